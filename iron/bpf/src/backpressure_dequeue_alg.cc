@@ -166,6 +166,7 @@ BPDequeueAlg::BPDequeueAlg(BPFwder& bpfwder, PacketPool& packet_pool,
       num_zombie_dequeue_ttypes_(0),
       drop_expired_(kDefaultDropExpired),
       anti_circ_(AC_TECH_NONE),
+      deq_variant_(DEQ_VARIANT_BASE),
       enable_hierarchical_fwding_(kDefaultHierarchicalFwding),
       multi_deq_(kDefaultMultiDeq),
       enable_mcast_opportunistic_fwding_(
@@ -175,7 +176,8 @@ BPDequeueAlg::BPDequeueAlg(BPFwder& bpfwder, PacketPool& packet_pool,
       dequeued_bytes_(),
       has_prio_ttypes_(),
       xplot_queue_delay_(kDefaultGenerateQueueDelayGraphs),
-      delay_xplot_()
+      delay_xplot_(),
+      expired_pkts_()
 {
   if (!path_ctrls)
   {
@@ -426,6 +428,9 @@ void BPDequeueAlg::Initialize(const ConfigInfo& config_info)
        enable_hierarchical_fwding_ ? "On" : "Off");
   LogC(kClassName, __func__,
        "Bpf.Alg.MultiDequeue          : %s\n", multi_deq_ ? "On" : "Off");
+
+  SelectDequeueVariant();
+
   LogC(kClassName, __func__,
        "BPF forwarding algorithm configuration complete.\n");
 
@@ -534,11 +539,68 @@ void BPDequeueAlg::ResetFwdingAlg(const ConfigInfo& config_info)
        enable_hierarchical_fwding_ ? "On" : "Off");
   LogC(kClassName, __func__,
        "Bpf.Alg.MultiDequeue          : %s\n", multi_deq_ ? "On" : "Off");
+
+  SelectDequeueVariant();
+
   LogC(kClassName, __func__,
        "BPF forwarding algorithm configuration complete.\n");
 }
 
 //============================================================================
+void BPDequeueAlg::SelectDequeueVariant()
+{
+  if (base_)
+  {
+    deq_variant_ = DEQ_VARIANT_BASE;
+  }
+  else if (anti_circ_ == AC_TECH_HEURISTIC_DAG)
+  {
+    deq_variant_ = DEQ_VARIANT_LA_HEURISTIC_DAG;
+  }
+  else if (anti_circ_ == AC_TECH_CONDITIONAL_DAG)
+  {
+    deq_variant_ = DEQ_VARIANT_LA_CONDITIONAL_DAG;
+  }
+  else
+  {
+    deq_variant_ = DEQ_VARIANT_GENERIC;
+  }
+
+  LogC(kClassName, __func__,
+       "Dequeue pipeline variant      : %s\n",
+       deq_variant_ == DEQ_VARIANT_BASE ? "Base" :
+       deq_variant_ == DEQ_VARIANT_LA_HEURISTIC_DAG ?
+       "LatencyAware, Heuristic DAG" :
+       deq_variant_ == DEQ_VARIANT_LA_CONDITIONAL_DAG ?
+       "LatencyAware, Conditional DAG" : "Generic");
+}
+
+//============================================================================
+uint8_t BPDequeueAlg::FindNextTransmission(TxSolution* solutions,
+                                           uint8_t max_num_solutions)
+{
+  switch (deq_variant_)
+  {
+    case DEQ_VARIANT_BASE:
+      return FindNextTransmission<DEQ_VARIANT_BASE>(solutions,
+                                                    max_num_solutions);
+
+    case DEQ_VARIANT_LA_HEURISTIC_DAG:
+      return FindNextTransmission<DEQ_VARIANT_LA_HEURISTIC_DAG>(
+        solutions, max_num_solutions);
+
+    case DEQ_VARIANT_LA_CONDITIONAL_DAG:
+      return FindNextTransmission<DEQ_VARIANT_LA_CONDITIONAL_DAG>(
+        solutions, max_num_solutions);
+
+    default:
+      return FindNextTransmission<DEQ_VARIANT_GENERIC>(solutions,
+                                                       max_num_solutions);
+  }
+}
+
+//============================================================================
+template <BPDequeueAlg::DequeueVariant V>
 uint8_t BPDequeueAlg::FindNextTransmission(TxSolution* solutions,
                                            uint8_t max_num_solutions)
 {
@@ -576,7 +638,7 @@ uint8_t BPDequeueAlg::FindNextTransmission(TxSolution* solutions,
   Time               now = Time::Now();
   int32_t            path_ctrl_q_sizes[kMaxPathCtrls];
   TransmitCandidate  critical_candidate;
-  if (!ZombifyAndCriticalizePkts(now, kMaxPathCtrls, path_ctrl_q_sizes,
+  if (!ZombifyAndCriticalizePkts<V>(now, kMaxPathCtrls, path_ctrl_q_sizes,
                                  critical_candidate))
   {
     return 0;
@@ -640,7 +702,7 @@ uint8_t BPDequeueAlg::FindNextTransmission(TxSolution* solutions,
 
   // Step S4 from the packet forwarder description in the BPF design
   // documentation, construct forwarding gradients.
-  ComputeGradients(path_ctrl_q_sizes, gradients, ls_gradients);
+  ComputeGradients<V>(path_ctrl_q_sizes, gradients, ls_gradients);
 
   // Provide BinQueueMgr gradient info to help with addressing starvation.
   queue_store_->ProcessGradientUpdate(ls_gradients, gradients);
@@ -657,7 +719,7 @@ uint8_t BPDequeueAlg::FindNextTransmission(TxSolution* solutions,
     ef_gradients = &gradients;
   }
 
-  FindLatencySensitivePkts(now, ef_gradients, path_ctrl_q_sizes,
+  FindLatencySensitivePkts<V>(now, ef_gradients, path_ctrl_q_sizes,
                            max_num_solutions, solutions, num_solutions);
   if (num_solutions > 0)
   {
@@ -669,7 +731,7 @@ uint8_t BPDequeueAlg::FindNextTransmission(TxSolution* solutions,
   LogD(kClassName, __func__, "Did not find candidate for priority dequeue "
        "traffic types.\n");
 
-  FindLatencyInsensitivePkts(now, gradients, path_ctrl_q_sizes,
+  FindLatencyInsensitivePkts<V>(now, gradients, path_ctrl_q_sizes,
                              max_num_solutions, solutions, num_solutions);
 
   if (num_solutions == 0)
@@ -950,6 +1012,7 @@ void BPDequeueAlg::ComputeMulticastGradient(
 }
 
 //============================================================================
+template <BPDequeueAlg::DequeueVariant V>
 bool BPDequeueAlg::ZombifyAndCriticalizePkts(
   const Time& now, size_t max_num_path_ctrls, int32_t* path_ctrl_q_sizes,
   TransmitCandidate& candidate)
@@ -982,7 +1045,7 @@ bool BPDequeueAlg::ZombifyAndCriticalizePkts(
 
   BinIndex  dst_bin_idx = 0;
   for (bool dst_bin_idx_valid = bin_map_.GetFirstUcastBinIndex(dst_bin_idx);
-       !base_ && dst_bin_idx_valid;
+       !UseBase<V>() && dst_bin_idx_valid;
        dst_bin_idx_valid = bin_map_.GetNextUcastBinIndex(dst_bin_idx))
   {
     q_mgr = queue_store_->GetBinQueueMgr(dst_bin_idx);
@@ -1012,7 +1075,7 @@ bool BPDequeueAlg::ZombifyAndCriticalizePkts(
     Time  min_ttr;
     min_ttr.SetInfinite();
 
-    if (anti_circ_ == AC_TECH_HEURISTIC_DAG)
+    if (UseAntiCirc<V>() == AC_TECH_HEURISTIC_DAG)
     {
       // Get the per path controller latency, which is same for all packets of
       // this bin. Compute best path controller busy-ness.
@@ -1035,7 +1098,8 @@ bool BPDequeueAlg::ZombifyAndCriticalizePkts(
         }
 
         size_t  current_pc_queue_size = 0;
-        if (!(path_ctrl->GetXmitQueueSize(current_pc_queue_size)))
+        if (!bpfwder_.GetXmitQueueSize(path_ctrl,
+                                       current_pc_queue_size))
         {
           // This path controller does not have a current transmit queue size.
           // Maybe it is still connecting to a peer. Move on.
@@ -1066,6 +1130,66 @@ bool BPDequeueAlg::ZombifyAndCriticalizePkts(
       }
     } // End heuristic_dag only.
 
+    // Unless the latency to the destination depends on each packet's
+    // history, the packets that cannot make it on any interface are those
+    // whose deadline precedes now + min_ttr, which the bin's deadline index
+    // finds without walking the queues.
+    bool  use_deadline_index =
+      (q_mgr->use_deadline_index() &&
+       (UseAntiCirc<V>() != AC_TECH_CONDITIONAL_DAG));
+
+    if (use_deadline_index)
+    {
+      Time  threshold = (min_ttr.IsInfinite() ? Time::Infinite() :
+                         now + min_ttr);
+
+      for (uint8_t ttype_i = 0; ttype_i < num_zombifiable_ttypes_; ++ttype_i)
+      {
+        expired_pkts_.clear();
+        q_mgr->DequeueExpired(zombifiable_ttypes_[ttype_i], threshold,
+                              expired_pkts_);
+
+        for (size_t i = 0; i < expired_pkts_.size(); ++i)
+        {
+          LogD(kClassName, __func__, "Pkt %p cannot be delivered in time on "
+               "any interface (min_ttr %s). Drop.\n", expired_pkts_[i],
+               min_ttr.ToString().c_str());
+          DropOrZombifyExpiredPkt(expired_pkts_[i], dst_bin_idx, q_mgr);
+        }
+      }
+
+      // The critical candidate for this bin is its critical packet with the
+      // least time-to-go.
+      Packet*                      pkt = NULL;
+      Time                         deadline;
+      PacketQueue::QueueWalkState  qws;
+
+      if ((UseAntiCirc<V>() == AC_TECH_HEURISTIC_DAG) &&
+          !min_ttr.IsInfinite() &&
+          (path_ctrl_q_sizes[min_lat_pc_index] <
+           static_cast<int32_t>(xmit_buf_max_thresh_)) &&
+          q_mgr->PeekEarliestDeadline(CRITICAL_LATENCY, pkt, deadline, qws))
+      {
+        ttg = deadline - now;
+
+        if (ttg < candidate.ttg)
+        {
+          candidate.is_valid        = true;
+          candidate.pkt             = pkt;
+          candidate.bin_idx         = dst_bin_idx;
+          candidate.id_to_log       = bin_map_.GetIdToLog(dst_bin_idx);
+          candidate.ttg             = ttg;
+          candidate.ttr             = min_ttr;
+          candidate.path_ctrl_index = min_lat_pc_index;
+          candidate.dequeue_loc     = qws;
+          candidate.q_mgr           = q_mgr;
+          LogD(kClassName, __func__, "Critical packet %p with ttg %s on "
+               "available path controller %zu overtakes candidates.\n",
+               pkt, ttg.ToString().c_str(), min_lat_pc_index);
+        }
+      }
+    }
+
     // Go through the EF and CRITICAL queues to zombify packets.
     for (uint8_t ttype_i = 0; ttype_i < num_zombifiable_ttypes_; ++ttype_i)
     {
@@ -1073,6 +1197,16 @@ bool BPDequeueAlg::ZombifyAndCriticalizePkts(
       uint32_t      num_available_bytes = 0;
       LatencyClass  ttype               = zombifiable_ttypes_[ttype_i];
 
+      // With the deadline index, expired packets are already gone and the
+      // critical candidate is already known. Only the history-constrained
+      // check of the heuristic DAG still requires walking the EF queue.
+      if (use_deadline_index &&
+          ((UseAntiCirc<V>() != AC_TECH_HEURISTIC_DAG) ||
+           (ttype != LOW_LATENCY)))
+      {
+        continue;
+      }
+
       q_mgr->PrepareIteration(ttype);
       PacketQueue::QueueWalkState  saved_it;
 
@@ -1091,7 +1225,7 @@ bool BPDequeueAlg::ZombifyAndCriticalizePkts(
 
         prev_pkt = pkt;
 
-        if (anti_circ_ == AC_TECH_CONDITIONAL_DAG)
+        if (UseAntiCirc<V>() == AC_TECH_CONDITIONAL_DAG)
         {
           // Get the per path controller latency, which is same for all
           // packets of this bin. Compute best path controller busy-ness.
@@ -1118,24 +1252,14 @@ bool BPDequeueAlg::ZombifyAndCriticalizePkts(
                ttg.ToString().c_str(), min_ttr.ToString().c_str());
           pkt = q_mgr->DequeueAtCurrentIterator(ttype);
 
-          if (pkt && pkt->HasQueuingDelay())
-          {
-            AddDelayToAverage(Time::GetNowInUsec() -
-                              pkt->recv_time().GetTimeInUsec(), dst_bin_idx);
-          }
-
-          if (drop_expired_ || !q_mgr->ZombifyPacket(pkt))
+          if (pkt)
           {
-            bpfwder_.AddDroppedBytes(dst_bin_idx, pkt->virtual_length());
-            TRACK_EXPECTED_DROP(kClassName, packet_pool_);
-            LogD(kClassName, __func__, "Dropped expired packet %p or "
-                 "Zombification failed.\n", pkt);
-            packet_pool_.Recycle(pkt);
+            DropOrZombifyExpiredPkt(pkt, dst_bin_idx, q_mgr);
           }
           continue;
         }
 
-        if (anti_circ_ == AC_TECH_HEURISTIC_DAG)
+        if (UseAntiCirc<V>() == AC_TECH_HEURISTIC_DAG)
         {
           // Anti-circulation technique is heuristic_dag, deal with critical.
           if ((ttype == CRITICAL_LATENCY) && (ttg < candidate.ttg) &&
@@ -1160,7 +1284,7 @@ bool BPDequeueAlg::ZombifyAndCriticalizePkts(
           }
 
           if ((ttype == LOW_LATENCY) &&
-              IsHistoryConstrained(pkt, ttg, latency_us, num_path_ctrls_))
+              IsHistoryConstrained<V>(pkt, ttg, latency_us, num_path_ctrls_))
           {
             // EF packet is history-constrained and not yet in critical. But
             // this should not prevent us from assessing it as a candidate.
@@ -1221,6 +1345,27 @@ bool BPDequeueAlg::ZombifyAndCriticalizePkts(
 }
 
 //============================================================================
+void BPDequeueAlg::DropOrZombifyExpiredPkt(Packet* pkt, BinIndex dst_bin_idx,
+                                           BinQueueMgr* q_mgr)
+{
+  if (pkt->HasQueuingDelay())
+  {
+    AddDelayToAverage(Time::GetNowInUsec() -
+                      pkt->recv_time().GetTimeInUsec(), dst_bin_idx);
+  }
+
+  if (drop_expired_ || !q_mgr->ZombifyPacket(pkt))
+  {
+    bpfwder_.AddDroppedBytes(dst_bin_idx, pkt->virtual_length());
+    TRACK_EXPECTED_DROP(kClassName, packet_pool_);
+    LogD(kClassName, __func__, "Dropped expired packet %p or "
+         "Zombification failed.\n", pkt);
+    packet_pool_.Recycle(pkt);
+  }
+}
+
+//============================================================================
+template <BPDequeueAlg::DequeueVariant V>
 void BPDequeueAlg::ComputeGradients(
   int32_t* path_ctrl_q_sizes, OrderedList<Gradient, int64_t>& gradients,
   OrderedList<Gradient, int64_t>& ls_gradients)
@@ -1249,7 +1394,7 @@ void BPDequeueAlg::ComputeGradients(
     if (path_ctrl_q_sizes[path_ctrl_idx] == -1)
     {
       size_t  current_pc_queue_size = 0;
-      if (!(path_ctrl->GetXmitQueueSize(current_pc_queue_size)))
+      if (!bpfwder_.GetXmitQueueSize(path_ctrl, current_pc_queue_size))
       {
         // This path controller does not have a current transmit queue size.
         // Maybe it is still connecting to a peer. Simply move on.
@@ -1302,7 +1447,7 @@ void BPDequeueAlg::ComputeGradients(
            path_ctrl->remote_bin_id(),
            bin_map_.GetIdToLog(dst_bin_idx).c_str());
 
-      if (!base_)
+      if (!UseBase<V>())
       {
         has_prio_ttypes_[dst_bin_idx] = queue_store_->GetBinQueueMgr(
           dst_bin_idx)->ContainsPacketsWithTtypes(
@@ -1420,6 +1565,7 @@ void BPDequeueAlg::ComputeGradients(
 }
 
 //============================================================================
+template <BPDequeueAlg::DequeueVariant V>
 void BPDequeueAlg::FindLatencySensitivePkts(
   const Time& now, OrderedList<Gradient, int64_t>* ef_gradients,
   int32_t* path_ctrl_q_sizes, uint8_t max_num_solutions,
@@ -1508,8 +1654,8 @@ void BPDequeueAlg::FindLatencySensitivePkts(
 
       if (!bin_map_.IsMcastBinIndex(gradient.bin_idx))
       {
-        cand_bytes_found += FindUcastPacketsForGradient(
-          gradient, ttype, now, !base_, candidates, to_find);
+        cand_bytes_found += FindUcastPacketsForGradient<V>(
+          gradient, ttype, now, !UseBase<V>(), candidates, to_find);
       }
       else if (ttype_i == 0)
       {
@@ -1528,7 +1674,7 @@ void BPDequeueAlg::FindLatencySensitivePkts(
              ++ttype_j)
         {
           LatencyClass  mcast_ttype = dequeue_order[ttype_j];
-          cand_bytes_found += FindMcastPacketsForGradient(
+          cand_bytes_found += FindMcastPacketsForGradient<V>(
             gradient, mcast_ttype, false, candidates, to_find);
         }
       }
@@ -1650,6 +1796,7 @@ void BPDequeueAlg::FindLatencySensitivePkts(
 }
 
 //============================================================================
+template <BPDequeueAlg::DequeueVariant V>
 void BPDequeueAlg::FindLatencyInsensitivePkts(
   const Time& now, OrderedList<Gradient, int64_t>& gradients,
   int32_t* path_ctrl_q_sizes, uint8_t max_num_solutions,
@@ -1750,12 +1897,12 @@ void BPDequeueAlg::FindLatencyInsensitivePkts(
       }
       if (!bin_map_.IsMcastBinIndex(gradient.bin_idx))
       {
-        cand_bytes_found += FindUcastPacketsForGradient(
+        cand_bytes_found += FindUcastPacketsForGradient<V>(
           gradient, ttype, now, false, candidates, to_find);
       }
       else
       {
-        cand_bytes_found += FindMcastPacketsForGradient(
+        cand_bytes_found += FindMcastPacketsForGradient<V>(
           gradient, ttype, false, candidates, to_find);
       }
     }
@@ -1904,7 +2051,17 @@ bool BPDequeueAlg::IsHistoryConstrained(Packet* pkt, iron::Time& ttg,
                                         uint32_t* latencies_us,
                                         size_t num_latencies)
 {
-  if (anti_circ_ != AC_TECH_HEURISTIC_DAG)
+  return IsHistoryConstrained<DEQ_VARIANT_GENERIC>(pkt, ttg, latencies_us,
+                                                   num_latencies);
+}
+
+//============================================================================
+template <BPDequeueAlg::DequeueVariant V>
+bool BPDequeueAlg::IsHistoryConstrained(Packet* pkt, iron::Time& ttg,
+                                        uint32_t* latencies_us,
+                                        size_t num_latencies)
+{
+  if (UseAntiCirc<V>() != AC_TECH_HEURISTIC_DAG)
   {
     return false;
   }
@@ -1992,6 +2149,17 @@ bool BPDequeueAlg::GetMinLatencyPath(uint32_t* latencies_us, size_t num_latencie
 }
 
 //============================================================================
+uint32_t BPDequeueAlg::FindUcastPacketsForGradient(
+  const Gradient& gradient, LatencyClass& ttype, const Time& now,
+  bool consider_latency, OrderedList<TransmitCandidate, Time>& candidates,
+  uint32_t max_bytes)
+{
+  return FindUcastPacketsForGradient<DEQ_VARIANT_GENERIC>(
+    gradient, ttype, now, consider_latency, candidates, max_bytes);
+}
+
+//============================================================================
+template <BPDequeueAlg::DequeueVariant V>
 uint32_t BPDequeueAlg::FindUcastPacketsForGradient(
   const Gradient& gradient, LatencyClass& ttype, const Time& now,
   bool consider_latency, OrderedList<TransmitCandidate, Time>& candidates,
@@ -2029,7 +2197,7 @@ uint32_t BPDequeueAlg::FindUcastPacketsForGradient(
        gradient.value, bin_map_.GetIdToLog(dst_bin_idx).c_str(),
        gradient.path_ctrl_index, LatencyClass_Name[ttype].c_str(), max_bytes);
 
-  if (!base_ && (anti_circ_ != AC_TECH_CONDITIONAL_DAG))
+  if (!UseBase<V>() && (UseAntiCirc<V>() != AC_TECH_CONDITIONAL_DAG))
   {
     // Get the per path controller latency, which is same for all packets of
     // this bin.
@@ -2085,7 +2253,7 @@ uint32_t BPDequeueAlg::FindUcastPacketsForGradient(
              pkt->virtual_length(), num_visited_bytes);
         prev_pkt            = pkt;
 
-        if ((anti_circ_ != AC_TECH_NONE) &&
+        if ((UseAntiCirc<V>() != AC_TECH_NONE) &&
             (packet_history_mgr_->PacketVisitedBin(
               pkt, bin_map_.GetPhyBinId(path_ctrl->remote_bin_idx()))))
         {
@@ -2095,7 +2263,7 @@ uint32_t BPDequeueAlg::FindUcastPacketsForGradient(
           continue;
         }
 
-        if (anti_circ_ == AC_TECH_CONDITIONAL_DAG)
+        if (UseAntiCirc<V>() == AC_TECH_CONDITIONAL_DAG)
         {
           bpfwder_.GetPerPcLatencyToDst(dst_bin_idx, (uint32_t*) latency_us,
                                         false, pkt);
@@ -2209,7 +2377,7 @@ uint32_t BPDequeueAlg::FindUcastPacketsForGradient(
   else
   {
     // Latency-insensitive traffic.
-    if ((anti_circ_ == AC_TECH_HEURISTIC_DAG) &&
+    if ((UseAntiCirc<V>() == AC_TECH_HEURISTIC_DAG) &&
         (latency_us[gradient.path_ctrl_index] ==
           std::numeric_limits<uint32_t>::max()))
     {
@@ -2344,6 +2512,7 @@ uint32_t BPDequeueAlg::FindUcastPacketsForGradient(
 }
 
 //============================================================================
+template <BPDequeueAlg::DequeueVariant V>
 uint32_t BPDequeueAlg::FindMcastPacketsForGradient(
   const Gradient& gradient,
   LatencyClass& ttype,
@@ -2566,7 +2735,7 @@ uint32_t BPDequeueAlg::FindMcastPacketsForGradient(
     DstVec    proposed_dst_vec    = 0;
 
     if (consider_latency &&
-        (anti_circ_ != AC_TECH_NONE) &&
+        (UseAntiCirc<V>() != AC_TECH_NONE) &&
         (packet_history_mgr_->PacketVisitedBin(
           pkt, bin_map_.GetPhyBinId(path_ctrl->remote_bin_idx()))))
     {
@@ -50,6 +50,8 @@
 #include "string_utils.h"
 #include "gradient.h"
 
+#include <vector>
+
 #include <string.h>
 
 namespace iron
@@ -337,6 +339,66 @@ namespace iron
 
     protected:
 
+    /// The dequeue pipeline variants.  Each one is a separate compilation
+    /// of the pipeline with the forwarding algorithm and anti-circulation
+    /// technique fixed, so their per-packet checks are resolved at compile
+    /// time.  The generic variant checks the configuration at run time and
+    /// handles any other combination.
+    enum DequeueVariant
+    {
+      DEQ_VARIANT_GENERIC             = 0,
+      DEQ_VARIANT_BASE                = 1,
+      DEQ_VARIANT_LA_HEURISTIC_DAG    = 2,
+      DEQ_VARIANT_LA_CONDITIONAL_DAG  = 3,
+    };
+
+    /// The anti-circulation techniques.
+    enum AntiCircTech
+    {
+      AC_TECH_NONE                = 0,
+      AC_TECH_HEURISTIC_DAG       = 1,
+      AC_TECH_CONDITIONAL_DAG     = 2,
+    };
+
+    /// \brief Select the dequeue pipeline variant matching the current
+    ///        configuration.
+    void SelectDequeueVariant();
+
+    /// \brief Find the next transmission opportunity using one dequeue
+    ///        pipeline variant.
+    ///
+    /// \param  solutions          The array of transmit solutions to be
+    ///                            sent.
+    /// \param  max_num_solutions  The maximum number of solutions that we
+    ///                            could find.
+    ///
+    /// \return The number of solutions that were found, 0 if nothing.
+    template <DequeueVariant V>
+    uint8_t FindNextTransmission(TxSolution* solutions,
+                                 uint8_t max_num_solutions);
+
+    /// \brief Check if a dequeue pipeline variant uses the base algorithm.
+    ///
+    /// \return True for the base algorithm, false for latency-aware.
+    template <DequeueVariant V>
+    inline bool UseBase() const
+    {
+      return ((V == DEQ_VARIANT_GENERIC) ? base_ : (V == DEQ_VARIANT_BASE));
+    }
+
+    /// \brief Get the anti-circulation technique of a dequeue pipeline
+    ///        variant.
+    ///
+    /// \return The anti-circulation technique.
+    template <DequeueVariant V>
+    inline AntiCircTech UseAntiCirc() const
+    {
+      return ((V == DEQ_VARIANT_GENERIC) ? anti_circ_ :
+              (V == DEQ_VARIANT_LA_HEURISTIC_DAG) ? AC_TECH_HEURISTIC_DAG :
+              (V == DEQ_VARIANT_LA_CONDITIONAL_DAG) ?
+              AC_TECH_CONDITIONAL_DAG : AC_TECH_NONE);
+    }
+
     /// \brief Zombify and Criticalize EF packets.
     ///
     /// \param  now                 The current time.
@@ -347,10 +409,24 @@ namespace iron
     /// \param  candidate           Critical packet candidate.
     ///
     /// \return True if successful, false otherwise.
+    template <DequeueVariant V>
     bool ZombifyAndCriticalizePkts(const Time& now, size_t max_num_path_ctrls,
                                    int32_t* path_ctrl_q_sizes,
                                    TransmitCandidate& candidate);
 
+    /// \brief Drop or zombify a packet that can no longer be delivered in
+    ///        time.
+    ///
+    /// The packet must already have been dequeued. Memory ownership goes to
+    /// the bin queue mgr if the packet is zombified, otherwise it is
+    /// recycled.
+    ///
+    /// \param  pkt          The expired packet.
+    /// \param  dst_bin_idx  The destination bin index of the packet.
+    /// \param  q_mgr        The bin queue mgr from which it was dequeued.
+    void DropOrZombifyExpiredPkt(Packet* pkt, BinIndex dst_bin_idx,
+                                 BinQueueMgr* q_mgr);
+
     /// \brief Compute forwarding gradients.
     ///
     /// \param  path_ctrl_q_sizes  Array of path controller transmit queue
@@ -359,6 +435,7 @@ namespace iron
     ///                            forwarding gradients.
     /// \param  ls_gradients       The computed latency-sensitive forwarding
     ///                            gradients.
+    template <DequeueVariant V>
     void ComputeGradients(int32_t* path_ctrl_q_sizes,
                           OrderedList<Gradient, int64_t>& gradients,
                           OrderedList<Gradient, int64_t>& ls_gradients);
@@ -373,6 +450,7 @@ namespace iron
     /// \param  max_num_solutions  The maximum number of supported solutions.
     /// \param  solutions          Array of transmit solutions.
     /// \param  num_solutions      The found number of transmit solutions.
+    template <DequeueVariant V>
     void FindLatencySensitivePkts(
       const Time& now, OrderedList<Gradient, int64_t>* ef_gradients,
       int32_t* path_ctrl_q_sizes, uint8_t max_num_solutions,
@@ -388,6 +466,7 @@ namespace iron
     /// \param  max_num_solutions  The maximum number of supported solutions.
     /// \param  solutions          Array of transmit solutions.
     /// \param  num_solutions      The found number of transmit solutions.
+    template <DequeueVariant V>
     void FindLatencyInsensitivePkts(
       const Time& now, OrderedList<Gradient, int64_t>& gradients,
       int32_t* path_ctrl_q_sizes, uint8_t max_num_solutions,
@@ -410,6 +489,12 @@ namespace iron
                               uint32_t* latencies_us,
                               size_t num_latencies);
 
+    /// \brief  IsHistoryConstrained() for one dequeue pipeline variant.
+    template <DequeueVariant V>
+    bool IsHistoryConstrained(Packet* pkt, Time& ttg,
+                              uint32_t* latencies_us,
+                              size_t num_latencies);
+
     /// \brief  Method to compute a one destination bin gradient between this
     ///         node and a neighbor to a group bin, whether unicast or a single
     ///         destination in a multicast group.
@@ -478,6 +563,16 @@ namespace iron
                       OrderedList<TransmitCandidate, Time>& candidates,
                       uint32_t max_bytes);
 
+    /// \brief  FindUcastPacketsForGradient() for one dequeue pipeline
+    ///         variant.
+    template <DequeueVariant V>
+    uint32_t FindUcastPacketsForGradient(const Gradient& gradient,
+                      LatencyClass& ttype,
+                      const Time& method_start,
+                      bool consider_latency,
+                      OrderedList<TransmitCandidate, Time>& candidates,
+                      uint32_t max_bytes);
+
     /// \brief  Find packets matching a multicast gradient.
     ///
     /// \param  gradient          The candidate gradient.
@@ -488,6 +583,7 @@ namespace iron
     /// \param  max_bytes         The maximum number of bytes to fetch.
     ///
     /// \return The number of candidates bytes.
+    template <DequeueVariant V>
     uint32_t FindMcastPacketsForGradient(
       const Gradient& gradient, LatencyClass& ttype, bool consider_latency,
       OrderedList<TransmitCandidate, Time>& candidates, uint32_t max_bytes);
@@ -602,16 +698,12 @@ namespace iron
     /// Boolean indicating whether to drop expired packets.
     bool                    drop_expired_;
 
-    enum AntiCircTech
-    {
-      AC_TECH_NONE                = 0,
-      AC_TECH_HEURISTIC_DAG       = 1,
-      AC_TECH_CONDITIONAL_DAG     = 2,
-    };
-
     /// Anti-circulation technique.
     AntiCircTech                  anti_circ_;
 
+    /// The dequeue pipeline variant selected for the configuration.
+    DequeueVariant                deq_variant_;
+
     /// Boolean indicating whether to use hierarchical forwarding.
     bool                          enable_hierarchical_fwding_;
 
@@ -646,6 +738,10 @@ namespace iron
     /// be NULL.
     BinIndexableArray<GenXplot*>  delay_xplot_;
 
+    /// Scratch space for the expired packets dequeued through a bin queue
+    /// mgr's deadline index.
+    std::vector<Packet*>          expired_pkts_;
+
   }; // end class BPDequeueAlg
 } // namespace iron
 
@@ -38,6 +38,7 @@
 #include "backpressure_fwder.h"
 
 #include "bpf_stats.h"
+#include "bpf_trace.h"
 #include "bin_map.h"
 #include "debugging_stats.h"
 #include "fifo_if.h"
@@ -72,6 +73,7 @@
 
 using ::iron::BinMap;
 using ::iron::BpfStats;
+using ::iron::BpfTraceWriter;
 using ::iron::BPFwder;
 using ::iron::DebuggingStats;
 using ::iron::FifoIF;
@@ -82,6 +84,7 @@ using ::iron::PACKET_OWNER_TCP_PROXY;
 using ::iron::PACKET_OWNER_UDP_PROXY;
 using ::iron::PacketPool;
 using ::iron::PacketType;
+using ::iron::PathController;
 using ::iron::SharedMemoryIF;
 using ::iron::StringUtils;
 using ::iron::Timer;
@@ -218,6 +221,7 @@ BPFwder::BPFwder(PacketPool& packet_pool,
       incl_queue_delays_(kDefaultIncludeQueuingDelays),
       incl_link_capacity_(kDefaultIncludeLinkCapacity),
       running_(false),
+      trace_writer_(NULL),
       my_bin_id_(numeric_limits<BinId>::max()),
       my_bin_idx_(numeric_limits<BinIndex>::max()),
       is_int_node_(false),
@@ -241,6 +245,10 @@ BPFwder::BPFwder(PacketPool& packet_pool,
       packet_history_mgr_(NULL),
       virt_queue_info_(),
       path_info_(),
+      lsa_matrix_current_(false),
+      virt_queue_topo_changed_(true),
+      virt_queue_hops_(),
+      virt_queue_ref_idx_(),
       packet_pool_(packet_pool),
       timer_(timer),
       weight_qd_shared_memory_(weight_qd_shared_memory),
@@ -272,6 +280,7 @@ BPFwder::BPFwder(PacketPool& packet_pool,
       last_lsa_send_time_(),
       lsa_timer_handle_(),
       lsa_info_(),
+      lsa_prev_info_(),
       gram_interval_ms_(kDefaultGramIntervalMs),
       gram_timer_handle_(),
       overhead_ratio_(kDefaultQlamOverheadRatio),
@@ -338,6 +347,15 @@ BPFwder::~BPFwder()
   }
 #endif // DEBUG_STATS
 
+  // Flush and close the trace.
+  if (trace_writer_)
+  {
+    LogI(kClassName, __func__, "Recorded %" PRIu64 " trace records.\n",
+         trace_writer_->num_records());
+    delete trace_writer_;
+    trace_writer_ = NULL;
+  }
+
   // Destroy the queue store.
   delete queue_store_;
 
@@ -427,6 +445,23 @@ bool BPFwder::Initialize()
     return false;
   }
 
+  // Start recording the BPF's inputs, if configured.  This must happen
+  // before the Path Controllers are created, as they report their
+  // capacities while initializing.
+  string  trace_file = config_info_.Get("Bpf.TraceFile", "");
+
+  if (!trace_file.empty())
+  {
+    trace_writer_ = new (std::nothrow) BpfTraceWriter();
+
+    if ((!trace_writer_) || (!trace_writer_->Open(trace_file, my_bin_id_)))
+    {
+      LogF(kClassName, __func__, "Unable to record trace to %s.\n",
+           trace_file.c_str());
+      return false;
+    }
+  }
+
   // Initialize the node records.
   if (!node_records_.Initialize(bin_map_shm_))
   {
@@ -443,6 +478,20 @@ bool BPFwder::Initialize()
     return false;
   }
 
+  // Initialize the virtual queue hop count arrays.
+  for (size_t i = 0; i <= kMaxPathCtrls; ++i)
+  {
+    if (!virt_queue_hops_[i].Initialize(bin_map_shm_))
+    {
+      LogE(kClassName, __func__, "Unable to initialize virtual queue hop "
+           "count array.\n");
+      return false;
+    }
+    virt_queue_hops_[i].Clear(UINT32_MAX);
+    virt_queue_ref_idx_[i] = kInvalidBinIndex;
+  }
+  virt_queue_topo_changed_ = true;
+
   // Get the virtual queue hop-count multiplier.
   virt_queue_mult_ = config_info_.GetUint("Bpf.VirtQueueDepths.Multiplier",
 					  kDefaultVirtQueueMult);
@@ -462,6 +511,13 @@ bool BPFwder::Initialize()
     return false;
   }
 
+  if (!lsa_prev_info_.Initialize(bin_map_shm_))
+  {
+    LogE(kClassName, __func__, "Unable to initialize previous LSA "
+         "information array.\n");
+    return false;
+  }
+
   // Create a node record for this IRON node since this is always needed.
   if (AccessOrAllocateNodeRecord(my_bin_idx_) == NULL)
   {
@@ -600,23 +656,7 @@ bool BPFwder::Initialize()
     string path_ctrl_type = config_info_.Get(config_prefix, "");
 
     // Create the Path Controller object.
-    PathController*  path_ctrl = NULL;
-
-    if (path_ctrl_type == "Sond")
-    {
-      path_ctrl = new (std::nothrow) Sond(this, packet_pool_, timer_);
-    }
-    else if (path_ctrl_type == "SliqCat")
-    {
-      path_ctrl = new (std::nothrow) SliqCat(this, packet_pool_, timer_);
-    }
-    else
-    {
-      LogE(kClassName, __func__, "Unknown Path Controller type %s.\n",
-           path_ctrl_type.c_str());
-
-      return false;
-    }
+    PathController*  path_ctrl = CreatePathController(path_ctrl_type);
 
     if (path_ctrl == NULL)
     {
@@ -961,44 +1001,7 @@ void BPFwder::Start(uint32_t num_pkts_to_process, uint32_t max_iterations)
 
   running_ = true;
 
-  // Do not schedule the first QLAM packet now: we do not know if the SOND or
-  // CAT is connected yet, so sending a QLAM would result in the QLAM being
-  // dropped.
-
-  // Start the statistics collection timer.
-  CallbackNoArg<BPFwder>  cbna(this, &BPFwder::PushStats);
-  Time                    delta_time = Time::FromMsec(stats_interval_ms_);
-
-  if (!timer_.StartTimer(delta_time, &cbna, stats_push_.timer_handle))
-  {
-    LogE(kClassName, __func__, "Error setting next statistics push timer.\n");
-  }
-
-  if (ls_latency_collection_)
-  {
-    // Set the periodic LSA timer (in case there are no udpates from the CATS).
-    CallbackNoArg<BPFwder>  cb_lsa(this, &BPFwder::SendNewLsa);
-    delta_time  = Time::FromMsec(lsa_interval_ms_);
-
-    if (!timer_.StartTimer(delta_time, &cb_lsa, lsa_timer_handle_))
-    {
-      LogE(kClassName, __func__, "Failed to set LSA timer.\n");
-    }
-  }
-
-  // If we are doing multicast forwarding and sending GRAMs then start
-  // the periodic timer.
-  if (mcast_fwding_ && send_grams_)
-  {
-    // Set the periodic GRAM timer.
-    CallbackNoArg<BPFwder>  cb_gram(this, &BPFwder::SendGram);
-    delta_time  = Time::FromMsec(gram_interval_ms_);
-
-    if (!timer_.StartTimer(delta_time, &cb_gram, gram_timer_handle_))
-    {
-      LogE(kClassName, __func__, "Failed to set GRAM timer.\n");
-    }
-  }
+  StartPeriodicTimers();
 
   // The Backpressure Forwarder main event loop.
   //
@@ -1140,111 +1143,177 @@ void BPFwder::Start(uint32_t num_pkts_to_process, uint32_t max_iterations)
       }
     }
 
-    // Process the timer callbacks.
-    timer_.DoCallbacks();
+    // Service the timers and the forwarding algorithm.
+    uint32_t  num_solutions_found = ServiceTimersAndQueues();
 
-    // Do periodic adjustments of queue values. Note: this is not called
-    // "periodically" since there is nothing regular about the timing other
-    // than that it's once per select loop. Timing of any periodic behaviors
-    // is done within the different queue depth managers.
-    queue_store_->PeriodicAdjustQueueValues();
+    if (num_pkts_to_process != 0)
+    {
+      // Counter for halting unit tests.
+      pkts_processed += num_solutions_found;
+    }
 
-    // Execute the algorithm.
-    size_t            path_ctrl_index;
-    PathController*   path_ctrl;
-    BinIndex          xmit_bin_idx;
+    // Check if we need to halt for unit tests.
+    if ((num_pkts_to_process != 0 && pkts_processed >= num_pkts_to_process) ||
+        (max_iterations != 0 && num_iterations >= max_iterations))
+    {
+      running_ = false;
+    }
+  }
+}
 
-    uint32_t          num_bytes_sent_since_shm_write = 0;
+//============================================================================
+void BPFwder::StartPeriodicTimers()
+{
+  // Do not schedule the first QLAM packet now: we do not know if the SOND or
+  // CAT is connected yet, so sending a QLAM would result in the QLAM being
+  // dropped.
 
-    uint8_t           num_solutions = max_num_dequeue_alg_solutions_;
+  // Start the statistics collection timer.
+  CallbackNoArg<BPFwder>  cbna(this, &BPFwder::PushStats);
+  Time                    delta_time = Time::FromMsec(stats_interval_ms_);
+
+  if (!timer_.StartTimer(delta_time, &cbna, stats_push_.timer_handle))
+  {
+    LogE(kClassName, __func__, "Error setting next statistics push timer.\n");
+  }
 
-    uint32_t          num_bytes_sent= 0;
-    uint32_t          max_free_bytes= 0;
-    uint32_t          bytes_avail[kPathCtrlMaxFdCount];
-    
-    memset(bytes_avail,0,sizeof(bytes_avail));
+  if (ls_latency_collection_)
+  {
+    // Set the periodic LSA timer (in case there are no udpates from the CATS).
+    CallbackNoArg<BPFwder>  cb_lsa(this, &BPFwder::SendNewLsa);
+    delta_time  = Time::FromMsec(lsa_interval_ms_);
 
-    if (multi_deq_)
+    if (!timer_.StartTimer(delta_time, &cb_lsa, lsa_timer_handle_))
     {
-      for (size_t pc_index = 0; pc_index < num_path_ctrls_; ++pc_index)
-      {
-        PathController* path_ctrl = path_ctrls_[pc_index].path_ctrl;
+      LogE(kClassName, __func__, "Failed to set LSA timer.\n");
+    }
+  }
 
-        if (!path_ctrl)
-        {
-          continue;
-        }
+  // If we are doing multicast forwarding and sending GRAMs then start
+  // the periodic timer.
+  if (mcast_fwding_ && send_grams_)
+  {
+    // Set the periodic GRAM timer.
+    CallbackNoArg<BPFwder>  cb_gram(this, &BPFwder::SendGram);
+    delta_time  = Time::FromMsec(gram_interval_ms_);
+
+    if (!timer_.StartTimer(delta_time, &cb_gram, gram_timer_handle_))
+    {
+      LogE(kClassName, __func__, "Failed to set GRAM timer.\n");
+    }
+  }
+}
 
-        size_t  current_pc_queue_size = 0;
+//============================================================================
+uint32_t BPFwder::ServiceTimersAndQueues()
+{
+  uint32_t  num_solutions_found = 0;
 
-        if (!(path_ctrl->GetXmitQueueSize(current_pc_queue_size)))
-        {
-          // This path controller does not have a current transmit queue size.
-          // Maybe it is still connecting to a peer.  Move on.
-          LogD(kClassName, __func__, "Path to nbr %" PRIBinId " currently "
-               "has no queue.\n", path_ctrl->remote_bin_id());
-          continue;
-        }
+  // Process the timer callbacks.
+  timer_.DoCallbacks();
 
-        if (xmit_buf_max_thresh_ > current_pc_queue_size)
-        {
+  // Do periodic adjustments of queue values. Note: this is not called
+  // "periodically" since there is nothing regular about the timing other
+  // than that it's once per select loop. Timing of any periodic behaviors
+  // is done within the different queue depth managers.
+  queue_store_->PeriodicAdjustQueueValues();
+
+  // Execute the algorithm.
+  size_t            path_ctrl_index;
+  PathController*   path_ctrl;
+  BinIndex          xmit_bin_idx;
+
+  uint32_t          num_bytes_sent_since_shm_write = 0;
+
+  uint8_t           num_solutions = max_num_dequeue_alg_solutions_;
+
+  uint32_t          num_bytes_sent= 0;
+  uint32_t          max_free_bytes= 0;
+  uint32_t          bytes_avail[kPathCtrlMaxFdCount];
+  
+  memset(bytes_avail,0,sizeof(bytes_avail));
+
+  if (multi_deq_)
+  {
+    for (size_t pc_index = 0; pc_index < num_path_ctrls_; ++pc_index)
+    {
+      PathController* path_ctrl = path_ctrls_[pc_index].path_ctrl;
+
+      if (!path_ctrl)
+      {
+        continue;
+      }
+
+      size_t  current_pc_queue_size = 0;
+
+      if (!GetXmitQueueSize(path_ctrl, current_pc_queue_size))
+      {
+        // This path controller does not have a current transmit queue size.
+        // Maybe it is still connecting to a peer.  Move on.
+        LogD(kClassName, __func__, "Path to nbr %" PRIBinId " currently "
+             "has no queue.\n", path_ctrl->remote_bin_id());
+        continue;
+      }
+
+      if (xmit_buf_max_thresh_ > current_pc_queue_size)
+      {
 	  bytes_avail[pc_index]  = xmit_buf_max_thresh_ -
 	                           current_pc_queue_size;
 	  max_free_bytes        += bytes_avail[pc_index];
-        }
       }
-
-      LogD(kClassName, __func__,
-           "There are %" PRIu32 "B of free space in the path controllers, "
-           "allow at most this many bytes to be dequeued.\n", max_free_bytes);
     }
 
-    // In multi-dequeue, dequeue at most as many bytes as there is free buffer
-    // space among all path controllers.
-    // Note: We do not consider path controller busy-ness as this requires some
-    // more parameters to be shared between the fwding algorithm and this bpf
-    // object.
-    do
-    {
-      iron::TxSolution  solutions[max_num_dequeue_alg_solutions_];
-      num_solutions       = 0;
+    LogD(kClassName, __func__,
+         "There are %" PRIu32 "B of free space in the path controllers, "
+         "allow at most this many bytes to be dequeued.\n", max_free_bytes);
+  }
 
-      if ((num_solutions = bpf_dequeue_alg_->FindNextTransmission(
-             solutions, max_num_dequeue_alg_solutions_)) > 0)
+  // In multi-dequeue, dequeue at most as many bytes as there is free buffer
+  // space among all path controllers.
+  // Note: We do not consider path controller busy-ness as this requires some
+  // more parameters to be shared between the fwding algorithm and this bpf
+  // object.
+  do
+  {
+    iron::TxSolution  solutions[max_num_dequeue_alg_solutions_];
+    num_solutions       = 0;
+
+    if ((num_solutions = bpf_dequeue_alg_->FindNextTransmission(
+           solutions, max_num_dequeue_alg_solutions_)) > 0)
+    {
+      for (uint8_t n = 0; n < num_solutions; ++n)
       {
-        for (uint8_t n = 0; n < num_solutions; ++n)
-        {
-          Packet* packet  = solutions[n].pkt;
+        Packet* packet  = solutions[n].pkt;
 
-          if (packet == NULL)
-          {
-            break;
-          }
-          path_ctrl_index = solutions[n].path_ctrl_index;
-          xmit_bin_idx    = solutions[n].bin_idx;
+        if (packet == NULL)
+        {
+          break;
+        }
+        path_ctrl_index = solutions[n].path_ctrl_index;
+        xmit_bin_idx    = solutions[n].bin_idx;
 
-          Time ttg;
+        Time ttg;
 
-          path_ctrl = path_ctrls_[path_ctrl_index].path_ctrl;
+        path_ctrl = path_ctrls_[path_ctrl_index].path_ctrl;
 
-          bool     packet_has_ip_hdr       = packet->HasIpHeader();
-          bool     packet_track_ttg        = packet->track_ttg();
-          uint32_t packet_size_bytes       = packet->GetLengthInBytes();
-          uint8_t  protocol                = 0;
+        bool     packet_has_ip_hdr       = packet->HasIpHeader();
+        bool     packet_track_ttg        = packet->track_ttg();
+        uint32_t packet_size_bytes       = packet->GetLengthInBytes();
+        uint8_t  protocol                = 0;
 
-          if (packet_has_ip_hdr && !packet->GetIpProtocol(protocol))
-          {
-            LogW(kClassName, __func__, "Failed to retrieve protocol from "
-                 "packet.\n");
-          }
+        if (packet_has_ip_hdr && !packet->GetIpProtocol(protocol))
+        {
+          LogW(kClassName, __func__, "Failed to retrieve protocol from "
+               "packet.\n");
+        }
 
-          if (packet_track_ttg)
-          {
-            ttg = packet->GetTimeToGo();
-            ttg = ttg - (Time::Now() - packet->recv_time());
-          }
+        if (packet_track_ttg)
+        {
+          ttg = packet->GetTimeToGo();
+          ttg = ttg - (Time::Now() - packet->recv_time());
+        }
 
-          num_bytes_sent_since_shm_write += packet_size_bytes;
+        num_bytes_sent_since_shm_write += packet_size_bytes;
 
 	  // num_bytes_sent is used as a mechanism for exiting the
 	  // while loop (see below) by comparing it with max_free_bytes
@@ -1264,120 +1333,110 @@ void BPFwder::Start(uint32_t num_pkts_to_process, uint32_t max_iterations)
 	    bytes_avail[path_ctrl_index]  = 0;
 	  }
 
-          // Send the packet id if (a) someone already marked it (for instance,
-          // if this packet arrived with metadata), (b) we are configured to do
-          // packet tracing, or (c) we need it for latency sensing.
-          packet->set_send_packet_id(packet->send_packet_id() ||
-                                     do_packet_tracing_ ||
-                                     packet->track_ttg());
-
-          // Modify the flow statistics for the path controller. Note: If the
-          // transmission fails or the path controller for some reason does not
-          // transmit the packet, the accuracy of the flow statistics may
-          // decrease.
-          path_ctrls_[path_ctrl_index].flow_stats.Record(packet);
-
-          // TODO This is a very inefficient way to drop zombies, since by now
-          // we've generated a whole new packet and done some stuff with it. Fix
-          // that if/when we decide dropping zombies on dequeue is the right
-          // things to do. (For now, this is just keeping "drop instead of
-          // dequeue" as a minimal change.)
-          bool dropped_zombie = false;
-          if (drop_dequeued_zombies_ ||
-               ((packet->virtual_length() < kMinZombieLenBytes)
-              && packet->IsZombie()))
-          {
-            dropped_zombie = true;
-            LogD(kClassName, __func__,
+        // Send the packet id if (a) someone already marked it (for instance,
+        // if this packet arrived with metadata), (b) we are configured to do
+        // packet tracing, or (c) we need it for latency sensing.
+        packet->set_send_packet_id(packet->send_packet_id() ||
+                                   do_packet_tracing_ ||
+                                   packet->track_ttg());
+
+        // Modify the flow statistics for the path controller. Note: If the
+        // transmission fails or the path controller for some reason does not
+        // transmit the packet, the accuracy of the flow statistics may
+        // decrease.
+        path_ctrls_[path_ctrl_index].flow_stats.Record(packet);
+
+        // TODO This is a very inefficient way to drop zombies, since by now
+        // we've generated a whole new packet and done some stuff with it. Fix
+        // that if/when we decide dropping zombies on dequeue is the right
+        // things to do. (For now, this is just keeping "drop instead of
+        // dequeue" as a minimal change.)
+        bool dropped_zombie = false;
+        if (drop_dequeued_zombies_ ||
+             ((packet->virtual_length() < kMinZombieLenBytes)
+            && packet->IsZombie()))
+        {
+          dropped_zombie = true;
+          LogD(kClassName, __func__,
 		 "SEND: Zombie Dequeued. Drop. (%p, %s)\n",
-                 packet, packet->GetPacketMetadataString().c_str());
-            TRACK_EXPECTED_DROP(kClassName, packet_pool_);
-            packet_pool_.Recycle(packet);
-          }
+               packet, packet->GetPacketMetadataString().c_str());
+          TRACK_EXPECTED_DROP(kClassName, packet_pool_);
+          packet_pool_.Recycle(packet);
+        }
 	  DstVec  dst_vec = packet->dst_vec();
-          if (dropped_zombie || path_ctrl->SendPacket(packet))
-          {
-            // Ownership of packet has been transferred to the path controller.
-            packet = NULL;
+        if (dropped_zombie || path_ctrl->SendPacket(packet))
+        {
+          // Ownership of packet has been transferred to the path controller.
+          packet = NULL;
 
-            if (packet_has_ip_hdr)
-            {
-              bpf_stats_.IncrementNumDataBytesSentToBinOnPathCtrl(
-                path_ctrl, xmit_bin_idx, packet_size_bytes,
+          if (packet_has_ip_hdr)
+          {
+            bpf_stats_.IncrementNumDataBytesSentToBinOnPathCtrl(
+              path_ctrl, xmit_bin_idx, packet_size_bytes,
 		dst_vec);
-            }
           }
-          else
+        }
+        else
+        {
+          // DO NOT DROP THE PACKET HERE!!!!
+          //
+          // The packet should go back into the correct bin exactly where it
+          // was before the forwarding algorithm dequeued it.  Dropping the
+          // packet will lower the bin depths, and if enough packets are
+          // dropped, then admission control will speed up, causing the
+          // proxies to use more packets, .... BOOM!
+          //
+          // \todo The current APIs do not support putting the packet back
+          // into the bin where it was before.  For now, treat the packet as
+          // if it just arrived in order to at least get it back into the
+          // correct bin.
+          LogE(kClassName, __func__, "Error sending packet via Path "
+               "Controller. Re-enqueueing the packet.\n");
+          ForwardPacket(packet, xmit_bin_idx);
+          packet = NULL;
+        }
+
+        if (num_bytes_sent_since_shm_write >= min_qd_change_shm_bytes_)
+        {
+          if (!queue_store_->PublishWQueueDepthsToShm())
           {
-            // DO NOT DROP THE PACKET HERE!!!!
-            //
-            // The packet should go back into the correct bin exactly where it
-            // was before the forwarding algorithm dequeued it.  Dropping the
-            // packet will lower the bin depths, and if enough packets are
-            // dropped, then admission control will speed up, causing the
-            // proxies to use more packets, .... BOOM!
-            //
-            // \todo The current APIs do not support putting the packet back
-            // into the bin where it was before.  For now, treat the packet as
-            // if it just arrived in order to at least get it back into the
-            // correct bin.
-            LogE(kClassName, __func__, "Error sending packet via Path "
-                 "Controller. Re-enqueueing the packet.\n");
-            ForwardPacket(packet, xmit_bin_idx);
-            packet = NULL;
+            LogW(kClassName, __func__,
+                 "Could not write queue depths to shared memory.\n");
           }
-
-          if (num_bytes_sent_since_shm_write >= min_qd_change_shm_bytes_)
+          else
           {
-            if (!queue_store_->PublishWQueueDepthsToShm())
-            {
-              LogW(kClassName, __func__,
-                   "Could not write queue depths to shared memory.\n");
-            }
-            else
-            {
-              LogD(kClassName, __func__,
-                   "Wrote queue depths to shared memory early after sending %"
-                   PRIu32 "B.\n", num_bytes_sent_since_shm_write);
-              num_bytes_sent_since_shm_write  = 0;
-              num_bytes_processed_            = 0;
-            }
+            LogD(kClassName, __func__,
+                 "Wrote queue depths to shared memory early after sending %"
+                 PRIu32 "B.\n", num_bytes_sent_since_shm_write);
+            num_bytes_sent_since_shm_write  = 0;
+            num_bytes_processed_            = 0;
           }
         }
-        if (num_pkts_to_process != 0)
-        {
-          // Counter for halting unit tests.
-          pkts_processed += num_solutions;
-        }
       }
-    } while ((num_solutions > 0) && (multi_deq_ && (num_bytes_sent <
-      max_free_bytes)));
+      num_solutions_found += num_solutions;
+    }
+  } while ((num_solutions > 0) && (multi_deq_ && (num_bytes_sent <
+    max_free_bytes)));
 
-    if (num_bytes_sent_since_shm_write + num_bytes_processed_ != 0)
+  if (num_bytes_sent_since_shm_write + num_bytes_processed_ != 0)
+  {
+    if (!queue_store_->PublishWQueueDepthsToShm())
     {
-      if (!queue_store_->PublishWQueueDepthsToShm())
-      {
-        LogW(kClassName, __func__,
-             "Could not write queue depths to shared memory.\n");
-      }
-      else
-      {
-        LogD(kClassName, __func__,
-             "Wrote queue depths to shared memory after sending %" PRIu32
-             "B and processing %" PRIu32 "B.\n",
-             num_bytes_sent_since_shm_write,
-             num_bytes_processed_);
-      }
-      num_bytes_processed_            = 0;
+      LogW(kClassName, __func__,
+           "Could not write queue depths to shared memory.\n");
     }
-
-    // Check if we need to halt for unit tests.
-    if ((num_pkts_to_process != 0 && pkts_processed >= num_pkts_to_process) ||
-        (max_iterations != 0 && num_iterations >= max_iterations))
+    else
     {
-      running_ = false;
+      LogD(kClassName, __func__,
+           "Wrote queue depths to shared memory after sending %" PRIu32
+           "B and processing %" PRIu32 "B.\n",
+           num_bytes_sent_since_shm_write,
+           num_bytes_processed_);
     }
+    num_bytes_processed_            = 0;
   }
+
+  return num_solutions_found;
 }
 
 //============================================================================
@@ -1453,6 +1512,13 @@ void BPFwder::ReceiveFromProxy(PacketFifo& fifo, const char* proxy_name)
 //============================================================================
 void BPFwder::ProcessRcvdPacket(Packet* packet, PathController* path_ctrl)
 {
+  if (trace_writer_)
+  {
+    trace_writer_->RecordPacket(
+      (path_ctrl ? static_cast<uint8_t>(path_ctrl->path_controller_number()) :
+       iron::kTraceProxyPathCtrlNum), packet);
+  }
+
   // Figure out what type of packet we have received and process it
   // appropriately.
   PacketType  pkt_type = packet->GetType();
@@ -1861,6 +1927,25 @@ bool BPFwder::InitializeFifos()
   return true;
 }
 
+//============================================================================
+PathController* BPFwder::CreatePathController(const string& type)
+{
+  if (type == "Sond")
+  {
+    return new (std::nothrow) Sond(this, packet_pool_, timer_);
+  }
+
+  if (type == "SliqCat")
+  {
+    return new (std::nothrow) SliqCat(this, packet_pool_, timer_);
+  }
+
+  LogE(kClassName, __func__, "Unknown Path Controller type %s.\n",
+       type.c_str());
+
+  return NULL;
+}
+
 //============================================================================
 void BPFwder::SendGram()
 {
@@ -2288,9 +2373,12 @@ Packet* BPFwder::GenerateLsa()
   lsa_info_.Clear(def_info);
 
   NodeRecord*  node_record = AccessOrAllocateNodeRecord(my_bin_idx_);
-  bool         clear_cache = false;
+  bool         pdd_changed = false;
+  bool         pc_changed[kMaxPathCtrls];
   bool         send_lsa    = false;
 
+  memset(pc_changed, 0, sizeof(pc_changed));
+
   if (node_record == NULL)
   {
     LogE(kClassName, __func__, "Error getting node record for my bin index %"
@@ -2316,10 +2404,20 @@ Packet* BPFwder::GenerateLsa()
     Time  pdd_mean(path_ctrls_[pc_i].pdd_mean_sec);
     Time  pdd_sd(path_ctrls_[pc_i].pdd_std_dev_sec);
 
+    PathCtrlInfo&  pc_info = path_ctrls_[pc_i];
+
     if (pdd_mean.IsZero())
     {
       LogD(kClassName, __func__, "Path ctrl %" PRIu8 " has no PDD.\n",
            path_ctrl->path_controller_number());
+
+      if ((pc_info.lsa_pdd_mean_us != 0) || (pc_info.lsa_pdd_var_us2 != 0))
+      {
+        pc_info.lsa_pdd_mean_us = 0;
+        pc_info.lsa_pdd_var_us2 = 0;
+        pc_changed[pc_i]        = true;
+        pdd_changed             = true;
+      }
       continue;
     }
 
@@ -2353,6 +2451,16 @@ Packet* BPFwder::GenerateLsa()
       pdd_var_us2 = pdd_val_us * pdd_val_us;
     }
 
+    // Only a change in the rounded PDD invalidates the cached latencies.
+    if ((pc_info.lsa_pdd_mean_us != pdd_mean.GetTimeInUsec()) ||
+        (pc_info.lsa_pdd_var_us2 != pdd_var_us2))
+    {
+      pc_info.lsa_pdd_mean_us = pdd_mean.GetTimeInUsec();
+      pc_info.lsa_pdd_var_us2 = pdd_var_us2;
+      pc_changed[pc_i]        = true;
+      pdd_changed             = true;
+    }
+
     BinIndex  nbr_bin_idx  = path_ctrl->remote_bin_idx();
 
     if (nbr_bin_idx == iron::kInvalidBinIndex)
@@ -2400,6 +2508,12 @@ Packet* BPFwder::GenerateLsa()
 
     NodeInfo&  node_info = node_record->records_[nbr_bin_idx];
 
+    // A new link to a neighbor changes the virtual queue hop counts.
+    if (node_info.nbr_lat_mean_ == UINT32_MAX)
+    {
+      virt_queue_topo_changed_ = true;
+    }
+
     node_info.nbr_lat_mean_ = lsa_info_[nbr_bin_idx].nbr_lat_mean_;
     node_info.nbr_lat_var_  = lsa_info_[nbr_bin_idx].nbr_lat_var_;
 
@@ -2408,14 +2522,11 @@ Packet* BPFwder::GenerateLsa()
     uint8_t d                                     = 0;
     GetEncodedCapacity(nbr_bin_idx, e, i, d);
     node_info.capacity_ = DecodeCapacity(e, i, d);
-    clear_cache = true;
   }
 
-  // Consider clearing the cache.
-  if (clear_cache)
+  if (pdd_changed)
   {
-    LogD(kClassName, __func__, "Resetting cache.\n");
-    latency_cache_reset_time_ = Time::Now();
+    InvalidateCachedLatencies(pc_changed);
   }
 
   if (!send_lsa)
@@ -3949,6 +4060,13 @@ void BPFwder::ProcessCapacityUpdate(PathController* path_ctrl,
                                     double chan_cap_est_bps,
                                     double trans_cap_est_bps)
 {
+  if ((trace_writer_) && (path_ctrl))
+  {
+    trace_writer_->RecordCapacity(
+      static_cast<uint8_t>(path_ctrl->path_controller_number()),
+      chan_cap_est_bps, trans_cap_est_bps);
+  }
+
   // The QLAM rate computation is as follows.
   //
   // The QLAM capacity = Cx, where C is path controller capacity and x is the
@@ -4082,6 +4200,13 @@ void BPFwder::ProcessPktDelDelay(PathController* path_ctrl, double pdd_mean,
     return;
   }
 
+  if (trace_writer_)
+  {
+    trace_writer_->RecordPdd(
+      static_cast<uint8_t>(path_ctrl->path_controller_number()), pdd_mean,
+      pdd_variance);
+  }
+
   if (!ls_latency_collection_)
   {
     return;
@@ -4159,6 +4284,21 @@ void BPFwder::ProcessPktDelDelay(PathController* path_ctrl, double pdd_mean,
       "Hold down timer already set.\n");
 }
 
+//============================================================================
+bool BPFwder::GetXmitQueueSize(PathController* path_ctrl, size_t& size)
+{
+  bool  valid = path_ctrl->GetXmitQueueSize(size);
+
+  if (trace_writer_)
+  {
+    trace_writer_->RecordXmitQueueSize(
+      static_cast<uint8_t>(path_ctrl->path_controller_number()), valid,
+      size);
+  }
+
+  return valid;
+}
+
 //============================================================================
 bool BPFwder::ComputeNextQlamTimer(PathCtrlInfo& pc_info, Time& next_exp_time)
 {
@@ -4333,11 +4473,32 @@ bool BPFwder::GetPerPcLatencyToDst(BinIndex dst_idx, uint32_t* all_latency_us,
        "Cache miss for destination bin id %s, will recompute.\n",
        bin_map_shm_.GetIdToLog(dst_idx).c_str());
 
-  // Convert the LSA records to a connection matrix (and a variance matrix).
-  ConvertNodeRecordsToMatrix();
+  if (conditional_dags_)
+  {
+    // The excluded nodes depend on the packet history, so the connection
+    // matrix and the minimum latency paths must be computed each time.
+    ConvertNodeRecordsToMatrix();
+    FindMinimumLatencyPath(dst_idx);
+  }
+  else if (!path_info_.LoadSpfResult(dst_idx))
+  {
+    // Convert the LSA records to a connection matrix (and a variance
+    // matrix), unless no node records changed since the last conversion.
+    if (!lsa_matrix_current_)
+    {
+      ConvertNodeRecordsToMatrix();
+    }
 
-  // Use the connection matrix to find the minimum latency path to the dst.
-  FindMinimumLatencyPath(dst_idx);
+    // Use the connection matrix to find the minimum latency path to the dst,
+    // and keep the result until an LSA changes an entry it depends on.
+    FindMinimumLatencyPath(dst_idx);
+    path_info_.SaveSpfResult(dst_idx);
+  }
+  else
+  {
+    LogD(kClassName, __func__, "Reusing minimum latency paths to "
+         "destination bin id %s.\n", bin_map_shm_.GetIdToLog(dst_idx).c_str());
+  }
 
   for (size_t pc_i = 0; pc_i < num_path_ctrls_; ++pc_i)
   {
@@ -4619,36 +4780,9 @@ void BPFwder::ConvertNodeRecordsToMatrix()
         node_info = node_record->records_[nbr_idx];
       }
 
-      if (bin_idx == nbr_idx)
-      {
-        // cost_matrix[bin_idx][nbr_idx] = 0
-        path_info_.LatMean(bin_idx, nbr_idx) = 0;
-        path_info_.LatVar(bin_idx, nbr_idx)  = 0;
-      }
-      else
-      {
-        // cost_matrix[bin_idx][nbr_idx] = latency
-        path_info_.LatMean(bin_idx, nbr_idx) = node_info.nbr_lat_mean_;
-        path_info_.LatVar(bin_idx, nbr_idx)  = node_info.nbr_lat_var_;
-      }
-
-      if (incl_queue_delays_)
-      {
-        if (infinity >
-            static_cast<uint64_t>(node_info.queue_delay_) +
-            static_cast<uint64_t>(path_info_.LatMean(bin_idx, nbr_idx)))
-        {
-          // Include queue latency.
-          // This adds the queuing delay for the node itself in the matrix, but
-          // that value is (correctly) ignored when computing the overall
-          // latency in FindMinimumLatencyPath.
-          path_info_.LatMean(bin_idx, nbr_idx) += node_info.queue_delay_;
-        }
-        else
-        {
-          path_info_.LatMean(bin_idx, nbr_idx) = infinity;
-        }
-      }
+      ComputeMatrixEntry(bin_idx, nbr_idx, node_info,
+                         path_info_.LatMean(bin_idx, nbr_idx),
+                         path_info_.LatVar(bin_idx, nbr_idx));
     }
   }
 
@@ -4677,6 +4811,197 @@ void BPFwder::ConvertNodeRecordsToMatrix()
       path_info_.LatVar(exclude_bin_idx, bin_idx) = 0;
     }
   }
+
+  // The matrix can be reused until a node record changes, as long as the
+  // same nodes are excluded.
+  lsa_matrix_current_ = ((path_info_.num_nodes_to_exclude_ == 1) &&
+                         (path_info_.nodes_to_exclude_[0] == my_bin_idx_));
+}
+
+//============================================================================
+void BPFwder::ComputeMatrixEntry(BinIndex bin_idx, BinIndex nbr_idx,
+                                 const NodeInfo& node_info,
+                                 uint32_t& lat_mean, uint64_t& lat_var)
+{
+  if (bin_idx == nbr_idx)
+  {
+    // cost_matrix[bin_idx][nbr_idx] = 0
+    lat_mean = 0;
+    lat_var  = 0;
+  }
+  else
+  {
+    // cost_matrix[bin_idx][nbr_idx] = latency
+    lat_mean = node_info.nbr_lat_mean_;
+    lat_var  = node_info.nbr_lat_var_;
+  }
+
+  if (incl_queue_delays_)
+  {
+    if (UINT32_MAX >
+        static_cast<uint64_t>(node_info.queue_delay_) +
+        static_cast<uint64_t>(lat_mean))
+    {
+      // Include queue latency.
+      // This adds the queuing delay for the node itself in the matrix, but
+      // that value is (correctly) ignored when computing the overall
+      // latency in FindMinimumLatencyPath.
+      lat_mean += node_info.queue_delay_;
+    }
+    else
+    {
+      lat_mean = UINT32_MAX;
+    }
+  }
+}
+
+//============================================================================
+bool BPFwder::ProcessNodeRecordUpdate(BinIndex bin_idx,
+                                      NodeRecord* node_record)
+{
+  bool      matrix_changed = false;
+  BinIndex  nbr_idx        = 0;
+
+  for (bool nbr_valid = bin_map_shm_.GetFirstPhyBinIndex(nbr_idx);
+       nbr_valid;
+       nbr_valid = bin_map_shm_.GetNextPhyBinIndex(nbr_idx))
+  {
+    const NodeInfo&  old_info = lsa_prev_info_[nbr_idx];
+    const NodeInfo&  new_info = node_record->records_[nbr_idx];
+
+    // The virtual queue hop counts only depend on which links exist.
+    if ((old_info.nbr_lat_mean_ == UINT32_MAX) !=
+        (new_info.nbr_lat_mean_ == UINT32_MAX))
+    {
+      virt_queue_topo_changed_ = true;
+    }
+
+    // This node is always excluded from the latency computations, so its
+    // row and column never reach the shortest path results.
+    if ((bin_idx == my_bin_idx_) || (nbr_idx == my_bin_idx_))
+    {
+      continue;
+    }
+
+    uint32_t  old_mean = 0;
+    uint64_t  old_var  = 0;
+    uint32_t  new_mean = 0;
+    uint64_t  new_var  = 0;
+
+    ComputeMatrixEntry(bin_idx, nbr_idx, old_info, old_mean, old_var);
+    ComputeMatrixEntry(bin_idx, nbr_idx, new_info, new_mean, new_var);
+
+    if ((old_mean == new_mean) && (old_var == new_var))
+    {
+      continue;
+    }
+
+    matrix_changed = true;
+
+    if (conditional_dags_)
+    {
+      // The saved results are not used with conditional DAGs, and the
+      // latency cache is reset as a whole below.
+      continue;
+    }
+
+    // Only recompute the destinations whose shortest path result may
+    // depend on this entry.
+    BinIndex  dst_idx = 0;
+
+    for (bool dst_valid = bin_map_shm_.GetFirstPhyBinIndex(dst_idx);
+         dst_valid;
+         dst_valid = bin_map_shm_.GetNextPhyBinIndex(dst_idx))
+    {
+      if (path_info_.SpfValid(dst_idx) &&
+          path_info_.SpfResultUsesEdge(dst_idx, bin_idx, nbr_idx, old_mean,
+                                       old_var, new_mean, new_var))
+      {
+        LogD(kClassName, __func__, "Entry %s->%s changed, recomputing paths "
+             "to %s.\n", bin_map_shm_.GetIdToLog(bin_idx).c_str(),
+             bin_map_shm_.GetIdToLog(nbr_idx).c_str(),
+             bin_map_shm_.GetIdToLog(dst_idx).c_str());
+        path_info_.InvalidateSpfResult(dst_idx);
+        EraseCachedLatency(dst_idx);
+      }
+    }
+  }
+
+  if (matrix_changed)
+  {
+    lsa_matrix_current_ = false;
+
+    if (conditional_dags_)
+    {
+      LogD(kClassName, __func__, "Resetting cache.\n");
+      latency_cache_reset_time_ = Time::Now();
+    }
+  }
+
+  return matrix_changed;
+}
+
+//============================================================================
+void BPFwder::EraseCachedLatency(BinIndex dst_idx)
+{
+  CacheKey            cache_key(dst_idx & 0xFF);
+  CachedLatencyData*  cached_data = NULL;
+
+  while (latency_cache_.FindAndRemove(cache_key, cached_data))
+  {
+    if (cached_data != NULL)
+    {
+      cached_data->DestroyLatencies();
+      delete cached_data;
+      cached_data = NULL;
+    }
+  }
+}
+
+//============================================================================
+void BPFwder::InvalidateCachedLatencies(const bool* pc_changed)
+{
+  if (conditional_dags_)
+  {
+    // The cache keys also hold the visit history, so reset the whole cache.
+    LogD(kClassName, __func__, "Resetting cache.\n");
+    latency_cache_reset_time_ = Time::Now();
+    return;
+  }
+
+  BinIndex  dst_idx = 0;
+
+  for (bool dst_valid = bin_map_shm_.GetFirstPhyBinIndex(dst_idx);
+       dst_valid;
+       dst_valid = bin_map_shm_.GetNextPhyBinIndex(dst_idx))
+  {
+    // Without a saved result, any cached entry is erased.
+    bool  erase = !path_info_.SpfValid(dst_idx);
+
+    for (size_t pc_i = 0; ((!erase) && (pc_i < num_path_ctrls_)); ++pc_i)
+    {
+      PathController*  path_ctrl = path_ctrls_[pc_i].path_ctrl;
+
+      if ((!pc_changed[pc_i]) || (path_ctrl == NULL))
+      {
+        continue;
+      }
+
+      BinIndex  nbr_idx = path_ctrl->remote_bin_idx();
+
+      // The cached latency through an unreachable neighbor is the maximum
+      // value, whatever the PDD is.
+      erase = ((!bin_map_shm_.BinIndexIsAssigned(nbr_idx)) ||
+               path_info_.SpfResultReaches(dst_idx, nbr_idx));
+    }
+
+    if (erase)
+    {
+      LogD(kClassName, __func__, "PDD changed, erasing cached latencies to "
+           "%s.\n", bin_map_shm_.GetIdToLog(dst_idx).c_str());
+      EraseCachedLatency(dst_idx);
+    }
+  }
 }
 
 //============================================================================
@@ -4719,10 +5044,24 @@ void BPFwder::PrintMatrix(BPFwder::PathInfo& path_info)
 //============================================================================
 void BPFwder::UpdateVirtQueues()
 {
-  // Update virtual queues for self.  The results are in virt_queue_info_.
-  ComputeVirtQueues(my_bin_idx_);
+  // The hop counts only need to be recomputed if the node adjacencies have
+  // changed since the last update, or if a neighbor has changed.  Only the
+  // virtual queue depths that differ from the computed values are set.
+  bool  topo_changed       = virt_queue_topo_changed_;
+  bool  depths_updated     = false;
+  virt_queue_topo_changed_ = false;
 
-  BinIndex  bin_idx = 0;
+  // Update virtual queues for self.
+  BinIndexableArray<uint32_t>&  my_hops = virt_queue_hops_[kMaxPathCtrls];
+
+  if (topo_changed || (virt_queue_ref_idx_[kMaxPathCtrls] != my_bin_idx_))
+  {
+    ComputeVirtQueues(my_bin_idx_);
+    CopyVirtQueueHops(kMaxPathCtrls, my_bin_idx_);
+  }
+
+  QueueDepths*  my_qd   = queue_store_->GetVirtQueueDepths();
+  BinIndex      bin_idx = 0;
 
   for (bool valid = bin_map_shm_.GetFirstPhyBinIndex(bin_idx);
        valid;
@@ -4733,11 +5072,16 @@ void BPFwder::UpdateVirtQueues()
     // roll over and potentially cause problems downstream
 
     uint32_t  virt_queue_value =
-      ((virt_queue_info_[bin_idx].hop_count_ == UINT32_MAX) ? UINT32_MAX :
-       (virt_queue_info_[bin_idx].hop_count_ * virt_queue_mult_));
+      ((my_hops[bin_idx] == UINT32_MAX) ? UINT32_MAX :
+       (my_hops[bin_idx] * virt_queue_mult_));
+
+    if (my_qd->GetBinDepthByIdx(bin_idx) == virt_queue_value)
+    {
+      continue;
+    }
 
-    queue_store_->GetVirtQueueDepths()->SetBinDepthByIdx(
-      bin_idx, virt_queue_value);
+    my_qd->SetBinDepthByIdx(bin_idx, virt_queue_value);
+    depths_updated = true;
 
     LogD(kClassName, __func__, "Setting virtual queue depth of %"
          PRIu32 "B to reach node %s from node %s (self).\n",
@@ -4774,7 +5118,15 @@ void BPFwder::UpdateVirtQueues()
       continue;
     }
 
-    ComputeVirtQueues(nbr_bix);
+    if (topo_changed || (virt_queue_ref_idx_[pc_i] != nbr_bix))
+    {
+      ComputeVirtQueues(nbr_bix);
+      CopyVirtQueueHops(pc_i, nbr_bix);
+    }
+
+    BinIndexableArray<uint32_t>&  nbr_hops = virt_queue_hops_[pc_i];
+    QueueDepths*                  nbr_qd   =
+      queue_store_->PeekNbrVirtQueueDepths(nbr_bix);
 
     for (bool valid = bin_map_shm_.GetFirstPhyBinIndex(bin_idx);
          valid;
@@ -4785,8 +5137,14 @@ void BPFwder::UpdateVirtQueues()
       // roll over and potentially cause problems downstream
 
       uint32_t  virt_queue_value =
-	((virt_queue_info_[bin_idx].hop_count_ == UINT32_MAX) ? UINT32_MAX :
-	 (virt_queue_info_[bin_idx].hop_count_ * virt_queue_mult_));
+	((nbr_hops[bin_idx] == UINT32_MAX) ? UINT32_MAX :
+	 (nbr_hops[bin_idx] * virt_queue_mult_));
+
+      if ((nbr_qd != NULL) &&
+          (nbr_qd->GetBinDepthByIdx(bin_idx) == virt_queue_value))
+      {
+        continue;
+      }
 
       if (ApplyVirtQueueSet(bin_idx, nbr_bix, virt_queue_value))
       {
@@ -4797,6 +5155,10 @@ void BPFwder::UpdateVirtQueues()
 	     virt_queue_value,
 	     bin_map_shm_.GetIdToLog(bin_idx).c_str(),
 	     bin_map_shm_.GetIdToLog(nbr_bix).c_str());
+        depths_updated = true;
+
+        // The first successful set may have created the depths object.
+        nbr_qd = queue_store_->PeekNbrVirtQueueDepths(nbr_bix);
       }
       else
       {
@@ -4811,7 +5173,26 @@ void BPFwder::UpdateVirtQueues()
   }
 
   // Since these have been updated, log them if "I" is set
-  LogForwardingBiases();
+  if (depths_updated)
+  {
+    LogForwardingBiases();
+  }
+}
+
+//============================================================================
+void BPFwder::CopyVirtQueueHops(size_t hops_idx, BinIndex ref_bin_idx)
+{
+  BinIndexableArray<uint32_t>&  hops    = virt_queue_hops_[hops_idx];
+  BinIndex                      bin_idx = 0;
+
+  for (bool valid = bin_map_shm_.GetFirstPhyBinIndex(bin_idx);
+       valid;
+       valid = bin_map_shm_.GetNextPhyBinIndex(bin_idx))
+  {
+    hops[bin_idx] = virt_queue_info_[bin_idx].hop_count_;
+  }
+
+  virt_queue_ref_idx_[hops_idx] = ref_bin_idx;
 }
 
 //============================================================================
@@ -5423,10 +5804,19 @@ void BPFwder::ProcessLsa(BinIndex src_bin_index,
     }
   }
 
-  // Copy the new NodeInfo values into the node record.  Do this for unicast
-  // destination, interior node, and multicast destination bin indexes.
+  // Remember the previous contents of the node record, so that only the
+  // state depending on entries that actually changed is recomputed.
   BinIndex  bin_idx = kInvalidBinIndex;
 
+  for (bool bin_idx_valid = bin_map_shm_.GetFirstPhyBinIndex(bin_idx);
+       bin_idx_valid;
+       bin_idx_valid = bin_map_shm_.GetNextPhyBinIndex(bin_idx))
+  {
+    lsa_prev_info_[bin_idx] = node_record->records_[bin_idx];
+  }
+
+  // Copy the new NodeInfo values into the node record.  Do this for unicast
+  // destination, interior node, and multicast destination bin indexes.
   for (bool bin_idx_valid = bin_map_shm_.GetFirstBinIndex(bin_idx);
        bin_idx_valid;
        bin_idx_valid = bin_map_shm_.GetNextBinIndex(bin_idx))
@@ -5463,10 +5853,17 @@ void BPFwder::ProcessLsa(BinIndex src_bin_index,
          bin_id);
   }
 
-  // TODO: Consider if we could clear out only portions of the cache.
-  LogD(kClassName, __func__, "Resetting cache.\n");
-  Time now                  = Time::Now();
-  latency_cache_reset_time_ = now;
+  // Invalidate the cached latencies and shortest paths that depend on the
+  // changed entries.  Most LSAs repeat the previous information, in which
+  // case nothing needs to be recomputed.
+  if (!ProcessNodeRecordUpdate(src_bin_index, node_record))
+  {
+    LogD(kClassName, __func__, "LSA from node %s did not change the "
+         "connection matrix.\n",
+         bin_map_shm_.GetIdToLog(src_bin_index).c_str());
+  }
+
+  Time  now = Time::Now();
 
   // Update the historyless latency cache.
   if ((now.GetTimeInMsec() - latency_pbpp_update_time_ms_) >
@@ -5892,15 +6289,24 @@ bool BPFwder::PathInfo::Initialize(BinMap& bin_map)
   visited_      = new (std::nothrow) bool[num_];
   min_cost_     = new (std::nothrow) uint32_t[num_];
 
+  spf_valid_    = new (std::nothrow) bool[num_];
+  spf_lat_mean_ = new (std::nothrow) uint32_t[num_ * num_];
+  spf_lat_var_  = new (std::nothrow) uint64_t[num_ * num_];
+  spf_next_hop_ = new (std::nothrow) uint32_t[num_ * num_];
+  spf_cost_     = new (std::nothrow) uint32_t[num_ * num_];
+
   if ((nodes_to_exclude_ == NULL) || (lat_mean_matrix_ == NULL) ||
       (lat_var_matrix_ == NULL) || (min_lat_mean_ == NULL) ||
       (min_lat_var_ == NULL) || (next_hop_ == NULL) || (visited_ == NULL) ||
-      (min_cost_ == NULL))
+      (min_cost_ == NULL) || (spf_valid_ == NULL) ||
+      (spf_lat_mean_ == NULL) || (spf_lat_var_ == NULL) ||
+      (spf_next_hop_ == NULL) || (spf_cost_ == NULL))
   {
     return false;
   }
 
   ResetMatrixes();
+  InvalidateSpfResults();
 
   for (size_t i = 0; i < num_; ++i)
   {
@@ -5944,6 +6350,75 @@ void BPFwder::PathInfo::ResetArrays(BinIndex src)
   }
 }
 
+//============================================================================
+void BPFwder::PathInfo::SaveSpfResult(BinIndex src)
+{
+  size_t  row = (a_idx_[src] * num_);
+
+  memcpy(&(spf_lat_mean_[row]), min_lat_mean_, (num_ * sizeof(uint32_t)));
+  memcpy(&(spf_lat_var_[row]),  min_lat_var_,  (num_ * sizeof(uint64_t)));
+  memcpy(&(spf_next_hop_[row]), next_hop_,     (num_ * sizeof(uint32_t)));
+  memcpy(&(spf_cost_[row]),     min_cost_,     (num_ * sizeof(uint32_t)));
+
+  spf_valid_[a_idx_[src]] = true;
+}
+
+//============================================================================
+bool BPFwder::PathInfo::LoadSpfResult(BinIndex src)
+{
+  if (!spf_valid_[a_idx_[src]])
+  {
+    return false;
+  }
+
+  size_t  row = (a_idx_[src] * num_);
+
+  memcpy(min_lat_mean_, &(spf_lat_mean_[row]), (num_ * sizeof(uint32_t)));
+  memcpy(min_lat_var_,  &(spf_lat_var_[row]),  (num_ * sizeof(uint64_t)));
+  memcpy(next_hop_,     &(spf_next_hop_[row]), (num_ * sizeof(uint32_t)));
+  memcpy(min_cost_,     &(spf_cost_[row]),     (num_ * sizeof(uint32_t)));
+
+  return true;
+}
+
+//============================================================================
+void BPFwder::PathInfo::InvalidateSpfResults()
+{
+  if (spf_valid_ != NULL)
+  {
+    memset(spf_valid_, 0, (num_ * sizeof(bool)));
+  }
+}
+
+//============================================================================
+bool BPFwder::PathInfo::SpfResultUsesEdge(BinIndex src, BinIndex node,
+                                          BinIndex nbr, uint32_t old_mean,
+                                          uint64_t old_var, uint32_t new_mean,
+                                          uint64_t new_var)
+{
+  // The entries leading directly to the source are the initial costs, which
+  // are not compared against anything.
+  if (nbr == src)
+  {
+    return true;
+  }
+
+  size_t    row       = (a_idx_[src] * num_);
+  uint32_t  node_cost = spf_cost_[row + a_idx_[node]];
+  uint32_t  nbr_mean  = spf_lat_mean_[row + a_idx_[nbr]];
+  uint64_t  nbr_var   = spf_lat_var_[row + a_idx_[nbr]];
+
+  // These match the path cost computation in FindMinimumLatencyPath().
+  uint64_t  old_path  =
+    (static_cast<uint64_t>(nbr_mean) + static_cast<uint64_t>(old_mean) +
+     (2.2 * sqrt(nbr_var + old_var)));
+  uint64_t  new_path  =
+    (static_cast<uint64_t>(nbr_mean) + static_cast<uint64_t>(new_mean) +
+     (2.2 * sqrt(nbr_var + new_var)));
+
+  return ((old_path <= node_cost) || (new_path <= node_cost));
+}
+
 //============================================================================
 BPFwder::PathInfo::~PathInfo()
 {
@@ -6000,4 +6475,34 @@ BPFwder::PathInfo::~PathInfo()
     delete [] min_cost_;
     min_cost_ = NULL;
   }
+
+  if (spf_valid_ != NULL)
+  {
+    delete [] spf_valid_;
+    spf_valid_ = NULL;
+  }
+
+  if (spf_lat_mean_ != NULL)
+  {
+    delete [] spf_lat_mean_;
+    spf_lat_mean_ = NULL;
+  }
+
+  if (spf_lat_var_ != NULL)
+  {
+    delete [] spf_lat_var_;
+    spf_lat_var_ = NULL;
+  }
+
+  if (spf_next_hop_ != NULL)
+  {
+    delete [] spf_next_hop_;
+    spf_next_hop_ = NULL;
+  }
+
+  if (spf_cost_ != NULL)
+  {
+    delete [] spf_cost_;
+    spf_cost_ = NULL;
+  }
 }
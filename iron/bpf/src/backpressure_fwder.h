@@ -73,6 +73,7 @@
 
 namespace iron
 {
+  class BpfTraceWriter;
   class DebuggingStats;
   class FwdAlg;
   class PacketHistoryMgr;
@@ -263,6 +264,18 @@ namespace iron
     void ProcessPktDelDelay(PathController* path_ctrl, double pdd_mean,
                             double pdd_variance);
 
+    /// \brief Get the current transmit queue size of a path controller.
+    ///
+    /// All of the BPF's queue size queries go through this method, so that
+    /// the answers can be recorded when tracing.
+    ///
+    /// \param  path_ctrl  The path controller.
+    /// \param  size       A reference where the queue size, in bytes, is
+    ///                    placed.
+    ///
+    /// \return  The value returned by PathController::GetXmitQueueSize().
+    bool GetXmitQueueSize(PathController* path_ctrl, size_t& size);
+
     /// \brief  Get the per path controller latency to a destination.
     ///
     /// \param  dst_idx     The bin index of the destination.
@@ -324,6 +337,33 @@ namespace iron
     /// \return  True if the initialization is successful, false otherwise.
     virtual bool InitializeFifos();
 
+    /// \brief Create a Path Controller of the configured type.
+    ///
+    /// Child classes may override this to provide additional Path Controller
+    /// types (e.g., in-memory links for simulation).
+    ///
+    /// \param  type  The PathController.X.Type configuration value.
+    ///
+    /// \return  A pointer to the new, uninitialized Path Controller, or NULL
+    ///          if the type is unknown or the allocation fails.
+    virtual PathController* CreatePathController(const std::string& type);
+
+    /// \brief Start the statistics, LSA, and GRAM periodic timers.
+    ///
+    /// Called once by Start() before entering the main event loop.
+    void StartPeriodicTimers();
+
+    /// \brief Service the timers and run the forwarding algorithm once.
+    ///
+    /// This is the portion of each main event loop iteration that follows
+    /// the servicing of file descriptors: the timer callbacks are processed,
+    /// the queue values are periodically adjusted, packets are dequeued and
+    /// handed to the Path Controllers, and the weight queue depths are
+    /// published to shared memory.
+    ///
+    /// \return  The number of dequeue solutions found.
+    uint32_t ServiceTimersAndQueues();
+
     /// \brief Generate a new GRoup Advertisement Message (GRAM) packet.
     /// The GRAM format:
     ///
@@ -586,7 +626,9 @@ namespace iron
                    max_bin_idx_(0), num_(0), a_idx_(NULL),
                    lat_mean_matrix_(NULL), lat_var_matrix_(NULL),
                    min_lat_mean_(NULL), min_lat_var_(NULL), next_hop_(NULL),
-                   visited_(NULL), min_cost_(NULL) {}
+                   visited_(NULL), min_cost_(NULL), spf_valid_(NULL),
+                   spf_lat_mean_(NULL), spf_lat_var_(NULL), spf_next_hop_(NULL),
+                   spf_cost_(NULL) {}
 
       /// \brief  Initialize all of the path information.
       bool Initialize(BinMap& bin_map);
@@ -597,6 +639,79 @@ namespace iron
       /// \brief  Reset all of the path information arrays.
       void ResetArrays(BinIndex src);
 
+      /// \brief  Save the current path information arrays as the shortest
+      ///         path result for a source.
+      ///
+      /// Only results computed with this node as the sole excluded node may
+      /// be saved, since the saved results are reused without regard to the
+      /// exclusions.
+      ///
+      /// \param  src  The source bin index used to compute the arrays.
+      void SaveSpfResult(BinIndex src);
+
+      /// \brief  Restore the path information arrays from a saved shortest
+      ///         path result for a source.
+      ///
+      /// \param  src  The source bin index whose saved result is restored.
+      ///
+      /// \return  True if a valid saved result was restored, false otherwise.
+      bool LoadSpfResult(BinIndex src);
+
+      /// \brief  Invalidate all of the saved shortest path results.
+      void InvalidateSpfResults();
+
+      /// \brief  Check if a change to one matrix entry can alter the saved
+      ///         shortest path result for a source.
+      ///
+      /// The entry is the latency from node to nbr.  This is a conservative
+      /// check, not an exact proof.  The entry is flagged if the path through
+      /// it was, or becomes, no worse than the saved minimum cost for node,
+      /// or if it leads directly to the source (which seeds the initial
+      /// costs).  Any other change is assumed to leave the saved result
+      /// alone.
+      ///
+      /// \param  src       The source bin index of the saved result.
+      /// \param  node      The bin index of the matrix row that changed.
+      /// \param  nbr       The bin index of the matrix column that changed.
+      /// \param  old_mean  The previous mean latency entry, in microseconds.
+      /// \param  old_var   The previous latency variance entry, in
+      ///                   microseconds squared.
+      /// \param  new_mean  The new mean latency entry, in microseconds.
+      /// \param  new_var   The new latency variance entry, in microseconds
+      ///                   squared.
+      ///
+      /// \return  True if the saved result must be recomputed, false if it
+      ///          remains valid.
+      bool SpfResultUsesEdge(BinIndex src, BinIndex node, BinIndex nbr,
+                             uint32_t old_mean, uint64_t old_var,
+                             uint32_t new_mean, uint64_t new_var);
+
+      /// \brief  Check if a neighbor has a path in the saved shortest path
+      ///         result for a source.
+      ///
+      /// \param  src  The source bin index of the saved result.
+      /// \param  nbr  The bin index of the neighbor.
+      ///
+      /// \return  True if the neighbor can reach the source, false otherwise.
+      inline bool SpfResultReaches(BinIndex src, BinIndex nbr) const
+      {
+        return (spf_lat_mean_[((a_idx_[src] * num_) + a_idx_[nbr])] !=
+                UINT32_MAX);
+      }
+
+      /// \brief  Check if there is a valid saved shortest path result for a
+      ///         source.
+      inline bool SpfValid(BinIndex src) const
+      {
+        return spf_valid_[a_idx_[src]];
+      }
+
+      /// \brief  Invalidate the saved shortest path result for a source.
+      inline void InvalidateSpfResult(BinIndex src)
+      {
+        spf_valid_[a_idx_[src]] = false;
+      }
+
       /// \brief  Validate a bin index before using it.
       inline void ValidateBinIndex(BinIndex bin_idx)
       {
@@ -710,6 +825,22 @@ namespace iron
 
       /// The array of minimum cost values.
       uint32_t*  min_cost_;
+
+      /// The array of flags recording which sources have a valid saved
+      /// shortest path result.
+      bool*      spf_valid_;
+
+      /// The saved minimum latency values, one row per source.
+      uint32_t*  spf_lat_mean_;
+
+      /// The saved minimum latency variance values, one row per source.
+      uint64_t*  spf_lat_var_;
+
+      /// The saved next hop values, one row per source.
+      uint32_t*  spf_next_hop_;
+
+      /// The saved minimum cost values, one row per source.
+      uint32_t*  spf_cost_;
     };
 
     /// \brief  Print the converted connection matrix.
@@ -727,6 +858,52 @@ namespace iron
     /// The latency may be the max uint32_t value to signify infinity.
     void ConvertNodeRecordsToMatrix();
 
+    /// \brief  Compute one connection matrix entry from a node record entry.
+    ///
+    /// This does not account for excluded nodes.
+    ///
+    /// \param  bin_idx    The bin index of the node owning the record.
+    /// \param  nbr_idx    The bin index of the record entry.
+    /// \param  node_info  The record entry.
+    /// \param  lat_mean   The computed mean latency entry, in microseconds.
+    /// \param  lat_var    The computed latency variance entry, in
+    ///                    microseconds squared.
+    void ComputeMatrixEntry(BinIndex bin_idx, BinIndex nbr_idx,
+                            const NodeInfo& node_info, uint32_t& lat_mean,
+                            uint64_t& lat_var);
+
+    /// \brief  Invalidate the cached state that depends on a node record
+    ///         that has just been updated from an LSA.
+    ///
+    /// The previous contents of the node record must be in lsa_prev_info_.
+    /// Only the shortest path results and cached latencies for destinations
+    /// whose paths may have changed are invalidated, and the virtual queues
+    /// are flagged for recomputation only if the node's adjacencies changed.
+    ///
+    /// \param  bin_idx      The bin index of the node owning the record.
+    /// \param  node_record  The updated node record.
+    ///
+    /// \return  True if any connection matrix entry changed.
+    bool ProcessNodeRecordUpdate(BinIndex bin_idx, NodeRecord* node_record);
+
+    /// \brief  Remove a destination's entry from the latency cache.
+    ///
+    /// Only valid when not using conditional DAGs, where the cache key is
+    /// simply the destination bin index.
+    ///
+    /// \param  dst_idx  The destination bin index.
+    void EraseCachedLatency(BinIndex dst_idx);
+
+    /// \brief  Invalidate the cached latencies that depend on the PDD of
+    ///         path controllers that changed since the last LSA interval.
+    ///
+    /// A destination's entry is only erased if one of the changed path
+    /// controllers leads to a neighbor that has a path to the destination.
+    ///
+    /// \param  pc_changed  The array of flags, indexed by path controller,
+    ///                     recording which path controllers changed.
+    void InvalidateCachedLatencies(const bool* pc_changed);
+
     /// \brief  Update the virtual queue depths based on LSAs.
     virtual void UpdateVirtQueues();
 
@@ -747,6 +924,13 @@ namespace iron
     ///                      hop counts.
     void ComputeVirtQueues(BinIndex ref_bin_idx);
 
+    /// \brief  Save the hop counts computed by ComputeVirtQueues().
+    ///
+    /// \param  hops_idx     The index into virt_queue_hops_ to save the hop
+    ///                      counts in.
+    /// \param  ref_bin_idx  The bin index the hop counts were computed from.
+    void CopyVirtQueueHops(size_t hops_idx, BinIndex ref_bin_idx);
+
     /// \brief  Compute and log the forwarding biases using virtual queue info
     ///
     /// Forwarding bias terms are added to the queue differentials to help
@@ -767,9 +951,16 @@ namespace iron
     void FindMinimumLatencyPath(BinIndex src_bin_idx);
 
     /// \brief  Clear the latency cache.
+    ///
+    /// This also discards the saved shortest path results and marks the
+    /// connection matrix as stale, so it must be called after modifying the
+    /// node records directly.
     inline void ClearLatencyCache()
     {
       latency_cache_reset_time_ = Time::Now();
+      lsa_matrix_current_       = false;
+      virt_queue_topo_changed_  = true;
+      path_info_.InvalidateSpfResults();
     }
 
     /// The structure for virtual queue information.
@@ -803,6 +994,9 @@ namespace iron
     /// Boolean flag that remembers if we are running or not.
     bool                                     running_;
 
+    /// The recorder of BPF inputs, or NULL if tracing is disabled.
+    BpfTraceWriter*                          trace_writer_;
+
     /// The bin id of this IRON node. (Bin ids are guaranteed to map
     /// one-to-one to IRON nodes.)
     BinId                                    my_bin_id_;
@@ -858,6 +1052,23 @@ namespace iron
     /// The path information used for finding minimum latency paths.
     PathInfo                                 path_info_;
 
+    /// Flag recording if the connection matrix in path_info_ is up to date
+    /// with the node records, with only this node excluded.
+    bool                                     lsa_matrix_current_;
+
+    /// Flag recording if any node adjacencies have changed since the virtual
+    /// queue hop counts were last computed.
+    bool                                     virt_queue_topo_changed_;
+
+    /// The hop counts from the last virtual queue computation.  The array at
+    /// index kMaxPathCtrls is for this node, the others are for the neighbor
+    /// on the path controller with the same index.
+    BinIndexableArray<uint32_t>  virt_queue_hops_[kMaxPathCtrls + 1];
+
+    /// The reference bin index used for each array in virt_queue_hops_, or
+    /// kInvalidBinIndex if not computed yet.
+    BinIndex                     virt_queue_ref_idx_[kMaxPathCtrls + 1];
+
     private:
 
     /// Copy constructor.
@@ -1380,6 +1591,11 @@ namespace iron
     /// index.
     BinIndexableArray<NodeInfo>         lsa_info_;
 
+    /// The previous contents of a node record being updated from an LSA,
+    /// used to find which connection matrix entries changed.  Indexed by
+    /// unicast destination or interior node bin index.
+    BinIndexableArray<NodeInfo>         lsa_prev_info_;
+
     /// The interval between GRAMs.
     uint32_t                            gram_interval_ms_;
 
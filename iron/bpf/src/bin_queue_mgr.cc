@@ -55,6 +55,7 @@
 
 using ::iron::BinId;
 using ::iron::BinQueueMgr;
+using ::iron::DeadlineIndex;
 using ::iron::DropPolicy;
 using ::iron::LatencyClass;
 using ::iron::Log;
@@ -87,6 +88,10 @@ namespace
   /// latency.
   const bool      kZombieLatencyReduction       = true;
 
+  /// If true, index the latency-sensitive queues by packet deadline so that
+  /// expired packets can be found without walking the queues.
+  const bool      kDefaultUseDeadlineIndex      = true;
+
   /// \brief Identifies which queues are packet-less zombie queues.
   ///
   /// If the position for a latency class is false, this queue will contain
@@ -160,7 +165,11 @@ BinQueueMgr::BinQueueMgr(
       debug_stats_(NULL),
       queue_depths_xplot_(),
       last_dequeue_time_(),
-      non_zombie_queue_depth_bytes_()
+      non_zombie_queue_depth_bytes_(),
+      use_deadline_index_(kDefaultUseDeadlineIndex),
+      critical_deadlines_(),
+      low_lat_deadlines_(),
+      expired_entries_()
 {
   // Set up the neighbor queue depths array.
   if (!nbr_queue_depths_.Initialize(bin_map_))
@@ -249,6 +258,13 @@ bool BinQueueMgr::Initialize(const ConfigInfo& config_info,
     ef_ordering  = EF_ORDERING_TTG;
   }
 
+  // Set up the deadline index of the latency-sensitive queues. Any existing
+  // entries are forgotten along with the queues below.
+  use_deadline_index_ = config_info.GetBool("Bpf.BinQueueMgr.UseDeadlineIndex",
+                                            kDefaultUseDeadlineIndex);
+  critical_deadlines_.Clear();
+  low_lat_deadlines_.Clear();
+
   // Initialize the physical queue for the node's bin index.
   Ipv4Address dst_addr = bin_map_.GetViableDestAddr(my_bin_index_);
 
@@ -396,6 +412,8 @@ bool BinQueueMgr::Initialize(const ConfigInfo& config_info,
        (kDefaultZombieCompression ? "ON" : "OFF"));
   LogC(kClassName, __func__, "Zombie-based latency reduction:  %s\n",
        (do_zombie_latency_reduction_ ? "ON" : "OFF"));
+  LogC(kClassName, __func__, "Bpf.BinQueueMgr.UseDeadlineIndex:   %s\n",
+       (use_deadline_index_ ? "ON" : "OFF"));
   LogC(kClassName, __func__, "Bin Id: %s\n",
        bin_map_.GetIdToLog(my_bin_index_).c_str());
 
@@ -579,11 +597,21 @@ bool BinQueueMgr::Enqueue(Packet* pkt)
     return false;
   }
 
-  // Attempt to enqueue the packet.
-  bool          rv          = queue->Enqueue(pkt);
+  // Attempt to enqueue the packet.  Indexed packets keep the iterator
+  // pointing to them in the queue.
+  DeadlineIndex*               index = GetDeadlineIndex(lat);
+  PacketQueue::QueueWalkState  qws;
+  bool                         rv    =
+    (index ? static_cast<PacketQueue*>(queue)->Enqueue(pkt, qws) :
+     queue->Enqueue(pkt));
 
   if (rv)
   {
+    if (index)
+    {
+      index->Add(pkt, qws);
+    }
+
     OnEnqueue(pkt_size, lat, dst_vec);
     if (WouldLogD(kClassName))
     {
@@ -744,6 +772,7 @@ Packet* BinQueueMgr::DequeueAtCurrentIterator(uint8_t lat)
 
   if (pkt)
   {
+    RemoveFromDeadlineIndex(lat, pkt);
     DequeuedInfo info(pkt, pkt->dst_vec());
     OnDequeue(info, false);
   }
@@ -828,6 +857,7 @@ Packet* BinQueueMgr::Dequeue()
 
   if (pkt)
   {
+    RemoveFromDeadlineIndex(lat, pkt);
     DequeuedInfo info(pkt, pkt->dst_vec());
     OnDequeue(info, false);
   }
@@ -895,6 +925,10 @@ Packet* BinQueueMgr::DequeueAtIterator(LatencyClass lat,
 
   if (pkt)
   {
+    if (!cloned)
+    {
+      RemoveFromDeadlineIndex(lat, pkt);
+    }
     DequeuedInfo info(pkt, send_to);
     OnDequeue(info, cloned);
   }
@@ -922,6 +956,7 @@ Packet* iron::BinQueueMgr::Dequeue(LatencyClass lat, uint32_t max_size_bytes,
 
   if (pkt)
   {
+    RemoveFromDeadlineIndex(lat, pkt);
     DequeuedInfo info(pkt, dst_vec);
     OnDequeue(info, false);
   }
@@ -929,6 +964,103 @@ Packet* iron::BinQueueMgr::Dequeue(LatencyClass lat, uint32_t max_size_bytes,
   return pkt;
 }
 
+//============================================================================
+size_t BinQueueMgr::DequeueExpired(LatencyClass lat, const Time& threshold,
+                                   std::vector<Packet*>& pkts)
+{
+  DeadlineIndex*  index = GetDeadlineIndex(lat);
+  Queue*          queue = FindQueue(lat);
+
+  if (!index || !queue)
+  {
+    return 0;
+  }
+
+  expired_entries_.clear();
+  index->PopExpired(threshold, expired_entries_);
+
+  size_t  num_dequeued = 0;
+
+  for (size_t i = 0; i < expired_entries_.size(); ++i)
+  {
+    Packet*                      pkt = expired_entries_[i].pkt;
+    PacketQueue::QueueWalkState  qws = expired_entries_[i].qws;
+
+    if (!FindIndexedPkt(lat, pkt, expired_entries_[i].deadline_us, qws))
+    {
+      LogD(kClassName, __func__, "Skipping stale deadline index entry for "
+           "pkt %p in latency queue %s.\n", pkt,
+           LatencyClass_Name[lat].c_str());
+      continue;
+    }
+
+    pkt = static_cast<PacketQueue*>(queue)->DequeueAtIterator(qws);
+
+    if (pkt)
+    {
+      DequeuedInfo info(pkt, pkt->dst_vec());
+      OnDequeue(info, false);
+      pkts.push_back(pkt);
+      ++num_dequeued;
+    }
+  }
+
+  return num_dequeued;
+}
+
+//============================================================================
+bool BinQueueMgr::PeekEarliestDeadline(LatencyClass lat, Packet*& pkt,
+                                       Time& deadline,
+                                       PacketQueue::QueueWalkState& qws)
+{
+  DeadlineIndex*  index = GetDeadlineIndex(lat);
+
+  if (!index)
+  {
+    return false;
+  }
+
+  while (index->PeekEarliest(pkt, deadline, qws))
+  {
+    if (FindIndexedPkt(lat, pkt, deadline.GetTimeInUsec(), qws))
+    {
+      return true;
+    }
+
+    LogD(kClassName, __func__, "Removing stale deadline index entry for pkt "
+         "%p in latency queue %s.\n", pkt, LatencyClass_Name[lat].c_str());
+    index->Remove(pkt, deadline);
+  }
+
+  return false;
+}
+
+//============================================================================
+bool BinQueueMgr::FindIndexedPkt(LatencyClass lat, Packet* pkt,
+                                 int64_t deadline_us,
+                                 const PacketQueue::QueueWalkState& qws)
+{
+  Time  deadline;
+
+  if (!DeadlineIndex::GetDeadline(pkt, deadline) ||
+      (deadline.GetTimeInUsec() != deadline_us) ||
+      (pkt->GetLatencyClass() != lat))
+  {
+    return false;
+  }
+
+  Queue*  queue = FindQueue(lat);
+
+  if (!queue || IS_PKTLESS_Z_QUEUE[lat])
+  {
+    return false;
+  }
+
+  // The iterator saved at enqueue time no longer points to the packet if the
+  // packet left the queue.
+  return static_cast<PacketQueue*>(queue)->IsAtIterator(qws, pkt);
+}
+
 //============================================================================
 bool BinQueueMgr::ZombifyPacket(Packet* pkt)
 {
@@ -1069,7 +1201,15 @@ bool BinQueueMgr::CriticalizePacket(Packet* pkt)
     size_t  pkt_size = pkt->virtual_length();
     DstVec  dst_vec  = pkt->dst_vec();
     pkt->SetLatencyClass(CRITICAL_LATENCY);
-    bool    rv       = queue->Enqueue(pkt);
+
+    PacketQueue::QueueWalkState  qws;
+    bool                         rv  =
+      static_cast<PacketQueue*>(queue)->Enqueue(pkt, qws);
+
+    if (rv && use_deadline_index_)
+    {
+      critical_deadlines_.Add(pkt, qws);
+    }
 
     // MCAST TODO Has this packet already been dequeued from the normal
     // latency queue? (Worth double checking, because we no longer totally
@@ -53,6 +53,7 @@
 #include "asap.h"
 #include "bin_indexable_array.h"
 #include "bin_map.h"
+#include "deadline_index.h"
 #include "debugging_stats.h"
 #include "gradient.h"
 #include "genxplot.h"
@@ -62,6 +63,8 @@
 #include "queue_depths.h"
 #include "zlr.h"
 
+#include <vector>
+
 #include <stdint.h>
 
 
@@ -383,6 +386,49 @@ namespace iron
     ///         be dropped.
     bool CriticalizePacket(Packet* pkt);
 
+    /// \brief  Check if the latency-sensitive queues are indexed by packet
+    ///         deadline.
+    ///
+    /// \return  True if the deadline index is in use, false otherwise.
+    inline bool use_deadline_index() const
+    {
+      return use_deadline_index_;
+    }
+
+    /// \brief  Dequeue every packet from a latency-sensitive queue whose
+    ///         deadline precedes a threshold.
+    ///
+    /// The packets are found through the deadline index, so the cost is
+    /// proportional to the number of packets dequeued rather than to the
+    /// depth of the queue.  Memory ownership of the dequeued packets goes to
+    /// the caller.
+    ///
+    /// \param  lat        The latency class, LOW_LATENCY or CRITICAL_LATENCY.
+    /// \param  threshold  The deadline threshold. Packets whose receive time
+    ///                    plus time-to-go is before this time are dequeued.
+    ///                    May be infinite.
+    /// \param  pkts       The vector to which the dequeued packets are
+    ///                    appended.
+    ///
+    /// \return  The number of packets dequeued.
+    size_t DequeueExpired(LatencyClass lat, const Time& threshold,
+                          std::vector<Packet*>& pkts);
+
+    /// \brief  Find the packet with the earliest deadline in a
+    ///         latency-sensitive queue.
+    ///
+    /// Memory ownership of the packet stays with the queue.
+    ///
+    /// \param  lat       The latency class, LOW_LATENCY or CRITICAL_LATENCY.
+    /// \param  pkt       The packet with the earliest deadline.
+    /// \param  deadline  The packet's deadline.
+    /// \param  qws       The iterator pointing to the packet, for use with
+    ///                   DequeueAtIterator.
+    ///
+    /// \return  True if a packet was found, false otherwise.
+    bool PeekEarliestDeadline(LatencyClass lat, Packet*& pkt, Time& deadline,
+                              PacketQueue::QueueWalkState& qws);
+
     /// \brief  Dequeue the packet placed at the iterator.
     /// Memory ownership quits the queue to go with the caller.
     ///
@@ -817,6 +863,56 @@ namespace iron
     void AdjustQueueDepth(
       BinIndex bin_idx, LatencyClass lat, int64_t delta_bytes);
 
+    /// \brief  Get the deadline index for a latency class.
+    ///
+    /// \param  lat  The latency class.
+    ///
+    /// \return  A pointer to the deadline index, or NULL if the latency class
+    ///          is not indexed.
+    inline DeadlineIndex* GetDeadlineIndex(uint8_t lat)
+    {
+      if (!use_deadline_index_)
+      {
+        return NULL;
+      }
+
+      return ((lat == CRITICAL_LATENCY) ? &critical_deadlines_ :
+              ((lat == LOW_LATENCY) ? &low_lat_deadlines_ : NULL));
+    }
+
+    /// \brief  Remove a dequeued packet from the deadline index.
+    ///
+    /// \param  lat  The latency class of the queue the packet left.
+    /// \param  pkt  The dequeued packet.
+    inline void RemoveFromDeadlineIndex(uint8_t lat, Packet* pkt)
+    {
+      DeadlineIndex*  index = GetDeadlineIndex(lat);
+
+      if (index)
+      {
+        index->Remove(pkt);
+      }
+    }
+
+    /// \brief  Check that a packet popped from the deadline index is still
+    ///         in its queue.
+    ///
+    /// Entries may be stale if the packet left the queue without the
+    /// BinQueueMgr knowing (e.g., a drop performed by the PacketQueue when
+    /// full), in which case the packet pointer may even have been reused.
+    /// This takes constant time.
+    ///
+    /// \param  lat          The latency class of the queue.
+    /// \param  pkt          The packet.
+    /// \param  deadline_us  The deadline the packet was indexed with, in
+    ///                      microseconds.
+    /// \param  qws          The iterator the packet was indexed with.
+    ///
+    /// \return  True if the packet is in the queue at the iterator with the
+    ///          same deadline, false otherwise.
+    bool FindIndexedPkt(LatencyClass lat, Packet* pkt, int64_t deadline_us,
+                        const PacketQueue::QueueWalkState& qws);
+
     /// \brief Initialize and generate the key for a per-bin graph.
     ///
     /// \param The BinIndex for which we want to generate a plot.
@@ -891,6 +987,19 @@ namespace iron
     /// The total size of non-zombie packets in the queue.
     BinIndexableArray<uint32_t>       non_zombie_queue_depth_bytes_;
 
+    /// Indicates whether the latency-sensitive queues are indexed by packet
+    /// deadline.
+    bool                              use_deadline_index_;
+
+    /// The deadline index for the CRITICAL_LATENCY queue.
+    DeadlineIndex                     critical_deadlines_;
+
+    /// The deadline index for the LOW_LATENCY queue.
+    DeadlineIndex                     low_lat_deadlines_;
+
+    /// Scratch space for entries popped from a deadline index.
+    std::vector<DeadlineIndex::Entry> expired_entries_;
+
   }; // end class BinQueueMgr
 
 } // namespace iron
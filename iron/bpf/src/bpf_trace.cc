@@ -0,0 +1,335 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "bpf_trace.h"
+
+#include "iron_constants.h"
+#include "itime.h"
+#include "log.h"
+#include "packet.h"
+#include "unused.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <inttypes.h>
+
+
+using ::iron::BpfTraceReader;
+using ::iron::BpfTraceWriter;
+using ::iron::Packet;
+using ::iron::Time;
+using ::std::string;
+
+
+namespace
+{
+  /// Class name for logging.
+  const char*     UNUSED(kClassName) = "BpfTrace";
+
+  /// The trace file magic string.
+  const char      kTraceMagic[8]     = { 'I', 'R', 'O', 'N',
+                                         'B', 'P', 'F', 'T' };
+
+  /// The trace format version.
+  const uint32_t  kTraceVersion      = 1;
+
+  /// The size of the trace file stdio buffer, in bytes.
+  const size_t    kTraceFileBufSize  = (1 << 20);
+}
+
+
+//============================================================================
+BpfTraceWriter::BpfTraceWriter()
+    : file_(NULL),
+      file_buf_(NULL),
+      num_records_(0)
+{
+}
+
+//============================================================================
+BpfTraceWriter::~BpfTraceWriter()
+{
+  if (file_ != NULL)
+  {
+    fclose(file_);
+    file_ = NULL;
+  }
+
+  if (file_buf_ != NULL)
+  {
+    delete [] file_buf_;
+    file_buf_ = NULL;
+  }
+}
+
+//============================================================================
+bool BpfTraceWriter::Open(const string& file_name, BinId bin_id)
+{
+  if (file_ != NULL)
+  {
+    LogE(kClassName, __func__, "Trace file already open.\n");
+    return false;
+  }
+
+  file_ = fopen(file_name.c_str(), "wb");
+
+  if (file_ == NULL)
+  {
+    LogE(kClassName, __func__, "Unable to open trace file %s: %s\n",
+         file_name.c_str(), strerror(errno));
+    return false;
+  }
+
+  file_buf_ = new (std::nothrow) char[kTraceFileBufSize];
+
+  if (file_buf_ != NULL)
+  {
+    setvbuf(file_, file_buf_, _IOFBF, kTraceFileBufSize);
+  }
+
+  BpfTraceFileHeader  file_hdr;
+
+  memset(&file_hdr, 0, sizeof(file_hdr));
+  memcpy(file_hdr.magic, kTraceMagic, sizeof(file_hdr.magic));
+  file_hdr.version         = kTraceVersion;
+  file_hdr.bin_id          = bin_id;
+  file_hdr.start_time_usec = Time::Now().GetTimeInUsec();
+
+  if (fwrite(&file_hdr, sizeof(file_hdr), 1, file_) != 1)
+  {
+    LogE(kClassName, __func__, "Error writing trace file header.\n");
+    return false;
+  }
+
+  LogI(kClassName, __func__, "Recording BPF trace to %s.\n",
+       file_name.c_str());
+
+  return true;
+}
+
+//============================================================================
+void BpfTraceWriter::RecordPacket(uint8_t pc_num, Packet* pkt)
+{
+  BpfTracePktInfo  info;
+  size_t           pkt_len     = pkt->GetLengthInBytes();
+  size_t           capture_len = pkt_len;
+  int              pkt_type    = pkt->GetRawType();
+
+  if (((pkt_type == IPV4_PACKET) || (pkt_type == ZOMBIE_PACKET)) &&
+      (capture_len > kTraceIpv4CaptureBytes))
+  {
+    capture_len = kTraceIpv4CaptureBytes;
+  }
+
+  memset(&info, 0, sizeof(info));
+  info.pkt_len        = static_cast<uint32_t>(pkt_len);
+  info.packet_id      = pkt->packet_id();
+  info.dst_vec        = static_cast<uint32_t>(pkt->dst_vec());
+  info.ttg_usec       = pkt->time_to_go_usec();
+  info.recv_time_usec = pkt->recv_time().GetTimeInUsec();
+  info.origin_ts_ms   = pkt->origin_ts_ms();
+  info.bin_id         = static_cast<uint8_t>(pkt->bin_id());
+  info.flags          = ((pkt->time_to_go_valid() ? kTraceTtgValid : 0) |
+                         (pkt->track_ttg() ? kTraceTrackTtg : 0));
+
+  WriteRecord(TRACE_RCVD_PKT, pc_num, &info, sizeof(info), pkt->GetBuffer(),
+              capture_len);
+}
+
+//============================================================================
+void BpfTraceWriter::RecordCapacity(uint8_t pc_num, double chan_cap_est_bps,
+                                    double trans_cap_est_bps)
+{
+  BpfTraceCapacity  cap;
+
+  cap.chan_cap_est_bps  = chan_cap_est_bps;
+  cap.trans_cap_est_bps = trans_cap_est_bps;
+
+  WriteRecord(TRACE_CAPACITY, pc_num, &cap, sizeof(cap), NULL, 0);
+}
+
+//============================================================================
+void BpfTraceWriter::RecordPdd(uint8_t pc_num, double pdd_mean,
+                               double pdd_variance)
+{
+  BpfTracePdd  pdd;
+
+  pdd.pdd_mean     = pdd_mean;
+  pdd.pdd_variance = pdd_variance;
+
+  WriteRecord(TRACE_PDD, pc_num, &pdd, sizeof(pdd), NULL, 0);
+}
+
+//============================================================================
+void BpfTraceWriter::RecordXmitQueueSize(uint8_t pc_num, bool valid,
+                                         size_t size)
+{
+  BpfTraceXmitQueueSize  xqs;
+
+  memset(&xqs, 0, sizeof(xqs));
+  xqs.size  = size;
+  xqs.valid = (valid ? 1 : 0);
+
+  WriteRecord(TRACE_XMIT_QUEUE_SIZE, pc_num, &xqs, sizeof(xqs), NULL, 0);
+}
+
+//============================================================================
+void BpfTraceWriter::Flush()
+{
+  if (file_ != NULL)
+  {
+    fflush(file_);
+  }
+}
+
+//============================================================================
+void BpfTraceWriter::WriteRecord(uint8_t type, uint8_t pc_num,
+                                 const void* body1, size_t body1_len,
+                                 const void* body2, size_t body2_len)
+{
+  if (file_ == NULL)
+  {
+    return;
+  }
+
+  BpfTraceRecordHeader  hdr;
+
+  hdr.time_usec = Time::Now().GetTimeInUsec();
+  hdr.body_len  = static_cast<uint32_t>(body1_len + body2_len);
+  hdr.type      = type;
+  hdr.pc_num    = pc_num;
+  hdr.reserved  = 0;
+
+  // fwrite() only copies into the stdio buffer, except when it fills.
+  if ((fwrite(&hdr, sizeof(hdr), 1, file_) != 1) ||
+      (fwrite(body1, body1_len, 1, file_) != 1) ||
+      ((body2_len > 0) && (fwrite(body2, body2_len, 1, file_) != 1)))
+  {
+    LogE(kClassName, __func__, "Error writing trace record, tracing "
+         "stopped.\n");
+    fclose(file_);
+    file_ = NULL;
+    return;
+  }
+
+  ++num_records_;
+}
+
+//============================================================================
+BpfTraceReader::BpfTraceReader()
+    : file_(NULL),
+      file_hdr_()
+{
+  memset(&file_hdr_, 0, sizeof(file_hdr_));
+}
+
+//============================================================================
+BpfTraceReader::~BpfTraceReader()
+{
+  if (file_ != NULL)
+  {
+    fclose(file_);
+    file_ = NULL;
+  }
+}
+
+//============================================================================
+bool BpfTraceReader::Open(const string& file_name)
+{
+  if (file_ != NULL)
+  {
+    LogE(kClassName, __func__, "Trace file already open.\n");
+    return false;
+  }
+
+  file_ = fopen(file_name.c_str(), "rb");
+
+  if (file_ == NULL)
+  {
+    LogE(kClassName, __func__, "Unable to open trace file %s: %s\n",
+         file_name.c_str(), strerror(errno));
+    return false;
+  }
+
+  if ((fread(&file_hdr_, sizeof(file_hdr_), 1, file_) != 1) ||
+      (memcmp(file_hdr_.magic, kTraceMagic, sizeof(kTraceMagic)) != 0))
+  {
+    LogE(kClassName, __func__, "%s is not a BPF trace file.\n",
+         file_name.c_str());
+    return false;
+  }
+
+  if (file_hdr_.version != kTraceVersion)
+  {
+    LogE(kClassName, __func__, "Unsupported trace version %" PRIu32 ".\n",
+         file_hdr_.version);
+    return false;
+  }
+
+  return true;
+}
+
+//============================================================================
+bool BpfTraceReader::ReadRecord(BpfTraceRecordHeader& hdr, uint8_t* body,
+                                size_t body_max)
+{
+  if (file_ == NULL)
+  {
+    return false;
+  }
+
+  if (fread(&hdr, sizeof(hdr), 1, file_) != 1)
+  {
+    return false;
+  }
+
+  if (hdr.body_len > body_max)
+  {
+    LogE(kClassName, __func__, "Trace record of %" PRIu32 " bytes exceeds "
+         "buffer of %zu bytes.\n", hdr.body_len, body_max);
+    return false;
+  }
+
+  if ((hdr.body_len > 0) && (fread(body, hdr.body_len, 1, file_) != 1))
+  {
+    LogE(kClassName, __func__, "Truncated trace record.\n");
+    return false;
+  }
+
+  return true;
+}
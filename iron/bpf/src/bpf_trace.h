@@ -0,0 +1,339 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+///  \brief BpfTrace header file
+///
+/// A binary trace of every input consumed by the Backpressure Forwarder,
+/// for replaying a run offline with virtual time.
+
+#ifndef IRON_BPF_BPF_TRACE_H
+#define IRON_BPF_BPF_TRACE_H
+
+#include "iron_types.h"
+
+#include <cstdio>
+#include <string>
+
+#include <stdint.h>
+
+
+namespace iron
+{
+  class Packet;
+
+  /// The Path Controller number recorded for packets received from the
+  /// local proxies.
+  const uint8_t  kTraceProxyPathCtrlNum  = 0xFF;
+
+  /// The maximum number of bytes of an IPv4 or Zombie packet recorded in a
+  /// trace.  Only the headers are needed by the BPF, so the rest of the
+  /// packet is replaced by zeros on replay.  Control packets (QLAMs, LSAs)
+  /// are always recorded whole.
+  const size_t   kTraceIpv4CaptureBytes  = 128;
+
+  /// The types of trace records.
+  enum BpfTraceRecordType
+  {
+    /// A packet passed to BPFwder::ProcessRcvdPacket(), from a Path
+    /// Controller or a proxy.  The body is a BpfTracePktInfo followed by the
+    /// captured packet bytes.
+    TRACE_RCVD_PKT        = 1,
+
+    /// A BPFwder::ProcessCapacityUpdate() call.  The body is a
+    /// BpfTraceCapacity.
+    TRACE_CAPACITY        = 2,
+
+    /// A BPFwder::ProcessPktDelDelay() call.  The body is a BpfTracePdd.
+    TRACE_PDD             = 3,
+
+    /// The answer to a PathController::GetXmitQueueSize() call made by the
+    /// BPF.  The body is a BpfTraceXmitQueueSize.
+    TRACE_XMIT_QUEUE_SIZE = 4
+  };
+
+  /// The trace file header.  All values are in host byte order, as traces
+  /// are meant to be replayed on the same kind of machine.
+  struct BpfTraceFileHeader
+  {
+    /// "IRONBPFT".
+    char      magic[8];
+
+    /// The trace format version.
+    uint32_t  version;
+
+    /// The bin id of the node that recorded the trace.
+    uint32_t  bin_id;
+
+    /// The time at which recording started, in microseconds.
+    int64_t   start_time_usec;
+  };
+
+  /// The header of each trace record.
+  struct BpfTraceRecordHeader
+  {
+    /// The time at which the input was consumed, in microseconds.
+    int64_t   time_usec;
+
+    /// The length of the record body, in bytes.
+    uint32_t  body_len;
+
+    /// The record type, a BpfTraceRecordType.
+    uint8_t   type;
+
+    /// The Path Controller number, or kTraceProxyPathCtrlNum.
+    uint8_t   pc_num;
+
+    /// Unused, zero.
+    uint16_t  reserved;
+  };
+
+  /// The Packet object state recorded with each received packet.
+  struct BpfTracePktInfo
+  {
+    /// The full packet length, in bytes.
+    uint32_t  pkt_len;
+
+    /// The packet id.
+    uint32_t  packet_id;
+
+    /// The destination bit vector.
+    uint32_t  dst_vec;
+
+    /// The time-to-go, in microseconds.
+    int32_t   ttg_usec;
+
+    /// The packet receive time, in microseconds.
+    int64_t   recv_time_usec;
+
+    /// The origin timestamp, in milliseconds.
+    uint16_t  origin_ts_ms;
+
+    /// The bin id.
+    uint8_t   bin_id;
+
+    /// kTraceTtgValid and kTraceTrackTtg flags.
+    uint8_t   flags;
+  };
+
+  /// BpfTracePktInfo flag: the time-to-go is valid.
+  const uint8_t  kTraceTtgValid = 0x01;
+
+  /// BpfTracePktInfo flag: the time-to-go is tracked.
+  const uint8_t  kTraceTrackTtg = 0x02;
+
+  /// The body of a TRACE_CAPACITY record.
+  struct BpfTraceCapacity
+  {
+    /// The channel capacity estimate, in bits per second.
+    double  chan_cap_est_bps;
+
+    /// The transport capacity estimate, in bits per second.
+    double  trans_cap_est_bps;
+  };
+
+  /// The body of a TRACE_PDD record.
+  struct BpfTracePdd
+  {
+    /// The mean packet delivery delay, in seconds.
+    double  pdd_mean;
+
+    /// The packet delivery delay variance, in seconds squared.
+    double  pdd_variance;
+  };
+
+  /// The body of a TRACE_XMIT_QUEUE_SIZE record.
+  struct BpfTraceXmitQueueSize
+  {
+    /// The reported queue size, in bytes.
+    uint64_t  size;
+
+    /// The value returned by GetXmitQueueSize(), 1 or 0.
+    uint8_t   valid;
+
+    /// Unused, zero.
+    uint8_t   reserved[7];
+  };
+
+  /// \brief Records BPF inputs to a trace file.
+  ///
+  /// Records are written through a large stdio buffer, so that recording
+  /// costs a memcpy per input in the common case.
+  class BpfTraceWriter
+  {
+  public:
+
+    /// \brief Constructor.
+    BpfTraceWriter();
+
+    /// \brief Destructor.  Flushes and closes the file.
+    virtual ~BpfTraceWriter();
+
+    /// \brief Create the trace file and write its header.
+    ///
+    /// \param  file_name  The trace file name.
+    /// \param  bin_id     The bin id of the recording node.
+    ///
+    /// \return  True on success, false otherwise.
+    bool Open(const std::string& file_name, BinId bin_id);
+
+    /// \brief Record a packet passed to the BPF.
+    ///
+    /// \param  pc_num  The receiving Path Controller number, or
+    ///                 kTraceProxyPathCtrlNum.
+    /// \param  pkt     The packet.
+    void RecordPacket(uint8_t pc_num, Packet* pkt);
+
+    /// \brief Record a capacity update.
+    ///
+    /// \param  pc_num             The Path Controller number.
+    /// \param  chan_cap_est_bps   The channel capacity estimate.
+    /// \param  trans_cap_est_bps  The transport capacity estimate.
+    void RecordCapacity(uint8_t pc_num, double chan_cap_est_bps,
+                        double trans_cap_est_bps);
+
+    /// \brief Record a packet delivery delay update.
+    ///
+    /// \param  pc_num        The Path Controller number.
+    /// \param  pdd_mean      The mean delay, in seconds.
+    /// \param  pdd_variance  The delay variance, in seconds squared.
+    void RecordPdd(uint8_t pc_num, double pdd_mean, double pdd_variance);
+
+    /// \brief Record the answer to a transmit queue size query.
+    ///
+    /// \param  pc_num  The Path Controller number.
+    /// \param  valid   The value returned by GetXmitQueueSize().
+    /// \param  size    The reported size, in bytes.
+    void RecordXmitQueueSize(uint8_t pc_num, bool valid, size_t size);
+
+    /// \brief Write any buffered records to the file.
+    void Flush();
+
+    /// \brief Get the number of records written.
+    ///
+    /// \return  The number of records written.
+    inline uint64_t num_records() const
+    {
+      return num_records_;
+    }
+
+  private:
+
+    /// Copy constructor.
+    BpfTraceWriter(const BpfTraceWriter& other);
+
+    /// Copy operator.
+    BpfTraceWriter& operator=(const BpfTraceWriter& other);
+
+    /// \brief Write one record.
+    ///
+    /// \param  type      The record type.
+    /// \param  pc_num    The Path Controller number.
+    /// \param  body1     The first part of the body.
+    /// \param  body1_len The length of the first part, in bytes.
+    /// \param  body2     The second part of the body, or NULL.
+    /// \param  body2_len The length of the second part, in bytes.
+    void WriteRecord(uint8_t type, uint8_t pc_num, const void* body1,
+                     size_t body1_len, const void* body2, size_t body2_len);
+
+    /// The trace file.
+    FILE*     file_;
+
+    /// The stdio buffer for the trace file.
+    char*     file_buf_;
+
+    /// The number of records written.
+    uint64_t  num_records_;
+
+  }; // end class BpfTraceWriter
+
+  /// \brief Reads BPF inputs from a trace file.
+  class BpfTraceReader
+  {
+  public:
+
+    /// \brief Constructor.
+    BpfTraceReader();
+
+    /// \brief Destructor.  Closes the file.
+    virtual ~BpfTraceReader();
+
+    /// \brief Open a trace file and read its header.
+    ///
+    /// \param  file_name  The trace file name.
+    ///
+    /// \return  True on success, false if the file cannot be read or is not
+    ///          a trace.
+    bool Open(const std::string& file_name);
+
+    /// \brief Read the next record.
+    ///
+    /// \param  hdr       A reference where the record header is placed.
+    /// \param  body      The buffer where the body is placed.
+    /// \param  body_max  The size of the buffer, in bytes.
+    ///
+    /// \return  True if a record was read, false at the end of the trace or
+    ///          on error.
+    bool ReadRecord(BpfTraceRecordHeader& hdr, uint8_t* body,
+                    size_t body_max);
+
+    /// \brief Get the trace file header.
+    ///
+    /// \return  The trace file header.
+    inline const BpfTraceFileHeader& file_hdr() const
+    {
+      return file_hdr_;
+    }
+
+  private:
+
+    /// Copy constructor.
+    BpfTraceReader(const BpfTraceReader& other);
+
+    /// Copy operator.
+    BpfTraceReader& operator=(const BpfTraceReader& other);
+
+    /// The trace file.
+    FILE*               file_;
+
+    /// The trace file header.
+    BpfTraceFileHeader  file_hdr_;
+
+  }; // end class BpfTraceReader
+
+} // namespace iron
+
+#endif // IRON_BPF_BPF_TRACE_H
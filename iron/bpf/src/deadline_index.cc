@@ -0,0 +1,343 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+/// \file deadline_index.cc, provides an implementation of the hashed timing
+/// wheel used to index latency-sensitive packets by deadline.
+
+#include "deadline_index.h"
+
+#include "log.h"
+#include "packet.h"
+
+#include <limits>
+
+#include <inttypes.h>
+
+using ::iron::DeadlineIndex;
+using ::iron::Packet;
+using ::iron::PacketQueue;
+using ::iron::Time;
+using ::std::vector;
+
+namespace
+{
+  /// Class name for logging.
+  const char  kClassName[] = "DeadlineIndex";
+}
+
+//============================================================================
+DeadlineIndex::DeadlineIndex()
+    : slots_(),
+      slot_mask_(0),
+      slot_width_us_(DEFAULT_DEADLINE_INDEX_SLOT_WIDTH_US),
+      cursor_(0),
+      num_entries_(0)
+{
+  Initialize(DEFAULT_DEADLINE_INDEX_NUM_SLOTS,
+             DEFAULT_DEADLINE_INDEX_SLOT_WIDTH_US);
+}
+
+//============================================================================
+DeadlineIndex::~DeadlineIndex()
+{
+  Clear();
+}
+
+//============================================================================
+bool DeadlineIndex::Initialize(uint32_t num_slots, uint32_t slot_width_us)
+{
+  if ((num_slots == 0) || (slot_width_us == 0))
+  {
+    LogE(kClassName, __func__, "Invalid wheel size: %" PRIu32 " slots of %"
+         PRIu32 " us.\n", num_slots, slot_width_us);
+    return false;
+  }
+
+  // Round the number of slots up to a power of two so that the slot for an
+  // absolute slot number is found with a mask.
+  size_t  size = 1;
+  while (size < num_slots)
+  {
+    size <<= 1;
+  }
+
+  slots_.clear();
+  slots_.resize(size);
+  slot_mask_     = size - 1;
+  slot_width_us_ = slot_width_us;
+  cursor_        = 0;
+  num_entries_   = 0;
+
+  return true;
+}
+
+//============================================================================
+bool DeadlineIndex::GetDeadline(const Packet* pkt, Time& deadline)
+{
+  if (!pkt || !pkt->time_to_go_valid())
+  {
+    return false;
+  }
+
+  deadline = pkt->recv_time() + pkt->GetTimeToGo();
+  return true;
+}
+
+//============================================================================
+bool DeadlineIndex::Add(Packet* pkt, const PacketQueue::QueueWalkState& qws)
+{
+  Time  deadline;
+
+  if (!GetDeadline(pkt, deadline))
+  {
+    return false;
+  }
+
+  int64_t  deadline_us = deadline.GetTimeInUsec();
+  int64_t  slot_num    = SlotNum(deadline_us);
+
+  if (num_entries_ == 0)
+  {
+    cursor_ = slot_num;
+  }
+  else if (slot_num < cursor_)
+  {
+    // The deadline is behind the cursor (the packet is already late). Place
+    // it in the cursor slot, which is the next one to be examined.
+    slot_num = cursor_;
+  }
+
+  Slot(slot_num).push_back(Entry(pkt, deadline_us, slot_num, qws));
+  ++num_entries_;
+
+  return true;
+}
+
+//============================================================================
+bool DeadlineIndex::Remove(Packet* pkt)
+{
+  Time  deadline;
+
+  if ((num_entries_ == 0) || !GetDeadline(pkt, deadline))
+  {
+    return false;
+  }
+
+  return Remove(pkt, deadline);
+}
+
+//============================================================================
+bool DeadlineIndex::Remove(Packet* pkt, const Time& deadline)
+{
+  if (num_entries_ == 0)
+  {
+    return false;
+  }
+
+  // Entries never sit in a slot behind the cursor, and those that were late
+  // when added sit in the cursor slot.
+  int64_t         slot_num = SlotNum(deadline.GetTimeInUsec());
+  vector<Entry>&  slot     = Slot((slot_num < cursor_) ? cursor_ : slot_num);
+
+  for (size_t i = 0; i < slot.size(); ++i)
+  {
+    if (slot[i].pkt == pkt)
+    {
+      slot[i] = slot.back();
+      slot.pop_back();
+      --num_entries_;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//============================================================================
+size_t DeadlineIndex::PopExpired(const Time& threshold,
+                                 vector<Entry>& expired)
+{
+  if (num_entries_ == 0)
+  {
+    return 0;
+  }
+
+  size_t   num_popped    = 0;
+  int64_t  threshold_us  = (threshold.IsInfinite() ?
+                            std::numeric_limits<int64_t>::max() :
+                            threshold.GetTimeInUsec());
+  int64_t  threshold_num = SlotNum(threshold_us);
+
+  if ((threshold_num - cursor_) >= static_cast<int64_t>(slots_.size()))
+  {
+    // The threshold is more than one revolution away, so every slot must be
+    // examined.
+    for (size_t s = 0; s < slots_.size(); ++s)
+    {
+      vector<Entry>&  slot = slots_[s];
+
+      for (size_t i = 0; i < slot.size(); )
+      {
+        if (slot[i].deadline_us < threshold_us)
+        {
+          expired.push_back(slot[i]);
+          slot[i] = slot.back();
+          slot.pop_back();
+          ++num_popped;
+        }
+        else
+        {
+          ++i;
+        }
+      }
+    }
+
+    // Every remaining entry has a deadline at or after the threshold.
+    cursor_ = threshold_num;
+  }
+  else
+  {
+    int64_t  last_num = (threshold_num > cursor_ ? threshold_num : cursor_);
+
+    for (int64_t slot_num = cursor_; slot_num <= last_num; ++slot_num)
+    {
+      vector<Entry>&  slot = Slot(slot_num);
+
+      for (size_t i = 0; i < slot.size(); )
+      {
+        if ((slot[i].slot_num == slot_num) &&
+            (slot[i].deadline_us < threshold_us))
+        {
+          expired.push_back(slot[i]);
+          slot[i] = slot.back();
+          slot.pop_back();
+          ++num_popped;
+        }
+        else
+        {
+          ++i;
+        }
+      }
+    }
+
+    // All slots before the threshold slot have been emptied of their entries
+    // for this revolution.
+    cursor_ = last_num;
+  }
+
+  num_entries_ -= num_popped;
+
+  LogD(kClassName, __func__, "Popped %zu entries expiring before %" PRId64
+       " us, %zu remaining.\n", num_popped, threshold_us, num_entries_);
+
+  return num_popped;
+}
+
+//============================================================================
+bool DeadlineIndex::PeekEarliest(Packet*& pkt, Time& deadline,
+                                 PacketQueue::QueueWalkState& qws)
+{
+  if (num_entries_ == 0)
+  {
+    return false;
+  }
+
+  const Entry*  earliest = NULL;
+
+  // Find the first slot, starting at the cursor, holding an entry for the
+  // current revolution.
+  for (size_t i = 0; (i < slots_.size()) && !earliest; ++i)
+  {
+    int64_t         slot_num = cursor_ + static_cast<int64_t>(i);
+    vector<Entry>&  slot     = Slot(slot_num);
+
+    for (size_t j = 0; j < slot.size(); ++j)
+    {
+      if ((slot[j].slot_num == slot_num) &&
+          (!earliest || (slot[j].deadline_us < earliest->deadline_us)))
+      {
+        earliest = &slot[j];
+      }
+    }
+
+    if (earliest)
+    {
+      cursor_ = slot_num;
+    }
+  }
+
+  if (!earliest)
+  {
+    // All entries are beyond the wheel horizon. Fall back on a full search.
+    for (size_t s = 0; s < slots_.size(); ++s)
+    {
+      for (size_t j = 0; j < slots_[s].size(); ++j)
+      {
+        if (!earliest || (slots_[s][j].deadline_us < earliest->deadline_us))
+        {
+          earliest = &slots_[s][j];
+        }
+      }
+    }
+
+    if (!earliest)
+    {
+      LogF(kClassName, __func__, "Index holds %zu entries but none were "
+           "found.\n", num_entries_);
+      return false;
+    }
+
+    cursor_ = earliest->slot_num;
+  }
+
+  pkt      = earliest->pkt;
+  deadline = Time::FromUsec(earliest->deadline_us);
+  qws      = earliest->qws;
+
+  return true;
+}
+
+//============================================================================
+void DeadlineIndex::Clear()
+{
+  for (size_t s = 0; s < slots_.size(); ++s)
+  {
+    slots_[s].clear();
+  }
+
+  num_entries_ = 0;
+}
@@ -0,0 +1,247 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+///  \brief DeadlineIndex header file
+///
+/// A hashed timing wheel that indexes latency-sensitive packets by the
+/// absolute time at which their time-to-go expires.
+
+#ifndef IRON_BPF_DEADLINE_INDEX_H
+#define IRON_BPF_DEADLINE_INDEX_H
+
+#include "itime.h"
+#include "packet_queue.h"
+
+#include <vector>
+
+#include <stdint.h>
+
+
+namespace iron
+{
+  /// The default number of slots in a deadline index wheel. Must be a power
+  /// of two.
+#define DEFAULT_DEADLINE_INDEX_NUM_SLOTS      1024
+
+  /// The default width of a deadline index wheel slot, in microseconds.
+#define DEFAULT_DEADLINE_INDEX_SLOT_WIDTH_US  1000
+
+  /// \brief A hashed timing wheel of packets keyed on their TTG deadline.
+  ///
+  /// Each packet is placed in the slot covering its deadline, i.e., its
+  /// receive time plus its time-to-go. A cursor tracks the earliest slot that
+  /// may still hold entries, so that finding every packet whose deadline
+  /// precedes a threshold only visits the slots between the cursor and the
+  /// threshold, and finding the packet with the earliest deadline only
+  /// visits the (typically few) empty slots ahead of it. Deadlines farther
+  /// away than the wheel horizon share slots with nearer ones, and are told
+  /// apart by their absolute slot number.
+  ///
+  /// The index does not own the packets. It is the responsibility of the
+  /// owner (the BinQueueMgr) to add a packet when it is enqueued and remove
+  /// it when it is dequeued. Each entry keeps the queue iterator returned by
+  /// the enqueue, so that the owner can find the packet in its queue without
+  /// a search. Packets that leave the queue without the owner knowing (e.g.,
+  /// drops performed inside a PacketQueue) leave stale entries behind, which
+  /// the owner must detect when they are popped.
+  ///
+  /// A packet's deadline must not change while the packet is in the index.
+  class DeadlineIndex
+  {
+  public:
+
+    /// Information stored for each indexed packet.
+    struct Entry
+    {
+      Entry() : pkt(NULL), deadline_us(0), slot_num(0), qws() { }
+      Entry(Packet* p, int64_t d, int64_t s,
+            const PacketQueue::QueueWalkState& q)
+          : pkt(p), deadline_us(d), slot_num(s), qws(q) { }
+
+      /// The indexed packet.
+      Packet*                      pkt;
+
+      /// The packet's deadline, in microseconds.
+      int64_t                      deadline_us;
+
+      /// The absolute slot number in which the entry was placed.
+      int64_t                      slot_num;
+
+      /// The iterator pointing to the packet in its queue when added.
+      PacketQueue::QueueWalkState  qws;
+    };
+
+    /// \brief Constructor.
+    DeadlineIndex();
+
+    /// \brief Destructor.
+    virtual ~DeadlineIndex();
+
+    /// \brief Size the wheel.
+    ///
+    /// Any packets already in the index are forgotten.
+    ///
+    /// \param  num_slots      The number of slots in the wheel. Rounded up to
+    ///                        a power of two.
+    /// \param  slot_width_us  The amount of time covered by each slot, in
+    ///                        microseconds.
+    ///
+    /// \return  True on success, false otherwise.
+    bool Initialize(uint32_t num_slots, uint32_t slot_width_us);
+
+    /// \brief Compute the deadline of a packet.
+    ///
+    /// \param  pkt       The packet.
+    /// \param  deadline  The absolute time at which the packet's time-to-go
+    ///                   expires.
+    ///
+    /// \return  True if the packet has a valid time-to-go, false otherwise.
+    static bool GetDeadline(const Packet* pkt, Time& deadline);
+
+    /// \brief Add a packet to the index.
+    ///
+    /// Packets without a valid time-to-go are not added.
+    ///
+    /// \param  pkt  The packet to add.
+    /// \param  qws  The iterator pointing to the packet in its queue.
+    ///
+    /// \return  True if the packet was added, false otherwise.
+    bool Add(Packet* pkt, const PacketQueue::QueueWalkState& qws);
+
+    /// \brief Remove a packet from the index.
+    ///
+    /// \param  pkt  The packet to remove.
+    ///
+    /// \return  True if the packet was found and removed, false otherwise.
+    bool Remove(Packet* pkt);
+
+    /// \brief Remove a packet from the index given the deadline it was added
+    /// with.
+    ///
+    /// Used to remove stale entries, whose packet may since have been given
+    /// a different deadline.
+    ///
+    /// \param  pkt       The packet to remove.
+    /// \param  deadline  The deadline the packet was added with.
+    ///
+    /// \return  True if the packet was found and removed, false otherwise.
+    bool Remove(Packet* pkt, const Time& deadline);
+
+    /// \brief Remove every packet whose deadline precedes a threshold.
+    ///
+    /// The packets are appended to the provided vector, in no particular
+    /// order.
+    ///
+    /// \param  threshold  The threshold. May be infinite, in which case every
+    ///                    packet in the index qualifies.
+    /// \param  expired    The vector to which the removed entries are
+    ///                    appended.
+    ///
+    /// \return  The number of packets removed.
+    size_t PopExpired(const Time& threshold, std::vector<Entry>& expired);
+
+    /// \brief Get the packet with the earliest deadline.
+    ///
+    /// The packet remains in the index.
+    ///
+    /// \param  pkt       The packet with the earliest deadline.
+    /// \param  deadline  Its deadline.
+    /// \param  qws       The iterator the packet was added with.
+    ///
+    /// \return  True if the index is not empty, false otherwise.
+    bool PeekEarliest(Packet*& pkt, Time& deadline,
+                      PacketQueue::QueueWalkState& qws);
+
+    /// \brief Forget all packets in the index.
+    void Clear();
+
+    /// \brief Get the number of packets in the index.
+    ///
+    /// \return  The number of packets in the index.
+    inline size_t size() const
+    {
+      return num_entries_;
+    }
+
+  private:
+
+    /// Copy constructor.
+    DeadlineIndex(const DeadlineIndex& other);
+
+    /// Copy operator.
+    DeadlineIndex& operator=(const DeadlineIndex& other);
+
+    /// \brief Map a deadline to an absolute slot number.
+    ///
+    /// \param  deadline_us  The deadline, in microseconds.
+    ///
+    /// \return  The absolute slot number.
+    inline int64_t SlotNum(int64_t deadline_us) const
+    {
+      return (deadline_us / slot_width_us_);
+    }
+
+    /// \brief Get the wheel slot holding an absolute slot number.
+    ///
+    /// \param  slot_num  The absolute slot number.
+    ///
+    /// \return  A reference to the slot.
+    inline std::vector<Entry>& Slot(int64_t slot_num)
+    {
+      return slots_[static_cast<size_t>(slot_num) & slot_mask_];
+    }
+
+    /// The wheel slots.
+    std::vector< std::vector<Entry> >  slots_;
+
+    /// The mask used to map an absolute slot number to a wheel slot.
+    size_t                             slot_mask_;
+
+    /// The amount of time covered by each slot, in microseconds.
+    int64_t                            slot_width_us_;
+
+    /// The absolute number of the earliest slot that may hold entries.
+    int64_t                            cursor_;
+
+    /// The number of packets in the index.
+    size_t                             num_entries_;
+
+  }; // end class DeadlineIndex
+
+} // namespace iron
+
+#endif  // IRON_BPF_DEADLINE_INDEX_H
@@ -54,7 +54,8 @@ namespace iron
         : path_ctrl(NULL), in_timer_callback(false), timer_handle(),
           bucket_depth_bits(0.0), link_capacity_bps(0.0),
           last_qlam_tx_time(), last_capacity_update_time(), pdd_mean_sec(0.0),
-          pdd_variance_secsq(0.0), pdd_std_dev_sec(0.0), flow_stats()
+          pdd_variance_secsq(0.0), pdd_std_dev_sec(0.0), lsa_pdd_mean_us(0),
+          lsa_pdd_var_us2(0), flow_stats()
     {}
 
     virtual ~PathCtrlInfo()
@@ -92,6 +93,13 @@ namespace iron
     /// seconds.
     double               pdd_std_dev_sec;
 
+    /// The rounded PDD mean, in microseconds, as of the last LSA interval.
+    uint32_t             lsa_pdd_mean_us;
+
+    /// The rounded PDD variance, in microseconds squared, as of the last LSA
+    /// interval.
+    uint64_t             lsa_pdd_var_us2;
+
     /// Accumulates flow statistics.
     FlowStats            flow_stats;
 
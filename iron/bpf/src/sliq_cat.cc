@@ -258,6 +258,14 @@ SliqCat::SliqCat(BPFwder* bpf, PacketPool& packet_pool, Timer& timer)
       cc_alg_(),
       cc_aggr_(0),
       rtt_outlier_rejection_(false),
+      edt_horizon_sec_(0.0),
+      ack_decimation_(false),
+      ack_coalescing_(false),
+      compact_hdrs_(false),
+      fast_reconnect_(false),
+      has_path_(false),
+      path_local_endpt_(),
+      path_remote_endpt_(),
       data_xmit_queue_size_(kDefaultDataXmitQueuePkts),
       endpt_id_(-1),
       qlam_stream_id_(0),
@@ -349,13 +357,32 @@ bool SliqCat::Initialize(const ConfigInfo& config_info, uint32_t config_id)
   config_name.append(".Endpoints");
   endpoints_str_ = config_info.Get(config_name);
 
-  if (!ParseEndpointsString(endpoints_str_))
+  if (!ParseEndpointsString(endpoints_str_, local_endpt_, remote_endpt_))
   {
     LogE(kClassName, __func__, "SliqCat %" PRIu32 ": Error, invalid "
          "endpoints: %s\n", path_controller_number_, endpoints_str_.c_str());
     return false;
   }
 
+  // Extract the optional second network path endpoints.
+  config_name = config_prefix;
+  config_name.append(".PathEndpoints");
+  string  path_endpts_str = config_info.Get(config_name, "");
+
+  if (!path_endpts_str.empty())
+  {
+    if (!ParseEndpointsString(path_endpts_str, path_local_endpt_,
+                              path_remote_endpt_))
+    {
+      LogE(kClassName, __func__, "SliqCat %" PRIu32 ": Error, invalid path "
+           "endpoints: %s\n", path_controller_number_,
+           path_endpts_str.c_str());
+      return false;
+    }
+
+    has_path_ = true;
+  }
+
   // Determine if this is the server or the client.  The higher IPv4 address
   // will be the server.  If the IPv4 addresses are the same, then compare the
   // UDP port numbers, with the higher port number becoming the server.
@@ -418,6 +445,31 @@ bool SliqCat::Initialize(const ConfigInfo& config_info, uint32_t config_id)
   config_name.append(".RttOutRej");
   rtt_outlier_rejection_ = config_info.GetBool(config_name, false);
 
+  // Extract the earliest departure time send pacing horizon setting.
+  config_name = config_prefix;
+  config_name.append(".EdtHorizon");
+  edt_horizon_sec_ = config_info.GetDouble(config_name, 0.0);
+
+  // Extract the adaptive ACK frequency setting.
+  config_name = config_prefix;
+  config_name.append(".AckDecimation");
+  ack_decimation_ = config_info.GetBool(config_name, false);
+
+  // Extract the coalesced ACK processing setting.
+  config_name = config_prefix;
+  config_name.append(".AckCoalescing");
+  ack_coalescing_ = config_info.GetBool(config_name, false);
+
+  // Extract the compact headers setting.
+  config_name = config_prefix;
+  config_name.append(".CompactHeaders");
+  compact_hdrs_ = config_info.GetBool(config_name, false);
+
+  // Extract the fast reconnection setting.
+  config_name = config_prefix;
+  config_name.append(".FastReconnect");
+  fast_reconnect_ = config_info.GetBool(config_name, false);
+
   // Extract the active capacity estimation setting.
   config_name = config_prefix;
   config_name.append(".ActiveCapEst");
@@ -436,6 +488,20 @@ bool SliqCat::Initialize(const ConfigInfo& config_info, uint32_t config_id)
     return false;
   }
 
+  // Offer compact headers before the SLIQ endpoint is set up.
+  if (compact_hdrs_ && (!ConfigureCompactHeaders(true)))
+  {
+    LogW(kClassName, __func__, "SliqCat %" PRIu32 ": Unable to configure "
+         "compact headers.\n", path_controller_number_);
+  }
+
+  // Enable fast reconnection before the SLIQ endpoint is set up.
+  if (fast_reconnect_ && (!ConfigureFastReconnect(true)))
+  {
+    LogW(kClassName, __func__, "SliqCat %" PRIu32 ": Unable to configure "
+         "fast reconnection.\n", path_controller_number_);
+  }
+
   // Set up the SLIQ endpoint.
   if (is_server_)
   {
@@ -469,6 +535,9 @@ bool SliqCat::Initialize(const ConfigInfo& config_info, uint32_t config_id)
          remote_endpt_.ToString().c_str(), endpt_id_);
   }
 
+  // Add the second network path, if configured.
+  AddConfiguredPath();
+
   // Log the configuration information.
   LogC(kClassName, __func__, "SliqCat %" PRIu32 " configuration:\n",
        path_controller_number_);
@@ -478,6 +547,12 @@ bool SliqCat::Initialize(const ConfigInfo& config_info, uint32_t config_id)
        label_.c_str());
   LogC(kClassName, __func__, "Endpoints                    : %s->%s\n",
        local_endpt_.ToString().c_str(), remote_endpt_.ToString().c_str());
+  if (has_path_)
+  {
+    LogC(kClassName, __func__, "Path Endpoints               : %s->%s\n",
+         path_local_endpt_.ToString().c_str(),
+         path_remote_endpt_.ToString().c_str());
+  }
   LogC(kClassName, __func__, "Connection Endpoint ID       : %d\n",
        endpt_id_);
   LogC(kClassName, __func__, "EF Data Reliability Mode     : %s\n",
@@ -488,6 +563,16 @@ bool SliqCat::Initialize(const ConfigInfo& config_info, uint32_t config_id)
        cc_aggr_);
   LogC(kClassName, __func__, "RTT Outlier Rejection        : %d\n",
        static_cast<int>(rtt_outlier_rejection_));
+  LogC(kClassName, __func__, "EDT Pacing Horizon           : %0.6f\n",
+       edt_horizon_sec_);
+  LogC(kClassName, __func__, "ACK Decimation               : %d\n",
+       static_cast<int>(ack_decimation_));
+  LogC(kClassName, __func__, "ACK Coalescing               : %d\n",
+       static_cast<int>(ack_coalescing_));
+  LogC(kClassName, __func__, "Compact Headers              : %d\n",
+       static_cast<int>(compact_hdrs_));
+  LogC(kClassName, __func__, "Fast Reconnect               : %d\n",
+       static_cast<int>(fast_reconnect_));
   LogC(kClassName, __func__, "Copa Anti-Jitter             : %0.6f\n",
        anti_jitter);
   LogC(kClassName, __func__, "Active Capacity Estimation   : %d\n",
@@ -835,6 +920,37 @@ void SliqCat::ProcessConnectionResult(EndptId endpt_id, bool success)
     }
   }
 
+  // Set the earliest departure time send pacing option.  On failure, SLIQ
+  // continues to use its send pacing timers.
+  if (edt_horizon_sec_ > 0.0)
+  {
+    if (!ConfigureEdtPacing(endpt_id_, edt_horizon_sec_))
+    {
+      LogW(kClassName, __func__, "SliqCat %" PRIu32 ": Unable to configure "
+           "EDT send pacing.\n", path_controller_number_);
+    }
+  }
+
+  // Set the adaptive ACK frequency option.
+  if (ack_decimation_)
+  {
+    if (!ConfigureAckFrequency(endpt_id_, true))
+    {
+      LogW(kClassName, __func__, "SliqCat %" PRIu32 ": Unable to configure "
+           "adaptive ACK frequency.\n", path_controller_number_);
+    }
+  }
+
+  // Set the coalesced ACK processing option.
+  if (ack_coalescing_)
+  {
+    if (!ConfigureAckCoalescing(endpt_id_, true))
+    {
+      LogW(kClassName, __func__, "SliqCat %" PRIu32 ": Unable to configure "
+           "coalesced ACK processing.\n", path_controller_number_);
+    }
+  }
+
   // Cancel any connection retry timer.
   timer_.CancelTimer(conn_retry_handle_);
 }
@@ -1404,7 +1520,8 @@ void SliqCat::ProcessFileDescriptorChange()
 }
 
 //============================================================================
-bool SliqCat::ParseEndpointsString(const string& ep_str)
+bool SliqCat::ParseEndpointsString(const string& ep_str, Ipv4Endpoint& lep,
+                                   Ipv4Endpoint& rep)
 {
   // The format to parse is:
   //   LOCAL_IP[:LOCAL_PORT]->REMOTE_IP[:REMOTE_PORT]
@@ -1443,15 +1560,14 @@ bool SliqCat::ParseEndpointsString(const string& ep_str)
   }
 
   // Convert the strings to endpoints.
-  if ((!local_endpt_.SetEndpoint(lep_str)) ||
-      (!remote_endpt_.SetEndpoint(rep_str)))
+  if ((!lep.SetEndpoint(lep_str)) || (!rep.SetEndpoint(rep_str)))
   {
     return false;
   }
 
   // The addresses and port numbers must not be zero.
-  if ((local_endpt_.address() == 0) || (local_endpt_.port() == 0) ||
-      (remote_endpt_.address() == 0) || (remote_endpt_.port() == 0))
+  if ((lep.address() == 0) || (lep.port() == 0) ||
+      (rep.address() == 0) || (rep.port() == 0))
   {
     return false;
   }
@@ -1466,6 +1582,7 @@ bool SliqCat::ParseEfDataRelString(const string& ef_rel_str)
   RexmitRounds  rounds_limit  = 0;
   double        time_limit    = 0.0;
   double        recv_prob     = 0.0;
+  bool          sliding_win   = false;
 
   LogD(kClassName, __func__, "SliqCat %" PRIu32 ": parsing %s\n",
        path_controller_number_, ef_rel_str.c_str());
@@ -1478,7 +1595,7 @@ bool SliqCat::ParseEfDataRelString(const string& ef_rel_str)
     List<string>  fec_val;
     StringUtils::Tokenize(fec_str, ",", fec_val);
 
-    if (fec_val.size() != 2)
+    if ((fec_val.size() != 2) && (fec_val.size() != 3))
     {
       return false;
     }
@@ -1541,26 +1658,41 @@ bool SliqCat::ParseEfDataRelString(const string& ef_rel_str)
       return false;
     }
 
+    // Parse the optional FEC mode.
+    if (fec_val.Pop(tok))
+    {
+      if (tok != "SW")
+      {
+        LogE(kClassName, __func__, "SliqCat %" PRIu32 ": Invalid FEC mode: "
+             "%s\n", path_controller_number_, tok.c_str());
+        return false;
+      }
+
+      sliding_win = true;
+    }
+
     // Store the reliability settings.
     if (limit_is_time)
     {
       LogD(kClassName, __func__, "SliqCat %" PRIu32 ": Configuring ARQFEC "
            "with: rexmit_limit %" PRIRexmitLimit ", recv_prob %f, time_limit "
-           "%f s.\n", path_controller_number_, kEfDataArqFecRexmitLimit,
-           recv_prob, time_limit);
+           "%f s, sliding_win %d.\n", path_controller_number_,
+           kEfDataArqFecRexmitLimit, recv_prob, time_limit,
+           static_cast<int>(sliding_win));
 
       ef_rel_.SetSemiRelArqFecUsingTime(kEfDataArqFecRexmitLimit, recv_prob,
-                                        time_limit);
+                                        time_limit, sliding_win);
     }
     else
     {
       LogD(kClassName, __func__, "SliqCat %" PRIu32 ": Configuring ARQFEC "
            "with: rexmit_limit %" PRIRexmitLimit ", recv_prob %f, "
-           "rounds_limit %" PRIRexmitRounds ".\n", path_controller_number_,
-           kEfDataArqFecRexmitLimit, recv_prob, rounds_limit);
+           "rounds_limit %" PRIRexmitRounds ", sliding_win %d.\n",
+           path_controller_number_, kEfDataArqFecRexmitLimit, recv_prob,
+           rounds_limit, static_cast<int>(sliding_win));
 
       ef_rel_.SetSemiRelArqFecUsingRounds(kEfDataArqFecRexmitLimit, recv_prob,
-                                          rounds_limit);
+                                          rounds_limit, sliding_win);
     }
   }
   else if (ef_rel_str == "ARQ")
@@ -1644,6 +1776,10 @@ bool SliqCat::ParseCongCtrlString(const string& cc_alg_str,
     {
       cc_alg_[i].SetCopa(anti_jitter);
     }
+    else if (cc_tok == "Bbr")
+    {
+      cc_alg_[i].SetBbr();
+    }
     else if (cc_tok.substr(0, 10) == "FixedRate_")
     {
       uint64_t  rate = StringUtils::GetUint64(cc_tok.substr(10),
@@ -1896,6 +2032,34 @@ void SliqCat::ConnectionRetryTimeout()
          path_controller_number_, local_endpt_.ToString().c_str(),
          remote_endpt_.ToString().c_str(), endpt_id_);
   }
+
+  // Add the second network path, if configured.
+  AddConfiguredPath();
+}
+
+//============================================================================
+void SliqCat::AddConfiguredPath()
+{
+  if ((!has_path_) || (endpt_id_ < 0))
+  {
+    return;
+  }
+
+  // A failure here is not fatal, as the tunnel still works over the
+  // primary path.
+  if (!AddPath(endpt_id_, path_local_endpt_, path_remote_endpt_))
+  {
+    LogW(kClassName, __func__, "SliqCat %" PRIu32 ": Unable to add path "
+         "from %s to %s.\n", path_controller_number_,
+         path_local_endpt_.ToString().c_str(),
+         path_remote_endpt_.ToString().c_str());
+    return;
+  }
+
+  LogD(kClassName, __func__, "SliqCat %" PRIu32 ": Added path from %s to "
+       "%s on endpoint %d.\n", path_controller_number_,
+       path_local_endpt_.ToString().c_str(),
+       path_remote_endpt_.ToString().c_str(), endpt_id_);
 }
 
 //============================================================================
@@ -116,10 +116,16 @@ namespace iron
   /// - PathController.x.Type
   /// - PathController.x.Label
   /// - PathController.x.Endpoints
+  /// - PathController.x.PathEndpoints
   /// - PathController.x.EfDataRel
   /// - PathController.x.CongCtrl
   /// - PathController.x.Aggr
   /// - PathController.x.RttOutRej
+  /// - PathController.x.EdtHorizon
+  /// - PathController.x.AckDecimation
+  /// - PathController.x.AckCoalescing
+  /// - PathController.x.CompactHeaders
+  /// - PathController.x.FastReconnect
   /// - PathController.x.AntiJitter
   /// - PathController.x.ActiveCapEst
   ///
@@ -130,6 +136,13 @@ namespace iron
   /// - Label     : The optional SLIQ CAT label string.
   /// - Endpoints : The IPv4 addresses and optional port numbers for the\n
   ///               local and remote endpoints of the tunnel.\n
+  /// - PathEndpoints : The optional IPv4 addresses and port numbers for\n
+  ///               the local and remote endpoints of a second network\n
+  ///               path for the tunnel, in the same format as Endpoints.\n
+  ///               When set, SLIQ stripes data over both paths, using the\n
+  ///               second congestion control algorithm in CongCtrl for\n
+  ///               the second path, and fails over to the remaining path\n
+  ///               if one stops responding.  Defaults to not set.\n
   ///               Must use the format\n
   ///               "LOCAL_IP[:LOCAL_PORT]->REMOTE_IP[:REMOTE_PORT]"\n
   ///               (for example "192.168.3.4->192.168.3.5" or\n
@@ -149,8 +162,11 @@ namespace iron
   ///               specified as a floating point number between 0.95 and\n
   ///               0.999 (inclusive), while "<l>" must be either a time in\n
   ///               seconds between "0.001s" and "64.0s" (inclusive) or a\n
-  ///               number of rounds between "1" and "7" (inclusive).\n
-  ///               Defaults to "ARQ".
+  ///               number of rounds between "1" and "7" (inclusive).  An\n
+  ///               optional third value of "SW" (for example\n
+  ///               "ARQFEC(1,0.99,SW)") selects sliding window FEC, which\n
+  ///               lowers the recovery latency of lost packets at the same\n
+  ///               FEC overhead.  Defaults to "ARQ".
   /// - CongCtrl  : The optional congestion control algorithms to use,\n
   ///               separated by commas.  Only the client side sets the
   ///               congestion control algorithms for both ends of the
@@ -163,7 +179,8 @@ namespace iron
   ///                 Throughput),\n
   ///               "CopaBeta1_<delta>" (Copa Beta 1, Constant Delta),\n
   ///               "DetCopaBeta1_<delta>" (Deterministic Copa Beta 1,\n
-  ///                 Constant Delta), or\n
+  ///                 Constant Delta),\n
+  ///               "Bbr" (BBR Model-Based Congestion Control), or\n
   ///               "FixedRate_<bps>" (Fixed Send Rate, For Testing Only).\n
   ///               Note that "<delta>" must be a floating-point number in\n
   ///               the range 0.004 to 1.0 inclusive.  Defaults to\n
@@ -175,6 +192,31 @@ namespace iron
   ///               enabled, all RTT samples are passed through a median\n
   ///               filter to eliminate those from the maximum RTT estimate.\n
   ///               Defaults to false (disabled).
+  /// - EdtHorizon : The optional earliest departure time send pacing\n
+  ///               horizon in seconds.  When greater than zero, data\n
+  ///               packets due within the horizon are handed to the kernel\n
+  ///               early with SO_TXTIME departure times, which requires the\n
+  ///               fq queueing discipline on the interface.  Must be at\n
+  ///               most 0.1.  Defaults to 0.0 (disabled).
+  /// - AckDecimation : The optional adaptive ACK frequency setting.  When\n
+  ///               enabled, the peer is asked to send fewer ACK packets as\n
+  ///               the send rate increases, while still sending them\n
+  ///               immediately on packet loss or reordering.  Defaults to\n
+  ///               false (disabled).
+  /// - AckCoalescing : The optional coalesced ACK processing setting.\n
+  ///               When enabled, the ACK packets read from the socket in\n
+  ///               one batch are merged before loss detection, congestion\n
+  ///               control updates, and sending happen once for the\n
+  ///               batch.  Defaults to false (disabled).
+  /// - CompactHeaders : The optional compact headers setting.  When\n
+  ///               enabled on both ends of the path, SLIQ data and ACK\n
+  ///               headers use truncated sequence numbers and variable\n
+  ///               length fields.  Defaults to false (disabled).
+  /// - FastReconnect : The optional fast reconnection setting.  When\n
+  ///               enabled on both ends of the path, a connection that is\n
+  ///               re-established after an outage starts from the cached\n
+  ///               congestion control, loss rate, and capacity state of\n
+  ///               the previous connection.  Defaults to false (disabled).
   /// - AntiJitter : The optional Copa congestion control algorithm\n
   ///               anti-jitter value in seconds.  Must be between 0.0 and\n
   ///               1.0.  Defaults to 0.0 (disabled).
@@ -490,10 +532,20 @@ namespace iron
     /// \brief Parse the endpoints string.
     ///
     /// \param  ep_str  A reference to the string to be parsed.
+    /// \param  lep     A reference to where the local endpoint is placed.
+    /// \param  rep     A reference to where the remote endpoint is placed.
     ///
     /// \return  True if the string is parsed successfully, or false
     ///          otherwise.
-    bool ParseEndpointsString(const std::string& ep_str);
+    bool ParseEndpointsString(const std::string& ep_str,
+                              iron::Ipv4Endpoint& lep,
+                              iron::Ipv4Endpoint& rep);
+
+    /// \brief Add the configured second network path, if any, to the SLIQ
+    /// endpoint.
+    ///
+    /// Must be called after the SLIQ endpoint is set up.
+    void AddConfiguredPath();
 
     /// \brief Parse the EF data reliability mode string.
     ///
@@ -650,6 +702,30 @@ namespace iron
     /// The SLIQ RTT outlier rejection setting.
     bool                 rtt_outlier_rejection_;
 
+    /// The SLIQ earliest departure time send pacing horizon, in seconds.
+    double               edt_horizon_sec_;
+
+    /// The SLIQ adaptive ACK frequency setting.
+    bool                 ack_decimation_;
+
+    /// The SLIQ coalesced ACK processing setting.
+    bool                 ack_coalescing_;
+
+    /// The SLIQ compact headers setting.
+    bool                 compact_hdrs_;
+
+    /// The SLIQ fast reconnection setting.
+    bool                 fast_reconnect_;
+
+    /// A flag recording if a second network path is configured.
+    bool                 has_path_;
+
+    /// The local endpoint of the second network path.
+    iron::Ipv4Endpoint   path_local_endpt_;
+
+    /// The remote endpoint of the second network path.
+    iron::Ipv4Endpoint   path_remote_endpt_;
+
     /// The data packet transmit queue size in packets.  Used for both the EF
     /// data and non-EF data streams.
     size_t               data_xmit_queue_size_;
@@ -134,6 +134,26 @@ public:
     PrintNodeRecords();
   }
 
+  /// Invoke the method to clear the latency cache.
+  void ResetLatencyCache()
+  {
+    ClearLatencyCache();
+  }
+
+  /// Invoke the method to generate an LSA at the end of an LSA interval.
+  ///
+  /// \return  The LSA packet, or NULL if no LSA is sent.
+  Packet* GenerateLsaTest()
+  {
+    return GenerateLsa();
+  }
+
+  /// Set the PDD mean on a path controller.
+  inline void SetPddMean(uint8_t path_ctrl_num, double pdd_mean_sec)
+  {
+    path_ctrls_[path_ctrl_num].pdd_mean_sec = pdd_mean_sec;
+  }
+
   /// Send a dummy LSA as if from node 0.
   void SendDummyLsa(Packet* lsa, PacketPool& pkt_pool, bool include_var = false);
 
@@ -575,6 +595,8 @@ class LinkStateTest : public CppUnit::TestFixture
   CPPUNIT_TEST(TestGetPerPcLatencyToDst);
   CPPUNIT_TEST(TestGetPerPcLatencyToDstWQueueDelay);
   CPPUNIT_TEST(TestGetPerPcLatencyToDstWVar);
+  CPPUNIT_TEST(TestIncrementalLatencyUpdate);
+  CPPUNIT_TEST(TestLsaIntervalLatencyCache);
   CPPUNIT_TEST(TestBPFAlg);
 
   CPPUNIT_TEST_SUITE_END();
@@ -1611,6 +1633,223 @@ public:
     pkt_pool_->Recycle(lsa);
   }
 
+  //==========================================================================
+  void TestIncrementalLatencyUpdate()
+  {
+    bpfwder_->ClearVariance();
+
+    std::vector<std::pair<BinId, uint32_t> > nbr_list;
+    std::vector<std::pair<BinId, uint64_t> > var_list;
+
+    // Same topology as TestGetPerPcLatencyToDst.
+    // Neighbor list data is:  (src_bin_id, cost)
+    // Variance list data is:  (src_bin_id, variance)
+    nbr_list.push_back(std::pair<BinId, uint32_t> (2, 2000));
+    nbr_list.push_back(std::pair<BinId, uint32_t> (3, 1000));
+    nbr_list.push_back(std::pair<BinId, uint32_t> (4, 1000));
+    var_list.push_back(std::pair<BinId, uint64_t> (2, 0));
+    var_list.push_back(std::pair<BinId, uint64_t> (3, 0));
+    var_list.push_back(std::pair<BinId, uint64_t> (4, 0));
+    bpfwder_->AddRecord(1, nbr_list, var_list);
+
+    nbr_list.clear();
+    nbr_list.push_back(std::pair<BinId, uint32_t> (1, 2000));
+    var_list.push_back(std::pair<BinId, uint64_t> (1, 0));
+    bpfwder_->AddRecord(2, nbr_list, var_list);
+
+    nbr_list.clear();
+    nbr_list.push_back(std::pair<BinId, uint32_t> (1, 1000));
+    nbr_list.push_back(std::pair<BinId, uint32_t> (5, 3000));
+    nbr_list.push_back(std::pair<BinId, uint32_t> (6, 5000));
+    var_list.push_back(std::pair<BinId, uint64_t> (1, 0));
+    var_list.push_back(std::pair<BinId, uint64_t> (5, 0));
+    var_list.push_back(std::pair<BinId, uint64_t> (6, 0));
+    bpfwder_->AddRecord(3, nbr_list, var_list);
+
+    nbr_list.clear();
+    nbr_list.push_back(std::pair<BinId, uint32_t> (1, 1000));
+    nbr_list.push_back(std::pair<BinId, uint32_t> (6, 7000));
+    nbr_list.push_back(std::pair<BinId, uint32_t> (7, 1000));
+    var_list.push_back(std::pair<BinId, uint64_t> (1, 0));
+    var_list.push_back(std::pair<BinId, uint64_t> (6, 0));
+    var_list.push_back(std::pair<BinId, uint64_t> (7, 0));
+    bpfwder_->AddRecord(4, nbr_list, var_list);
+
+    nbr_list.clear();
+    nbr_list.push_back(std::pair<BinId, uint32_t> (3, 3000));
+    var_list.push_back(std::pair<BinId, uint64_t> (3, 0));
+    bpfwder_->AddRecord(5, nbr_list, var_list);
+
+    nbr_list.clear();
+    nbr_list.push_back(std::pair<BinId, uint32_t> (3, 5000));
+    nbr_list.push_back(std::pair<BinId, uint32_t> (4, 7000));
+    nbr_list.push_back(std::pair<BinId, uint32_t> (7, 3000));
+    var_list.push_back(std::pair<BinId, uint64_t> (3, 0));
+    var_list.push_back(std::pair<BinId, uint64_t> (4, 0));
+    var_list.push_back(std::pair<BinId, uint64_t> (7, 0));
+    bpfwder_->AddRecord(6, nbr_list, var_list);
+
+    nbr_list.clear();
+    nbr_list.push_back(std::pair<BinId, uint32_t> (4, 1000));
+    nbr_list.push_back(std::pair<BinId, uint32_t> (6, 3000));
+    var_list.push_back(std::pair<BinId, uint64_t> (4, 0));
+    var_list.push_back(std::pair<BinId, uint64_t> (6, 0));
+    bpfwder_->AddRecord(7, nbr_list, var_list);
+
+    // Compute and save the paths to every destination.
+    uint32_t  latency_us[4];
+
+    for (BinId dst_id = 2; dst_id <= 7; ++dst_id)
+    {
+      CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(
+                       bin_map_->GetPhyBinIndex(dst_id), latency_us, false));
+    }
+
+    // Process an LSA from node 4 that changes some of its links.
+    Packet* lsa = pkt_pool_->Get(iron::PACKET_NOW_TIMESTAMP);
+
+    bpfwder_->SendDummyLsa(lsa, *pkt_pool_);
+
+    iron::PathController* pc  = new (std::nothrow) iron::Sond(
+      bpfwder_, *pkt_pool_, *timer_);
+    CPPUNIT_ASSERT(pc);
+
+    bpfwder_->ProcessRcvdPacket(lsa, pc);
+
+    delete pc;
+
+    // The latencies using the incrementally updated state must match those
+    // recomputed from scratch.
+    uint32_t  incr_latency_us[8][4];
+
+    for (BinId dst_id = 2; dst_id <= 7; ++dst_id)
+    {
+      CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(
+                       bin_map_->GetPhyBinIndex(dst_id),
+                       incr_latency_us[dst_id], false));
+    }
+
+    CPPUNIT_ASSERT(incr_latency_us[6][0] == UINT32_MAX);
+    CPPUNIT_ASSERT(incr_latency_us[6][1] == 6000);
+    CPPUNIT_ASSERT(incr_latency_us[6][2] == 8000);
+    CPPUNIT_ASSERT(incr_latency_us[6][3] == 17000);
+
+    bpfwder_->ResetLatencyCache();
+
+    for (BinId dst_id = 2; dst_id <= 7; ++dst_id)
+    {
+      CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(
+                       bin_map_->GetPhyBinIndex(dst_id), latency_us, false));
+
+      for (uint8_t pc_i = 0; pc_i < 4; ++pc_i)
+      {
+        CPPUNIT_ASSERT(latency_us[pc_i] == incr_latency_us[dst_id][pc_i]);
+      }
+    }
+
+    pkt_pool_->Recycle(lsa);
+  }
+
+  //==========================================================================
+  void TestLsaIntervalLatencyCache()
+  {
+    bpfwder_->ClearVariance();
+
+    std::vector<std::pair<BinId, uint32_t> > nbr_list;
+    std::vector<std::pair<BinId, uint64_t> > var_list;
+
+    // Path controllers 0, 1 and 2 lead to nodes 2, 3 and 4.  Node 2 and
+    // node 4 are only reachable through this node, and node 3 leads on to
+    // node 5.
+    // Neighbor list data is:  (src_bin_id, cost)
+    // Variance list data is:  (src_bin_id, variance)
+    nbr_list.push_back(std::pair<BinId, uint32_t> (1, 2000));
+    var_list.push_back(std::pair<BinId, uint64_t> (1, 0));
+    bpfwder_->AddRecord(2, nbr_list, var_list);
+
+    nbr_list.clear();
+    var_list.clear();
+    nbr_list.push_back(std::pair<BinId, uint32_t> (1, 1000));
+    nbr_list.push_back(std::pair<BinId, uint32_t> (5, 3000));
+    var_list.push_back(std::pair<BinId, uint64_t> (1, 0));
+    var_list.push_back(std::pair<BinId, uint64_t> (5, 0));
+    bpfwder_->AddRecord(3, nbr_list, var_list);
+
+    nbr_list.clear();
+    var_list.clear();
+    nbr_list.push_back(std::pair<BinId, uint32_t> (1, 1000));
+    var_list.push_back(std::pair<BinId, uint64_t> (1, 0));
+    bpfwder_->AddRecord(4, nbr_list, var_list);
+
+    nbr_list.clear();
+    var_list.clear();
+    nbr_list.push_back(std::pair<BinId, uint32_t> (3, 3000));
+    var_list.push_back(std::pair<BinId, uint64_t> (3, 0));
+    bpfwder_->AddRecord(5, nbr_list, var_list);
+
+    BinIndex  dst_2 = bin_map_->GetPhyBinIndex(2);
+    BinIndex  dst_3 = bin_map_->GetPhyBinIndex(3);
+    BinIndex  dst_5 = bin_map_->GetPhyBinIndex(5);
+    uint32_t  latency_us[4];
+    Packet*   lsa   = NULL;
+
+    // Record the PDDs of this LSA interval, then fill the cache.
+    lsa = bpfwder_->GenerateLsaTest();
+    if (lsa)
+    {
+      pkt_pool_->Recycle(lsa);
+    }
+
+    CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(dst_2, latency_us, false));
+    CPPUNIT_ASSERT(latency_us[0] == 2000);
+    CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(dst_3, latency_us, false));
+    CPPUNIT_ASSERT(latency_us[1] == 1000);
+
+    // PDD changes that do not alter the advertised (rounded) values keep
+    // the whole cache.
+    bpfwder_->SetPddMean(0, 0.00201);
+    bpfwder_->SetPddMean(1, 0.00101);
+    lsa = bpfwder_->GenerateLsaTest();
+    if (lsa)
+    {
+      pkt_pool_->Recycle(lsa);
+    }
+
+    CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(dst_2, latency_us, false));
+    CPPUNIT_ASSERT(latency_us[0] == 2000);
+    CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(dst_3, latency_us, false));
+    CPPUNIT_ASSERT(latency_us[1] == 1000);
+
+    // A change on the path to node 2 only erases the cached latencies to
+    // node 2, since node 3 cannot reach node 2 without this node.
+    bpfwder_->SetPddMean(0, 0.005);
+    lsa = bpfwder_->GenerateLsaTest();
+    if (lsa)
+    {
+      pkt_pool_->Recycle(lsa);
+    }
+
+    CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(dst_2, latency_us, false));
+    CPPUNIT_ASSERT(latency_us[0] == 5000);
+    CPPUNIT_ASSERT(latency_us[1] == UINT32_MAX);
+    CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(dst_3, latency_us, false));
+    CPPUNIT_ASSERT(latency_us[1] == 1000);
+
+    // A change on the path to node 3 erases the cached latencies to node 3
+    // and node 5.
+    bpfwder_->SetPddMean(1, 0.003);
+    lsa = bpfwder_->GenerateLsaTest();
+    if (lsa)
+    {
+      pkt_pool_->Recycle(lsa);
+    }
+
+    CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(dst_3, latency_us, false));
+    CPPUNIT_ASSERT(latency_us[1] == 3000);
+    CPPUNIT_ASSERT(bpfwder_->GetPerPcLatencyToDst(dst_5, latency_us, false));
+    CPPUNIT_ASSERT(latency_us[1] == 6000);
+  }
+
   //==========================================================================
   void TestBPFAlg()
   {
@@ -0,0 +1,235 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "bpf_trace.h"
+
+#include "itime.h"
+#include "log.h"
+#include "packet.h"
+#include "packet_pool_heap.h"
+
+#include <cstring>
+
+#include <unistd.h>
+
+using ::iron::BpfTraceCapacity;
+using ::iron::BpfTracePdd;
+using ::iron::BpfTracePktInfo;
+using ::iron::BpfTraceReader;
+using ::iron::BpfTraceRecordHeader;
+using ::iron::BpfTraceWriter;
+using ::iron::BpfTraceXmitQueueSize;
+using ::iron::Log;
+using ::iron::Packet;
+using ::iron::PacketPoolHeap;
+using ::iron::Time;
+
+namespace
+{
+  /// The trace file used in the tests.
+  const char*  kTraceFile = "bpf_trace_test.trc";
+}
+
+//============================================================================
+class BpfTraceTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(BpfTraceTest);
+
+  CPPUNIT_TEST(TestRoundTrip);
+  CPPUNIT_TEST(TestBadFile);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  PacketPoolHeap*  pkt_pool_;
+
+public:
+
+  //==========================================================================
+  void setUp()
+  {
+    Log::SetDefaultLevel("F");
+
+    pkt_pool_ = new PacketPoolHeap();
+    CPPUNIT_ASSERT(pkt_pool_);
+    CPPUNIT_ASSERT(pkt_pool_->Create(8) == true);
+  }
+
+  //==========================================================================
+  void tearDown()
+  {
+    delete pkt_pool_;
+    pkt_pool_ = NULL;
+
+    unlink(kTraceFile);
+    Time::ClearSimulatedNow();
+
+    Log::SetDefaultLevel("FEWI");
+  }
+
+  //==========================================================================
+  void TestRoundTrip()
+  {
+    Time::SetSimulatedNow(Time::FromUsec(5000000));
+
+    // A large IPv4 packet, of which only the headers are captured.
+    Packet*  data_pkt = pkt_pool_->Get();
+    CPPUNIT_ASSERT(data_pkt);
+    memset(data_pkt->GetBuffer(), 0xAB, 1000);
+    data_pkt->GetBuffer()[0] = 0x45;
+    data_pkt->SetLengthInBytes(1000);
+    data_pkt->set_bin_id(3);
+    data_pkt->set_recv_time(Time::FromUsec(4999000));
+    data_pkt->SetTimeToGo(Time::FromUsec(150000));
+    data_pkt->set_track_ttg(true);
+
+    // A small control packet, which is captured whole.
+    Packet*  qlam_pkt = pkt_pool_->Get();
+    CPPUNIT_ASSERT(qlam_pkt);
+    memset(qlam_pkt->GetBuffer(), 0x11, 40);
+    qlam_pkt->GetBuffer()[0] = iron::QLAM_PACKET;
+    qlam_pkt->SetLengthInBytes(40);
+
+    BpfTraceWriter*  writer = new BpfTraceWriter();
+    CPPUNIT_ASSERT(writer->Open(kTraceFile, 7));
+
+    writer->RecordPacket(iron::kTraceProxyPathCtrlNum, data_pkt);
+    Time::SetSimulatedNow(Time::FromUsec(5000100));
+    writer->RecordPacket(2, qlam_pkt);
+    writer->RecordCapacity(1, 1.0e7, 9.0e6);
+    writer->RecordPdd(1, 0.025, 0.0001);
+    Time::SetSimulatedNow(Time::FromUsec(5000200));
+    writer->RecordXmitQueueSize(0, true, 4500);
+    writer->RecordXmitQueueSize(1, false, 0);
+    CPPUNIT_ASSERT(writer->num_records() == 6);
+
+    delete writer;
+
+    pkt_pool_->Recycle(data_pkt);
+    pkt_pool_->Recycle(qlam_pkt);
+
+    BpfTraceReader        reader;
+    BpfTraceRecordHeader  hdr;
+    uint8_t               body[iron::kMaxPacketSizeBytes +
+                               sizeof(BpfTracePktInfo)];
+
+    CPPUNIT_ASSERT(reader.Open(kTraceFile));
+    CPPUNIT_ASSERT(reader.file_hdr().bin_id == 7);
+    CPPUNIT_ASSERT(reader.file_hdr().start_time_usec == 5000000);
+
+    // The IPv4 packet.
+    CPPUNIT_ASSERT(reader.ReadRecord(hdr, body, sizeof(body)));
+    CPPUNIT_ASSERT(hdr.type == iron::TRACE_RCVD_PKT);
+    CPPUNIT_ASSERT(hdr.pc_num == iron::kTraceProxyPathCtrlNum);
+    CPPUNIT_ASSERT(hdr.time_usec == 5000000);
+    CPPUNIT_ASSERT(hdr.body_len == (sizeof(BpfTracePktInfo) +
+                                    iron::kTraceIpv4CaptureBytes));
+
+    BpfTracePktInfo  info;
+    memcpy(&info, body, sizeof(info));
+    CPPUNIT_ASSERT(info.pkt_len == 1000);
+    CPPUNIT_ASSERT(info.bin_id == 3);
+    CPPUNIT_ASSERT(info.recv_time_usec == 4999000);
+    CPPUNIT_ASSERT(info.ttg_usec == 150000);
+    CPPUNIT_ASSERT(info.flags == (iron::kTraceTtgValid |
+                                  iron::kTraceTrackTtg));
+    CPPUNIT_ASSERT(body[sizeof(info)] == 0x45);
+    CPPUNIT_ASSERT(body[sizeof(info) + 1] == 0xAB);
+
+    // The QLAM.
+    CPPUNIT_ASSERT(reader.ReadRecord(hdr, body, sizeof(body)));
+    CPPUNIT_ASSERT(hdr.type == iron::TRACE_RCVD_PKT);
+    CPPUNIT_ASSERT(hdr.pc_num == 2);
+    CPPUNIT_ASSERT(hdr.time_usec == 5000100);
+    CPPUNIT_ASSERT(hdr.body_len == (sizeof(BpfTracePktInfo) + 40));
+
+    // The capacity update.
+    BpfTraceCapacity  cap;
+    CPPUNIT_ASSERT(reader.ReadRecord(hdr, body, sizeof(body)));
+    CPPUNIT_ASSERT(hdr.type == iron::TRACE_CAPACITY);
+    CPPUNIT_ASSERT(hdr.pc_num == 1);
+    memcpy(&cap, body, sizeof(cap));
+    CPPUNIT_ASSERT(cap.chan_cap_est_bps == 1.0e7);
+    CPPUNIT_ASSERT(cap.trans_cap_est_bps == 9.0e6);
+
+    // The PDD update.
+    BpfTracePdd  pdd;
+    CPPUNIT_ASSERT(reader.ReadRecord(hdr, body, sizeof(body)));
+    CPPUNIT_ASSERT(hdr.type == iron::TRACE_PDD);
+    memcpy(&pdd, body, sizeof(pdd));
+    CPPUNIT_ASSERT(pdd.pdd_mean == 0.025);
+    CPPUNIT_ASSERT(pdd.pdd_variance == 0.0001);
+
+    // The transmit queue sizes.
+    BpfTraceXmitQueueSize  xqs;
+    CPPUNIT_ASSERT(reader.ReadRecord(hdr, body, sizeof(body)));
+    CPPUNIT_ASSERT(hdr.type == iron::TRACE_XMIT_QUEUE_SIZE);
+    CPPUNIT_ASSERT(hdr.pc_num == 0);
+    CPPUNIT_ASSERT(hdr.time_usec == 5000200);
+    memcpy(&xqs, body, sizeof(xqs));
+    CPPUNIT_ASSERT(xqs.valid == 1);
+    CPPUNIT_ASSERT(xqs.size == 4500);
+
+    CPPUNIT_ASSERT(reader.ReadRecord(hdr, body, sizeof(body)));
+    memcpy(&xqs, body, sizeof(xqs));
+    CPPUNIT_ASSERT(hdr.pc_num == 1);
+    CPPUNIT_ASSERT(xqs.valid == 0);
+
+    // The end of the trace.
+    CPPUNIT_ASSERT(!reader.ReadRecord(hdr, body, sizeof(body)));
+  }
+
+  //==========================================================================
+  void TestBadFile()
+  {
+    BpfTraceReader  missing;
+    CPPUNIT_ASSERT(!missing.Open("bpf_trace_test_missing.trc"));
+
+    FILE*  file = fopen(kTraceFile, "wb");
+    CPPUNIT_ASSERT(file);
+    fputs("not a trace file, but long enough for a header", file);
+    fclose(file);
+
+    BpfTraceReader  bad;
+    CPPUNIT_ASSERT(!bad.Open(kTraceFile));
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BpfTraceTest);
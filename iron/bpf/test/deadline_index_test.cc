@@ -0,0 +1,238 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "deadline_index.h"
+
+#include "itime.h"
+#include "log.h"
+#include "packet.h"
+#include "packet_pool_heap.h"
+
+#include <vector>
+
+using ::iron::DeadlineIndex;
+using ::iron::Log;
+using ::iron::Packet;
+using ::iron::PacketPoolHeap;
+using ::iron::PacketQueue;
+using ::iron::Time;
+using ::std::vector;
+
+namespace
+{
+  /// The number of packets used in the tests.
+  const size_t  kNumPkts = 40;
+}
+
+//============================================================================
+class DeadlineIndexTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(DeadlineIndexTest);
+
+  CPPUNIT_TEST(TestAddRemove);
+  CPPUNIT_TEST(TestPopExpired);
+  CPPUNIT_TEST(TestLateAndFarDeadlines);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  PacketPoolHeap*  pkt_pool_;
+  DeadlineIndex*   index_;
+  Time             base_;
+  Packet*          pkts_[kNumPkts];
+
+public:
+
+  //==========================================================================
+  void setUp()
+  {
+    Log::SetDefaultLevel("F");
+
+    pkt_pool_ = new PacketPoolHeap();
+    CPPUNIT_ASSERT(pkt_pool_);
+    CPPUNIT_ASSERT(pkt_pool_->Create(64) == true);
+
+    // 16 slots of 1 ms, so that the tests cross the wheel horizon.
+    index_ = new DeadlineIndex();
+    CPPUNIT_ASSERT(index_);
+    CPPUNIT_ASSERT(index_->Initialize(16, 1000));
+
+    base_ = Time::FromUsec(1000000000LL);
+
+    // Packet i expires (500 * i + 100) us after the base time.
+    for (size_t i = 0; i < kNumPkts; ++i)
+    {
+      pkts_[i] = pkt_pool_->Get();
+      CPPUNIT_ASSERT(pkts_[i]);
+      pkts_[i]->set_recv_time(base_);
+      pkts_[i]->SetTimeToGo(Time::FromUsec(500 * i + 100));
+    }
+  }
+
+  //==========================================================================
+  void tearDown()
+  {
+    delete index_;
+    index_ = NULL;
+
+    for (size_t i = 0; i < kNumPkts; ++i)
+    {
+      pkt_pool_->Recycle(pkts_[i]);
+      pkts_[i] = NULL;
+    }
+
+    delete pkt_pool_;
+    pkt_pool_ = NULL;
+
+    Log::SetDefaultLevel("FEWI");
+  }
+
+  //==========================================================================
+  void TestAddRemove()
+  {
+    Packet*                      pkt = NULL;
+    Time                         deadline;
+    PacketQueue::QueueWalkState  qws;
+
+    CPPUNIT_ASSERT(!index_->PeekEarliest(pkt, deadline, qws));
+
+    // Add the packets in reverse deadline order.
+    for (size_t i = kNumPkts; i > 0; --i)
+    {
+      CPPUNIT_ASSERT(index_->Add(pkts_[i - 1], qws));
+    }
+    CPPUNIT_ASSERT(index_->size() == kNumPkts);
+
+    CPPUNIT_ASSERT(index_->PeekEarliest(pkt, deadline, qws));
+    CPPUNIT_ASSERT(pkt == pkts_[0]);
+    CPPUNIT_ASSERT(deadline.GetTimeInUsec() == base_.GetTimeInUsec() + 100);
+
+    CPPUNIT_ASSERT(index_->Remove(pkts_[0]));
+    CPPUNIT_ASSERT(!index_->Remove(pkts_[0]));
+    CPPUNIT_ASSERT(index_->size() == kNumPkts - 1);
+
+    CPPUNIT_ASSERT(index_->PeekEarliest(pkt, deadline, qws));
+    CPPUNIT_ASSERT(pkt == pkts_[1]);
+
+    // Packets without a valid time-to-go are not indexed.
+    Packet*  no_ttg = pkt_pool_->Get();
+    CPPUNIT_ASSERT(no_ttg);
+    no_ttg->SetTimeToGo(Time(0), false);
+    CPPUNIT_ASSERT(!index_->Add(no_ttg, qws));
+    pkt_pool_->Recycle(no_ttg);
+
+    index_->Clear();
+    CPPUNIT_ASSERT(index_->size() == 0);
+    CPPUNIT_ASSERT(!index_->PeekEarliest(pkt, deadline, qws));
+  }
+
+  //==========================================================================
+  void TestPopExpired()
+  {
+    vector<DeadlineIndex::Entry>  expired;
+    PacketQueue::QueueWalkState   qws;
+
+    for (size_t i = 0; i < kNumPkts; ++i)
+    {
+      CPPUNIT_ASSERT(index_->Add(pkts_[i], qws));
+    }
+
+    // Within the wheel horizon: packets 0 to 9 expire before 5 ms.
+    CPPUNIT_ASSERT(index_->PopExpired(base_ + Time::FromUsec(5000),
+                                      expired) == 10);
+    for (size_t i = 0; i < expired.size(); ++i)
+    {
+      CPPUNIT_ASSERT(expired[i].deadline_us <
+                     base_.GetTimeInUsec() + 5000);
+    }
+
+    // Popping again with the same threshold finds nothing.
+    expired.clear();
+    CPPUNIT_ASSERT(index_->PopExpired(base_ + Time::FromUsec(5000),
+                                      expired) == 0);
+
+    Packet*  pkt = NULL;
+    Time     deadline;
+    CPPUNIT_ASSERT(index_->PeekEarliest(pkt, deadline, qws));
+    CPPUNIT_ASSERT(pkt == pkts_[10]);
+
+    // Beyond the wheel horizon: packets 10 to 29 expire before 15 ms.
+    expired.clear();
+    CPPUNIT_ASSERT(index_->PopExpired(base_ + Time::FromUsec(15000),
+                                      expired) == 20);
+    CPPUNIT_ASSERT(index_->size() == kNumPkts - 30);
+
+    // An infinite threshold empties the index.
+    expired.clear();
+    CPPUNIT_ASSERT(index_->PopExpired(Time::Infinite(), expired) ==
+                   kNumPkts - 30);
+    CPPUNIT_ASSERT(index_->size() == 0);
+  }
+
+  //==========================================================================
+  void TestLateAndFarDeadlines()
+  {
+    Packet*                       pkt = NULL;
+    Time                          deadline;
+    vector<DeadlineIndex::Entry>  expired;
+    PacketQueue::QueueWalkState   qws;
+
+    CPPUNIT_ASSERT(index_->Add(pkts_[20], qws));
+    CPPUNIT_ASSERT(index_->PopExpired(base_ + Time::FromUsec(9000),
+                                      expired) == 0);
+
+    // A packet whose deadline is behind the cursor is still found first.
+    CPPUNIT_ASSERT(index_->Add(pkts_[0], qws));
+    CPPUNIT_ASSERT(index_->PeekEarliest(pkt, deadline, qws));
+    CPPUNIT_ASSERT(pkt == pkts_[0]);
+    CPPUNIT_ASSERT(index_->Remove(pkts_[0]));
+
+    // A packet more than one revolution away is found by the full search.
+    pkts_[39]->SetTimeToGo(Time::FromUsec(900000));
+    CPPUNIT_ASSERT(index_->Add(pkts_[39], qws));
+    CPPUNIT_ASSERT(index_->Remove(pkts_[20]));
+    CPPUNIT_ASSERT(index_->PeekEarliest(pkt, deadline, qws));
+    CPPUNIT_ASSERT(pkt == pkts_[39]);
+    CPPUNIT_ASSERT(index_->Remove(pkts_[39]));
+    CPPUNIT_ASSERT(index_->size() == 0);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DeadlineIndexTest);
@@ -98,6 +98,18 @@ namespace iron
     /// \return Number of bytes sent, -1 on failure.
     ssize_t Send(const Packet* pkt);
 
+    /// \brief Send a batch of packets on the edge interface.
+    ///
+    /// The packets are handed to the kernel with as few sendmmsg() calls as
+    /// possible, in order. A packet that cannot be sent is dropped and the
+    /// packets after it are still sent.
+    ///
+    /// \param  pkts      The packets to send.
+    /// \param  num_pkts  The number of packets to send.
+    ///
+    /// \return The number of packets sent.
+    size_t SendBatch(const Packet* const* pkts, size_t num_pkts);
+
     /// \brief Add the underlying file descriptor to a mask.
     ///
     /// The receive process uses this method for adding the file to a fd_set
@@ -162,6 +174,14 @@ namespace iron
     /// \brief Close the edge interface sockets.
     void CloseSockets();
 
+    /// \brief Get the destination address for a packet.
+    ///
+    /// \param  pkt   The packet to be sent.
+    /// \param  addr  The address that is filled in.
+    ///
+    /// \return True if the packet's destination was found, false otherwise.
+    bool GetDstAddr(const Packet* pkt, struct sockaddr_in& addr) const;
+
     /// \brief Execute a system command.
     ///
     /// Program termination will occur if the execution of the provided system
@@ -0,0 +1,160 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#ifndef IRON_COMMON_EDGE_IF_SEND_BATCH_H
+#define IRON_COMMON_EDGE_IF_SEND_BATCH_H
+
+/// \brief Batches the packets sent on an edge interface.
+
+#include "packet.h"
+
+#include <vector>
+
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace iron
+{
+  class PacketPool;
+  class VirtualEdgeIf;
+
+  /// \brief Collects the packets sent on an edge interface and sends them
+  /// together.
+  ///
+  /// A proxy queues the packets that it sends to the LAN with Send() and
+  /// calls Flush() once per pass of its event loop, before it blocks. The
+  /// packets are sent in the order in which they were queued, with a single
+  /// VirtualEdgeIf::SendBatch() call per flush. A full batch is flushed
+  /// immediately.
+  ///
+  /// The batch is not thread-safe. Each thread that sends on a shared edge
+  /// interface uses its own batch.
+  class EdgeIfSendBatch
+  {
+    public:
+
+    /// \brief Constructor.
+    ///
+    /// \param  edge_if      The edge interface on which to send the packets.
+    /// \param  packet_pool  The pool to which sent packets are recycled.
+    EdgeIfSendBatch(VirtualEdgeIf& edge_if, PacketPool& packet_pool);
+
+    /// \brief Destructor.
+    ///
+    /// Packets that are still queued are recycled without being sent.
+    virtual ~EdgeIfSendBatch();
+
+    /// \brief Queue a packet to be sent.
+    ///
+    /// The batch takes ownership of the packet, which is recycled once it
+    /// has been sent.
+    ///
+    /// \param  pkt  The packet to send.
+    ///
+    /// \return The number of bytes queued, or -1 if the packet is NULL.
+    ssize_t Send(Packet* pkt);
+
+    /// \brief Send the queued packets.
+    ///
+    /// \return The number of packets sent.
+    size_t Flush();
+
+    /// \brief Get the number of packets waiting to be sent.
+    ///
+    /// \return The number of queued packets.
+    inline size_t num_queued() const
+    {
+      return pkts_.size();
+    }
+
+    /// \brief Get the number of non-empty flushes.
+    ///
+    /// \return The number of batches sent.
+    inline uint64_t num_batches() const
+    {
+      return num_batches_;
+    }
+
+    /// \brief Get the number of packets in all of the batches sent.
+    ///
+    /// \return The number of packets handed to the edge interface.
+    inline uint64_t num_pkts() const
+    {
+      return num_pkts_;
+    }
+
+    /// \brief Get the size of the largest batch sent.
+    ///
+    /// \return The largest number of packets sent in one batch.
+    inline size_t max_batch_size() const
+    {
+      return max_batch_size_;
+    }
+
+    private:
+
+    /// \brief Copy constructor.
+    EdgeIfSendBatch(const EdgeIfSendBatch& other);
+
+    /// \brief Assignment operator.
+    EdgeIfSendBatch& operator=(const EdgeIfSendBatch& other);
+
+    /// The edge interface on which the packets are sent.
+    VirtualEdgeIf&        edge_if_;
+
+    /// The pool to which the packets are recycled.
+    PacketPool&           packet_pool_;
+
+    /// The queued packets, in the order in which they are to be sent.
+    std::vector<Packet*>  pkts_;
+
+    /// The number of non-empty flushes.
+    uint64_t              num_batches_;
+
+    /// The number of packets handed to the edge interface.
+    uint64_t              num_pkts_;
+
+    /// The number of packets that the edge interface failed to send.
+    uint64_t              num_send_errors_;
+
+    /// The largest number of packets sent in one batch.
+    size_t                max_batch_size_;
+
+  }; // end class EdgeIfSendBatch
+} // namespace iron
+
+#endif // IRON_COMMON_EDGE_IF_SEND_BATCH_H
@@ -242,6 +242,20 @@ namespace iron
     /// \return  The current time in microseconds.
     static int64_t GetNowInUsec();
 
+    /// \brief Drive the monotonic clock from a simulated time source.
+    ///
+    /// Once called, Now(), GetNow(), GetNowInSec() and GetNowInUsec() all
+    /// return the simulated time instead of reading the system clock, until
+    /// ClearSimulatedNow() is called.  This is only intended for
+    /// discrete-event simulation of the forwarding code, and is not thread
+    /// safe.
+    ///
+    /// \param  now  The simulated current time.
+    static void SetSimulatedNow(const Time& now);
+
+    /// \brief Return to reading the system monotonic clock.
+    static void ClearSimulatedNow();
+
     /// \brief Zero the Time object.
     void Zero();
 
@@ -227,6 +227,28 @@ namespace iron
       return true;
     }
 
+    /// \brief  The method to append a new item to the list and get its
+    ///         location.
+    ///
+    /// It does not take ownership of any memory in the element.
+    /// The element is inserted at the tail of the list.
+    ///
+    /// \param  element  A reference to the element to store.
+    /// \param  ws       The walk state, set to point to the new link.
+    ///
+    /// \return true if success inserting, false otherwise.
+    inline bool Push(const C& element, WalkState& ws)
+    {
+      LLElem* e = GetLle(element);
+      if (e == NULL)
+      {
+        return false;
+      }
+      Push(e);
+      ws.walk_elem_ = e;
+      return true;
+    }
+
     /// \brief  The method to remove an item from the head of the list.
     ///
     /// It leaves ownership with the caller.
@@ -375,6 +397,26 @@ namespace iron
       return true;
     }
 
+    /// \brief  Check if a walk state points to an element in the list.
+    ///
+    /// Links are pooled for the life of the list, so a walk state saved
+    /// from this list may be checked in constant time, even after its link
+    /// was removed.
+    ///
+    /// \param  ws  A walk state obtained from this list.
+    /// \param  c   The element expected at the walk state.
+    ///
+    /// \return True if the walk state points to a link of the list holding
+    ///         the element, false otherwise.
+    inline bool IsAt(const WalkState& ws, const C& c) const
+    {
+      LLElem* e = ws.walk_elem_;
+
+      // Links in the pool have no previous link and are never the head.
+      return ((e != NULL) && (e->element == c) &&
+              ((e->prev != NULL) || (e == head_)));
+    }
+
     /// \brief  Check if an element is in the list.
     ///
     /// \param c The element being searched for.
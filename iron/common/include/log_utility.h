@@ -45,6 +45,7 @@
 namespace iron
 {
   class KVal;
+  class LogUtilityBatch;
   class ProxyState;
 
   class LogUtility : public UtilityFn
@@ -57,11 +58,14 @@ namespace iron
     /// \param  bin_idx       The bin index (mcast or ucast).
     /// \param  k_val         A reference to the proxy's k value.
     /// \param  flow_id       The flow identifier.
+    /// \param  batch         The proxy's batch of Log utility functions, or
+    ///                       NULL if the send rate is to be computed on each
+    ///                       call. The batch must outlive this object.
     LogUtility(QueueDepths& queue_depths, BinIndex bin_idx, KVal& k_val,
-               uint32_t flow_id);
+               uint32_t flow_id, LogUtilityBatch* batch = NULL);
 
     /// \brief destructor
-    virtual ~LogUtility() {};
+    virtual ~LogUtility();
 
     /// \brief Initialize the Log Utility Function.
     ///
@@ -75,10 +79,18 @@ namespace iron
     /// \brief Get the send rate, in bits per second, allowed by the utility
     /// function.
     ///
+    /// If the utility function is registered with a batch that has been
+    /// evaluated, the send rate from that evaluation is returned.
+    ///
     /// \return The rate, in bits per second, at which to admit packets
     ///         into the network in order to maximize utility.
     virtual double GetSendRate();
 
+    /// \brief Set the priority of the flow.
+    ///
+    /// \param  priority  The new priority of the flow.
+    virtual void set_priority(double priority);
+
     /// \brief  Compute the instantaneous utility.
     ///
     /// \param  send_rate The send rate for this utility.
@@ -87,13 +99,22 @@ namespace iron
     private:
 
     /// The utility function's max send rate parameter, in bits per second.
-    double    m_val_;
+    double            m_val_;
 
     /// Backpressure queue normalization parameter (bits^2/sec).
-    KVal&     k_val_;
+    KVal&             k_val_;
 
     /// Normalized 'a' shape parameter for the utility function.
-    double    a_val_;
+    double            a_val_;
+
+    /// The batch that computes the send rate, or NULL.
+    LogUtilityBatch*  batch_;
+
+    /// The utility function's slot in the batch.
+    size_t            batch_slot_;
+
+    /// Whether the utility function is registered with the batch.
+    bool              in_batch_;
 
   }; // end class LogUtility
 
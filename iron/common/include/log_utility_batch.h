@@ -0,0 +1,205 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#ifndef IRON_PROXY_COMMON_LOG_UTILITY_BATCH_H
+#define	IRON_PROXY_COMMON_LOG_UTILITY_BATCH_H
+
+#include "iron_types.h"
+
+#include <vector>
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/// Batch evaluation of the send rates of a proxy's Log utility functions.
+namespace iron
+{
+  class KVal;
+  class QueueDepths;
+
+  /// \brief Evaluates the send rates of a set of Log utility functions in a
+  /// single pass.
+  ///
+  /// The parameters of each registered flow are kept in parallel arrays
+  /// (struct-of-arrays) indexed by a slot number. Evaluate() reads K once and
+  /// the queue depth of each bin once, and then computes the send rates of
+  /// all of the flows in a tight loop over the arrays. A LogUtility that is
+  /// registered with a batch is a thin view onto its slot and returns the
+  /// send rate computed by the most recent evaluation.
+  ///
+  /// The proxy that owns the batch calls Evaluate() once per service pass,
+  /// before the flows are serviced.
+  class LogUtilityBatch
+  {
+    public:
+
+    /// \brief Constructor.
+    ///
+    /// \param  queue_depths  A reference to the queue depths object from BPF.
+    /// \param  k_val         A reference to the proxy's k value.
+    LogUtilityBatch(QueueDepths& queue_depths, KVal& k_val);
+
+    /// \brief Destructor.
+    virtual ~LogUtilityBatch();
+
+    /// \brief Register a flow with the batch.
+    ///
+    /// The flow's send rate is not available until the next evaluation.
+    ///
+    /// \param  bin_idx  The bin index for the flow.
+    /// \param  a_val    The flow's 'a' shape parameter.
+    /// \param  m_val    The flow's max send rate, in bits per second.
+    /// \param  p_val    The flow's priority.
+    ///
+    /// \return The flow's slot in the batch.
+    size_t Add(BinIndex bin_idx, double a_val, double m_val, double p_val);
+
+    /// \brief Remove a flow from the batch.
+    ///
+    /// \param  slot  The flow's slot in the batch.
+    void Remove(size_t slot);
+
+    /// \brief Set the priority of a flow.
+    ///
+    /// The flow's send rate is not available until the next evaluation.
+    ///
+    /// \param  slot   The flow's slot in the batch.
+    /// \param  p_val  The new priority of the flow.
+    void SetPriority(size_t slot, double p_val);
+
+    /// \brief Compute the send rates of all of the flows in the batch.
+    void Evaluate();
+
+    /// \brief Check if a flow's send rate has been computed.
+    ///
+    /// \param  slot  The flow's slot in the batch.
+    ///
+    /// \return True if the flow's send rate has been computed since it was
+    ///         added or last modified, false otherwise.
+    inline bool IsEvaluated(size_t slot) const
+    {
+      return (evaluated_[slot] != 0);
+    }
+
+    /// \brief Get the send rate computed for a flow.
+    ///
+    /// \param  slot  The flow's slot in the batch.
+    ///
+    /// \return The flow's send rate, in bits per second.
+    inline double send_rate(size_t slot) const
+    {
+      return rate_[slot];
+    }
+
+    /// \brief Get the queue depth used to compute a flow's send rate.
+    ///
+    /// \param  slot  The flow's slot in the batch.
+    ///
+    /// \return The queue depth of the flow's bin, in bits.
+    inline double queue_depth_bits(size_t slot) const
+    {
+      return qd_bits_[slot];
+    }
+
+    /// \brief Get the number of flows in the batch.
+    ///
+    /// \return The number of flows in the batch.
+    inline size_t num_flows() const
+    {
+      return num_flows_;
+    }
+
+    private:
+
+    /// \brief Copy constructor.
+    LogUtilityBatch(const LogUtilityBatch& other);
+
+    /// \brief Assignment operator.
+    LogUtilityBatch& operator=(const LogUtilityBatch& other);
+
+    /// The queue depths from which the bin depths are read.
+    QueueDepths&           queue_depths_;
+
+    /// Backpressure queue normalization parameter (bits^2/sec).
+    KVal&                  k_val_;
+
+    /// The bin index of each flow.
+    std::vector<BinIndex>  bin_idx_;
+
+    /// The 'a' shape parameter of each flow.
+    std::vector<double>    a_val_;
+
+    /// The max send rate of each flow, in bits per second.
+    std::vector<double>    m_val_;
+
+    /// The priority of each flow.
+    std::vector<double>    p_val_;
+
+    /// The queue depth, in bits, used in the last evaluation of each flow.
+    std::vector<double>    qd_bits_;
+
+    /// The send rate, in bits per second, from the last evaluation of each
+    /// flow.
+    std::vector<double>    rate_;
+
+    /// Flags recording which slots hold a flow.
+    std::vector<uint8_t>   in_use_;
+
+    /// Flags recording which slots have been evaluated since the flow was
+    /// added or modified.
+    std::vector<uint8_t>   evaluated_;
+
+    /// The slots that have been released for reuse.
+    std::vector<size_t>    free_slots_;
+
+    /// The number of flows in the batch.
+    size_t                 num_flows_;
+
+    /// The queue depth of each bin, in bits, read during an evaluation.
+    std::vector<double>    bin_depth_bits_;
+
+    /// The evaluation in which each bin's queue depth was last read.
+    std::vector<uint32_t>  bin_epoch_;
+
+    /// The current evaluation number.
+    uint32_t               epoch_;
+
+  }; // end class LogUtilityBatch
+
+} // namespace iron
+
+#endif // IRON_PROXY_COMMON_LOG_UTILITY_BATCH_H
@@ -252,6 +252,29 @@ namespace iron
       return true;
     }
 
+    /// \brief  The method to insert a new item in the list and get its
+    ///         location.
+    ///
+    /// It does not take ownership of any memory in the element.
+    ///
+    /// \param  element  A reference to the element to store.
+    /// \param  value    The value by which to order this element in the list.
+    /// \param  ws       The walk state, set to point to the new link.
+    ///
+    /// \return true if success inserting, false otherwise.
+    inline bool Push(const C& element, const O& value, WalkState& ws)
+    {
+      LLElem* e = GetLle(element, value);
+      if (e == NULL)
+      {
+        return false;
+      }
+
+      OrderedInsert(e);
+      ws.walk_elem_ = e;
+      return true;
+    }
+
     /// \brief  The method to remove an item from the head of the list.
     ///
     /// It leaves ownership with the caller.
@@ -401,6 +424,26 @@ namespace iron
       return true;
     }
 
+    /// \brief  Check if a walk state points to an element in the list.
+    ///
+    /// Links are pooled for the life of the list, so a walk state saved
+    /// from this list may be checked in constant time, even after its link
+    /// was removed.
+    ///
+    /// \param  ws  A walk state obtained from this list.
+    /// \param  c   The element expected at the walk state.
+    ///
+    /// \return True if the walk state points to a link of the list holding
+    ///         the element, false otherwise.
+    inline bool IsAt(const WalkState& ws, const C& c) const
+    {
+      LLElem* e = ws.walk_elem_;
+
+      // Links in the pool have no previous link and are never the head.
+      return ((e != NULL) && (e->element == c) &&
+              ((e->prev != NULL) || (e == head_)));
+    }
+
     /// \brief  Remove an element from the linked list.
     ///         
     /// If the element owns memory, this method does not free the 
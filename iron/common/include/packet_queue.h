@@ -212,6 +212,19 @@ namespace iron
     /// \return An iterator, the NULL iterator if not found.
     QueueWalkState GetIterator(Packet* pkt);
 
+    /// \brief  Check if an iterator points to a given packet in the queue.
+    ///
+    /// Unlike GetIterator(), this takes constant time. The iterator may be
+    /// stale, e.g., saved by Enqueue() for a packet that has since been
+    /// dropped.
+    ///
+    /// \param  iterator  An iterator obtained from this queue.
+    /// \param  pkt       The packet expected at the iterator.
+    ///
+    /// \return True if the packet is in the queue at the iterator, false
+    ///         otherwise.
+    bool IsAtIterator(const QueueWalkState& iterator, Packet* pkt) const;
+
     /// \brief  Dequeue the current packet, place iterator at element following
     ///         the one dequeued.
     /// Memory ownership quits the queue to go with the caller.
@@ -259,6 +272,22 @@ namespace iron
     //           the caller retains ownership of the memory.
     virtual bool Enqueue(Packet* pkt);
 
+    /// \brief Enqueue an element into the queue and get an iterator pointing
+    ///        to it.
+    ///
+    /// Behaves like Enqueue(Packet*). The iterator can later be checked with
+    /// IsAtIterator() and used to dequeue the packet without a search.
+    ///
+    /// \param  pkt       Pointer to the packet to be enqueued.  Must not be
+    ///                   NULL.
+    /// \param  iterator  The iterator, set to point to the packet on
+    ///                   success.
+    ///
+    /// \return  Returns true if the enqueue operation succeeded and the queue
+    //           has taken ownership of the memory, or false if it failed and
+    //           the caller retains ownership of the memory.
+    bool Enqueue(Packet* pkt, QueueWalkState& iterator);
+
     /// \brief Set the queue's size limit.
     ///
     /// If the current number of packets in the queue is larger than the
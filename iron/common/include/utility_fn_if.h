@@ -119,7 +119,10 @@ namespace iron
     /// \brief Set the priority of a flow.
     ///
     /// \param priority The new priority of the flow.
-    inline void set_priority(double priority) { p_val_ = priority; }
+    virtual inline void set_priority(double priority)
+    {
+      p_val_ = priority;
+    }
 
     /// \brief Get the flow priority.
     ///
@@ -91,6 +91,32 @@ namespace iron
     /// \return Number of bytes sent, -1 on failure.
     virtual ssize_t Send(const Packet* pkt) = 0;
 
+    /// \brief Send a batch of packets on the edge interface.
+    ///
+    /// The packets are sent in order. A packet that cannot be sent is
+    /// dropped and the packets after it are still sent, just as if Send()
+    /// had been called for each one. This default implementation does
+    /// exactly that.
+    ///
+    /// \param  pkts      The packets to send.
+    /// \param  num_pkts  The number of packets to send.
+    ///
+    /// \return The number of packets sent.
+    virtual size_t SendBatch(const Packet* const* pkts, size_t num_pkts)
+    {
+      size_t  num_sent = 0;
+
+      for (size_t i = 0; i < num_pkts; ++i)
+      {
+        if (Send(pkts[i]) >= 0)
+        {
+          ++num_sent;
+        }
+      }
+
+      return num_sent;
+    }
+
     /// \brief Add the underlying file descriptor to a mask.
     ///
     /// The receive process uses this method for adding the file to a fd_set
@@ -53,6 +53,9 @@ namespace
 
   /// Identifier for an unopened socket file descriptor.
   const int kNoFd = -1;
+
+  /// The maximum number of packets handed to each sendmmsg() call.
+  const unsigned int  kMaxSendBatchSize = 64;
 }
 
 using ::iron::EdgeIf;
@@ -240,27 +243,12 @@ ssize_t EdgeIf::Send(const Packet* pkt)
     return -1;
   }
 
-  uint16_t  dport;
-  if (!pkt->GetDstPort(dport))
-  {
-    LogE(kClassName, __func__, "Error getting destination port.\n");
-    return -1;
-  }
-
-  uint32_t  daddr;
-  if (!pkt->GetIpDstAddr(daddr))
+  struct sockaddr_in  addr;
+  if (!GetDstAddr(pkt, addr))
   {
-    LogE(kClassName, __func__, "Error getting packet's destination "
-         "address.\n");
     return -1;
   }
 
-  struct sockaddr_in  addr;
-  memset(&addr, 0, sizeof(addr));
-  addr.sin_family      = AF_INET;
-  addr.sin_port        = dport;
-  addr.sin_addr.s_addr = daddr;
-
   ssize_t  num_written;
   if ((num_written = sendto(xmt_sock_, pkt->GetBuffer(),
                             pkt->GetLengthInBytes(), 0,
@@ -278,6 +266,85 @@ ssize_t EdgeIf::Send(const Packet* pkt)
   return num_written;
 }
 
+//============================================================================
+size_t EdgeIf::SendBatch(const Packet* const* pkts, size_t num_pkts)
+{
+  struct mmsghdr      msgs[kMaxSendBatchSize];
+  struct iovec        iovs[kMaxSendBatchSize];
+  struct sockaddr_in  addrs[kMaxSendBatchSize];
+  size_t              num_sent = 0;
+  size_t              i        = 0;
+
+  while (i < num_pkts)
+  {
+    // Build the messages for the next chunk of packets. A packet without a
+    // valid destination is dropped here, as Send() would drop it.
+    unsigned int  num_msgs = 0;
+
+    for (; (i < num_pkts) && (num_msgs < kMaxSendBatchSize); ++i)
+    {
+      if (pkts[i] == NULL)
+      {
+        LogF(kClassName, __func__, "Error: pkt was NULL\n");
+        continue;
+      }
+
+      if (!GetDstAddr(pkts[i], addrs[num_msgs]))
+      {
+        continue;
+      }
+
+      iovs[num_msgs].iov_base =
+        const_cast<uint8_t*>(pkts[i]->GetBuffer());
+      iovs[num_msgs].iov_len  = pkts[i]->GetLengthInBytes();
+
+      memset(&msgs[num_msgs], 0, sizeof(msgs[num_msgs]));
+      msgs[num_msgs].msg_hdr.msg_name    = &addrs[num_msgs];
+      msgs[num_msgs].msg_hdr.msg_namelen = sizeof(addrs[num_msgs]);
+      msgs[num_msgs].msg_hdr.msg_iov     = &iovs[num_msgs];
+      msgs[num_msgs].msg_hdr.msg_iovlen  = 1;
+      ++num_msgs;
+    }
+
+    // Transmit the messages in order. sendmmsg() stops at the first message
+    // that cannot be sent. That message is dropped and the transmission
+    // resumes with the message after it.
+    unsigned int  done = 0;
+
+    while (done < num_msgs)
+    {
+      int  rv = sendmmsg(xmt_sock_, &msgs[done], num_msgs - done, 0);
+
+      if (rv <= 0)
+      {
+        LogE(kClassName, __func__, "sendmmsg error: %s, expected=%zu\n",
+             strerror(errno), iovs[done].iov_len);
+        ++done;
+        continue;
+      }
+
+      for (unsigned int j = done; j < (done + rv); ++j)
+      {
+        if (msgs[j].msg_len != iovs[j].iov_len)
+        {
+          LogE(kClassName, __func__, "sendmmsg short write: wrote=%u, "
+               "expected=%zu\n", msgs[j].msg_len, iovs[j].iov_len);
+          continue;
+        }
+
+        ++num_sent;
+      }
+
+      done += rv;
+    }
+  }
+
+  LogD(kClassName, __func__, "%zu of %zu packets written to edge "
+       "interface.\n", num_sent, num_pkts);
+
+  return num_sent;
+}
+
 //============================================================================
 void EdgeIf::AddFileDescriptors(int& max_fd, fd_set& read_fds) const
 {
@@ -352,6 +419,32 @@ void EdgeIf::CloseSockets()
   }
 }
 
+//============================================================================
+bool EdgeIf::GetDstAddr(const Packet* pkt, struct sockaddr_in& addr) const
+{
+  uint16_t  dport;
+  if (!pkt->GetDstPort(dport))
+  {
+    LogE(kClassName, __func__, "Error getting destination port.\n");
+    return false;
+  }
+
+  uint32_t  daddr;
+  if (!pkt->GetIpDstAddr(daddr))
+  {
+    LogE(kClassName, __func__, "Error getting packet's destination "
+         "address.\n");
+    return false;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = dport;
+  addr.sin_addr.s_addr = daddr;
+
+  return true;
+}
+
 //============================================================================
 void EdgeIf::ExeSysCmd(const string& cmd) const
 {
@@ -0,0 +1,148 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "edge_if_send_batch.h"
+
+#include "log.h"
+#include "packet_pool.h"
+#include "virtual_edge_if.h"
+
+#include <inttypes.h>
+
+using ::iron::EdgeIfSendBatch;
+using ::iron::Packet;
+using ::iron::PacketPool;
+using ::iron::VirtualEdgeIf;
+
+namespace
+{
+  /// Class name for logging.
+  const char*  kClassName = "EdgeIfSendBatch";
+
+  /// The number of packets that fills a batch.
+  const size_t  kMaxBatchSize = 64;
+}
+
+//============================================================================
+EdgeIfSendBatch::EdgeIfSendBatch(VirtualEdgeIf& edge_if,
+                                 PacketPool& packet_pool)
+    : edge_if_(edge_if),
+      packet_pool_(packet_pool),
+      pkts_(),
+      num_batches_(0),
+      num_pkts_(0),
+      num_send_errors_(0),
+      max_batch_size_(0)
+{
+  pkts_.reserve(kMaxBatchSize);
+}
+
+//============================================================================
+EdgeIfSendBatch::~EdgeIfSendBatch()
+{
+  if (num_batches_ > 0)
+  {
+    LogI(kClassName, __func__, "Sent %" PRIu64 " packets in %" PRIu64
+         " batches, average %.2f, max %zu, %" PRIu64 " send errors.\n",
+         num_pkts_, num_batches_,
+         static_cast<double>(num_pkts_) / static_cast<double>(num_batches_),
+         max_batch_size_, num_send_errors_);
+  }
+
+  for (size_t i = 0; i < pkts_.size(); ++i)
+  {
+    packet_pool_.Recycle(pkts_[i]);
+  }
+  pkts_.clear();
+}
+
+//============================================================================
+ssize_t EdgeIfSendBatch::Send(Packet* pkt)
+{
+  if (pkt == NULL)
+  {
+    LogE(kClassName, __func__, "Error: pkt was NULL.\n");
+    return -1;
+  }
+
+  ssize_t  length = pkt->GetLengthInBytes();
+
+  pkts_.push_back(pkt);
+
+  if (pkts_.size() >= kMaxBatchSize)
+  {
+    Flush();
+  }
+
+  return length;
+}
+
+//============================================================================
+size_t EdgeIfSendBatch::Flush()
+{
+  size_t  num_pkts = pkts_.size();
+
+  if (num_pkts == 0)
+  {
+    return 0;
+  }
+
+  size_t  num_sent = edge_if_.SendBatch(&pkts_[0], num_pkts);
+
+  ++num_batches_;
+  num_pkts_        += num_pkts;
+  num_send_errors_ += (num_pkts - num_sent);
+
+  if (num_pkts > max_batch_size_)
+  {
+    max_batch_size_ = num_pkts;
+  }
+
+  if (num_sent < num_pkts)
+  {
+    LogW(kClassName, __func__, "Sent %zu of %zu packets.\n", num_sent,
+         num_pkts);
+  }
+
+  for (size_t i = 0; i < num_pkts; ++i)
+  {
+    packet_pool_.Recycle(pkts_[i]);
+  }
+  pkts_.clear();
+
+  return num_sent;
+}
@@ -58,6 +58,12 @@ namespace
 {
   /// Class name for logging.
   const char*  UNUSED(kClassName) = "Time";
+
+  /// Whether the simulated clock is in use.
+  bool         sim_clock_active   = false;
+
+  /// The simulated clock value, used when sim_clock_active is true.
+  timeval      sim_clock_now      = {0, 0};
 }
 
 Time::Time(const timespec& t_spec)
@@ -209,6 +215,11 @@ string Time::ToString() const
 //============================================================================
 time_t Time::GetNowInSec()
 {
+  if (sim_clock_active)
+  {
+    return sim_clock_now.tv_sec;
+  }
+
   timespec  t_spec;
 
   if (clock_gettime(CLOCK_MONOTONIC, &t_spec) != 0)
@@ -224,6 +235,12 @@ time_t Time::GetNowInSec()
 //============================================================================
 int64_t Time::GetNowInUsec()
 {
+  if (sim_clock_active)
+  {
+    return ((static_cast<int64_t>(sim_clock_now.tv_sec) * 1000000) +
+            static_cast<int64_t>(sim_clock_now.tv_usec));
+  }
+
   timespec  t_spec;
 
   if (clock_gettime(CLOCK_MONOTONIC, &t_spec) != 0)
@@ -238,6 +255,19 @@ int64_t Time::GetNowInUsec()
   return tmp.GetTimeInUsec();
 }
 
+//============================================================================
+void Time::SetSimulatedNow(const Time& now)
+{
+  sim_clock_active = true;
+  sim_clock_now    = now.t_val_;
+}
+
+//============================================================================
+void Time::ClearSimulatedNow()
+{
+  sim_clock_active = false;
+}
+
 //============================================================================
 void Time::Zero()
 {
@@ -248,6 +278,12 @@ void Time::Zero()
 //============================================================================
 bool Time::GetNow()
 {
+  if (sim_clock_active)
+  {
+    t_val_ = sim_clock_now;
+    return true;
+  }
+
   timespec  t_spec;
 
   if (clock_gettime(CLOCK_MONOTONIC, &t_spec) != 0)
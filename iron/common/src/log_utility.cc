@@ -40,6 +40,7 @@
 #include "config_info.h"
 #include "k_val.h"
 #include "log.h"
+#include "log_utility_batch.h"
 #include "queue_depths.h"
 #include "string_utils.h"
 #include "unused.h"
@@ -56,6 +57,7 @@ using ::iron::ConfigInfo;
 using ::iron::KVal;
 using ::iron::Log;
 using ::iron::LogUtility;
+using ::iron::LogUtilityBatch;
 using ::iron::ProxyState;
 using ::iron::StringUtils;
 using ::iron::QueueDepths;
@@ -75,16 +77,30 @@ namespace
 
 //============================================================================
 LogUtility::LogUtility(QueueDepths& queue_depths, BinIndex bin_idx,
-                       KVal& k_val, uint32_t flow_id)
+                       KVal& k_val, uint32_t flow_id,
+                       LogUtilityBatch* batch)
     : UtilityFn(queue_depths, bin_idx, flow_id),
       m_val_(0.0),
       k_val_(k_val),
-      a_val_(0.0)
+      a_val_(0.0),
+      batch_(batch),
+      batch_slot_(0),
+      in_batch_(false)
 {
   LogD(kClassName, __func__, "fid: %" PRIu32 ", LOG utility created for bin "
        "idx %" PRIBinIndex ".\n", flow_id_, bin_idx);
 }
 
+//============================================================================
+LogUtility::~LogUtility()
+{
+  if (in_batch_)
+  {
+    batch_->Remove(batch_slot_);
+    in_batch_ = false;
+  }
+}
+
 //============================================================================
 bool LogUtility::Initialize(const ConfigInfo& ci)
 {
@@ -114,6 +130,17 @@ bool LogUtility::Initialize(const ConfigInfo& ci)
   LogC(kClassName, __func__, "p                    : %.03f\n", p_val_);
   LogC(kClassName, __func__, "LOG configuration complete\n");
 
+  if (batch_ != NULL)
+  {
+    if (in_batch_)
+    {
+      batch_->Remove(batch_slot_);
+    }
+
+    batch_slot_ = batch_->Add(bin_idx_, a_val_, m_val_, p_val_);
+    in_batch_   = true;
+  }
+
   LogI(kClassName, __func__, "Log initialized.\n");
 
   return true;
@@ -128,7 +155,20 @@ double LogUtility::GetSendRate()
   }
 
   double  send_rate         = 0.0;
-  double  queue_depth_bits  = queue_depths_.GetBinDepthByIdx(bin_idx_)*8;
+  double  queue_depth_bits  = 0.0;
+
+  if (in_batch_ && batch_->IsEvaluated(batch_slot_))
+  {
+    send_rate        = batch_->send_rate(batch_slot_);
+    queue_depth_bits = batch_->queue_depth_bits(batch_slot_);
+
+    LogA(kClassName, __func__, "f_id: %" PRIu32 ", queue: %.03fb, rate: "
+         "%.03fbps (batch).\n", flow_id_, queue_depth_bits, send_rate);
+
+    return send_rate;
+  }
+
+  queue_depth_bits = queue_depths_.GetBinDepthByIdx(bin_idx_)*8;
 
   if (queue_depth_bits >= k_val_.GetValue() * p_val_ * a_val_)
   {
@@ -152,6 +192,17 @@ double LogUtility::GetSendRate()
   return send_rate;
 }
 
+//============================================================================
+void LogUtility::set_priority(double priority)
+{
+  p_val_ = priority;
+
+  if (in_batch_)
+  {
+    batch_->SetPriority(batch_slot_, priority);
+  }
+}
+
 //==========================================================================
 double LogUtility::ComputeUtility(double send_rate)
 {
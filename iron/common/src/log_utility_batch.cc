@@ -0,0 +1,204 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "log_utility_batch.h"
+
+#include "k_val.h"
+#include "log.h"
+#include "queue_depths.h"
+#include "unused.h"
+
+using ::iron::KVal;
+using ::iron::LogUtilityBatch;
+using ::iron::QueueDepths;
+
+namespace
+{
+  /// Class name used for logging.
+  const char*  UNUSED(kClassName) = "LogUtilityBatch";
+}
+
+//============================================================================
+LogUtilityBatch::LogUtilityBatch(QueueDepths& queue_depths, KVal& k_val)
+    : queue_depths_(queue_depths),
+      k_val_(k_val),
+      bin_idx_(),
+      a_val_(),
+      m_val_(),
+      p_val_(),
+      qd_bits_(),
+      rate_(),
+      in_use_(),
+      evaluated_(),
+      free_slots_(),
+      num_flows_(0),
+      bin_depth_bits_(),
+      bin_epoch_(),
+      epoch_(0)
+{
+}
+
+//============================================================================
+LogUtilityBatch::~LogUtilityBatch()
+{
+  if (num_flows_ > 0)
+  {
+    LogW(kClassName, __func__, "Destroying batch with %zu flows still "
+         "registered.\n", num_flows_);
+  }
+}
+
+//============================================================================
+size_t LogUtilityBatch::Add(BinIndex bin_idx, double a_val, double m_val,
+                            double p_val)
+{
+  size_t  slot = rate_.size();
+
+  if (!free_slots_.empty())
+  {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  }
+  else
+  {
+    bin_idx_.push_back(0);
+    a_val_.push_back(0.0);
+    m_val_.push_back(0.0);
+    p_val_.push_back(0.0);
+    qd_bits_.push_back(0.0);
+    rate_.push_back(0.0);
+    in_use_.push_back(0);
+    evaluated_.push_back(0);
+  }
+
+  if (bin_idx >= bin_epoch_.size())
+  {
+    bin_depth_bits_.resize(bin_idx + 1, 0.0);
+    bin_epoch_.resize(bin_idx + 1, 0);
+  }
+
+  bin_idx_[slot]   = bin_idx;
+  a_val_[slot]     = a_val;
+  m_val_[slot]     = m_val;
+  p_val_[slot]     = p_val;
+  qd_bits_[slot]   = 0.0;
+  rate_[slot]      = 0.0;
+  in_use_[slot]    = 1;
+  evaluated_[slot] = 0;
+  ++num_flows_;
+
+  LogD(kClassName, __func__, "Added flow for bin idx %" PRIBinIndex " in "
+       "slot %zu, %zu flows.\n", bin_idx, slot, num_flows_);
+
+  return slot;
+}
+
+//============================================================================
+void LogUtilityBatch::Remove(size_t slot)
+{
+  if ((slot >= in_use_.size()) || (in_use_[slot] == 0))
+  {
+    LogW(kClassName, __func__, "Slot %zu is not in use.\n", slot);
+    return;
+  }
+
+  in_use_[slot]    = 0;
+  evaluated_[slot] = 0;
+  rate_[slot]      = 0.0;
+  free_slots_.push_back(slot);
+  --num_flows_;
+}
+
+//============================================================================
+void LogUtilityBatch::SetPriority(size_t slot, double p_val)
+{
+  p_val_[slot]     = p_val;
+  evaluated_[slot] = 0;
+}
+
+//============================================================================
+void LogUtilityBatch::Evaluate()
+{
+  if (num_flows_ == 0)
+  {
+    return;
+  }
+
+  // Start a new evaluation. The bin epochs are reset on the (very rare)
+  // wrap of the evaluation number so that a stale depth is never reused.
+  if (++epoch_ == 0)
+  {
+    bin_epoch_.assign(bin_epoch_.size(), 0);
+    epoch_ = 1;
+  }
+
+  double        k_val = static_cast<double>(k_val_.GetValue());
+  const size_t  n     = rate_.size();
+
+  // Gather the queue depth of each flow's bin, reading each bin once.
+  for (size_t i = 0; i < n; ++i)
+  {
+    BinIndex  bin_idx = bin_idx_[i];
+
+    if (bin_epoch_[bin_idx] != epoch_)
+    {
+      bin_depth_bits_[bin_idx] =
+        static_cast<double>(queue_depths_.GetBinDepthByIdx(bin_idx)) * 8;
+      bin_epoch_[bin_idx]      = epoch_;
+    }
+
+    qd_bits_[i] = bin_depth_bits_[bin_idx];
+  }
+
+  // Compute the send rates. This mirrors LogUtility::GetSendRate(), written
+  // without branches on the flow so that the loop runs straight through the
+  // arrays. Unused slots are computed too and are simply never read.
+  for (size_t i = 0; i < n; ++i)
+  {
+    double  qd_bits   = qd_bits_[i];
+    double  a_val     = a_val_[i];
+    double  m_val     = m_val_[i];
+    double  threshold = k_val * p_val_[i] * a_val;
+    double  denom     = (qd_bits == 0.0) ? 1.0 : (a_val * qd_bits);
+    double  rate      = (a_val * k_val * p_val_[i] - qd_bits) / denom;
+
+    rate          = (rate < m_val) ? rate : m_val;
+    rate          = (qd_bits == 0.0) ? m_val : rate;
+    rate_[i]      = (qd_bits >= threshold) ? 0.0 : rate;
+    evaluated_[i] = in_use_[i];
+  }
+}
@@ -171,6 +171,22 @@ PacketQueue::QueueWalkState PacketQueue::GetIterator(Packet* search_pkt)
   return qws;
 }
 
+//============================================================================
+bool PacketQueue::IsAtIterator(const QueueWalkState& qws, Packet* pkt) const
+{
+  if (qws.is_ordered_ != is_ordered_)
+  {
+    return false;
+  }
+
+  if (!is_ordered_)
+  {
+    return queue_.IsAt(qws.ws_, pkt);
+  }
+
+  return ordered_queue_.IsAt(qws.ordered_ws_, pkt);
+}
+
 //============================================================================
 Packet* PacketQueue::Peek()
 {
@@ -363,6 +379,14 @@ iron::Packet* iron::PacketQueue::DequeueAtIterator(QueueWalkState& qws)
 
 //============================================================================
 bool PacketQueue::Enqueue(Packet* pkt)
+{
+  QueueWalkState  qws(is_ordered_);
+
+  return Enqueue(pkt, qws);
+}
+
+//============================================================================
+bool PacketQueue::Enqueue(Packet* pkt, QueueWalkState& qws)
 {
   if (pkt == NULL)
   {
@@ -382,13 +406,15 @@ bool PacketQueue::Enqueue(Packet* pkt)
   }
 
   // Add the packet to the back of the queue.
+  qws.is_ordered_ = is_ordered_;
+
   if (is_ordered_)
   {
-    ordered_queue_.Push(pkt, pkt->GetOrderTime());
+    ordered_queue_.Push(pkt, pkt->GetOrderTime(), qws.ordered_ws_);
   }
   else
   {
-    queue_.Push(pkt);
+    queue_.Push(pkt, qws.ws_);
   }
 
   // And increment the queued item count and queue size.
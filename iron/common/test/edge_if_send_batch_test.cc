@@ -0,0 +1,270 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "edge_if_send_batch.h"
+
+#include "log.h"
+#include "packet.h"
+#include "packet_pool_heap.h"
+#include "virtual_edge_if.h"
+
+#include <vector>
+
+using ::iron::EdgeIfSendBatch;
+using ::iron::Log;
+using ::iron::Packet;
+using ::iron::PacketPoolHeap;
+using ::iron::VirtualEdgeIf;
+using ::std::vector;
+
+namespace
+{
+  /// An edge interface that records the lengths of the packets it sends.
+  /// Every packet whose length is a multiple of fail_mod fails to send.
+  class RecordingEdgeIf : public VirtualEdgeIf
+  {
+  public:
+
+    RecordingEdgeIf(bool batch, size_t fail_mod)
+        : batch_(batch), fail_mod_(fail_mod), num_batch_calls_(0),
+          sent_lens_()
+    { }
+
+    virtual ~RecordingEdgeIf() { }
+
+    bool Open() { return true; }
+
+    bool IsOpen() const { return true; }
+
+    void Close() { }
+
+    ssize_t Recv(Packet* pkt, const size_t offset = 0) { return -1; }
+
+    ssize_t Send(const Packet* pkt)
+    {
+      size_t  len = pkt->GetLengthInBytes();
+
+      if ((fail_mod_ > 0) && ((len % fail_mod_) == 0))
+      {
+        return -1;
+      }
+
+      sent_lens_.push_back(len);
+      return len;
+    }
+
+    size_t SendBatch(const Packet* const* pkts, size_t num_pkts)
+    {
+      ++num_batch_calls_;
+
+      if (!batch_)
+      {
+        return VirtualEdgeIf::SendBatch(pkts, num_pkts);
+      }
+
+      for (size_t i = 0; i < num_pkts; ++i)
+      {
+        sent_lens_.push_back(pkts[i]->GetLengthInBytes());
+      }
+
+      return num_pkts;
+    }
+
+    void AddFileDescriptors(int& max_fd, fd_set& read_fds) const { }
+
+    bool InSet(fd_set* fds) const { return false; }
+
+    bool            batch_;
+    size_t          fail_mod_;
+    size_t          num_batch_calls_;
+    vector<size_t>  sent_lens_;
+  };
+}
+
+//============================================================================
+class EdgeIfSendBatchTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(EdgeIfSendBatchTest);
+
+  CPPUNIT_TEST(TestFlushInOrder);
+  CPPUNIT_TEST(TestFullBatch);
+  CPPUNIT_TEST(TestSendErrors);
+  CPPUNIT_TEST(TestDestructorRecycles);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  PacketPoolHeap*  pkt_pool_;
+
+  //==========================================================================
+  Packet* GetPkt(size_t len)
+  {
+    Packet*  pkt = pkt_pool_->Get();
+    CPPUNIT_ASSERT(pkt);
+    CPPUNIT_ASSERT(pkt->SetLengthInBytes(len));
+    return pkt;
+  }
+
+public:
+
+  //==========================================================================
+  void setUp()
+  {
+    Log::SetDefaultLevel("F");
+
+    pkt_pool_ = new PacketPoolHeap();
+    CPPUNIT_ASSERT(pkt_pool_->Create(128) == true);
+  }
+
+  //==========================================================================
+  void tearDown()
+  {
+    delete pkt_pool_;
+    pkt_pool_ = NULL;
+
+    Log::SetDefaultLevel("FEWI");
+  }
+
+  //==========================================================================
+  void TestFlushInOrder()
+  {
+    RecordingEdgeIf  edge_if(true, 0);
+    EdgeIfSendBatch  batch(edge_if, *pkt_pool_);
+    size_t           pool_size = pkt_pool_->GetSize();
+
+    // Nothing is sent for an empty batch.
+    CPPUNIT_ASSERT(batch.Flush() == 0);
+    CPPUNIT_ASSERT(edge_if.num_batch_calls_ == 0);
+
+    CPPUNIT_ASSERT(batch.Send(NULL) == -1);
+    CPPUNIT_ASSERT(batch.Send(GetPkt(100)) == 100);
+    CPPUNIT_ASSERT(batch.Send(GetPkt(101)) == 101);
+    CPPUNIT_ASSERT(batch.Send(GetPkt(102)) == 102);
+    CPPUNIT_ASSERT(batch.num_queued() == 3);
+    CPPUNIT_ASSERT(edge_if.sent_lens_.empty());
+
+    // The packets are sent in one call, in order, and are recycled.
+    CPPUNIT_ASSERT(batch.Flush() == 3);
+    CPPUNIT_ASSERT(edge_if.num_batch_calls_ == 1);
+    CPPUNIT_ASSERT(edge_if.sent_lens_.size() == 3);
+    CPPUNIT_ASSERT(edge_if.sent_lens_[0] == 100);
+    CPPUNIT_ASSERT(edge_if.sent_lens_[1] == 101);
+    CPPUNIT_ASSERT(edge_if.sent_lens_[2] == 102);
+    CPPUNIT_ASSERT(batch.num_queued() == 0);
+    CPPUNIT_ASSERT(pkt_pool_->GetSize() == pool_size);
+
+    CPPUNIT_ASSERT(batch.Send(GetPkt(103)) == 103);
+    CPPUNIT_ASSERT(batch.Flush() == 1);
+
+    CPPUNIT_ASSERT(batch.num_batches() == 2);
+    CPPUNIT_ASSERT(batch.num_pkts() == 4);
+    CPPUNIT_ASSERT(batch.max_batch_size() == 3);
+  }
+
+  //==========================================================================
+  void TestFullBatch()
+  {
+    RecordingEdgeIf  edge_if(true, 0);
+    EdgeIfSendBatch  batch(edge_if, *pkt_pool_);
+
+    // A full batch is sent without waiting for a flush.
+    size_t  i = 0;
+    while (edge_if.num_batch_calls_ == 0)
+    {
+      CPPUNIT_ASSERT(i < 128);
+      batch.Send(GetPkt(100 + i));
+      ++i;
+    }
+
+    CPPUNIT_ASSERT(batch.num_queued() == 0);
+    CPPUNIT_ASSERT(edge_if.sent_lens_.size() == i);
+    CPPUNIT_ASSERT(batch.max_batch_size() == i);
+
+    for (size_t j = 0; j < i; ++j)
+    {
+      CPPUNIT_ASSERT(edge_if.sent_lens_[j] == (100 + j));
+    }
+  }
+
+  //==========================================================================
+  void TestSendErrors()
+  {
+    // Use the default, one at a time, SendBatch() with every third packet
+    // failing.
+    RecordingEdgeIf  edge_if(false, 3);
+    EdgeIfSendBatch  batch(edge_if, *pkt_pool_);
+    size_t           pool_size = pkt_pool_->GetSize();
+
+    for (size_t len = 100; len < 106; ++len)
+    {
+      batch.Send(GetPkt(len));
+    }
+
+    // The failed packets are dropped and the others are still sent, in
+    // order.
+    CPPUNIT_ASSERT(batch.Flush() == 4);
+    CPPUNIT_ASSERT(edge_if.sent_lens_.size() == 4);
+    CPPUNIT_ASSERT(edge_if.sent_lens_[0] == 100);
+    CPPUNIT_ASSERT(edge_if.sent_lens_[1] == 101);
+    CPPUNIT_ASSERT(edge_if.sent_lens_[2] == 103);
+    CPPUNIT_ASSERT(edge_if.sent_lens_[3] == 104);
+    CPPUNIT_ASSERT(batch.num_pkts() == 6);
+    CPPUNIT_ASSERT(pkt_pool_->GetSize() == pool_size);
+  }
+
+  //==========================================================================
+  void TestDestructorRecycles()
+  {
+    RecordingEdgeIf  edge_if(true, 0);
+    size_t           pool_size = pkt_pool_->GetSize();
+
+    {
+      EdgeIfSendBatch  batch(edge_if, *pkt_pool_);
+      batch.Send(GetPkt(100));
+      batch.Send(GetPkt(101));
+      CPPUNIT_ASSERT(pkt_pool_->GetSize() == (pool_size - 2));
+    }
+
+    CPPUNIT_ASSERT(edge_if.sent_lens_.empty());
+    CPPUNIT_ASSERT(pkt_pool_->GetSize() == pool_size);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(EdgeIfSendBatchTest);
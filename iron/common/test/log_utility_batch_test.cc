@@ -0,0 +1,269 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "log_utility_batch.h"
+
+#include "bin_map.h"
+#include "config_info.h"
+#include "k_val.h"
+#include "log.h"
+#include "log_utility.h"
+#include "queue_depths.h"
+
+#include <cstring>
+
+using ::iron::BinIndex;
+using ::iron::BinMap;
+using ::iron::ConfigInfo;
+using ::iron::KVal;
+using ::iron::Log;
+using ::iron::LogUtility;
+using ::iron::LogUtilityBatch;
+using ::iron::QueueDepths;
+
+//============================================================================
+class LogUtilityBatchTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(LogUtilityBatchTest);
+
+  CPPUNIT_TEST(TestMatchesScalar);
+  CPPUNIT_TEST(TestAddRemove);
+  CPPUNIT_TEST(TestView);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  char*    bin_map_mem_;
+  BinMap*  bin_map_;
+
+  //==========================================================================
+  void InitBinMap(BinMap* bin_map)
+  {
+    ConfigInfo  ci;
+    ci.Add("BinMap.BinIds", "2,5,6");
+    ci.Add("BinMap.BinId.2.HostMasks", "192.168.2.0/24,10.2.2.2");
+    ci.Add("BinMap.BinId.5.HostMasks", "192.168.5.0/24,10.5.5.5");
+    ci.Add("BinMap.BinId.6.HostMasks", "192.168.6.0/24,10.6.6.6");
+    CPPUNIT_ASSERT(bin_map->Initialize(ci) == true);
+  }
+
+  //==========================================================================
+  void InitLogUtility(LogUtility& log_utility, const char* a, const char* m,
+                      const char* p)
+  {
+    ConfigInfo  ci;
+    ci.Add("a", a);
+    ci.Add("m", m);
+    ci.Add("p", p);
+    CPPUNIT_ASSERT(log_utility.Initialize(ci));
+  }
+
+public:
+
+  //==========================================================================
+  void setUp()
+  {
+    bin_map_mem_ = new char[sizeof(BinMap)];
+    bin_map_     = reinterpret_cast<BinMap*>(bin_map_mem_);
+    memset(bin_map_mem_, 0, sizeof(BinMap));
+
+    Log::SetDefaultLevel("F");
+
+    InitBinMap(bin_map_);
+  }
+
+  //==========================================================================
+  void tearDown()
+  {
+    delete [] bin_map_mem_;
+    bin_map_mem_ = NULL;
+    bin_map_     = NULL;
+
+    Log::SetDefaultLevel("FEWI");
+  }
+
+  //==========================================================================
+  void TestMatchesScalar()
+  {
+    QueueDepths      qd(*bin_map_);
+    KVal             k_val;
+    LogUtilityBatch  batch(qd, k_val);
+
+    BinIndex  bidx_2 = bin_map_->GetPhyBinIndex(2);
+    BinIndex  bidx_5 = bin_map_->GetPhyBinIndex(5);
+    BinIndex  bidx_6 = bin_map_->GetPhyBinIndex(6);
+
+    // Scalar utility functions spanning the branches of the send rate
+    // computation: an empty bin, a bin below the threshold, and a bin above
+    // the threshold for the low priority flows.
+    LogUtility  scalar_a(qd, bidx_2, k_val, 1);
+    LogUtility  scalar_b(qd, bidx_5, k_val, 2);
+    LogUtility  scalar_c(qd, bidx_5, k_val, 3);
+    LogUtility  scalar_d(qd, bidx_6, k_val, 4);
+    InitLogUtility(scalar_a, "10", "250000", "5");
+    InitLogUtility(scalar_b, "20", "10000000", "1");
+    InitLogUtility(scalar_c, "0.5", "10000", "2");
+    InitLogUtility(scalar_d, "10", "250000", "0.000001");
+
+    size_t  slot_a = batch.Add(bidx_2, 10, 250000, 5);
+    size_t  slot_b = batch.Add(bidx_5, 20, 10000000, 1);
+    size_t  slot_c = batch.Add(bidx_5, 0.5, 10000, 2);
+    size_t  slot_d = batch.Add(bidx_6, 10, 250000, 0.000001);
+    CPPUNIT_ASSERT(batch.num_flows() == 4);
+    CPPUNIT_ASSERT(!batch.IsEvaluated(slot_a));
+
+    uint32_t  depths[] = {0, 1500, 1000000, 100000000};
+
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); ++i)
+    {
+      qd.SetBinDepthByIdx(bidx_2, 0);
+      qd.SetBinDepthByIdx(bidx_5, depths[i]);
+      qd.SetBinDepthByIdx(bidx_6, depths[i] / 2);
+
+      batch.Evaluate();
+
+      CPPUNIT_ASSERT(batch.IsEvaluated(slot_d));
+      CPPUNIT_ASSERT(batch.send_rate(slot_a) == scalar_a.GetSendRate());
+      CPPUNIT_ASSERT(batch.send_rate(slot_b) == scalar_b.GetSendRate());
+      CPPUNIT_ASSERT(batch.send_rate(slot_c) == scalar_c.GetSendRate());
+      CPPUNIT_ASSERT(batch.send_rate(slot_d) == scalar_d.GetSendRate());
+      CPPUNIT_ASSERT(batch.queue_depth_bits(slot_b) ==
+                     static_cast<double>(depths[i]) * 8);
+    }
+
+    // An empty bin admits at the max rate.
+    CPPUNIT_ASSERT(batch.send_rate(slot_a) == 250000);
+
+    // A priority change invalidates the flow until the next evaluation.
+    batch.SetPriority(slot_b, 100);
+    scalar_b.set_priority(100);
+    CPPUNIT_ASSERT(!batch.IsEvaluated(slot_b));
+    CPPUNIT_ASSERT(batch.IsEvaluated(slot_c));
+    batch.Evaluate();
+    CPPUNIT_ASSERT(batch.send_rate(slot_b) == scalar_b.GetSendRate());
+
+    batch.Remove(slot_a);
+    batch.Remove(slot_b);
+    batch.Remove(slot_c);
+    batch.Remove(slot_d);
+    CPPUNIT_ASSERT(batch.num_flows() == 0);
+  }
+
+  //==========================================================================
+  void TestAddRemove()
+  {
+    QueueDepths      qd(*bin_map_);
+    KVal             k_val;
+    LogUtilityBatch  batch(qd, k_val);
+
+    BinIndex  bidx_2 = bin_map_->GetPhyBinIndex(2);
+
+    size_t  slot_a = batch.Add(bidx_2, 10, 1000, 1);
+    size_t  slot_b = batch.Add(bidx_2, 10, 2000, 1);
+    CPPUNIT_ASSERT(slot_a != slot_b);
+
+    batch.Evaluate();
+    CPPUNIT_ASSERT(batch.send_rate(slot_a) == 1000);
+    CPPUNIT_ASSERT(batch.send_rate(slot_b) == 2000);
+
+    // A released slot is reused, and is not evaluated until the next pass.
+    batch.Remove(slot_a);
+    CPPUNIT_ASSERT(!batch.IsEvaluated(slot_a));
+    CPPUNIT_ASSERT(batch.num_flows() == 1);
+
+    size_t  slot_c = batch.Add(bidx_2, 10, 3000, 1);
+    CPPUNIT_ASSERT(slot_c == slot_a);
+    CPPUNIT_ASSERT(!batch.IsEvaluated(slot_c));
+
+    batch.Evaluate();
+    CPPUNIT_ASSERT(batch.send_rate(slot_c) == 3000);
+    CPPUNIT_ASSERT(batch.send_rate(slot_b) == 2000);
+
+    batch.Remove(slot_b);
+    batch.Remove(slot_c);
+    CPPUNIT_ASSERT(batch.num_flows() == 0);
+  }
+
+  //==========================================================================
+  void TestView()
+  {
+    QueueDepths      qd(*bin_map_);
+    KVal             k_val;
+    LogUtilityBatch  batch(qd, k_val);
+
+    BinIndex  bidx_5 = bin_map_->GetPhyBinIndex(5);
+
+    {
+      LogUtility  view(qd, bidx_5, k_val, 1, &batch);
+      LogUtility  scalar(qd, bidx_5, k_val, 2);
+      InitLogUtility(view, "20", "10000000", "1");
+      InitLogUtility(scalar, "20", "10000000", "1");
+      CPPUNIT_ASSERT(batch.num_flows() == 1);
+
+      // Before the first evaluation, the view computes its own rate.
+      qd.SetBinDepthByIdx(bidx_5, 1000000);
+      double  rate = scalar.GetSendRate();
+      CPPUNIT_ASSERT(view.GetSendRate() == rate);
+
+      // After an evaluation, the view returns the batch's rate, which is not
+      // affected by queue depth changes until the next evaluation.
+      batch.Evaluate();
+      qd.SetBinDepthByIdx(bidx_5, 2000000);
+      CPPUNIT_ASSERT(view.GetSendRate() == rate);
+      batch.Evaluate();
+      CPPUNIT_ASSERT(view.GetSendRate() == scalar.GetSendRate());
+
+      // A priority change through the view is pushed to the batch.
+      view.set_priority(10);
+      scalar.set_priority(10);
+      CPPUNIT_ASSERT(view.GetSendRate() == scalar.GetSendRate());
+      batch.Evaluate();
+      CPPUNIT_ASSERT(view.GetSendRate() == scalar.GetSendRate());
+
+      // A flow that is off does not send.
+      view.set_flow_state(iron::FLOW_OFF);
+      CPPUNIT_ASSERT(view.GetSendRate() == 0.0);
+    }
+
+    // The view leaves the batch when it is destroyed.
+    CPPUNIT_ASSERT(batch.num_flows() == 0);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LogUtilityBatchTest);
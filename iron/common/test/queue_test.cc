@@ -71,6 +71,7 @@ class QTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(TestDequeue);
   CPPUNIT_TEST(TestDropPacketHEAD);
   CPPUNIT_TEST(TestEnqueue);
+  CPPUNIT_TEST(TestEnqueueIterator);
   CPPUNIT_TEST(TestWalk);
   CPPUNIT_TEST(TestOrderedWalk);
   CPPUNIT_TEST(TestPurge);
@@ -237,6 +238,61 @@ public:
     CPPUNIT_ASSERT(oq_->GetSize() == 350);
   }
 
+  //==========================================================================
+  void TestEnqueueIterator()
+  {
+    iron::PacketQueue::QueueWalkState  qws;
+
+    Packet* pkt3 = pkt_pool_->Get();
+    CPPUNIT_ASSERT(pkt3);
+    pkt3->SetLengthInBytes(200);
+    CPPUNIT_ASSERT(xq_->Enqueue(pkt3, qws));
+
+    iron::PacketQueue::QueueWalkState  saved_qws = qws;
+
+    CPPUNIT_ASSERT(xq_->IsAtIterator(qws, pkt3));
+    CPPUNIT_ASSERT(xq_->PeekAtIterator(qws) == pkt3);
+
+    // The iterator survives the removal of other packets.
+    Packet* pkt = xq_->Dequeue();
+    CPPUNIT_ASSERT(pkt);
+    CPPUNIT_ASSERT(!xq_->IsAtIterator(qws, pkt));
+    pkt_pool_->Recycle(pkt);
+    CPPUNIT_ASSERT(xq_->IsAtIterator(qws, pkt3));
+
+    CPPUNIT_ASSERT(xq_->DequeueAtIterator(qws) == pkt3);
+    CPPUNIT_ASSERT(xq_->GetCount() == 1);
+    CPPUNIT_ASSERT(!xq_->IsAtIterator(saved_qws, pkt3));
+    pkt_pool_->Recycle(pkt3);
+
+    // A dropped packet is no longer found at its iterator.
+    Packet* pkt4 = pkt_pool_->Get();
+    CPPUNIT_ASSERT(pkt4);
+    pkt4->SetLengthInBytes(10);
+    CPPUNIT_ASSERT(xq_->Enqueue(pkt4, qws));
+    CPPUNIT_ASSERT(xq_->IsAtIterator(qws, pkt4));
+    xq_->Purge();
+    CPPUNIT_ASSERT(!xq_->IsAtIterator(qws, pkt4));
+
+    iron::PacketQueue::QueueWalkState  ordered_qws(true);
+
+    Packet* pkt30 = pkt_pool_->Get();
+    CPPUNIT_ASSERT(pkt30);
+    pkt30->InitIpPacket();
+    pkt30->SetIpDscp(46);
+    pkt30->SetLengthInBytes(200);
+    CPPUNIT_ASSERT(oq_->Enqueue(pkt30, ordered_qws));
+
+    saved_qws = ordered_qws;
+
+    CPPUNIT_ASSERT(oq_->IsAtIterator(ordered_qws, pkt30));
+    CPPUNIT_ASSERT(!xq_->IsAtIterator(ordered_qws, pkt30));
+    CPPUNIT_ASSERT(oq_->DequeueAtIterator(ordered_qws) == pkt30);
+    CPPUNIT_ASSERT(oq_->GetCount() == 2);
+    CPPUNIT_ASSERT(!oq_->IsAtIterator(saved_qws, pkt30));
+    pkt_pool_->Recycle(pkt30);
+  }
+
   //==========================================================================
   void TestWalk()
   {
@@ -68,6 +68,7 @@ class TimeTest : public CppUnit::TestFixture
   CPPUNIT_TEST(TestMonotonic);
   CPPUNIT_TEST(TestOperators);
   CPPUNIT_TEST(TestGetTimeInFormat);
+  CPPUNIT_TEST(TestSimulatedNow);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -379,6 +380,31 @@ public:
     CPPUNIT_ASSERT(t1.ToString() == s1);
     CPPUNIT_ASSERT(s2 == s3);
   }
+
+  //==========================================================================
+  void TestSimulatedNow()
+  {
+    Time  sim_now(1234, 567890);
+
+    Time::SetSimulatedNow(sim_now);
+
+    Time  t1;
+    CPPUNIT_ASSERT(t1.GetNow());
+    CPPUNIT_ASSERT(t1 == sim_now);
+    CPPUNIT_ASSERT(Time::Now() == sim_now);
+    CPPUNIT_ASSERT(Time::GetNowInSec() == 1234);
+    CPPUNIT_ASSERT(Time::GetNowInUsec() == 1234567890);
+
+    // Advancing the simulated clock is the only way time moves.
+    Time::SetSimulatedNow(sim_now + Time::FromMsec(5));
+    CPPUNIT_ASSERT(Time::Now() == Time(1234, 572890));
+
+    Time::ClearSimulatedNow();
+
+    Time  t2 = Time::Now();
+    Time  t3 = Time::Now();
+    CPPUNIT_ASSERT(t3 >= t2);
+  }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TimeTest);
@@ -73,6 +73,8 @@ namespace sliq
   /// The implementation of a SLIQ server application would consist of the
   /// following calls and callbacks:
   /// - Call InitializeSliqApp().
+  /// - Optionally call ConfigureCompactHeaders() to allow compact data and\n
+  ///   ACK headers on new connections.
   /// - Use a TCP-like connection procedure or a direct connection procedure\n
   ///   for creating a connection.  If using a TCP-like connection procedure:
   ///   - Call Listen() with a server address, storing the new listen server\n
@@ -85,6 +87,8 @@ namespace sliq
   ///   - Call SetupServerDataEndpoint() with both server and client\n
   ///     addresses to attempt to accept the connection to a SLIQ client\n
   ///     application, storing the new server data endpoint ID.
+  ///   - Optionally call AddPath() with another pair of server and client\n
+  ///     addresses to stripe the connection over additional interfaces.
   /// - The ProcessConnectionResult() callback occurs when the connection\n
   ///   attempt has either been successful or has failed.
   /// - Call AddStream() as necessary to create new streams.  The SLIQ\n
@@ -96,6 +100,12 @@ namespace sliq
   ///   friendliness/aggressiveness behavior of local transmissions.
   /// - Call ConfigureRttOutlierRejection() on the connection to change the\n
   ///   RTT outlier rejection setting.
+  /// - Call ConfigureEdtPacing() on the connection to enable earliest\n
+  ///   departure time send pacing.
+  /// - Call ConfigureAckFrequency() on the connection to enable adaptive\n
+  ///   ACK frequency.
+  /// - Call ConfigureAckCoalescing() on the connection to enable\n
+  ///   coalesced ACK processing.
   /// - Call ConfigureTransmitQueue() on any stream that requires the\n
   ///   transmit queue to be configured.
   /// - Call ConfigureRetransmissionLimit() on any semi-reliable ARQ stream\n
@@ -122,6 +132,8 @@ namespace sliq
   /// The implementation of a SLIQ client application would consist of the
   /// following calls and callbacks:
   /// - Call InitializeSliqApp().
+  /// - Optionally call ConfigureCompactHeaders() to allow compact data and\n
+  ///   ACK headers on new connections.
   /// - Use a TCP-like connection procedure or a direct connection procedure\n
   ///   for creating a connection.  If using a TCP-like connection procedure:
   ///   - Call Connect() with a server address to attempt to connect to a\n
@@ -130,6 +142,9 @@ namespace sliq
   ///   - Call SetupClientDataEndpoint() with both client and server\n
   ///     addresses to attempt to connect to the SLIQ server application,\n
   ///     storing the new client data endpoint ID.
+  ///   - Optionally call AddPath() with another pair of client and server\n
+  ///     addresses to stripe the connection over additional interfaces.\n
+  ///     One congestion control algorithm is needed for each path.
   /// - The ProcessConnectionResult() callback occurs when the connection\n
   ///   attempt has either been successful or has failed.
   /// - Call AddStream() as necessary to create new streams.  The SLIQ\n
@@ -141,6 +156,12 @@ namespace sliq
   ///   friendliness/aggressiveness behavior of local transmissions.
   /// - Call ConfigureRttOutlierRejection() on the connection to change the\n
   ///   RTT outlier rejection setting.
+  /// - Call ConfigureEdtPacing() on the connection to enable earliest\n
+  ///   departure time send pacing.
+  /// - Call ConfigureAckFrequency() on the connection to enable adaptive\n
+  ///   ACK frequency.
+  /// - Call ConfigureAckCoalescing() on the connection to enable\n
+  ///   coalesced ACK processing.
   /// - Call ConfigureTransmitQueue() on any stream that requires the\n
   ///   transmit queue to be configured.
   /// - Call ConfigureRetransmissionLimit() on any semi-reliable ARQ stream\n
@@ -315,6 +336,30 @@ namespace sliq
       const iron::Ipv4Endpoint& server_address,
       const iron::Ipv4Endpoint& client_address, EndptId& endpt_id);
 
+    /// \brief Add a network path to a direct connection.
+    ///
+    /// Called by both the SLIQ client and server after setting up a direct
+    /// connection, each with the mirror image addresses of the other.  The
+    /// connection then stripes its data packets over all of its paths,
+    /// favoring the path with the earliest expected delivery time, and moves
+    /// the traffic to the remaining paths when a path fails.  The paths share
+    /// the connection's streams, so packets lost on one path may be
+    /// retransmitted on another.  Path N, where the original addresses are
+    /// path 0, is paced by the congestion control algorithm with index N in
+    /// the client's congestion control settings, so the client must use at
+    /// least as many congestion control algorithms as paths.  Up to
+    /// kMaxCcAlgPerConn paths are supported.
+    ///
+    /// \param  endpt_id        The data endpoint ID.
+    /// \param  local_address   The local address and port number for the
+    ///                         new path, normally on another interface.
+    /// \param  remote_address  The remote address and port number for the
+    ///                         new path.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool AddPath(EndptId endpt_id, const iron::Ipv4Endpoint& local_address,
+                 const iron::Ipv4Endpoint& remote_address);
+
     /// \brief A callback method for processing a client or server endpoint
     /// connection result.
     ///
@@ -414,6 +459,104 @@ namespace sliq
     /// \return  Returns true on success, or false on error.
     bool ConfigureRttOutlierRejection(EndptId endpt_id, bool rtt_or);
 
+    /// \brief Configure the earliest departure time (EDT) send pacing
+    /// setting of a client or server endpoint.
+    ///
+    /// With EDT send pacing, data packets due to be sent within the horizon
+    /// are written to the UDP socket right away with their departure times
+    /// (using SO_TXTIME), and the kernel's fq queueing discipline releases
+    /// them on time.  This greatly reduces the number of send pacing timer
+    /// wakeups at high send rates.  If the socket option is not supported,
+    /// then the send pacing timers continue to be used.  Defaults to
+    /// disabled.
+    ///
+    /// \param  endpt_id     The endpoint ID which will be configured.
+    /// \param  horizon_sec  The EDT horizon in seconds, up to 0.1 seconds.
+    ///                      Zero disables EDT send pacing.
+    ///
+    /// \return  Returns true on success, or false on error.
+    bool ConfigureEdtPacing(EndptId endpt_id, double horizon_sec);
+
+    /// \brief Configure the adaptive ACK frequency setting of a client or
+    /// server endpoint.
+    ///
+    /// When enabled, the endpoint asks its peer to send one ACK packet for
+    /// every N data packets received, or after a maximum ACK delay, where N
+    /// grows with the send rate so that roughly a fixed number of ACK packets
+    /// are sent per round-trip time.  The peer still sends ACK packets
+    /// immediately when data packets are lost or reordered.  Defaults to
+    /// disabled.
+    ///
+    /// \param  endpt_id  The endpoint ID which will be configured.
+    /// \param  enable    The adaptive ACK frequency setting.
+    ///
+    /// \return  Returns true on success, or false on error.
+    bool ConfigureAckFrequency(EndptId endpt_id, bool enable);
+
+    /// \brief Configure the coalesced ACK processing setting of a client or
+    /// server endpoint.
+    ///
+    /// When enabled, all of the ACK packets read from the socket in one
+    /// batch are merged before loss detection, the congestion control ACK
+    /// processing updates, and the sending of new packets are done, which
+    /// then happen once per batch instead of once per ACK packet.  RTT
+    /// samples are still taken from each ACK packet.  Defaults to disabled.
+    ///
+    /// \param  endpt_id  The endpoint ID which will be configured.
+    /// \param  enable    The coalesced ACK processing setting.
+    ///
+    /// \return  Returns true on success, or false on error.
+    bool ConfigureAckCoalescing(EndptId endpt_id, bool enable);
+
+    /// \brief Configure the use of compact data and ACK headers.
+    ///
+    /// When enabled, new connections negotiate the use of compact data and
+    /// ACK headers during the connection handshake.  Compact headers are only
+    /// used if both endpoints enable them.  Compact data headers carry
+    /// truncated packet sequence numbers, omit the payload length, and use
+    /// variable length encodings for timestamp deltas.  Compact ACK headers
+    /// use variable length encodings for observed packet times and ACK block
+    /// offsets.  Only affects connections created after the call.  Defaults
+    /// to disabled.
+    ///
+    /// \param  enable  The compact headers setting.
+    ///
+    /// \return  Returns true on success, or false on error.
+    bool ConfigureCompactHeaders(bool enable);
+
+    /// \brief Get the compact headers setting.
+    ///
+    /// \return  True if new connections will offer compact headers.
+    inline bool compact_headers() const
+    {
+      return compact_hdrs_;
+    }
+
+    /// \brief Configure fast reconnection using cached connection state.
+    ///
+    /// When enabled, each endpoint caches the RTT, congestion control,
+    /// packet error rate (PER) and capacity estimate state of its
+    /// connections per peer, along with a resumption token issued by the
+    /// server during the connection handshake.  When a new connection to the
+    /// same peer presents a matching token, both endpoints start from a
+    /// conservatively scaled version of the cached state instead of the
+    /// defaults, and the cached capacity estimate is reported right away.
+    /// Only used if both endpoints enable it.  Only affects connections
+    /// created after the call.  Defaults to disabled.
+    ///
+    /// \param  enable  The fast reconnection setting.
+    ///
+    /// \return  Returns true on success, or false on error.
+    bool ConfigureFastReconnect(bool enable);
+
+    /// \brief Get the fast reconnection setting.
+    ///
+    /// \return  True if new connections will use fast reconnection.
+    inline bool fast_reconnect() const
+    {
+      return fast_reconnect_;
+    }
+
     /// \brief Configure a stream's transmit queue.
     ///
     /// The stream's transmit queue is for packets that cannot be sent yet due
@@ -770,6 +913,44 @@ namespace sliq
     bool GetTransmitQueueSizeInPackets(EndptId endpt_id, StreamId stream_id,
                                        size_t& size) const;
 
+    /// \brief Get the stream's packet transmission statistics.
+    ///
+    /// The statistics separate original data packets from retransmitted
+    /// data packets and FEC encoded packets, allowing the transmission
+    /// overhead of the stream's reliability mode to be measured.
+    ///
+    /// \param  endpt_id   The endpoint ID of interest.
+    /// \param  stream_id  The stream ID of interest.
+    /// \param  stats      A reference to where the statistics are returned
+    ///                    on success.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool GetSendStats(EndptId endpt_id, StreamId stream_id,
+                      SendStats& stats) const;
+
+    /// \brief Get the endpoint's coalesced ACK processing statistics.
+    ///
+    /// The statistics are only updated while coalesced ACK processing is
+    /// enabled on the endpoint.
+    ///
+    /// \param  endpt_id  The endpoint ID of interest.
+    /// \param  stats     A reference to where the statistics are returned on
+    ///                   success.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool GetAckBatchStats(EndptId endpt_id, AckBatchStats& stats) const;
+
+    /// \brief Get the socket system call statistics.
+    ///
+    /// The statistics cover all of the sockets used by the SLIQ application
+    /// since it was initialized.
+    ///
+    /// \param  stats  A reference to where the statistics are returned on
+    ///                success.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool GetSocketStats(SocketStats& stats) const;
+
     /// \brief Get a pointer to the socket manager for the SLIQ application.
     ///
     /// Necessary for integration with the ns-3 network simulator.
@@ -803,6 +984,12 @@ namespace sliq
     /// The initialized flag.
     bool                initialized_;
 
+    /// The flag controlling if new connections offer compact headers.
+    bool                compact_hdrs_;
+
+    /// The flag controlling if new connections use fast reconnection.
+    bool                fast_reconnect_;
+
     /// The common socket manager.
     SocketManager*      socket_mgr_;
 
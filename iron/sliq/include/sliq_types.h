@@ -40,6 +40,7 @@
 
 #include "itime.h"
 
+#include <stddef.h>
 #include <stdint.h>
 #include <inttypes.h>
 
@@ -85,6 +86,8 @@ namespace sliq
                                ///< throughput policy controller
     COPA2_CC = 6,              ///< MIT's Copa Beta 2
     COPA_CC = 7,               ///< MIT's Copa (final version)
+    TCP_BBR_CC = 8,            ///< Google's BBR model-based congestion
+                               ///< control
 
     FIXED_RATE_TEST_CC = 15,   ///< Fixed send rate instead of congestion
                                ///< control, for testing only
@@ -200,6 +203,16 @@ namespace sliq
       fixed_send_rate    = 0;
     }
 
+    void SetBbr()
+    {
+      algorithm          = TCP_BBR_CC;
+      cubic_reno_pacing  = false;
+      deterministic_copa = false;
+      copa_delta         = 0.0;
+      copa_anti_jitter   = 0.0;
+      fixed_send_rate    = 0;
+    }
+
     void SetFixedRate(Capacity send_rate_bps)
     {
       algorithm          = FIXED_RATE_TEST_CC;
@@ -299,12 +312,18 @@ namespace sliq
   /// - The fec_target_pkt_del_time_sec setting is only applicable to the
   ///   SEMI_RELIABLE_ARQ_FEC mode.  It specifies the target number of seconds
   ///   allowed in order to achieve the target packet receive probability.
+  /// - The fec_sliding_win setting is only applicable to the
+  ///   SEMI_RELIABLE_ARQ_FEC mode.  When true, the sender spreads the
+  ///   encoded data packets of each FEC group between the source data
+  ///   packets, each one covering a sliding window of the most recent source
+  ///   data packets, instead of sending them all after the last source data
+  ///   packet in the group.  This lowers the latency of FEC recovery.
   struct Reliability
   {
     Reliability()
         : mode(RELIABLE_ARQ), rexmit_limit(0), fec_target_pkt_recv_prob(0.0),
           fec_del_time_flag(false), fec_target_pkt_del_rounds(0),
-          fec_target_pkt_del_time_sec(0.0)
+          fec_target_pkt_del_time_sec(0.0), fec_sliding_win(false)
     {}
 
     virtual ~Reliability()
@@ -314,7 +333,7 @@ namespace sliq
                 bool del_time, RexmitRounds recv_rounds, double recv_time)
         : mode(m), rexmit_limit(rx_lim), fec_target_pkt_recv_prob(recv_prob),
           fec_del_time_flag(del_time), fec_target_pkt_del_rounds(recv_rounds),
-          fec_target_pkt_del_time_sec(recv_time)
+          fec_target_pkt_del_time_sec(recv_time), fec_sliding_win(false)
     {}
 
     void SetBestEffort()
@@ -325,6 +344,7 @@ namespace sliq
       fec_del_time_flag           = false;
       fec_target_pkt_del_rounds   = 0;
       fec_target_pkt_del_time_sec = 0.0;
+      fec_sliding_win             = false;
     }
 
     void SetSemiRelArq(RexmitLimit rx_lim)
@@ -335,10 +355,12 @@ namespace sliq
       fec_del_time_flag           = false;
       fec_target_pkt_del_rounds   = 0;
       fec_target_pkt_del_time_sec = 0.0;
+      fec_sliding_win             = false;
     }
 
     void SetSemiRelArqFecUsingRounds(RexmitLimit rx_lim, double recv_prob,
-                                     RexmitRounds recv_rounds)
+                                     RexmitRounds recv_rounds,
+                                     bool sliding_win = false)
     {
       mode                        = SEMI_RELIABLE_ARQ_FEC;
       rexmit_limit                = rx_lim;
@@ -346,10 +368,12 @@ namespace sliq
       fec_del_time_flag           = false;
       fec_target_pkt_del_rounds   = recv_rounds;
       fec_target_pkt_del_time_sec = 0.0;
+      fec_sliding_win             = sliding_win;
     }
 
     void SetSemiRelArqFecUsingTime(RexmitLimit rx_lim, double recv_prob,
-                                   double recv_time_sec)
+                                   double recv_time_sec,
+                                   bool sliding_win = false)
     {
       mode                        = SEMI_RELIABLE_ARQ_FEC;
       rexmit_limit                = rx_lim;
@@ -357,6 +381,7 @@ namespace sliq
       fec_del_time_flag           = true;
       fec_target_pkt_del_rounds   = 0;
       fec_target_pkt_del_time_sec = recv_time_sec;
+      fec_sliding_win             = sliding_win;
     }
 
     void SetRelArq()
@@ -367,6 +392,7 @@ namespace sliq
       fec_del_time_flag           = false;
       fec_target_pkt_del_rounds   = 0;
       fec_target_pkt_del_time_sec = 0.0;
+      fec_sliding_win             = false;
     }
 
     bool operator==(const Reliability& r)
@@ -381,6 +407,7 @@ namespace sliq
                  static_cast<int>((r.fec_target_pkt_recv_prob *
                                    10000.0) + 0.5)) &&
                 (fec_del_time_flag == r.fec_del_time_flag) &&
+                (fec_sliding_win == r.fec_sliding_win) &&
                 ((fec_del_time_flag) ||
                  (fec_target_pkt_del_rounds ==
                   r.fec_target_pkt_del_rounds)) &&
@@ -414,6 +441,10 @@ namespace sliq
 
     /// FEC target packet delivery time in seconds
     double           fec_target_pkt_del_time_sec;
+
+    /// Flag controlling if FEC encoded data packets cover sliding windows of
+    /// source data packets (true) or entire FEC groups (false)
+    bool             fec_sliding_win;
   };
 
   /// The SLIQ delivery modes.  Up to 16 may be defined.
@@ -472,6 +503,72 @@ namespace sliq
     uint32_t  pdd_usec;
   };
 
+  /// The SLIQ stream packet transmission statistics structure.
+  struct SendStats
+  {
+    SendStats()
+        : data_pkts(0), rexmit_pkts(0), fec_enc_pkts(0)
+    {}
+
+    virtual ~SendStats()
+    {}
+
+    /// Original data packets sent, including FEC source packets
+    size_t  data_pkts;
+
+    /// Data packets retransmitted, including FEC source packets
+    size_t  rexmit_pkts;
+
+    /// FEC encoded packets sent, including retransmissions
+    size_t  fec_enc_pkts;
+  };
+
+  /// The SLIQ socket system call statistics structure.
+  struct SocketStats
+  {
+    SocketStats()
+        : read_calls(0), read_pkts(0), write_calls(0), write_pkts(0)
+    {}
+
+    virtual ~SocketStats()
+    {}
+
+    /// Socket read system calls made
+    size_t  read_calls;
+
+    /// Packets read from the sockets
+    size_t  read_pkts;
+
+    /// Socket write system calls made
+    size_t  write_calls;
+
+    /// Packets written to the sockets
+    size_t  write_pkts;
+  };
+
+  /// The SLIQ coalesced ACK processing statistics structure.
+  struct AckBatchStats
+  {
+    AckBatchStats()
+        : batches(0), ack_pkts(0), acks(0), cc_cycles_saved(0)
+    {}
+
+    virtual ~AckBatchStats()
+    {}
+
+    /// Receive batches containing ACK packets
+    size_t  batches;
+
+    /// ACK packets received in the receive batches
+    size_t  ack_pkts;
+
+    /// ACK headers received in the receive batches
+    size_t  acks;
+
+    /// Congestion control ACK processing start/done cycles saved
+    size_t  cc_cycles_saved;
+  };
+
 } // namespace sliq
 
 #endif // IRON_SLIC_TYPES_H
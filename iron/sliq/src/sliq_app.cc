@@ -67,7 +67,8 @@ namespace
 //============================================================================
 SliqApp::SliqApp(PacketPool& packet_pool, Timer& timer)
   : packet_pool_(packet_pool), timer_(timer), initialized_(false),
-    socket_mgr_(NULL), connection_mgr_(NULL), rng_()
+    compact_hdrs_(false), fast_reconnect_(false), socket_mgr_(NULL),
+    connection_mgr_(NULL), rng_()
 {
 }
 
@@ -294,6 +295,36 @@ bool SliqApp::SetupServerDataEndpoint(const Ipv4Endpoint& server_address,
   return true;
 }
 
+//============================================================================
+bool SliqApp::AddPath(EndptId endpt_id, const Ipv4Endpoint& local_address,
+                      const Ipv4Endpoint& remote_address)
+{
+  if (!initialized_)
+  {
+    LogE(kClassName, __func__, "Not initialized.\n");
+    return false;
+  }
+
+  // Find the connection.
+  Connection*  conn = connection_mgr_->GetConnection(endpt_id);
+
+  if (conn == NULL)
+  {
+    return false;
+  }
+
+  // Add the path to the connection, and map the path's socket back to the
+  // connection.
+  SocketId  path_socket_id = -1;
+
+  if (!conn->AddPath(local_address, remote_address, path_socket_id))
+  {
+    return false;
+  }
+
+  return connection_mgr_->AddPathSocket(path_socket_id, endpt_id);
+}
+
 //============================================================================
 bool SliqApp::AddStream(EndptId endpt_id, StreamId stream_id, Priority prio,
                         const Reliability& rel, DeliveryMode del_mode)
@@ -360,6 +391,97 @@ bool SliqApp::ConfigureRttOutlierRejection(EndptId endpt_id, bool rtt_or)
   return true;
 }
 
+//============================================================================
+bool SliqApp::ConfigureEdtPacing(EndptId endpt_id, double horizon_sec)
+{
+  if (!initialized_)
+  {
+    LogE(kClassName, __func__, "Not initialized.\n");
+    return false;
+  }
+
+  // Find the connection.
+  Connection*  conn = connection_mgr_->GetConnection(endpt_id);
+
+  if (conn == NULL)
+  {
+    return false;
+  }
+
+  // Call into the connection to change the setting.
+  return conn->ConfigureEdtPacing(horizon_sec);
+}
+
+//============================================================================
+bool SliqApp::ConfigureAckFrequency(EndptId endpt_id, bool enable)
+{
+  if (!initialized_)
+  {
+    LogE(kClassName, __func__, "Not initialized.\n");
+    return false;
+  }
+
+  // Find the connection.
+  Connection*  conn = connection_mgr_->GetConnection(endpt_id);
+
+  if (conn == NULL)
+  {
+    return false;
+  }
+
+  // Call into the connection to change the setting.
+  return conn->ConfigureAckFrequency(enable);
+}
+
+//============================================================================
+bool SliqApp::ConfigureAckCoalescing(EndptId endpt_id, bool enable)
+{
+  if (!initialized_)
+  {
+    LogE(kClassName, __func__, "Not initialized.\n");
+    return false;
+  }
+
+  // Find the connection.
+  Connection*  conn = connection_mgr_->GetConnection(endpt_id);
+
+  if (conn == NULL)
+  {
+    return false;
+  }
+
+  // Call into the connection to change the setting.
+  return conn->ConfigureAckCoalescing(enable);
+}
+
+//============================================================================
+bool SliqApp::ConfigureCompactHeaders(bool enable)
+{
+  if (!initialized_)
+  {
+    LogE(kClassName, __func__, "Not initialized.\n");
+    return false;
+  }
+
+  compact_hdrs_ = enable;
+
+  return true;
+}
+
+//============================================================================
+bool SliqApp::ConfigureFastReconnect(bool enable)
+{
+  if (!initialized_)
+  {
+    LogE(kClassName, __func__, "Not initialized.\n");
+    return false;
+  }
+
+  fast_reconnect_ = enable;
+
+  return true;
+}
+
 //============================================================================
 bool SliqApp::ConfigureTransmitQueue(EndptId endpt_id, StreamId stream_id,
                                      size_t max_size_pkts,
@@ -634,12 +756,18 @@ void SliqApp::SvcFileDescriptor(int fd, FdEvent event)
   // the two are equal.
   EndptId  endpt_id = fd;
 
-  // Find the connection.
+  // Find the connection.  The file descriptor may also be for one of the
+  // connection's added paths.
   Connection*  conn = connection_mgr_->GetConnection(endpt_id);
 
   if (conn == NULL)
   {
-    return;
+    conn = connection_mgr_->GetConnectionByPathSocket(fd);
+
+    if (conn == NULL)
+    {
+      return;
+    }
   }
 
   // Service the file descriptor on the connection.
@@ -691,3 +819,60 @@ bool SliqApp::GetTransmitQueueSizeInPackets(EndptId endpt_id,
   // Call into the connection to get the size.
   return conn->GetTransmitQueueSizeInPackets(stream_id, size);
 }
+
+//============================================================================
+bool SliqApp::GetSendStats(EndptId endpt_id, StreamId stream_id,
+                           SendStats& stats) const
+{
+  if (!initialized_)
+  {
+    LogE(kClassName, __func__, "Not initialized.\n");
+    return false;
+  }
+
+  // Find the connection.
+  Connection*  conn = connection_mgr_->GetConnection(endpt_id);
+
+  if (conn == NULL)
+  {
+    return false;
+  }
+
+  // Call into the connection to get the statistics.
+  return conn->GetSendStats(stream_id, stats);
+}
+
+//============================================================================
+bool SliqApp::GetAckBatchStats(EndptId endpt_id, AckBatchStats& stats) const
+{
+  if (!initialized_)
+  {
+    LogE(kClassName, __func__, "Not initialized.\n");
+    return false;
+  }
+
+  // Find the connection.
+  Connection*  conn = connection_mgr_->GetConnection(endpt_id);
+
+  if (conn == NULL)
+  {
+    return false;
+  }
+
+  // Call into the connection to get the statistics.
+  return conn->GetAckBatchStats(stats);
+}
+
+//============================================================================
+bool SliqApp::GetSocketStats(SocketStats& stats) const
+{
+  if (!initialized_)
+  {
+    LogE(kClassName, __func__, "Not initialized.\n");
+    return false;
+  }
+
+  socket_mgr_->GetStats(stats);
+
+  return true;
+}
@@ -0,0 +1,979 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "sliq_cc_bbr.h"
+
+#include "log.h"
+#include "unused.h"
+
+#include <inttypes.h>
+
+
+using ::sliq::Bbr;
+using ::sliq::Capacity;
+using ::sliq::CongCtrlAlg;
+using ::sliq::PktSeqNumber;
+using ::iron::Log;
+using ::iron::Time;
+
+
+namespace
+{
+  /// The class name string for logging.
+  const char*     UNUSED(kClassName)   = "Bbr";
+
+  /// The maximum segment size, in bytes.
+  const int64_t   kBbrMss              = sliq::kMaxPacketSize;
+
+  /// The initial congestion window size, in bytes.
+  const int64_t   kInitCwnd            = (10 * kBbrMss);
+
+  /// The minimum congestion window size, in bytes.  This is also the
+  /// congestion window size used while in PROBE_RTT.
+  const int64_t   kMinCwnd             = (4 * kBbrMss);
+
+  /// The packet overhead due to Ethernet (14 bytes), IP (20 bytes), and UDP
+  /// (8 bytes), in bytes.  This assumes that no 802.1Q tag is present in the
+  /// Ethernet frame, and that no IP header options are present.
+  const uint32_t  kPktOverheadBytes    = 42;
+
+  /// The STARTUP pacing and congestion window gain, which is 2/ln(2).  This
+  /// is the smallest gain that allows the sending rate to double each round
+  /// trip.
+  const double    kHighGain            = 2.885;
+
+  /// The DRAIN pacing gain, which drains the queue created during STARTUP in
+  /// a single round trip.
+  const double    kDrainGain           = (1.0 / 2.885);
+
+  /// The PROBE_BW congestion window gain.
+  const double    kCwndGain            = 2.0;
+
+  /// The number of phases in the PROBE_BW pacing gain cycle.
+  const size_t    kGainCycleLen        = 8;
+
+  /// The PROBE_BW pacing gain cycle.  One phase probes for more bandwidth,
+  /// the next phase drains any resulting queue, and the remaining phases
+  /// cruise at the estimated bottleneck bandwidth.
+  const double    kPacingGain[kGainCycleLen] =
+  {
+    1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0
+  };
+
+  /// The PROBE_BW cycle index entered after DRAIN.  Starting in a cruising
+  /// phase avoids probing immediately after draining the STARTUP queue.
+  const size_t    kInitCycleIndex      = 2;
+
+  /// The length of the bottleneck bandwidth filter window, in round trips.
+  const uint64_t  kBwWindowRounds      = 10;
+
+  /// The length of the minimum RTT filter window, in seconds.
+  const double    kMinRttWindowSec     = 10.0;
+
+  /// The minimum time to stay in PROBE_RTT, in seconds.
+  const double    kProbeRttDurationSec = 0.2;
+
+  /// The bottleneck bandwidth growth factor that must be seen each round in
+  /// STARTUP for the pipe to not yet be considered full.
+  const double    kFullBwThresh        = 1.25;
+
+  /// The number of rounds without kFullBwThresh growth after which the pipe
+  /// is considered full.
+  const uint32_t  kFullBwCnt           = 3;
+}
+
+
+//============================================================================
+Bbr::Bbr(EndptId conn_id, bool is_client, RttManager& rtt_mgr)
+    : CongCtrlInterface(conn_id, is_client),
+      rtt_mgr_(rtt_mgr),
+      connected_(false),
+      state_(STARTUP),
+      pkt_data_(NULL),
+      nxt_cc_seq_num_(0),
+      delivered_(0),
+      delivered_time_(),
+      first_sent_time_(),
+      app_limited_until_(0),
+      rs_valid_(false),
+      rs_prior_delivered_(0),
+      rs_prior_time_(),
+      rs_send_elapsed_(),
+      rs_app_limited_(false),
+      rs_acked_bytes_(0),
+      rs_loss_(false),
+      max_bw_(),
+      round_count_(0),
+      next_round_delivered_(0),
+      round_start_(false),
+      min_rtt_(),
+      min_rtt_stamp_(),
+      min_rtt_expired_(false),
+      pacing_gain_(kHighGain),
+      cwnd_gain_(kHighGain),
+      cycle_index_(kInitCycleIndex),
+      cycle_stamp_(),
+      full_bw_reached_(false),
+      full_bw_(0.0),
+      full_bw_cnt_(0),
+      probe_rtt_done_stamp_(),
+      probe_rtt_round_done_(false),
+      prior_cwnd_(0),
+      pacing_rate_bps_(0.0),
+      cwnd_(kInitCwnd)
+{
+  min_rtt_.SetInfinite();
+}
+
+//============================================================================
+Bbr::~Bbr()
+{
+  // Delete the array of packet information.
+  if (pkt_data_ != NULL)
+  {
+    delete [] pkt_data_;
+    pkt_data_ = NULL;
+  }
+}
+
+//============================================================================
+bool Bbr::Configure(const CongCtrl& /* cc_params */)
+{
+  // Allocate the circular array of per-packet delivery state.
+  pkt_data_ = new (std::nothrow) PacketData[kMaxCongCtrlWindowPkts];
+
+  if (pkt_data_ == NULL)
+  {
+    LogE(kClassName, __func__, "Conn %" PRIEndptId ": Error allocating "
+         "packet data.\n", conn_id_);
+    return false;
+  }
+
+  return true;
+}
+
+//============================================================================
+void Bbr::Connected(const Time& now, const Time& rtt)
+{
+  connected_     = true;
+  min_rtt_stamp_ = now;
+  cycle_stamp_   = now;
+
+  // Seed the minimum RTT with the connection handshake RTT, and pace the
+  // initial congestion window over it at the STARTUP gain.
+  Time  init_rtt = (rtt.IsZero() ? rtt_mgr_.smoothed_rtt() : rtt);
+
+  if (!init_rtt.IsZero())
+  {
+    min_rtt_         = init_rtt;
+    pacing_rate_bps_ = ((kHighGain * 8.0 * static_cast<double>(cwnd_)) /
+                        init_rtt.ToDouble());
+  }
+
+  LogD(kClassName, __func__, "Conn %" PRIEndptId ": Connected, initial "
+       "rtt %s pacing rate %f bps.\n", conn_id_, init_rtt.ToString().c_str(),
+       pacing_rate_bps_);
+}
+
+//============================================================================
+void Bbr::Resume(const Time& now, const Time& min_rtt, size_t cwnd,
+                 Capacity rate)
+{
+  if (rate == 0)
+  {
+    return;
+  }
+
+  // Seed the bottleneck bandwidth filter with one-half of the cached send
+  // rate and stay in STARTUP, so the model is refreshed within a few rounds
+  // while the first round is not limited to the initial congestion window.
+  max_bw_.Update((0.5 * static_cast<double>(rate)), round_count_,
+                 kBwWindowRounds);
+
+  if (min_rtt_.IsInfinite() && (!min_rtt.IsZero()))
+  {
+    min_rtt_ = min_rtt;
+  }
+
+  int64_t  bdp = ComputeBdp(1.0);
+
+  if (bdp > cwnd_)
+  {
+    cwnd_ = bdp;
+  }
+
+  SetPacingRate();
+
+  LogD(kClassName, __func__, "Conn %" PRIEndptId ": Resumed with btl bw %f "
+       "bps pacing rate %f bps cwnd %" PRId64 ".\n", conn_id_,
+       max_bw_.GetBest(), pacing_rate_bps_, cwnd_);
+}
+
+//============================================================================
+bool Bbr::UseRexmitPacing()
+{
+  return true;
+}
+
+//============================================================================
+bool Bbr::UseCongWinForCapEst()
+{
+  // The bottleneck bandwidth estimate is a direct capacity estimate.
+  return false;
+}
+
+//============================================================================
+bool Bbr::UseUnaPktReporting()
+{
+  return false;
+}
+
+//============================================================================
+bool Bbr::SetTcpFriendliness(uint32_t /* num_flows */)
+{
+  return false;
+}
+
+//============================================================================
+bool Bbr::ActivateStream(StreamId /* stream_id */,
+                         PktSeqNumber /* init_send_seq_num */)
+{
+  return true;
+}
+
+//============================================================================
+bool Bbr::DeactivateStream(StreamId /* stream_id */)
+{
+  return true;
+}
+
+//============================================================================
+void Bbr::OnAckPktProcessingStart(const Time& /* ack_time */)
+{
+  // Start a new rate sample.
+  rs_valid_       = false;
+  rs_acked_bytes_ = 0;
+  rs_loss_        = false;
+}
+
+//============================================================================
+void Bbr::OnRttUpdate(StreamId /* stream_id */, const Time& ack_time,
+                      PktTimestamp /* send_ts */, PktTimestamp /* recv_ts */,
+                      PktSeqNumber /* seq_num */,
+                      PktSeqNumber /* cc_seq_num */, const Time& rtt,
+                      uint32_t /* bytes */, float /* cc_val */)
+{
+  if (rtt.IsZero())
+  {
+    return;
+  }
+
+  // Update the minimum RTT filter.  A sample replaces the estimate if it is
+  // lower or if the estimate has not been refreshed within the window.
+  min_rtt_expired_ = (ack_time > min_rtt_stamp_.Add(kMinRttWindowSec));
+
+  if ((rtt <= min_rtt_) || min_rtt_expired_)
+  {
+    min_rtt_       = rtt;
+    min_rtt_stamp_ = ack_time;
+  }
+}
+
+//============================================================================
+bool Bbr::OnPacketLost(StreamId /* stream_id */, const Time& /* ack_time */,
+                       PktSeqNumber /* seq_num */,
+                       PktSeqNumber /* cc_seq_num */, uint32_t /* bytes */)
+{
+  // Losses do not directly change the model, but they end a bandwidth
+  // probing phase early.
+  rs_loss_ = true;
+
+  return true;
+}
+
+//============================================================================
+void Bbr::OnPacketAcked(StreamId /* stream_id */, const Time& ack_time,
+                        PktSeqNumber /* seq_num */, PktSeqNumber cc_seq_num,
+                        PktSeqNumber /* ne_seq_num */, uint32_t /* bytes */)
+{
+  PacketData&  pd = pkt_data_[cc_seq_num % kMaxCongCtrlWindowPkts];
+
+  if (!pd.in_flight)
+  {
+    return;
+  }
+
+  pd.in_flight     = false;
+  delivered_      += pd.bytes;
+  delivered_time_  = ack_time;
+  rs_acked_bytes_ += pd.bytes;
+
+  // Base the rate sample on the most recently sent packet that is ACKed.
+  if ((!rs_valid_) || (pd.delivered > rs_prior_delivered_))
+  {
+    rs_valid_           = true;
+    rs_prior_delivered_ = pd.delivered;
+    rs_prior_time_      = pd.delivered_time;
+    rs_send_elapsed_    = (pd.send_time - pd.first_sent_time);
+    rs_app_limited_     = pd.app_limited;
+    first_sent_time_    = pd.send_time;
+  }
+}
+
+//============================================================================
+void Bbr::OnAckPktProcessingDone(const Time& ack_time)
+{
+  // End the application limited period once its data has been delivered.
+  if ((app_limited_until_ != 0) && (delivered_ > app_limited_until_))
+  {
+    app_limited_until_ = 0;
+  }
+
+  if (!rs_valid_)
+  {
+    return;
+  }
+
+  UpdateModelAndState(ack_time);
+  SetPacingRate();
+  SetCwnd();
+
+#ifdef SLIQ_CC_DEBUG
+  LogD(kClassName, __func__, "Conn %" PRIEndptId ": state %s round %"
+       PRIu64 " btlbw %f bps min_rtt %s pacing_gain %f pacing_rate %f bps "
+       "cwnd %" PRId64 " bif %" PRId64 ".\n", conn_id_,
+       StateToString(state_), round_count_, max_bw_.GetBest(),
+       min_rtt_.ToString().c_str(), pacing_gain_, pacing_rate_bps_, cwnd_,
+       bytes_in_flight_);
+#endif
+}
+
+//============================================================================
+PktSeqNumber Bbr::OnPacketSent(StreamId stream_id, const Time& send_time,
+                               PktSeqNumber seq_num, uint32_t pld_bytes,
+                               uint32_t tot_bytes, float& cc_val)
+{
+  // Assign a CC sequence number to the packet.
+  PktSeqNumber  cc_seq_num = nxt_cc_seq_num_;
+  ++nxt_cc_seq_num_;
+
+#ifdef SLIQ_CC_DEBUG
+  LogD(kClassName, __func__, "Conn %" PRIEndptId ": On Send: stream=%"
+       PRIStreamId " seq_num=%" PRIPktSeqNumber " cc_seq_num=%"
+       PRIPktSeqNumber " send_time=%s size=%" PRIu32 "/%" PRIu32
+       " cc_val=%f\n", conn_id_, stream_id, seq_num, cc_seq_num,
+       send_time.ToString().c_str(), pld_bytes, tot_bytes,
+       static_cast<double>(cc_val));
+#endif
+
+  // When leaving quiescence, restart the delivery rate sampling intervals
+  // and mark the connection as application limited until the data in
+  // flight has been delivered, since the sends were limited by the
+  // application and not the network.  Note that bytes in flight does not
+  // reflect the packet just sent yet.
+  if (bytes_in_flight_ == 0)
+  {
+    first_sent_time_   = send_time;
+    delivered_time_    = send_time;
+    app_limited_until_ = ((delivered_ > 0) ? delivered_ : 1);
+  }
+
+  PacketData&  pd = pkt_data_[cc_seq_num % kMaxCongCtrlWindowPkts];
+
+  pd.in_flight       = true;
+  pd.app_limited     = (app_limited_until_ != 0);
+  pd.bytes           = (tot_bytes + kPktOverheadBytes);
+  pd.delivered       = delivered_;
+  pd.send_time       = send_time;
+  pd.delivered_time  = delivered_time_;
+  pd.first_sent_time = first_sent_time_;
+
+  return cc_seq_num;
+}
+
+//============================================================================
+void Bbr::OnPacketResent(StreamId stream_id, const Time& send_time,
+                         PktSeqNumber seq_num, PktSeqNumber cc_seq_num,
+                         uint32_t pld_bytes, uint32_t tot_bytes, bool rto,
+                         bool orig_cc, float& cc_val)
+{
+#ifdef SLIQ_CC_DEBUG
+  LogD(kClassName, __func__, "Conn %" PRIEndptId ": On Resend: stream=%"
+       PRIStreamId " seq_num=%" PRIPktSeqNumber " cc_seq_num=%"
+       PRIPktSeqNumber " send_time=%s size=%" PRIu32 "/%" PRIu32" rto=%d "
+       "orig_cc=%d cc_val=%f\n", conn_id_, stream_id, seq_num, cc_seq_num,
+       send_time.ToString().c_str(), pld_bytes, tot_bytes,
+       static_cast<int>(rto), static_cast<int>(orig_cc),
+       static_cast<double>(cc_val));
+#endif
+
+  if (!orig_cc)
+  {
+    return;
+  }
+
+  // Restamp the packet's delivery state so that a rate sample from its ACK
+  // covers the retransmission and not the original transmission.
+  PacketData&  pd = pkt_data_[cc_seq_num % kMaxCongCtrlWindowPkts];
+
+  pd.in_flight       = true;
+  pd.app_limited     = (app_limited_until_ != 0);
+  pd.bytes           = (tot_bytes + kPktOverheadBytes);
+  pd.delivered       = delivered_;
+  pd.send_time       = send_time;
+  pd.delivered_time  = delivered_time_;
+  pd.first_sent_time = first_sent_time_;
+}
+
+//============================================================================
+void Bbr::OnRto(bool /* pkt_rexmit */)
+{
+  // Collapse the congestion window.  The model is kept, so the window grows
+  // straight back to its target as ACKs arrive.
+  if (state_ != PROBE_RTT)
+  {
+    prior_cwnd_ = cwnd_;
+  }
+
+  cwnd_ = kMinCwnd;
+}
+
+//============================================================================
+void Bbr::OnOutageEnd()
+{
+  // The path may have changed during the outage.  Restart with the initial
+  // congestion window, keeping the model.
+  cwnd_ = kInitCwnd;
+}
+
+//============================================================================
+bool Bbr::CanSend(const Time& /* now */, uint32_t /* bytes */)
+{
+  if (!connected_)
+  {
+    return false;
+  }
+
+  // Make sure that the maximum number of packets in the circular array is
+  // never exceeded.
+  if (pkts_in_flight_ >= static_cast<int32_t>(kMaxCongCtrlWindowPkts))
+  {
+    LogW(kClassName, __func__, "Conn %" PRIEndptId ": CC window size reached "
+         "%zu packets.\n", conn_id_, kMaxCongCtrlWindowPkts);
+    return false;
+  }
+
+  // Note that bytes_in_flight_ is allowed to go over cwnd_ for the last
+  // packet to "fit" into cwnd_.
+  return (bytes_in_flight_ < cwnd_);
+}
+
+//============================================================================
+bool Bbr::CanResend(const Time& /* now */, uint32_t /* bytes */,
+                    bool /* orig_cc */)
+{
+  // Fast retransmissions are paced, so this can just return true.
+  return true;
+}
+
+//============================================================================
+Time Bbr::TimeUntilSend(const Time& /* now */)
+{
+  // The PacingSender object handles the pacing.
+  return Time();
+}
+
+//============================================================================
+Capacity Bbr::SendPacingRate()
+{
+  return static_cast<Capacity>(pacing_rate_bps_);
+}
+
+//============================================================================
+Capacity Bbr::SendRate()
+{
+  // Until the first bandwidth sample is available, report the pacing rate.
+  double  btl_bw = max_bw_.GetBest();
+
+  if (btl_bw <= 0.0)
+  {
+    return static_cast<Capacity>(pacing_rate_bps_);
+  }
+
+  return static_cast<Capacity>(btl_bw);
+}
+
+//============================================================================
+bool Bbr::GetSyncParams(uint16_t& /* seq_num */, uint32_t& /* cc_params */)
+{
+  return false;
+}
+
+//============================================================================
+void Bbr::ProcessSyncParams(const Time& /* now */, uint16_t /* seq_num */,
+                            uint32_t /* cc_params */)
+{
+  return;
+}
+
+//============================================================================
+void Bbr::ProcessCcPktTrain(const Time& /* now */,
+                            CcPktTrainHeader& /* hdr */)
+{
+  return;
+}
+
+//============================================================================
+bool Bbr::InSlowStart()
+{
+  return (state_ == STARTUP);
+}
+
+//============================================================================
+bool Bbr::InRecovery()
+{
+  return false;
+}
+
+//============================================================================
+uint32_t Bbr::GetCongestionWindow()
+{
+  return static_cast<uint32_t>(cwnd_);
+}
+
+//============================================================================
+uint32_t Bbr::GetSlowStartThreshold()
+{
+  return 0;
+}
+
+//============================================================================
+CongCtrlAlg Bbr::GetCongestionControlType()
+{
+  return TCP_BBR_CC;
+}
+
+//============================================================================
+void Bbr::Close()
+{
+  return;
+}
+
+//============================================================================
+void Bbr::UpdateModelAndState(const Time& now)
+{
+  UpdateRound();
+  UpdateBw(now);
+  UpdateCyclePhase(now);
+  CheckFullPipe();
+  CheckDrain(now);
+  UpdateMinRttAndProbeRtt(now);
+}
+
+//============================================================================
+void Bbr::UpdateRound()
+{
+  round_start_ = false;
+
+  // A round trip ends when a packet sent after the start of the round is
+  // ACKed.
+  if (rs_prior_delivered_ >= next_round_delivered_)
+  {
+    next_round_delivered_ = delivered_;
+    ++round_count_;
+    round_start_          = true;
+  }
+}
+
+//============================================================================
+void Bbr::UpdateBw(const Time& /* now */)
+{
+  // The sample interval is the longer of the send and ACK intervals, which
+  // guards against ACK compression inflating the sample.
+  Time  ack_elapsed = (delivered_time_ - rs_prior_time_);
+  Time  interval    = Time::Max(rs_send_elapsed_, ack_elapsed);
+
+  if (interval.IsZero() || (delivered_ <= rs_prior_delivered_))
+  {
+    return;
+  }
+
+  // Intervals shorter than the minimum RTT cannot be trusted.
+  if ((!min_rtt_.IsInfinite()) && (interval < min_rtt_))
+  {
+    return;
+  }
+
+  double  bw = ((8.0 * static_cast<double>(delivered_ -
+                                           rs_prior_delivered_)) /
+                interval.ToDouble());
+
+  // Application limited samples only reflect a lower bound on the bottleneck
+  // bandwidth, so they can only raise the estimate.
+  if ((!rs_app_limited_) || (bw >= max_bw_.GetBest()))
+  {
+    max_bw_.Update(bw, round_count_, kBwWindowRounds);
+  }
+}
+
+//============================================================================
+void Bbr::UpdateCyclePhase(const Time& now)
+{
+  if (state_ != PROBE_BW)
+  {
+    return;
+  }
+
+  bool  full_length = ((now - cycle_stamp_) > min_rtt_);
+  bool  advance     = full_length;
+
+  if (pacing_gain_ > 1.0)
+  {
+    // Keep probing until the extra data is actually in flight, unless a
+    // loss shows that the probe has already filled the queue.
+    advance = (full_length &&
+               (rs_loss_ || (bytes_in_flight_ >= ComputeBdp(pacing_gain_))));
+  }
+  else if (pacing_gain_ < 1.0)
+  {
+    // Stop draining early once the queue is gone.
+    advance = (full_length || (bytes_in_flight_ <= ComputeBdp(1.0)));
+  }
+
+  if (advance)
+  {
+    cycle_index_ = ((cycle_index_ + 1) % kGainCycleLen);
+    cycle_stamp_ = now;
+    pacing_gain_ = kPacingGain[cycle_index_];
+  }
+}
+
+//============================================================================
+void Bbr::CheckFullPipe()
+{
+  if (full_bw_reached_ || (!round_start_) || rs_app_limited_)
+  {
+    return;
+  }
+
+  double  btl_bw = max_bw_.GetBest();
+
+  if (btl_bw >= (full_bw_ * kFullBwThresh))
+  {
+    full_bw_     = btl_bw;
+    full_bw_cnt_ = 0;
+    return;
+  }
+
+  ++full_bw_cnt_;
+
+  if (full_bw_cnt_ >= kFullBwCnt)
+  {
+    full_bw_reached_ = true;
+
+    LogD(kClassName, __func__, "Conn %" PRIEndptId ": Full bandwidth "
+         "reached at %f bps.\n", conn_id_, full_bw_);
+  }
+}
+
+//============================================================================
+void Bbr::CheckDrain(const Time& now)
+{
+  if ((state_ == STARTUP) && full_bw_reached_)
+  {
+    state_       = DRAIN;
+    pacing_gain_ = kDrainGain;
+    cwnd_gain_   = kHighGain;
+  }
+
+  if ((state_ == DRAIN) && (bytes_in_flight_ <= ComputeBdp(1.0)))
+  {
+    EnterProbeBw(now);
+  }
+}
+
+//============================================================================
+void Bbr::UpdateMinRttAndProbeRtt(const Time& now)
+{
+  if (min_rtt_expired_ && (state_ != PROBE_RTT))
+  {
+    state_                = PROBE_RTT;
+    pacing_gain_          = 1.0;
+    cwnd_gain_            = 1.0;
+    prior_cwnd_           = cwnd_;
+    probe_rtt_done_stamp_.Zero();
+    probe_rtt_round_done_ = false;
+
+    LogD(kClassName, __func__, "Conn %" PRIEndptId ": Entering PROBE_RTT, "
+         "min_rtt %s.\n", conn_id_, min_rtt_.ToString().c_str());
+  }
+
+  min_rtt_expired_ = false;
+
+  if (state_ != PROBE_RTT)
+  {
+    return;
+  }
+
+  if (probe_rtt_done_stamp_.IsZero())
+  {
+    // Wait for the data in flight to drain down to the PROBE_RTT window,
+    // then hold it there for at least one round trip and kProbeRttDurationSec
+    // seconds.
+    if (bytes_in_flight_ <= kMinCwnd)
+    {
+      probe_rtt_done_stamp_ = now.Add(kProbeRttDurationSec);
+      probe_rtt_round_done_ = false;
+      next_round_delivered_ = delivered_;
+    }
+    return;
+  }
+
+  if (round_start_)
+  {
+    probe_rtt_round_done_ = true;
+  }
+
+  if (probe_rtt_round_done_ && (now >= probe_rtt_done_stamp_))
+  {
+    min_rtt_stamp_ = now;
+    cwnd_          = ((cwnd_ > prior_cwnd_) ? cwnd_ : prior_cwnd_);
+
+    if (full_bw_reached_)
+    {
+      EnterProbeBw(now);
+    }
+    else
+    {
+      state_       = STARTUP;
+      pacing_gain_ = kHighGain;
+      cwnd_gain_   = kHighGain;
+    }
+
+    LogD(kClassName, __func__, "Conn %" PRIEndptId ": Leaving PROBE_RTT for "
+         "%s.\n", conn_id_, StateToString(state_));
+  }
+}
+
+//============================================================================
+void Bbr::EnterProbeBw(const Time& now)
+{
+  state_       = PROBE_BW;
+  cwnd_gain_   = kCwndGain;
+  cycle_index_ = kInitCycleIndex;
+  cycle_stamp_ = now;
+  pacing_gain_ = kPacingGain[cycle_index_];
+
+  LogD(kClassName, __func__, "Conn %" PRIEndptId ": Entering PROBE_BW, "
+       "btlbw %f bps min_rtt %s.\n", conn_id_, max_bw_.GetBest(),
+       min_rtt_.ToString().c_str());
+}
+
+//============================================================================
+void Bbr::SetPacingRate()
+{
+  double  btl_bw = max_bw_.GetBest();
+
+  if (btl_bw <= 0.0)
+  {
+    return;
+  }
+
+  double  rate = (pacing_gain_ * btl_bw);
+
+  // Never lower the pacing rate in STARTUP before the pipe is full, since
+  // the early samples underestimate the bottleneck bandwidth.
+  if (full_bw_reached_ || (rate > pacing_rate_bps_))
+  {
+    pacing_rate_bps_ = rate;
+  }
+}
+
+//============================================================================
+void Bbr::SetCwnd()
+{
+  if (state_ == PROBE_RTT)
+  {
+    cwnd_ = ((cwnd_ < kMinCwnd) ? cwnd_ : kMinCwnd);
+    return;
+  }
+
+  // Allow for three maximum size packets of quantization effects on top of
+  // the scaled bandwidth-delay product.
+  int64_t  target = (ComputeBdp(cwnd_gain_) + (3 * kBbrMss));
+
+  if (full_bw_reached_)
+  {
+    cwnd_ += rs_acked_bytes_;
+    cwnd_  = ((cwnd_ < target) ? cwnd_ : target);
+  }
+  else if ((cwnd_ < target) ||
+           (delivered_ < static_cast<uint64_t>(kInitCwnd)))
+  {
+    cwnd_ += rs_acked_bytes_;
+  }
+
+  cwnd_ = ((cwnd_ > kMinCwnd) ? cwnd_ : kMinCwnd);
+}
+
+//============================================================================
+int64_t Bbr::ComputeBdp(double gain) const
+{
+  double  btl_bw = max_bw_.GetBest();
+
+  // Without a model, fall back to the initial congestion window.
+  if ((btl_bw <= 0.0) || min_rtt_.IsInfinite())
+  {
+    return kInitCwnd;
+  }
+
+  return static_cast<int64_t>((gain * btl_bw * min_rtt_.ToDouble()) / 8.0);
+}
+
+//============================================================================
+const char* Bbr::StateToString(BbrState state)
+{
+  switch (state)
+  {
+    case STARTUP:
+      return "STARTUP";
+
+    case DRAIN:
+      return "DRAIN";
+
+    case PROBE_BW:
+      return "PROBE_BW";
+
+    case PROBE_RTT:
+      return "PROBE_RTT";
+  }
+
+  return "UNKNOWN";
+}
+
+//============================================================================
+Bbr::PacketData::PacketData()
+    : in_flight(false),
+      app_limited(false),
+      bytes(0),
+      delivered(0),
+      send_time(),
+      delivered_time(),
+      first_sent_time()
+{
+}
+
+//============================================================================
+Bbr::PacketData::~PacketData()
+{
+}
+
+//============================================================================
+Bbr::MaxBwFilter::MaxBwFilter()
+{
+  Reset(0.0, 0);
+}
+
+//============================================================================
+Bbr::MaxBwFilter::~MaxBwFilter()
+{
+}
+
+//============================================================================
+void Bbr::MaxBwFilter::Reset(double bw, uint64_t round)
+{
+  for (size_t i = 0; i < 3; ++i)
+  {
+    est[i].bw    = bw;
+    est[i].round = round;
+  }
+}
+
+//============================================================================
+void Bbr::MaxBwFilter::Update(double bw, uint64_t round, uint64_t window)
+{
+  // A new best sample, or a best sample that has aged out of the window,
+  // resets the whole filter.
+  if ((bw >= est[0].bw) || ((round - est[2].round) > window))
+  {
+    Reset(bw, round);
+    return;
+  }
+
+  if (bw >= est[1].bw)
+  {
+    est[1].bw    = bw;
+    est[1].round = round;
+    est[2]       = est[1];
+  }
+  else if (bw >= est[2].bw)
+  {
+    est[2].bw    = bw;
+    est[2].round = round;
+  }
+
+  // Age out the best sample, promoting the second and third best samples,
+  // and keep the backup samples spread across the window.
+  uint64_t  dt = (round - est[0].round);
+
+  if (dt > window)
+  {
+    est[0]       = est[1];
+    est[1]       = est[2];
+    est[2].bw    = bw;
+    est[2].round = round;
+
+    if ((round - est[0].round) > window)
+    {
+      est[0]       = est[1];
+      est[1]       = est[2];
+      est[2].bw    = bw;
+      est[2].round = round;
+    }
+  }
+  else if ((est[1].round == est[0].round) && (dt > (window / 4)))
+  {
+    est[1].bw    = bw;
+    est[1].round = round;
+    est[2]       = est[1];
+  }
+  else if ((est[2].round == est[1].round) && (dt > (window / 2)))
+  {
+    est[2].bw    = bw;
+    est[2].round = round;
+  }
+}
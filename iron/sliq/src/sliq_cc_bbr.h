@@ -0,0 +1,723 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#ifndef IRON_SLIQ_CC_BBR_H
+#define IRON_SLIQ_CC_BBR_H
+
+#include "sliq_cc_interface.h"
+#include "sliq_private_defs.h"
+#include "sliq_private_types.h"
+#include "sliq_rtt_manager.h"
+
+#include "itime.h"
+
+
+namespace sliq
+{
+
+  /// \brief A BBR-style model-based congestion control algorithm.
+  ///
+  /// Instead of reacting to packet losses or delay increases, BBR builds an
+  /// explicit model of the network path from two estimates: the bottleneck
+  /// bandwidth, which is the windowed maximum of the delivery rate samples
+  /// measured over the last ten round trips, and the round-trip propagation
+  /// time, which is the windowed minimum of the RTT samples measured over the
+  /// last ten seconds.  The send pacing rate is the bottleneck bandwidth
+  /// estimate scaled by a pacing gain that is cycled in order to probe for
+  /// more bandwidth and then drain any queue that was created, and the
+  /// congestion window is a small multiple of the estimated bandwidth-delay
+  /// product.
+  ///
+  /// The algorithm moves through the STARTUP, DRAIN, PROBE_BW, and PROBE_RTT
+  /// states described in "BBR: Congestion-Based Congestion Control" (Cardwell
+  /// et al., ACM Queue, 2016).  Delivery rate samples are generated from the
+  /// ACK processing callbacks using the per-packet delivery state recorded
+  /// when each packet is sent.
+  ///
+  /// This object must be wrapped in a PacingSender object, which paces the
+  /// transmissions at SendPacingRate().  The bottleneck bandwidth estimate is
+  /// reported by SendRate() for use by the capacity estimator.
+  ///
+  /// Note that this class is not thread-safe.
+  class Bbr : public CongCtrlInterface
+  {
+
+   public:
+
+    /// \brief Constructor.
+    ///
+    /// \param  conn_id    The connection ID.
+    /// \param  is_client  The flag determining if this is the client or
+    ///                    server side of the connection.
+    /// \param  rtt_mgr    The RTT manager.
+    Bbr(EndptId conn_id, bool is_client, RttManager& rtt_mgr);
+
+    /// \brief Destructor.
+    virtual ~Bbr();
+
+    /// \brief Configure the congestion control algorithm.
+    ///
+    /// \param  cc_params  The congestion control parameters to use.
+    ///
+    /// \return  Returns true on success, or false if an error occurs.
+    virtual bool Configure(const CongCtrl& cc_params);
+
+    /// \brief Called once the connection is established.
+    ///
+    /// \param  now  The current time.
+    /// \param  rtt  The initial RTT estimate from the connection handshake.
+    virtual void Connected(const iron::Time& now, const iron::Time& rtt);
+
+    /// \brief Called right after Connected() when the connection resumes
+    /// from state cached during a previous connection to the same peer.
+    ///
+    /// \param  now      The current time.
+    /// \param  min_rtt  The cached minimum RTT estimate.
+    /// \param  cwnd     The cached congestion window size, in bytes.
+    /// \param  rate     The cached send rate estimate, in bits per second.
+    virtual void Resume(const iron::Time& now, const iron::Time& min_rtt,
+                        size_t cwnd, Capacity rate);
+
+    /// \brief Determine if non-RTO timeout retransmitted packets should be
+    /// paced or not.
+    ///
+    /// \return  True if the congestion control algorithm requires pacing of
+    ///          non-RTO timeout retransmitted packets, or false if it
+    ///          requires immediate sending.
+    virtual bool UseRexmitPacing();
+
+    /// \brief Determine if the congestion window size should be used to
+    /// compute capacity estimates.
+    ///
+    /// \return  True if the congestion control algorithm's congestion window
+    ///          size should be used to compute capacity estimates, or false
+    ///          if the congestion control algorithm's rate estimate should be
+    ///          used instead.
+    virtual bool UseCongWinForCapEst();
+
+    /// \brief Determine if the oldest unacknowledged packet must be reported
+    /// for each stream or not.
+    ///
+    /// If so, then the ReportUnaPkt() method must be called with the oldest
+    /// unacknowledged packet sequence number for all streams.
+    ///
+    /// \return  True if the congestion control algorithm requires reporting
+    ///          of the oldest unacknowledged packet for all streams, or false
+    ///          if not.
+    virtual bool UseUnaPktReporting();
+
+    /// \brief Ajust the TCP friendliness/aggressiveness of the congestion
+    /// control algorithm.
+    ///
+    /// \param  num_flows  The number of TCP flows to emulate in terms of
+    ///                    TCP friendliness/aggressiveness.  The higher the
+    ///                    number, the more aggressive.  Must be greater than
+    ///                    or equal to one.
+    ///
+    /// \return  Returns true on success, or false if this setting is not
+    ///          supported by the algorithm.
+    virtual bool SetTcpFriendliness(uint32_t num_flows);
+
+    /// \brief Add a new stream.
+    ///
+    /// Must be called when a new stream is added to the connection, and
+    /// before any data packets are sent.  This is necessary in order to
+    /// include the stream in connection-level congestion control decisions.
+    ///
+    /// \param  stream_id          The stream's ID.
+    /// \param  init_send_seq_num  The initial data packet send sequence
+    ///                            number that will be used in the stream.
+    ///
+    /// \return  Returns true on success, or false if an error occurs.
+    virtual bool ActivateStream(StreamId stream_id,
+                                PktSeqNumber init_send_seq_num);
+
+    /// \brief Deactivate a stream.
+    ///
+    /// Must be called when an active stream becomes inactive.  This is
+    /// necessary in order to eliminate the stream from connection-level
+    /// congestion control decisions.
+    ///
+    /// \param  stream_id  The stream's ID.
+    ///
+    /// \return  Returns true on success, or false if an error occurs.
+    virtual bool DeactivateStream(StreamId stream_id);
+
+    /// \brief Called before the OnRttUpdate(), OnPacketLost(), and
+    /// OnPacketAcked() calls for a collection of received ACK packets (all
+    /// within a single UDP packet).
+    ///
+    /// \param  ack_time  The ACK packet collection's receive time.
+    virtual void OnAckPktProcessingStart(const iron::Time& ack_time);
+
+    /// \brief Called when an update to the round-trip-time occurs while
+    /// processing received ACK packets.
+    ///
+    /// \param  stream_id   The stream's ID.
+    /// \param  ack_time    The ACK packet's receive time.
+    /// \param  send_ts     The sender's timestamp from the ACK packet, in
+    ///                     microseconds.
+    /// \param  recv_ts     The receiver's timestamp from when the ACK packet
+    ///                     was received, in microseconds.
+    /// \param  seq_num     The lost packet's sequence number.
+    /// \param  cc_seq_num  The lost packet's congestion control sequence
+    ///                     number as assigned by OnPacketSent().
+    /// \param  rtt         The measured round-trip-time.
+    /// \param  bytes       The size of the packet being ACKed in bytes.
+    /// \param  cc_val      The CC-specific value that was stored when the
+    ///                     packet was sent or resent.
+    virtual void OnRttUpdate(StreamId stream_id, const iron::Time& ack_time,
+                             PktTimestamp send_ts, PktTimestamp recv_ts,
+                             PktSeqNumber seq_num, PktSeqNumber cc_seq_num,
+                             const iron::Time& rtt, uint32_t bytes,
+                             float cc_val);
+
+    /// \brief Called when a packet could be considered lost while processing
+    /// received ACK packets.
+    ///
+    /// The method is called repeatedly for each packet that might be
+    /// considered lost until it returns true.
+    ///
+    /// Note that the UpdateCounts() method must be called after all calls to
+    /// this method are complete for an ACK packet.
+    ///
+    /// \param  stream_id   The stream's ID.
+    /// \param  ack_time    The ACK packet's receive time.
+    /// \param  seq_num     The lost packet's sequence number.
+    /// \param  cc_seq_num  The lost packet's congestion control sequence
+    ///                     number as assigned by OnPacketSent().
+    /// \param  bytes       The lost packet's size in bytes.
+    ///
+    /// \return  True if the packet should be considered lost and scheduled
+    ///          for retransmission immediately, or false if not.
+    virtual bool OnPacketLost(StreamId stream_id, const iron::Time& ack_time,
+                              PktSeqNumber seq_num, PktSeqNumber cc_seq_num,
+                              uint32_t bytes);
+
+    /// \brief Called when a packet is ACKed (reported as received) while
+    /// processing received ACK packets.
+    ///
+    /// This method must only be called once for each packet when it is ACKed.
+    ///
+    /// Note that the UpdateCounts() method must be called after all calls to
+    /// this method are complete for an ACK packet.
+    ///
+    /// \param  stream_id   The stream's ID.
+    /// \param  ack_time    The ACK packet's receive time.
+    /// \param  seq_num     The ACKed packet's sequence number.
+    /// \param  cc_seq_num  The congestion control sequence number, as
+    ///                     assigned by OnPacketSent(), of the ACKed packet.
+    /// \param  ne_seq_num  The ACK packet's next expected sequence number.
+    /// \param  bytes       The size of the packet being ACKed in bytes.
+    virtual void OnPacketAcked(StreamId stream_id, const iron::Time& ack_time,
+                               PktSeqNumber seq_num, PktSeqNumber cc_seq_num,
+                               PktSeqNumber ne_seq_num, uint32_t bytes);
+
+    /// \brief Called when all of the OnRttUpdate(), OnPacketLost(), and
+    /// OnPacketAcked() calls are complete for a collection of received ACK
+    /// packets (all within a single UDP packet).
+    ///
+    /// \param  ack_time  The ACK packet collection's receive time.
+    virtual void OnAckPktProcessingDone(const iron::Time& ack_time);
+
+    /// \brief Called when a data packet is transmitted the first time.
+    ///
+    /// Do not call on data packet retransmissions.  This function must be
+    /// called for every new data packet sent to the wire.  It returns an
+    /// assigned congestion control sequence number for the packet.
+    ///
+    /// Note that the UpdateCounts() method must be called after this call is
+    /// complete.
+    ///
+    /// \param  stream_id  The stream's ID.
+    /// \param  send_time  The data packet's transmission time.
+    /// \param  seq_num    The data packet's sequence number.
+    /// \param  pld_bytes  The number of payload bytes transmitted.
+    /// \param  tot_bytes  The total number of bytes transmitted.
+    /// \param  cc_val     The reference to a CC-specific value that is stored
+    ///                    for the sent packet.
+    ///
+    /// \return  The data packet's assigned congestion control sequence
+    ///          number.
+    virtual PktSeqNumber OnPacketSent(StreamId stream_id,
+                                      const iron::Time& send_time,
+                                      PktSeqNumber seq_num,
+                                      uint32_t pld_bytes, uint32_t tot_bytes,
+                                      float& cc_val);
+
+    /// \brief Called when a data packet is retransmitted.
+    ///
+    /// Do not call on the original data packet transmission.
+    ///
+    /// Note that the UpdateCounts() method must be called after this call is
+    /// complete.
+    ///
+    /// \param  stream_id   The stream's ID.
+    /// \param  send_time   The data packet's retransmission time.
+    /// \param  seq_num     The data packet's sequence number.
+    /// \param  cc_seq_num  The data packet's congestion control sequence
+    ///                     number as assigned by OnPacketSent().
+    /// \param  pld_bytes   The number of payload bytes transmitted.
+    /// \param  tot_bytes   The total number of bytes transmitted.
+    /// \param  rto         True if the retransmission is due to an RTO event.
+    /// \param  orig_cc     True if this is the congestion control algorithm
+    ///                     that sent the original data packet.
+    /// \param  cc_val      The reference to a CC-specific value that is
+    ///                     stored for the resent packet.
+    virtual void OnPacketResent(StreamId stream_id,
+                                const iron::Time& send_time,
+                                PktSeqNumber seq_num, PktSeqNumber cc_seq_num,
+                                uint32_t pld_bytes, uint32_t tot_bytes,
+                                bool rto, bool orig_cc, float& cc_val);
+
+    /// \brief Called when the retransmission timeout (RTO) timer fires.
+    ///
+    /// Note that OnPacketLost() will not be called for these packets.
+    ///
+    /// \param  pkt_rexmit  Indicates if the oldest missing packet on the
+    ///                     highest priority stream has been retransmitted due
+    ///                     to the RTO timer or not.
+    virtual void OnRto(bool pkt_rexmit);
+
+    /// \brief Called when an outage is over.
+    virtual void OnOutageEnd();
+
+    /// \brief Check if a new data packet can be sent.
+    ///
+    /// This method is used to determine if the algorithm is currently
+    /// allowing or blocking the transmission of a new data packet.  Do not
+    /// call this method to check if a data packet retransmission can occur.
+    ///
+    /// Note that TimeUntilSend() should be called in order to pace data
+    /// packet transmissions.
+    ///
+    /// \param  now    The current time.
+    /// \param  bytes  The number of bytes that would be sent.
+    ///
+    /// \return  True if not currently congestion control blocked, or false
+    ///          otherwise.
+    virtual bool CanSend(const iron::Time& now, uint32_t bytes);
+
+    /// \brief Check if a fast retransmit data packet can be sent.
+    ///
+    /// This method is used to determine if the algorithm is currently
+    /// allowing or blocking the fast retransmission of a data packet.  Do not
+    /// call this method to check if a new data packet transmission can occur.
+    ///
+    /// Note that if UseRexmitPacing() returns true, then TimeUntilSend()
+    /// should be called in order to pace the retransmission.
+    ///
+    /// \param  now      The current time.
+    /// \param  bytes    The number of bytes that would be resent.
+    /// \param  orig_cc  True if this is the congestion control algorithm that
+    ///                  sent the original data packet.
+    ///
+    /// \return  True if not currently congestion control blocked, or false
+    ///          otherwise.
+    virtual bool CanResend(const iron::Time& now, uint32_t bytes,
+                           bool orig_cc);
+
+    /// \brief Calculate the time of the next data packet transmission.
+    ///
+    /// The method is used to implement send pacing of data packets.  If the
+    /// returned time is zero, then a transmission can occur immediately.
+    /// Otherwise, the next transmission must wait for the returned time to
+    /// elapse first.  This method will never return an infinite time.
+    ///
+    /// This method should always be called for new data packets, and should
+    /// only be called for non-RTO timeout retransmitted data packets if
+    /// UseRexmitPacing() returns true.
+    ///
+    /// \param  now  The current time.
+    ///
+    /// \return  The amount of time until the next send can occur.
+    virtual iron::Time TimeUntilSend(const iron::Time& now);
+
+    /// \brief Get the current send pacing rate.
+    ///
+    /// May be zero if the rate is unknown.
+    ///
+    /// Note that the send pacing rate might be higher than the send rate for
+    /// window-based congestion controls to ensure that the congestion window
+    /// gets filled completely.
+    ///
+    /// \return  The current send pacing rate, in bits per second.  May be
+    ///          zero.
+    virtual Capacity SendPacingRate();
+
+    /// \brief Get the current send rate.
+    ///
+    /// \return  The current send rate, in bits per second.
+    virtual Capacity SendRate();
+
+    /// \brief Get any optional congestion control parameters that must be
+    /// transferred to the other end of the connection.
+    ///
+    /// These parameters are exhanged for synchronization of the congestion
+    /// control algorithm.  They are sent best effort.
+    ///
+    /// \param  seq_num    A reference where the sequence number for the
+    ///                    message is placed when true is returned.
+    /// \param  cc_params  A reference where the congestion control parameters
+    ///                    to be sent are placed when true is returned.
+    ///
+    /// \return  True if there are congestion control parameters to be sent.
+    virtual bool GetSyncParams(uint16_t& seq_num, uint32_t& cc_params);
+
+    /// \brief Process the received congestion control parameters from the
+    /// other end of the connection for synchronization of the algorithm.
+    ///
+    /// These parameters are exhanged for synchronization of the congestion
+    /// control algorithm.  They are sent best effort.
+    ///
+    /// \param  now        The current time.
+    /// \param  seq_num    The received sequence number.
+    /// \param  cc_params  The received congestion control parameters.
+    virtual void ProcessSyncParams(const iron::Time& now, uint16_t seq_num,
+                                   uint32_t cc_params);
+
+    /// \brief Process the received congestion control packet train packet
+    /// header from the peer.
+    ///
+    /// These parameters are exhanged for characterizing the channel to the
+    /// peer.  They are sent best effort.
+    ///
+    /// \param  now  The current time.
+    /// \param  hdr  A reference to the received congestion control packet
+    ///              train header.
+    virtual void ProcessCcPktTrain(const iron::Time& now,
+                                   CcPktTrainHeader& hdr);
+
+    /// \brief Queries if the congestion control algorithm is currently in
+    /// slow start.
+    ///
+    /// When true, the CapacityEstimate() is expected to be too low.
+    ///
+    /// \return  True if the congestion control algorithm is currently in slow
+    ///          start, or false otherwise.
+    virtual bool InSlowStart();
+
+    /// \brief Queries if the congestion control algorithm is currently in
+    /// fast recovery.
+    ///
+    /// \return  True if the congestion control algorithm is currently in fast
+    ///          recovery, or false otherwise.
+    virtual bool InRecovery();
+
+    /// \brief Get the current congestion window size, in bytes.
+    ///
+    /// \return  The current congestion window size, in bytes.  Note, this is
+    ///          not the *available* window.  Some congestion control
+    ///          algorithms may not use a congestion window and will return 0.
+    virtual uint32_t GetCongestionWindow();
+
+    /// \brief Get the current slow start threshold, in bytes.
+    ///
+    /// \return  The size of the slow start congestion window, in bytes, aka
+    ///          ssthresh.  Some congestion control algorithms do not define a
+    ///          slow start threshold and will return 0.
+    virtual uint32_t GetSlowStartThreshold();
+
+    /// \brief Get the congestion control type.
+    ///
+    /// \return  The congestion control type.
+    virtual CongCtrlAlg GetCongestionControlType();
+
+    /// \brief Close the congestion control object.
+    virtual void Close();
+
+   private:
+
+    /// \brief Copy constructor.
+    Bbr(const Bbr& bbr);
+
+    /// \brief Assignment operator.
+    Bbr& operator=(const Bbr& bbr);
+
+    /// The BBR states.
+    enum BbrState
+    {
+      STARTUP,
+      DRAIN,
+      PROBE_BW,
+      PROBE_RTT
+    };
+
+    /// \brief The per-packet delivery state recorded when a packet is sent,
+    /// used for generating delivery rate samples when it is ACKed.
+    struct PacketData
+    {
+      PacketData();
+      virtual ~PacketData();
+
+      /// The flag recording if the packet is sent and not yet ACKed.
+      bool        in_flight;
+
+      /// The flag recording if the connection was application limited when
+      /// the packet was sent.
+      bool        app_limited;
+
+      /// The packet size, including the packet overhead, in bytes.
+      uint32_t    bytes;
+
+      /// The connection's delivered byte count when the packet was sent.
+      uint64_t    delivered;
+
+      /// The packet's send time.
+      iron::Time  send_time;
+
+      /// The connection's delivered time when the packet was sent.
+      iron::Time  delivered_time;
+
+      /// The connection's first sent time when the packet was sent.
+      iron::Time  first_sent_time;
+    };
+
+    /// \brief A windowed maximum filter for the bottleneck bandwidth.
+    ///
+    /// Tracks the best, second best, and third best maximum samples over a
+    /// window measured in round trips using the algorithm by Kathleen
+    /// Nichols.
+    struct MaxBwFilter
+    {
+      MaxBwFilter();
+      virtual ~MaxBwFilter();
+
+      /// \brief Reset the filter to a single sample.
+      ///
+      /// \param  bw     The bandwidth sample, in bits per second.
+      /// \param  round  The round trip count for the sample.
+      void Reset(double bw, uint64_t round);
+
+      /// \brief Add a new sample to the filter.
+      ///
+      /// \param  bw      The bandwidth sample, in bits per second.
+      /// \param  round   The round trip count for the sample.
+      /// \param  window  The filter window length, in round trips.
+      void Update(double bw, uint64_t round, uint64_t window);
+
+      /// \brief Get the current maximum bandwidth estimate.
+      ///
+      /// \return  The maximum bandwidth estimate, in bits per second.
+      inline double GetBest() const
+      {
+        return est[0].bw;
+      }
+
+      /// The three samples, from best to third best.
+      struct
+      {
+        double    bw;
+        uint64_t  round;
+      }  est[3];
+    };
+
+    /// \brief Update the model and the control parameters once a collection
+    /// of received ACK packets has been processed.
+    ///
+    /// \param  now  The current time.
+    void UpdateModelAndState(const iron::Time& now);
+
+    /// \brief Update the round trip counter using the current rate sample.
+    void UpdateRound();
+
+    /// \brief Update the bottleneck bandwidth filter using the current rate
+    /// sample.
+    ///
+    /// \param  now  The current time.
+    void UpdateBw(const iron::Time& now);
+
+    /// \brief Advance the pacing gain cycle when in PROBE_BW if needed.
+    ///
+    /// \param  now  The current time.
+    void UpdateCyclePhase(const iron::Time& now);
+
+    /// \brief Check if the bottleneck bandwidth has stopped growing while in
+    /// STARTUP.
+    void CheckFullPipe();
+
+    /// \brief Leave STARTUP for DRAIN, and leave DRAIN for PROBE_BW, when
+    /// appropriate.
+    ///
+    /// \param  now  The current time.
+    void CheckDrain(const iron::Time& now);
+
+    /// \brief Enter, maintain, and exit PROBE_RTT as needed.
+    ///
+    /// \param  now  The current time.
+    void UpdateMinRttAndProbeRtt(const iron::Time& now);
+
+    /// \brief Enter the PROBE_BW state.
+    ///
+    /// \param  now  The current time.
+    void EnterProbeBw(const iron::Time& now);
+
+    /// \brief Update the pacing rate from the model.
+    void SetPacingRate();
+
+    /// \brief Update the congestion window from the model.
+    void SetCwnd();
+
+    /// \brief Compute a multiple of the estimated bandwidth-delay product.
+    ///
+    /// \param  gain  The multiplier to use.
+    ///
+    /// \return  The scaled bandwidth-delay product, in bytes.
+    int64_t ComputeBdp(double gain) const;
+
+    /// \brief Get a string for a BBR state.
+    ///
+    /// \param  state  The BBR state.
+    ///
+    /// \return  The state string.
+    static const char* StateToString(BbrState state);
+
+    /// The RTT manager.
+    RttManager&   rtt_mgr_;
+
+    /// The connected flag.
+    bool          connected_;
+
+    /// The current BBR state.
+    BbrState      state_;
+
+    /// The circular array of per-packet delivery state.
+    PacketData*   pkt_data_;
+
+    /// The next congestion control sequence number to be sent.
+    PktSeqNumber  nxt_cc_seq_num_;
+
+    /// The total number of bytes delivered to the peer.
+    uint64_t      delivered_;
+
+    /// The time when delivered_ was last updated.
+    iron::Time    delivered_time_;
+
+    /// The send time of the most recently ACKed packet.
+    iron::Time    first_sent_time_;
+
+    /// The delivered_ value that ends the current application limited
+    /// period, or zero if the connection is not application limited.
+    uint64_t      app_limited_until_;
+
+    /// The flag recording if the current rate sample has any ACKed packets.
+    bool          rs_valid_;
+
+    /// The rate sample's delivered_ value when the most recently sent ACKed
+    /// packet was sent.
+    uint64_t      rs_prior_delivered_;
+
+    /// The rate sample's delivered_time_ value when the most recently sent
+    /// ACKed packet was sent.
+    iron::Time    rs_prior_time_;
+
+    /// The rate sample's send interval.
+    iron::Time    rs_send_elapsed_;
+
+    /// The rate sample's application limited flag.
+    bool          rs_app_limited_;
+
+    /// The number of bytes ACKed in the current rate sample.
+    int64_t       rs_acked_bytes_;
+
+    /// The flag recording if a packet loss was reported in the current
+    /// collection of received ACK packets.
+    bool          rs_loss_;
+
+    /// The bottleneck bandwidth filter.
+    MaxBwFilter   max_bw_;
+
+    /// The number of round trips so far.
+    uint64_t      round_count_;
+
+    /// The delivered_ value that marks the end of the current round trip.
+    uint64_t      next_round_delivered_;
+
+    /// The flag recording if the current rate sample started a new round.
+    bool          round_start_;
+
+    /// The round-trip propagation time estimate.
+    iron::Time    min_rtt_;
+
+    /// The time when min_rtt_ was last updated.
+    iron::Time    min_rtt_stamp_;
+
+    /// The flag recording if the min_rtt_ estimate has expired.
+    bool          min_rtt_expired_;
+
+    /// The current pacing gain.
+    double        pacing_gain_;
+
+    /// The current congestion window gain.
+    double        cwnd_gain_;
+
+    /// The current index into the pacing gain cycle.
+    size_t        cycle_index_;
+
+    /// The time when the current pacing gain cycle phase started.
+    iron::Time    cycle_stamp_;
+
+    /// The flag recording if the bottleneck bandwidth has been reached.
+    bool          full_bw_reached_;
+
+    /// The bottleneck bandwidth at the last STARTUP growth check, in bits
+    /// per second.
+    double        full_bw_;
+
+    /// The number of rounds without significant bandwidth growth.
+    uint32_t      full_bw_cnt_;
+
+    /// The time when PROBE_RTT may be exited, or zero if not yet known.
+    iron::Time    probe_rtt_done_stamp_;
+
+    /// The flag recording if a full round trip has passed in PROBE_RTT.
+    bool          probe_rtt_round_done_;
+
+    /// The congestion window before PROBE_RTT was entered, in bytes.
+    int64_t       prior_cwnd_;
+
+    /// The current pacing rate, in bits per second.
+    double        pacing_rate_bps_;
+
+    /// The congestion window size in bytes.
+    int64_t       cwnd_;
+
+  }; // end class Bbr
+
+}; // namespace sliq
+
+#endif // IRON_SLIQ_CC_BBR_H
@@ -135,6 +135,26 @@ void CubicBytes::Connected(const Time& now, const Time& rtt)
   return;
 }
 
+//============================================================================
+void CubicBytes::Resume(const Time& now, const Time& min_rtt, size_t cwnd,
+                        Capacity rate)
+{
+  // Start from one-half of the cached congestion window, and let slow start
+  // quickly climb back up to the cached congestion window if the path still
+  // supports it.
+  ssthresh_ = ((cwnd < min_cwnd_) ? min_cwnd_ :
+               ((cwnd > max_cwnd_) ? max_cwnd_ : cwnd));
+  cwnd_     = (ssthresh_ / 2);
+
+  if (cwnd_ < kInitCongCtrlWindowBytes)
+  {
+    cwnd_ = kInitCongCtrlWindowBytes;
+  }
+
+  LogD(kClassName, __func__, "Conn %" PRIEndptId ": Resumed with cwnd %zu "
+       "ssthresh %zu.\n", conn_id_, cwnd_, ssthresh_);
+}
+
 //============================================================================
 bool CubicBytes::UseRexmitPacing()
 {
@@ -36,6 +36,7 @@
 /* IRON: end */
 
 #include "sliq_cc_interface.h"
+#include "sliq_cc_bbr.h"
 #include "sliq_cc_copa.h"
 #include "sliq_cc_copa2.h"
 #include "sliq_cc_copa3.h"
@@ -45,6 +46,7 @@
 
 #include "unused.h"
 
+using ::sliq::Bbr;
 using ::sliq::CongCtrlInterface;
 using ::sliq::CopaBeta1;
 using ::sliq::CopaBeta2;
@@ -55,6 +57,7 @@ using ::sliq::FixedRate;
 using ::iron::Log;
 using ::iron::PacketPool;
 using ::iron::RNG;
+using ::iron::Time;
 using ::iron::Timer;
 
 
@@ -101,6 +104,10 @@ CongCtrlInterface* CongCtrlInterface::Create(
                                        framer, packet_pool, timer);
       break;
 
+    case TCP_BBR_CC:
+      cc_alg = new (std::nothrow) Bbr(conn_id, is_client, rtt_mgr);
+      break;
+
     case FIXED_RATE_TEST_CC:
       cc_alg = new (std::nothrow) FixedRate(conn_id, is_client);
       break;
@@ -141,6 +148,11 @@ void CongCtrlInterface::ReportUnaPkt(StreamId stream_id, bool has_una_pkt,
                                      PktSeqNumber una_cc_seq_num)
 {}
 
+//============================================================================
+void CongCtrlInterface::Resume(const Time& now, const Time& min_rtt,
+                               size_t cwnd, Capacity rate)
+{}
+
 //============================================================================
 bool CongCtrlInterface::RequireFastRto()
 {
@@ -110,6 +110,21 @@ namespace sliq
     /// \param  rtt  The initial RTT estimate from the connection handshake.
     virtual void Connected(const iron::Time& now, const iron::Time& rtt) = 0;
 
+    /// \brief Called right after Connected() when the connection resumes
+    /// from state cached during a previous connection to the same peer.
+    ///
+    /// The values are those last observed on the previous connection, and
+    /// the algorithm should start from a conservatively scaled version of
+    /// them.  Algorithms that do not support resumption ignore the call and
+    /// start from their defaults.
+    ///
+    /// \param  now      The current time.
+    /// \param  min_rtt  The cached minimum RTT estimate.
+    /// \param  cwnd     The cached congestion window size, in bytes.
+    /// \param  rate     The cached send rate estimate, in bits per second.
+    virtual void Resume(const iron::Time& now, const iron::Time& min_rtt,
+                        size_t cwnd, Capacity rate);
+
     /// \brief Determine if non-RTO timeout retransmitted packets should be
     /// paced or not.
     ///
@@ -97,6 +97,13 @@ void PacingSender::Connected(const Time& now, const Time& rtt)
   cc_alg_->Connected(now, rtt);
 }
 
+//============================================================================
+void PacingSender::Resume(const Time& now, const Time& min_rtt, size_t cwnd,
+                          Capacity rate)
+{
+  cc_alg_->Resume(now, min_rtt, cwnd, rate);
+}
+
 //============================================================================
 bool PacingSender::UseRexmitPacing()
 {
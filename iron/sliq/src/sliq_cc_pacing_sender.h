@@ -90,6 +90,16 @@ namespace sliq
     /// \param  rtt  The initial RTT estimate from the connection handshake.
     virtual void Connected(const iron::Time& now, const iron::Time& rtt);
 
+    /// \brief Called right after Connected() when the connection resumes
+    /// from state cached during a previous connection to the same peer.
+    ///
+    /// \param  now      The current time.
+    /// \param  min_rtt  The cached minimum RTT estimate.
+    /// \param  cwnd     The cached congestion window size, in bytes.
+    /// \param  rate     The cached send rate estimate, in bits per second.
+    virtual void Resume(const iron::Time& now, const iron::Time& min_rtt,
+                        size_t cwnd, Capacity rate);
+
     /// \brief Determine if non-RTO timeout retransmitted packets should be
     /// paced or not.
     ///
@@ -118,6 +118,14 @@ namespace
   /// The ACK timer minimum interval, in milliseconds.
   const int           kMinAckTimerMsec = 1;
 
+  /// The target number of ACK packets per RTT when using adaptive ACK
+  /// frequency.
+  const double        kAckFreqAcksPerRtt = 8.0;
+
+  /// The interval for resending unchanged adaptive ACK frequency settings,
+  /// in seconds.
+  const double        kAckFreqRefreshSec = 1.0;
+
   /// The maximum connection establishment RTT estimate value, in
   /// microseconds.
   const PktTimestamp  kConnEstabMaxRttUsec = 1500000;
@@ -154,6 +162,22 @@ namespace
   /// The maximum Copa Beta 1 constant delta value.
   const double        kMaxCopaBeta1ConstDelta = 1.0;
 
+  /// The maximum earliest departure time (EDT) send pacing horizon, in
+  /// seconds.  Longer horizons hold too many packets in the kernel.
+  const double        kMaxEdtHorizonSec = 0.1;
+
+  /// The interval, in seconds, between the data packets that probe a failed
+  /// path for recovery.
+  const double        kPathProbeIntervalSec = 0.25;
+
+  /// The maximum age, in seconds, of cached state that a fast reconnection
+  /// may resume from.
+  const double        kResumeMaxAgeSec = 120.0;
+
+  /// The scale factor applied to the cached capacity estimates reported when
+  /// a fast reconnection resumes from cached state.
+  const double        kResumeCapEstScale = 0.5;
+
   /// Connection handshake header message tag for "CH" (client hello).
   const MsgTag        kClientHelloTag = 0x4843;
 
@@ -229,6 +253,7 @@ Connection::Connection(SliqApp& app, SocketManager& socket_mgr,
       client_id_(0),
       socket_id_(-1),
       is_write_blocked_(false),
+      write_blocked_socket_id_(-1),
       is_in_rto_(false),
       is_in_outage_(false),
       outage_stream_id_(0),
@@ -261,6 +286,14 @@ Connection::Connection(SliqApp& app, SocketManager& socket_mgr,
       rtt_pdd_samples_(NULL),
       rtl_owd_(),
       ltr_owd_(),
+      ack_freq_(),
+      ack_coal_(),
+      compact_hdrs_(false),
+      num_paths_(1),
+      paths_(),
+      resume_(false),
+      resume_token_(0),
+      resume_peer_(),
       do_close_conn_callback_(false),
       stats_rcv_rpc_hdr_(),
       stats_rcv_rpc_trigger_cnt_(0),
@@ -270,6 +303,17 @@ Connection::Connection(SliqApp& app, SocketManager& socket_mgr,
       stats_snd_per_update_time_(),
       stats_local_per_(0.0),
       stats_last_rpc_(0),
+      stats_send_timer_wakeups_(0),
+      stats_edt_early_sends_(0),
+      stats_ack_pkts_sent_(0),
+      stats_ack_batches_(0),
+      stats_ack_batch_pkts_(0),
+      stats_ack_batch_hdrs_(0),
+      stats_ack_batch_cc_saved_(0),
+      stats_snd_hdr_bytes_(0),
+      stats_snd_pld_bytes_(0),
+      edt_horizon_(),
+      edt_depart_delay_(),
       do_callbacks_(true),
       close_reason_(SLIQ_CONN_NORMAL_CLOSE),
       next_conn_seq_num_(1),
@@ -292,6 +336,72 @@ Connection::~Connection()
   LogD(kClassName, __func__, "Destroying connection object %p.\n", this);
 #endif
 
+  // Report the send pacing wakeups saved by EDT send pacing.
+  if (!edt_horizon_.IsZero())
+  {
+    LogI(kClassName, __func__, "Conn %" PRISocketId ": EDT send pacing "
+         "early sends (wakeups saved) %" PRIu64 ", send timer wakeups %"
+         PRIu64 ".\n", socket_id_, stats_edt_early_sends_,
+         stats_send_timer_wakeups_);
+  }
+
+  // Report the ACK packets sent per data packet received when the peer
+  // requested adaptive ACK frequency.
+  if (ack_freq_.init_)
+  {
+    LogI(kClassName, __func__, "Conn %" PRISocketId ": ACK packets sent %"
+         PRIu64 ", data packets received %" PRIPktCount ", ACKs per data "
+         "packet %f.\n", socket_id_, stats_ack_pkts_sent_,
+         stats_rcv_rpc_hdr_.rcvd_data_pkt_count, StatsGetAcksPerDataPkt());
+  }
+
+  // Report the coalesced ACK processing statistics.
+  if (stats_ack_batches_ > 0)
+  {
+    LogI(kClassName, __func__, "Conn %" PRISocketId ": Coalesced ACK "
+         "batches %" PRIu64 ", ACK packets %" PRIu64 ", ACK headers %" PRIu64
+         ", ACK packets per batch %f, CC cycles saved %" PRIu64 ".\n",
+         socket_id_, stats_ack_batches_, stats_ack_batch_pkts_,
+         stats_ack_batch_hdrs_,
+         (static_cast<double>(stats_ack_batch_pkts_) /
+          static_cast<double>(stats_ack_batches_)),
+         stats_ack_batch_cc_saved_);
+  }
+
+  // Report the SLIQ header overhead of the data and ACK packets sent.
+  if (stats_snd_pld_bytes_ > 0)
+  {
+    LogI(kClassName, __func__, "Conn %" PRISocketId ": Compact headers %s, "
+         "header bytes sent %" PRIu64 ", payload bytes sent %" PRIu64
+         ", header bytes per payload byte %f.\n", socket_id_,
+         (compact_hdrs_ ? "on" : "off"), stats_snd_hdr_bytes_,
+         stats_snd_pld_bytes_, StatsGetHdrBytesPerPldByte());
+  }
+
+  // Report the data packets sent on each path.
+  if (num_paths_ > 1)
+  {
+    for (size_t path = 0; path < num_paths_; ++path)
+    {
+      LogI(kClassName, __func__, "Conn %" PRISocketId ": Path %zu data "
+           "packets sent %" PRIu64 ".\n", socket_id_, path,
+           paths_[path].pkts_sent_);
+    }
+  }
+
+  // Close any open path sockets.
+  for (size_t path = 1; path < num_paths_; ++path)
+  {
+    if (paths_[path].socket_id_ >= 0)
+    {
+      if (!socket_mgr_.Close(paths_[path].socket_id_))
+      {
+        LogE(kClassName, __func__, "Error closing path socket.\n");
+      }
+      paths_[path].socket_id_ = -1;
+    }
+  }
+
   // Close any open socket.
   if (socket_id_ >= 0)
   {
@@ -687,11 +797,30 @@ bool Connection::ConnectToServer(const Ipv4Endpoint& server_address)
   }
 
   // Update the connection state.
-  state_      = UNCONNECTED;
-  peer_addr_  = server_address;
-  num_hellos_ = 0;
+  state_        = UNCONNECTED;
+  peer_addr_    = server_address;
+  num_hellos_   = 0;
+  compact_hdrs_ = app_.compact_headers();
   hello_timer_.Clear();
 
+  // Ask to resume from any recent state cached for the server.  The token is
+  // sent even if the state cannot be used, so the server can keep it.
+  resume_        = false;
+  resume_token_  = 0;
+  resume_peer_   = server_address;
+
+  if (app_.fast_reconnect())
+  {
+    ConnectionManager::ResumeInfo*  info =
+      conn_mgr_.GetResumeInfo(resume_peer_);
+
+    if (info != NULL)
+    {
+      resume_       = HasUsableResumeState(Time::Now());
+      resume_token_ = info->token_;
+    }
+  }
+
   // Set a timer for how long to wait for a response from the server.
   if (!StartClientHelloTimer())
   {
@@ -722,6 +851,95 @@ bool Connection::ConnectToServer(const Ipv4Endpoint& server_address)
   return true;
 }
 
+//============================================================================
+bool Connection::AddPath(const Ipv4Endpoint& local_addr,
+                         const Ipv4Endpoint& remote_addr,
+                         SocketId& path_socket_id)
+{
+  // Only data connections may have multiple paths.
+  if (((type_ != CLIENT_DATA) && (type_ != SERVER_DATA)) || (!initialized_))
+  {
+    LogE(kClassName, __func__, "Conn %" PRISocketId ": Error, cannot add a "
+         "path in current connection state.\n", socket_id_);
+    return false;
+  }
+
+  if (num_paths_ >= SliqApp::kMaxCcAlgPerConn)
+  {
+    LogE(kClassName, __func__, "Conn %" PRISocketId ": Error, maximum number "
+         "of paths (%zu) reached.\n", socket_id_, SliqApp::kMaxCcAlgPerConn);
+    return false;
+  }
+
+  PathInfo&  path_info = paths_[num_paths_];
+
+  // Open a UDP socket.
+  SocketId  sock = socket_mgr_.CreateUdpSocket(kFdEventRead
+#ifdef SLIQ_NS3
+                                               , this
+#endif // SLIQ_NS3
+                                               );
+
+  if (sock < 0)
+  {
+    LogE(kClassName, __func__, "Conn %" PRISocketId ": Error opening path "
+         "UDP socket.\n", socket_id_);
+    return false;
+  }
+
+  // Set the necessary socket options, bind the socket to the local address,
+  // and connect it to the remote address.
+  if ((!socket_mgr_.SetRecvBufferSize(sock, kSocketBufferSize)) ||
+      (!socket_mgr_.SetSendBufferSize(sock, kSocketBufferSize)) ||
+      (!socket_mgr_.EnableReceiveTimestamps(sock)) ||
+      (!socket_mgr_.EnablePortReuse(sock)) ||
+      (!socket_mgr_.Bind(sock, local_addr)) ||
+      (!socket_mgr_.Connect(sock, remote_addr)) ||
+      (!socket_mgr_.GetLocalAddress(sock, path_info.self_addr_)))
+  {
+    LogE(kClassName, __func__, "Conn %" PRISocketId ": Error setting up path "
+         "UDP socket from %s to %s.\n", socket_id_,
+         local_addr.ToString().c_str(), remote_addr.ToString().c_str());
+    socket_mgr_.Close(sock);
+    return false;
+  }
+
+  // The new socket must support transmit times if EDT send pacing is in
+  // use.
+  if ((!edt_horizon_.IsZero()) && (!socket_mgr_.EnableTxTime(sock)))
+  {
+    LogE(kClassName, __func__, "Conn %" PRISocketId ": Error enabling EDT "
+         "send pacing on path UDP socket.\n", socket_id_);
+    socket_mgr_.Close(sock);
+    return false;
+  }
+
+  path_info.socket_id_ = sock;
+  path_info.peer_addr_ = remote_addr;
+  path_info.is_failed_ = false;
+  path_info.unans_send_time_.Zero();
+  path_info.next_probe_time_.Zero();
+  path_socket_id       = sock;
+  ++num_paths_;
+
+  // Notify the application.
+  app_.ProcessFileDescriptorChange();
+
+  LogA(kClassName, __func__, "Conn %" PRISocketId ": Added path %zu from %s "
+       "to %s.\n", socket_id_, (num_paths_ - 1),
+       path_info.self_addr_.ToString().c_str(),
+       remote_addr.ToString().c_str());
+
+  if ((cc_algs_.num_cc_alg > 0) && (cc_algs_.num_cc_alg < num_paths_))
+  {
+    LogW(kClassName, __func__, "Conn %" PRISocketId ": Warning, %zu "
+         "congestion control algorithms for %zu paths, some paths will not "
+         "be used.\n", socket_id_, cc_algs_.num_cc_alg, num_paths_);
+  }
+
+  return true;
+}
+
 //============================================================================
 bool Connection::AddStream(StreamId stream_id, Priority prio,
                            const Reliability& rel, DeliveryMode del_mode)
@@ -838,8 +1056,100 @@ bool Connection::ConfigureTcpFriendliness(uint32_t num_flows)
 //============================================================================
 void Connection::ConfigureRttOutlierRejection(bool enable_rtt_or)
 {
-  // Change the setting in the RTT manager.
+  // Change the setting in the RTT managers.
   rtt_mgr_.ConfigureRttOutlierRejection(enable_rtt_or);
+
+  for (size_t path = 0; path < SliqApp::kMaxCcAlgPerConn; ++path)
+  {
+    paths_[path].rtt_mgr_.ConfigureRttOutlierRejection(enable_rtt_or);
+  }
+}
+
+//============================================================================
+void Connection::UpdatePathRtt(const Time& now, CcId cc_id, const Time& rtt)
+{
+  if (num_paths_ > 1)
+  {
+    paths_[GetCcPath(cc_id)].rtt_mgr_.UpdateRtt(now, socket_id_, rtt);
+    return;
+  }
+
+  for (size_t i = 0; i < cc_algs_.num_cc_alg; ++i)
+  {
+    paths_[i].rtt_mgr_.UpdateRtt(now, socket_id_, rtt);
+  }
+}
+
+//============================================================================
+bool Connection::ConfigureEdtPacing(double horizon_sec)
+{
+  if (((type_ != CLIENT_DATA) && (type_ != SERVER_DATA)) || (!initialized_))
+  {
+    return false;
+  }
+
+  if (horizon_sec <= 0.0)
+  {
+    edt_horizon_.Zero();
+    return true;
+  }
+
+  if (horizon_sec > kMaxEdtHorizonSec)
+  {
+    LogE(kClassName, __func__, "Conn %" PRISocketId ": Invalid EDT horizon "
+         "%f seconds.\n", socket_id_, horizon_sec);
+    return false;
+  }
+
+  // The socket must support transmit times.  Otherwise, the send pacing
+  // timers remain in use.
+  for (size_t path = 0; path < num_paths_; ++path)
+  {
+    if (!socket_mgr_.EnableTxTime(GetPathSocketId(path)))
+    {
+      LogW(kClassName, __func__, "Conn %" PRISocketId ": EDT send pacing "
+           "not available, using send pacing timers.\n", socket_id_);
+      return false;
+    }
+  }
+
+  edt_horizon_ = Time(horizon_sec);
+
+  LogI(kClassName, __func__, "Conn %" PRISocketId ": Using EDT send pacing "
+       "with a %s horizon.\n", socket_id_, edt_horizon_.ToString().c_str());
+
+  return true;
+}
+
+//============================================================================
+bool Connection::ConfigureAckFrequency(bool enable)
+{
+  if (((type_ != CLIENT_DATA) && (type_ != SERVER_DATA)) || (!initialized_))
+  {
+    return false;
+  }
+
+  // When disabled after being enabled, the fixed ACK policy values are
+  // advertised to the peer once by AddAckFreq().
+  ack_freq_.enable_ = enable;
+
+  return true;
+}
+
+//============================================================================
+bool Connection::ConfigureAckCoalescing(bool enable)
+{
+  if (((type_ != CLIENT_DATA) && (type_ != SERVER_DATA)) || (!initialized_))
+  {
+    return false;
+  }
+
+  // Any ACK headers waiting for completion are completed by the receive
+  // batch that is currently being processed, so the setting can change at
+  // any time.
+  ack_coal_.enable_ = enable;
+
+  return true;
 }
 
 //============================================================================
@@ -941,12 +1251,13 @@ bool Connection::Send(StreamId stream_id, Packet* data)
 //============================================================================
 void Connection::ServiceFileDescriptor(int fd, FdEvent event)
 {
-  // Verify the file descriptor.
-  if (fd != socket_id_)
+  // Verify the file descriptor, and find the path that it is for.
+  size_t  path = 0;
+
+  if ((fd != socket_id_) && (!GetPathIndex(fd, path)))
   {
     LogE(kClassName, __func__, "Conn %" PRISocketId ": File descriptor %d "
-         "does not match socket ID %" PRISocketId ".\n", socket_id_, fd,
-         socket_id_);
+         "does not match any path socket ID.\n", socket_id_, fd);
     return;
   }
 
@@ -972,14 +1283,14 @@ void Connection::ServiceFileDescriptor(int fd, FdEvent event)
     else
     {
       // The socket is blocked again.
-      SetWriteBlocked(reblocked_stream_id);
+      SetWriteBlocked(reblocked_stream_id, write_blocked_socket_id_);
     }
   }
 
   // Handle the read event.
   if ((event == kFdEventRead) || (event == kFdEventReadWrite))
   {
-    ReceivePackets();
+    ReceivePackets(path);
   }
 
   // Do any pending reentrant callbacks.
@@ -1034,6 +1345,45 @@ bool Connection::GetTransmitQueueSizeInPackets(StreamId stream_id,
   return true;
 }
 
+//============================================================================
+bool Connection::GetSendStats(StreamId stream_id, SendStats& stats)
+{
+  if (((type_ != CLIENT_DATA) && (type_ != SERVER_DATA)) || (!initialized_) ||
+      (state_ != CONNECTED))
+  {
+    return false;
+  }
+
+  // Find the stream.
+  Stream*  stream = GetStream(stream_id);
+
+  if (stream == NULL)
+  {
+    return false;
+  }
+
+  // Call into the stream.
+  stream->GetSendStats(stats);
+
+  return true;
+}
+
+//============================================================================
+bool Connection::GetAckBatchStats(AckBatchStats& stats)
+{
+  if (((type_ != CLIENT_DATA) && (type_ != SERVER_DATA)) || (!initialized_))
+  {
+    return false;
+  }
+
+  stats.batches         = static_cast<size_t>(stats_ack_batches_);
+  stats.ack_pkts        = static_cast<size_t>(stats_ack_batch_pkts_);
+  stats.acks            = static_cast<size_t>(stats_ack_batch_hdrs_);
+  stats.cc_cycles_saved = static_cast<size_t>(stats_ack_batch_cc_saved_);
+
+  return true;
+}
+
 //============================================================================
 bool Connection::InitiateCloseStream(StreamId stream_id, bool& fully_closed)
 {
@@ -1231,12 +1581,22 @@ void Connection::CloseStreamCallback(StreamId stream_id, bool fully_closed)
 //============================================================================
 bool Connection::CanSend(const Time& now, size_t bytes, CcId& cc_id)
 {
+  // Any departure delay from a previous call has been used or abandoned.
+  edt_depart_delay_.Zero();
+
   // If currently in an outage, then the send should not happen.
   if (is_in_outage_)
   {
     return false;
   }
 
+  // With multiple paths, every congestion control algorithm that allows the
+  // send is a candidate, and the one whose path has the earliest expected
+  // delivery time wins.
+  bool    found     = false;
+  double  best_time = 0.0;
+  Time    best_delay;
+
   // Check each of the congestion control algorithms.
   for (size_t i = 0; i < cc_algs_.num_cc_alg; ++i)
   {
@@ -1250,6 +1610,13 @@ bool Connection::CanSend(const Time& now, size_t bytes, CcId& cc_id)
       continue;
     }
 
+    // Skip a failed path until it is time to probe it.
+    if ((num_paths_ > 1) && IsPathFailed(now, GetCcPath(i)) &&
+        (now < paths_[GetCcPath(i)].next_probe_time_))
+    {
+      continue;
+    }
+
     // Get the amount of delay before a send can occur for this congestion
     // control algorithm.
     Time  delay(cc_alg->TimeUntilSend(now));
@@ -1264,8 +1631,9 @@ bool Connection::CanSend(const Time& now, size_t bytes, CcId& cc_id)
     }
 
     // If the congestion control algorithm requires a delay, then we cannot
-    // send this packet now.
-    if (!delay.IsZero())
+    // send this packet now, unless EDT send pacing can release it early.
+    if ((!delay.IsZero()) && (edt_horizon_.IsZero() ||
+                              (delay > edt_horizon_)))
     {
       // Use the send pacing timer to wake up when a packet can be sent, and
       // continue the search.
@@ -1281,6 +1649,35 @@ bool Connection::CanSend(const Time& now, size_t bytes, CcId& cc_id)
       continue;
     }
 
+    if (num_paths_ > 1)
+    {
+      // The expected delivery time is the departure delay, plus the time to
+      // send the packet at the pacing rate, plus the path's one-way delay.
+      Capacity  rate      = cc_alg->SendPacingRate();
+      double    dlvr_time = (delay.ToDouble() + (0.5 * paths_[GetCcPath(i)].
+                                                 rtt_mgr_.smoothed_rtt().
+                                                 ToDouble()));
+
+      if (rate > 0)
+      {
+        dlvr_time += ((static_cast<double>(bytes) * 8.0) /
+                      static_cast<double>(rate));
+      }
+
+      if ((!found) || (dlvr_time < best_time))
+      {
+        found      = true;
+        best_time  = dlvr_time;
+        best_delay = delay;
+        cc_id      = static_cast<CcId>(i);
+      }
+
+      continue;
+    }
+
+    // Record the departure delay for the packet.
+    edt_depart_delay_ = delay;
+
     // This congestion control algorithm will allow the send right now.
     // Cancel any pacing timer before returning the CCID and true.
 #ifdef SLIQ_DEBUG
@@ -1298,13 +1695,31 @@ bool Connection::CanSend(const Time& now, size_t bytes, CcId& cc_id)
     return true;
   }
 
-  return false;
+  if (found)
+  {
+    // Record the departure delay for the packet, cancel any pacing timer,
+    // and limit the probing of the path if it has failed.
+    PathInfo&  path_info = paths_[GetCcPath(cc_id)];
+
+    edt_depart_delay_ = best_delay;
+    timer_.CancelTimer(cc_algs_.cc_alg[cc_id].send_timer);
+
+    if (path_info.is_failed_)
+    {
+      path_info.next_probe_time_ = (now + Time(kPathProbeIntervalSec));
+    }
+  }
+
+  return found;
 }
 
 //============================================================================
 bool Connection::CanResend(const Time& now, size_t bytes, CcId orig_cc_id,
                            CcId& cc_id)
 {
+  // Any departure delay from a previous call has been used or abandoned.
+  edt_depart_delay_.Zero();
+
   // If currently in an outage, then the send should not happen.
   if (is_in_outage_)
   {
@@ -1316,6 +1731,7 @@ bool Connection::CanResend(const Time& now, size_t bytes, CcId orig_cc_id,
   {
     CcAlg&              cc_info = cc_algs_.cc_alg[i];
     CongCtrlInterface*  cc_alg  = cc_info.cc_alg;
+    Time                delay;
 
     if (cc_alg == NULL)
     {
@@ -1324,11 +1740,17 @@ bool Connection::CanResend(const Time& now, size_t bytes, CcId orig_cc_id,
       continue;
     }
 
+    // Retransmissions avoid failed paths.
+    if ((num_paths_ > 1) && IsPathFailed(now, GetCcPath(i)))
+    {
+      continue;
+    }
+
     if (cc_info.use_rexmit_pacing)
     {
       // Get the amount of delay before a resend can occur for this congestion
       // control algorithm.
-      Time  delay(cc_alg->TimeUntilSend(now));
+      delay = cc_alg->TimeUntilSend(now);
 
       // The returned delay should never be infinite.
       if (delay.IsInfinite())
@@ -1340,8 +1762,9 @@ bool Connection::CanResend(const Time& now, size_t bytes, CcId orig_cc_id,
       }
 
       // If the congestion control algorithm requires a delay, then we cannot
-      // resend this packet now.
-      if (!delay.IsZero())
+      // resend this packet now, unless EDT send pacing can release it early.
+      if ((!delay.IsZero()) && (edt_horizon_.IsZero() ||
+                                (delay > edt_horizon_)))
       {
         // Use the send pacing timer to wake up when a packet can be sent, and
         // continue the search.
@@ -1358,6 +1781,9 @@ bool Connection::CanResend(const Time& now, size_t bytes, CcId orig_cc_id,
       continue;
     }
 
+    // Record the departure delay for the packet.
+    edt_depart_delay_ = delay;
+
     // This congestion control algorithm will allow the resend right now.
     // Cancel any pacing timer before returning the CCID and true.
 #ifdef SLIQ_DEBUG
@@ -1390,7 +1816,8 @@ bool Connection::SendCreateStreamPkt(
                              win_size, seq_num, del_mode, rel.mode,
                              rel.rexmit_limit, rel.fec_target_pkt_del_rounds,
                              rel.fec_target_pkt_del_time_sec,
-                             rel.fec_target_pkt_recv_prob);
+                             rel.fec_target_pkt_recv_prob,
+                             rel.fec_sliding_win);
   Packet*             pkt = framer_.GenerateCreateStream(cs_hdr);
 
   if (pkt == NULL)
@@ -1400,8 +1827,10 @@ bool Connection::SendCreateStreamPkt(
     return rv;
   }
 
-  // Send the packet to the peer.
-  WriteResult  wr = socket_mgr_.WritePacket(socket_id_, *pkt, peer_addr_);
+  // Send the packet to the peer on the control path.
+  size_t       path = GetCtrlPath();
+  WriteResult  wr   = socket_mgr_.WritePacket(GetPathSocketId(path), *pkt,
+                                              GetPathPeerAddr(path));
 
   if (wr.status == WRITE_STATUS_OK)
   {
@@ -1458,8 +1887,10 @@ bool Connection::SendResetStreamPkt(StreamId stream_id, StreamErrorCode error,
     return rv;
   }
 
-  // Send the packet to the peer.
-  WriteResult  wr = socket_mgr_.WritePacket(socket_id_, *pkt, peer_addr_);
+  // Send the packet to the peer on the control path.
+  size_t       path = GetCtrlPath();
+  WriteResult  wr   = socket_mgr_.WritePacket(GetPathSocketId(path), *pkt,
+                                              GetPathPeerAddr(path));
 
   if (wr.status == WRITE_STATUS_OK)
   {
@@ -1594,10 +2025,38 @@ WriteResult Connection::SendDataPkt(const Time& now, DataHeader& data_hdr,
     AddConnMeas(now, rsvd_len, hdrs);
   }
 
-  // Get the timestamp and timestamp delta values for the data header.
-  data_hdr.timestamp       = GetCurrentLocalTimestamp();
+  // Decide if an ACK frequency header can be opportunistically included or
+  // not.
+  if (ack_freq_.enable_ || (ack_freq_.sent_ratio_ != 0))
+  {
+    AddAckFreq(now, rsvd_len, hdrs);
+  }
+
+  // Get the timestamp and timestamp delta values for the data header.  A
+  // packet released early by EDT send pacing is timestamped with its
+  // departure time to keep the RTT samples accurate.
+  Time  depart_delay = edt_depart_delay_;
+
+  edt_depart_delay_.Zero();
+
+  data_hdr.timestamp       = (GetCurrentLocalTimestamp() +
+                              static_cast<PktTimestamp>(
+                                depart_delay.GetTimeInUsec()));
   data_hdr.timestamp_delta = ts_delta_;
 
+  // Use a compact data header if negotiated for the connection.
+  if (compact_hdrs_)
+  {
+    Stream*  stream = GetStream(data_hdr.stream_id);
+
+    if (stream != NULL)
+    {
+      data_hdr.compact_flag   = true;
+      data_hdr.seq_num_length =
+        stream->GetCompactSeqNumLength(data_hdr.sequence_number);
+    }
+  }
+
   // Finally, add the data header last.
   if (!framer_.AppendDataHeader(hdrs, data_hdr, data_len))
   {
@@ -1626,21 +2085,43 @@ WriteResult Connection::SendDataPkt(const Time& now, DataHeader& data_hdr,
 
   // Send the packet to the peer.  If this packet is a FIN packet, then send
   // it multiple times to improve the chance of reception.
+  // The packet is sent on the path of the congestion control algorithm that
+  // allowed the send.
   WriteResult  wr;
   int          send_cnt = (data_hdr.fin_flag ? kFinPktSends : 1);
+  size_t       path     = GetCcPath(data_hdr.cc_id);
+  SocketId     sock     = GetPathSocketId(path);
 
   for (int i = 0; i < send_cnt; ++i)
   {
     if ((data == NULL) || (data_len == 0))
     {
-      wr = socket_mgr_.WritePacket(socket_id_, *hdrs, peer_addr_);
+      wr = socket_mgr_.WritePacket(sock, *hdrs, GetPathPeerAddr(path),
+                                   depart_delay);
     }
     else
     {
-      wr = socket_mgr_.WritePacket(socket_id_, *hdrs, *data, peer_addr_);
+      wr = socket_mgr_.WritePacket(sock, *hdrs, *data, GetPathPeerAddr(path),
+                                   depart_delay);
     }
   }
 
+  // An added path's interface may go away.  Treat the packet as sent and
+  // lost on that path, so that it is retransmitted on another path instead
+  // of closing the connection.
+  if ((wr.status == WRITE_STATUS_ERROR) && (path > 0))
+  {
+    LogW(kClassName, __func__, "Conn %" PRISocketId ": Error sending data "
+         "packet on path %zu: %s\n", socket_id_, path,
+         strerror(wr.error_code));
+    wr.status = WRITE_STATUS_OK;
+  }
+
+  if ((wr.status == WRITE_STATUS_OK) && (!depart_delay.IsZero()))
+  {
+    ++stats_edt_early_sends_;
+  }
+
   // Record the total number of bytes sent.  This includes SLIQ headers, but
   // not IP or UDP headers.
   bytes = (data_len + hdrs->GetLengthInBytes());
@@ -1716,11 +2197,18 @@ WriteResult Connection::SendDataPkt(const Time& now, DataHeader& data_hdr,
 
     // Update the sent data packet statistics.
     ++stats_snd_data_pkts_sent_;
+    stats_snd_hdr_bytes_ += hdrs->GetLengthInBytes();
+    stats_snd_pld_bytes_ += data_len;
+
+    if (num_paths_ > 1)
+    {
+      RecordPathSend(now, path);
+    }
   }
   else if (wr.status == WRITE_STATUS_BLOCKED)
   {
     // Writes are now blocked on the socket.
-    SetWriteBlocked(data_hdr.stream_id);
+    SetWriteBlocked(data_hdr.stream_id, sock);
   }
   else if (wr.status == WRITE_STATUS_ERROR)
   {
@@ -1764,13 +2252,17 @@ bool Connection::SendCcPktTrainPkts(CcId id, uint8_t type, uint8_t seq,
     ++hdr_seq;
   }
 
-  // Send the packets to the peer as fast as possible.
+  // Send the packets to the peer as fast as possible on the congestion
+  // control algorithm's path.
+  size_t  path = GetCcPath(id);
+
   for (size_t i = 0; i < send_cnt; ++i)
   {
     if (pkt[i] != NULL)
     {
-      WriteResult  wr = socket_mgr_.WritePacket(socket_id_, *(pkt[i]),
-                                                peer_addr_);
+      WriteResult  wr = socket_mgr_.WritePacket(GetPathSocketId(path),
+                                                *(pkt[i]),
+                                                GetPathPeerAddr(path));
 
       if (wr.status == WRITE_STATUS_BLOCKED)
       {
@@ -1873,6 +2365,13 @@ void Connection::UpdateCapacityEstimate(const Time& now, CcId cc_id,
 
     cc_algs_.send_rate_est_bps = send_rate_bps;
 
+    // Keep the cached fast reconnection state up to date while the
+    // connection is healthy.
+    if ((resume_token_ != 0) && (!is_in_outage_) && (chan_ce_bps > 0.0))
+    {
+      SaveResumeState(now);
+    }
+
 #ifdef SLIQ_CC_DEBUG
     LogD(kClassName, __func__, "Conn %" PRISocketId ": PLT_CAPEST %f %f %f\n",
          socket_id_, cc_algs_.chan_cap_est_bps, cc_algs_.trans_cap_est_bps,
@@ -2274,8 +2773,9 @@ bool Connection::CreateCongCtrlObjects(bool is_client)
     }
 
     cc_algs_.cc_alg[i].cc_alg = CongCtrlInterface::Create(
-      socket_id_, is_client, static_cast<CcId>(i), *this, framer_, rtt_mgr_,
-      rng_, packet_pool_, timer_, cc_algs_.cc_settings[i]);
+      socket_id_, is_client, static_cast<CcId>(i), *this, framer_,
+      paths_[i].rtt_mgr_, rng_, packet_pool_, timer_,
+      cc_algs_.cc_settings[i]);
 
     if (cc_algs_.cc_alg[i].cc_alg == NULL)
     {
@@ -2284,10 +2784,12 @@ bool Connection::CreateCongCtrlObjects(bool is_client)
       return false;
     }
 
-    // Check if a PacingSender object must wrap the real object.
-    if (((cc_algs_.cc_settings[i].algorithm == TCP_CUBIC_BYTES_CC) ||
-         (cc_algs_.cc_settings[i].algorithm == TCP_RENO_BYTES_CC)) &&
-        (cc_algs_.cc_settings[i].cubic_reno_pacing))
+    // Check if a PacingSender object must wrap the real object.  BBR is
+    // always paced at its model-based pacing rate.
+    if ((((cc_algs_.cc_settings[i].algorithm == TCP_CUBIC_BYTES_CC) ||
+          (cc_algs_.cc_settings[i].algorithm == TCP_RENO_BYTES_CC)) &&
+         (cc_algs_.cc_settings[i].cubic_reno_pacing)) ||
+        (cc_algs_.cc_settings[i].algorithm == TCP_BBR_CC))
     {
       CongCtrlInterface*  tail_cc_alg = cc_algs_.cc_alg[i].cc_alg;
 
@@ -2352,6 +2854,11 @@ bool Connection::SendConnHndshkPkt(const Ipv4Endpoint& dst, MsgTag tag,
   // Create the connection handshake packet.
   ConnHndshkHeader  ch_hdr(cc_algs_.num_cc_alg, tag, ts, echo_ts, id,
                            cc_algs_.cc_settings);
+
+  ch_hdr.compact_flag = compact_hdrs_;
+  ch_hdr.resume_flag  = resume_;
+  ch_hdr.resume_token = resume_token_;
+
   Packet*           pkt = framer_.GenerateConnHndshk(ch_hdr);
 
   if (pkt == NULL)
@@ -2421,8 +2928,10 @@ bool Connection::SendResetConnPkt(ConnErrorCode error)
     return rv;
   }
 
-  // Send the packet to the peer.
-  WriteResult  wr = socket_mgr_.WritePacket(socket_id_, *pkt, peer_addr_);
+  // Send the packet to the peer on the control path.
+  size_t       path = GetCtrlPath();
+  WriteResult  wr   = socket_mgr_.WritePacket(GetPathSocketId(path), *pkt,
+                                              GetPathPeerAddr(path));
 
   if (wr.status == WRITE_STATUS_OK)
   {
@@ -2468,8 +2977,10 @@ bool Connection::SendCloseConnPkt(bool ack, ConnCloseCode reason)
     return rv;
   }
 
-  // Send the packet to the peer.
-  WriteResult  wr = socket_mgr_.WritePacket(socket_id_, *pkt, peer_addr_);
+  // Send the packet to the peer on the control path.
+  size_t       path = GetCtrlPath();
+  WriteResult  wr   = socket_mgr_.WritePacket(GetPathSocketId(path), *pkt,
+                                              GetPathPeerAddr(path));
 
   if (wr.status == WRITE_STATUS_OK)
   {
@@ -2503,11 +3014,16 @@ bool Connection::SendCloseConnPkt(bool ack, ConnCloseCode reason)
 //============================================================================
 void Connection::SendAckPkt(const Time& now, CcId cc_id, Packet* pkt)
 {
-  // Send the packet to the peer.
-  WriteResult  wr = socket_mgr_.WritePacket(socket_id_, *pkt, peer_addr_);
+  // Send the packet to the peer on the congestion control algorithm's path.
+  size_t       path = GetCcPath(cc_id);
+  WriteResult  wr   = socket_mgr_.WritePacket(GetPathSocketId(path), *pkt,
+                                              GetPathPeerAddr(path));
 
   if (wr.status == WRITE_STATUS_OK)
   {
+    ++stats_ack_pkts_sent_;
+    stats_snd_hdr_bytes_ += pkt->GetLengthInBytes();
+
 #ifdef SLIQ_DEBUG
     LogD(kClassName, __func__, "Conn %" PRISocketId ": Sent consolidated ACK "
          "packet for cc_id %" PRICcId " size %zu bytes.\n", socket_id_, cc_id,
@@ -2526,8 +3042,12 @@ void Connection::SendAckPkt(const Time& now, CcId cc_id, Packet* pkt)
     LogE(kClassName, __func__, "Conn %" PRISocketId ": Error sending ACK "
          "packet: %s.\n", socket_id_, strerror(wr.error_code));
 
-    // Initiate a close of the connection.
-    do_close_conn_callback_ = true;
+    // Initiate a close of the connection, unless the error is on an added
+    // path.
+    if (path == 0)
+    {
+      do_close_conn_callback_ = true;
+    }
   }
 }
 
@@ -2589,8 +3109,10 @@ bool Connection::SendCcSyncPkt(CcId cc_id, uint16_t cc_sync_seq_num,
     AddConnMeas(now, 0, pkt);
   }
 
-  // Send the packet to the peer.
-  WriteResult  wr = socket_mgr_.WritePacket(socket_id_, *pkt, peer_addr_);
+  // Send the packet to the peer on the congestion control algorithm's path.
+  size_t       path = GetCcPath(cc_id);
+  WriteResult  wr   = socket_mgr_.WritePacket(GetPathSocketId(path), *pkt,
+                                              GetPathPeerAddr(path));
 
   if (wr.status == WRITE_STATUS_OK)
   {
@@ -2622,8 +3144,12 @@ bool Connection::SendCcSyncPkt(CcId cc_id, uint16_t cc_sync_seq_num,
     LogE(kClassName, __func__, "Conn %" PRISocketId ": Error sending CC sync "
          "packet: %s.\n", socket_id_, strerror(wr.error_code));
 
-    // Initiate a close of the connection.
-    do_close_conn_callback_ = true;
+    // Initiate a close of the connection, unless the error is on an added
+    // path.
+    if (path == 0)
+    {
+      do_close_conn_callback_ = true;
+    }
   }
 
   // Release the packet.
@@ -2650,8 +3176,10 @@ bool Connection::SendRcvdPktCnt()
     return rv;
   }
 
-  // Send the packet to the peer.
-  WriteResult  wr = socket_mgr_.WritePacket(socket_id_, *pkt, peer_addr_);
+  // Send the packet to the peer on the control path.
+  size_t       path = GetCtrlPath();
+  WriteResult  wr   = socket_mgr_.WritePacket(GetPathSocketId(path), *pkt,
+                                              GetPathPeerAddr(path));
 
   if (wr.status == WRITE_STATUS_OK)
   {
@@ -2695,7 +3223,7 @@ bool Connection::SendRcvdPktCnt()
 }
 
 //============================================================================
-void Connection::ReceivePackets()
+void Connection::ReceivePackets(size_t path)
 {
   Ipv4Endpoint  src;
   Time          rcv_time;
@@ -2706,7 +3234,13 @@ void Connection::ReceivePackets()
   while (num_pkts > 0)
   {
     // Read the next set of packets.
-    num_pkts = socket_mgr_.ReadPackets(socket_id_, pkt_set_);
+    num_pkts = socket_mgr_.ReadPackets(GetPathSocketId(path), pkt_set_);
+
+    // Any packet received on a path shows that the path is working.
+    if ((num_pkts > 0) && (num_paths_ > 1))
+    {
+      RecordPathRecv(path);
+    }
 
     // Process each of the packets.
     for (int i = 0; i < num_pkts; ++i)
@@ -2735,10 +3269,10 @@ void Connection::ReceivePackets()
       {
         HeaderType  hdr_type = framer_.GetHeaderType(pkt, offset);
 
-        // Only data, ACK, CC sync, and received packet count headers may be
-        // consolidated.
+        // Only data, ACK, CC sync, received packet count, connection
+        // measurement, and ACK frequency headers may be consolidated.
         if ((offset > 0) && ((hdr_type < DATA_HEADER) ||
-                             (hdr_type > CONN_MEAS_HEADER)))
+                             (hdr_type > ACK_FREQ_HEADER)))
         {
           LogE(kClassName, __func__, "Conn %" PRISocketId ": Cannot "
                "consolidate header type %d.\n", socket_id_, hdr_type);
@@ -2868,7 +3402,8 @@ void Connection::ReceivePackets()
           {
             DataHeader  data_hdr;
 
-            if (framer_.ParseDataHeader(pkt, offset, data_hdr))
+            if ((framer_.ParseDataHeader(pkt, offset, data_hdr)) &&
+                (ExpandCompactSeqNum(data_hdr)))
             {
 #ifdef SLIQ_DEBUG
               LogD(kClassName, __func__, "Conn %" PRISocketId ": Received "
@@ -3084,20 +3619,40 @@ void Connection::ReceivePackets()
             break;
           }
 
-          case CC_PKT_TRAIN_HEADER:
+          case ACK_FREQ_HEADER:
           {
-            CcPktTrainHeader  ccpt_hdr;
+            AckFreqHeader  af_hdr;
 
-            if (framer_.ParseCcPktTrainHeader(pkt, offset, ccpt_hdr))
+            if (framer_.ParseAckFreqHeader(pkt, offset, af_hdr))
             {
 #ifdef SLIQ_DEBUG
-              LogD(kClassName, __func__, "Conn %" PRISocketId ": Received CC "
-                   "packet train packet: cc_id %" PRICcId " pt_type %" PRIu8
-                   " pt_seq %" PRIu8 " inter_recv_time %" PRIu32 " ts %"
-                   PRIPktTimestamp " ts_delta %" PRIPktTimestamp "\n",
-                   socket_id_, ccpt_hdr.cc_id, ccpt_hdr.pt_pkt_type,
-                   ccpt_hdr.pt_seq_num, ccpt_hdr.pt_inter_recv_time,
-                   ccpt_hdr.pt_timestamp, ccpt_hdr.pt_timestamp_delta);
+              LogD(kClassName, __func__, "Conn %" PRISocketId ": Received "
+                   "ACK frequency: ratio %" PRIu8 " seq %" PRIu16 " "
+                   "max_ack_delay %" PRIu32 "\n", socket_id_,
+                   af_hdr.ack_ratio, af_hdr.sequence_number,
+                   af_hdr.max_ack_delay_usec);
+#endif
+
+              ProcessAckFreqInfo(af_hdr);
+            }
+
+            break;
+          }
+
+          case CC_PKT_TRAIN_HEADER:
+          {
+            CcPktTrainHeader  ccpt_hdr;
+
+            if (framer_.ParseCcPktTrainHeader(pkt, offset, ccpt_hdr))
+            {
+#ifdef SLIQ_DEBUG
+              LogD(kClassName, __func__, "Conn %" PRISocketId ": Received CC "
+                   "packet train packet: cc_id %" PRICcId " pt_type %" PRIu8
+                   " pt_seq %" PRIu8 " inter_recv_time %" PRIu32 " ts %"
+                   PRIPktTimestamp " ts_delta %" PRIPktTimestamp "\n",
+                   socket_id_, ccpt_hdr.cc_id, ccpt_hdr.pt_pkt_type,
+                   ccpt_hdr.pt_seq_num, ccpt_hdr.pt_inter_recv_time,
+                   ccpt_hdr.pt_timestamp, ccpt_hdr.pt_timestamp_delta);
 #endif
 
               // Update the differences in the two packet timestamp clocks.
@@ -3139,38 +3694,61 @@ void Connection::ReceivePackets()
         pkt = NULL;
       }
 
-      // Update congestion control.
+      // Update congestion control.  When coalescing the ACK processing,
+      // wait until all of the packets in the batch have been processed.
       if (ack_cnt > 0)
       {
-        // Process any implicit ACKs for streams other than those that
-        // received ACKs above.
-        ProcessImplicitAcks(ack_stream_mask);
+        if (ack_coal_.enable_)
+        {
+          ack_coal_.ack_stream_mask_ |= ack_stream_mask;
+          ack_coal_.ack_cnt_         += static_cast<size_t>(ack_cnt);
+          ++ack_coal_.ack_pkt_cnt_;
+        }
+        else
+        {
+          FinishAckPktProcessing(ack_stream_mask);
+        }
+      }
+    } // for (int i = 0; i < num_pkts; ++i)
 
-        // Get the current time.
-        Time  now = Time::Now();
+    // Complete the coalesced ACK processing for the batch of packets.
+    if (ack_coal_.ack_pkt_cnt_ > 0)
+    {
+      CompleteAckProcessing(Time::Now());
+
+      // Each additional ACK packet in the batch would have started and
+      // stopped the ACK packet processing on each congestion control
+      // algorithm that is now in ACK packet processing.
+      size_t  cc_in_ack_proc = 0;
 
-        // Stop ACK packet processing on the congestion control algorithms
-        // where it has been started.
-        for (size_t l = 0; l < cc_algs_.num_cc_alg; ++l)
+      for (size_t l = 0; l < cc_algs_.num_cc_alg; ++l)
+      {
+        if (cc_algs_.cc_alg[l].in_ack_proc)
         {
-          CcAlg&  cc_info = cc_algs_.cc_alg[l];
+          ++cc_in_ack_proc;
+        }
+      }
 
-          if (cc_info.in_ack_proc)
-          {
-            if (cc_info.cc_alg != NULL)
-            {
-              cc_info.cc_alg->OnAckPktProcessingDone(now);
-            }
+      ++stats_ack_batches_;
+      stats_ack_batch_pkts_     += ack_coal_.ack_pkt_cnt_;
+      stats_ack_batch_hdrs_     += ack_coal_.ack_cnt_;
+      stats_ack_batch_cc_saved_ += ((ack_coal_.ack_pkt_cnt_ - 1) *
+                                    cc_in_ack_proc);
 
-            cc_info.in_ack_proc = false;
-          }
-        }
+#ifdef SLIQ_DEBUG
+      LogD(kClassName, __func__, "Conn %" PRISocketId ": Coalesced %zu ACK "
+           "headers in %zu ACK packets.\n", socket_id_, ack_coal_.ack_cnt_,
+           ack_coal_.ack_pkt_cnt_);
+#endif
 
-        // Now that all of the ACKs have been processed, attempt to send as
-        // many packets as possible.
-        OnCanWrite();
-      }
-    } // for (int i = 0; i < num_pkts; ++i)
+      uint64_t  ack_stream_mask = ack_coal_.ack_stream_mask_;
+
+      ack_coal_.ack_stream_mask_ = 0;
+      ack_coal_.ack_cnt_         = 0;
+      ack_coal_.ack_pkt_cnt_     = 0;
+
+      FinishAckPktProcessing(ack_stream_mask);
+    }
   } // while (num_pkts > 0)
 }
 
@@ -3279,6 +3857,12 @@ void Connection::ProcessDataClientHello(ConnHndshkHeader& hdr,
        src.ToString().c_str(), hdr.client_id);
 #endif
 
+  // Use compact headers only if both endpoints allow them.
+  compact_hdrs_ = (hdr.compact_flag && app_.compact_headers());
+
+  // Decide if the connection resumes from cached state.
+  SetupServerResume(hdr);
+
   // Attempt to continue the connection establishment.
   if (!ContinueConnectToClient(hdr.timestamp, hdr.client_id))
   {
@@ -3424,6 +4008,12 @@ void Connection::ProcessClientHello(ConnHndshkHeader& hdr,
        socket_id_, src.ToString().c_str(), hdr.client_id);
 #endif
 
+  // Use compact headers only if both endpoints allow them.
+  conn->compact_hdrs_ = (hdr.compact_flag && app_.compact_headers());
+
+  // Decide if the connection resumes from cached state.
+  conn->SetupServerResume(hdr);
+
   // Attempt to continue the connection establishment.
   if (!conn->ContinueConnectToClient(hdr.timestamp, hdr.client_id))
   {
@@ -3515,6 +4105,12 @@ void Connection::ProcessServerHello(ConnHndshkHeader& hdr,
     return;
   }
 
+  // Decide if the connection resumes from cached state before confirming.
+  if (state_ == SENT_CHLO)
+  {
+    ProcessServerResume(hdr);
+  }
+
   // Send a client confirmation packet back to the server.
   if (!SendConnHndshkPkt(peer_addr_, kClientConfirmTag, hdr.timestamp,
                          client_id_))
@@ -3534,6 +4130,15 @@ void Connection::ProcessServerHello(ConnHndshkHeader& hdr,
 
     state_ = CONNECTED;
 
+    // Use compact headers only if the server agreed to use them.
+    compact_hdrs_ = (compact_hdrs_ && hdr.compact_flag);
+
+    if (compact_hdrs_)
+    {
+      LogI(kClassName, __func__, "Conn %" PRISocketId ": Using compact "
+           "headers.\n", socket_id_);
+    }
+
     // Notify the server application that the connection was successful.
     app_.ProcessConnectionResult(socket_id_, true);
 
@@ -3582,6 +4187,7 @@ void Connection::ProcessServerHello(ConnHndshkHeader& hdr,
     Time  rtt = Time::FromUsec(delta);
 
     rtt_mgr_.UpdateRtt(now, socket_id_, rtt);
+    UpdatePathRtt(now, 0, rtt);
 
     if (num_rtt_pdd_samples_ < kMaxRttPddSamples)
     {
@@ -3600,6 +4206,11 @@ void Connection::ProcessServerHello(ConnHndshkHeader& hdr,
         cc_alg->Connected(now, rtt);
       }
     }
+
+    if (resume_)
+    {
+      ResumeCachedState(now);
+    }
   }
 
   // Cancel any hello timer.
@@ -3669,6 +4280,12 @@ void Connection::ProcessClientConfirm(ConnHndshkHeader& hdr,
   // Update the connection state.
   state_ = CONNECTED;
 
+  if (compact_hdrs_)
+  {
+    LogI(kClassName, __func__, "Conn %" PRISocketId ": Using compact "
+         "headers.\n", socket_id_);
+  }
+
   // Notify the server application that the connection was successful.
   app_.ProcessConnectionResult(socket_id_, true);
 
@@ -3704,6 +4321,7 @@ void Connection::ProcessClientConfirm(ConnHndshkHeader& hdr,
   Time  rtt = Time::FromUsec(delta);
 
   rtt_mgr_.UpdateRtt(now, socket_id_, rtt);
+  UpdatePathRtt(now, 0, rtt);
 
   if (num_rtt_pdd_samples_ < kMaxRttPddSamples)
   {
@@ -3723,6 +4341,14 @@ void Connection::ProcessClientConfirm(ConnHndshkHeader& hdr,
     }
   }
 
+  // Resume from cached state only if the client also agreed to it.
+  resume_ = (resume_ && hdr.resume_flag);
+
+  if (resume_)
+  {
+    ResumeCachedState(now);
+  }
+
   // Cancel any hello timer.
   timer_.CancelTimer(hello_timer_);
 }
@@ -3784,7 +4410,7 @@ void Connection::ProcessResetConn(ResetConnHeader& hdr,
   }
 
   // Validate the source address.
-  if (peer_addr_ != src)
+  if (!IsPeerAddr(src))
   {
     LogE(kClassName, __func__, "Conn %" PRISocketId ": Error, source address "
          "%s does not match peer address %s.\n", socket_id_,
@@ -3861,7 +4487,7 @@ void Connection::ProcessCloseConn(CloseConnHeader& hdr,
   }
 
   // Validate the source address.
-  if (peer_addr_ != src)
+  if (!IsPeerAddr(src))
   {
     LogE(kClassName, __func__, "Conn %" PRISocketId ": Error, source address "
          "%s does not match peer address %s.\n", socket_id_,
@@ -3984,7 +4610,7 @@ void Connection::ProcessCreateStream(CreateStreamHeader& hdr,
   }
 
   // Validate the source address.
-  if (peer_addr_ != src)
+  if (!IsPeerAddr(src))
   {
     LogE(kClassName, __func__, "Conn %" PRISocketId ": Error, source address "
          "%s does not match peer address %s.\n", socket_id_,
@@ -4081,7 +4707,7 @@ void Connection::ProcessResetStream(ResetStreamHeader& hdr,
   }
 
   // Validate the source address.
-  if (peer_addr_ != src)
+  if (!IsPeerAddr(src))
   {
     LogE(kClassName, __func__, "Conn %" PRISocketId ": Error, source address "
          "%s does not match peer address %s.\n", socket_id_,
@@ -4119,7 +4745,7 @@ bool Connection::IsGoodDataPacket(DataHeader& hdr, const Ipv4Endpoint& src)
   }
 
   // Validate the source address.
-  if (peer_addr_ != src)
+  if (!IsPeerAddr(src))
   {
     LogE(kClassName, __func__, "Conn %" PRISocketId ": Error, source address "
          "%s does not match peer address %s.\n", socket_id_,
@@ -4254,7 +4880,7 @@ bool Connection::IsGoodAckPacket(AckHeader& hdr, const Ipv4Endpoint& src)
   }
 
   // Validate the source address.
-  if (peer_addr_ != src)
+  if (!IsPeerAddr(src))
   {
     LogE(kClassName, __func__, "Conn %" PRISocketId ": Error, source address "
          "%s does not match peer address %s.\n", socket_id_,
@@ -4286,14 +4912,13 @@ void Connection::ProcessAck(AckHeader& hdr, const Time& rcv_time)
   }
 
   // If the connection is currently in an outage, then switch back to normal
-  // mode.  Note that the retransmission timer will be reset below if needed.
-  // Also, any required data packets will be sent below.
-  bool  leaving_outage = false;
-
+  // mode.  Note that the retransmission timer will be reset when the ACK
+  // processing is completed if needed.  Also, any required data packets will
+  // be sent at that time.
   if (is_in_outage_)
   {
     LeaveOutage(false);
-    leaving_outage = true;
+    ack_coal_.leaving_outage_ = true;
   }
 
   // Get the current time.
@@ -4302,23 +4927,65 @@ void Connection::ProcessAck(AckHeader& hdr, const Time& rcv_time)
   // Record the time that an ACK packet was received from the peer.
   ack_or_data_pkt_recv_time_ = rcv_time;
 
-  // Call into the stream to process the ACK.  The stream returns if all data
-  // has been ACKed after processing the ACK, and if new data was ACKed in the
-  // processing of the ACK.  It also returns the largest observed connection
-  // sequence number on success.
-  bool          new_data_acked = false;
-  bool          all_data_acked = false;
-  PktSeqNumber  lo_conn_seq    = 0;
+  // Call into the stream to process the ACK.  The stream returns the largest
+  // observed connection sequence number on success.
+  PktSeqNumber  lo_conn_seq = 0;
 
-  if (stream->ProcessAck(hdr, rcv_time, now, leaving_outage, new_data_acked,
-                         all_data_acked, lo_conn_seq))
+  if (stream->ProcessAck(hdr, rcv_time, now, lo_conn_seq))
   {
     if (SEQ_GT(lo_conn_seq, largest_observed_conn_seq_num_))
     {
       largest_observed_conn_seq_num_ = lo_conn_seq;
     }
+
+    ack_coal_.cmpl_stream_mask_ |= (static_cast<uint64_t>(0x1) <<
+                                    hdr.stream_id);
+  }
+
+  // Unless the ACK processing is being coalesced, complete it now.
+  if (!ack_coal_.enable_)
+  {
+    CompleteAckProcessing(now);
+  }
+}
+
+//============================================================================
+void Connection::CompleteAckProcessing(const Time& now)
+{
+  // Call into each stream that received an ACK header to complete the ACK
+  // processing.  Each stream returns if all data has been ACKed and if new
+  // data was ACKed in the processing of the ACK headers.
+  bool  new_data_acked = false;
+  bool  all_data_acked = true;
+
+  for (size_t index = 0; index < prio_info_.num_streams; ++index)
+  {
+    StreamId  stream_id = prio_info_.stream_id[index];
+
+    if ((ack_coal_.cmpl_stream_mask_ &
+         (static_cast<uint64_t>(0x1) << stream_id)) != 0)
+    {
+      Stream*  stream = GetStream(stream_id);
+
+      if (stream != NULL)
+      {
+        bool  stream_new_data_acked = false;
+        bool  stream_all_data_acked = false;
+
+        stream->CompleteAckProcessing(now, stream_new_data_acked,
+                                      stream_all_data_acked);
+
+        new_data_acked = (new_data_acked || stream_new_data_acked);
+        all_data_acked = (all_data_acked && stream_all_data_acked);
+      }
+    }
   }
 
+  bool  leaving_outage = ack_coal_.leaving_outage_;
+
+  ack_coal_.cmpl_stream_mask_ = 0;
+  ack_coal_.leaving_outage_   = false;
+
   // If this is the first ACK packet since an RTO timeout, then reset state
   // for a fast recovery.
   if (rto_timeout_cnt_ > 0)
@@ -4342,8 +5009,8 @@ void Connection::ProcessAck(AckHeader& hdr, const Time& rcv_time)
     is_in_rto_ = false;
   }
 
-  // If all of the data on this and the other streams has been ACKed, then
-  // stop the retransmission timer.
+  // If all of the data on the ACKed streams and the other streams has been
+  // ACKed, then stop the retransmission timer.
   if ((all_data_acked) && (IsAllDataAcked()))
   {
 #ifdef SLIQ_DEBUG
@@ -4355,8 +5022,8 @@ void Connection::ProcessAck(AckHeader& hdr, const Time& rcv_time)
   }
   else
   {
-    // If new data was ACKed in the ACK or this call is leaving an outage,
-    // then set the retransmission timer expiration time.
+    // If new data was ACKed in the ACK headers or this call is leaving an
+    // outage, then set the retransmission timer expiration time.
     if ((new_data_acked) || (leaving_outage))
     {
       SetRexmitTime(now, rtt_mgr_.GetRtoTime());
@@ -4364,6 +5031,38 @@ void Connection::ProcessAck(AckHeader& hdr, const Time& rcv_time)
   }
 }
 
+//============================================================================
+void Connection::FinishAckPktProcessing(uint64_t ack_stream_mask)
+{
+  // Process any implicit ACKs for streams other than those that received
+  // ACKs.
+  ProcessImplicitAcks(ack_stream_mask);
+
+  // Get the current time.
+  Time  now = Time::Now();
+
+  // Stop ACK packet processing on the congestion control algorithms where it
+  // has been started.
+  for (size_t l = 0; l < cc_algs_.num_cc_alg; ++l)
+  {
+    CcAlg&  cc_info = cc_algs_.cc_alg[l];
+
+    if (cc_info.in_ack_proc)
+    {
+      if (cc_info.cc_alg != NULL)
+      {
+        cc_info.cc_alg->OnAckPktProcessingDone(now);
+      }
+
+      cc_info.in_ack_proc = false;
+    }
+  }
+
+  // Now that all of the ACKs have been processed, attempt to send as many
+  // packets as possible.
+  OnCanWrite();
+}
+
 //============================================================================
 void Connection::ProcessImplicitAcks(uint64_t ack_stream_mask)
 {
@@ -4557,6 +5256,53 @@ void Connection::ProcessConnMeasInfo(ConnMeasHeader& hdr)
   }
 }
 
+//============================================================================
+void Connection::ProcessAckFreqInfo(AckFreqHeader& hdr)
+{
+  // Ignore old ACK frequency settings.
+  if (ack_freq_.init_ &&
+      (static_cast<int16_t>(hdr.sequence_number - ack_freq_.af_hdr_seq_) <=
+       0))
+  {
+    return;
+  }
+
+  ack_freq_.init_       = true;
+  ack_freq_.af_hdr_seq_ = hdr.sequence_number;
+
+  // Limit the ACK ratio to what the ACK headers can support, and limit the
+  // maximum ACK delay to the fixed ACK timer duration that the peer's
+  // retransmission timeout already allows for.
+  size_t       ratio = hdr.ack_ratio;
+  suseconds_t  delay = static_cast<suseconds_t>(hdr.max_ack_delay_usec);
+
+  if (ratio < 1)
+  {
+    ratio = 1;
+  }
+  if (ratio > kMaxAckRatio)
+  {
+    ratio = kMaxAckRatio;
+  }
+  if (delay < kMinAckDelayUsec)
+  {
+    delay = kMinAckDelayUsec;
+  }
+  if (delay > kAckTimerUsec)
+  {
+    delay = kAckTimerUsec;
+  }
+
+  ack_freq_.ack_ratio_     = ratio;
+  ack_freq_.max_ack_delay_ = Time(0, delay);
+
+#ifdef SLIQ_DEBUG
+  LogD(kClassName, __func__, "Conn %" PRISocketId ": Updated ACK ratio %zu "
+       "max ACK delay %s\n", socket_id_, ack_freq_.ack_ratio_,
+       ack_freq_.max_ack_delay_.ToString().c_str());
+#endif
+}
+
 //============================================================================
 void Connection::ForceAck(const Time& now, CcId cc_id, StreamId stream_id)
 {
@@ -4581,8 +5327,8 @@ void Connection::MaybeAck(const Time& now, CcId cc_id, StreamId stream_id)
 
   // If enough data packets have been received since the last ACK packet was
   // sent, then send the ACK packet immediately.  Otherwise, use the ACK
-  // timer.
-  if (pkts_since_last_ack_ >= kAckAfterDataPktCnt)
+  // timer.  Both are set by the peer when it uses adaptive ACK frequency.
+  if (pkts_since_last_ack_ >= ack_freq_.ack_ratio_)
   {
     // Reset the packet counter.
     pkts_since_last_ack_ = 0;
@@ -4601,12 +5347,12 @@ void Connection::MaybeAck(const Time& now, CcId cc_id, StreamId stream_id)
     if (!timer_.IsTimerSet(ack_timer_))
     {
       // Start an ACK timer.
-      Time                              duration(0, kAckTimerUsec);
       CallbackOneArg<Connection, CcId>  callback(this,
                                                  &Connection::AckTimeout,
                                                  cc_id);
 
-      if (!timer_.StartTimer(duration, &callback, ack_timer_))
+      if (!timer_.StartTimer(ack_freq_.max_ack_delay_, &callback,
+                             ack_timer_))
       {
         LogE(kClassName, __func__, "Conn %" PRISocketId ": Error starting "
              "ACK timer.\n", socket_id_);
@@ -4657,6 +5403,7 @@ bool Connection::GetAcks(const Time& now, size_t rsvd_len, Packet*& pkt,
           // Get the timestamp and timestamp delta values for the ACK header.
           ack_hdr_.timestamp       = GetCurrentLocalTimestamp();
           ack_hdr_.timestamp_delta = ts_delta_;
+          ack_hdr_.compact_flag    = compact_hdrs_;
 
           if (!framer_.AppendAckHeader(pkt, ack_hdr_))
           {
@@ -4769,6 +5516,7 @@ void Connection::SendAck(const Time& now, CcId cc_id,
         // Get the timestamp and timestamp delta values for the ACK header.
         ack_hdr_.timestamp       = GetCurrentLocalTimestamp();
         ack_hdr_.timestamp_delta = ts_delta_;
+        ack_hdr_.compact_flag    = compact_hdrs_;
 
         // Clear the delayed ACK flag for the stream.
         stream_info_[stream_id].delayed_ack = false;
@@ -4885,7 +5633,7 @@ void Connection::SendAck(const Time& now, CcId cc_id,
   // next ACK timer if needed.
   if (start_ack_timer)
   {
-    Time                              duration(0, kAckTimerUsec);
+    Time                              duration = ack_freq_.max_ack_delay_;
     CallbackOneArg<Connection, CcId>  callback(this,
                                                &Connection::AckTimeout,
                                                cc_id);
@@ -4995,6 +5743,102 @@ void Connection::AddConnMeas(const Time& now, size_t rsvd_len, Packet*& pkt)
   }
 }
 
+//============================================================================
+void Connection::AddAckFreq(const Time& now, size_t rsvd_len, Packet*& pkt)
+{
+  // Compute the ACK ratio and maximum ACK delay that the peer should use.
+  // When disabled, these are the fixed ACK policy values.  Otherwise, target
+  // about kAckFreqAcksPerRtt ACK packets per smoothed RTT at the current
+  // send rate.  The sender side is tolerant of the resulting stretch ACKs:
+  // the RTT samples are corrected for the ACK hold time, loss detection is
+  // based on packet sequence numbers, and the congestion control algorithms
+  // are updated for every packet acknowledged.
+  size_t       ratio = kAckAfterDataPktCnt;
+  suseconds_t  delay = kAckTimerUsec;
+  Time         srtt  = rtt_mgr_.smoothed_rtt();
+
+  if (ack_freq_.enable_ && (!srtt.IsZero()) &&
+      (cc_algs_.send_rate_est_bps > 0.0))
+  {
+    double  pkts_per_rtt = ((cc_algs_.send_rate_est_bps * srtt.ToDouble()) /
+                            (8.0 * static_cast<double>(kMaxPacketSize)));
+    double  ratio_dbl    = (pkts_per_rtt / kAckFreqAcksPerRtt);
+
+    if (ratio_dbl > static_cast<double>(kMaxAckRatio))
+    {
+      ratio_dbl = static_cast<double>(kMaxAckRatio);
+    }
+    if (ratio_dbl > static_cast<double>(ratio))
+    {
+      ratio = static_cast<size_t>(ratio_dbl);
+    }
+
+    delay = static_cast<suseconds_t>(srtt.GetTimeInUsec() / 4);
+
+    if (delay < kMinAckDelayUsec)
+    {
+      delay = kMinAckDelayUsec;
+    }
+    if (delay > kAckTimerUsec)
+    {
+      delay = kAckTimerUsec;
+    }
+  }
+
+  // Send the header when the values change, at most once per smoothed RTT,
+  // or periodically to recover from a lost header.
+  bool  changed = ((static_cast<size_t>(ack_freq_.sent_ratio_) != ratio) ||
+                   (ack_freq_.sent_delay_usec_ !=
+                    static_cast<uint32_t>(delay)));
+
+  if (!((changed && (now >= (ack_freq_.last_send_time_ + srtt))) ||
+        (now >= (ack_freq_.last_send_time_ + Time(kAckFreqRefreshSec)))))
+  {
+    return;
+  }
+
+  // Check if an ACK frequency header will fit, and if so, add it.
+  size_t  curr_len = (rsvd_len +
+                      ((pkt != NULL) ? pkt->GetLengthInBytes() : 0));
+
+  if ((curr_len + kAckFreqHdrSize) <= kMaxPacketSize)
+  {
+    AckFreqHeader  ack_freq_hdr(static_cast<uint8_t>(ratio),
+                                ack_freq_.next_af_hdr_seq_,
+                                static_cast<uint32_t>(delay));
+
+    if (!framer_.AppendAckFreqHeader(pkt, ack_freq_hdr))
+    {
+      LogE(kClassName, __func__, "Conn %" PRISocketId ": Error appending "
+           "ACK frequency header.\n", socket_id_);
+      return;
+    }
+
+#ifdef SLIQ_DEBUG
+    LogD(kClassName, __func__, "Conn %" PRISocketId ": Add opportunistic "
+         "ACK frequency: ratio %zu seq %" PRIu16 " max_ack_delay %" PRIu32
+         "\n", socket_id_, ratio, ack_freq_.next_af_hdr_seq_,
+         static_cast<uint32_t>(delay));
+#endif
+
+    ++ack_freq_.next_af_hdr_seq_;
+    ack_freq_.last_send_time_ = now;
+
+    // Once the fixed ACK policy values have been sent after disabling, stop
+    // sending ACK frequency headers.
+    if (!ack_freq_.enable_)
+    {
+      ack_freq_.sent_ratio_      = 0;
+      ack_freq_.sent_delay_usec_ = 0;
+    }
+    else
+    {
+      ack_freq_.sent_ratio_      = static_cast<uint8_t>(ratio);
+      ack_freq_.sent_delay_usec_ = static_cast<uint32_t>(delay);
+    }
+  }
+}
+
 //============================================================================
 bool Connection::IsAllDataAcked()
 {
@@ -5015,7 +5859,7 @@ bool Connection::IsAllDataAcked()
 }
 
 //============================================================================
-void Connection::ForceUnackedPacketsLost(const Time& now)
+void Connection::ForceUnackedPacketsLost(const Time& now, int cc_id)
 {
   // Update each of the streams.
   for (size_t index = 0; index < prio_info_.num_streams; ++index)
@@ -5025,7 +5869,7 @@ void Connection::ForceUnackedPacketsLost(const Time& now)
 
     if (stream != NULL)
     {
-      stream->ForceUnackedPacketsLost(now);
+      stream->ForceUnackedPacketsLost(now, cc_id);
     }
   }
 }
@@ -5168,16 +6012,17 @@ void Connection::LeaveOutage(bool full_proc)
 }
 
 //============================================================================
-void Connection::SetWriteBlocked(StreamId stream_id)
+void Connection::SetWriteBlocked(StreamId stream_id, SocketId socket_id)
 {
 #ifdef SLIQ_DEBUG
-  LogD(kClassName, __func__, "Conn %" PRISocketId ": Socket is now "
-       "blocked.\n", socket_id_);
+  LogD(kClassName, __func__, "Conn %" PRISocketId ": Socket %" PRISocketId
+       " is now blocked.\n", socket_id_, socket_id);
 #endif
 
   // The socket is now write blocked.
-  is_write_blocked_ = true;
-  socket_mgr_.UpdateEvents(socket_id_, kFdEventReadWrite);
+  is_write_blocked_        = true;
+  write_blocked_socket_id_ = socket_id;
+  socket_mgr_.UpdateEvents(socket_id, kFdEventReadWrite);
   app_.ProcessFileDescriptorChange();
 
   // Mark the stream as blocked.
@@ -5197,7 +6042,7 @@ bool Connection::ClearWriteBlocked(StreamId& reblocked_stream_id)
 
   // The socket is no longer write blocked.
   is_write_blocked_ = false;
-  socket_mgr_.UpdateEvents(socket_id_, kFdEventRead);
+  socket_mgr_.UpdateEvents(write_blocked_socket_id_, kFdEventRead);
   app_.ProcessFileDescriptorChange();
 
   // Find the stream that is blocked and complete the send that was
@@ -5663,6 +6508,8 @@ void Connection::SendTimeout(CcId cc_id)
     return;
   }
 
+  ++stats_send_timer_wakeups_;
+
   // If the socket is not write blocked, then attempt to send packets.
   if (!is_write_blocked_)
   {
@@ -6339,6 +7186,263 @@ Stream* Connection::GetStream(StreamId stream_id) const
   return stream_info_[stream_id].stream;
 }
 
+//============================================================================
+bool Connection::ExpandCompactSeqNum(DataHeader& data_hdr) const
+{
+  if (!data_hdr.compact_flag)
+  {
+    return true;
+  }
+
+  // The truncated packet sequence number can only be expanded using the
+  // stream's received packet state.
+  Stream*  stream = GetStream(data_hdr.stream_id);
+
+  if (stream == NULL)
+  {
+#ifdef SLIQ_DEBUG
+    LogD(kClassName, __func__, "Conn %" PRISocketId ": Compact data header "
+         "for unknown stream %" PRIStreamId ", dropping.\n", socket_id_,
+         data_hdr.stream_id);
+#endif
+    return false;
+  }
+
+  stream->ExpandCompactSeqNum(data_hdr);
+
+  return true;
+}
+//============================================================================
+size_t Connection::GetCtrlPath() const
+{
+  for (size_t path = 0; path < num_paths_; ++path)
+  {
+    if (!paths_[path].is_failed_)
+    {
+      return path;
+    }
+  }
+
+  return 0;
+}
+
+//============================================================================
+bool Connection::IsPathFailed(const Time& now, size_t path)
+{
+  PathInfo&  path_info = paths_[path];
+
+  // Data packets that have gone unanswered for longer than the path's
+  // retransmission timeout mark the path as failed.
+  if ((!path_info.is_failed_) && (!path_info.unans_send_time_.IsZero()) &&
+      ((now - path_info.unans_send_time_) > path_info.rtt_mgr_.GetRtoTime()))
+  {
+    path_info.is_failed_       = true;
+    path_info.next_probe_time_ = (now + Time(kPathProbeIntervalSec));
+
+    LogW(kClassName, __func__, "Conn %" PRISocketId ": Path %zu to %s has "
+         "failed, moving traffic to the other paths.\n", socket_id_, path,
+         GetPathPeerAddr(path).ToString().c_str());
+
+    // Packets still in flight on the failed path will not be ACKed, so
+    // have them retransmitted on the other paths right away.
+    ForceUnackedPacketsLost(now, static_cast<int>(path));
+  }
+
+  if (!path_info.is_failed_)
+  {
+    return false;
+  }
+
+  // A failed path is still used if all of the other paths have failed too.
+  for (size_t i = 0; i < num_paths_; ++i)
+  {
+    if (!paths_[i].is_failed_)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//============================================================================
+void Connection::RecordPathSend(const Time& now, size_t path)
+{
+  PathInfo&  path_info = paths_[path];
+
+  if (path_info.unans_send_time_.IsZero())
+  {
+    path_info.unans_send_time_ = now;
+  }
+
+  ++path_info.pkts_sent_;
+}
+
+//============================================================================
+void Connection::RecordPathRecv(size_t path)
+{
+  PathInfo&  path_info = paths_[path];
+
+  path_info.unans_send_time_.Zero();
+
+  if (path_info.is_failed_)
+  {
+    path_info.is_failed_ = false;
+
+    LogI(kClassName, __func__, "Conn %" PRISocketId ": Path %zu to %s has "
+         "recovered.\n", socket_id_, path,
+         GetPathPeerAddr(path).ToString().c_str());
+  }
+}
+
+//============================================================================
+bool Connection::HasUsableResumeState(const Time& now)
+{
+  ConnectionManager::ResumeInfo*  info = conn_mgr_.GetResumeInfo(resume_peer_);
+
+  return ((info != NULL) && info->has_state_ &&
+          ((now - info->save_time_) <= Time(kResumeMaxAgeSec)));
+}
+
+//============================================================================
+void Connection::SetupServerResume(const ConnHndshkHeader& hdr)
+{
+  resume_        = false;
+  resume_token_  = 0;
+  resume_peer_   = peer_addr_;
+
+  if (!app_.fast_reconnect())
+  {
+    return;
+  }
+
+  // Issue a token for the peer if it does not have one yet.
+  Time                            now  = Time::Now();
+  ConnectionManager::ResumeInfo&  info = conn_mgr_.AddResumeInfo(
+    resume_peer_);
+
+  if (info.token_ == 0)
+  {
+    info.token_     = (static_cast<uint32_t>(rng_.GetInt(0x7ffffffe)) + 1);
+    info.save_time_ = now;
+  }
+
+  // Only resume if the client presented the token for the cached state.
+  resume_       = (hdr.resume_flag && (hdr.resume_token == info.token_) &&
+                   HasUsableResumeState(now));
+  resume_token_ = info.token_;
+}
+
+//============================================================================
+void Connection::ProcessServerResume(const ConnHndshkHeader& hdr)
+{
+  if ((!app_.fast_reconnect()) || (hdr.resume_token == 0))
+  {
+    resume_ = false;
+    return;
+  }
+
+  // Only resume if the server has the same cached state.
+  resume_ = (resume_ && hdr.resume_flag &&
+             (hdr.resume_token == resume_token_));
+
+  // Record the server's token.  A new token means that any cached state is
+  // from an older server instance, and must not be used again.
+  ConnectionManager::ResumeInfo&  info = conn_mgr_.AddResumeInfo(
+    resume_peer_);
+
+  if (info.token_ != hdr.resume_token)
+  {
+    info.token_     = hdr.resume_token;
+    info.has_state_ = false;
+    info.save_time_ = Time::Now();
+  }
+
+  resume_token_ = hdr.resume_token;
+}
+
+//============================================================================
+void Connection::ResumeCachedState(const Time& now)
+{
+  ConnectionManager::ResumeInfo*  info = conn_mgr_.GetResumeInfo(resume_peer_);
+
+  if ((info == NULL) || (!info->has_state_))
+  {
+    resume_ = false;
+    return;
+  }
+
+  LogA(kClassName, __func__, "Conn %" PRISocketId ": Resuming from state "
+       "cached for peer %s: min rtt %s per %f capacity %f Mbps.\n",
+       socket_id_, resume_peer_.ToString().c_str(),
+       info->min_rtt_.ToString().c_str(), info->per_,
+       (info->chan_cap_est_bps_ / 1.0e6));
+
+  // Start the PER estimate, and thus the FEC parameters, from the cached
+  // value.
+  stats_local_per_ = info->per_;
+
+  // Let each congestion control algorithm start from its cached state.  The
+  // algorithms must match the ones that the state was saved from.
+  for (size_t i = 0; ((i < cc_algs_.num_cc_alg) && (i < info->num_cc_alg_));
+       ++i)
+  {
+    CongCtrlInterface*  cc_alg = cc_algs_.cc_alg[i].cc_alg;
+
+    if ((cc_alg != NULL) &&
+        (cc_alg->GetCongestionControlType() == info->alg_[i]))
+    {
+      cc_alg->Resume(now, info->min_rtt_, info->cwnd_[i], info->rate_[i]);
+    }
+  }
+
+  // Report a scaled version of the cached capacity estimates right away,
+  // instead of waiting for the first collection interval to end.
+  do_cap_est_callback_       = true;
+  cc_algs_.chan_cap_est_bps  = (kResumeCapEstScale *
+                                info->chan_cap_est_bps_);
+  cc_algs_.trans_cap_est_bps = (kResumeCapEstScale *
+                                info->trans_cap_est_bps_);
+  cc_algs_.ccl_time_sec      = 0.0;
+}
+
+//============================================================================
+void Connection::SaveResumeState(const Time& now)
+{
+  ConnectionManager::ResumeInfo&  info = conn_mgr_.AddResumeInfo(
+    resume_peer_);
+
+  // The entry may have been reused for another peer since the handshake.
+  info.token_             = resume_token_;
+  info.has_state_         = true;
+  info.save_time_         = now;
+  info.min_rtt_           = rtt_mgr_.minimum_rtt();
+  info.per_               = stats_local_per_;
+  info.chan_cap_est_bps_  = cc_algs_.chan_cap_est_bps;
+  info.trans_cap_est_bps_ = cc_algs_.trans_cap_est_bps;
+  info.num_cc_alg_        = 0;
+
+  if (info.min_rtt_.IsZero())
+  {
+    info.min_rtt_ = rtt_mgr_.smoothed_rtt();
+  }
+
+  for (size_t i = 0; i < cc_algs_.num_cc_alg; ++i)
+  {
+    CongCtrlInterface*  cc_alg = cc_algs_.cc_alg[i].cc_alg;
+
+    if (cc_alg == NULL)
+    {
+      break;
+    }
+
+    info.alg_[i]  = cc_alg->GetCongestionControlType();
+    info.cwnd_[i] = cc_alg->GetCongestionWindow();
+    info.rate_[i] = cc_alg->SendRate();
+    ++info.num_cc_alg_;
+  }
+}
+
 //============================================================================
 bool Connection::StreamIdIsValid(StreamId stream_id) const
 {
@@ -6503,6 +7607,19 @@ bool Connection::CongCtrlSettingIsValid(CongCtrl& alg,
            "control: Copa\n", socket_id_);
       return true;
 
+    case TCP_BBR_CC:
+      if (allow_updates)
+      {
+        alg.cubic_reno_pacing  = false;
+        alg.deterministic_copa = false;
+        alg.copa_delta         = 0.0;
+        alg.copa_anti_jitter   = 0.0;
+      }
+
+      LogI(kClassName, __func__, "Conn %" PRISocketId ": Using congestion "
+           "control: BBR\n", socket_id_);
+      return true;
+
     case FIXED_RATE_TEST_CC:
       // The connection handshake header only has a 32-bit field for
       // congestion control parameters.
@@ -6601,6 +7718,9 @@ const char* Connection::CongCtrlAlgToString(const CongCtrl& alg) const
     case COPA_CC:
       return "Copa";
 
+    case TCP_BBR_CC:
+      return "TCP BBR";
+
     case FIXED_RATE_TEST_CC:
       snprintf(tmp_str, sizeof(tmp_str), "Fixed Rate %" PRICapacity " bps",
                alg.fixed_send_rate);
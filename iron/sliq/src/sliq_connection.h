@@ -226,6 +226,30 @@ namespace sliq
     /// \return  True on success, or false otherwise.
     bool ConnectToServer(const iron::Ipv4Endpoint& server_address);
 
+    /// \brief Add a network path to a data connection.
+    ///
+    /// Opens a new UDP socket bound to the local address and connected to
+    /// the remote address, which is normally on a different local interface
+    /// than the connection's original socket.  The peer must add the mirror
+    /// image path.  Path N carries the data packets, ACK packets, and
+    /// retransmissions paced by the congestion control algorithm with CCID
+    /// N, where the original socket is path 0, so the connection must use at
+    /// least as many congestion control algorithms as paths.  All paths share
+    /// the connection's streams and packet sequence number spaces, so lost
+    /// packets may be retransmitted on any path.
+    ///
+    /// \param  local_addr      A reference to the local IP address and port
+    ///                         number to use.
+    /// \param  remote_addr     A reference to the remote IP address and port
+    ///                         number to use.
+    /// \param  path_socket_id  A reference to where the new path's socket ID
+    ///                         will be returned on success.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool AddPath(const iron::Ipv4Endpoint& local_addr,
+                 const iron::Ipv4Endpoint& remote_addr,
+                 SocketId& path_socket_id);
+
     /// \brief Add a new stream.
     ///
     /// The stream IDs must be between 1 and 32 (inclusive), must be odd on
@@ -259,6 +283,59 @@ namespace sliq
     /// \param  enable_rtt_or  The RTT outlier rejection setting.
     void ConfigureRttOutlierRejection(bool enable_rtt_or);
 
+    /// \brief Update the per-path RTT estimates with a new RTT sample.
+    ///
+    /// The connection's RTT manager must be updated separately.  Until a
+    /// second path is added, every congestion control algorithm shares the
+    /// one path and gets every sample.
+    ///
+    /// \param  now    The current time.
+    /// \param  cc_id  The CCID of the packet that the RTT was measured on.
+    /// \param  rtt    The RTT sample.
+    void UpdatePathRtt(const iron::Time& now, CcId cc_id,
+                       const iron::Time& rtt);
+
+    /// \brief Configure earliest departure time (EDT) send pacing.
+    ///
+    /// When enabled, a data packet that the congestion control pacing would
+    /// release within the horizon is written to the socket immediately,
+    /// stamped with its departure time, and the kernel holds it until then.
+    /// This replaces one send timer wakeup per packet with one per horizon.
+    /// If the socket does not support transmit times, then the send pacing
+    /// timers continue to be used.
+    ///
+    /// \param  horizon_sec  The EDT horizon in seconds.  Zero disables EDT
+    ///                      send pacing.
+    ///
+    /// \return  Returns true on success, or false if EDT send pacing could
+    ///          not be enabled.
+    bool ConfigureEdtPacing(double horizon_sec);
+
+    /// \brief Configure adaptive ACK frequency.
+    ///
+    /// When enabled, the data packets sent periodically carry an ACK
+    /// frequency header asking the peer to send one ACK packet for every N
+    /// data packets received, or after a maximum ACK delay, where N and the
+    /// delay are derived from the current send rate and RTT estimates.  This
+    /// reduces the number of ACK packets at high send rates.
+    ///
+    /// \param  enable  The adaptive ACK frequency setting.
+    ///
+    /// \return  Returns true on success, or false otherwise.
+    bool ConfigureAckFrequency(bool enable);
+
+    /// \brief Configure coalesced ACK processing.
+    ///
+    /// When enabled, the ACK packets read from the socket in one batch are
+    /// all processed before loss detection, the congestion control ACK
+    /// processing updates, and the sending of new packets are done once for
+    /// the batch.
+    ///
+    /// \param  enable  The coalesced ACK processing setting.
+    ///
+    /// \return  Returns true on success, or false otherwise.
+    bool ConfigureAckCoalescing(bool enable);
+
     /// \brief Configure a stream's transmit queue.
     ///
     /// \param  stream_id      The stream ID.
@@ -348,6 +425,23 @@ namespace sliq
     /// \return  True on success, or false otherwise.
     bool GetTransmitQueueSizeInPackets(StreamId stream_id, size_t& size);
 
+    /// \brief Get the stream's packet transmission statistics.
+    ///
+    /// \param  stream_id  The stream ID of interest.
+    /// \param  stats      A reference to where the statistics are returned
+    ///                    on success.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool GetSendStats(StreamId stream_id, SendStats& stats);
+
+    /// \brief Get the coalesced ACK processing statistics.
+    ///
+    /// \param  stats  A reference to where the statistics are returned on
+    ///                success.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool GetAckBatchStats(AckBatchStats& stats);
+
     /// \brief Called when a stream's transmit queue size changes.
     ///
     /// \param  stream_id  The stream ID of the transmit queue.
@@ -576,6 +670,38 @@ namespace sliq
       return peer_addr_;
     }
 
+    /// \brief Get the number of network paths used by the connection.
+    ///
+    /// \return  The number of paths, including the original socket's path.
+    inline size_t num_paths() const
+    {
+      return num_paths_;
+    }
+
+    /// \brief Check if the path used by a congestion control algorithm is
+    /// currently marked as failed.
+    ///
+    /// \param  cc_id  The congestion control identifier.
+    ///
+    /// \return  True if the path is marked as failed, or false otherwise.
+    inline bool IsCcPathFailed(CcId cc_id) const
+    {
+      return paths_[GetCcPath(cc_id)].is_failed_;
+    }
+
+    /// \brief Check if a socket belongs to one of the connection's added
+    /// paths.
+    ///
+    /// \param  socket_id  The socket ID to check.
+    ///
+    /// \return  True if the socket is an added path's socket.
+    inline bool IsPathSocket(SocketId socket_id) const
+    {
+      size_t  path = 0;
+
+      return (GetPathIndex(socket_id, path) && (path > 0));
+    }
+
     /// \brief Get the local timestamp clock correction value.
     ///
     /// \return  The local timestamp clock correction value.
@@ -632,6 +758,28 @@ namespace sliq
       return cc_algs_.send_rate_est_bps;
     }
 
+    /// \brief Get the number of ACK packets sent per data packet received
+    /// for the connection.
+    ///
+    /// \return  The ACK packets sent per data packet received.
+    inline double StatsGetAcksPerDataPkt() const
+    {
+      return ((stats_rcv_rpc_hdr_.rcvd_data_pkt_count == 0) ? 0.0 :
+              (static_cast<double>(stats_ack_pkts_sent_) /
+               static_cast<double>(stats_rcv_rpc_hdr_.rcvd_data_pkt_count)));
+    }
+
+    /// \brief Get the number of SLIQ header bytes sent in data and ACK
+    /// packets per payload byte sent for the connection.
+    ///
+    /// \return  The header bytes sent per payload byte sent.
+    inline double StatsGetHdrBytesPerPldByte() const
+    {
+      return ((stats_snd_pld_bytes_ == 0) ? 0.0 :
+              (static_cast<double>(stats_snd_hdr_bytes_) /
+               static_cast<double>(stats_snd_pld_bytes_)));
+    }
+
    private:
 
     /// \brief Copy constructor.
@@ -747,7 +895,9 @@ namespace sliq
     bool SendRcvdPktCnt();
 
     /// \brief Receive packets and process them.
-    void ReceivePackets();
+    ///
+    /// \param  path  The index of the path to receive packets on.
+    void ReceivePackets(size_t path);
 
     /// \brief Process a received connection handshake header.
     ///
@@ -853,10 +1003,30 @@ namespace sliq
 
     /// \brief Process a received ACK header.
     ///
+    /// Unless coalesced ACK processing is enabled, CompleteAckProcessing()
+    /// is called before returning.
+    ///
     /// \param  hdr       The received header.
     /// \param  rcv_time  The receive time.
     void ProcessAck(AckHeader& hdr, const iron::Time& rcv_time);
 
+    /// \brief Complete the processing of the received ACK headers.
+    ///
+    /// Completes the ACK processing in each stream that has received an ACK
+    /// header since the last call, then updates the retransmission timer.
+    ///
+    /// \param  now  The current time.
+    void CompleteAckProcessing(const iron::Time& now);
+
+    /// \brief Finish the processing of received ACK packets.
+    ///
+    /// Processes the implicit ACKs, stops the ACK packet processing on the
+    /// congestion control algorithms, and sends as many packets as possible.
+    ///
+    /// \param  ack_stream_mask  A mask of stream IDs that have received an
+    ///                          ACK header.
+    void FinishAckPktProcessing(uint64_t ack_stream_mask);
+
     /// \brief Process an implicit ACK.
     ///
     /// \param  ack_stream_mask  A mask of stream IDs that have received an
@@ -875,6 +1045,11 @@ namespace sliq
     /// \param  hdr  The received connection measurement header.
     void ProcessConnMeasInfo(ConnMeasHeader& hdr);
 
+    /// \brief Process a received ACK frequency header.
+    ///
+    /// \param  hdr  The received ACK frequency header.
+    void ProcessAckFreqInfo(AckFreqHeader& hdr);
+
     /// \brief Immediately send an ACK packet and record that it was sent.
     ///
     /// \param  now        The current time.
@@ -941,6 +1116,17 @@ namespace sliq
     void AddConnMeas(const iron::Time& now, size_t rsvd_len,
                      iron::Packet*& pkt);
 
+    /// \brief Add an ACK frequency header to a packet if it is needed and
+    /// if it will fit.
+    ///
+    /// \param  now       The current time.
+    /// \param  rsvd_len  The reserved packet length in bytes.
+    /// \param  pkt       A reference to a pointer to the packet where the ACK
+    ///                   frequency header will be appended.  If NULL, then a
+    ///                   packet will be generated and placed in this pointer.
+    void AddAckFreq(const iron::Time& now, size_t rsvd_len,
+                    iron::Packet*& pkt);
+
     /// \brief Check if all of the stream data being sent is currently ACKed.
     ///
     /// \return  True if all of the stream data is currently ACKed, or false
@@ -950,8 +1136,10 @@ namespace sliq
     /// \brief Force all of the unACKed packets in each stream to be
     /// considered lost.
     ///
-    /// \param  now  The current time.
-    void ForceUnackedPacketsLost(const iron::Time& now);
+    /// \param  now    The current time.
+    /// \param  cc_id  The congestion control identifier that the packets
+    ///                must have been sent with, or -1 for all packets.
+    void ForceUnackedPacketsLost(const iron::Time& now, int cc_id = -1);
 
     /// \brief Check if the peer has been heard from recently.
     ///
@@ -978,7 +1166,8 @@ namespace sliq
     ///
     /// \param  stream_id  The stream ID of the stream that was sending on the
     ///                    socket when the write blocked.
-    void SetWriteBlocked(StreamId stream_id);
+    /// \param  socket_id  The socket ID of the socket that is blocked.
+    void SetWriteBlocked(StreamId stream_id, SocketId socket_id);
 
     /// \brief Unset the socket as write blocked.
     ///
@@ -1123,6 +1312,147 @@ namespace sliq
     ///          it is not found.
     Stream* GetStream(StreamId stream_id) const;
 
+    /// \brief Expand the truncated packet sequence number in a received
+    /// compact data header.
+    ///
+    /// Full data headers are left unchanged.
+    ///
+    /// \param  data_hdr  A reference to the received data header.
+    ///
+    /// \return  True if the data header may be processed, or false if it
+    ///          must be dropped.
+    bool ExpandCompactSeqNum(DataHeader& data_hdr) const;
+
+    /// \brief Find the path that uses a socket.
+    ///
+    /// \param  socket_id  The socket ID.
+    /// \param  path       A reference to where the path index is returned.
+    ///
+    /// \return  True if the socket belongs to one of the paths, or false
+    ///          otherwise.
+    inline bool GetPathIndex(SocketId socket_id, size_t& path) const
+    {
+      for (path = 0; path < num_paths_; ++path)
+      {
+        if (GetPathSocketId(path) == socket_id)
+        {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    /// \brief Get the path used by a congestion control algorithm.
+    ///
+    /// \param  cc_id  The CCID.
+    ///
+    /// \return  The path index.  Congestion control algorithms without a
+    ///          path of their own use path 0.
+    inline size_t GetCcPath(CcId cc_id) const
+    {
+      return ((cc_id < num_paths_) ? static_cast<size_t>(cc_id) : 0);
+    }
+
+    /// \brief Get the socket ID of a path.
+    ///
+    /// \param  path  The path index.
+    ///
+    /// \return  The socket ID.
+    inline SocketId GetPathSocketId(size_t path) const
+    {
+      return ((path == 0) ? socket_id_ : paths_[path].socket_id_);
+    }
+
+    /// \brief Get the peer's address and port number on a path.
+    ///
+    /// \param  path  The path index.
+    ///
+    /// \return  The peer's address and port number.
+    inline const iron::Ipv4Endpoint& GetPathPeerAddr(size_t path) const
+    {
+      return ((path == 0) ? peer_addr_ : paths_[path].peer_addr_);
+    }
+
+    /// \brief Check if an address is the peer's address on any path.
+    ///
+    /// \param  addr  The address and port number to check.
+    ///
+    /// \return  True if the address is one of the peer's addresses.
+    inline bool IsPeerAddr(const iron::Ipv4Endpoint& addr) const
+    {
+      for (size_t path = 0; path < num_paths_; ++path)
+      {
+        if (GetPathPeerAddr(path) == addr)
+        {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    /// \brief Get the path to use for connection control packets.
+    ///
+    /// \return  Path 0, unless it has failed and another path has not.
+    size_t GetCtrlPath() const;
+
+    /// \brief Check if a path has failed.
+    ///
+    /// A path fails when the data packets sent on it go unanswered for
+    /// longer than the path's retransmission timeout.  It recovers as soon
+    /// as any packet is received on it.  A failed path is not reported as
+    /// failed while all of the other paths have failed too.
+    ///
+    /// \param  now   The current time.
+    /// \param  path  The path index.
+    ///
+    /// \return  True if the path has failed, or false otherwise.
+    bool IsPathFailed(const iron::Time& now, size_t path);
+
+    /// \brief Record that a data packet was sent on a path.
+    ///
+    /// \param  now   The current time.
+    /// \param  path  The path index.
+    void RecordPathSend(const iron::Time& now, size_t path);
+
+    /// \brief Record that a packet was received on a path.
+    ///
+    /// \param  path  The path index.
+    void RecordPathRecv(size_t path);
+
+    /// \brief Check if there is cached fast reconnection state for the peer
+    /// that is recent enough to resume from.
+    ///
+    /// \param  now  The current time.
+    ///
+    /// \return  True if the cached state may be used, or false otherwise.
+    bool HasUsableResumeState(const iron::Time& now);
+
+    /// \brief Decide if a server data endpoint resumes from cached state,
+    /// and get the resumption token to send to the client.
+    ///
+    /// \param  hdr  A reference to the received client hello header.
+    void SetupServerResume(const ConnHndshkHeader& hdr);
+
+    /// \brief Decide if a client data endpoint resumes from cached state,
+    /// and record the server's resumption token.
+    ///
+    /// \param  hdr  A reference to the received server hello header.
+    void ProcessServerResume(const ConnHndshkHeader& hdr);
+
+    /// \brief Start the connection from the cached fast reconnection state.
+    ///
+    /// Called once the connection is established.
+    ///
+    /// \param  now  The current time.
+    void ResumeCachedState(const iron::Time& now);
+
+    /// \brief Save the connection's state to the fast reconnection cache.
+    ///
+    /// \param  now  The current time.
+    void SaveResumeState(const iron::Time& now);
+
     /// \brief Check if the specified stream ID is valid.
     ///
     /// \param  stream_id  The stream ID.
@@ -1397,6 +1727,130 @@ namespace sliq
       iron::Time  max_ltr_owd_;
     };
 
+    /// \brief The structure of state information for adaptive ACK
+    /// frequency.
+    ///
+    /// The send side advertises the ACK ratio and maximum ACK delay that it
+    /// wants the peer to use in ACK frequency headers.  The receive side
+    /// stores the values most recently advertised by the peer, which start
+    /// out as the fixed ACK policy values.
+    struct AckFreqInfo
+    {
+      AckFreqInfo()
+          : enable_(false), next_af_hdr_seq_(0), sent_ratio_(0),
+            sent_delay_usec_(0), last_send_time_(), init_(false),
+            af_hdr_seq_(0), ack_ratio_(kAckAfterDataPktCnt),
+            max_ack_delay_(0, kAckTimerUsec)
+      {}
+
+      virtual ~AckFreqInfo()
+      {}
+
+      /// The send side adaptive ACK frequency setting.
+      bool        enable_;
+
+      /// The next ACK frequency header sequence number.
+      uint16_t    next_af_hdr_seq_;
+
+      /// The ACK ratio last sent to the peer.  Zero if none has been sent.
+      uint8_t     sent_ratio_;
+
+      /// The maximum ACK delay, in microseconds, last sent to the peer.
+      uint32_t    sent_delay_usec_;
+
+      /// The time that the last ACK frequency header was sent.
+      iron::Time  last_send_time_;
+
+      /// The receive side initialization flag.
+      bool        init_;
+
+      /// The last received ACK frequency header sequence number.
+      uint16_t    af_hdr_seq_;
+
+      /// The number of data packets to receive before sending an ACK packet.
+      size_t      ack_ratio_;
+
+      /// The maximum time to delay an ACK packet.
+      iron::Time  max_ack_delay_;
+    };
+
+    /// \brief The structure of state information for coalesced ACK
+    /// processing.
+    ///
+    /// The stream masks must be sized to have at least kStreamArraySize
+    /// bits.
+    struct AckCoalesceInfo
+    {
+      AckCoalesceInfo()
+          : enable_(false), leaving_outage_(false), cmpl_stream_mask_(0),
+            ack_stream_mask_(0), ack_cnt_(0), ack_pkt_cnt_(0)
+      {}
+
+      virtual ~AckCoalesceInfo()
+      {}
+
+      /// The coalesced ACK processing setting.
+      bool      enable_;
+
+      /// The flag recording if an outage was exited by the ACK headers.
+      bool      leaving_outage_;
+
+      /// The mask of stream IDs waiting for ACK processing completion.
+      uint64_t  cmpl_stream_mask_;
+
+      /// The mask of stream IDs that have received an ACK header.
+      uint64_t  ack_stream_mask_;
+
+      /// The number of ACK headers in the current receive batch.
+      size_t    ack_cnt_;
+
+      /// The number of ACK packets in the current receive batch.
+      size_t    ack_pkt_cnt_;
+    };
+
+    /// \brief The structure of state information for a network path.
+    ///
+    /// Path 0 uses the connection's socket and addresses, so only its RTT
+    /// manager and failover state are used.
+    struct PathInfo
+    {
+      PathInfo()
+          : socket_id_(-1), self_addr_(), peer_addr_(), rtt_mgr_(),
+            unans_send_time_(), next_probe_time_(), is_failed_(false),
+            pkts_sent_(0)
+      {}
+
+      virtual ~PathInfo()
+      {}
+
+      /// The UDP socket file descriptor.
+      SocketId            socket_id_;
+
+      /// The local address and port number.
+      iron::Ipv4Endpoint  self_addr_;
+
+      /// The peer's address and port number.
+      iron::Ipv4Endpoint  peer_addr_;
+
+      /// The RTT manager for the path, used by the path's congestion control
+      /// algorithm.
+      RttManager          rtt_mgr_;
+
+      /// The send time of the oldest data packet sent on the path since a
+      /// packet was last received on it.  Zero if there is none.
+      iron::Time          unans_send_time_;
+
+      /// The earliest time that a data packet may probe the path while it is
+      /// failed.
+      iron::Time          next_probe_time_;
+
+      /// The failed flag.
+      bool                is_failed_;
+
+      /// The number of data packets sent on the path.
+      uint64_t            pkts_sent_;
+    };
+
     // ---------- Components Used By Connections ----------
 
     /// The SLIQ application.
@@ -1449,6 +1903,9 @@ namespace sliq
     /// A flag to record if writing to the UDP socket is blocked.
     bool                 is_write_blocked_;
 
+    /// The UDP socket that writing is blocked on.
+    SocketId             write_blocked_socket_id_;
+
     /// A flag to record if the connection is in a retransmission timeout.
     bool                 is_in_rto_;
 
@@ -1570,6 +2027,42 @@ namespace sliq
     /// Computed remotely and transferred via connection measurement headers.
     LtrOwdInfo           ltr_owd_;
 
+    // ---------- Adaptive ACK Frequency ----------
+
+    /// The adaptive ACK frequency information.
+    AckFreqInfo          ack_freq_;
+
+    // ---------- Coalesced ACK Processing ----------
+
+    /// The coalesced ACK processing information.
+    AckCoalesceInfo      ack_coal_;
+
+    // ---------- Compact Headers ----------
+
+    /// The flag recording if compact data and ACK headers are used.
+    bool                 compact_hdrs_;
+
+    // ---------- Multipath ----------
+
+    /// The number of network paths, including the original socket's path.
+    size_t               num_paths_;
+
+    /// The network path information.  Indexed by path index, which is also
+    /// the CCID of the congestion control algorithm used on the path.
+    PathInfo             paths_[SliqApp::kMaxCcAlgPerConn];
+
+    // ---------- Fast Reconnection ----------
+
+    /// The flag recording if the connection resumes, or is asking to resume,
+    /// from cached state.
+    bool                 resume_;
+
+    /// The resumption token issued by the server.  Zero if not in use.
+    uint32_t             resume_token_;
+
+    /// The peer address that the cached state is stored under.
+    iron::Ipv4Endpoint   resume_peer_;
+
     // ---------- Close Connection Callbacks ----------
 
     /// Perform the close connection callback.
@@ -1604,6 +2097,45 @@ namespace sliq
     /// The last received packet count to be received.
     PktCount             stats_last_rpc_;
 
+    /// The number of send pacing timer callbacks.
+    uint64_t             stats_send_timer_wakeups_;
+
+    /// The number of data packets released ahead of their departure time
+    /// using EDT send pacing.  Each one is a send pacing timer wakeup saved.
+    uint64_t             stats_edt_early_sends_;
+
+    /// The number of ACK packets sent at the receive side.
+    uint64_t             stats_ack_pkts_sent_;
+
+    /// The number of receive batches with ACK packets that were processed
+    /// using coalesced ACK processing.
+    uint64_t             stats_ack_batches_;
+
+    /// The number of ACK packets in the coalesced receive batches.
+    uint64_t             stats_ack_batch_pkts_;
+
+    /// The number of ACK headers in the coalesced receive batches.
+    uint64_t             stats_ack_batch_hdrs_;
+
+    /// The number of congestion control ACK processing start/done cycles
+    /// saved by coalesced ACK processing.
+    uint64_t             stats_ack_batch_cc_saved_;
+
+    /// The number of SLIQ header bytes sent in data and ACK packets.
+    uint64_t             stats_snd_hdr_bytes_;
+
+    /// The number of payload bytes sent in data packets.
+    uint64_t             stats_snd_pld_bytes_;
+
+    // ---------- Earliest Departure Time Send Pacing ----------
+
+    /// The EDT horizon.  Zero when EDT send pacing is disabled.
+    iron::Time           edt_horizon_;
+
+    /// The departure delay for the next data packet written, as granted by
+    /// the last CanSend() or CanResend() call.
+    iron::Time           edt_depart_delay_;
+
     // ---------- Specialized Members ----------
 
     /// Perform callbacks to the application in the destructor.
@@ -67,12 +67,13 @@ namespace
 
 //============================================================================
 ConnectionManager::ConnectionManager(Timer& timer)
-    : timer_(timer), connections_(), reaper_size_(0), reaper_list_(),
-      reaper_timer_()
+    : timer_(timer), connections_(), path_owners_(), reaper_size_(0),
+      reaper_list_(), reaper_timer_(), resume_cache_()
 {
   for (size_t i = 0; i < kNumBlocks; ++i)
   {
     connections_[i] = NULL;
+    path_owners_[i] = NULL;
   }
 
   memset(reaper_list_, 0, sizeof(reaper_list_));
@@ -103,6 +104,16 @@ ConnectionManager::~ConnectionManager()
     }
   }
 
+  // Delete the path socket mappings.
+  for (size_t i = 0; i < kNumBlocks; ++i)
+  {
+    if (path_owners_[i] != NULL)
+    {
+      delete [] path_owners_[i];
+      path_owners_[i] = NULL;
+    }
+  }
+
   // Cancel any timers.
   timer_.CancelTimer(reaper_timer_);
 
@@ -210,6 +221,125 @@ Connection* ConnectionManager::GetConnectionByPeer(const Ipv4Endpoint& peer)
   return NULL;
 }
 
+//============================================================================
+bool ConnectionManager::AddPathSocket(SocketId socket_id, EndptId endpt_id)
+{
+  // Make sure that the mapping will fit in the 2D array.
+  if ((socket_id < 0) ||
+      (static_cast<size_t>(socket_id) >= (kNumBlocks * kNumConnsPerBlock)))
+  {
+    LogE(kClassName, __func__, "Path socket ID %" PRISocketId " cannot be "
+         "stored.\n", socket_id);
+    return false;
+  }
+
+  // Compute the location for this mapping.
+  size_t  block_index = (static_cast<size_t>(socket_id) / kNumConnsPerBlock);
+  size_t  sock_index  = (static_cast<size_t>(socket_id) % kNumConnsPerBlock);
+
+  // Add a new block of mappings if needed.
+  if (path_owners_[block_index] == NULL)
+  {
+    path_owners_[block_index] = new (std::nothrow) EndptId[kNumConnsPerBlock];
+
+    if (path_owners_[block_index] == NULL)
+    {
+      LogE(kClassName, __func__, "Error allocating block of path socket "
+           "mappings.\n");
+      return false;
+    }
+
+    for (size_t i = 0; i < kNumConnsPerBlock; ++i)
+    {
+      path_owners_[block_index][i] = -1;
+    }
+  }
+
+  path_owners_[block_index][sock_index] = endpt_id;
+
+  return true;
+}
+
+//============================================================================
+ConnectionManager::ResumeInfo* ConnectionManager::GetResumeInfo(
+  const Ipv4Endpoint& peer)
+{
+  for (size_t i = 0; i < kResumeCacheSize; ++i)
+  {
+    if ((resume_cache_[i].token_ != 0) && (resume_cache_[i].peer_ == peer))
+    {
+      return &(resume_cache_[i]);
+    }
+  }
+
+  return NULL;
+}
+
+//============================================================================
+ConnectionManager::ResumeInfo& ConnectionManager::AddResumeInfo(
+  const Ipv4Endpoint& peer)
+{
+  ResumeInfo*  info = GetResumeInfo(peer);
+
+  if (info != NULL)
+  {
+    return *info;
+  }
+
+  // Use an unused entry, or else the least recently saved one.
+  size_t  idx = 0;
+
+  for (size_t i = 0; i < kResumeCacheSize; ++i)
+  {
+    if (resume_cache_[i].token_ == 0)
+    {
+      idx = i;
+      break;
+    }
+
+    if (resume_cache_[i].save_time_ < resume_cache_[idx].save_time_)
+    {
+      idx = i;
+    }
+  }
+
+  resume_cache_[idx]       = ResumeInfo();
+  resume_cache_[idx].peer_ = peer;
+
+  return resume_cache_[idx];
+}
+
+//============================================================================
+Connection* ConnectionManager::GetConnectionByPathSocket(SocketId socket_id)
+{
+  if ((socket_id < 0) ||
+      (static_cast<size_t>(socket_id) >= (kNumBlocks * kNumConnsPerBlock)))
+  {
+    return NULL;
+  }
+
+  size_t  block_index = (static_cast<size_t>(socket_id) / kNumConnsPerBlock);
+
+  if (path_owners_[block_index] == NULL)
+  {
+    return NULL;
+  }
+
+  // The connection that the socket was mapped to may have been destroyed, or
+  // the socket ID may have been reused, so verify the mapping.
+  size_t       sock_index = (static_cast<size_t>(socket_id) %
+                             kNumConnsPerBlock);
+  Connection*  conn       = GetConnection(
+    path_owners_[block_index][sock_index]);
+
+  if ((conn == NULL) || (!conn->IsPathSocket(socket_id)))
+  {
+    return NULL;
+  }
+
+  return conn;
+}
+
 //============================================================================
 bool ConnectionManager::DeleteConnection(EndptId endpt_id)
 {
@@ -310,3 +440,14 @@ void ConnectionManager::ReaperTimeout()
 
   reaper_size_ = 0;
 }
+
+//============================================================================
+ConnectionManager::ResumeInfo::ResumeInfo()
+    : peer_(), token_(0), has_state_(false), save_time_(), min_rtt_(),
+      per_(0.0), chan_cap_est_bps_(0.0), trans_cap_est_bps_(0.0),
+      num_cc_alg_(0), alg_(), cwnd_(), rate_()
+{}
+
+//============================================================================
+ConnectionManager::ResumeInfo::~ResumeInfo()
+{}
@@ -38,10 +38,12 @@
 #ifndef IRON_SLIQ_CONNECTION_MANAGER_H
 #define IRON_SLIQ_CONNECTION_MANAGER_H
 
+#include "sliq_app.h"
 #include "sliq_private_types.h"
 #include "sliq_types.h"
 
 #include "ipv4_endpoint.h"
+#include "itime.h"
 #include "timer.h"
 
 
@@ -55,6 +57,56 @@ namespace sliq
 
    public:
 
+    /// \brief Structure for the state cached for fast reconnection to a
+    /// peer.
+    ///
+    /// An entry is created with a resumption token when a connection to the
+    /// peer is established, and the state is updated while the connection
+    /// is healthy.  A later connection to the same peer may start from the
+    /// state if both endpoints still have the same token.
+    struct ResumeInfo
+    {
+      ResumeInfo();
+      virtual ~ResumeInfo();
+
+      /// The peer's IPv4 address and UDP port number.
+      iron::Ipv4Endpoint  peer_;
+
+      /// The resumption token issued by the server.  Zero if the entry is
+      /// not in use.
+      uint32_t            token_;
+
+      /// A flag recording if the state below has been saved.
+      bool                has_state_;
+
+      /// The time that the state was last saved.
+      iron::Time          save_time_;
+
+      /// The minimum RTT estimate.
+      iron::Time          min_rtt_;
+
+      /// The packet error rate (PER) estimate for data packets sent.
+      double              per_;
+
+      /// The channel capacity estimate, in bits per second.
+      double              chan_cap_est_bps_;
+
+      /// The transport capacity estimate, in bits per second.
+      double              trans_cap_est_bps_;
+
+      /// The number of congestion control algorithms.
+      size_t              num_cc_alg_;
+
+      /// The type of each congestion control algorithm.
+      CongCtrlAlg         alg_[SliqApp::kMaxCcAlgPerConn];
+
+      /// The congestion window size of each algorithm, in bytes.
+      size_t              cwnd_[SliqApp::kMaxCcAlgPerConn];
+
+      /// The send rate estimate of each algorithm, in bits per second.
+      Capacity            rate_[SliqApp::kMaxCcAlgPerConn];
+    };
+
     /// \brief Constructor.
     ///
     /// \param  timer  A reference to the timer object.
@@ -98,6 +150,30 @@ namespace sliq
     ///          otherwise.
     Connection* GetConnectionByPeer(const iron::Ipv4Endpoint& peer);
 
+    /// \brief Map an added path's socket to its connection.
+    ///
+    /// The connection remains owned by the connection manager under its
+    /// endpoint ID.  Any earlier mapping for the socket is replaced.
+    ///
+    /// \param  socket_id  The path's socket ID.
+    /// \param  endpt_id   The endpoint ID of the connection that owns the
+    ///                    path.
+    ///
+    /// \return  True if the mapping was added successfully, or false
+    ///          otherwise.
+    bool AddPathSocket(SocketId socket_id, EndptId endpt_id);
+
+    /// \brief Get a connection by one of its added paths' sockets.
+    ///
+    /// The object remains owned by the connection manager.  This is a fast
+    /// lookup.
+    ///
+    /// \param  socket_id  The path's socket ID.
+    ///
+    /// \return  A pointer to the connection object if it is found, or NULL
+    ///          otherwise.
+    Connection* GetConnectionByPathSocket(SocketId socket_id);
+
     /// \brief Schedule a connection for deletion.
     ///
     /// The connection object, if found, is scheduled to be destroyed at a
@@ -110,6 +186,23 @@ namespace sliq
     ///          destruction, or false otherwise.
     bool DeleteConnection(EndptId endpt_id);
 
+    /// \brief Get the cached fast reconnection state for a peer.
+    ///
+    /// \param  peer  The peer's IPv4 address and UDP port number.
+    ///
+    /// \return  A pointer to the entry if it is found, or NULL otherwise.
+    ResumeInfo* GetResumeInfo(const iron::Ipv4Endpoint& peer);
+
+    /// \brief Get the cached fast reconnection state for a peer, creating
+    /// an empty entry if there is none.
+    ///
+    /// When the cache is full, the least recently saved entry is reused.
+    ///
+    /// \param  peer  The peer's IPv4 address and UDP port number.
+    ///
+    /// \return  A reference to the entry.
+    ResumeInfo& AddResumeInfo(const iron::Ipv4Endpoint& peer);
+
    private:
 
     /// \brief Copy constructor.
@@ -130,12 +223,20 @@ namespace sliq
     /// The number of elements in the reaper list.
     static const size_t  kMaxReaperSize    = 16;
 
+    /// The number of peers with cached fast reconnection state.
+    static const size_t  kResumeCacheSize  = 16;
+
     /// The timer.
     iron::Timer&         timer_;
 
     /// A 2D array of all connections objects for fast lookups.
     Connection**         connections_[kNumBlocks];
 
+    /// A 2D array of the endpoint IDs of the connections that own added
+    /// path sockets, indexed by socket ID.  The entries are never cleared, so
+    /// the connection is always checked for the socket before it is used.
+    EndptId*             path_owners_[kNumBlocks];
+
     /// The number of connections to be destroyed.
     size_t               reaper_size_;
 
@@ -145,6 +246,9 @@ namespace sliq
     /// The reaper timer handle.
     iron::Timer::Handle  reaper_timer_;
 
+    /// The cached fast reconnection state for recent peers.
+    ResumeInfo           resume_cache_[kResumeCacheSize];
+
   }; // end class ConnectionManager
 
 }  // namespace sliq
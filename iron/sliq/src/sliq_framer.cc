@@ -49,6 +49,7 @@
 #include <inttypes.h>
 
 
+using ::sliq::AckFreqHeader;
 using ::sliq::AckHeader;
 using ::sliq::CcPktTrainHeader;
 using ::sliq::CcSyncHeader;
@@ -102,7 +103,8 @@ Packet* Framer::GenerateConnHndshk(const ConnHndshkHeader& input)
 
   // Build the header.
   if ((!WriteUint8(CONNECTION_HANDSHAKE_HEADER, packet)) ||
-      (!WriteUint8(cnt, packet)) ||
+      (!WriteUint8((cnt | (input.compact_flag ? 0x80 : 0x00) |
+                   (input.resume_flag ? 0x40 : 0x00)), packet)) ||
       (!WriteUint16(input.message_tag, packet)) ||
       (!WriteUint32(input.timestamp, packet)) ||
       (!WriteUint32(input.echo_timestamp, packet)))
@@ -145,6 +147,16 @@ Packet* Framer::GenerateConnHndshk(const ConnHndshkHeader& input)
     return NULL;
   }
 
+  // Append the resumption token, if there is one.
+  if ((input.resume_token != 0) && (!WriteUint32(input.resume_token, packet)))
+  {
+    LogE(kClassName, __func__, "Error generating connection handshake "
+         "resumption token.\n");
+    TRACK_UNEXPECTED_DROP(kClassName, packet_pool_);
+    packet_pool_.Recycle(packet);
+    return NULL;
+  }
+
   return packet;
 }
 
@@ -219,7 +231,8 @@ Packet* Framer::GenerateCreateStream(const CreateStreamHeader& input)
   }
 
   // Generate the necessary fields.
-  uint8_t   flags   = ((input.del_time_flag ? 0x02 : 0x00) |
+  uint8_t   flags   = ((input.sliding_win_flag ? 0x04 : 0x00) |
+                       (input.del_time_flag ? 0x02 : 0x00) |
                        (input.ack_flag ? 0x01 : 0x00));
   uint8_t   del_rel = (((static_cast<uint8_t>(input.delivery_mode) & 0x0f)
                         << 4) |
@@ -327,20 +340,76 @@ bool Framer::AppendDataHeader(Packet*& packet, const DataHeader& input,
                     (input.fin_flag ? 0x01 : 0x00));
 
   // Build the header.
-  if ((!WriteUint8(DATA_HEADER, packet)) ||
-      (!WriteUint8(flags, packet)) ||
-      (!WriteUint8(input.stream_id, packet)) ||
-      (!WriteUint8(input.num_ttg, packet)) ||
-      (!WriteUint8(input.cc_id, packet)) ||
-      (!WriteUint8(input.retransmission_count, packet)) ||
-      (!WriteUint16(payload_length, packet)) ||
-      (!WriteUint32(input.sequence_number, packet)) ||
-      (!WriteUint32(input.timestamp, packet)) ||
-      (!WriteUint32(input.timestamp_delta, packet)))
+  if (input.compact_flag)
   {
-    LogE(kClassName, __func__, "Error generating data header common "
-         "fields.\n");
-    return false;
+    // The compact format sends only the low-order bytes of the packet
+    // sequence number and does not send the payload length.
+    size_t  seq_len = (((input.seq_num_length >= 1) &&
+                        (input.seq_num_length <= 4)) ?
+                       input.seq_num_length : 4);
+    bool    seq_ok  = false;
+
+    flags |= (0x80 | static_cast<uint8_t>((seq_len - 1) << 2));
+
+    if ((!WriteUint8(DATA_HEADER, packet)) ||
+        (!WriteUint8(flags, packet)) ||
+        (!WriteUint8(input.stream_id, packet)) ||
+        (!WriteUint8((((input.cc_id & 0x07) << 5) | (input.num_ttg & 0x1f)),
+                     packet)) ||
+        (!WriteUint8(input.retransmission_count, packet)))
+    {
+      LogE(kClassName, __func__, "Error generating compact data header "
+           "common fields.\n");
+      return false;
+    }
+
+    switch (seq_len)
+    {
+      case 1:
+        seq_ok = WriteUint8(static_cast<uint8_t>(input.sequence_number),
+                            packet);
+        break;
+
+      case 2:
+        seq_ok = WriteUint16(static_cast<uint16_t>(input.sequence_number),
+                             packet);
+        break;
+
+      case 3:
+        seq_ok = WriteUint24(input.sequence_number, packet);
+        break;
+
+      default:
+        seq_ok = WriteUint32(input.sequence_number, packet);
+    }
+
+    if ((!seq_ok) ||
+        (!WriteUint32(input.timestamp, packet)) ||
+        (!WriteVarInt32(static_cast<int32_t>(input.timestamp_delta),
+                        packet)))
+    {
+      LogE(kClassName, __func__, "Error generating compact data header "
+           "sequence number and timestamp fields.\n");
+      return false;
+    }
+  }
+  else
+  {
+    if ((!WriteUint8(DATA_HEADER, packet)) ||
+        (!WriteUint8(flags, packet)) ||
+        (!WriteUint8(input.stream_id, packet)) ||
+        (!WriteUint8(input.num_ttg, packet)) ||
+        (!WriteUint8(input.cc_id, packet)) ||
+        (!WriteUint8(input.retransmission_count, packet)) ||
+        (!WriteUint16(payload_length, packet)) ||
+        (!WriteUint32(input.sequence_number, packet)) ||
+        (!WriteUint32(input.timestamp, packet)) ||
+        (!WriteUint32(input.timestamp_delta, packet)))
+    {
+      LogE(kClassName, __func__, "Error generating data header common "
+           "fields.\n");
+      return false;
+    }
   }
 
   // Append the move forward packet sequence number field if needed.
@@ -359,6 +428,7 @@ bool Framer::AppendDataHeader(Packet*& packet, const DataHeader& input,
   {
     uint16_t  tmp =
       (((static_cast<uint16_t>(input.fec_pkt_type) & 0x01) << 15) |
+       (input.fec_win_flag ? 0x4000 : 0x0000) |
        ((static_cast<uint16_t>(input.fec_group_index) & 0x3f) << 8) |
        ((static_cast<uint16_t>(input.fec_num_src) & 0x0f) << 4) |
        (static_cast<uint16_t>(input.fec_round) & 0x0f));
@@ -369,6 +439,16 @@ bool Framer::AppendDataHeader(Packet*& packet, const DataHeader& input,
       LogE(kClassName, __func__, "Error appending FEC fields.\n");
       return false;
     }
+
+    if (input.fec_win_flag)
+    {
+      if ((!WriteUint8(static_cast<uint8_t>(input.fec_win_start), packet)) ||
+          (!WriteUint8(0, packet)))
+      {
+        LogE(kClassName, __func__, "Error appending FEC window field.\n");
+        return false;
+      }
+    }
   }
 
   // Append the encoded packet length field if needed.
@@ -436,6 +516,17 @@ bool Framer::AppendAckHeader(Packet*& packet, const AckHeader& input)
     }
   }
 
+  // Use the compact format only if it is possible and actually smaller.
+  if (input.compact_flag)
+  {
+    size_t  compact_size = ComputeCompactAckHeaderSize(input);
+
+    if ((compact_size > 0) && (compact_size < ComputeAckHeaderSize(input)))
+    {
+      return AppendCompactAckHeader(packet, input);
+    }
+  }
+
   // Generate the flags and number of observed times/ACK block offsets fields.
   uint8_t  flags     = 0;
   uint8_t  num_field = (((input.num_observed_times & 0x07) << 5) |
@@ -483,6 +574,126 @@ bool Framer::AppendAckHeader(Packet*& packet, const AckHeader& input)
   return true;
 }
 
+//============================================================================
+size_t Framer::ComputeCompactAckHeaderSize(const AckHeader& input)
+{
+  size_t  size = (kAckHdrCompactBaseSize +
+                  VarInt32Size(static_cast<int32_t>(input.timestamp_delta)));
+
+  for (uint8_t i = 0; i < (input.num_observed_times & 0x07); ++i)
+  {
+    size += VarInt32Size(static_cast<int32_t>(
+                           input.observed_time[i].seq_num -
+                           input.next_expected_seq_num));
+
+    if (i == 0)
+    {
+      size += sizeof(PktTimestamp);
+    }
+    else
+    {
+      size += VarInt32Size(static_cast<int32_t>(
+                             input.observed_time[i].timestamp -
+                             input.observed_time[i - 1].timestamp));
+    }
+  }
+
+  for (uint8_t j = 0; j < (input.num_ack_block_offsets & 0x1f); ++j)
+  {
+    uint16_t  offset = input.ack_block_offset[j].offset;
+
+    if (offset > kAckHdrCompactMaxAbo)
+    {
+      return 0;
+    }
+
+    size += ((offset > kAckHdrCompactMaxShortAbo) ? 2 : 1);
+  }
+
+  return size;
+}
+
+//============================================================================
+bool Framer::AppendCompactAckHeader(Packet* packet, const AckHeader& input)
+{
+  uint8_t  flags     = 0x80;
+  uint8_t  num_field = (((input.num_observed_times & 0x07) << 5) |
+                        (input.num_ack_block_offsets & 0x1f));
+
+  // Build the common fields for the header.
+  if ((!WriteUint8(ACK_HEADER, packet)) ||
+      (!WriteUint8(flags, packet)) ||
+      (!WriteUint8(input.stream_id, packet)) ||
+      (!WriteUint8(num_field, packet)) ||
+      (!WriteUint32(input.next_expected_seq_num, packet)) ||
+      (!WriteUint32(input.timestamp, packet)) ||
+      (!WriteVarInt32(static_cast<int32_t>(input.timestamp_delta), packet)))
+  {
+    LogE(kClassName, __func__, "Error generating compact ack header common "
+         "fields.\n");
+    return false;
+  }
+
+  // Append all of the observed packet times.  Sequence numbers are relative
+  // to the next expected sequence number, and all timestamps after the first
+  // are relative to the previous timestamp.
+  for (uint8_t i = 0; i < (input.num_observed_times & 0x07); ++i)
+  {
+    bool  ok = WriteVarInt32(static_cast<int32_t>(
+                               input.observed_time[i].seq_num -
+                               input.next_expected_seq_num), packet);
+
+    if (ok)
+    {
+      if (i == 0)
+      {
+        ok = WriteUint32(input.observed_time[i].timestamp, packet);
+      }
+      else
+      {
+        ok = WriteVarInt32(static_cast<int32_t>(
+                             input.observed_time[i].timestamp -
+                             input.observed_time[i - 1].timestamp), packet);
+      }
+    }
+
+    if (!ok)
+    {
+      LogE(kClassName, __func__, "Error appending compact observed time.\n");
+      return false;
+    }
+  }
+
+  // Append all of the ACK block offsets using one or two bytes each.
+  for (uint8_t j = 0; j < (input.num_ack_block_offsets & 0x1f); ++j)
+  {
+    uint16_t  offset = input.ack_block_offset[j].offset;
+    uint8_t   type   = (static_cast<uint8_t>(input.ack_block_offset[j].type) &
+                        0x01);
+    bool      abo_ok = false;
+
+    if (offset <= kAckHdrCompactMaxShortAbo)
+    {
+      abo_ok = WriteUint8(((type << 6) | static_cast<uint8_t>(offset)),
+                          packet);
+    }
+    else
+    {
+      abo_ok = WriteUint16((0x8000 | (static_cast<uint16_t>(type) << 14) |
+                            (offset & kAckHdrCompactMaxAbo)), packet);
+    }
+
+    if (!abo_ok)
+    {
+      LogE(kClassName, __func__, "Error appending compact ACK block "
+           "offset.\n");
+      return false;
+    }
+  }
+
+  return true;
+}
+
 //============================================================================
 bool Framer::AppendCcSyncHeader(Packet*& packet, const CcSyncHeader& input)
 {
@@ -585,6 +796,33 @@ bool Framer::AppendConnMeasHeader(Packet*& packet,
   return true;
 }
 
+//============================================================================
+bool Framer::AppendAckFreqHeader(Packet*& packet, const AckFreqHeader& input)
+{
+  if (packet == NULL)
+  {
+    packet = packet_pool_.Get();
+
+    if (packet == NULL)
+    {
+      LogE(kClassName, __func__, "Error getting packet from pool.\n");
+      return false;
+    }
+  }
+
+  // Build the header.
+  if ((!WriteUint8(ACK_FREQ_HEADER, packet)) ||
+      (!WriteUint8(input.ack_ratio, packet)) ||
+      (!WriteUint16(input.sequence_number, packet)) ||
+      (!WriteUint32(input.max_ack_delay_usec, packet)))
+  {
+    LogE(kClassName, __func__, "Error generating ACK frequency header.\n");
+    return false;
+  }
+
+  return true;
+}
+
 //============================================================================
 Packet* Framer::GenerateCcPktTrain(const CcPktTrainHeader& input,
                                    size_t payload_length)
@@ -646,7 +884,7 @@ HeaderType Framer::GetHeaderType(const Packet* packet, size_t offset)
   }
 
   // Test the most likely success case first for efficiency.
-  if (((type_byte >= DATA_HEADER) && (type_byte <= CONN_MEAS_HEADER)) ||
+  if (((type_byte >= DATA_HEADER) && (type_byte <= ACK_FREQ_HEADER)) ||
       ((type_byte >= CONNECTION_HANDSHAKE_HEADER) &&
        (type_byte <= RESET_STREAM_HEADER)) ||
       (type_byte == CC_PKT_TRAIN_HEADER))
@@ -676,6 +914,12 @@ bool Framer::ParseConnHndshkHeader(const Packet* packet, size_t& offset,
     return false;
   }
 
+  // Split the compact headers and resume flags from the number of
+  // algorithms.
+  output.compact_flag = ((output.num_cc_algs & 0x80) != 0);
+  output.resume_flag  = ((output.num_cc_algs & 0x40) != 0);
+  output.num_cc_algs &= 0x3f;
+
   // Parse all of the congestion control algorithm settings.
   uint8_t   alg_type = 0;
   uint8_t   flags    = 0;
@@ -723,6 +967,12 @@ bool Framer::ParseConnHndshkHeader(const Packet* packet, size_t& offset,
     output.client_id = 0;
   }
 
+  // Parse the resumption token, if present.
+  if (!ReadUint32(packet, offset, output.resume_token))
+  {
+    output.resume_token = 0;
+  }
+
   return true;
 }
 
@@ -802,6 +1052,7 @@ bool Framer::ParseCreateStreamHeader(const Packet* packet,
   // Skip the unused 2 bytes at the end.
   offset += 2;
 
+  output.sliding_win_flag = ((flags & 0x04) != 0);
   output.del_time_flag    = ((flags & 0x02) != 0);
   output.ack_flag         = ((flags & 0x01) != 0);
   output.delivery_mode    = static_cast<DeliveryMode>((del_rel >> 4) & 0x0f);
@@ -858,20 +1109,86 @@ bool Framer::ParseDataHeader(Packet* packet, size_t& offset,
   uint8_t   flags   = 0;
   uint16_t  pld_len = 0;
 
-  if ((!ReadUint8(packet, offset, flags)) ||
-      (!ReadUint8(packet, offset, output.stream_id)) ||
-      (!ReadUint8(packet, offset, output.num_ttg)) ||
-      (!ReadUint8(packet, offset, output.cc_id)) ||
-      (!ReadUint8(packet, offset, output.retransmission_count)) ||
-      (!ReadUint16(packet, offset, pld_len)) ||
-      (!ReadUint32(packet, offset, output.sequence_number)) ||
-      (!ReadUint32(packet, offset, output.timestamp)) ||
-      (!ReadUint32(packet, offset, output.timestamp_delta)))
+  if (!ReadUint8(packet, offset, flags))
   {
-    LogE(kClassName, __func__, "Error parsing data header.\n");
+    LogE(kClassName, __func__, "Error parsing data header flags.\n");
     return false;
   }
 
+  output.compact_flag = ((flags & 0x80) != 0);
+
+  if (output.compact_flag)
+  {
+    // The compact format carries a truncated packet sequence number, which
+    // the caller must expand, and no payload length.
+    uint8_t   cc_ttg   = 0;
+    uint8_t   seq8     = 0;
+    uint16_t  seq16    = 0;
+    int32_t   ts_delta = 0;
+    bool      seq_ok   = false;
+
+    output.seq_num_length = (((flags >> 2) & 0x03) + 1);
+
+    if ((!ReadUint8(packet, offset, output.stream_id)) ||
+        (!ReadUint8(packet, offset, cc_ttg)) ||
+        (!ReadUint8(packet, offset, output.retransmission_count)))
+    {
+      LogE(kClassName, __func__, "Error parsing compact data header.\n");
+      return false;
+    }
+
+    output.cc_id   = ((cc_ttg >> 5) & 0x07);
+    output.num_ttg = (cc_ttg & 0x1f);
+
+    switch (output.seq_num_length)
+    {
+      case 1:
+        seq_ok                 = ReadUint8(packet, offset, seq8);
+        output.sequence_number = seq8;
+        break;
+
+      case 2:
+        seq_ok                 = ReadUint16(packet, offset, seq16);
+        output.sequence_number = seq16;
+        break;
+
+      case 3:
+        seq_ok = ReadUint24(packet, offset, output.sequence_number);
+        break;
+
+      default:
+        seq_ok = ReadUint32(packet, offset, output.sequence_number);
+    }
+
+    if ((!seq_ok) ||
+        (!ReadUint32(packet, offset, output.timestamp)) ||
+        (!ReadVarInt32(packet, offset, ts_delta)))
+    {
+      LogE(kClassName, __func__, "Error parsing compact data header "
+           "sequence number and timestamp fields.\n");
+      return false;
+    }
+
+    output.timestamp_delta = static_cast<PktTimestamp>(ts_delta);
+  }
+  else
+  {
+    output.seq_num_length = sizeof(PktSeqNumber);
+
+    if ((!ReadUint8(packet, offset, output.stream_id)) ||
+        (!ReadUint8(packet, offset, output.num_ttg)) ||
+        (!ReadUint8(packet, offset, output.cc_id)) ||
+        (!ReadUint8(packet, offset, output.retransmission_count)) ||
+        (!ReadUint16(packet, offset, pld_len)) ||
+        (!ReadUint32(packet, offset, output.sequence_number)) ||
+        (!ReadUint32(packet, offset, output.timestamp)) ||
+        (!ReadUint32(packet, offset, output.timestamp_delta)))
+    {
+      LogE(kClassName, __func__, "Error parsing data header.\n");
+      return false;
+    }
+  }
+
   output.enc_pkt_len_flag = ((flags & 0x40) != 0);
   output.fec_flag         = ((flags & 0x20) != 0);
   output.move_fwd_flag    = ((flags & 0x10) != 0);
@@ -910,9 +1227,29 @@ bool Framer::ParseDataHeader(Packet* packet, size_t& offset,
     }
 
     output.fec_pkt_type    = static_cast<FecPktType>((tmp >> 15) & 0x01);
+    output.fec_win_flag    = ((tmp & 0x4000) != 0);
     output.fec_group_index = static_cast<FecSize>((tmp >> 8) & 0x3f);
     output.fec_num_src     = static_cast<FecSize>((tmp >> 4) & 0x0f);
     output.fec_round       = static_cast<FecRound>(tmp & 0x0f);
+
+    if (output.fec_win_flag)
+    {
+      uint8_t  win_start = 0;
+      uint8_t  unused    = 0;
+
+      if ((!ReadUint8(packet, offset, win_start)) ||
+          (!ReadUint8(packet, offset, unused)))
+      {
+        LogE(kClassName, __func__, "Error parsing FEC window field.\n");
+        return false;
+      }
+
+      output.fec_win_start = static_cast<FecSize>(win_start);
+    }
+    else
+    {
+      output.fec_win_start = 0;
+    }
   }
 
   // Parse the encoded packet length field if needed.
@@ -968,7 +1305,7 @@ bool Framer::ParseDataHeader(Packet* packet, size_t& offset,
   output.payload_length = (packet->GetLengthInBytes() - offset);
   output.payload        = packet;
 
-  if (pld_len != output.payload_length)
+  if ((!output.compact_flag) && (pld_len != output.payload_length))
   {
     if (pld_len < output.payload_length)
     {
@@ -993,25 +1330,38 @@ bool Framer::ParseDataHeader(Packet* packet, size_t& offset,
 bool Framer::ParseAckHeader(const Packet* packet, size_t& offset,
                             AckHeader& output)
 {
-  // Skip the packet type byte and the flags byte.
-  offset += 2;
+  // Skip the packet type byte.
+  offset += 1;
 
   // Parse the header.
-  uint8_t  num_field;
+  uint8_t  flags     = 0;
+  uint8_t  num_field = 0;
 
-  if ((!ReadUint8(packet, offset, output.stream_id)) ||
-      (!ReadUint8(packet, offset, num_field)) ||
-      (!ReadUint32(packet, offset, output.next_expected_seq_num)) ||
-      (!ReadUint32(packet, offset, output.timestamp)) ||
-      (!ReadUint32(packet, offset, output.timestamp_delta)))
+  if ((!ReadUint8(packet, offset, flags)) ||
+      (!ReadUint8(packet, offset, output.stream_id)) ||
+      (!ReadUint8(packet, offset, num_field)))
   {
     LogE(kClassName, __func__, "Error parsing ACK header.\n");
     return false;
   }
 
+  output.compact_flag          = ((flags & 0x80) != 0);
   output.num_observed_times    = ((num_field >> 5) & 0x07);
   output.num_ack_block_offsets = (num_field & 0x1f);
 
+  if (output.compact_flag)
+  {
+    return ParseCompactAckHeader(packet, offset, output);
+  }
+
+  if ((!ReadUint32(packet, offset, output.next_expected_seq_num)) ||
+      (!ReadUint32(packet, offset, output.timestamp)) ||
+      (!ReadUint32(packet, offset, output.timestamp_delta)))
+  {
+    LogE(kClassName, __func__, "Error parsing ACK header.\n");
+    return false;
+  }
+
   // Parse all of the observed packet times.
   for (uint8_t i = 0; i < output.num_observed_times; ++i)
   {
@@ -1042,6 +1392,96 @@ bool Framer::ParseAckHeader(const Packet* packet, size_t& offset,
   return true;
 }
 
+//============================================================================
+bool Framer::ParseCompactAckHeader(const Packet* packet, size_t& offset,
+                                   AckHeader& output)
+{
+  int32_t  ts_delta = 0;
+
+  if ((!ReadUint32(packet, offset, output.next_expected_seq_num)) ||
+      (!ReadUint32(packet, offset, output.timestamp)) ||
+      (!ReadVarInt32(packet, offset, ts_delta)))
+  {
+    LogE(kClassName, __func__, "Error parsing compact ACK header.\n");
+    return false;
+  }
+
+  output.timestamp_delta = static_cast<PktTimestamp>(ts_delta);
+
+  // Parse all of the observed packet times.
+  for (uint8_t i = 0; i < output.num_observed_times; ++i)
+  {
+    int32_t  seq_off = 0;
+    int32_t  ts_diff = 0;
+    bool     ts_ok   = false;
+
+    if (!ReadVarInt32(packet, offset, seq_off))
+    {
+      LogE(kClassName, __func__, "Error parsing compact observed time.\n");
+      return false;
+    }
+
+    if (i == 0)
+    {
+      ts_ok = ReadUint32(packet, offset, output.observed_time[i].timestamp);
+    }
+    else
+    {
+      ts_ok = ReadVarInt32(packet, offset, ts_diff);
+
+      output.observed_time[i].timestamp =
+        (output.observed_time[i - 1].timestamp +
+         static_cast<PktTimestamp>(ts_diff));
+    }
+
+    if (!ts_ok)
+    {
+      LogE(kClassName, __func__, "Error parsing compact observed time.\n");
+      return false;
+    }
+
+    output.observed_time[i].seq_num = (output.next_expected_seq_num +
+                                       static_cast<PktSeqNumber>(seq_off));
+  }
+
+  // Parse all of the one or two byte ACK block offsets.
+  for (uint8_t j = 0; j < output.num_ack_block_offsets; ++j)
+  {
+    uint8_t  tmp = 0;
+
+    if (!ReadUint8(packet, offset, tmp))
+    {
+      LogE(kClassName, __func__, "Error parsing compact ACK block "
+           "offset.\n");
+      return false;
+    }
+
+    output.ack_block_offset[j].type = static_cast<AckBlkType>((tmp >> 6) &
+                                                              0x01);
+
+    if ((tmp & 0x80) == 0)
+    {
+      output.ack_block_offset[j].offset = (tmp & 0x3f);
+    }
+    else
+    {
+      uint8_t  low = 0;
+
+      if (!ReadUint8(packet, offset, low))
+      {
+        LogE(kClassName, __func__, "Error parsing compact ACK block "
+             "offset.\n");
+        return false;
+      }
+
+      output.ack_block_offset[j].offset =
+        ((static_cast<uint16_t>(tmp & 0x3f) << 8) | low);
+    }
+  }
+
+  return true;
+}
+
 //============================================================================
 bool Framer::ParseCcSyncHeader(const Packet* packet, size_t& offset,
                                CcSyncHeader& output)
@@ -1116,6 +1556,25 @@ bool Framer::ParseConnMeasHeader(const Packet* packet, size_t& offset,
   return true;
 }
 
+//============================================================================
+bool Framer::ParseAckFreqHeader(const Packet* packet, size_t& offset,
+                                AckFreqHeader& output)
+{
+  // Skip the packet type byte.
+  offset += 1;
+
+  // Parse the header.
+  if ((!ReadUint8(packet, offset, output.ack_ratio)) ||
+      (!ReadUint16(packet, offset, output.sequence_number)) ||
+      (!ReadUint32(packet, offset, output.max_ack_delay_usec)))
+  {
+    LogE(kClassName, __func__, "Error parsing ACK frequency header.\n");
+    return false;
+  }
+
+  return true;
+}
+
 //============================================================================
 bool Framer::ParseCcPktTrainHeader(const Packet* packet, size_t& offset,
                                    CcPktTrainHeader& output)
@@ -1314,18 +1773,80 @@ bool Framer::ReadInt32(const Packet* packet, size_t& offset,
   return true;
 }
 
+//============================================================================
+bool Framer::WriteVarInt32(int32_t value, Packet* packet)
+{
+  size_t    packet_len = packet->GetLengthInBytes();
+  uint32_t  zz         = ZigZagEncode(value);
+  uint8_t   buf[kMaxVarInt32Size];
+  size_t    len        = 0;
+
+  do
+  {
+    buf[len] = static_cast<uint8_t>(zz & 0x7f);
+    zz     >>= 7;
+
+    if (zz != 0)
+    {
+      buf[len] |= 0x80;
+    }
+
+    ++len;
+  }
+  while (zz != 0);
+
+  if ((packet_len + len) > packet->GetMaxLengthInBytes())
+  {
+    return false;
+  }
+
+  ::memcpy(reinterpret_cast<void*>(packet->GetBuffer(packet_len)), buf, len);
+
+  return packet->SetLengthInBytes(packet_len + len);
+}
+
+//============================================================================
+bool Framer::ReadVarInt32(const Packet* packet, size_t& offset,
+                          int32_t& result)
+{
+  size_t    packet_len = packet->GetLengthInBytes();
+  uint32_t  zz         = 0;
+
+  for (size_t i = 0; i < kMaxVarInt32Size; ++i)
+  {
+    if ((offset + i) >= packet_len)
+    {
+      return false;
+    }
+
+    uint8_t  byte = *(packet->GetBuffer(offset + i));
+
+    zz |= (static_cast<uint32_t>(byte & 0x7f) << (7 * i));
+
+    if ((byte & 0x80) == 0)
+    {
+      result  = ZigZagDecode(zz);
+      offset += (i + 1);
+      return true;
+    }
+  }
+
+  return false;
+}
+
 //============================================================================
 ConnHndshkHeader::ConnHndshkHeader()
-    : num_cc_algs(0), message_tag(0), timestamp(0), echo_timestamp(0),
-      client_id(0), cc_alg()
+    : compact_flag(false), resume_flag(false), num_cc_algs(0), message_tag(0),
+      timestamp(0), echo_timestamp(0), client_id(0), resume_token(0), cc_alg()
 {}
 
 //============================================================================
 ConnHndshkHeader::ConnHndshkHeader(uint8_t num_alg, MsgTag tag,
                                    PktTimestamp ts, PktTimestamp echo_ts,
                                    ClientId id, CongCtrl* alg)
-    : num_cc_algs(num_alg), message_tag(tag), timestamp(ts),
-      echo_timestamp(echo_ts), client_id(id), cc_alg()
+    : compact_flag(false), resume_flag(false), num_cc_algs(num_alg),
+      message_tag(tag), timestamp(ts), echo_timestamp(echo_ts), client_id(id),
+      resume_token(0), cc_alg()
 {
   if (alg == NULL)
   {
@@ -1437,7 +1958,8 @@ CloseConnHeader::CloseConnHeader(bool ack, ConnCloseCode reason)
 
 //============================================================================
 CreateStreamHeader::CreateStreamHeader()
-    : del_time_flag(false), ack_flag(false), stream_id(0),
+    : sliding_win_flag(false), del_time_flag(false), ack_flag(false),
+      stream_id(0),
       priority(kLowestPriority), initial_win_size_pkts(kFlowCtrlWindowPkts),
       initial_seq_num(0), delivery_mode(ORDERED_DELIVERY),
       reliability_mode(RELIABLE_ARQ),
@@ -1449,8 +1971,10 @@ CreateStreamHeader::CreateStreamHeader()
 CreateStreamHeader::CreateStreamHeader(
   bool tm, bool ack, StreamId sid, Priority prio, WindowSize win_size,
   PktSeqNumber seq_num, DeliveryMode del_mode, ReliabilityMode rel_mode,
-  RexmitLimit limit, RexmitRounds del_rnds, double del_time, double recv_p)
-    : del_time_flag(tm), ack_flag(ack), stream_id(sid), priority(prio),
+  RexmitLimit limit, RexmitRounds del_rnds, double del_time, double recv_p,
+  bool sliding_win)
+    : sliding_win_flag(sliding_win), del_time_flag(tm), ack_flag(ack),
+      stream_id(sid), priority(prio),
       initial_win_size_pkts(win_size), initial_seq_num(seq_num),
       delivery_mode(del_mode), reliability_mode(rel_mode),
       rexmit_limit(limit), fec_target_pkt_del_rounds(del_rnds),
@@ -1476,6 +2000,7 @@ void CreateStreamHeader::GetReliability(Reliability& rel)
   {
     rel.fec_target_pkt_recv_prob = fec_target_pkt_recv_prob;
     rel.fec_del_time_flag        = del_time_flag;
+    rel.fec_sliding_win          = sliding_win_flag;
 
     if (del_time_flag)
     {
@@ -1494,6 +2019,7 @@ void CreateStreamHeader::GetReliability(Reliability& rel)
     rel.fec_del_time_flag           = false;
     rel.fec_target_pkt_del_rounds   = 0;
     rel.fec_target_pkt_del_time_sec = 0.0;
+    rel.fec_sliding_win             = false;
   }
 }
 
@@ -1510,13 +2036,15 @@ ResetStreamHeader::ResetStreamHeader(StreamId sid, StreamErrorCode error,
 
 //============================================================================
 DataHeader::DataHeader()
-    : enc_pkt_len_flag(false), fec_flag(false), move_fwd_flag(false),
+    : compact_flag(false), seq_num_length(sizeof(PktSeqNumber)),
+      enc_pkt_len_flag(false), fec_flag(false), move_fwd_flag(false),
       persist_flag(false), fin_flag(false), stream_id(0),
       num_ttg(0), cc_id(0), retransmission_count(0), sequence_number(0),
       timestamp(0), timestamp_delta(0), move_fwd_seq_num(0),
       fec_pkt_type(FEC_SRC_PKT), fec_group_index(0), fec_num_src(0),
-      fec_round(0), fec_group_id(0), encoded_pkt_length(0), ttg(),
-      payload_offset(0), payload_length(0), payload(NULL)
+      fec_round(0), fec_group_id(0), fec_win_flag(false), fec_win_start(0),
+      encoded_pkt_length(0), ttg(), payload_offset(0), payload_length(0),
+      payload(NULL)
 {}
 
 //============================================================================
@@ -1527,28 +2055,31 @@ DataHeader::DataHeader(bool epl, bool fec, bool move_fwd, bool persist,
                        PktSeqNumber mf_seq_num, FecPktType fec_type,
                        FecSize fec_idx, FecSize fec_src, FecRound fec_rnd,
                        FecGroupId fec_grp, FecEncPktLen enc_pkt_len)
-    : enc_pkt_len_flag(epl), fec_flag(fec), move_fwd_flag(move_fwd),
+    : compact_flag(false), seq_num_length(sizeof(PktSeqNumber)),
+      enc_pkt_len_flag(epl), fec_flag(fec), move_fwd_flag(move_fwd),
       persist_flag(persist), fin_flag(fin), stream_id(sid),
       num_ttg(ttgs), cc_id(id), retransmission_count(rx_cnt),
       sequence_number(seq_num), timestamp(ts), timestamp_delta(ts_delta),
       move_fwd_seq_num(mf_seq_num), fec_pkt_type(fec_type),
       fec_group_index(fec_idx), fec_num_src(fec_src), fec_round(fec_rnd),
-      fec_group_id(fec_grp), encoded_pkt_length(enc_pkt_len),
-      ttg(), payload_offset(0), payload_length(0), payload(NULL)
+      fec_group_id(fec_grp), fec_win_flag(false), fec_win_start(0),
+      encoded_pkt_length(enc_pkt_len), ttg(), payload_offset(0),
+      payload_length(0), payload(NULL)
 {}
 
 //============================================================================
 AckHeader::AckHeader()
-    : stream_id(0), num_observed_times(0), num_ack_block_offsets(0),
-      next_expected_seq_num(0), timestamp(0), timestamp_delta(0),
-      observed_time(), ack_block_offset()
+    : compact_flag(false), stream_id(0), num_observed_times(0),
+      num_ack_block_offsets(0), next_expected_seq_num(0), timestamp(0),
+      timestamp_delta(0), observed_time(), ack_block_offset()
 {}
 
 //============================================================================
 AckHeader::AckHeader(StreamId sid, PktSeqNumber ne_seq, PktTimestamp ts,
                      PktTimestamp ts_delta)
-    : stream_id(sid), num_observed_times(0), num_ack_block_offsets(0),
-      next_expected_seq_num(ne_seq), timestamp(ts), timestamp_delta(ts_delta),
+    : compact_flag(false), stream_id(sid), num_observed_times(0),
+      num_ack_block_offsets(0), next_expected_seq_num(ne_seq), timestamp(ts),
+      timestamp_delta(ts_delta),
       observed_time(), ack_block_offset()
 {}
 
@@ -1585,6 +2116,16 @@ ConnMeasHeader::ConnMeasHeader(bool owd, uint16_t sn, uint32_t max_owd)
     : owd_flag(owd), sequence_number(sn), max_rmt_to_loc_owd(max_owd)
 {}
 
+//============================================================================
+AckFreqHeader::AckFreqHeader()
+    : ack_ratio(0), sequence_number(0), max_ack_delay_usec(0)
+{}
+
+//============================================================================
+AckFreqHeader::AckFreqHeader(uint8_t ratio, uint16_t sn, uint32_t max_delay)
+    : ack_ratio(ratio), sequence_number(sn), max_ack_delay_usec(max_delay)
+{}
+
 //============================================================================
 CcPktTrainHeader::CcPktTrainHeader()
     : cc_id(0), pt_pkt_type(0), pt_seq_num(0), pt_inter_recv_time(0),
@@ -143,6 +143,7 @@ namespace sliq
     CC_SYNC_HEADER              = 34,  // 0x22
     RCVD_PKT_CNT_HEADER         = 35,  // 0x23
     CONN_MEAS_HEADER            = 36,  // 0x24
+    ACK_FREQ_HEADER             = 37,  // 0x25
 
     // Specialized stand-alone headers.  Cannot be concatenated.
     CC_PKT_TRAIN_HEADER         = 40,  // 0x28
@@ -157,7 +158,7 @@ namespace sliq
   ///  0                   1                   2                   3
   ///  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  /// |     Type      |  # of CC Alg  |          Message Tag          |
+  /// |     Type      |C|R|# CC Alg   |          Message Tag          |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   /// |                       Packet Timestamp                        |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -176,9 +177,13 @@ namespace sliq
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   /// |                       Unique Client ID                        |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  /// |                 Resumption Token (Optional)                   |
+  /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   ///
   ///   Header Type (1 byte) (0x00)
-  ///   Number of Congestion Control Algorithms (1 byte)
+  ///   Compact Headers Flag (1 bit)
+  ///   Resume Flag (1 bit)
+  ///   Number of Congestion Control Algorithms (6 bits)
   ///   Message Tag (2 bytes, char string) ("CH", "SH", "CC", or "RJ")
   ///   Packet Timestamp in Microseconds (4 bytes)
   ///   Echo Timestamp in Microseconds (4 bytes)
@@ -191,9 +196,22 @@ namespace sliq
   ///     Unused (2 bytes)
   ///     Congestion Control Parameters (4 bytes)
   ///   Unique Client Identifier (4 bytes)
+  ///   Resumption Token (4 bytes, only present if non-zero)
   /// \endverbatim
   ///
-  /// Length = 16 bytes + (num_cc_alg * 8 bytes).
+  /// Length = 16 bytes + (num_cc_alg * 8 bytes), plus 4 bytes if the
+  /// resumption token is present.
+  ///
+  /// The Compact Headers Flag is set in a client hello if the client is
+  /// willing to use compact data and ACK headers, and is set in the server
+  /// hello if both endpoints will use them for the connection.
+  ///
+  /// The Resumption Token is issued by the server and identifies the state
+  /// cached by both endpoints for a previous connection between them.  The
+  /// Resume Flag is set in a client hello if the client wants to resume from
+  /// the cached state identified by the token, and is set in the server
+  /// hello if the server has the same cached state and both endpoints will
+  /// resume from it.
   ///
   /// This header uses specialized reliability and retransmission rules.
   struct ConnHndshkHeader
@@ -204,11 +222,14 @@ namespace sliq
     virtual ~ConnHndshkHeader() {}
     size_t ConvertToCongCtrl(CongCtrl* alg, size_t max_alg);
 
+    bool          compact_flag;
+    bool          resume_flag;
     uint8_t       num_cc_algs;
     MsgTag        message_tag;
     PktTimestamp  timestamp;
     PktTimestamp  echo_timestamp;
     ClientId      client_id;
+    uint32_t      resume_token;
 
     struct
     {
@@ -281,7 +302,7 @@ namespace sliq
   ///  0                   1                   2                   3
   ///  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  /// |     Type      |  Unused   |T|A|   Stream ID   |   Priority    |
+  /// |     Type      | Unused  |W|T|A|   Stream ID   |   Priority    |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   /// |                      Initial Window Size                      |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -293,8 +314,9 @@ namespace sliq
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   ///
   ///   Header Type (1 byte) (0x03)
-  ///   Flags (1 byte) (uuuuuuta)
-  ///     uuuuuu - Unused (6 bits)
+  ///   Flags (1 byte) (uuuuuwta)
+  ///     uuuuu  - Unused (5 bits)
+  ///     w      - FEC Sliding Window, ARQ+FEC Mode Only (1 bit)
   ///     t      - Delivery Time, ARQ+FEC Mode Only (1 bit)
   ///     a      - ACK (1 bit)
   ///   Stream ID (1 byte)
@@ -320,10 +342,11 @@ namespace sliq
                        WindowSize win_size, PktSeqNumber seq_num,
                        DeliveryMode del_mode, ReliabilityMode rel_mode,
                        RexmitLimit limit, RexmitRounds del_rnds,
-                       double del_time, double recv_p);
+                       double del_time, double recv_p, bool sliding_win);
     virtual ~CreateStreamHeader() {}
     void GetReliability(Reliability& rel);
 
+    bool             sliding_win_flag;
     bool             del_time_flag;
     bool             ack_flag;
     StreamId         stream_id;
@@ -378,7 +401,7 @@ namespace sliq
   ///  0                   1                   2                   3
   ///  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  /// |     Type      |U|L|E|M| U |P|F|   Stream ID   | Number of TTG |
+  /// |     Type      |C|L|E|M| U |P|F|   Stream ID   | Number of TTG |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   /// |     CC ID     | Rexmit Count  |    Payload Length in Bytes    |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -390,11 +413,11 @@ namespace sliq
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   /// |             Move Forward Packet Sequence Number*              |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  /// |T|U|  Index*   |NumSrc*|Round* |           Group ID*           |
+  /// |T|W|  Index*   |NumSrc*|Round* |           Group ID*           |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  /// |    Encoded Packet Length*     |        Time-To-Go #1*         |
+  /// | Win Start*    |    Unused*    |    Encoded Packet Length*     |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  /// |        Time-To-Go #2*         |        Time-To-Go #3*         |
+  /// |        Time-To-Go #1*         |        Time-To-Go #2*         |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   /// ~                                                               ~
   /// ~                                                               ~
@@ -407,12 +430,12 @@ namespace sliq
   /// |                                                               |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   ///
-  /// Optional fields are denoted with (*).  The "T" and "U" fields in the FEC
+  /// Optional fields are denoted with (*).  The "T" and "W" fields in the FEC
   /// fields are also optional.
   ///
   ///   Header Type (1 byte) (0x20)
-  ///   Flags (1 byte) (ulemuupf)
-  ///     u  - Unused (1 bit)
+  ///   Flags (1 byte) (clemuupf)
+  ///     c  - Compact Header (1 bit), 0 for this format
   ///     l  - Encoded Packet Length Present (1 bit)
   ///     e  - Forward Error Correction (FEC) Fields Present (1 bit)
   ///     m  - Move Forward Present (1 bit)
@@ -435,13 +458,20 @@ namespace sliq
   ///     FEC Packet Type (1 bit)
   ///       0 = Original Packet (aka Source Data Packet)
   ///       1 = FEC Packet (aka Encoded Data Packet)
-  ///     Unused (1 bit)
+  ///     FEC Sliding Window (1 bit)
+  ///       0 = Encoded over all source packets in the FEC group
+  ///       1 = Encoded over a window of source packets in the FEC group
   ///     Group Index within the FEC Group, 0-63 (6 bits)
   ///     Number of FEC Source Packets in FEC Group, 0-15 (4 bits)
   ///       Must be 0 if (FEC Packet Type == 0)
+  ///       One more than the last window index if (FEC Sliding Window == 1)
   ///     Round Number in FEC Group, 0-15 (4 bits)
   ///     FEC Group Identifier (2 bytes)
   ///
+  ///   Present if (FEC Sliding Window == 1):
+  ///     FEC Window Start Group Index (1 byte)
+  ///     Unused (1 byte)
+  ///
   ///   Present if (Encoded Packet Length Present == 1):
   ///     Encoded Packet Length (2 bytes)
   ///
@@ -458,7 +488,47 @@ namespace sliq
   /// \endverbatim
   ///
   /// Length = 20 bytes + (m_bit * 4 bytes) + (e_bit * 4 bytes) +
-  ///          (l_bit * 2 bytes) + (num_ttg * 2 bytes) + payload_len_bytes.
+  ///          (w_bit * 2 bytes) + (l_bit * 2 bytes) + (num_ttg * 2 bytes) +
+  ///          payload_len_bytes.
+  ///
+  /// If compact headers have been negotiated for the connection, then the
+  /// following compact format is used instead:
+  ///
+  /// \verbatim
+  ///  0                   1                   2                   3
+  ///  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+  /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  /// |     Type      |C|L|E|M|SL |P|F|   Stream ID   |CCID | #TTG    |
+  /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  /// | Rexmit Count  |  Packet Sequence Number (1-4 bytes) ...
+  /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  ///
+  ///   Header Type (1 byte) (0x20)
+  ///   Flags (1 byte) (clemsspf)
+  ///     c  - Compact Header (1 bit), 1 for this format
+  ///     l, e, m, p, f - Same as above
+  ///     ss - Packet Sequence Number Length in Bytes, Minus One (2 bits)
+  ///   Stream ID (1 byte)
+  ///   Congestion Control Identifier (3 bits)
+  ///   Number of Time-To-Go Values (5 bits)
+  ///   Retransmission Count (1 byte)
+  ///   Truncated Packet Sequence Number (1-4 bytes)
+  ///   Packet Timestamp in Microseconds (4 bytes)
+  ///   Packet Timestamp Delta in Microseconds (signed varint, 1-5 bytes)
+  ///
+  ///   Followed by the same optional fields, TTG values, and payload as
+  ///   above.
+  /// \endverbatim
+  ///
+  /// The payload length is not sent in the compact format, as the payload
+  /// always extends to the end of the packet.  The packet sequence number is
+  /// truncated to the fewest low-order bytes that the receiver can expand
+  /// unambiguously using its largest observed packet sequence number for the
+  /// stream (see Framer::ComputeSeqNumLength()).  Signed varints are zigzag
+  /// encoded, then written seven bits per byte, least significant bits
+  /// first, with the MSB set in each byte except the last.
+  ///
+  /// Length = 10 to 18 bytes + optional fields + payload_len_bytes.
   ///
   /// This header, plus any payload, is reliable via the ACK header and/or
   /// FEC.
@@ -478,6 +548,8 @@ namespace sliq
                FecEncPktLen enc_pkt_len);
     virtual ~DataHeader() {}
 
+    bool              compact_flag;
+    size_t            seq_num_length;
     bool              enc_pkt_len_flag;
     bool              fec_flag;
     bool              move_fwd_flag;
@@ -496,6 +568,8 @@ namespace sliq
     FecSize           fec_num_src;
     FecRound          fec_round;
     FecGroupId        fec_group_id;
+    bool              fec_win_flag;
+    FecSize           fec_win_start;
     FecEncPktLen      encoded_pkt_length;
     double            ttg[kMaxTtgs];
 
@@ -510,7 +584,7 @@ namespace sliq
   ///  0                   1                   2                   3
   ///  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  /// |     Type      |Flags (Unused) |   Stream ID   | #OPT|   #ABO  |
+  /// |     Type      |C|   Unused    |   Stream ID   | #OPT|   #ABO  |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   /// |             Next Expected Packet Sequence Number              |
   /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -556,8 +630,9 @@ namespace sliq
   /// packet sequence number.
   ///
   ///   Header Type (1 byte) (0x21)
-  ///   Flags (1 byte) (uuuuuuuu)
-  ///     uuuuuuuu - Unused (8 bits)
+  ///   Flags (1 byte) (cuuuuuuu)
+  ///     c       - Compact Header (1 bit)
+  ///     uuuuuuu - Unused (7 bits)
   ///   Stream ID (1 byte)
   ///   Number of Observed Packet Times (3 bits)
   ///   Number of ACK Block Offsets (5 bits)
@@ -578,6 +653,26 @@ namespace sliq
   ///
   /// Length = 16 bytes + (num_times * 8 bytes) + (num_blocks * 2 bytes).
   ///
+  /// If compact headers have been negotiated for the connection and the
+  /// result is smaller, then the Compact Header flag is set and the fields
+  /// following the Packet Timestamp are encoded as follows:
+  ///
+  /// \verbatim
+  ///   Packet Timestamp Delta in Microseconds (signed varint, 1-5 bytes)
+  ///
+  ///   Series of Observed Packet Times:
+  ///     Offset From Next Expected Sequence Number (signed varint)
+  ///     Observed Packet Timestamp in Microseconds (4 bytes for the first,
+  ///       signed varint difference from the previous one for the rest)
+  ///
+  ///   Series of ACK Block Offsets, each either:
+  ///     0 (1 bit), Type (1 bit), Offset (6 bits) if the offset is < 64
+  ///     1 (1 bit), Type (1 bit), Offset (14 bits) if the offset is < 16384
+  /// \endverbatim
+  ///
+  /// Length = 13 to 17 bytes + (num_times * 2 to 10 bytes) +
+  ///          (num_blocks * 1 to 2 bytes).
+  ///
   /// This header is best effort.
   ///
   /// This header may be concatenated with Data, Congestion Control
@@ -590,6 +685,7 @@ namespace sliq
               PktTimestamp ts_delta);
     virtual ~AckHeader() {}
 
+    bool          compact_flag;
     StreamId      stream_id;
     uint8_t       num_observed_times;
     uint8_t       num_ack_block_offsets;
@@ -728,6 +824,46 @@ namespace sliq
     uint32_t  max_rmt_to_loc_owd;
   };
 
+  /// The SLIQ ACK frequency header.
+  ///
+  /// \verbatim
+  ///  0                   1                   2                   3
+  ///  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+  /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  /// |     Type      |   ACK Ratio   |        Sequence Number        |
+  /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  /// |                       Maximum ACK Delay                       |
+  /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  ///
+  ///   Header Type (1 byte) (0x25)
+  ///   ACK Ratio in Data Packets per ACK Packet (1 byte)
+  ///   Sequence Number (2 bytes)
+  ///   Maximum ACK Delay in Microseconds (4 bytes)
+  /// \endverbatim
+  ///
+  /// Length = 8 bytes.
+  ///
+  /// Sent by a data sender to request that the peer send an ACK packet after
+  /// every ACK Ratio data packets received, or after Maximum ACK Delay has
+  /// elapsed, whichever comes first.  The receiver still sends ACK packets
+  /// immediately when it detects missing or reordered data packets.
+  ///
+  /// This header is best effort.
+  ///
+  /// This header may be concatenated with Data, ACK, Congestion Control
+  /// Synchronization, Received Packet Count, and Connection Measurement
+  /// headers into a single UDP packet.
+  struct AckFreqHeader
+  {
+    AckFreqHeader();
+    AckFreqHeader(uint8_t ratio, uint16_t sn, uint32_t max_delay);
+    virtual ~AckFreqHeader() {}
+
+    uint8_t   ack_ratio;
+    uint16_t  sequence_number;
+    uint32_t  max_ack_delay_usec;
+  };
+
   /// The SLIQ congestion control packet train header.
   ///
   /// \verbatim
@@ -887,6 +1023,17 @@ namespace sliq
     bool AppendConnMeasHeader(iron::Packet*& packet,
                               const ConnMeasHeader& input);
 
+    /// \brief Append a SLIQ ACK frequency header.
+    ///
+    /// \param  packet  A reference to a pointer to the packet where the ACK
+    ///                 frequency header will be appended.  If NULL, then a
+    ///                 packet will be generated and placed in this pointer.
+    /// \param  input   The header input data.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool AppendAckFreqHeader(iron::Packet*& packet,
+                             const AckFreqHeader& input);
+
     /// \brief Generate a SLIQ packet with a congestion control packet train
     /// header followed by a payload of the specified length.
     ///
@@ -1027,6 +1174,18 @@ namespace sliq
     bool ParseConnMeasHeader(const iron::Packet* packet, size_t& offset,
                              ConnMeasHeader& output);
 
+    /// \brief Parse a received ACK frequency header.
+    ///
+    /// \param  packet  The packet that is being parsed.
+    /// \param  offset  The byte offset into the packet where the received ACK
+    ///                 frequency header begins.
+    /// \param  output  The parsed header.
+    ///
+    /// \return  True if the header is parsed successfully, or false
+    ///          otherwise.
+    bool ParseAckFreqHeader(const iron::Packet* packet, size_t& offset,
+                            AckFreqHeader& output);
+
     /// \brief Parse a SLIQ congestion control packet train header.
     ///
     /// \param  packet  The packet that is being parsed.
@@ -1050,6 +1209,7 @@ namespace sliq
       return(kDataHdrBaseSize +
              (hdr.move_fwd_flag ? kDataHdrMoveFwdSize : 0) +
              (hdr.fec_flag ? kDataHdrFecSize : 0) +
+             ((hdr.fec_flag && hdr.fec_win_flag) ? kDataHdrFecWinSize : 0) +
              (hdr.enc_pkt_len_flag ? kDataHdrEncPktLenSize : 0) +
              (hdr.num_ttg * kDataHdrTtgSize));
     }
@@ -1068,11 +1228,107 @@ namespace sliq
               kAckHdrAckBlockOffsetSize));
     }
 
+    /// \brief Determine the size of the compact SLIQ ACK header if it were
+    /// to be generated.
+    ///
+    /// \param  input  The header input data.
+    ///
+    /// \return  The size of the compact ACK header in bytes, or zero if the
+    ///          ACK header cannot be encoded in the compact format.
+    static size_t ComputeCompactAckHeaderSize(const AckHeader& input);
+
+    /// \brief Determine the number of low-order bytes of a packet sequence
+    /// number that must be sent in a compact data header.
+    ///
+    /// The receiver expands the truncated packet sequence number relative to
+    /// its largest observed packet sequence number for the stream, which the
+    /// sender knows is no less than the largest packet sequence number ACKed
+    /// and no greater than the largest packet sequence number sent.
+    ///
+    /// \param  seq_num        The packet sequence number being sent.
+    /// \param  largest_acked  The largest packet sequence number ACKed by
+    ///                        the receiver.
+    /// \param  largest_sent   The largest packet sequence number sent.
+    ///
+    /// \return  The number of bytes to send, from 1 to 4.
+    inline static size_t ComputeSeqNumLength(PktSeqNumber seq_num,
+                                             PktSeqNumber largest_acked,
+                                             PktSeqNumber largest_sent)
+    {
+      int64_t  above = static_cast<int32_t>(seq_num - largest_acked);
+      int64_t  below = static_cast<int32_t>(largest_sent + 1 - seq_num);
+      int64_t  span  = ((above > below) ? above : below);
+
+      if (span <= 0x80)
+      {
+        return 1;
+      }
+      if (span <= 0x8000)
+      {
+        return 2;
+      }
+      if (span <= 0x800000)
+      {
+        return 3;
+      }
+      return 4;
+    }
+
+    /// \brief Expand a truncated packet sequence number from a compact data
+    /// header.
+    ///
+    /// \param  trunc_seq_num  The truncated packet sequence number.
+    /// \param  length         The number of bytes that were sent.
+    /// \param  largest_rcvd   The largest packet sequence number received on
+    ///                        the stream.
+    ///
+    /// \return  The full packet sequence number closest to the next expected
+    ///          packet sequence number.
+    inline static PktSeqNumber ExpandSeqNum(PktSeqNumber trunc_seq_num,
+                                            size_t length,
+                                            PktSeqNumber largest_rcvd)
+    {
+      if (length >= sizeof(PktSeqNumber))
+      {
+        return trunc_seq_num;
+      }
+
+      PktSeqNumber  expected = (largest_rcvd + 1);
+      uint32_t      win      = (static_cast<uint32_t>(1) << (8 * length));
+      uint32_t      diff     = ((trunc_seq_num - expected) & (win - 1));
+
+      if (diff >= (win >> 1))
+      {
+        return (expected + diff - win);
+      }
+
+      return (expected + diff);
+    }
+
    private:
 
     /// \brief Copy constructor.
     Framer(const Framer& other);
 
+    /// \brief Append a compact SLIQ ACK header to a packet.
+    ///
+    /// \param  packet  The packet to append the header to.
+    /// \param  input   The header input data.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool AppendCompactAckHeader(iron::Packet* packet, const AckHeader& input);
+
+    /// \brief Parse the remainder of a compact SLIQ ACK header.
+    ///
+    /// \param  packet  The packet containing the header.
+    /// \param  offset  The offset of the Next Expected Packet Sequence
+    ///                 Number field.  Updated to the end of the header.
+    /// \param  output  The header with the common fields already parsed.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool ParseCompactAckHeader(const iron::Packet* packet, size_t& offset,
+                               AckHeader& output);
+
     /// \brief Copy operator.
     Framer& operator=(const Framer& other);
 
@@ -1191,6 +1447,71 @@ namespace sliq
     bool ReadInt32(const iron::Packet* packet, size_t& offset,
                    int32_t& result);
 
+    /// \brief Write an int32_t value to a SLIQ packet as a signed varint.
+    ///
+    /// The value is zigzag encoded, then written seven bits per byte, least
+    /// significant bits first, with the MSB set in each byte except the
+    /// last.
+    ///
+    /// \param  value   The value to be written to the packet.
+    /// \param  packet  The packet into which the value will be placed.
+    ///
+    /// \return  True if successful, or false otherwise.
+    bool WriteVarInt32(int32_t value, iron::Packet* packet);
+
+    /// \brief Read a signed varint from a SLIQ packet.
+    ///
+    /// \param  packet  The packet from which the value will be read.
+    /// \param  offset  The offset into the packet buffer from which to start
+    ///                 the read.
+    /// \param  result  The resulting value.
+    ///
+    /// \return  True if successful, or false otherwise.
+    bool ReadVarInt32(const iron::Packet* packet, size_t& offset,
+                      int32_t& result);
+
+    /// \brief Determine the number of bytes needed to write an int32_t value
+    /// as a signed varint.
+    ///
+    /// \param  value  The value to be written.
+    ///
+    /// \return  The number of bytes, from 1 to 5.
+    inline static size_t VarInt32Size(int32_t value)
+    {
+      uint32_t  zz  = ZigZagEncode(value);
+      size_t    len = 1;
+
+      while (zz >= 0x80)
+      {
+        zz >>= 7;
+        ++len;
+      }
+
+      return len;
+    }
+
+    /// \brief Zigzag encode a signed value so that small magnitudes map to
+    /// small unsigned values.
+    ///
+    /// \param  value  The signed value.
+    ///
+    /// \return  The zigzag encoded value.
+    inline static uint32_t ZigZagEncode(int32_t value)
+    {
+      return ((static_cast<uint32_t>(value) << 1) ^
+              static_cast<uint32_t>(value >> 31));
+    }
+
+    /// \brief Decode a zigzag encoded value.
+    ///
+    /// \param  value  The zigzag encoded value.
+    ///
+    /// \return  The signed value.
+    inline static int32_t ZigZagDecode(uint32_t value)
+    {
+      return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
     /// Pool containing packets to use.
     iron::PacketPool&  packet_pool_;
 
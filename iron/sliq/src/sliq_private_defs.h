@@ -113,6 +113,9 @@ namespace sliq
   // MTU is 1500 bytes.  Thus, 1500 - 28 = 1472.
   const size_t  kMaxPacketSize = 1472;
 
+  // The maximum size of a signed varint field in a compact header, in bytes.
+  const size_t  kMaxVarInt32Size = 5;
+
   // ================ SLIQ Data Headers ================
 
   // The base size of the data header, in bytes.
@@ -125,6 +128,9 @@ namespace sliq
   // The size of the FEC fields in the data header, in bytes.
   const size_t  kDataHdrFecSize = 4;
 
+  // The size of the FEC sliding window field in the data header, in bytes.
+  const size_t  kDataHdrFecWinSize = 2;
+
   // The size of the encoded packet length field in the data header, in bytes.
   const size_t  kDataHdrEncPktLenSize = 2;
 
@@ -146,6 +152,16 @@ namespace sliq
   // The size of each ACK block offset entry in the ACK header, in bytes.
   const size_t  kAckHdrAckBlockOffsetSize = 2;
 
+  // The size of the fixed length fields in the compact ACK header, in bytes.
+  const size_t  kAckHdrCompactBaseSize = 12;
+
+  // The largest ACK block offset that fits in one byte in the compact ACK
+  // header.
+  const uint16_t  kAckHdrCompactMaxShortAbo = 0x3f;
+
+  // The largest ACK block offset that fits in the compact ACK header.
+  const uint16_t  kAckHdrCompactMaxAbo = 0x3fff;
+
   /// The maximum number of observed packet times that may be contained in a
   /// single ACK header.
   const size_t  kMaxObsTimes = 7;
@@ -177,6 +193,21 @@ namespace sliq
   /// microseconds (500 milliseconds).
   const suseconds_t  kAckTimerUsec = 40000;
 
+  /// The maximum ACK ratio, in data packets per ACK packet, that a data
+  /// sender may request using an ACK frequency header.  Limited by the
+  /// number of observed packet times that fit in a single ACK header.
+  const size_t  kMaxAckRatio = kMaxObsTimes;
+
+  /// The maximum number of observed packet times, from the ACK headers
+  /// received in a single ACK processing batch, that are held until the
+  /// batch is completed for determining the end of FEC group rounds.  Any
+  /// beyond this are processed as they are received.
+  const size_t  kMaxAckBatchObsTimes = 64;
+
+  /// The minimum maximum ACK delay, in microseconds, that a data sender may
+  /// request using an ACK frequency header.
+  const suseconds_t  kMinAckDelayUsec = 5000;
+
   // ================ SLIQ CC Synchronization Headers ================
 
   // The size of the congestion control synchronization header, in bytes.
@@ -201,6 +232,11 @@ namespace sliq
   // The size of the maximum remote-to-local one-way delay field, in bytes.
   const size_t  kConnMeasHdrMaxRtlOwdSize = 4;
 
+  // ================ SLIQ ACK Frequency Headers ================
+
+  // The size of the ACK frequency header, in bytes.
+  const size_t  kAckFreqHdrSize = 8;
+
   // ================ SLIQ CC Packet Train Headers ================
 
   // The size of the congestion control packet train header, in bytes.
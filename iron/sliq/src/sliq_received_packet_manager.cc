@@ -81,6 +81,10 @@ namespace
   /// delivered to the application.
   const uint8_t       kDelivered         = 0x10;
 
+  /// Received packet information flag for sliding window FEC encoded data
+  /// packets.
+  const uint8_t       kFecWindow         = 0x20;
+
   /// The number of FEC groups supported for storing FEC information.  The
   /// worst case occurs when there is only one packet in each FEC group.
   const WindowSize    kFecGroupInfoSize  = sliq::kFlowCtrlWindowPkts;
@@ -100,12 +104,14 @@ namespace
 #define IS_RECEIVED(info)     (((info).flags_ & kReceived) != 0)
 #define IS_REGENERATED(info)  (((info).flags_ & kRegenerated) != 0)
 #define IS_DELIVERED(info)    (((info).flags_ & kDelivered) != 0)
+#define IS_FEC_WINDOW(info)   (((info).flags_ & kFecWindow) != 0)
 
 #define SET_FEC(info)          (info).flags_ |= kFec
 #define SET_FIN(info)          (info).flags_ |= kFin
 #define SET_RECEIVED(info)     (info).flags_ |= kReceived
 #define SET_REGENERATED(info)  (info).flags_ |= kRegenerated
 #define SET_DELIVERED(info)    (info).flags_ |= kDelivered
+#define SET_FEC_WINDOW(info)   (info).flags_ |= kFecWindow
 
 
 /// The RcvdPktInfo's static member to the packet pool.
@@ -133,7 +139,8 @@ RcvdPktManager::RcvdPktManager(Connection& conn, PacketPool& packet_pool,
       stats_pkts_(),
       fec_grp_info_(NULL),
       fec_src_pkts_(NULL),
-      rcvd_pkts_(NULL)
+      rcvd_pkts_(NULL),
+      rcvd_bits_()
 {
 }
 
@@ -258,6 +265,15 @@ bool RcvdPktManager::Initialize(
     return false;
   }
 
+  // Allocate the matching bitmap of received packets.
+  if (!rcvd_bits_.Initialize(kFlowCtrlWindowPkts))
+  {
+    LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": Error allocating received packet bitmap.\n", conn_id_,
+         stream_id_);
+    return false;
+  }
+
   // Store the settings.
   rel_      = rel;
   del_mode_ = del_mode;
@@ -377,6 +393,7 @@ bool RcvdPktManager::AddPkt(DataHeader& pkt, const Time& rcv_time)
         (pkt.retransmission_count > old_rpi.rexmit_cnt_))
     {
       SET_RECEIVED(old_rpi);
+      rcvd_bits_.Set(pkt.sequence_number);
       old_rpi.rexmit_cnt_ = pkt.retransmission_count;
     }
 
@@ -433,6 +450,9 @@ bool RcvdPktManager::AddPkt(DataHeader& pkt, const Time& rcv_time)
     {
       // This packet is out of order, so send an ACK packet immediately.
       ack_now = true;
+
+      // Clear the holes in the received packet bitmap a word at a time.
+      rcvd_bits_.ClearRange((rcv_max_ + 1), (pkt.sequence_number - 1));
     }
 
     for (PktSeqNumber seq_num = (rcv_max_ + 1);
@@ -474,6 +494,7 @@ bool RcvdPktManager::AddPkt(DataHeader& pkt, const Time& rcv_time)
       // as being received, update the retransmission count, then recycle the
       // packet.
       SET_RECEIVED(pkt_info);
+      rcvd_bits_.Set(pkt.sequence_number);
 
       if (pkt.retransmission_count > pkt_info.rexmit_cnt_)
       {
@@ -1012,18 +1033,19 @@ void RcvdPktManager::UpdateNextExpected(bool reset_to_min)
   }
 
   // Move rcv_nxt_ forward through the receive window until a packet that
-  // has not been received or regenerated is found.
-  while (SEQ_LEQ(rcv_nxt_, rcv_max_))
+  // has not been received or regenerated is found.  If there is no such
+  // packet, then rcv_nxt_ moves just beyond rcv_max_.
+  if (SEQ_LEQ(rcv_nxt_, rcv_max_))
   {
-    RcvdPktInfo&  rpi = rcvd_pkts_[(rcv_nxt_ % kFlowCtrlWindowPkts)];
+    PktSeqNumber  missing_seq_num = 0;
 
-    if (IS_RECEIVED(rpi) || IS_REGENERATED(rpi))
+    if (rcvd_bits_.FindNextClear(rcv_nxt_, rcv_max_, missing_seq_num))
     {
-      ++rcv_nxt_;
+      rcv_nxt_ = missing_seq_num;
     }
     else
     {
-      break;
+      rcv_nxt_ = (rcv_max_ + 1);
     }
   }
 }
@@ -1110,34 +1132,23 @@ void RcvdPktManager::GenerateAckBlock(PktSeqNumber seq_num)
     return;
   }
 
-  // The packet is not already covered by an ACK block.  Walk the window
-  // backward and forward from the specified sequence number to generate the
-  // ACK block.
+  // The packet is not already covered by an ACK block.  Search the received
+  // packet bitmap backward and forward from the specified sequence number
+  // for the nearest missing packets, which bound the ACK block.
   PktSeqNumber  ack_lo = seq_num;
   PktSeqNumber  ack_hi = seq_num;
+  PktSeqNumber  sn     = 0;
 
-  for (PktSeqNumber sn = (seq_num - 1); SEQ_GEQ(sn, rcv_nxt_); --sn)
+  if (SEQ_GT(seq_num, rcv_nxt_))
   {
-    RcvdPktInfo&  rpi = rcvd_pkts_[(sn % kFlowCtrlWindowPkts)];
-
-    if ((!IS_RECEIVED(rpi)) && (!IS_REGENERATED(rpi)))
-    {
-      break;
-    }
-
-    ack_lo = sn;
+    ack_lo = (rcvd_bits_.FindPrevClear(rcv_nxt_, (seq_num - 1), sn) ?
+              (sn + 1) : rcv_nxt_);
   }
 
-  for (PktSeqNumber sn = (seq_num + 1); SEQ_LEQ(sn, rcv_max_); ++sn)
+  if (SEQ_LT(seq_num, rcv_max_))
   {
-    RcvdPktInfo&  rpi = rcvd_pkts_[(sn % kFlowCtrlWindowPkts)];
-
-    if ((!IS_RECEIVED(rpi)) && (!IS_REGENERATED(rpi)))
-    {
-      break;
-    }
-
-    ack_hi = sn;
+    ack_hi = (rcvd_bits_.FindNextClear((seq_num + 1), rcv_max_, sn) ?
+              (sn - 1) : rcv_max_);
   }
 
   ack_blk_.AddAckBlock(ack_lo, ack_hi);
@@ -1221,8 +1232,16 @@ void RcvdPktManager::StorePkt(DataHeader& pkt, RcvdPktInfo& pkt_info)
     pkt_info.fec_enc_pkt_len_ = pkt.encoded_pkt_length;
     pkt_info.fec_grp_idx_     = pkt.fec_group_index;
     pkt_info.fec_num_src_     = pkt.fec_num_src;
+    pkt_info.fec_win_start_   = 0;
     pkt_info.fec_round_       = pkt.fec_round;
 
+    if ((pkt.fec_pkt_type == FEC_ENC_PKT) && (pkt.fec_win_flag))
+    {
+      SET_FEC_WINDOW(pkt_info);
+
+      pkt_info.fec_win_start_ = pkt.fec_win_start;
+    }
+
     if ((pkt.fec_pkt_type == FEC_ENC_PKT) && (!pkt.enc_pkt_len_flag))
     {
       LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
@@ -1240,9 +1259,11 @@ void RcvdPktManager::StorePkt(DataHeader& pkt, RcvdPktInfo& pkt_info)
       if (grp_info.fec_grp_id_ != pkt_info.fec_grp_id_)
       {
         // This is a new FEC group information entry.
-        grp_info.fec_grp_id_    = pkt_info.fec_grp_id_;
-        grp_info.delivered_cnt_ = 0;
-        grp_info.ttg_cnt_       = 0;
+        grp_info.fec_grp_id_       = pkt_info.fec_grp_id_;
+        grp_info.delivered_cnt_    = 0;
+        grp_info.fec_win_rcvd_cnt_ = 0;
+        grp_info.fec_regen_cnt_    = 0;
+        grp_info.ttg_cnt_          = 0;
 
         if (pkt_info.fec_pkt_type_ == FEC_SRC_PKT)
         {
@@ -1254,11 +1275,19 @@ void RcvdPktManager::StorePkt(DataHeader& pkt, RcvdPktInfo& pkt_info)
         }
         else
         {
-          grp_info.fec_num_src_       = pkt_info.fec_num_src_;
+          // A sliding window FEC encoded packet only reports the end of its
+          // window, not the number of FEC source packets in the group.
+          grp_info.fec_num_src_       = (IS_FEC_WINDOW(pkt_info) ? 0 :
+                                         pkt_info.fec_num_src_);
           grp_info.fec_src_rcvd_cnt_  = 0;
           grp_info.fec_enc_rcvd_cnt_  = 1;
           grp_info.start_src_seq_num_ = 0;
           grp_info.start_enc_seq_num_ = pkt.sequence_number;
+
+          if (IS_FEC_WINDOW(pkt_info))
+          {
+            grp_info.fec_win_rcvd_cnt_ = 1;
+          }
         }
       }
       else
@@ -1268,12 +1297,26 @@ void RcvdPktManager::StorePkt(DataHeader& pkt, RcvdPktInfo& pkt_info)
         {
           ++(grp_info.fec_src_rcvd_cnt_);
 
-          if ((grp_info.fec_src_rcvd_cnt_ == 1) ||
+          // Sliding window decoding may have already set the starting
+          // sequence number using a regenerated FEC source packet.
+          if (((grp_info.fec_src_rcvd_cnt_ == 1) &&
+               (grp_info.fec_regen_cnt_ == 0)) ||
               (SEQ_LT(pkt.sequence_number, grp_info.start_src_seq_num_)))
           {
             grp_info.start_src_seq_num_ = pkt.sequence_number;
           }
         }
+        else if (IS_FEC_WINDOW(pkt_info))
+        {
+          ++(grp_info.fec_win_rcvd_cnt_);
+          ++(grp_info.fec_enc_rcvd_cnt_);
+
+          if ((grp_info.fec_enc_rcvd_cnt_ == 1) ||
+              (SEQ_LT(pkt.sequence_number, grp_info.start_enc_seq_num_)))
+          {
+            grp_info.start_enc_seq_num_ = pkt.sequence_number;
+          }
+        }
         else
         {
           if (grp_info.fec_num_src_ == 0)
@@ -1305,9 +1348,12 @@ void RcvdPktManager::StorePkt(DataHeader& pkt, RcvdPktInfo& pkt_info)
       }
 
       // Store the FEC encoded packet's TTG values if there are enough of them
-      // for all of the FEC source packets in the group.
+      // for all of the FEC source packets in the group.  A sliding window FEC
+      // encoded packet only has TTG values up to the end of its window, so
+      // never let it replace a longer TTG vector.
       if ((pkt_info.fec_pkt_type_ == FEC_ENC_PKT) &&
-          (pkt.num_ttg >= pkt_info.fec_num_src_))
+          (pkt.num_ttg >= pkt_info.fec_num_src_) &&
+          ((!IS_FEC_WINDOW(pkt_info)) || (pkt.num_ttg >= grp_info.ttg_cnt_)))
       {
         grp_info.ttg_cnt_ = pkt.num_ttg;
 
@@ -1370,6 +1416,7 @@ void RcvdPktManager::StorePkt(DataHeader& pkt, RcvdPktInfo& pkt_info)
   }
 
   SET_RECEIVED(pkt_info);
+  rcvd_bits_.Set(pkt.sequence_number);
 
   // The packet is now owned by the packet information object.
   pkt.payload = NULL;
@@ -1397,6 +1444,14 @@ void RcvdPktManager::RegeneratePkts(DataHeader& fec_pkt, const Time& rcv_time)
     return;
   }
 
+  // FEC groups with sliding window FEC encoded packets are decoded
+  // incrementally.
+  if (grp_info.fec_win_rcvd_cnt_ > 0)
+  {
+    RegenerateWindowPkts(fec_pkt, grp_info, rcv_time);
+    return;
+  }
+
   // If no FEC encoded data packets have been received for the FEC group or
   // the number of FEC source data packets for the FEC group is not known,
   // then regeneration cannot be done yet.
@@ -1786,176 +1841,511 @@ void RcvdPktManager::RegeneratePkts(DataHeader& fec_pkt, const Time& rcv_time)
   {
     if (vdm_info_.out_pkt_[out_idx] != NULL)
     {
-      // This is a missing FEC source data packet.  Get the sequence number.
-      Packet*   pkt         = vdm_info_.out_pkt_[out_idx];
-      uint16_t  pkt_len     = vdm_info_.out_pkt_size_[out_idx];
-      uint32_t  seq_num_nbo = 0;
+      // This is a missing FEC source data packet.
+      (void)PlaceRegeneratedPkt(grp_info, out_idx, max_rnd,
+                                (grp_info.ttg_cnt_ >= grp_info.fec_num_src_),
+                                ttg_corr, rcv_time, seq_num);
+    }
+  }
+
+#ifdef SLIQ_DEBUG
+  LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+       ": Completed grp %" PRIFecGroupId " via regeneration.\n", conn_id_,
+       stream_id_, grp_id);
+#endif
+
+  // Update the packet receive statistics for the regenerated FEC source
+  // packets.
+  if (((rel_.fec_del_time_flag) && (max_rnd < kOutOfRounds)) ||
+      ((!rel_.fec_del_time_flag) &&
+       (max_rnd <= rel_.fec_target_pkt_del_rounds)))
+  {
+    // Increment the number of FEC source packets received, and decrement the
+    // number of "extra" FEC encoded packets used to do the regeneration.
+    stats_pkts_.fec_total_src_rcvd_ += static_cast<size_t>(enc_cnt);
+    stats_pkts_.fec_total_ext_rcvd_ -= static_cast<size_t>(enc_cnt);
+  }
+
+  // Release any allocated Packet objects that were not transferred to
+  // received packet information entries.
+  for (out_idx = 0; out_idx < grp_info.fec_num_src_; ++out_idx)
+  {
+    if (vdm_info_.out_pkt_[out_idx] != NULL)
+    {
+      LogW(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+           ": Warning, FEC SRC Packet object for grp %" PRIFecGroupId " idx "
+           "%d not used.\n", conn_id_, stream_id_, grp_id, out_idx);
+
+      packet_pool_.Recycle(vdm_info_.out_pkt_[out_idx]);
+      vdm_info_.out_pkt_[out_idx] = NULL;
+    }
+  }
+}
 
-      if (pkt_len < sizeof(seq_num_nbo))
+//============================================================================
+void RcvdPktManager::RegenerateWindowPkts(DataHeader& fec_pkt,
+                                          FecGroupInfo& grp_info,
+                                          const Time& rcv_time)
+{
+  FecGroupId  grp_id = grp_info.fec_grp_id_;
+
+  // If all of the FEC source data packets are already present, then
+  // regeneration is not needed.
+  if ((grp_info.fec_num_src_ > 0) &&
+      ((grp_info.fec_src_rcvd_cnt_ + grp_info.fec_regen_cnt_) >=
+       grp_info.fec_num_src_))
+  {
+    return;
+  }
+
+  // Clear the VDM decoder information.
+  memset(&vdm_info_, 0, sizeof(vdm_info_));
+
+  int           num_col = grp_info.fec_num_src_;
+  uint32_t      known   = 0;
+  FecSize       enc_cnt = 0;
+  RetransCount  max_rnd = 0;
+  PktSeqNumber  seq_num = 0;
+
+  // Add any FEC source data packets for the group that have already left the
+  // receive window.
+  for (FecSize src_idx = 0; src_idx < kMaxFecGroupLengthPkts; ++src_idx)
+  {
+    RcvdPktInfo&  pkt_info = fec_src_pkts_[src_idx];
+
+    if (IS_FEC(pkt_info) && (pkt_info.fec_grp_id_ == grp_id) &&
+        (pkt_info.packet_ != NULL) && SEQ_LT(pkt_info.seq_num_, rcv_min_) &&
+        AddWindowSrcRow(pkt_info, known))
+    {
+      if (pkt_info.fec_grp_idx_ >= num_col)
       {
-        LogF(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
-             ": Error, FEC SRC pkt for grp %" PRIFecGroupId " too small for "
-             "sequence number.\n", conn_id_, stream_id_, grp_id);
+        num_col = (pkt_info.fec_grp_idx_ + 1);
       }
+    }
+  }
+
+  // Find where the FEC group starts in the receive window.  Regenerated FEC
+  // source packets are accounted for in the starting source sequence number.
+  PktSeqNumber  start_seq = grp_info.start_enc_seq_num_;
+
+  if ((grp_info.fec_enc_rcvd_cnt_ == 0) ||
+      (((grp_info.fec_src_rcvd_cnt_ > 0) || (grp_info.fec_regen_cnt_ > 0)) &&
+       SEQ_LT(grp_info.start_src_seq_num_, start_seq)))
+  {
+    start_seq = grp_info.start_src_seq_num_;
+  }
+
+  if (SEQ_LT(start_seq, rcv_min_))
+  {
+    start_seq = rcv_min_;
+  }
 
-      pkt_len -= sizeof(seq_num_nbo);
-      ::memcpy(&seq_num_nbo, reinterpret_cast<void*>(pkt->GetBuffer(pkt_len)),
-               sizeof(seq_num_nbo));
-      seq_num = ntohl(seq_num_nbo);
+  // Add the FEC source and encoded data packets for the group that are in
+  // the receive window.
+  for (seq_num = start_seq;
+       (SEQ_LEQ(seq_num, rcv_max_) &&
+        (vdm_info_.num_src_pkt_ < static_cast<int>(MAX_FEC_RATE)));
+       ++seq_num)
+  {
+    RcvdPktInfo&  pkt_info = rcvd_pkts_[(seq_num % kFlowCtrlWindowPkts)];
 
-      // Make sure that the regenerated FEC source data packet is still
-      // within the window.
-      if (SEQ_LT(seq_num, rcv_min_))
+    if ((!IS_FEC(pkt_info)) || (pkt_info.fec_grp_id_ != grp_id) ||
+        (pkt_info.packet_ == NULL) ||
+        (!(IS_RECEIVED(pkt_info) || IS_REGENERATED(pkt_info))))
+    {
+      continue;
+    }
+
+    if (IS_RECEIVED(pkt_info))
+    {
+      // Update the maximum FEC group round found so far.
+      if (pkt_info.fec_round_ == 0)
       {
-        LogW(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
-             ": Warning, no place for FEC SRC pkt seq %" PRIPktSeqNumber
-             " in grp %" PRIFecGroupId " idx %d.\n", conn_id_, stream_id_,
-             seq_num, grp_id, out_idx);
+        max_rnd = kOutOfRounds;
       }
-      else
+      else if (pkt_info.fec_round_ > max_rnd)
       {
-        RcvdPktInfo&  pkt_info = rcvd_pkts_[(seq_num % kFlowCtrlWindowPkts)];
+        max_rnd = pkt_info.fec_round_;
+      }
+    }
 
-        if (IS_RECEIVED(pkt_info))
-        {
-          LogF(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
-               PRIStreamId ": Error, FEC SRC pkt seq %" PRIPktSeqNumber
-               " in grp %" PRIFecGroupId " idx %d already received.\n",
-               conn_id_, stream_id_, seq_num, grp_id, out_idx);
-        }
+    if (pkt_info.fec_pkt_type_ == FEC_SRC_PKT)
+    {
+      if (AddWindowSrcRow(pkt_info, known) &&
+          (pkt_info.fec_grp_idx_ >= num_col))
+      {
+        num_col = (pkt_info.fec_grp_idx_ + 1);
+      }
 
-        if (pkt_info.packet_ != NULL)
-        {
-          packet_pool_.Recycle(pkt_info.packet_);
-        }
+      continue;
+    }
 
-        pkt_info.packet_            = pkt;
-        vdm_info_.out_pkt_[out_idx] = NULL;
+    // This is a received FEC encoded data packet.  Look up its
+    // coefficients.
+    int  in_idx = vdm_info_.num_src_pkt_;
 
-        pkt_info.seq_num_ = seq_num;
-        pkt_info.flags_   = 0;
+    if (IS_FEC_WINDOW(pkt_info))
+    {
+      VdmFec::GetWindowCoefficients(grp_id, pkt_info.fec_grp_idx_,
+                                    pkt_info.fec_win_start_,
+                                    pkt_info.fec_num_src_,
+                                    vdm_info_.in_coef_[in_idx]);
+    }
+    else
+    {
+      if (pkt_info.fec_grp_idx_ < pkt_info.fec_num_src_)
+      {
+        LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
+             PRIStreamId ": Invalid index %" PRIFecSize ".\n", conn_id_,
+             stream_id_, pkt_info.fec_grp_idx_);
+        continue;
+      }
 
-        SET_FEC(pkt_info);
+      VdmFec::GetBlockCoefficients(
+        pkt_info.fec_num_src_,
+        (pkt_info.fec_grp_idx_ - pkt_info.fec_num_src_),
+        vdm_info_.in_coef_[in_idx]);
+    }
 
-        pkt_info.fec_pkt_type_    = static_cast<uint8_t>(FEC_SRC_PKT);
-        pkt_info.fec_grp_id_      = grp_id;
-        pkt_info.fec_enc_pkt_len_ = 0;
-        pkt_info.fec_grp_idx_     = static_cast<FecSize>(out_idx);
-        pkt_info.fec_num_src_     = grp_info.fec_num_src_;
-        pkt_info.fec_round_       = max_rnd;
+    vdm_info_.in_pkt_data_[in_idx]     =
+      pkt_info.packet_->GetBuffer(pkt_info.payload_offset_);
+    vdm_info_.in_pkt_size_[in_idx]     = pkt_info.payload_len_;
+    vdm_info_.in_enc_pkt_size_[in_idx] = pkt_info.fec_enc_pkt_len_;
+    vdm_info_.in_pkt_index_[in_idx]    = pkt_info.fec_grp_idx_;
+    vdm_info_.num_src_pkt_             = (in_idx + 1);
 
-        SET_REGENERATED(pkt_info);
+    if (pkt_info.fec_num_src_ > num_col)
+    {
+      num_col = pkt_info.fec_num_src_;
+    }
 
-        pkt_info.packet_->SetLengthInBytes(pkt_len);
-        pkt_info.packet_->set_recv_time(rcv_time);
-        pkt_info.payload_offset_ = 0;
-        pkt_info.payload_len_    = pkt_len;
-        pkt_info.rexmit_cnt_     = 0;
+    ++enc_cnt;
+  }
 
-        // Determine the TTG for the regenerated FEC source packet, if
-        // possible.
-        double  new_ttg_sec = 0.0;
+  if ((enc_cnt == 0) || (num_col > static_cast<int>(MAX_FEC_RATE)))
+  {
+    return;
+  }
 
-        if (grp_info.ttg_cnt_ >= grp_info.fec_num_src_)
-        {
-          double  owd_est_sec = conn_.GetRtlOwdEst(0, rcv_time);
+  // Set the output packet information for each FEC source data packet that
+  // is missing from the columns covered so far.
+  int  out_idx = 0;
+  int  missing = 0;
 
-          new_ttg_sec = (grp_info.ttg_[out_idx] - owd_est_sec - ttg_corr);
+  for (out_idx = 0; out_idx < num_col; ++out_idx)
+  {
+    if ((known & (static_cast<uint32_t>(1) << out_idx)) != 0)
+    {
+      continue;
+    }
 
-          if (new_ttg_sec < 0.0)
-          {
-            new_ttg_sec = 0.0;
-          }
+    vdm_info_.out_pkt_[out_idx] = packet_pool_.Get();
 
-          Time  nttg(new_ttg_sec);
+    if (vdm_info_.out_pkt_[out_idx] == NULL)
+    {
+      LogF(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+           ": Error getting packet from pool.\n", conn_id_, stream_id_);
+    }
 
-          pkt_info.packet_->set_track_ttg(true);
-          pkt_info.packet_->SetTimeToGo(nttg, true);
+    vdm_info_.out_pkt_data_[out_idx] =
+      vdm_info_.out_pkt_[out_idx]->GetBuffer(0);
+    ++missing;
+  }
 
-#ifdef SLIQ_DEBUG
-          LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
-               PRIStreamId ": Latency-sensitive pkt seq %" PRIPktSeqNumber
-               " enc_ttg %f owd_est %f ttg_corr %f new_ttg %f.\n", conn_id_,
-               stream_id_, seq_num,
-               static_cast<double>(grp_info.ttg_[out_idx]), owd_est_sec,
-               ttg_corr, new_ttg_sec);
-#endif
+  // Decode whatever FEC source data packets the received packets allow.
+  uint32_t  solved = 0;
 
-#ifdef TTG_TRACKING
-          // Log the amount that the TTG was reduced by.
-          // Format:  PLT_OWD <seq_num> <ttg_delta> <final_ttg>
-          LogC(kClassName, __func__, "Conn %" PRIEndptId ": PLT_OWD %"
-               PRIPktSeqNumber " %f %f\n", conn_id_, seq_num, owd_est_sec,
-               new_ttg_sec);
-#endif // TTG_TRACKING
-        }
+  if ((missing > 0) &&
+      (VdmFec::DecodeWindowPackets(num_col, vdm_info_.num_src_pkt_,
+                                   vdm_info_.in_pkt_data_,
+                                   vdm_info_.in_pkt_size_,
+                                   vdm_info_.in_enc_pkt_size_,
+                                   vdm_info_.in_coef_,
+                                   vdm_info_.out_pkt_data_,
+                                   vdm_info_.out_pkt_size_, solved) < 0))
+  {
+    LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": Error decoding FEC window packets for grp %" PRIFecGroupId ".\n",
+         conn_id_, stream_id_, grp_id);
+    solved = 0;
+  }
 
-        // Record the packet's sequence number as a recently regenerated
-        // data packet.
-        rct_rcvs_.RecordSeqNum(seq_num);
+  // Compute the time-to-go (TTG) correction, if any, the same way as
+  // RegeneratePkts() does.
+  double  ttg_corr = 0.0;
 
-        // Update the packet regeneration statistics.
-        ++stats_pkts_.fec_src_regen_;
+  if ((fec_pkt.fec_pkt_type == FEC_SRC_PKT) && (fec_pkt.num_ttg == 1) &&
+      (grp_info.ttg_cnt_ > fec_pkt.fec_group_index))
+  {
+    ttg_corr = (grp_info.ttg_[fec_pkt.fec_group_index] - fec_pkt.ttg[0]);
+  }
 
-#ifdef SLIQ_DEBUG
-        if (pkt_info.packet_->track_ttg())
-        {
-          LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
-               PRIStreamId ": Regenerated grp %" PRIFecGroupId " idx %d seq %"
-               PRIPktSeqNumber " len %" PRIu16 " ttg %f.\n", conn_id_,
-               stream_id_, grp_id, out_idx, seq_num, pkt_len, new_ttg_sec);
-        }
-        else
-        {
-          LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
-               PRIStreamId ": Regenerated grp %" PRIFecGroupId " idx %d seq %"
-               PRIPktSeqNumber " len %" PRIu16 ".\n", conn_id_, stream_id_,
-               grp_id, out_idx, seq_num, pkt_len);
-        }
-#endif
+  // Store the regenerated FEC source data packets, and release the Packet
+  // objects for those that could not be regenerated yet.
+  FecSize  regen_cnt = 0;
+
+  for (out_idx = 0; out_idx < num_col; ++out_idx)
+  {
+    if (vdm_info_.out_pkt_[out_idx] == NULL)
+    {
+      continue;
+    }
+
+    if (((solved & (static_cast<uint32_t>(1) << out_idx)) != 0) &&
+        PlaceRegeneratedPkt(grp_info, out_idx, max_rnd,
+                            (grp_info.ttg_cnt_ > out_idx), ttg_corr,
+                            rcv_time, seq_num))
+    {
+      if (((grp_info.fec_src_rcvd_cnt_ == 0) &&
+           (grp_info.fec_regen_cnt_ == 0) && (regen_cnt == 0)) ||
+          SEQ_LT(seq_num, grp_info.start_src_seq_num_))
+      {
+        grp_info.start_src_seq_num_ = seq_num;
       }
+
+      ++regen_cnt;
+    }
+
+    if (vdm_info_.out_pkt_[out_idx] != NULL)
+    {
+      packet_pool_.Recycle(vdm_info_.out_pkt_[out_idx]);
+      vdm_info_.out_pkt_[out_idx] = NULL;
     }
   }
 
+  if (regen_cnt == 0)
+  {
+    return;
+  }
+
+  grp_info.fec_regen_cnt_ += regen_cnt;
+
 #ifdef SLIQ_DEBUG
   LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
-       ": Completed grp %" PRIFecGroupId " via regeneration.\n", conn_id_,
-       stream_id_, grp_id);
+       ": Regenerated %" PRIFecSize " pkts in grp %" PRIFecGroupId " using %"
+       PRIFecSize " enc pkts.\n", conn_id_, stream_id_, regen_cnt, grp_id,
+       enc_cnt);
 #endif
 
   // Update the packet receive statistics for the regenerated FEC source
-  // packets.
+  // packets, moving one "extra" FEC encoded packet to the FEC source packet
+  // count for each.
   if (((rel_.fec_del_time_flag) && (max_rnd < kOutOfRounds)) ||
       ((!rel_.fec_del_time_flag) &&
        (max_rnd <= rel_.fec_target_pkt_del_rounds)))
   {
-    // Increment the number of FEC source packets received, and decrement the
-    // number of "extra" FEC encoded packets used to do the regeneration.
-    stats_pkts_.fec_total_src_rcvd_ += static_cast<size_t>(enc_cnt);
-    stats_pkts_.fec_total_ext_rcvd_ -= static_cast<size_t>(enc_cnt);
+    stats_pkts_.fec_total_src_rcvd_ += static_cast<size_t>(regen_cnt);
+    stats_pkts_.fec_total_ext_rcvd_ -= static_cast<size_t>(regen_cnt);
   }
+}
 
-  // Release any allocated Packet objects that were not transferred to
-  // received packet information entries.
-  for (out_idx = 0; out_idx < grp_info.fec_num_src_; ++out_idx)
+//============================================================================
+bool RcvdPktManager::AddWindowSrcRow(RcvdPktInfo& pkt_info, uint32_t& known)
+{
+  uint32_t  bit = (static_cast<uint32_t>(1) << pkt_info.fec_grp_idx_);
+  int       row = vdm_info_.num_src_pkt_;
+
+  if ((pkt_info.fec_grp_idx_ >= kMaxFecGroupLengthPkts) ||
+      ((known & bit) != 0) || (row >= static_cast<int>(MAX_FEC_RATE)))
   {
-    if (vdm_info_.out_pkt_[out_idx] != NULL)
-    {
-      LogW(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
-           ": Warning, FEC SRC Packet object for grp %" PRIFecGroupId " idx "
-           "%d not used.\n", conn_id_, stream_id_, grp_id, out_idx);
+    return false;
+  }
 
-      packet_pool_.Recycle(vdm_info_.out_pkt_[out_idx]);
-      vdm_info_.out_pkt_[out_idx] = NULL;
+  // Copy the packet's sequence number to the end of the payload, as is done
+  // in RegeneratePkts(), so that it is part of the decoding.
+  size_t    packet_len  = static_cast<size_t>(pkt_info.payload_len_);
+  uint32_t  seq_num_nbo = htonl(pkt_info.seq_num_);
+
+  if ((pkt_info.payload_offset_ + packet_len + sizeof(seq_num_nbo)) >
+      pkt_info.packet_->GetMaxLengthInBytes())
+  {
+    LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": Error, FEC SRC data packet %" PRIPktSeqNumber " is too big to add "
+         "sequence number.\n", conn_id_, stream_id_, pkt_info.seq_num_);
+    return false;
+  }
+
+  ::memcpy(reinterpret_cast<void*>(
+             pkt_info.packet_->GetBuffer(pkt_info.payload_offset_ +
+                                         packet_len)),
+           &seq_num_nbo, sizeof(seq_num_nbo));
+
+  uint16_t  pkt_len = static_cast<uint16_t>(packet_len +
+                                            sizeof(seq_num_nbo));
+
+  // A known FEC source data packet is a row with a single coefficient of one
+  // in its own column.
+  vdm_info_.in_pkt_data_[row]     =
+    pkt_info.packet_->GetBuffer(pkt_info.payload_offset_);
+  vdm_info_.in_pkt_size_[row]     = pkt_len;
+  vdm_info_.in_enc_pkt_size_[row] = pkt_len;
+  vdm_info_.in_pkt_index_[row]    = pkt_info.fec_grp_idx_;
+  vdm_info_.in_coef_[row][pkt_info.fec_grp_idx_] = 1;
+  vdm_info_.num_src_pkt_          = (row + 1);
+
+  known |= bit;
+
+  return true;
+}
+
+//============================================================================
+bool RcvdPktManager::PlaceRegeneratedPkt(FecGroupInfo& grp_info, int out_idx,
+                                         RetransCount max_rnd, bool use_ttg,
+                                         double ttg_corr, const Time& rcv_time,
+                                         PktSeqNumber& seq_num)
+{
+  // Get the regenerated FEC source data packet's sequence number.
+  FecGroupId  grp_id      = grp_info.fec_grp_id_;
+  Packet*     pkt         = vdm_info_.out_pkt_[out_idx];
+  uint16_t    pkt_len     = vdm_info_.out_pkt_size_[out_idx];
+  uint32_t    seq_num_nbo = 0;
+
+  if (pkt_len < sizeof(seq_num_nbo))
+  {
+    LogF(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": Error, FEC SRC pkt for grp %" PRIFecGroupId " too small for "
+         "sequence number.\n", conn_id_, stream_id_, grp_id);
+  }
+
+  pkt_len -= sizeof(seq_num_nbo);
+  ::memcpy(&seq_num_nbo, reinterpret_cast<void*>(pkt->GetBuffer(pkt_len)),
+           sizeof(seq_num_nbo));
+  seq_num = ntohl(seq_num_nbo);
+
+  // Make sure that the regenerated FEC source data packet is still
+  // within the window.
+  if (SEQ_LT(seq_num, rcv_min_))
+  {
+    LogW(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": Warning, no place for FEC SRC pkt seq %" PRIPktSeqNumber
+         " in grp %" PRIFecGroupId " idx %d.\n", conn_id_, stream_id_,
+         seq_num, grp_id, out_idx);
+    return false;
+  }
+
+  RcvdPktInfo&  pkt_info = rcvd_pkts_[(seq_num % kFlowCtrlWindowPkts)];
+
+  // A sliding window FEC group may attempt to regenerate a packet that was
+  // already regenerated if it is no longer available for decoding.
+  if (IS_REGENERATED(pkt_info) && (pkt_info.seq_num_ == seq_num))
+  {
+#ifdef SLIQ_DEBUG
+    LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": FEC SRC pkt seq %" PRIPktSeqNumber " in grp %" PRIFecGroupId
+         " idx %d already regenerated.\n", conn_id_, stream_id_, seq_num,
+         grp_id, out_idx);
+#endif
+    return false;
+  }
+
+  if (IS_RECEIVED(pkt_info))
+  {
+    LogF(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
+         PRIStreamId ": Error, FEC SRC pkt seq %" PRIPktSeqNumber
+         " in grp %" PRIFecGroupId " idx %d already received.\n",
+         conn_id_, stream_id_, seq_num, grp_id, out_idx);
+  }
+
+  if (pkt_info.packet_ != NULL)
+  {
+    packet_pool_.Recycle(pkt_info.packet_);
+  }
+
+  pkt_info.packet_            = pkt;
+  vdm_info_.out_pkt_[out_idx] = NULL;
+
+  pkt_info.seq_num_ = seq_num;
+  pkt_info.flags_   = 0;
+
+  SET_FEC(pkt_info);
+
+  pkt_info.fec_pkt_type_    = static_cast<uint8_t>(FEC_SRC_PKT);
+  pkt_info.fec_grp_id_      = grp_id;
+  pkt_info.fec_enc_pkt_len_ = 0;
+  pkt_info.fec_grp_idx_     = static_cast<FecSize>(out_idx);
+  pkt_info.fec_num_src_     = grp_info.fec_num_src_;
+  pkt_info.fec_round_       = max_rnd;
+
+  SET_REGENERATED(pkt_info);
+  rcvd_bits_.Set(seq_num);
+
+  pkt_info.packet_->SetLengthInBytes(pkt_len);
+  pkt_info.packet_->set_recv_time(rcv_time);
+  pkt_info.payload_offset_ = 0;
+  pkt_info.payload_len_    = pkt_len;
+  pkt_info.rexmit_cnt_     = 0;
+
+  // Determine the TTG for the regenerated FEC source packet, if
+  // possible.
+  double  new_ttg_sec = 0.0;
+
+  if (use_ttg)
+  {
+    double  owd_est_sec = conn_.GetRtlOwdEst(0, rcv_time);
+
+    new_ttg_sec = (grp_info.ttg_[out_idx] - owd_est_sec - ttg_corr);
+
+    if (new_ttg_sec < 0.0)
+    {
+      new_ttg_sec = 0.0;
     }
+
+    Time  nttg(new_ttg_sec);
+
+    pkt_info.packet_->set_track_ttg(true);
+    pkt_info.packet_->SetTimeToGo(nttg, true);
+
+#ifdef SLIQ_DEBUG
+    LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
+         PRIStreamId ": Latency-sensitive pkt seq %" PRIPktSeqNumber
+         " enc_ttg %f owd_est %f ttg_corr %f new_ttg %f.\n", conn_id_,
+         stream_id_, seq_num,
+         static_cast<double>(grp_info.ttg_[out_idx]), owd_est_sec,
+         ttg_corr, new_ttg_sec);
+#endif
+
+#ifdef TTG_TRACKING
+    // Log the amount that the TTG was reduced by.
+    // Format:  PLT_OWD <seq_num> <ttg_delta> <final_ttg>
+    LogC(kClassName, __func__, "Conn %" PRIEndptId ": PLT_OWD %"
+         PRIPktSeqNumber " %f %f\n", conn_id_, seq_num, owd_est_sec,
+         new_ttg_sec);
+#endif // TTG_TRACKING
+  }
+
+  // Record the packet's sequence number as a recently regenerated
+  // data packet.
+  rct_rcvs_.RecordSeqNum(seq_num);
+
+  // Update the packet regeneration statistics.
+  ++stats_pkts_.fec_src_regen_;
+
+#ifdef SLIQ_DEBUG
+  if (pkt_info.packet_->track_ttg())
+  {
+    LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
+         PRIStreamId ": Regenerated grp %" PRIFecGroupId " idx %d seq %"
+         PRIPktSeqNumber " len %" PRIu16 " ttg %f.\n", conn_id_,
+         stream_id_, grp_id, out_idx, seq_num, pkt_len, new_ttg_sec);
   }
+  else
+  {
+    LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
+         PRIStreamId ": Regenerated grp %" PRIFecGroupId " idx %d seq %"
+         PRIPktSeqNumber " len %" PRIu16 ".\n", conn_id_, stream_id_,
+         grp_id, out_idx, seq_num, pkt_len);
+  }
+#endif
+
+  return true;
 }
 
 //============================================================================
 RcvdPktManager::RcvdPktInfo::RcvdPktInfo()
     : packet_(NULL), seq_num_(0), payload_offset_(0), payload_len_(0),
       rexmit_cnt_(0), flags_(0), fec_pkt_type_(0), fec_grp_id_(0),
-      fec_enc_pkt_len_(0), fec_grp_idx_(0), fec_num_src_(0), fec_round_(0)
+      fec_enc_pkt_len_(0), fec_grp_idx_(0), fec_num_src_(0),
+      fec_win_start_(0), fec_round_(0)
 {
 }
 
@@ -1988,6 +2378,7 @@ void RcvdPktManager::RcvdPktInfo::Clear()
   fec_enc_pkt_len_ = 0;
   fec_grp_idx_     = 0;
   fec_num_src_     = 0;
+  fec_win_start_   = 0;
   fec_round_       = 0;
 }
 
@@ -2013,6 +2404,7 @@ void RcvdPktManager::RcvdPktInfo::MoveFecInfo(RcvdPktInfo& rpi)
   fec_enc_pkt_len_ = rpi.fec_enc_pkt_len_;
   fec_grp_idx_     = rpi.fec_grp_idx_;
   fec_num_src_     = rpi.fec_num_src_;
+  fec_win_start_   = rpi.fec_win_start_;
   fec_round_       = rpi.fec_round_;
 }
 
@@ -2285,8 +2677,9 @@ void RcvdPktManager::ObsTimeInfo::AddLatestObsTimeToAckHdr(AckHeader& ack_hdr,
 //============================================================================
 RcvdPktManager::FecGroupInfo::FecGroupInfo()
     : fec_grp_id_(0), fec_num_src_(0), fec_src_rcvd_cnt_(0),
-      fec_enc_rcvd_cnt_(0), delivered_cnt_(0), ttg_cnt_(0),
-      start_src_seq_num_(0), start_enc_seq_num_(0), ttg_()
+      fec_enc_rcvd_cnt_(0), delivered_cnt_(0), fec_win_rcvd_cnt_(0),
+      fec_regen_cnt_(0), ttg_cnt_(0), start_src_seq_num_(0),
+      start_enc_seq_num_(0), ttg_()
 {
 }
 
@@ -2298,7 +2691,8 @@ RcvdPktManager::FecGroupInfo::~FecGroupInfo()
 //============================================================================
 RcvdPktManager::VdmDecodeInfo::VdmDecodeInfo()
     : num_src_pkt_(0), in_pkt_data_(), in_pkt_size_(), in_enc_pkt_size_(),
-      in_pkt_index_(), out_pkt_(), out_pkt_data_(), out_pkt_size_()
+      in_pkt_index_(), in_coef_(), out_pkt_(), out_pkt_data_(),
+      out_pkt_size_()
 {
 }
 
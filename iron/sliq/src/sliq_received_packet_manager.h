@@ -39,6 +39,7 @@
 #define IRON_SLIQ_RECEIVED_PACKET_MANAGER_H_
 
 #include "sliq_framer.h"
+#include "sliq_seq_num_bitmap.h"
 #include "sliq_types.h"
 #include "sliq_vdm_fec.h"
 
@@ -201,6 +202,14 @@ namespace sliq
     /// otherwise.
     bool IsDataMissing() const;
 
+    /// \brief Get the largest data packet sequence number observed.
+    ///
+    /// \return  The largest observed data packet sequence number.
+    inline PktSeqNumber GetLargestObservedSeqNum() const
+    {
+      return rcv_max_;
+    }
+
     /// \brief Check if all of the data packets, including the data packet
     /// with the FIN, have been consumed (delivered to the application).
     ///
@@ -242,7 +251,8 @@ namespace sliq
       /// The retransmission count.
       RetransCount   rexmit_cnt_;
 
-      /// The packet's flags: FEC, FIN, received, regenerated, and delivered.
+      /// The packet's flags: FEC, FIN, received, regenerated, delivered, and
+      /// FEC sliding window.
       uint8_t        flags_;
 
       /// The FEC packet's type.
@@ -258,9 +268,14 @@ namespace sliq
       FecSize        fec_grp_idx_;
 
       /// The FEC packet's number of FEC source packets in the group.  Only
-      /// set in FEC encoded packets.
+      /// set in FEC encoded packets.  For sliding window FEC encoded
+      /// packets, this is the end of the window.
       FecSize        fec_num_src_;
 
+      /// The FEC packet's sliding window start group index.  Only set in
+      /// sliding window FEC encoded packets.
+      FecSize        fec_win_start_;
+
       /// The FEC packet's round number.
       FecRound       fec_round_;
     };
@@ -360,7 +375,8 @@ namespace sliq
       /// The FEC group ID.
       FecGroupId    fec_grp_id_;
 
-      /// The number of FEC source packets in the FEC group.
+      /// The number of FEC source packets in the FEC group.  Zero until a
+      /// non-sliding window FEC encoded packet is received.
       FecSize       fec_num_src_;
 
       /// The number of FEC source packets received in the FEC group.
@@ -372,6 +388,14 @@ namespace sliq
       /// The number of FEC source packets delivered from the FEC group.
       FecSize       delivered_cnt_;
 
+      /// The number of sliding window FEC encoded packets received in the FEC
+      /// group.
+      FecSize       fec_win_rcvd_cnt_;
+
+      /// The number of FEC source packets regenerated in the FEC group using
+      /// sliding window decoding.
+      FecSize       fec_regen_cnt_;
+
       /// The number of TTG values stored in the array for the FEC group.
       TtgCount      ttg_cnt_;
 
@@ -407,6 +431,10 @@ namespace sliq
       /// The array of received FEC data packet group indexes.
       int            in_pkt_index_[MAX_FEC_RATE];
 
+      /// The array of received FEC data packet coefficient rows, used for
+      /// sliding window decoding.
+      uint16_t       in_coef_[MAX_FEC_RATE][MAX_FEC_RATE];
+
       /// The array of pointers to Packet objects for regenerated FEC source
       /// data packets.
       iron::Packet*  out_pkt_[MAX_FEC_RATE];
@@ -513,6 +541,52 @@ namespace sliq
     /// \param  rcv_time  The FEC data packet's receive time.
     void RegeneratePkts(DataHeader& fec_pkt, const iron::Time& rcv_time);
 
+    /// \brief Attempt to regenerate any missing packets within an FEC group
+    /// that contains sliding window FEC encoded packets.
+    ///
+    /// Unlike RegeneratePkts(), this does not wait for enough FEC packets
+    /// to decode the entire FEC group.  Each missing FEC source packet is
+    /// regenerated as soon as the received FEC packets allow it.
+    ///
+    /// \param  fec_pkt   The received FEC data packet that has just been
+    ///                   added to the window.
+    /// \param  grp_info  The FEC group information.
+    /// \param  rcv_time  The FEC data packet's receive time.
+    void RegenerateWindowPkts(DataHeader& fec_pkt, FecGroupInfo& grp_info,
+                              const iron::Time& rcv_time);
+
+    /// \brief Add a received or regenerated FEC source data packet to the
+    /// VDM decoder information as a row for sliding window decoding.
+    ///
+    /// \param  pkt_info  The FEC source data packet information.
+    /// \param  known     The bit mask of FEC group indices already added.
+    ///                   Updated on success.
+    ///
+    /// \return  True if the packet was added, or false otherwise.
+    bool AddWindowSrcRow(RcvdPktInfo& pkt_info, uint32_t& known);
+
+    /// \brief Place a regenerated FEC source data packet into the receive
+    /// window.
+    ///
+    /// The packet is taken from the VDM decoder information output arrays.
+    ///
+    /// \param  grp_info   The FEC group information.
+    /// \param  out_idx    The FEC group index of the regenerated packet.
+    /// \param  max_rnd    The FEC round to record for the packet.
+    /// \param  use_ttg    The flag indicating if the FEC group's TTG for the
+    ///                    packet may be used.
+    /// \param  ttg_corr   The TTG correction, in seconds.
+    /// \param  rcv_time   The receive time to record for the packet.
+    /// \param  seq_num    A reference to where the regenerated packet's
+    ///                    sequence number is placed.
+    ///
+    /// \return  True if the packet was placed in the receive window, or
+    ///           false otherwise.
+    bool PlaceRegeneratedPkt(FecGroupInfo& grp_info, int out_idx,
+                             RetransCount max_rnd, bool use_ttg,
+                             double ttg_corr, const iron::Time& rcv_time,
+                             PktSeqNumber& seq_num);
+
     // The receive window:
     //
     //     |<-------- rcv_wnd_ ------->|
@@ -605,6 +679,11 @@ namespace sliq
     /// packet's sequence number.
     RcvdPktInfo*       rcvd_pkts_;
 
+    /// The bitmap of received or regenerated packets, mirroring the received
+    /// and regenerated flags in rcvd_pkts_.  Used to find the edges of ACK
+    /// blocks and the next expected sequence number a word at a time.
+    SeqNumBitmap       rcvd_bits_;
+
   }; // end class RcvdPktManager
 
 } // namespace sliq
@@ -86,6 +86,9 @@ namespace
   /// Sent packet information flag for fast retransmit candidate reporting.
   const uint8_t       kCand               = 0x20;
 
+  /// Sent packet information flag for sliding window FEC encoded packets.
+  const uint8_t       kFecWin             = 0x40;
+
   /// FEC group flag for pure ARQ mode.
   const uint8_t       kFecPureArq         = 0x01;
 
@@ -95,6 +98,9 @@ namespace
   /// FEC group flag for forcing the end of the group.
   const uint8_t       kFecForceEnd        = 0x04;
 
+  /// FEC group flag for sliding window FEC encoded packets.
+  const uint8_t       kFecSlidingWin      = 0x08;
+
   /// The distance between a packet and the current largest observed packet to
   /// consider a packet lost, and for a fast retransmission to take place.
   /// This is an adaptation of the TCP 3 duplicate ACKs rule (RFC 5681,
@@ -165,6 +171,7 @@ namespace
 #define IS_ACKED(info)    (((info).flags_ & kAcked) != 0)
 #define IS_LOST(info)     (((info).flags_ & kLost) != 0)
 #define IS_CAND(info)     (((info).flags_ & kCand) != 0)
+#define IS_FEC_WIN(info)  (((info).flags_ & kFecWin) != 0)
 
 #define SET_FEC(info)      (info).flags_ |= kFec
 #define SET_FIN(info)      (info).flags_ |= kFin
@@ -172,6 +179,7 @@ namespace
 #define SET_ACKED(info)    (info).flags_ |= kAcked
 #define SET_LOST(info)     (info).flags_ |= kLost
 #define SET_CAND(info)     (info).flags_ |= kCand
+#define SET_FEC_WIN(info)  (info).flags_ |= kFecWin
 
 #define CLEAR_BLOCKED(info)  (info).flags_ &= ~kBlocked
 #define CLEAR_LOST(info)     (info).flags_ &= ~kLost
@@ -182,10 +190,12 @@ namespace
 #define IS_PURE_ARQ(info)   (((info).fec_flags_ & kFecPureArq) != 0)
 #define IS_LAT_SENS(info)   (((info).fec_flags_ & kFecLatSens) != 0)
 #define IS_FORCE_END(info)  (((info).fec_flags_ & kFecForceEnd) != 0)
+#define IS_SLIDING_WIN(info)  (((info).fec_flags_ & kFecSlidingWin) != 0)
 
 #define SET_PURE_ARQ(info)   (info).fec_flags_ |= kFecPureArq
 #define SET_LAT_SENS(info)   (info).fec_flags_ |= kFecLatSens
 #define SET_FORCE_END(info)  (info).fec_flags_ |= kFecForceEnd
+#define SET_SLIDING_WIN(info)  (info).fec_flags_ |= kFecSlidingWin
 
 #define CLEAR_PURE_ARQ(info)  (info).fec_flags_ &= ~kFecPureArq
 
@@ -214,6 +224,7 @@ SentPktManager::SentPktManager(Connection& conn, Stream& stream,
       rcv_ack_nxt_exp_(0),
       rcv_ack_lrg_obs_(0),
       last_lo_conn_seq_(0),
+      ack_batch_(),
       stats_pkts_(),
       stats_bytes_in_flight_(0),
       stats_fec_src_dur_sec_(1.0),
@@ -239,7 +250,10 @@ SentPktManager::SentPktManager(Connection& conn, Stream& stream,
       vdm_info_(),
       cc_cnt_adj_(),
       cc_una_pkt_(),
-      sent_pkts_(NULL)
+      cc_acked_(),
+      cc_lrg_acked_seq_(),
+      sent_pkts_(NULL),
+      acked_bits_()
 {
   // Set all of the FEC lookup table pointers to NULL.
   for (size_t i = 0; i < kNumLookupTables; ++i)
@@ -399,6 +413,14 @@ bool SentPktManager::Initialize(const Reliability& rel,
     return false;
   }
 
+  // Allocate the matching bitmap of ACKed packets.
+  if (!acked_bits_.Initialize(kFlowCtrlWindowPkts))
+  {
+    LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": Error allocating ACKed packet bitmap.\n", conn_id_, stream_id_);
+    return false;
+  }
+
   // Initialize the FEC source packet sending duration to the current smoothed
   // RTT.
   stats_fec_src_dur_sec_ = rtt_mgr_.smoothed_rtt().ToDouble();
@@ -491,6 +513,8 @@ bool SentPktManager::PrepareNextPkt(Packet* pkt, CcId cc_id, bool fin,
     hdr.fec_num_src        = 0;
     hdr.fec_round          = 1;
     hdr.fec_group_id       = fec_grp_id_;
+    hdr.fec_win_flag       = false;
+    hdr.fec_win_start      = 0;
     hdr.encoded_pkt_length = 0;
 
 #ifdef SLIQ_DEBUG
@@ -636,6 +660,7 @@ void SentPktManager::AddSentPkt(
   pkt_info.rexmit_cnt_        = 0;
   pkt_info.cc_id_             = cc_id;
   pkt_info.flags_             = 0;
+  acked_bits_.Clear(seq_num);
   pkt_info.sent_pkt_cnt_      = sent_pkt_cnt;
   pkt_info.prev_sent_pkt_cnt_ = 0;
 
@@ -646,6 +671,7 @@ void SentPktManager::AddSentPkt(
     pkt_info.fec_enc_pkt_len_ = hdr.encoded_pkt_length;
     pkt_info.fec_grp_idx_     = hdr.fec_group_index;
     pkt_info.fec_num_src_     = hdr.fec_num_src;
+    pkt_info.fec_win_start_   = 0;
     pkt_info.fec_round_       = hdr.fec_round;
     pkt_info.fec_pkt_type_    = static_cast<uint8_t>(hdr.fec_pkt_type);
     pkt_info.fec_ts_          = hdr.timestamp;
@@ -699,6 +725,9 @@ void SentPktManager::AddSentPkt(
       grp_info.fec_enc_sent_icr_    = 0;
       grp_info.fec_rexmit_limit_    = rel_.rexmit_limit;
       grp_info.fec_flags_           = 0;
+      grp_info.fec_win_num_         = 0;
+      grp_info.fec_win_cnt_         = 0;
+      grp_info.fec_win_size_        = 0;
       grp_info.start_src_seq_num_   = seq_num;
       grp_info.end_src_seq_num_     = seq_num;
       grp_info.start_enc_seq_num_   = seq_num;
@@ -753,6 +782,29 @@ void SentPktManager::AddSentPkt(
         grp_info.fec_src_to_send_icr_ = grp_info.fec_num_src_;
       }
 
+      // If sliding window FEC is enabled and there are fewer FEC encoded
+      // packets than FEC source packets, then spread the FEC encoded packets
+      // between the FEC source packets, each covering a window of the most
+      // recent FEC source packets.  This allows the receiver to regenerate
+      // lost FEC source packets without waiting for the end of the group.
+      if ((rel_.fec_sliding_win) && (!IS_PURE_ARQ(grp_info)) &&
+          (grp_info.fec_num_enc_ > 0) &&
+          (grp_info.fec_num_enc_ < grp_info.fec_num_src_))
+      {
+        SET_SLIDING_WIN(grp_info);
+        grp_info.fec_win_num_  = grp_info.fec_num_enc_;
+        grp_info.fec_win_size_ = ComputeFecWindowSize(grp_info.fec_num_src_,
+                                                      grp_info.fec_num_enc_);
+
+#ifdef SLIQ_DEBUG
+        LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
+             PRIStreamId ": FEC grp %" PRIFecGroupId " using %" PRIFecSize
+             " sliding windows of %" PRIFecSize " src pkts.\n", conn_id_,
+             stream_id_, grp_info.fec_grp_id_, grp_info.fec_win_num_,
+             grp_info.fec_win_size_);
+#endif
+      }
+
       // Store the number of source and encoded packets in the current group.
       fec_total_pkts_ = (grp_info.fec_num_src_ + grp_info.fec_num_enc_);
     }
@@ -787,6 +839,24 @@ void SentPktManager::AddSentPkt(
     // Update the source packet sent count for the FEC group's current round.
     ++grp_info.fec_src_sent_icr_;
 
+    // Generate any sliding window FEC encoded packets that are due now that
+    // this FEC source packet has been sent.  They are sent before the next
+    // FEC source packet.
+    while (IS_SLIDING_WIN(grp_info) &&
+           (grp_info.fec_win_cnt_ < grp_info.fec_win_num_) &&
+           (GetFecWindowEnd(grp_info, grp_info.fec_win_cnt_) <=
+            (hdr.fec_group_index + 1)))
+    {
+      if (!GenerateFecWindowPkt(grp_info))
+      {
+        LogF(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
+             PRIStreamId ": Cannot continue without generation of FEC "
+             "window packets.\n", conn_id_, stream_id_);
+      }
+
+      grp_info.fec_gen_enc_round_ = grp_info.fec_round_;
+    }
+
     // Check if this is the last FEC source packet to be sent in the FEC
     // group.
     if (hdr.fec_group_index == (grp_info.fec_num_src_ - 1))
@@ -795,8 +865,13 @@ void SentPktManager::AddSentPkt(
 
       // Now that we have all of the FEC source packets for the group,
       // generate any required FEC encoded packets.  Note that any FEC encoded
-      // packets needed later are generated in PrepareNextFecRound().
-      if (grp_info.fec_num_enc_ > 0)
+      // packets needed later are generated in PrepareNextFecRound().  With
+      // sliding windows, they have all been generated already.
+      if (IS_SLIDING_WIN(grp_info))
+      {
+        grp_info.fec_gen_enc_round_ = grp_info.fec_round_;
+      }
+      else if (grp_info.fec_num_enc_ > 0)
       {
         if (!GenerateFecEncodedPkts(
               grp_info.start_src_seq_num_, grp_info.end_src_seq_num_,
@@ -875,6 +950,8 @@ bool SentPktManager::GetBlockedPkt(DataHeader& hdr, Packet*& pkt)
         hdr.fec_num_src     = pkt_info.fec_num_src_;
         hdr.fec_round       = pkt_info.fec_round_;
         hdr.fec_group_id    = pkt_info.fec_grp_id_;
+        hdr.fec_win_flag    = IS_FEC_WIN(pkt_info);
+        hdr.fec_win_start   = pkt_info.fec_win_start_;
 
         if (hdr.fec_pkt_type == FEC_ENC_PKT)
         {
@@ -1190,6 +1267,8 @@ bool SentPktManager::GetRexmitPkt(const Time& now, PktSeqNumber seq_num,
     hdr.fec_round       = (rto_outage ? 0 :
                            GetRexmitFecRound(pkt_info.fec_grp_id_));
     hdr.fec_group_id    = pkt_info.fec_grp_id_;
+    hdr.fec_win_flag    = IS_FEC_WIN(pkt_info);
+    hdr.fec_win_start   = pkt_info.fec_win_start_;
 
     // FEC encoded packets require the encoded packet length.
     if (hdr.fec_pkt_type == FEC_ENC_PKT)
@@ -1531,6 +1610,11 @@ void SentPktManager::ForceFecGroupToEnd()
   // Mark the group as being forced to end.
   SET_FORCE_END(grp_info);
 
+  // Any sliding window FEC encoded packets already generated have used the
+  // group indices starting at the originally planned number of source
+  // packets.  Remember this before it is updated.
+  int32_t  planned_src = grp_info.fec_num_src_;
+
   // Update the number of source and encoded packets in the current group.
   // The number of source packets will be however many have already been sent.
   grp_info.fec_num_src_ = grp_info.fec_src_sent_icr_;
@@ -1582,6 +1666,13 @@ void SentPktManager::ForceFecGroupToEnd()
 
   int32_t  num_enc = (total_to_send - num_src);
 
+  if (IS_SLIDING_WIN(grp_info))
+  {
+    ForceFecWindowGroupToEnd(grp_info, planned_src, num_enc);
+    StartNextFecGroup();
+    return;
+  }
+
   grp_info.fec_num_enc_ = num_enc;
 
   grp_info.fec_src_to_send_icr_ = num_src;
@@ -1635,6 +1726,64 @@ void SentPktManager::ForceFecGroupToEnd()
   StartNextFecGroup();
 }
 
+//============================================================================
+void SentPktManager::ForceFecWindowGroupToEnd(FecGroupInfo& grp_info,
+                                              int32_t planned_src,
+                                              int32_t num_enc)
+{
+  // The sliding window FEC encoded packets that have already been generated
+  // count toward the number of FEC encoded packets needed.  Generate the
+  // remainder as normal FEC encoded packets covering all of the FEC source
+  // packets, skipping over the group indices used by the sliding windows.
+  int32_t  num_src   = grp_info.fec_num_src_;
+  int32_t  win_cnt   = grp_info.fec_win_cnt_;
+  int32_t  idx_adj   = ((planned_src - num_src) + win_cnt);
+  int32_t  blk_cnt   = ((num_enc > win_cnt) ? (num_enc - win_cnt) : 0);
+  int32_t  max_blk   = (static_cast<int32_t>(kMaxFecGroupLengthPkts) -
+                        num_src - idx_adj);
+
+  if (blk_cnt > max_blk)
+  {
+    blk_cnt = ((max_blk > 0) ? max_blk : 0);
+  }
+
+  grp_info.fec_num_enc_         = static_cast<FecSize>(idx_adj + blk_cnt);
+  grp_info.fec_src_to_send_icr_ = static_cast<FecSize>(num_src);
+  grp_info.fec_enc_to_send_icr_ = static_cast<FecSize>(win_cnt + blk_cnt);
+
+#ifdef SLIQ_DEBUG
+  LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+       ": Force end of FEC sliding window grp %" PRIFecGroupId " src %"
+       PRId32 " win %" PRId32 " blk %" PRId32 "\n", conn_id_, stream_id_,
+       grp_info.fec_grp_id_, num_src, win_cnt, blk_cnt);
+#endif
+
+  if (blk_cnt > 0)
+  {
+    if (!GenerateFecEncodedPkts(
+          grp_info.start_src_seq_num_, grp_info.end_src_seq_num_,
+          grp_info.fec_grp_id_, kMaxFecGroupLengthPkts,
+          grp_info.fec_num_src_, static_cast<FecSize>(idx_adj),
+          static_cast<FecSize>(blk_cnt), fec_enc_orig_, false))
+    {
+      LogF(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+           ": Cannot continue without generation of FEC encoded packets.\n",
+           conn_id_, stream_id_);
+    }
+
+    grp_info.fec_gen_enc_round_ = grp_info.fec_round_;
+  }
+  else if (grp_info.fec_enc_sent_icr_ >= grp_info.fec_enc_to_send_icr_)
+  {
+    // All of the packets for the FEC group have been sent.  Watch the
+    // returned ACK packet timestamps for the end of the round.
+    Time          now = Time::Now();
+    PktTimestamp  ts  = conn_.GetCurrentLocalTimestamp();
+
+    RecordEndOfFecRound(now, grp_info, ts);
+  }
+}
+
 //============================================================================
 bool SentPktManager::GetSentPktCnt(
   PktSeqNumber seq_num, RetransCount rexmit_cnt, PktCount& sent_pkt_cnt) const
@@ -1703,6 +1852,16 @@ bool SentPktManager::IsGoodAckPacket(const AckHeader& ack_hdr)
   // Make sure that the next expected sequence number is not going backward.
   if (SEQ_LT(ack_hdr.next_expected_seq_num, rcv_ack_nxt_exp_))
   {
+    // ACK packets sent over different paths are routinely reordered, so a
+    // stale ACK is expected when multipath is in use.
+    if (conn_.num_paths() > 1)
+    {
+      LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %"
+           PRIStreamId ": Ignoring stale ACK reordered across paths.\n",
+           conn_id_, stream_id_);
+      return false;
+    }
+
     LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
          ": Error, ACK next expected seq %" PRIPktSeqNumber " less than "
          "current next expected seq %" PRIPktSeqNumber ".\n", conn_id_,
@@ -1832,8 +1991,10 @@ bool SentPktManager::ProcessAck(const AckHeader& ack_hdr,
     {
       SentPktInfo&  pkt_info = sent_pkts_[(seq_num % kFlowCtrlWindowPkts)];
 
-      // Store the RTT for the packet.
+      // Store the RTT for the packet, and update the RTT estimate for the
+      // path that the packet was sent on.
       pkt_info.rtt_usec_ = rtt_usec;
+      conn_.UpdatePathRtt(now, pkt_info.cc_id_, rtt);
 
       // Look up the congestion control algorithm using the CC ID from when
       // the packet was sent.
@@ -1867,10 +2028,7 @@ bool SentPktManager::ProcessAck(const AckHeader& ack_hdr,
     }
   }
 
-  // Now that the RTT manager has been updated, get the current retransmit
-  // time for use below.
-  Time     rexmit_time = rtt_mgr_.GetFastRexmitTime();
-  ssize_t  new_bif     = stats_bytes_in_flight_;
+  ssize_t  new_bif = stats_bytes_in_flight_;
 
   // Reset the congestion control count adjustments before processing the ACK
   // information.
@@ -1879,10 +2037,8 @@ bool SentPktManager::ProcessAck(const AckHeader& ack_hdr,
   // Process all of the ACKs in the ACK header.
   // - All packets from snd_una_ up to ne_seq_num must be ACKed.
   // - Packets from ne_seq_num to lo_seq_num in the ACK blocks must be ACKed.
-  for (seq_num = snd_una_; SEQ_LT(seq_num, ne_seq_num); ++seq_num)
-  {
-    MarkPktAcked(seq_num, ack_hdr, now, new_data_acked, new_bif);
-  }
+  MarkPktRangeAcked(snd_una_, (ne_seq_num - 1), ack_hdr, now,
+                    new_data_acked, new_bif);
 
   bool          multi_block   = false;
   PktSeqNumber  start_seq_num = 0;
@@ -1907,30 +2063,14 @@ bool SentPktManager::ProcessAck(const AckHeader& ack_hdr,
         }
         else
         {
-          for (PktSeqNumber sn = start_seq_num; SEQ_LEQ(sn, seq_num); ++sn)
-          {
-            MarkPktAcked(sn, ack_hdr, now, new_data_acked, new_bif);
-          }
+          MarkPktRangeAcked(start_seq_num, seq_num, ack_hdr, now,
+                            new_data_acked, new_bif);
           multi_block = false;
         }
         break;
     }
   }
 
-  // Walk the window forward up to the last packet that might be considered
-  // lost.
-  for (seq_num = snd_fec_; SEQ_LEQ(seq_num, (lo_seq_num - kFastRexmitDist));
-       ++seq_num)
-  {
-    SentPktInfo&  pkt_info = sent_pkts_[(seq_num % kFlowCtrlWindowPkts)];
-
-    // If the packet has not been ACKed, then attempt to consider it lost.
-    if (!IS_ACKED(pkt_info))
-    {
-      MaybeMarkPktLost(seq_num, pkt_info, now, rexmit_time);
-    }
-  }
-
   // The bytes in flight should never be less than 0.
   if (new_bif < 0)
   {
@@ -1938,18 +2078,112 @@ bool SentPktManager::ProcessAck(const AckHeader& ack_hdr,
          ": Negative bytes in flight.\n", conn_id_, stream_id_);
   }
 
-  // Update the counts.  This has to happen after the OnPacketLost() and
-  // OnPacketAcked() calls, which are above.
+  // Update the counts.  This has to happen after the OnPacketAcked() calls,
+  // which are above.
   //
   //   pif_adj  - starts at 0, subtract one for each ACKed packet.
   //   bif_adj  - starts at 0, subtract packet size for each ACKed packet.
   //   pipe_adj - starts at 0, subtract packet size for each packet that was
-  //              not lost and is now either ACKed or considered lost,
-  //              subtract packet size again if packet was retransmitted.
+  //              not lost and is now ACKed, subtract packet size again if
+  //              packet was retransmitted.
   ReportCcCntAdjToCc();
 
   stats_bytes_in_flight_ = new_bif;
 
+  // Merge the next expected and largest observed sequence numbers into the
+  // ACK headers waiting to be completed.
+  if ((!ack_batch_.pending_) || SEQ_GT(ne_seq_num, ack_batch_.ne_seq_num_))
+  {
+    ack_batch_.ne_seq_num_ = ne_seq_num;
+  }
+
+  if ((!ack_batch_.pending_) || SEQ_GT(lo_seq_num, ack_batch_.lo_seq_num_))
+  {
+    ack_batch_.lo_seq_num_ = lo_seq_num;
+  }
+
+  ack_batch_.pending_         = true;
+  ack_batch_.new_data_acked_ |= new_data_acked;
+
+  // Hold the observed sequence number timestamps for determining the end of
+  // FEC group rounds once the ACK headers are completed.  If there is no
+  // room left, then use them now.
+  if (rel_.mode == SEMI_RELIABLE_ARQ_FEC)
+  {
+    for (uint8_t i = 0; i < ack_hdr.num_observed_times; ++i)
+    {
+      if (ack_batch_.num_obs_ < kMaxAckBatchObsTimes)
+      {
+        ack_batch_.obs_[ack_batch_.num_obs_].seq_num_   =
+          ack_hdr.observed_time[i].seq_num;
+        ack_batch_.obs_[ack_batch_.num_obs_].timestamp_ =
+          ack_hdr.observed_time[i].timestamp;
+        ++ack_batch_.num_obs_;
+      }
+      else
+      {
+        ProcessEndOfFecRounds(ack_hdr.observed_time[i].seq_num,
+                              ack_hdr.observed_time[i].timestamp);
+      }
+    }
+  }
+
+  return true;
+}
+
+//============================================================================
+void SentPktManager::CompleteAckProcessing(const Time& now,
+                                           bool& new_data_acked)
+{
+  new_data_acked = ack_batch_.new_data_acked_;
+
+  if (!ack_batch_.pending_)
+  {
+    return;
+  }
+
+  PktSeqNumber  ne_seq_num = ack_batch_.ne_seq_num_;
+  PktSeqNumber  lo_seq_num = ack_batch_.lo_seq_num_;
+
+  // Now that the RTT manager has been updated, get the current retransmit
+  // time for use below.
+  Time  rexmit_time = rtt_mgr_.GetFastRexmitTime();
+
+  // Reset the congestion control count adjustments before loss detection.
+  ResetCcCntAdjInfo();
+
+  // Walk the unACKed packets in the window forward up to the last packet
+  // that might be considered lost.  The ACKed packet bitmap skips over the
+  // ACKed packets.
+  PktSeqNumber  end_seq_num = (lo_seq_num - kFastRexmitDist);
+  PktSeqNumber  seq_num     = snd_fec_;
+
+  while (acked_bits_.FindNextClear(seq_num, end_seq_num, seq_num))
+  {
+    SentPktInfo&  pkt_info = sent_pkts_[(seq_num % kFlowCtrlWindowPkts)];
+
+    // The packet has not been ACKed, so attempt to consider it lost.
+    // Packets sent on different paths are reordered by the path delay
+    // differences, so with multiple paths the distance is measured using
+    // the packets sent on the same path, unless that path has failed.
+    if ((conn_.num_paths() == 1) || conn_.IsCcPathFailed(pkt_info.cc_id_) ||
+        (cc_acked_[pkt_info.cc_id_] &&
+         SEQ_LEQ((pkt_info.cc_seq_num_ + kFastRexmitDist),
+                 cc_lrg_acked_seq_[pkt_info.cc_id_])))
+    {
+      MaybeMarkPktLost(seq_num, pkt_info, now, rexmit_time);
+    }
+
+    ++seq_num;
+  }
+
+  // Update the counts.  This has to happen after the OnPacketLost() calls,
+  // which are above.
+  //
+  //   pipe_adj - starts at 0, subtract packet size for each packet that was
+  //              not lost and is now considered lost.
+  ReportCcCntAdjToCc();
+
   // Move snd_una_ up to the next expected sequence number in the received ACK
   // packet.  These packets have either been ACKed or are FEC packets that the
   // receiver has given up on (based on move forward packets).
@@ -2001,16 +2235,16 @@ bool SentPktManager::ProcessAck(const AckHeader& ack_hdr,
 
   // Determine the end of FEC group rounds using the observed sequence number
   // timestamps.
-  if ((rel_.mode == SEMI_RELIABLE_ARQ_FEC) &&
-      (ack_hdr.num_observed_times > 0))
+  for (size_t i = 0; i < ack_batch_.num_obs_; ++i)
   {
-    for (uint8_t i = 0; i < ack_hdr.num_observed_times; ++i)
-    {
-      ProcessEndOfFecRounds(ack_hdr.observed_time[i].seq_num,
-                            ack_hdr.observed_time[i].timestamp);
-    }
+    ProcessEndOfFecRounds(ack_batch_.obs_[i].seq_num_,
+                          ack_batch_.obs_[i].timestamp_);
   }
 
+  ack_batch_.pending_        = false;
+  ack_batch_.new_data_acked_ = false;
+  ack_batch_.num_obs_        = 0;
+
 #ifdef SLIQ_DEBUG
   LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
        ": Updated snd_wnd_ %" PRIWindowSize " snd_fec_ %" PRIPktSeqNumber
@@ -2022,8 +2256,6 @@ bool SentPktManager::ProcessAck(const AckHeader& ack_hdr,
        rcv_ack_nxt_exp_, rcv_ack_lrg_obs_, fec_enc_orig_.GetCount(),
        fec_enc_addl_.GetCount(), stats_bytes_in_flight_);
 #endif
-
-  return true;
 }
 
 //============================================================================
@@ -2104,7 +2336,7 @@ void SentPktManager::ProcessImplicitAck(const Time& now,
 }
 
 //============================================================================
-bool SentPktManager::ForceUnackedPacketsLost(const Time& now)
+bool SentPktManager::ForceUnackedPacketsLost(const Time& now, int cc_id)
 {
   // Get the current retransmit time for use below.
   Time  rexmit_time = rtt_mgr_.GetFastRexmitTime();
@@ -2119,6 +2351,11 @@ bool SentPktManager::ForceUnackedPacketsLost(const Time& now)
   {
     SentPktInfo&  pkt_info = sent_pkts_[(seq % kFlowCtrlWindowPkts)];
 
+    if ((cc_id >= 0) && (pkt_info.cc_id_ != cc_id))
+    {
+      continue;
+    }
+
     if ((!IS_ACKED(pkt_info)) && (!IS_LOST(pkt_info)))
     {
       MaybeMarkPktLost(seq, pkt_info, now, rexmit_time, true);
@@ -2334,6 +2571,14 @@ void SentPktManager::MarkPktAcked(
   cc_alg->OnPacketAcked(stream_id_, now, seq_num, pkt_info.cc_seq_num_,
                         ack_hdr.next_expected_seq_num, pkt_info.pkt_len_);
 
+  // Record the largest ACKed congestion control sequence number.
+  if ((!cc_acked_[pkt_info.cc_id_]) ||
+      SEQ_GT(pkt_info.cc_seq_num_, cc_lrg_acked_seq_[pkt_info.cc_id_]))
+  {
+    cc_acked_[pkt_info.cc_id_]         = true;
+    cc_lrg_acked_seq_[pkt_info.cc_id_] = pkt_info.cc_seq_num_;
+  }
+
   // The unACKed packet is about to be marked as ACKed.  Update the counts.
   cc_cnt_adj_[pkt_info.cc_id_].updated_  = true;
   cc_cnt_adj_[pkt_info.cc_id_].pif_adj_ -= 1;
@@ -2388,6 +2633,7 @@ void SentPktManager::MarkPktAcked(
   // Mark the packet as ACKed.  It is also no longer considered lost.
   SET_ACKED(pkt_info);
   CLEAR_LOST(pkt_info);
+  acked_bits_.Set(seq_num);
 
   // Update the new data ACKed flag.
   new_data_acked = true;
@@ -2399,6 +2645,22 @@ void SentPktManager::MarkPktAcked(
 #endif
 }
 
+//============================================================================
+void SentPktManager::MarkPktRangeAcked(
+  PktSeqNumber lo_seq_num, PktSeqNumber hi_seq_num, const AckHeader& ack_hdr,
+  const Time& now, bool& new_data_acked, ssize_t& new_bif)
+{
+  // Only visit the packets in the range that have not been ACKed yet.
+  PktSeqNumber  seq_num = lo_seq_num;
+
+  while (acked_bits_.FindNextClear(seq_num, hi_seq_num, seq_num))
+  {
+    MarkPktAcked(seq_num, ack_hdr, now, new_data_acked, new_bif);
+
+    ++seq_num;
+  }
+}
+
 //============================================================================
 void SentPktManager::MaybeMarkPktLost(
   PktSeqNumber seq_num, SentPktInfo& pkt_info, const Time& now,
@@ -2658,6 +2920,8 @@ bool SentPktManager::GetFecEncPkt(const Time& now, CcId cc_id,
   hdr.fec_num_src        = fe_pkt_info.fec_num_src_;
   hdr.fec_round          = GetRexmitFecRound(fe_pkt_info.fec_grp_id_);
   hdr.fec_group_id       = fe_pkt_info.fec_grp_id_;
+  hdr.fec_win_flag       = IS_FEC_WIN(fe_pkt_info);
+  hdr.fec_win_start      = fe_pkt_info.fec_win_start_;
   hdr.encoded_pkt_length = fe_pkt_info.fec_enc_pkt_len_;
 
   // Add any TTGs to the packet.
@@ -2751,6 +3015,7 @@ void SentPktManager::MoveFecEncPkt(
   // Move the FEC information from the FEC encoded data packet queue element
   // into the send window element.
   pkt_info.MoveFecInfo(fe_pkt_info);
+  acked_bits_.Clear(seq_num);
 
   pkt_info.seq_num_           = seq_num;
   pkt_info.conn_seq_num_      = conn_seq;
@@ -2784,8 +3049,12 @@ void SentPktManager::MoveFecEncPkt(
     // Update the encoded packet sent count for the FEC group's current round.
     ++grp_info.fec_enc_sent_icr_;
 
-    // Update the FEC encoded packet sequence numbers in the FEC group.
-    if (pkt_info.fec_grp_idx_ == grp_info.fec_num_src_)
+    // Update the FEC encoded packet sequence numbers in the FEC group.  The
+    // first sliding window FEC encoded packet sent is found by the start
+    // sequence number still being at its initial value.
+    if ((pkt_info.fec_grp_idx_ == grp_info.fec_num_src_) ||
+        (IS_SLIDING_WIN(grp_info) &&
+         (grp_info.start_enc_seq_num_ == grp_info.start_src_seq_num_)))
     {
       grp_info.start_enc_seq_num_ = seq_num;
     }
@@ -3363,7 +3632,11 @@ void SentPktManager::AddPktTtgs(const Time& now, Packet* pkt, DataHeader& hdr)
   }
 
   // This is an FEC encoded packet.  Add adjusted TTG values for all FEC
-  // source packets in the group.
+  // source packets in the group, or up to the end of the window for sliding
+  // window FEC encoded packets.
+  FecSize  num_src = (hdr.fec_win_flag ? hdr.fec_num_src :
+                      grp_info.fec_num_src_);
+
   for (PktSeqNumber seq_num = grp_info.start_src_seq_num_;
        (SEQ_LEQ(seq_num, grp_info.end_src_seq_num_) &&
         SEQ_LT(seq_num, snd_nxt_)); ++seq_num)
@@ -3371,7 +3644,7 @@ void SentPktManager::AddPktTtgs(const Time& now, Packet* pkt, DataHeader& hdr)
     SentPktInfo&  spi = sent_pkts_[(seq_num % kFlowCtrlWindowPkts)];
 
     if (IS_FEC(spi) && (spi.fec_grp_id_ == grp_info.fec_grp_id_) &&
-        (spi.fec_pkt_type_ == FEC_SRC_PKT))
+        (spi.fec_pkt_type_ == FEC_SRC_PKT) && (spi.fec_grp_idx_ < num_src))
     {
       if (hdr.num_ttg >= kMaxTtgs)
       {
@@ -3409,7 +3682,7 @@ void SentPktManager::AddPktTtgs(const Time& now, Packet* pkt, DataHeader& hdr)
     }
   }
 
-  if (hdr.num_ttg != grp_info.fec_num_src_)
+  if (hdr.num_ttg != num_src)
   {
     LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
          ": Error, not all src pkts found for FEC grp %" PRIFecGroupId ".\n",
@@ -3588,7 +3861,10 @@ void SentPktManager::RecordFecGroupPktAck(const Time& now,
     }
   }
 
-  // Update the FEC group's packet counts based on the ACK.
+  // Update the FEC group's packet counts based on the ACK.  An ACK for a
+  // sliding window FEC encoded packet is not counted, since it does not
+  // necessarily add a degree of freedom for the whole group.  Any FEC source
+  // packets that the receiver regenerates with it will be ACKed instead.
   bool  updated_sent_icr = false;
 
   if (pkt_info.fec_pkt_type_ == FEC_SRC_PKT)
@@ -3606,7 +3882,7 @@ void SentPktManager::RecordFecGroupPktAck(const Time& now,
       updated_sent_icr = true;
     }
   }
-  else
+  else if (!IS_FEC_WIN(pkt_info))
   {
     grp_info.fec_enc_ack_cnt_ += 1;
 
@@ -3843,16 +4119,17 @@ bool SentPktManager::GenerateFecEncodedPkts(
     }
 
     // Initialize the FEC information for the FEC encoded packet.
-    fe_pkt_info.pkt_len_      = enc_len;
-    fe_pkt_info.bytes_sent_   = 0;
-    fe_pkt_info.flags_        = 0;
+    fe_pkt_info.pkt_len_       = enc_len;
+    fe_pkt_info.bytes_sent_    = 0;
+    fe_pkt_info.flags_         = 0;
     SET_FEC(fe_pkt_info);
-    fe_pkt_info.fec_grp_id_   = grp_id;
-    fe_pkt_info.fec_grp_idx_  = grp_idx;
-    fe_pkt_info.fec_num_src_  = k;
-    fe_pkt_info.fec_round_    = 0;
-    fe_pkt_info.fec_pkt_type_ = static_cast<uint8_t>(FEC_ENC_PKT);
-    fe_pkt_info.fec_ts_       = 0;
+    fe_pkt_info.fec_grp_id_    = grp_id;
+    fe_pkt_info.fec_grp_idx_   = grp_idx;
+    fe_pkt_info.fec_num_src_   = k;
+    fe_pkt_info.fec_win_start_ = 0;
+    fe_pkt_info.fec_round_     = 0;
+    fe_pkt_info.fec_pkt_type_  = static_cast<uint8_t>(FEC_ENC_PKT);
+    fe_pkt_info.fec_ts_        = 0;
 
     vdm_info_.enc_pkt_data_[enc_idx] = fe_pkt_info.packet_->GetBuffer();
   }
@@ -3899,6 +4176,218 @@ bool SentPktManager::GenerateFecEncodedPkts(
   return true;
 }
 
+//============================================================================
+bool SentPktManager::GenerateFecWindowPkt(FecGroupInfo& grp_info)
+{
+  FecGroupId  grp_id    = grp_info.fec_grp_id_;
+  FecSize     win_end   = GetFecWindowEnd(grp_info, grp_info.fec_win_cnt_);
+  FecSize     win_start = ((win_end > grp_info.fec_win_size_) ?
+                           (win_end - grp_info.fec_win_size_) : 0);
+  FecSize     grp_idx   = (grp_info.fec_num_src_ + grp_info.fec_win_cnt_);
+
+#ifdef SLIQ_DEBUG
+  LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+       ": Generate FEC window packet, grp %" PRIFecGroupId " idx %"
+       PRIFecSize " window %" PRIFecSize "-%" PRIFecSize ".\n", conn_id_,
+       stream_id_, grp_id, grp_idx, win_start, (win_end - 1));
+#endif
+
+  // Check that the generated FEC encoded data packet will fit in the
+  // original FEC encoded data packet queue.
+  if (fec_enc_orig_.GetCount() >= fec_enc_orig_.GetMaxSize())
+  {
+    LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": Error, FEC window packet will not fit in queue.\n", conn_id_,
+         stream_id_);
+    return false;
+  }
+
+  // Clear the VDM encoder information.  The source data packets are indexed
+  // by their FEC group index, with those outside of the window left NULL.
+  memset(&vdm_info_, 0, sizeof(vdm_info_));
+
+  vdm_info_.num_src_pkt_ = win_end;
+
+  FecSize       found   = 0;
+  uint16_t      enc_len = 0;
+  PktSeqNumber  seq_num = 0;
+
+  for (seq_num = grp_info.start_src_seq_num_;
+       (SEQ_LEQ(seq_num, grp_info.end_src_seq_num_) &&
+        SEQ_LT(seq_num, snd_nxt_)); ++seq_num)
+  {
+    SentPktInfo&  pkt_info = sent_pkts_[(seq_num % kFlowCtrlWindowPkts)];
+
+    if ((!IS_FEC(pkt_info)) || (pkt_info.fec_grp_id_ != grp_id) ||
+        (pkt_info.fec_pkt_type_ != FEC_SRC_PKT) ||
+        (pkt_info.fec_grp_idx_ < win_start) ||
+        (pkt_info.fec_grp_idx_ >= win_end))
+    {
+      continue;
+    }
+
+    if (pkt_info.packet_ == NULL)
+    {
+      LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+           ": Error, FEC source data packet seq %" PRIPktSeqNumber " for "
+           "grp %" PRIFecGroupId " has NULL packet.\n", conn_id_, stream_id_,
+           seq_num, grp_id);
+      return false;
+    }
+
+    // Copy the packet's sequence number to the end of the payload, just as
+    // is done in GenerateFecEncodedPkts().
+    size_t    mdata_len   = pkt_info.packet_->GetMetadataHeaderLengthInBytes();
+    size_t    data_len    = pkt_info.packet_->GetLengthInBytes();
+    uint16_t  pkt_len     = static_cast<uint16_t>(mdata_len + data_len);
+    uint32_t  seq_num_nbo = htonl(seq_num);
+
+    if ((data_len + sizeof(seq_num_nbo)) >
+        pkt_info.packet_->GetMaxLengthInBytes())
+    {
+      LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+           ": Error, FEC source data packet seq %" PRIPktSeqNumber " is too "
+           "big to add sequence number.\n", conn_id_, stream_id_, seq_num);
+      return false;
+    }
+
+    ::memcpy(reinterpret_cast<void*>(
+               pkt_info.packet_->GetBuffer(data_len)),
+             &seq_num_nbo, sizeof(seq_num_nbo));
+
+    pkt_len += static_cast<uint16_t>(sizeof(seq_num_nbo));
+
+    vdm_info_.src_pkt_data_[pkt_info.fec_grp_idx_] =
+      pkt_info.packet_->GetMetadataHeaderBuffer();
+    vdm_info_.src_pkt_size_[pkt_info.fec_grp_idx_] = pkt_len;
+
+    if (pkt_len > enc_len)
+    {
+      enc_len = pkt_len;
+    }
+
+    ++found;
+  }
+
+  if (found != (win_end - win_start))
+  {
+    LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": Error, only %" PRIFecSize " of %" PRIFecSize " FEC source data "
+         "packets for grp %" PRIFecGroupId " window were found.\n", conn_id_,
+         stream_id_, found, (win_end - win_start), grp_id);
+    return false;
+  }
+
+  // Make sure encoded data packets are always an even number of bytes in
+  // length.
+  if (enc_len & 0x1)
+  {
+    ++enc_len;
+  }
+
+  // Add a new entry at the tail of the queue, then get the new tail entry to
+  // use.
+  if (!fec_enc_orig_.AddToTail())
+  {
+    LogF(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": Error adding element to tail of FEC encoded packet queue.\n",
+         conn_id_, stream_id_);
+  }
+
+  SentPktInfo&  fe_pkt_info = fec_enc_orig_.GetTail();
+
+  if (fe_pkt_info.packet_ != NULL)
+  {
+    packet_pool_.Recycle(fe_pkt_info.packet_);
+  }
+
+  fe_pkt_info.packet_ = packet_pool_.Get();
+
+  if (fe_pkt_info.packet_ == NULL)
+  {
+    LogF(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
+         ": Error getting packet from pool.\n", conn_id_, stream_id_);
+  }
+
+  fe_pkt_info.packet_->SetLengthInBytes(enc_len);
+
+  fe_pkt_info.pkt_len_       = enc_len;
+  fe_pkt_info.bytes_sent_    = 0;
+  fe_pkt_info.flags_         = 0;
+  SET_FEC(fe_pkt_info);
+  SET_FEC_WIN(fe_pkt_info);
+  fe_pkt_info.fec_grp_id_    = grp_id;
+  fe_pkt_info.fec_grp_idx_   = grp_idx;
+  fe_pkt_info.fec_num_src_   = win_end;
+  fe_pkt_info.fec_win_start_ = win_start;
+  fe_pkt_info.fec_round_     = 0;
+  fe_pkt_info.fec_pkt_type_  = static_cast<uint8_t>(FEC_ENC_PKT);
+  fe_pkt_info.fec_ts_        = 0;
+
+  // Encode the packet.
+  uint16_t  coef[MAX_FEC_RATE];
+
+  VdmFec::GetWindowCoefficients(grp_id, grp_idx, win_start, win_end, coef);
+  VdmFec::EncodeWindowPacket(vdm_info_.num_src_pkt_, vdm_info_.src_pkt_data_,
+                             vdm_info_.src_pkt_size_, coef,
+                             fe_pkt_info.packet_->GetBuffer(),
+                             fe_pkt_info.fec_enc_pkt_len_);
+
+  ++grp_info.fec_win_cnt_;
+
+  return true;
+}
+
+//============================================================================
+FecSize SentPktManager::GetFecWindowEnd(const FecGroupInfo& grp_info,
+                                        FecSize win_idx)
+{
+  if (grp_info.fec_win_num_ == 0)
+  {
+    return grp_info.fec_num_src_;
+  }
+
+  return static_cast<FecSize>(
+    (((static_cast<uint32_t>(win_idx) + 1) * grp_info.fec_num_src_) +
+     grp_info.fec_win_num_ - 1) / grp_info.fec_win_num_);
+}
+
+//============================================================================
+FecSize SentPktManager::ComputeFecWindowSize(FecSize num_src, FecSize num_enc)
+{
+  if ((num_enc == 0) || (num_enc >= num_src))
+  {
+    return num_src;
+  }
+
+  // The FEC encoded packets are spread evenly, one every spacing FEC source
+  // packets.
+  FecSize  spacing = ((num_src + num_enc - 1) / num_enc);
+
+  // Split the target packet loss probability evenly across the target number
+  // of rounds, the same way the FEC lookup tables are built.
+  FecRound  rnds    = ((fec_target_rounds_ > 0) ? fec_target_rounds_ : 1);
+  double    rnd_eps = (1.0 - pow(rel_.fec_target_pkt_recv_prob,
+                                 (1.0 / static_cast<double>(rnds))));
+
+  // A lost FEC source packet is covered by one FEC encoded packet for each
+  // spacing in the window.  Grow the window until the probability of losing
+  // the FEC source packet and all of the FEC encoded packets covering it
+  // drops below the per-round target.
+  FecSize  span   = 1;
+  double   p_loss = (fec_per_ * fec_per_);
+
+  while ((span < num_enc) && (p_loss > rnd_eps))
+  {
+    p_loss *= fec_per_;
+    ++span;
+  }
+
+  FecSize  win_size = (span * spacing);
+
+  return ((win_size < num_src) ? win_size : num_src);
+}
+
 //============================================================================
 FecRound SentPktManager::GetRexmitFecRound(FecGroupId grp_id)
 {
@@ -3954,6 +4443,14 @@ bool SentPktManager::PrepareNextFecRound(FecGroupInfo& grp_info)
   int32_t  src_lost = ((src_rcvd <= num_src) ? (num_src - src_rcvd) : 0);
   int32_t  enc_lost = ((enc_rcvd <= num_enc) ? (num_enc - enc_rcvd) : 0);
 
+  // Sliding window FEC encoded packets are never retransmitted, since each
+  // one only covers part of the group.  Any additional FEC encoded packets
+  // are newly generated ones covering the entire group.
+  if (IS_SLIDING_WIN(grp_info))
+  {
+    enc_lost = 0;
+  }
+
   // Determine the total number of packets to be sent.
   int32_t  total_to_send = 0;
 
@@ -5199,6 +5696,18 @@ SentPktManager::CcCntAdjInfo::~CcCntAdjInfo()
 {
 }
 
+//============================================================================
+SentPktManager::AckBatchInfo::AckBatchInfo()
+    : pending_(false), new_data_acked_(false), ne_seq_num_(0),
+      lo_seq_num_(0), num_obs_(0), obs_()
+{
+}
+
+//============================================================================
+SentPktManager::AckBatchInfo::~AckBatchInfo()
+{
+}
+
 //============================================================================
 SentPktManager::CcUnaPktInfo::CcUnaPktInfo()
     : has_una_(false), una_cc_seq_num_(0), prev_has_una_(false),
@@ -5218,8 +5727,8 @@ SentPktManager::SentPktInfo::SentPktInfo()
       last_xmit_time_(), pkt_len_(0), bytes_sent_(0), rexmit_limit_(0),
       rexmit_cnt_(0), cc_id_(0), flags_(0), sent_pkt_cnt_(0),
       prev_sent_pkt_cnt_(0), fec_grp_id_(0), fec_enc_pkt_len_(0),
-      fec_grp_idx_(0), fec_num_src_(0), fec_round_(0), fec_pkt_type_(0),
-      fec_ts_(0)
+      fec_grp_idx_(0), fec_num_src_(0), fec_win_start_(0), fec_round_(0),
+      fec_pkt_type_(0), fec_ts_(0)
 {
 }
 
@@ -5260,6 +5769,7 @@ void SentPktManager::SentPktInfo::MoveFecInfo(SentPktInfo& spi)
   fec_enc_pkt_len_ = spi.fec_enc_pkt_len_;
   fec_grp_idx_     = spi.fec_grp_idx_;
   fec_num_src_     = spi.fec_num_src_;
+  fec_win_start_   = spi.fec_win_start_;
   fec_round_       = spi.fec_round_;
   fec_pkt_type_    = spi.fec_pkt_type_;
   fec_ts_          = spi.fec_ts_;
@@ -5335,8 +5845,9 @@ SentPktManager::FecGroupInfo::FecGroupInfo()
       fec_enc_ack_cnt_(0), fec_round_(0), fec_max_rounds_(0),
       fec_gen_enc_round_(0), fec_src_to_send_icr_(0), fec_enc_to_send_icr_(0),
       fec_src_sent_icr_(0), fec_enc_sent_icr_(0), fec_rexmit_limit_(0),
-      fec_flags_(0), start_src_seq_num_(0), end_src_seq_num_(0),
-      start_enc_seq_num_(0), end_enc_seq_num_(0)
+      fec_flags_(0), fec_win_num_(0), fec_win_cnt_(0), fec_win_size_(0),
+      start_src_seq_num_(0), end_src_seq_num_(0), start_enc_seq_num_(0),
+      end_enc_seq_num_(0)
 {
 }
 
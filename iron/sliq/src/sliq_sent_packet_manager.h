@@ -43,6 +43,7 @@
 #include "sliq_private_defs.h"
 #include "sliq_private_types.h"
 #include "sliq_rtt_manager.h"
+#include "sliq_seq_num_bitmap.h"
 #include "sliq_vdm_fec.h"
 
 #include "itime.h"
@@ -437,6 +438,11 @@ namespace sliq
 
     /// \brief Process a received ACK header.
     ///
+    /// Updates the RTT estimates and marks the ACKed packets.  Loss
+    /// detection and moving the send window forward are deferred until
+    /// CompleteAckProcessing() is called, which allows the ACK headers
+    /// received in a batch of packets to be completed together.
+    ///
     /// \param  ack_hdr         The received ACK header.
     /// \param  rcv_time        The ACK receive time.
     /// \param  now             The current time.
@@ -451,6 +457,18 @@ namespace sliq
                     const iron::Time& now, bool& new_data_acked,
                     PktSeqNumber& lo_conn_seq);
 
+    /// \brief Complete the processing of the ACK headers passed to
+    /// ProcessAck() since the last call.
+    ///
+    /// Performs loss detection using the merged next expected and largest
+    /// observed sequence numbers of the ACK headers, moves the send window
+    /// forward, and drops any stale or lost packets.
+    ///
+    /// \param  now             The current time.
+    /// \param  new_data_acked  A reference to a flag that is set to true if
+    ///                         any of the ACK headers ACKed new data.
+    void CompleteAckProcessing(const iron::Time& now, bool& new_data_acked);
+
     /// \brief Process an implicit ACK.
     ///
     /// Implicit ACKs are caused by ACKs on other streams that increase the
@@ -463,10 +481,12 @@ namespace sliq
 
     /// \brief Force all of the unACKed packets to be considered lost.
     ///
-    /// \param  now  The current time.
+    /// \param  now    The current time.
+    /// \param  cc_id  The congestion control identifier that the packets
+    ///                must have been sent with, or -1 for all packets.
     ///
     /// \return  True if the update is successful, false otherwise.
-    bool ForceUnackedPacketsLost(const iron::Time& now);
+    bool ForceUnackedPacketsLost(const iron::Time& now, int cc_id = -1);
 
     /// \brief Handle the end of an outage.
     void LeaveOutage();
@@ -521,6 +541,18 @@ namespace sliq
       return (snd_nxt_ - 1);
     }
 
+    /// \brief Get the number of bytes needed to send a data packet sequence
+    /// number in a compact data header.
+    ///
+    /// \param  seq_num  The data packet sequence number being sent.
+    ///
+    /// \return  The number of low-order bytes to send, from 1 to 4.
+    inline size_t GetCompactSeqNumLength(PktSeqNumber seq_num) const
+    {
+      return Framer::ComputeSeqNumLength(seq_num, rcv_ack_lrg_obs_,
+                                         (snd_nxt_ - 1));
+    }
+
     /// \brief Check if all of the data has been ACKed or not.
     ///
     /// \return  True if all of the data has been ACKed.
@@ -537,6 +569,19 @@ namespace sliq
       return fin_sent_;
     }
 
+    /// \brief Get the packet transmission statistics.
+    ///
+    /// \param  stats  A reference to where the statistics are returned.
+    inline void GetSendStats(SendStats& stats) const
+    {
+      stats.data_pkts    = (stats_pkts_.norm_sent_ +
+                            stats_pkts_.fec_src_sent_);
+      stats.rexmit_pkts  = (stats_pkts_.norm_rx_sent_ +
+                            stats_pkts_.fec_src_rx_sent_);
+      stats.fec_enc_pkts = (stats_pkts_.fec_enc_sent_ +
+                            stats_pkts_.fec_enc_rx_sent_);
+    }
+
    private:
 
     /// Count adjustment information for a congestion control algorithm.
@@ -580,6 +625,37 @@ namespace sliq
       PktSeqNumber  prev_una_cc_seq_num_;
     };
 
+    /// Information for the ACK headers that have been processed but not
+    /// completed yet.
+    struct AckBatchInfo
+    {
+      AckBatchInfo();
+      virtual ~AckBatchInfo();
+
+      /// A flag recording if any ACK headers are waiting to be completed.
+      bool          pending_;
+
+      /// A flag recording if the ACK headers ACKed new data.
+      bool          new_data_acked_;
+
+      /// The largest next expected sequence number in the ACK headers.
+      PktSeqNumber  ne_seq_num_;
+
+      /// The largest observed sequence number in the ACK headers.
+      PktSeqNumber  lo_seq_num_;
+
+      /// The number of observed packet times held in obs_.
+      size_t        num_obs_;
+
+      /// The observed packet times from the ACK headers, held for
+      /// determining the end of FEC group rounds.
+      struct
+      {
+        PktSeqNumber  seq_num_;
+        PktTimestamp  timestamp_;
+      } obs_[kMaxAckBatchObsTimes];
+    };
+
     /// Information for each sent packet.  The size of this structure needs to
     /// be as small as possible (currently 96 bytes on a 64-bit OS).
     struct SentPktInfo
@@ -641,7 +717,8 @@ namespace sliq
       /// The associated congestion control identifier.
       CcId           cc_id_;
 
-      /// The packet's flags: FEC, FIN, blocked, acked, lost, and candidate.
+      /// The packet's flags: FEC, FIN, blocked, acked, lost, candidate, and
+      /// FEC sliding window.
       uint8_t        flags_;
 
       /// The sent packet count for this packet with the current
@@ -662,9 +739,15 @@ namespace sliq
       FecSize        fec_grp_idx_;
 
       /// The FEC packet's number of FEC source packets in the FEC group.
-      /// Only set in FEC encoded packets.
+      /// Only set in FEC encoded packets.  For sliding window FEC encoded
+      /// packets, this is one more than the last source packet index in the
+      /// window.
       FecSize        fec_num_src_;
 
+      /// The FEC packet's first source packet index in the window.  Only set
+      /// in sliding window FEC encoded packets.
+      FecSize        fec_win_start_;
+
       /// The FEC packet's round number.
       FecRound       fec_round_;
 
@@ -718,7 +801,7 @@ namespace sliq
     };
 
     /// Information for each FEC group.  The size of this structure needs to
-    /// be as small as possible (currently 32 bytes on a 64-bit OS).
+    /// be as small as possible (currently 40 bytes on a 64-bit OS).
     struct FecGroupInfo
     {
       FecGroupInfo();
@@ -731,7 +814,10 @@ namespace sliq
       FecSize       fec_num_src_;
 
       /// The number of FEC encoded packets in the FEC group.  Set to 0 when
-      /// the number is not known yet.
+      /// the number is not known yet.  For sliding window groups that are
+      /// forced to end early, this includes the unused group index positions
+      /// between the actual number of FEC source packets and the first
+      /// sliding window FEC encoded packet.
       FecSize       fec_num_enc_;
 
       /// The number of FEC source packets ACKed in the FEC group.
@@ -770,9 +856,21 @@ namespace sliq
       /// the group.
       RetransCount  fec_rexmit_limit_;
 
-      /// The FEC group's flags: pure ARQ, latency sensitive, and force end.
+      /// The FEC group's flags: pure ARQ, latency sensitive, force end, and
+      /// sliding window.
       uint8_t       fec_flags_;
 
+      /// The number of sliding window FEC encoded packets to be generated in
+      /// round 1.
+      FecSize       fec_win_num_;
+
+      /// The number of sliding window FEC encoded packets generated so far.
+      FecSize       fec_win_cnt_;
+
+      /// The number of FEC source packets covered by each sliding window FEC
+      /// encoded packet.
+      FecSize       fec_win_size_;
+
       /// The sequence number of the first FEC source packet in the group.
       PktSeqNumber  start_src_seq_num_;
 
@@ -891,6 +989,22 @@ namespace sliq
                       const iron::Time& now, bool& new_data_acked,
                       ssize_t& new_bif);
 
+    /// \brief Mark all of the packets in a range as ACKed.
+    ///
+    /// Packets in the range that are already ACKed are skipped using the
+    /// ACKed packet bitmap.
+    ///
+    /// \param  lo_seq_num      The lowest sequence number in the range.
+    /// \param  hi_seq_num      The highest sequence number in the range.
+    /// \param  ack_hdr         The ACK header.
+    /// \param  now             The current time.
+    /// \param  new_data_acked  The new data ACKed flag that will be updated.
+    /// \param  new_bif         The new bytes in flight value that will be
+    ///                         updated.
+    void MarkPktRangeAcked(PktSeqNumber lo_seq_num, PktSeqNumber hi_seq_num,
+                           const AckHeader& ack_hdr, const iron::Time& now,
+                           bool& new_data_acked, ssize_t& new_bif);
+
     /// \brief Possibly mark the specified packet as being lost.
     ///
     /// \param  seq_num      The sequence number of the packet that might be
@@ -1069,6 +1183,52 @@ namespace sliq
                                 FecSize enc_offset, FecSize enc_cnt,
                                 SentPktQueue& fec_enc_q, bool addl_flag);
 
+    /// \brief Generate the next sliding window FEC encoded data packet for
+    /// an FEC group in round 1.
+    ///
+    /// The packet is added to the original FEC encoded data packet queue.
+    ///
+    /// \param  grp_info  A reference to the group information.
+    ///
+    /// \return  True if the FEC encoded data packet was generated, or false
+    ///          otherwise.
+    bool GenerateFecWindowPkt(FecGroupInfo& grp_info);
+
+    /// \brief Force a sliding window FEC group to end early.
+    ///
+    /// \param  grp_info     A reference to the group information, with the
+    ///                      number of FEC source packets already updated.
+    /// \param  planned_src  The number of FEC source packets originally
+    ///                      planned for the group.
+    /// \param  num_enc      The total number of FEC encoded packets needed
+    ///                      for the actual number of FEC source packets.
+    void ForceFecWindowGroupToEnd(FecGroupInfo& grp_info, int32_t planned_src,
+                                  int32_t num_enc);
+
+    /// \brief Get the number of FEC source packets sent in an FEC group when
+    /// a sliding window FEC encoded data packet is to be generated.
+    ///
+    /// The sliding window FEC encoded data packets are spread evenly across
+    /// the FEC source packets, with the last one following the last FEC
+    /// source packet.
+    ///
+    /// \param  grp_info  A reference to the group information.
+    /// \param  win_idx   The zero-based sliding window FEC encoded data
+    ///                   packet index.
+    ///
+    /// \return  The number of FEC source packets sent, which is also one
+    ///          more than the last FEC source packet index in the window.
+    FecSize GetFecWindowEnd(const FecGroupInfo& grp_info, FecSize win_idx);
+
+    /// \brief Compute the number of FEC source packets to be covered by each
+    /// sliding window FEC encoded data packet.
+    ///
+    /// \param  num_src  The number of FEC source packets in the group.
+    /// \param  num_enc  The number of FEC encoded packets in the group.
+    ///
+    /// \return  The sliding window size in packets.
+    FecSize ComputeFecWindowSize(FecSize num_src, FecSize num_enc);
+
     /// \brief Get the current FEC group round number for a packet
     /// retransmission.
     ///
@@ -1288,6 +1448,9 @@ namespace sliq
     /// The previously reported largest observed connection sequence number.
     PktSeqNumber       last_lo_conn_seq_;
 
+    /// The ACK headers waiting for CompleteAckProcessing().
+    AckBatchInfo       ack_batch_;
+
     /// The packet statistics for the stream.
     PktCounts          stats_pkts_;
 
@@ -1376,10 +1539,23 @@ namespace sliq
     /// The array of congestion control unacknowledged packet information.
     CcUnaPktInfo       cc_una_pkt_[SliqApp::kMaxCcAlgPerConn];
 
+    /// The array of flags recording if a packet sent using each congestion
+    /// control algorithm has been ACKed.
+    bool               cc_acked_[SliqApp::kMaxCcAlgPerConn];
+
+    /// The array of the largest ACKed congestion control sequence numbers
+    /// for each congestion control algorithm.  Used for detecting losses
+    /// on each path of a multipath connection.
+    PktSeqNumber       cc_lrg_acked_seq_[SliqApp::kMaxCcAlgPerConn];
+
     /// The circular array of sent packet information, with elements from
     /// snd_una_ up to (but not including) snd_nxt_.
     SentPktInfo*       sent_pkts_;
 
+    /// The bitmap of ACKed packets, mirroring the ACKed flag in sent_pkts_.
+    /// Used to skip over runs of ACKed packets a word at a time.
+    SeqNumBitmap       acked_bits_;
+
   }; // end class SentPktManager
 
 } // end namespace sliq
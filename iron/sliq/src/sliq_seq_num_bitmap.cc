@@ -0,0 +1,246 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "sliq_seq_num_bitmap.h"
+
+#include "sliq_private_defs.h"
+
+#include "log.h"
+#include "unused.h"
+
+#include <cstring>
+#include <inttypes.h>
+
+using ::sliq::PktSeqNumber;
+using ::sliq::SeqNumBitmap;
+using ::sliq::WindowSize;
+
+
+namespace
+{
+  /// Class name for logging.
+  const char*  UNUSED(kClassName) = "SeqNumBitmap";
+}
+
+
+//============================================================================
+SeqNumBitmap::SeqNumBitmap()
+    : mask_(0), words_(NULL)
+{
+}
+
+//============================================================================
+SeqNumBitmap::~SeqNumBitmap()
+{
+  if (words_ != NULL)
+  {
+    delete [] words_;
+    words_ = NULL;
+  }
+}
+
+//============================================================================
+bool SeqNumBitmap::Initialize(WindowSize size)
+{
+  // Prevent multiple initializations.
+  if (words_ != NULL)
+  {
+    LogE(kClassName, __func__, "Error, already initialized.\n");
+    return false;
+  }
+
+  // The size must be a power of two that fills at least one word.
+  if ((size < kBitsPerWord) || ((size & (size - 1)) != 0))
+  {
+    LogE(kClassName, __func__, "Error, invalid size %" PRIWindowSize ".\n",
+         size);
+    return false;
+  }
+
+  size_t  num_words = (size >> kWordShift);
+
+  words_ = new (std::nothrow) uint64_t[num_words];
+
+  if (words_ == NULL)
+  {
+    LogE(kClassName, __func__, "Error allocating bitmap array.\n");
+    return false;
+  }
+
+  memset(words_, 0, (num_words * sizeof(uint64_t)));
+
+  mask_ = (size - 1);
+
+  return true;
+}
+
+//============================================================================
+void SeqNumBitmap::ClearRange(PktSeqNumber lo_seq_num,
+                              PktSeqNumber hi_seq_num)
+{
+  if ((words_ == NULL) || SEQ_GT(lo_seq_num, hi_seq_num))
+  {
+    return;
+  }
+
+  PktSeqNumber  seq_num = lo_seq_num;
+  size_t        rem     = RangeLength(lo_seq_num, hi_seq_num);
+
+  while (rem > 0)
+  {
+    size_t  idx = (seq_num & mask_);
+    size_t  bit = (idx & kBitMask);
+    size_t  cnt = (kBitsPerWord - bit);
+
+    if (cnt > rem)
+    {
+      cnt = rem;
+    }
+
+    uint64_t  bits = ((cnt == kBitsPerWord) ? ~UINT64_C(0) :
+                      ((UINT64_C(1) << cnt) - 1));
+
+    words_[idx >> kWordShift] &= ~(bits << bit);
+
+    seq_num += static_cast<PktSeqNumber>(cnt);
+    rem     -= cnt;
+  }
+}
+
+//============================================================================
+bool SeqNumBitmap::FindNextClear(PktSeqNumber lo_seq_num,
+                                 PktSeqNumber hi_seq_num,
+                                 PktSeqNumber& seq_num) const
+{
+  if ((words_ == NULL) || SEQ_GT(lo_seq_num, hi_seq_num))
+  {
+    return false;
+  }
+
+  PktSeqNumber  sn  = lo_seq_num;
+  size_t        rem = RangeLength(lo_seq_num, hi_seq_num);
+
+  while (rem > 0)
+  {
+    size_t  idx = (sn & mask_);
+    size_t  bit = (idx & kBitMask);
+    size_t  cnt = (kBitsPerWord - bit);
+
+    if (cnt > rem)
+    {
+      cnt = rem;
+    }
+
+    // Invert the word so that clear bits become set bits, shift the bit for
+    // sn down to bit 0, and ignore any bits beyond the end of the range.
+    uint64_t  bits = (~words_[idx >> kWordShift] >> bit);
+
+    if (cnt < kBitsPerWord)
+    {
+      bits &= ((UINT64_C(1) << cnt) - 1);
+    }
+
+    if (bits != 0)
+    {
+      seq_num = (sn + static_cast<PktSeqNumber>(__builtin_ctzll(bits)));
+      return true;
+    }
+
+    sn  += static_cast<PktSeqNumber>(cnt);
+    rem -= cnt;
+  }
+
+  return false;
+}
+
+//============================================================================
+bool SeqNumBitmap::FindPrevClear(PktSeqNumber lo_seq_num,
+                                 PktSeqNumber hi_seq_num,
+                                 PktSeqNumber& seq_num) const
+{
+  if ((words_ == NULL) || SEQ_GT(lo_seq_num, hi_seq_num))
+  {
+    return false;
+  }
+
+  PktSeqNumber  sn  = hi_seq_num;
+  size_t        rem = RangeLength(lo_seq_num, hi_seq_num);
+
+  while (rem > 0)
+  {
+    size_t  idx = (sn & mask_);
+    size_t  bit = (idx & kBitMask);
+    size_t  cnt = (bit + 1);
+
+    if (cnt > rem)
+    {
+      cnt = rem;
+    }
+
+    // Invert the word so that clear bits become set bits, shift the bit for
+    // sn up to bit 63, and ignore any bits before the start of the range.
+    uint64_t  bits = (~words_[idx >> kWordShift] << (kBitMask - bit));
+
+    if (cnt < kBitsPerWord)
+    {
+      bits &= ~((UINT64_C(1) << (kBitsPerWord - cnt)) - 1);
+    }
+
+    if (bits != 0)
+    {
+      seq_num = (sn - static_cast<PktSeqNumber>(__builtin_clzll(bits)));
+      return true;
+    }
+
+    sn  -= static_cast<PktSeqNumber>(cnt);
+    rem -= cnt;
+  }
+
+  return false;
+}
+
+//============================================================================
+size_t SeqNumBitmap::RangeLength(PktSeqNumber lo_seq_num,
+                                 PktSeqNumber hi_seq_num) const
+{
+  // A range longer than the bitmap wraps onto itself, so a single pass over
+  // the bitmap is sufficient.
+  size_t  len  = (static_cast<size_t>(hi_seq_num - lo_seq_num) + 1);
+  size_t  size = (static_cast<size_t>(mask_) + 1);
+
+  return ((len > size) ? size : len);
+}
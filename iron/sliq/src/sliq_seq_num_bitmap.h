@@ -0,0 +1,182 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#ifndef IRON_SLIQ_SEQ_NUM_BITMAP_H
+#define IRON_SLIQ_SEQ_NUM_BITMAP_H
+
+#include "sliq_private_types.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+namespace sliq
+{
+
+  /// \brief A word-packed bitmap indexed by packet sequence number.
+  ///
+  /// The bitmap mirrors a circular array of per-packet information that is
+  /// indexed by (sequence number % size), and stores one bit per element.
+  /// Runs of set or clear bits are located using count leading/trailing
+  /// zero instructions on 64-bit words instead of visiting each element,
+  /// and ranges are cleared a word at a time.
+  ///
+  /// The size must be a power of two that is at least 64, so that the
+  /// sequence number to bit mapping is preserved across sequence number
+  /// wrap-around.
+  class SeqNumBitmap
+  {
+
+   public:
+
+    /// \brief Constructor.
+    SeqNumBitmap();
+
+    /// \brief Destructor.
+    virtual ~SeqNumBitmap();
+
+    /// \brief Initialize the bitmap.  All of the bits are cleared.
+    ///
+    /// \param  size  The number of bits in the bitmap.  Must be a power of
+    ///               two that is at least 64.
+    ///
+    /// \return  True on success, or false otherwise.
+    bool Initialize(WindowSize size);
+
+    /// \brief Set the bit for a sequence number.
+    ///
+    /// \param  seq_num  The sequence number.
+    inline void Set(PktSeqNumber seq_num)
+    {
+      size_t  idx = (seq_num & mask_);
+
+      words_[idx >> kWordShift] |= (UINT64_C(1) << (idx & kBitMask));
+    }
+
+    /// \brief Clear the bit for a sequence number.
+    ///
+    /// \param  seq_num  The sequence number.
+    inline void Clear(PktSeqNumber seq_num)
+    {
+      size_t  idx = (seq_num & mask_);
+
+      words_[idx >> kWordShift] &= ~(UINT64_C(1) << (idx & kBitMask));
+    }
+
+    /// \brief Test the bit for a sequence number.
+    ///
+    /// \param  seq_num  The sequence number.
+    ///
+    /// \return  True if the bit is set, or false otherwise.
+    inline bool IsSet(PktSeqNumber seq_num) const
+    {
+      size_t  idx = (seq_num & mask_);
+
+      return ((words_[idx >> kWordShift] &
+               (UINT64_C(1) << (idx & kBitMask))) != 0);
+    }
+
+    /// \brief Clear the bits for an inclusive range of sequence numbers.
+    ///
+    /// \param  lo_seq_num  The lowest sequence number in the range.
+    /// \param  hi_seq_num  The highest sequence number in the range.
+    void ClearRange(PktSeqNumber lo_seq_num, PktSeqNumber hi_seq_num);
+
+    /// \brief Find the lowest sequence number in an inclusive range whose
+    /// bit is clear.
+    ///
+    /// \param  lo_seq_num  The lowest sequence number in the range.
+    /// \param  hi_seq_num  The highest sequence number in the range.
+    /// \param  seq_num     A reference to where the sequence number found is
+    ///                     placed on success.
+    ///
+    /// \return  True if a clear bit was found, or false if every bit in the
+    ///          range is set or the range is empty.
+    bool FindNextClear(PktSeqNumber lo_seq_num, PktSeqNumber hi_seq_num,
+                       PktSeqNumber& seq_num) const;
+
+    /// \brief Find the highest sequence number in an inclusive range whose
+    /// bit is clear.
+    ///
+    /// \param  lo_seq_num  The lowest sequence number in the range.
+    /// \param  hi_seq_num  The highest sequence number in the range.
+    /// \param  seq_num     A reference to where the sequence number found is
+    ///                     placed on success.
+    ///
+    /// \return  True if a clear bit was found, or false if every bit in the
+    ///          range is set or the range is empty.
+    bool FindPrevClear(PktSeqNumber lo_seq_num, PktSeqNumber hi_seq_num,
+                       PktSeqNumber& seq_num) const;
+
+   private:
+
+    /// Copy constructor.
+    SeqNumBitmap(const SeqNumBitmap& other);
+
+    /// Copy operator.
+    SeqNumBitmap& operator=(const SeqNumBitmap& other);
+
+    /// \brief Get the number of bits to visit for an inclusive range of
+    /// sequence numbers.
+    ///
+    /// \param  lo_seq_num  The lowest sequence number in the range.
+    /// \param  hi_seq_num  The highest sequence number in the range.
+    ///
+    /// \return  The range length, limited to the size of the bitmap.
+    size_t RangeLength(PktSeqNumber lo_seq_num,
+                       PktSeqNumber hi_seq_num) const;
+
+    /// The number of bits in each word.
+    static const size_t  kBitsPerWord = 64;
+
+    /// The shift converting a bit index into a word index.
+    static const size_t  kWordShift   = 6;
+
+    /// The mask converting a bit index into a bit offset within a word.
+    static const size_t  kBitMask     = (kBitsPerWord - 1);
+
+    /// The mask converting a sequence number into a bit index.
+    PktSeqNumber  mask_;
+
+    /// The array of words.
+    uint64_t*     words_;
+
+  }; // end class SeqNumBitmap
+
+} // namespace sliq
+
+#endif // IRON_SLIQ_SEQ_NUM_BITMAP_H
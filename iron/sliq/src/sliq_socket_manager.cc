@@ -43,8 +43,11 @@
 
 #include <cerrno>
 #include <cstring>
+#include <ctime>
 #include <unistd.h>
 
+#include <linux/net_tstamp.h>
+
 using ::sliq::SocketId;
 using ::sliq::SocketManager;
 using ::sliq::WriteResult;
@@ -54,17 +57,24 @@ using ::iron::Log;
 using ::iron::Ipv4Endpoint;
 using ::iron::Packet;
 using ::iron::PacketSet;
+using ::iron::Time;
 
 
 namespace
 {
   const char*  UNUSED(kClassName) = "SocketManager";
+
+  /// The size of the control message buffer used for SCM_TXTIME, in bytes.
+  const size_t    kTxTimeCmsgBufSize = 64;
+
+  /// The number of nanoseconds in a second.
+  const uint64_t  kNsecPerSec        = 1000000000ULL;
 }
 
 
 //============================================================================
 SocketManager::SocketManager()
-    : valid_socket_mask_(), socket_list_(NULL), sockets_(NULL)
+    : valid_socket_mask_(), socket_list_(NULL), sockets_(NULL), stats_()
 {
   FD_ZERO(&valid_socket_mask_);
 }
@@ -267,6 +277,40 @@ bool SocketManager::EnablePortReuse(SocketId socket_id)
   return true;
 }
 
+//============================================================================
+bool SocketManager::EnableTxTime(SocketId socket_id)
+{
+  if (!FD_ISSET(socket_id, &valid_socket_mask_))
+  {
+    LogE(kClassName, __func__, "Invalid socket id %" PRISocketId ".\n",
+         socket_id);
+    return false;
+  }
+
+#ifdef SO_TXTIME
+  // The fq queueing discipline requires departure times in CLOCK_MONOTONIC.
+  struct sock_txtime  txtime_cfg;
+
+  memset(&txtime_cfg, 0, sizeof(txtime_cfg));
+  txtime_cfg.clockid = CLOCK_MONOTONIC;
+  txtime_cfg.flags   = 0;
+
+  if (setsockopt(socket_id, SOL_SOCKET, SO_TXTIME, &txtime_cfg,
+                 sizeof(txtime_cfg)) < 0)
+  {
+    LogW(kClassName, __func__, "Failed to enable transmit times on socket "
+         "id %" PRISocketId ": %s\n", socket_id, strerror(errno));
+    return false;
+  }
+
+  return true;
+#else
+  LogW(kClassName, __func__, "Transmit times are not supported on socket "
+       "id %" PRISocketId ".\n", socket_id);
+  return false;
+#endif // SO_TXTIME
+}
+
 //============================================================================
 bool SocketManager::Bind(SocketId socket_id, const Ipv4Endpoint& endpoint)
 {
@@ -434,6 +478,8 @@ int SocketManager::ReadPackets(SocketId socket_id, PacketSet& packet_set)
   int  packets_read = recvmmsg(socket_id, packet_set.GetVecPtr(),
                                packet_set.GetVecLen(), MSG_DONTWAIT, NULL);
 
+  ++stats_.read_calls;
+
   if (packets_read <= 0)
   {
     // Do not log connection refused errors.  These are caused by the peer's
@@ -450,13 +496,15 @@ int SocketManager::ReadPackets(SocketId socket_id, PacketSet& packet_set)
 
   packet_set.FinalizeRecvMmsg(packets_read, true);
 
+  stats_.read_pkts += static_cast<size_t>(packets_read);
+
   return packets_read;
 }
 
 //============================================================================
 WriteResult SocketManager::WritePacket(
   SocketId socket_id, Packet& packet,
-  const Ipv4Endpoint& peer_address)
+  const Ipv4Endpoint& peer_address, const Time& depart_delay)
 {
   if (!FD_ISSET(socket_id, &valid_socket_mask_))
   {
@@ -486,11 +534,23 @@ WriteResult SocketManager::WritePacket(
   hdr.msg_controllen  = 0;
   hdr.msg_flags       = 0;
 
+  // Stamp the packet with its departure time if it is being sent early.
+  char  cbuf[kTxTimeCmsgBufSize];
+
+  if (!depart_delay.IsZero())
+  {
+    AddTxTime(depart_delay, hdr, cbuf, sizeof(cbuf));
+  }
+
   // Send the packet.
   int  rc = sendmsg(socket_id, &hdr, 0);
 
+  ++stats_.write_calls;
+
   if (rc >= 0)
   {
+    ++stats_.write_pkts;
+
     if (static_cast<size_t>(rc) != iov.iov_len)
     {
       return WriteResult(WRITE_STATUS_ERROR, EIO);
@@ -506,7 +566,7 @@ WriteResult SocketManager::WritePacket(
 //============================================================================
 WriteResult SocketManager::WritePacket(
   SocketId socket_id, Packet& header, Packet& data,
-  const Ipv4Endpoint& peer_address)
+  const Ipv4Endpoint& peer_address, const Time& depart_delay)
 {
   if (!FD_ISSET(socket_id, &valid_socket_mask_))
   {
@@ -540,11 +600,23 @@ WriteResult SocketManager::WritePacket(
   hdr.msg_controllen  = 0;
   hdr.msg_flags       = 0;
 
+  // Stamp the packet with its departure time if it is being sent early.
+  char  cbuf[kTxTimeCmsgBufSize];
+
+  if (!depart_delay.IsZero())
+  {
+    AddTxTime(depart_delay, hdr, cbuf, sizeof(cbuf));
+  }
+
   // Send the packet.
   int  rc = sendmsg(socket_id, &hdr, 0);
 
+  ++stats_.write_calls;
+
   if (rc >= 0)
   {
+    ++stats_.write_pkts;
+
     if (static_cast<size_t>(rc) != (iov[0].iov_len + iov[1].iov_len))
     {
       return WriteResult(WRITE_STATUS_ERROR, EIO);
@@ -617,3 +689,40 @@ bool SocketManager::Close(SocketId socket_id)
 
   return false;
 }
+
+//============================================================================
+void SocketManager::AddTxTime(const Time& depart_delay, struct msghdr& hdr,
+                              char* cbuf, size_t cbuf_len)
+{
+#ifdef SCM_TXTIME
+  struct timespec  mono_now;
+
+  if (clock_gettime(CLOCK_MONOTONIC, &mono_now) != 0)
+  {
+    return;
+  }
+
+  uint64_t  txtime_ns = ((static_cast<uint64_t>(mono_now.tv_sec) *
+                          kNsecPerSec) +
+                         static_cast<uint64_t>(mono_now.tv_nsec) +
+                         (static_cast<uint64_t>(
+                           depart_delay.GetTimeInUsec()) * 1000));
+
+  if (cbuf_len < CMSG_SPACE(sizeof(txtime_ns)))
+  {
+    return;
+  }
+
+  memset(cbuf, 0, cbuf_len);
+
+  hdr.msg_control    = cbuf;
+  hdr.msg_controllen = CMSG_SPACE(sizeof(txtime_ns));
+
+  struct cmsghdr*  cmsg = CMSG_FIRSTHDR(&hdr);
+
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type  = SCM_TXTIME;
+  cmsg->cmsg_len   = CMSG_LEN(sizeof(txtime_ns));
+  memcpy(CMSG_DATA(cmsg), &txtime_ns, sizeof(txtime_ns));
+#endif // SCM_TXTIME
+}
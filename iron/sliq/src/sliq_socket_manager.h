@@ -44,10 +44,12 @@
 
 #include "fd_event.h"
 #include "ipv4_endpoint.h"
+#include "itime.h"
 #include "packet.h"
 #include "packet_set.h"
 
 #include <sys/select.h>
+#include <sys/socket.h>
 
 
 namespace sliq
@@ -145,6 +147,18 @@ namespace sliq
     /// \return  True if the change succeeds, false otherwise.
     bool EnablePortReuse(SocketId socket_id);
 
+    /// Enable earliest departure time transmissions on a socket.
+    ///
+    /// Once enabled, packets written with a non-zero departure delay are
+    /// stamped with their departure time using SCM_TXTIME, and are held by
+    /// the kernel (e.g., by the fq queueing discipline) until that time.
+    ///
+    /// \param  socket_id  The socket identifier.
+    ///
+    /// \return  True if the change succeeds, false if the socket option is
+    ///          not supported.
+    bool EnableTxTime(SocketId socket_id);
+
     /// Bind a socket to a local address and port.
     ///
     /// \param  socket_id  The socket identifier.
@@ -202,12 +216,17 @@ namespace sliq
     /// \param  socket_id     The socket identifier.
     /// \param  packet        The packet to be written to the socket.
     /// \param  peer_address  The destination address of the packet.
+    /// \param  depart_delay  The amount of time from now until the packet
+    ///                       should depart.  Only used if EnableTxTime() has
+    ///                       been called on the socket.  Zero sends the
+    ///                       packet immediately.
     ///
     /// \return  Structure containing the result of the operation.  This
     ///          includes a status and the number of bytes written or an error
     ///          code.
     WriteResult WritePacket(SocketId socket_id, iron::Packet& packet,
-                            const iron::Ipv4Endpoint& peer_address);
+                            const iron::Ipv4Endpoint& peer_address,
+                            const iron::Time& depart_delay = iron::Time());
 
     /// Write a packet, consisting of a header and data, to a socket.
     ///
@@ -215,13 +234,18 @@ namespace sliq
     /// \param  header        The packet header to be written to the socket.
     /// \param  data          The packet data to be written to the socket.
     /// \param  peer_address  The destination address of the packet.
+    /// \param  depart_delay  The amount of time from now until the packet
+    ///                       should depart.  Only used if EnableTxTime() has
+    ///                       been called on the socket.  Zero sends the
+    ///                       packet immediately.
     ///
     /// \return  Structure containing the result of the operation.  This
     ///          includes a status and the number of bytes written or an error
     ///          code.
     WriteResult WritePacket(SocketId socket_id, iron::Packet& header,
                             iron::Packet& data,
-                            const iron::Ipv4Endpoint& peer_address);
+                            const iron::Ipv4Endpoint& peer_address,
+                            const iron::Time& depart_delay = iron::Time());
 
     /// Close a socket.
     ///
@@ -230,6 +254,14 @@ namespace sliq
     /// \return  True if the socket is closed, false otherwise.
     bool Close(SocketId socket_id);
 
+    /// Get the system call statistics for all of the sockets.
+    ///
+    /// \param  stats  A reference to where the statistics are returned.
+    inline void GetStats(SocketStats& stats) const
+    {
+      stats = stats_;
+    }
+
    private:
 
     /// Copy constructor.
@@ -238,6 +270,18 @@ namespace sliq
     /// Copy operator.
     SocketManager& operator=(const SocketManager& sm);
 
+    /// Add an SCM_TXTIME control message carrying a packet departure time to
+    /// a message header.
+    ///
+    /// \param  depart_delay  The amount of time from now until the packet
+    ///                       should depart.
+    /// \param  hdr           The message header to be updated.
+    /// \param  cbuf          The control message buffer to use.
+    /// \param  cbuf_len      The size of the control message buffer in
+    ///                       bytes.
+    static void AddTxTime(const iron::Time& depart_delay,
+                          struct msghdr& hdr, char* cbuf, size_t cbuf_len);
+
     /// \brief A structure for socket information.
     struct SockInfo
     {
@@ -258,17 +302,20 @@ namespace sliq
 
     /// Valid socket mask.  This supports file descriptor numbers less than
     /// FD_SETSIZE.
-    fd_set      valid_socket_mask_;
+    fd_set       valid_socket_mask_;
 
     /// The collection of socket information in a doubly-linked list.  This
     /// is the pointer to the head of the list, and the list owns the SockInfo
     /// objects.
-    SockInfo*   socket_list_;
+    SockInfo*    socket_list_;
 
     /// An array of pointers to socket information indexed by the file
     /// descriptor number.  This supports file descriptor numbers less than
     /// FD_SETSIZE.
-    SockInfo**  sockets_;
+    SockInfo**   sockets_;
+
+    /// The system call statistics for all of the sockets.
+    SocketStats  stats_;
 
   }; // end class SocketManger
 
@@ -1186,8 +1186,7 @@ bool Stream::IsGoodAckPacket(AckHeader& hdr)
 
 //============================================================================
 bool Stream::ProcessAck(AckHeader& hdr, const Time& rcv_time, const Time& now,
-                        bool leaving_outage, bool& new_data_acked,
-                        bool& all_data_acked, PktSeqNumber& lo_conn_seq)
+                        PktSeqNumber& lo_conn_seq)
 {
 #ifdef SLIQ_DEBUG
   LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
@@ -1195,15 +1194,26 @@ bool Stream::ProcessAck(AckHeader& hdr, const Time& rcv_time, const Time& now,
 #endif
 
   // Process the ACK packet.
+  bool  new_data_acked = false;
+
   if (!sent_pkt_mgr_.ProcessAck(hdr, rcv_time, now, new_data_acked,
                                 lo_conn_seq))
   {
     LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
          ": Error processing received ACK packet.\n", conn_id_, stream_id_);
-    all_data_acked = sent_pkt_mgr_.IsAllDataAcked();
     return false;
   }
 
+  return true;
+}
+
+//============================================================================
+void Stream::CompleteAckProcessing(const Time& now, bool& new_data_acked,
+                                   bool& all_data_acked)
+{
+  // Complete the processing of the ACK packets.
+  sent_pkt_mgr_.CompleteAckProcessing(now, new_data_acked);
+
   // Check if all of the data has been ACKed or not.
   all_data_acked = sent_pkt_mgr_.IsAllDataAcked();
 
@@ -1244,8 +1254,6 @@ bool Stream::ProcessAck(AckHeader& hdr, const Time& rcv_time, const Time& now,
   {
     timer_.CancelTimer(persist_timer_);
   }
-
-  return true;
 }
 
 //============================================================================
@@ -1463,7 +1471,7 @@ bool Stream::SendPersist(const Time& now, CcId cc_id)
 }
 
 //============================================================================
-void Stream::ForceUnackedPacketsLost(const Time& now)
+void Stream::ForceUnackedPacketsLost(const Time& now, int cc_id)
 {
 #ifdef SLIQ_DEBUG
   LogD(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
@@ -1472,7 +1480,7 @@ void Stream::ForceUnackedPacketsLost(const Time& now)
 #endif
 
   // Force any unACKed packets to be considered lost.
-  if (!sent_pkt_mgr_.ForceUnackedPacketsLost(now))
+  if (!sent_pkt_mgr_.ForceUnackedPacketsLost(now, cc_id))
   {
     LogE(kClassName, __func__, "Conn %" PRIEndptId " Stream %" PRIStreamId
          ": Error forcing all unACKed packets to be considered lost.\n",
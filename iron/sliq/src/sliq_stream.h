@@ -223,25 +223,33 @@ namespace sliq
 
     /// \brief Process a received ACK header.
     ///
-    /// \param  hdr             A reference to the received ACK header.
-    /// \param  rcv_time        The ACK receive time.
-    /// \param  now             The current time.
-    /// \param  leaving_outage  Indicates if an outage is being exited due to
-    ///                         the reception of this ACK packet.
-    /// \param  new_data_acked  A reference to a flag that is set to true if
-    ///                         the ACK packet ACKed new data.
-    /// \param  all_data_acked  A reference to a flag that is set to true if
-    ///                         all of the stream's data is ACKed.
-    /// \param  lo_conn_seq     A reference to the largest observed
-    ///                         connection sequence number which is returned
-    ///                         on success.
+    /// CompleteAckProcessing() must be called after one or more ACK headers
+    /// have been processed.
+    ///
+    /// \param  hdr          A reference to the received ACK header.
+    /// \param  rcv_time     The ACK receive time.
+    /// \param  now          The current time.
+    /// \param  lo_conn_seq  A reference to the largest observed connection
+    ///                      sequence number which is returned on success.
     ///
     /// \return  True if the ACK header processing was successful, false
     ///          otherwise.
     bool ProcessAck(AckHeader& hdr, const iron::Time& rcv_time,
-                    const iron::Time& now, bool leaving_outage,
-                    bool& new_data_acked, bool& all_data_acked,
-                    PktSeqNumber& lo_conn_seq);
+                    const iron::Time& now, PktSeqNumber& lo_conn_seq);
+
+    /// \brief Complete the processing of the received ACK headers.
+    ///
+    /// Performs loss detection and moves the send window forward once for
+    /// all of the ACK headers processed since the last call, then updates
+    /// the retransmission and persist timers.
+    ///
+    /// \param  now             The current time.
+    /// \param  new_data_acked  A reference to a flag that is set to true if
+    ///                         the ACK headers ACKed new data.
+    /// \param  all_data_acked  A reference to a flag that is set to true if
+    ///                         all of the stream's data is ACKed.
+    void CompleteAckProcessing(const iron::Time& now, bool& new_data_acked,
+                               bool& all_data_acked);
 
     /// \brief Process an implicit ACK.
     ///
@@ -316,8 +324,10 @@ namespace sliq
     /// \brief Force all of the unACKed packets in the stream to be considered
     /// lost.
     ///
-    /// \param  now  The current time.
-    void ForceUnackedPacketsLost(const iron::Time& now);
+    /// \param  now    The current time.
+    /// \param  cc_id  The congestion control identifier that the packets
+    ///                must have been sent with, or -1 for all packets.
+    void ForceUnackedPacketsLost(const iron::Time& now, int cc_id = -1);
 
     /// \brief Check if the stream detects a connection outage.
     ///
@@ -415,6 +425,31 @@ namespace sliq
       return rcvd_pkt_mgr_.IsDataMissing();
     }
 
+    /// \brief Get the number of bytes needed to send a data packet sequence
+    /// number in a compact data header.
+    ///
+    /// \param  seq_num  The data packet sequence number being sent.
+    ///
+    /// \return  The number of low-order bytes to send, from 1 to 4.
+    inline size_t GetCompactSeqNumLength(PktSeqNumber seq_num) const
+    {
+      return sent_pkt_mgr_.GetCompactSeqNumLength(seq_num);
+    }
+
+    /// \brief Expand a truncated data packet sequence number received in a
+    /// compact data header.
+    ///
+    /// \param  data_hdr  The received data header, which is updated with the
+    ///                   full data packet sequence number.
+    inline void ExpandCompactSeqNum(DataHeader& data_hdr) const
+    {
+      data_hdr.sequence_number =
+        Framer::ExpandSeqNum(data_hdr.sequence_number,
+                             data_hdr.seq_num_length,
+                             rcvd_pkt_mgr_.GetLargestObservedSeqNum());
+      data_hdr.seq_num_length  = sizeof(PktSeqNumber);
+    }
+
     /// \brief Check if the stream has any fast retransmit packets waiting to
     /// be sent.
     ///
@@ -497,6 +532,14 @@ namespace sliq
       return transmit_queue_.GetSizeInPackets();
     }
 
+    /// \brief Get the stream's packet transmission statistics.
+    ///
+    /// \param  stats  A reference to where the statistics are returned.
+    inline void GetSendStats(SendStats& stats) const
+    {
+      sent_pkt_mgr_.GetSendStats(stats);
+    }
+
   private:
 
     /// \brief Copy constructor.
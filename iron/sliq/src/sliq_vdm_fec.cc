@@ -133,6 +133,48 @@ static inline gf gf_mul(gf x, gf y)
   return gf_exp[modnn(gf_log[x] + gf_log[y])] ;
 }
 
+//============================================================================
+// gf_addmul(dst,src,size,c) adds c times the size byte long src buffer into
+// dst, treating a trailing odd byte as the low order byte of one more
+// element.
+static inline void gf_addmul(gf* dst, const uint8_t* src, int size, gf c)
+{
+  const gf*  s  = (const gf*)src;
+  int        sz = size >> 1;
+  int        item;
+
+  for (item = 0; item < sz; item++)
+  {
+    dst[item] ^= gf_mul(c, *s++);
+  }
+
+  if (size & 0x1)
+  {
+    uint16_t  tmp;
+
+#if (__BYTE_ORDER == __LITTLE_ENDIAN)
+    tmp = (uint16_t)(*(const uint8_t*)s);
+#else // (__BYTE_ORDER == __BIG_ENDIAN)
+    tmp = (uint16_t)((*(const uint8_t*)s) << 8);
+#endif
+
+    dst[item] ^= gf_mul(c, tmp);
+  }
+}
+
+//============================================================================
+// Integer hash used to derive the sliding window coefficients.  Any change
+// here breaks interoperability.
+static inline uint32_t coef_hash(uint32_t x)
+{
+  x ^= x >> 16;
+  x *= 0x7feb352dU;
+  x ^= x >> 15;
+  x *= 0x846ca68bU;
+  x ^= x >> 16;
+  return x;
+}
+
 //============================================================================
 // Generate GF(2**m) from the irreducible polynomial p(X) in p[0]..p[m].
 // Lookup tables:
@@ -515,3 +557,237 @@ int VdmFec::DecodePackets(int       num_src_pkt,      // n
 
   return 0;
 }
+
+//============================================================================
+void VdmFec::GetWindowCoefficients(uint16_t  grp_id,
+                                   int       grp_idx,
+                                   int       win_start,
+                                   int       win_end,
+                                   uint16_t* coef)
+{
+  for (int i = 0; i < P_KMAX; ++i)
+  {
+    if ((i < win_start) || (i >= win_end))
+    {
+      coef[i] = 0;
+      continue;
+    }
+
+    // Map the hash onto the NN non-zero field elements.
+    uint32_t  h = coef_hash((static_cast<uint32_t>(grp_id) << 16) |
+                            (static_cast<uint32_t>(grp_idx & 0xff) << 8) |
+                            static_cast<uint32_t>(i));
+
+    coef[i] = gf_exp[h % NN];
+  }
+}
+
+//============================================================================
+void VdmFec::GetBlockCoefficients(int       num_src_pkt,
+                                  int       enc_idx,
+                                  uint16_t* coef)
+{
+  for (int i = 0; i < P_KMAX; ++i)
+  {
+    coef[i] = ((i < num_src_pkt) ? gf_exp[modnn(i * enc_idx)] : 0);
+  }
+}
+
+//============================================================================
+void VdmFec::EncodeWindowPacket(int             num_src_pkt,
+                                uint8_t**       src_pkt_data,
+                                uint16_t*       src_pkt_size,
+                                const uint16_t* coef,
+                                uint8_t*        enc_pkt_data,
+                                uint16_t&       enc_pkt_size)
+{
+  int  i        = 0;
+  int  max_size = 0;
+
+  for (i = 0; i < num_src_pkt; i++)
+  {
+    if ((coef[i] != 0) && (src_pkt_size[i] > max_size))
+    {
+      max_size = src_pkt_size[i];
+    }
+  }
+
+  // Need to make sure we clear enough of the repair buffer by ensuring the
+  // length is an even number of bytes.
+  if (max_size & 0x1)
+  {
+    max_size++;
+  }
+
+  bzero(enc_pkt_data, max_size * sizeof(uint8_t));
+  enc_pkt_size = 0;
+
+  for (i = 0; i < num_src_pkt; i++)
+  {
+    if ((coef[i] == 0) || (src_pkt_data[i] == NULL))
+    {
+      continue;
+    }
+
+    gf_addmul((gf*)enc_pkt_data, src_pkt_data[i], src_pkt_size[i], coef[i]);
+    enc_pkt_size ^= gf_mul(coef[i], src_pkt_size[i]);
+  }
+}
+
+//============================================================================
+int VdmFec::DecodeWindowPackets(int       num_src_pkt,
+                                int       num_in_pkt,
+                                uint8_t** in_pkt_data,
+                                uint16_t* in_pkt_size,
+                                uint16_t* in_enc_pkt_size,
+                                uint16_t  (*in_coef)[MAX_FEC_RATE],
+                                uint8_t** out_pkt_data,
+                                uint16_t* out_pkt_size,
+                                uint32_t& solved_mask)
+{
+  gf   a[P_KMAX][P_KMAX];  // The coefficient rows being reduced.
+  gf   b[P_KMAX][P_KMAX];  // The row operations applied to the inputs.
+  int  piv_col[P_KMAX];
+  int  rank     = 0;
+  int  max_size = 0;
+  int  solved   = 0;
+  int  row      = 0;
+  int  col      = 0;
+  int  i        = 0;
+
+  solved_mask = 0;
+
+  if ((num_src_pkt <= 0) || (num_src_pkt > P_KMAX) || (num_in_pkt < 0) ||
+      (num_in_pkt > P_KMAX))
+  {
+    return -1;
+  }
+
+  for (row = 0; row < num_in_pkt; row++)
+  {
+    for (col = 0; col < P_KMAX; col++)
+    {
+      a[row][col] = ((col < num_src_pkt) ? in_coef[row][col] : 0);
+      b[row][col] = ((col == row) ? 1 : 0);
+    }
+
+    if (in_pkt_size[row] > max_size)
+    {
+      max_size = in_pkt_size[row];
+    }
+  }
+
+  if (max_size & 0x1)
+  {
+    max_size++;
+  }
+
+  // Reduce the coefficients to reduced row echelon form, tracking the row
+  // operations so that they can be applied to the packet data afterwards.
+  for (col = 0; (col < num_src_pkt) && (rank < num_in_pkt); col++)
+  {
+    for (row = rank; row < num_in_pkt; row++)
+    {
+      if (a[row][col] != 0)
+      {
+        break;
+      }
+    }
+
+    if (row == num_in_pkt)
+    {
+      continue;
+    }
+
+    if (row != rank)
+    {
+      for (i = 0; i < P_KMAX; i++)
+      {
+        gf  tmp     = a[row][i];
+        a[row][i]   = a[rank][i];
+        a[rank][i]  = tmp;
+        tmp         = b[row][i];
+        b[row][i]   = b[rank][i];
+        b[rank][i]  = tmp;
+      }
+    }
+
+    gf  inv = inverse[a[rank][col]];
+
+    if (inv != 1)
+    {
+      for (i = 0; i < P_KMAX; i++)
+      {
+        a[rank][i] = gf_mul(inv, a[rank][i]);
+        b[rank][i] = gf_mul(inv, b[rank][i]);
+      }
+    }
+
+    for (row = 0; row < num_in_pkt; row++)
+    {
+      gf  c = a[row][col];
+
+      if ((row == rank) || (c == 0))
+      {
+        continue;
+      }
+
+      for (i = 0; i < P_KMAX; i++)
+      {
+        a[row][i] ^= gf_mul(c, a[rank][i]);
+        b[row][i] ^= gf_mul(c, b[rank][i]);
+      }
+    }
+
+    piv_col[rank] = col;
+    rank++;
+  }
+
+  // A missing packet is determined when its pivot row has no other non-zero
+  // coefficients.
+  for (row = 0; row < rank; row++)
+  {
+    int  pc = piv_col[row];
+
+    if (out_pkt_data[pc] == NULL)
+    {
+      continue;
+    }
+
+    for (col = 0; col < num_src_pkt; col++)
+    {
+      if ((col != pc) && (a[row][col] != 0))
+      {
+        break;
+      }
+    }
+
+    if (col < num_src_pkt)
+    {
+      continue;
+    }
+
+    gf*  d = (gf*)out_pkt_data[pc];
+
+    bzero(d, max_size * sizeof(uint8_t));
+    out_pkt_size[pc] = 0;
+
+    for (i = 0; i < num_in_pkt; i++)
+    {
+      gf  x = b[row][i];
+
+      if (x == 0)
+      {
+        continue;
+      }
+
+      gf_addmul(d, in_pkt_data[i], in_pkt_size[i], x);
+      out_pkt_size[pc] ^= gf_mul(x, in_enc_pkt_size[i]);
+    }
+
+    solved_mask |= (static_cast<uint32_t>(1) << pc);
+    solved++;
+  }
+
+  return solved;
+}
@@ -195,6 +195,102 @@ namespace sliq
                              uint8_t** out_pkt_data,
                              uint16_t* out_pkt_size);
 
+    /// \brief Get the coefficients for a sliding window encoded data packet.
+    ///
+    /// Each source data packet within the window is given a non-zero
+    /// pseudo-random coefficient derived from the FEC group ID and the
+    /// encoded data packet's group index, so that the receiver can recreate
+    /// the coefficients from the data header alone.  All other coefficients
+    /// are set to zero.
+    ///
+    /// \param  grp_id     The FEC group ID.
+    /// \param  grp_idx    The encoded data packet's index within the FEC
+    ///                    group.
+    /// \param  win_start  The index of the first source data packet covered
+    ///                    by the window.
+    /// \param  win_end    One more than the index of the last source data
+    ///                    packet covered by the window.
+    /// \param  coef       The array of coefficients to be populated.  The
+    ///                    array size must be MAX_FEC_RATE.
+    static void GetWindowCoefficients(uint16_t  grp_id,
+                                      int       grp_idx,
+                                      int       win_start,
+                                      int       win_end,
+                                      uint16_t* coef);
+
+    /// \brief Get the coefficients used by EncodePackets() for one encoded
+    /// data packet.
+    ///
+    /// \param  num_src_pkt  The number of source data packets.
+    /// \param  enc_idx      The zero-based encoded data packet index (the
+    ///                      group index minus the number of source data
+    ///                      packets).
+    /// \param  coef         The array of coefficients to be populated.  The
+    ///                      array size must be MAX_FEC_RATE.
+    static void GetBlockCoefficients(int       num_src_pkt,
+                                     int       enc_idx,
+                                     uint16_t* coef);
+
+    /// \brief Generate one encoded data packet as a linear combination of
+    /// source data packets.
+    ///
+    /// \param  num_src_pkt   The number of source data packets.
+    /// \param  src_pkt_data  The array of source data packets.  Elements
+    ///                       with a zero coefficient may be NULL.
+    /// \param  src_pkt_size  The array of source data packet sizes in bytes.
+    /// \param  coef          The array of coefficients, one per source data
+    ///                       packet.
+    /// \param  enc_pkt_data  The encoded data packet buffer to populate.
+    /// \param  enc_pkt_size  The encoded packet length to populate.
+    static void EncodeWindowPacket(int             num_src_pkt,
+                                   uint8_t**       src_pkt_data,
+                                   uint16_t*       src_pkt_size,
+                                   const uint16_t* coef,
+                                   uint8_t*        enc_pkt_data,
+                                   uint16_t&       enc_pkt_size);
+
+    /// \brief Decode as many original packets (source data packets) as
+    /// possible from any mix of received source and encoded data packets.
+    ///
+    /// Unlike DecodePackets(), the number of received packets does not need
+    /// to match the number of source data packets.  Gaussian elimination is
+    /// performed on the coefficients, and each missing source data packet
+    /// whose value is fully determined is regenerated, even if the overall
+    /// system is not of full rank.
+    ///
+    /// \param  num_src_pkt      The number of source data packets (columns).
+    /// \param  num_in_pkt       The number of received data packets (rows).
+    ///                          Must not exceed MAX_FEC_RATE.
+    /// \param  in_pkt_data      The array of received data packets.
+    /// \param  in_pkt_size      The array of received data packet sizes in
+    ///                          bytes.
+    /// \param  in_enc_pkt_size  The array of received data packet encoded
+    ///                          sizes.  Use the actual packet sizes for
+    ///                          source data packets.
+    /// \param  in_coef          The coefficient rows for the received data
+    ///                          packets.  A received source data packet has
+    ///                          a single coefficient of one at its index.
+    /// \param  out_pkt_data     The array of output buffers, indexed by
+    ///                          source data packet index.  Only the missing
+    ///                          source data packets to be regenerated may be
+    ///                          non-NULL.
+    /// \param  out_pkt_size     The array of regenerated source data packet
+    ///                          lengths, indexed by source data packet index.
+    /// \param  solved_mask      Upon return, a bit is set for each source
+    ///                          data packet index that was regenerated.
+    ///
+    /// \return  Returns the number of source data packets regenerated, or a
+    ///          negative value on error.
+    static int DecodeWindowPackets(int       num_src_pkt,
+                                   int       num_in_pkt,
+                                   uint8_t** in_pkt_data,
+                                   uint16_t* in_pkt_size,
+                                   uint16_t* in_enc_pkt_size,
+                                   uint16_t  (*in_coef)[MAX_FEC_RATE],
+                                   uint8_t** out_pkt_data,
+                                   uint16_t* out_pkt_size,
+                                   uint32_t& solved_mask);
+
   }; // end class VdmFec
 
 } // namespace sliq
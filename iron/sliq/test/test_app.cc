@@ -221,7 +221,8 @@ private:
 
   void Usage(const char* prog_name);
   bool ParseCongCtrlConfig(const char* cc_config);
-  bool ParseDirectConnConfig(const char* dir_conn_config);
+  bool ParseDirectConnConfig(const char* dir_conn_config, string& local_addr,
+                             string& remote_addr);
   bool ParseStreamConfig(const char* stream_config);
   bool ParseLatencySensitiveStreamIds(const char* lss_config);
   bool ActAsServer(const Ipv4Endpoint& server_address);
@@ -238,8 +239,14 @@ private:
   bool             lat_sens_stream_[kMaxStreams];
   bool             limit_latency_;
   bool             outlier_rejection_;
+  bool             ack_decimation_;
+  bool             compact_hdrs_;
+  bool             fast_reconnect_;
   string           direct_local_addr_;
   string           direct_remote_addr_;
+  bool             direct_path_;
+  string           path_local_addr_;
+  string           path_remote_addr_;
   string           server_addr_;
   string           server_port_;
   size_t           num_cc_alg_;
@@ -769,8 +776,14 @@ TestApp::TestApp(PacketPool& packet_pool, Timer& timer)
       lat_sens_stream_(),
       limit_latency_(false),
       outlier_rejection_(false),
+      ack_decimation_(false),
+      compact_hdrs_(false),
+      fast_reconnect_(false),
       direct_local_addr_(),
       direct_remote_addr_(),
+      direct_path_(false),
+      path_local_addr_(),
+      path_remote_addr_(),
       server_addr_("0.0.0.0"),
       server_port_("22123"),
       num_cc_alg_(1),
@@ -842,7 +855,7 @@ bool TestApp::Init(int argc, char** argv)
   LogC(kName, __func__, "Command: %s\n", cmd.c_str());
 
   // Parse the command line arguments.
-  while ((c = getopt(argc, argv, "C:a:j:D:p:R:s:l:LOqvdh")) != -1)
+  while ((c = getopt(argc, argv, "C:a:j:D:P:p:R:s:l:LOAcFqvdh")) != -1)
   {
     switch (c)
     {
@@ -876,12 +889,25 @@ bool TestApp::Init(int argc, char** argv)
         break;
 
       case 'D':
-        if (!ParseDirectConnConfig(optarg))
+        if (!ParseDirectConnConfig(optarg, direct_local_addr_,
+                                   direct_remote_addr_))
         {
           LogE(kName, __func__, "Invalid direct connection addresses: %s\n",
                optarg);
           return false;
         }
+        direct_conn_ = true;
+        break;
+
+      case 'P':
+        if (!ParseDirectConnConfig(optarg, path_local_addr_,
+                                   path_remote_addr_))
+        {
+          LogE(kName, __func__, "Invalid direct connection path addresses: "
+               "%s\n", optarg);
+          return false;
+        }
+        direct_path_ = true;
         break;
 
       case 'p':
@@ -917,6 +943,18 @@ bool TestApp::Init(int argc, char** argv)
         outlier_rejection_ = true;
         break;
 
+      case 'A':
+        ack_decimation_ = true;
+        break;
+
+      case 'c':
+        compact_hdrs_ = true;
+        break;
+
+      case 'F':
+        fast_reconnect_ = true;
+        break;
+
       case 'q':
         Log::SetDefaultLevel("FEW");
         break;
@@ -935,6 +973,14 @@ bool TestApp::Init(int argc, char** argv)
     }
   }
 
+  // An added path requires a direct connection.
+  if (direct_path_ && (!direct_conn_))
+  {
+    LogE(kName, __func__, "A direct connection path requires a direct "
+         "connection.\n");
+    return false;
+  }
+
   // Get any server address specified.
   if ((argc - optind) > 1)
   {
@@ -985,6 +1031,20 @@ bool TestApp::Init(int argc, char** argv)
     return false;
   }
 
+  // Allow compact headers if requested.
+  if (compact_hdrs_ && (!ConfigureCompactHeaders(true)))
+  {
+    LogE(kName, __func__, "Error enabling compact headers.\n");
+    return false;
+  }
+
+  // Allow fast reconnection if requested.
+  if (fast_reconnect_ && (!ConfigureFastReconnect(true)))
+  {
+    LogE(kName, __func__, "Error enabling fast reconnection.\n");
+    return false;
+  }
+
   // Initialize the client or server side.
   if (is_server_)
   {
@@ -1318,6 +1378,16 @@ void TestApp::ProcessConnectionResult(EndptId endpt_id, bool success)
       }
     }
 
+    // Set the adaptive ACK frequency option if needed.
+    if (ack_decimation_)
+    {
+      if (!ConfigureAckFrequency(data_endpt_id_, true))
+      {
+        LogW(kName, __func__, "Unable to configure adaptive ACK "
+             "frequency.\n");
+      }
+    }
+
     // Create the necessary streams.
     if (is_server_)
     {
@@ -1800,7 +1870,7 @@ void TestApp::Usage(const char* prog_name)
   fprintf(stderr, "Options:\n");
   fprintf(stderr, "  -C <cc>    The congestion control types to use (cubic, "
           "copa1m, detcopa1m,\n             copa1_<delta>, detcopa1_<delta>, "
-          "copa2, copa, gubic,\n             gubicpacing, reno, "
+          "copa2, copa, bbr,\n             gubic, gubicpacing, reno, "
           "renopacing, fixedrate_<bps>, none)\n             (default "
           "copa).\n");
   fprintf(stderr, "  -a <flws>  The congestion control aggressiveness in "
@@ -1809,6 +1879,9 @@ void TestApp::Usage(const char* prog_name)
           "setting in seconds\n             (default 0.0).\n");
   fprintf(stderr, "  -D <addr>  Direct connect using local,remote "
           "addresses.\n");
+  fprintf(stderr, "  -P <addr>  Add a direct connection path using "
+          "local,remote addresses.\n             Requires -D, and one "
+          "congestion control algorithm per\n             path.\n");
   fprintf(stderr, "  -p <port>  The server port number (default 22123).\n");
   fprintf(stderr, "  -R <msec>  Enable 28 second rate change pattern using "
           "wait time in msec.\n");
@@ -1819,6 +1892,9 @@ void TestApp::Usage(const char* prog_name)
   fprintf(stderr, "  -L         Do not include start/end packets in latency "
           "measurements.\n");
   fprintf(stderr, "  -O         Enable RTT outlier rejection.\n");
+  fprintf(stderr, "  -A         Enable adaptive ACK frequency.\n");
+  fprintf(stderr, "  -c         Enable compact headers.\n");
+  fprintf(stderr, "  -F         Enable fast reconnection.\n");
   fprintf(stderr, "  -q         Turn off logging.\n");
   fprintf(stderr, "  -v         Turn on verbose logging.\n");
   fprintf(stderr, "  -d         Turn on debug logging.\n");
@@ -1838,7 +1914,7 @@ void TestApp::Usage(const char* prog_name)
           "3).\n");
   fprintf(stderr, "  rel       The reliability mode (beffort, rel_arq, "
           "srel_arq[rx_lim],\n            srel_arqfec[rx_lim,del_lim,"
-          "tgt_rcv_prob]) (default rel_arq).\n");
+          "tgt_rcv_prob[,sw]]) (default rel_arq).\n");
   fprintf(stderr, "  del       The delivery mode (ord, unord) (default "
           "ord).\n");
   fprintf(stderr, "  q_size    The transmit queue size in packets (default "
@@ -1930,6 +2006,10 @@ bool TestApp::ParseCongCtrlConfig(const char* cc_config)
     {
       cc_algorithm_[i].SetCopa();
     }
+    else if (tok == "bbr")
+    {
+      cc_algorithm_[i].SetBbr();
+    }
     else if (tok == "gubicpacing")
     {
       cc_algorithm_[i].SetGoogleTcpCubic(true);
@@ -1979,7 +2059,8 @@ bool TestApp::ParseCongCtrlConfig(const char* cc_config)
 }
 
 //============================================================================
-bool TestApp::ParseDirectConnConfig(const char* dir_conn_config)
+bool TestApp::ParseDirectConnConfig(const char* dir_conn_config,
+                                    string& local_addr, string& remote_addr)
 {
   // Tokenize the direct connection address string, which should contain two
   // IP addresses separated by ','.
@@ -1996,19 +2077,16 @@ bool TestApp::ParseDirectConnConfig(const char* dir_conn_config)
   }
 
   // Store the IP addresses.
-  if (!tokens.Pop(direct_local_addr_))
+  if (!tokens.Pop(local_addr))
   {
     return false;
   }
 
-  if (!tokens.Pop(direct_remote_addr_))
+  if (!tokens.Pop(remote_addr))
   {
     return false;
   }
 
-  // Use a direct connection.
-  direct_conn_ = true;
-
   return true;
 }
 
@@ -2218,7 +2296,7 @@ bool TestApp::ParseStreamConfig(const char* stream_config)
       string        mix_str = tok.substr(12, (tok.size() - 13));
       List<string>  mix_val;
       StringUtils::Tokenize(mix_str, ",", mix_val);
-      if (mix_val.size() != 3)
+      if ((mix_val.size() != 3) && (mix_val.size() != 4))
       {
         LogE(kName, __func__, "Invalid semi-reliable ARQ/FEC format: %s\n",
              mix_str.c_str());
@@ -2283,13 +2361,25 @@ bool TestApp::ParseStreamConfig(const char* stream_config)
              "probability: %s\n", tok.c_str());
         return false;
       }
+      bool  sliding_win = false;
+      if (mix_val.Pop(tok))
+      {
+        if (tok != "sw")
+        {
+          LogE(kName, __func__, "Invalid semi-reliable ARQ/FEC FEC mode: "
+               "%s\n", tok.c_str());
+          return false;
+        }
+        sliding_win = true;
+      }
       if (use_rounds)
       {
-        rel.SetSemiRelArqFecUsingRounds(limit, rcv_p, tgt_rounds);
+        rel.SetSemiRelArqFecUsingRounds(limit, rcv_p, tgt_rounds,
+                                        sliding_win);
       }
       else
       {
-        rel.SetSemiRelArqFecUsingTime(limit, rcv_p, tgt_time);
+        rel.SetSemiRelArqFecUsingTime(limit, rcv_p, tgt_time, sliding_win);
       }
     }
     else if (tok == "beffort")
@@ -2499,6 +2589,19 @@ bool TestApp::ActAsServer(const Ipv4Endpoint& server_address)
          "%s to %s on endpoint %" PRIEndptId ".\n",
          server_addr.ToString().c_str(), client_addr.ToString().c_str(),
          data_endpt_id_);
+
+    if (direct_path_)
+    {
+      // Add the second path.
+      Ipv4Endpoint  path_server_addr(path_local_addr_ + ":" + server_port_);
+      Ipv4Endpoint  path_client_addr(path_remote_addr_ + ":" + server_port_);
+
+      if (!AddPath(data_endpt_id_, path_server_addr, path_client_addr))
+      {
+        LogE(kName, __func__, "Error in AddPath().\n");
+        return false;
+      }
+    }
   }
   else
   {
@@ -2544,6 +2647,19 @@ bool TestApp::ActAsClient(const Ipv4Endpoint& server_address)
          "%s to %s on endpoint %" PRIEndptId ".\n",
          client_addr.ToString().c_str(), server_addr.ToString().c_str(),
          data_endpt_id_);
+
+    if (direct_path_)
+    {
+      // Add the second path.
+      Ipv4Endpoint  path_client_addr(path_local_addr_ + ":" + server_port_);
+      Ipv4Endpoint  path_server_addr(path_remote_addr_ + ":" + server_port_);
+
+      if (!AddPath(data_endpt_id_, path_client_addr, path_server_addr))
+      {
+        LogE(kName, __func__, "Error in AddPath().\n");
+        return false;
+      }
+    }
   }
   else
   {
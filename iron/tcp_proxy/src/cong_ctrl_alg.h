@@ -78,6 +78,42 @@ class CongCtrlAlg
   /// \param  data_len  The length of the received data.
   virtual void DupAckRcvd(const struct tcphdr* tcp_hdr, int data_len) = 0;
 
+  /// \brief Invoked when a new round trip time sample is available.
+  ///
+  /// \param  rtt_us  The round trip time sample, in microseconds.
+  virtual void RttSample(uint32_t rtt_us) { }
+
+  /// \brief Inquire whether the algorithm's congestion window and pacing
+  /// rate limit the Socket's transmissions.
+  ///
+  /// The windows computed by the original algorithms are not enforced by
+  /// the Socket, as WAN-facing transmissions are governed by Admission
+  /// Control.
+  ///
+  /// \return True if the Socket must honor GetCwnd() and GetPacingRate(),
+  ///         false otherwise.
+  virtual bool EnforcesWindow() const
+  {
+    return false;
+  }
+
+  /// \brief Get the congestion window.
+  ///
+  /// \return The congestion window, in bytes.
+  virtual uint32_t GetCwnd() const
+  {
+    return 0;
+  }
+
+  /// \brief Get the pacing rate.
+  ///
+  /// \return The pacing rate, in bits per second, or 0.0 if transmissions
+  ///         are not paced.
+  virtual double GetPacingRate() const
+  {
+    return 0.0;
+  }
+
   /// \brief Select the Congestion Control Algorithm implementation.
   void Select();
 
@@ -0,0 +1,397 @@
+//============================================================================
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+//============================================================================
+
+#include "cong_ctrl_bbr.h"
+#include "itime.h"
+#include "log.h"
+#include "socket.h"
+#include "unused.h"
+
+#include <string.h>
+
+using ::iron::Time;
+
+namespace
+{
+  /// Class name for logging.
+  const char*  UNUSED(kClassName) = "BbrCongCtrlAlg";
+
+  /// The STARTUP pacing and window gain, 2/ln(2), which doubles the
+  /// delivery rate every round trip.
+  const double    kHighGain = 2.885;
+
+  /// The DRAIN pacing gain, which drains the queue built during STARTUP.
+  const double    kDrainGain = 1.0 / 2.885;
+
+  /// The window gain outside of STARTUP and DRAIN.
+  const double    kCwndGain = 2.0;
+
+  /// The PROBE_BW pacing gain cycle, advanced once per round trip.
+  const double    kPacingGainCycle[] = {1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0,
+                                        1.0};
+
+  /// The length of the PROBE_BW pacing gain cycle.
+  const uint32_t  kGainCycleLen =
+    sizeof(kPacingGainCycle) / sizeof(kPacingGainCycle[0]);
+
+  /// The bandwidth growth that keeps STARTUP going.
+  const double    kFullBwThresh = 1.25;
+
+  /// The number of rounds without bandwidth growth that end STARTUP.
+  const uint32_t  kFullBwRounds = 3;
+
+  /// The lifetime of the propagation delay estimate, in microseconds.
+  const int64_t   kMinRttWindowUs = 10000000;
+
+  /// The minimum duration of PROBE_RTT, in microseconds.
+  const int64_t   kProbeRttDurationUs = 200000;
+
+  /// The initial congestion window, in segments.
+  const uint32_t  kInitialCwndSegs = 4;
+
+  /// The minimum congestion window, in segments, also used in PROBE_RTT.
+  const uint32_t  kMinCwndSegs = 4;
+}
+
+
+//============================================================================
+BbrCongCtrlAlg::BbrCongCtrlAlg(Socket* s)
+  : CongCtrlAlg(s),
+    mode_(BBR_STARTUP),
+    cwnd_(0),
+    prior_cwnd_(0),
+    pacing_gain_(kHighGain),
+    cwnd_gain_(kHighGain),
+    btl_bw_(0.0),
+    min_rtt_us_(0),
+    min_rtt_stamp_(),
+    min_rtt_expired_(false),
+    round_started_(false),
+    round_end_seq_(0),
+    round_start_time_(),
+    round_delivered_(0),
+    round_count_(0),
+    full_bw_(0.0),
+    full_bw_cnt_(0),
+    filled_pipe_(false),
+    cycle_idx_(0),
+    probe_rtt_done_time_(),
+    probe_rtt_done_round_(0)
+{
+  memset(bw_samples_, 0, sizeof(bw_samples_));
+}
+
+//============================================================================
+void BbrCongCtrlAlg::Init()
+{
+  mode_                 = BBR_STARTUP;
+  cwnd_                 = 0;
+  prior_cwnd_           = 0;
+  pacing_gain_          = kHighGain;
+  cwnd_gain_            = kHighGain;
+  btl_bw_               = 0.0;
+  min_rtt_us_           = 0;
+  min_rtt_expired_      = false;
+  round_started_        = false;
+  round_end_seq_        = 0;
+  round_delivered_      = 0;
+  round_count_          = 0;
+  full_bw_              = 0.0;
+  full_bw_cnt_          = 0;
+  filled_pipe_          = false;
+  cycle_idx_            = 0;
+  probe_rtt_done_round_ = 0;
+
+  memset(bw_samples_, 0, sizeof(bw_samples_));
+}
+
+//============================================================================
+void BbrCongCtrlAlg::AckRcvd(uint32_t ack_num, int bytes_acked)
+{
+  if (!selected_)
+  {
+    return;
+  }
+
+  uint32_t  min_cwnd = kMinCwndSegs * socket_->max_data();
+  Time      now      = Time::Now();
+
+  if (cwnd_ == 0)
+  {
+    cwnd_ = kInitialCwndSegs * socket_->max_data();
+  }
+
+  if (!round_started_)
+  {
+    StartRound(now);
+  }
+  else
+  {
+    if (bytes_acked > 0)
+    {
+      round_delivered_ += bytes_acked;
+    }
+
+    if (SEQ_GEQ(ack_num, round_end_seq_))
+    {
+      EndRound(now, ack_num);
+      StartRound(now);
+    }
+  }
+
+  if (bytes_acked <= 0)
+  {
+    return;
+  }
+
+  // Grow the window towards the target. Until the pipe is filled, the
+  // window grows with every acknowledged byte.
+  uint32_t  target = GetBdp(cwnd_gain_);
+
+  if (filled_pipe_ && (target > 0))
+  {
+    cwnd_ = MIN(cwnd_ + bytes_acked, MAX(target, min_cwnd));
+  }
+  else if ((target == 0) || (cwnd_ < target))
+  {
+    cwnd_ += bytes_acked;
+  }
+
+  cwnd_ = MAX(cwnd_, min_cwnd);
+
+  if (mode_ == BBR_PROBE_RTT)
+  {
+    cwnd_ = MIN(cwnd_, min_cwnd);
+  }
+}
+
+//============================================================================
+void BbrCongCtrlAlg::Timeout()
+{
+  if (!selected_)
+  {
+    return;
+  }
+
+  // Restart from a single segment. The window grows back to the target
+  // within a few round trips, as the estimates are kept.
+  cwnd_ = socket_->max_data();
+
+  LogD(kClassName, __func__, "Timeout, bandwidth estimate %.0f bps, min rtt "
+       "%" PRIu32 " us.\n", btl_bw_, min_rtt_us_);
+}
+
+//============================================================================
+void BbrCongCtrlAlg::RttSample(uint32_t rtt_us)
+{
+  if (!selected_)
+  {
+    return;
+  }
+
+  Time  now     = Time::Now();
+  bool  expired = ((min_rtt_us_ != 0) &&
+                   (now > min_rtt_stamp_ + Time::FromUsec(kMinRttWindowUs)));
+
+  if (expired)
+  {
+    min_rtt_expired_ = true;
+  }
+
+  if ((min_rtt_us_ == 0) || (rtt_us <= min_rtt_us_) || expired)
+  {
+    min_rtt_us_    = MAX(rtt_us, 1);
+    min_rtt_stamp_ = now;
+  }
+}
+
+//============================================================================
+uint32_t BbrCongCtrlAlg::GetCwnd() const
+{
+  if (cwnd_ == 0)
+  {
+    return kInitialCwndSegs * socket_->max_data();
+  }
+
+  return cwnd_;
+}
+
+//============================================================================
+double BbrCongCtrlAlg::GetPacingRate() const
+{
+  if (btl_bw_ > 0.0)
+  {
+    return (pacing_gain_ * btl_bw_);
+  }
+
+  // Without a bandwidth estimate, pace the window over the round trip time.
+  if (min_rtt_us_ > 0)
+  {
+    return (pacing_gain_ * GetCwnd() * 8.0 * 1000000.0 / min_rtt_us_);
+  }
+
+  return 0.0;
+}
+
+//============================================================================
+void BbrCongCtrlAlg::StartRound(const Time& now)
+{
+  round_started_    = true;
+  round_end_seq_    = socket_->seq_sent();
+  round_start_time_ = now;
+  round_delivered_  = 0;
+}
+
+//============================================================================
+void BbrCongCtrlAlg::EndRound(const Time& now, uint32_t ack_num)
+{
+  int64_t  elapsed_us = (now - round_start_time_).GetTimeInUsec();
+
+  round_count_++;
+
+  // Update the bottleneck bandwidth estimate with the round's delivery
+  // rate.
+  double  sample = 0.0;
+  if (elapsed_us > 0)
+  {
+    sample = static_cast<double>(round_delivered_) * 8.0 * 1000000.0 /
+      elapsed_us;
+  }
+
+  bw_samples_[round_count_ % BBR_BW_FILTER_ROUNDS] = sample;
+
+  btl_bw_ = 0.0;
+  for (uint32_t i = 0; i < BBR_BW_FILTER_ROUNDS; ++i)
+  {
+    btl_bw_ = MAX(btl_bw_, bw_samples_[i]);
+  }
+
+  uint32_t  in_flight = socket_->seq_sent() - ack_num;
+
+  switch (mode_)
+  {
+    case BBR_STARTUP:
+      // The pipe is full once the bandwidth estimate stops growing.
+      if (btl_bw_ >= (full_bw_ * kFullBwThresh))
+      {
+        full_bw_     = btl_bw_;
+        full_bw_cnt_ = 0;
+      }
+      else if (++full_bw_cnt_ >= kFullBwRounds)
+      {
+        filled_pipe_ = true;
+        mode_        = BBR_DRAIN;
+        pacing_gain_ = kDrainGain;
+
+        LogD(kClassName, __func__, "Pipe filled at %.0f bps, entering "
+             "DRAIN.\n", btl_bw_);
+      }
+      break;
+
+    case BBR_DRAIN:
+      if (in_flight <= GetBdp(1.0))
+      {
+        EnterProbeBw();
+      }
+      break;
+
+    case BBR_PROBE_BW:
+      cycle_idx_   = (cycle_idx_ + 1) % kGainCycleLen;
+      pacing_gain_ = kPacingGainCycle[cycle_idx_];
+      break;
+
+    case BBR_PROBE_RTT:
+      if ((now >= probe_rtt_done_time_) &&
+          (round_count_ >= probe_rtt_done_round_))
+      {
+        min_rtt_stamp_   = now;
+        min_rtt_expired_ = false;
+        cwnd_            = MAX(cwnd_, prior_cwnd_);
+
+        if (filled_pipe_)
+        {
+          EnterProbeBw();
+        }
+        else
+        {
+          mode_        = BBR_STARTUP;
+          pacing_gain_ = kHighGain;
+          cwnd_gain_   = kHighGain;
+        }
+      }
+      break;
+  }
+
+  // Drain the queue to measure the propagation delay when its estimate has
+  // not been refreshed for a while.
+  if ((mode_ != BBR_PROBE_RTT) && min_rtt_expired_)
+  {
+    mode_                 = BBR_PROBE_RTT;
+    pacing_gain_          = 1.0;
+    prior_cwnd_           = cwnd_;
+    probe_rtt_done_time_  = now + Time::FromUsec(kProbeRttDurationUs);
+    probe_rtt_done_round_ = round_count_ + 1;
+
+    LogD(kClassName, __func__, "Entering PROBE_RTT, min rtt %" PRIu32
+         " us.\n", min_rtt_us_);
+  }
+}
+
+//============================================================================
+void BbrCongCtrlAlg::EnterProbeBw()
+{
+  mode_        = BBR_PROBE_BW;
+  cwnd_gain_   = kCwndGain;
+  cycle_idx_   = 0;
+  pacing_gain_ = kPacingGainCycle[cycle_idx_];
+
+  LogD(kClassName, __func__, "Entering PROBE_BW at %.0f bps.\n", btl_bw_);
+}
+
+//============================================================================
+uint32_t BbrCongCtrlAlg::GetBdp(double gain) const
+{
+  if ((btl_bw_ <= 0.0) || (min_rtt_us_ == 0))
+  {
+    return 0;
+  }
+
+  return static_cast<uint32_t>(gain * btl_bw_ * min_rtt_us_ /
+                               (8.0 * 1000000.0));
+}
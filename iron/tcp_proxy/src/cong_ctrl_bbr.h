@@ -0,0 +1,242 @@
+//============================================================================
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+//============================================================================
+
+#ifndef IRON_TCP_PROXY_BBR_CONG_CTRL_ALG_H
+#define IRON_TCP_PROXY_BBR_CONG_CTRL_ALG_H
+
+#include "cong_ctrl_alg.h"
+#include "itime.h"
+
+class Socket;
+
+/// The number of round trips over which the bottleneck bandwidth is
+/// estimated.
+#define BBR_BW_FILTER_ROUNDS  10
+
+/// A rate-based Congestion Control Algorithm modeled after BBR.
+///
+/// The algorithm estimates the bottleneck bandwidth, as the maximum delivery
+/// rate over the last BBR_BW_FILTER_ROUNDS round trips, and the propagation
+/// delay, as the minimum round trip time over the last 10 seconds. The
+/// transmissions are paced at a gain times the bandwidth estimate, and the
+/// data in flight is limited to twice the estimated bandwidth-delay
+/// product. Losses are not used as a congestion signal, so random losses on
+/// long delay paths do not reduce the sending rate. The pacing rate and the
+/// window are enforced by the Socket.
+class BbrCongCtrlAlg : public CongCtrlAlg
+{
+  public:
+
+  /// \brief Constructor.
+  ///
+  /// \param  s  The Socket associated with the BBR Congestion Control
+  ///            algorithm.
+  BbrCongCtrlAlg(Socket* s);
+
+  /// \brief Destructor.
+  virtual ~BbrCongCtrlAlg() { }
+
+  /// \brief Initialize the BBR Congestion Control Algorithm.
+  void Init();
+
+  /// \brief Called when the Retransmit timer expires.
+  void Timeout();
+
+  /// \brief Invoked when an ACK is received.
+  ///
+  /// \param  ack_num      The received Ack number.
+  /// \param  bytes_acked  The number of bytes being acked.
+  void AckRcvd(uint32_t ack_num, int bytes_acked);
+
+  /// \brief Invoked when a SNACK is received.
+  ///
+  /// \param  tcp_hdr      The received TCP header.
+  /// \param  data_len     The length of the received data.
+  /// \param  bytes_acked  The number of bytes being acked.
+  void SnackRcvd(const struct tcphdr* tcp_hdr, int data_len, int bytes_acked)
+  { }
+
+  /// \brief Invoked when a duplicate ACK is received.
+  ///
+  /// \param  tcp_hdr   The received TCP header.
+  /// \param  data_len  The length of the received data.
+  void DupAckRcvd(const struct tcphdr* tcp_hdr, int data_len) { }
+
+  /// \brief Invoked when a new round trip time sample is available.
+  ///
+  /// \param  rtt_us  The round trip time sample, in microseconds.
+  void RttSample(uint32_t rtt_us);
+
+  /// \brief Inquire whether the algorithm limits the Socket's transmissions.
+  ///
+  /// \return Always true.
+  bool EnforcesWindow() const
+  {
+    return true;
+  }
+
+  /// \brief Get the congestion window.
+  ///
+  /// \return The congestion window, in bytes.
+  uint32_t GetCwnd() const;
+
+  /// \brief Get the pacing rate.
+  ///
+  /// \return The pacing rate, in bits per second, or 0.0 before the first
+  ///         round trip time sample.
+  double GetPacingRate() const;
+
+  protected:
+
+  /// \brief Constructor.
+  BbrCongCtrlAlg()
+  { }
+
+  private:
+
+  /// The BBR operating modes.
+  enum BbrMode
+  {
+    BBR_STARTUP,
+    BBR_DRAIN,
+    BBR_PROBE_BW,
+    BBR_PROBE_RTT
+  };
+
+  /// \brief Copy constructor.
+  BbrCongCtrlAlg(const BbrCongCtrlAlg& bbr);
+
+  /// \brief Copy operator.
+  BbrCongCtrlAlg& operator=(const BbrCongCtrlAlg& bbr);
+
+  /// \brief Start a new round trip.
+  ///
+  /// The round trip ends when the data sent so far is acknowledged.
+  ///
+  /// \param  now  The current time.
+  void StartRound(const iron::Time& now);
+
+  /// \brief End the current round trip.
+  ///
+  /// Updates the bandwidth estimate with the round's delivery rate and
+  /// advances the operating mode.
+  ///
+  /// \param  now      The current time.
+  /// \param  ack_num  The received Ack number.
+  void EndRound(const iron::Time& now, uint32_t ack_num);
+
+  /// \brief Enter the PROBE_BW mode.
+  void EnterProbeBw();
+
+  /// \brief Get the estimated bandwidth-delay product times a gain.
+  ///
+  /// \param  gain  The gain.
+  ///
+  /// \return The gain times the estimated bandwidth-delay product, in bytes,
+  ///         or 0 if there is no estimate yet.
+  uint32_t GetBdp(double gain) const;
+
+  /// The current operating mode.
+  BbrMode     mode_;
+
+  /// The congestion window, in bytes.
+  uint32_t    cwnd_;
+
+  /// The congestion window saved when entering PROBE_RTT.
+  uint32_t    prior_cwnd_;
+
+  /// The current pacing gain.
+  double      pacing_gain_;
+
+  /// The current congestion window gain.
+  double      cwnd_gain_;
+
+  /// The delivery rate samples for the last rounds, in bits per second.
+  double      bw_samples_[BBR_BW_FILTER_ROUNDS];
+
+  /// The bottleneck bandwidth estimate, in bits per second.
+  double      btl_bw_;
+
+  /// The propagation delay estimate, in microseconds, or 0 if there is no
+  /// sample yet.
+  uint32_t    min_rtt_us_;
+
+  /// The time of the propagation delay estimate.
+  iron::Time  min_rtt_stamp_;
+
+  /// Remembers if the propagation delay estimate has expired.
+  bool        min_rtt_expired_;
+
+  /// Remembers if a round trip has been started.
+  bool        round_started_;
+
+  /// The sequence number that must be acknowledged to end the round trip.
+  uint32_t    round_end_seq_;
+
+  /// The start time of the round trip.
+  iron::Time  round_start_time_;
+
+  /// The number of bytes acknowledged during the round trip.
+  uint32_t    round_delivered_;
+
+  /// The number of completed round trips.
+  uint32_t    round_count_;
+
+  /// The bandwidth estimate when it last grew significantly during STARTUP,
+  /// in bits per second.
+  double      full_bw_;
+
+  /// The number of rounds without significant bandwidth growth.
+  uint32_t    full_bw_cnt_;
+
+  /// Remembers if STARTUP has filled the pipe.
+  bool        filled_pipe_;
+
+  /// The index into the PROBE_BW pacing gain cycle.
+  uint32_t    cycle_idx_;
+
+  /// The earliest time that PROBE_RTT can end.
+  iron::Time  probe_rtt_done_time_;
+
+  /// The round trip count at which PROBE_RTT can end.
+  uint32_t    probe_rtt_done_round_;
+
+}; // end class BbrCongCtrlAlg
+
+#endif // IRON_TCP_PROXY_BBR_CONG_CTRL_ALG_H
@@ -0,0 +1,333 @@
+//============================================================================
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+//============================================================================
+
+#include "cong_ctrl_cubic.h"
+#include "itime.h"
+#include "log.h"
+#include "socket.h"
+#include "unused.h"
+
+#include <math.h>
+#include <netinet/tcp.h>
+
+using ::iron::Time;
+
+namespace
+{
+  /// Class name for logging.
+  const char*  UNUSED(kClassName) = "CubicCongCtrlAlg";
+
+  /// The cubic scaling constant, in segments per second cubed.
+  const double    kCubicC = 0.4;
+
+  /// The multiplicative window decrease factor.
+  const double    kCubicBeta = 0.7;
+
+  /// The initial congestion window, in segments.
+  const uint32_t  kInitialCwndSegs = 4;
+
+  /// The minimum congestion window after a loss, in segments.
+  const uint32_t  kMinCwndSegs = 2;
+
+  /// The initial slow start threshold, in bytes.
+  const double    kInitialSsthreshBytes = 1 << 30;
+
+  /// The pacing gain during slow start.
+  const double    kSlowStartPacingGain = 2.0;
+
+  /// The pacing gain during congestion avoidance.
+  const double    kCongAvoidPacingGain = 1.2;
+}
+
+
+//============================================================================
+CubicCongCtrlAlg::CubicCongCtrlAlg(Socket* s)
+  : CongCtrlAlg(s),
+    cwnd_(0.0),
+    ssthresh_(kInitialSsthreshBytes),
+    w_max_(0.0),
+    w_est_(0.0),
+    k_(0.0),
+    epoch_started_(false),
+    epoch_start_(),
+    in_recovery_(false),
+    recovery_seq_(0),
+    min_rtt_us_(0),
+    srtt_us_(0)
+{
+}
+
+//============================================================================
+void CubicCongCtrlAlg::Init()
+{
+  cwnd_          = 0.0;
+  ssthresh_      = kInitialSsthreshBytes;
+  w_max_         = 0.0;
+  w_est_         = 0.0;
+  k_             = 0.0;
+  epoch_started_ = false;
+  in_recovery_   = false;
+  recovery_seq_  = 0;
+  min_rtt_us_    = 0;
+  srtt_us_       = 0;
+}
+
+//============================================================================
+void CubicCongCtrlAlg::AckRcvd(uint32_t ack_num, int bytes_acked)
+{
+  if ((!selected_) || (bytes_acked <= 0))
+  {
+    return;
+  }
+
+  CheckInitialCwnd();
+
+  double  mss = socket_->max_data();
+
+  // The window is not grown by the ACKs for the data that was outstanding
+  // when the loss was detected.
+  if (in_recovery_)
+  {
+    if (SEQ_LT(ack_num, recovery_seq_))
+    {
+      return;
+    }
+
+    in_recovery_ = false;
+  }
+
+  if (cwnd_ < ssthresh_)
+  {
+    // Slow start.
+    cwnd_ += bytes_acked;
+  }
+  else
+  {
+    Time  now = Time::Now();
+
+    if (!epoch_started_)
+    {
+      // Start a new congestion avoidance epoch. K is the time needed to
+      // grow the window back to w_max_ (RFC 8312, Section 4.1).
+      epoch_started_ = true;
+      epoch_start_   = now;
+      w_est_         = cwnd_;
+
+      if (cwnd_ < w_max_)
+      {
+        k_ = pow((w_max_ - cwnd_) / (kCubicC * mss), 1.0 / 3.0);
+      }
+      else
+      {
+        k_     = 0.0;
+        w_max_ = cwnd_;
+      }
+    }
+
+    // Compute the cubic window one minimum round trip time from now.
+    double  t      = (now - epoch_start_).ToDouble() +
+      (static_cast<double>(min_rtt_us_) / 1000000.0);
+    double  target = w_max_ + (kCubicC * mss * (t - k_) * (t - k_) *
+                               (t - k_));
+
+    // Track the window that standard TCP would have reached, which is the
+    // lower bound for the cubic window (RFC 8312, Section 4.2).
+    w_est_ += ((3.0 * (1.0 - kCubicBeta) / (1.0 + kCubicBeta)) * mss *
+               bytes_acked / cwnd_);
+
+    if (target > cwnd_)
+    {
+      // Reach the target in one round trip time, but never grow the window
+      // by more than half of the acknowledged data.
+      cwnd_ += MIN((target - cwnd_) * bytes_acked / cwnd_,
+                   bytes_acked / 2.0);
+    }
+    else
+    {
+      cwnd_ += (mss * bytes_acked) / (100.0 * cwnd_);
+    }
+
+    if (w_est_ > cwnd_)
+    {
+      cwnd_ = w_est_;
+    }
+  }
+
+  // Clip the window to the largest window that can be offered.
+  cwnd_ = MIN(cwnd_, static_cast<double>(TCP_MAXWIN << socket_->snd_scale()));
+}
+
+//============================================================================
+void CubicCongCtrlAlg::SnackRcvd(const struct tcphdr* tcp_hdr, int data_len,
+                                 int bytes_acked)
+{
+  if (!selected_)
+  {
+    return;
+  }
+
+  CongestionEvent();
+}
+
+//============================================================================
+void CubicCongCtrlAlg::DupAckRcvd(const struct tcphdr* tcp_hdr, int data_len)
+{
+  if (!selected_)
+  {
+    return;
+  }
+
+  // The Socket has counted the duplicate ACK already. React only once, when
+  // the fast retransmission is triggered.
+  if (socket_->t_dupacks() == DUPACK_THRESH)
+  {
+    CongestionEvent();
+  }
+}
+
+//============================================================================
+void CubicCongCtrlAlg::Timeout()
+{
+  if (!selected_)
+  {
+    return;
+  }
+
+  CheckInitialCwnd();
+
+  double  mss = socket_->max_data();
+
+  // Remember the window for the next epoch and restart from slow start.
+  w_max_         = cwnd_;
+  ssthresh_      = MAX(cwnd_ * kCubicBeta, kMinCwndSegs * mss);
+  cwnd_          = mss;
+  epoch_started_ = false;
+  in_recovery_   = false;
+}
+
+//============================================================================
+void CubicCongCtrlAlg::RttSample(uint32_t rtt_us)
+{
+  if (!selected_)
+  {
+    return;
+  }
+
+  if ((min_rtt_us_ == 0) || (rtt_us < min_rtt_us_))
+  {
+    min_rtt_us_ = rtt_us;
+  }
+
+  // Smooth the samples with the RFC 6298 gain of 1/8.
+  if (srtt_us_ == 0)
+  {
+    srtt_us_ = rtt_us;
+  }
+  else
+  {
+    srtt_us_ = ((7 * static_cast<uint64_t>(srtt_us_)) + rtt_us) / 8;
+  }
+}
+
+//============================================================================
+uint32_t CubicCongCtrlAlg::GetCwnd() const
+{
+  if (cwnd_ <= 0.0)
+  {
+    return kInitialCwndSegs * socket_->max_data();
+  }
+
+  return static_cast<uint32_t>(cwnd_);
+}
+
+//============================================================================
+double CubicCongCtrlAlg::GetPacingRate() const
+{
+  if (srtt_us_ == 0)
+  {
+    return 0.0;
+  }
+
+  double  gain = (cwnd_ < ssthresh_) ? kSlowStartPacingGain :
+    kCongAvoidPacingGain;
+
+  return (gain * GetCwnd() * 8.0 * 1000000.0 / srtt_us_);
+}
+
+//============================================================================
+void CubicCongCtrlAlg::CheckInitialCwnd()
+{
+  if (cwnd_ <= 0.0)
+  {
+    cwnd_ = kInitialCwndSegs * socket_->max_data();
+  }
+}
+
+//============================================================================
+void CubicCongCtrlAlg::CongestionEvent()
+{
+  if (in_recovery_)
+  {
+    return;
+  }
+
+  CheckInitialCwnd();
+
+  double  mss = socket_->max_data();
+
+  // With fast convergence, a flow that lost before reaching its previous
+  // maximum releases some of its share (RFC 8312, Section 4.6).
+  if (cwnd_ < w_max_)
+  {
+    w_max_ = cwnd_ * (1.0 + kCubicBeta) / 2.0;
+  }
+  else
+  {
+    w_max_ = cwnd_;
+  }
+
+  cwnd_          = MAX(cwnd_ * kCubicBeta, kMinCwndSegs * mss);
+  ssthresh_      = cwnd_;
+  epoch_started_ = false;
+  in_recovery_   = true;
+  recovery_seq_  = socket_->snd_max();
+
+  LogD(kClassName, __func__, "Congestion event, cwnd %.0f w_max %.0f "
+       "recovery seq %" PRIu32 ".\n", cwnd_, w_max_, recovery_seq_);
+}
@@ -0,0 +1,190 @@
+//============================================================================
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+//============================================================================
+
+#ifndef IRON_TCP_PROXY_CUBIC_CONG_CTRL_ALG_H
+#define IRON_TCP_PROXY_CUBIC_CONG_CTRL_ALG_H
+
+#include "cong_ctrl_alg.h"
+#include "itime.h"
+
+class Socket;
+
+/// TCP Cubic Congestion Control Algorithm (RFC 8312).
+///
+/// After a loss event the congestion window follows a cubic function of the
+/// time since the event, which quickly returns to the window at which the
+/// loss occurred and then probes beyond it. Unlike the linear growth of the
+/// VJ algorithm, the growth does not depend on the round trip time, so long
+/// delay paths recover their capacity as quickly as short ones. The window
+/// and the pacing rate derived from it are enforced by the Socket.
+class CubicCongCtrlAlg : public CongCtrlAlg
+{
+  public:
+
+  /// \brief Constructor.
+  ///
+  /// \param  s  The Socket associated with the Cubic Congestion Control
+  ///            algorithm.
+  CubicCongCtrlAlg(Socket* s);
+
+  /// \brief Destructor.
+  virtual ~CubicCongCtrlAlg() { }
+
+  /// \brief Initialize TCP Cubic Congestion Control Algorithm.
+  void Init();
+
+  /// \brief Called when the Retransmit timer expires.
+  void Timeout();
+
+  /// \brief Invoked when an ACK is received.
+  ///
+  /// \param  ack_num      The received Ack number.
+  /// \param  bytes_acked  The number of bytes being acked.
+  void AckRcvd(uint32_t ack_num, int bytes_acked);
+
+  /// \brief Invoked when a SNACK is received.
+  ///
+  /// The SNACK reports a loss, which is handled as a congestion event.
+  ///
+  /// \param  tcp_hdr      The received TCP header.
+  /// \param  data_len     The length of the received data.
+  /// \param  bytes_acked  The number of bytes being acked.
+  void SnackRcvd(const struct tcphdr* tcp_hdr, int data_len, int bytes_acked);
+
+  /// \brief Invoked when a duplicate ACK is received.
+  ///
+  /// The duplicate ACK that triggers a fast retransmission is handled as a
+  /// congestion event.
+  ///
+  /// \param  tcp_hdr   The received TCP header.
+  /// \param  data_len  The length of the received data.
+  void DupAckRcvd(const struct tcphdr* tcp_hdr, int data_len);
+
+  /// \brief Invoked when a new round trip time sample is available.
+  ///
+  /// \param  rtt_us  The round trip time sample, in microseconds.
+  void RttSample(uint32_t rtt_us);
+
+  /// \brief Inquire whether the algorithm limits the Socket's transmissions.
+  ///
+  /// \return Always true.
+  bool EnforcesWindow() const
+  {
+    return true;
+  }
+
+  /// \brief Get the congestion window.
+  ///
+  /// \return The congestion window, in bytes.
+  uint32_t GetCwnd() const;
+
+  /// \brief Get the pacing rate.
+  ///
+  /// The window is spread over the smoothed round trip time, with some
+  /// headroom so that the pacing does not limit the window's growth.
+  ///
+  /// \return The pacing rate, in bits per second, or 0.0 before the first
+  ///         round trip time sample.
+  double GetPacingRate() const;
+
+  protected:
+
+  /// \brief Constructor.
+  CubicCongCtrlAlg()
+  { }
+
+  private:
+
+  /// \brief Copy constructor.
+  CubicCongCtrlAlg(const CubicCongCtrlAlg& cubic);
+
+  /// \brief Copy operator.
+  CubicCongCtrlAlg& operator=(const CubicCongCtrlAlg& cubic);
+
+  /// \brief Set the initial congestion window if it has not been set yet.
+  ///
+  /// The Socket's maximum data size may not be known yet when the algorithm
+  /// is initialized.
+  void CheckInitialCwnd();
+
+  /// \brief Reduce the congestion window in response to a loss.
+  ///
+  /// Only one reduction is made for the losses in a window of data.
+  void CongestionEvent();
+
+  /// The congestion window, in bytes.
+  double      cwnd_;
+
+  /// The slow start threshold, in bytes.
+  double      ssthresh_;
+
+  /// The congestion window before the last reduction, in bytes.
+  double      w_max_;
+
+  /// The window that standard TCP would have reached since the last
+  /// reduction, in bytes.
+  double      w_est_;
+
+  /// The time, in seconds, that the cubic function takes to grow the window
+  /// back to w_max_.
+  double      k_;
+
+  /// Remembers if the current congestion avoidance epoch has started.
+  bool        epoch_started_;
+
+  /// The start time of the current congestion avoidance epoch.
+  iron::Time  epoch_start_;
+
+  /// Remembers if the algorithm is recovering from a loss.
+  bool        in_recovery_;
+
+  /// The sequence number that must be acknowledged to end the recovery.
+  uint32_t    recovery_seq_;
+
+  /// The minimum round trip time sample, in microseconds, or 0 if there is
+  /// no sample yet.
+  uint32_t    min_rtt_us_;
+
+  /// The smoothed round trip time, in microseconds, or 0 if there is no
+  /// sample yet.
+  uint32_t    srtt_us_;
+
+}; // end class CubicCongCtrlAlg
+
+#endif // IRON_TCP_PROXY_CUBIC_CONG_CTRL_ALG_H
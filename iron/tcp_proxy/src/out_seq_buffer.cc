@@ -60,7 +60,9 @@ OutSeqBuffer::OutSeqBuffer(PktInfoPool& pkt_info_pool,
       head_(NULL),
       tail_(NULL),
       last_inserted_seq_(0),
-      socket_(socket)
+      socket_(socket),
+      seq_index_(),
+      plugs_()
 {
   LogI(kClassName, __func__, "Creating out-of-sequence buffer with a maximum "
        "size of %zd bytes...\n", max_size_bytes_);
@@ -84,6 +86,9 @@ OutSeqBuffer::~OutSeqBuffer()
 
   head_ = NULL;
   tail_ = NULL;
+
+  seq_index_.Clear();
+  plugs_.Clear();
 }
 
 //============================================================================
@@ -151,6 +156,8 @@ bool OutSeqBuffer::Enqueue(PktInfo* pkt_info)
     tail_          = pkt_info;
   }
 
+  IndexPkt(pkt_info);
+
   size_bytes_        += pkt_info->data_len;
   last_inserted_seq_  = pkt_info->seq_num;
 
@@ -214,49 +221,57 @@ bool OutSeqBuffer::Insert(PktInfo* pkt_info)
     return Enqueue(pkt_info);
   }
 
-  // The packet to be inserted goes somewhere between head_ and tail_. Start
-  // at the beginning of the packet buffer and find the correct place for the
-  // insertion.
-  cur_pkt_info = head_;
-  while (cur_pkt_info != NULL)
+  // The packet to be inserted goes somewhere between head_ and tail_. Use
+  // the sequence number index to check for a duplicate packet and to find
+  // the packet that the new packet is inserted in front of, which is the
+  // first packet with a larger sequence number.
+  PktInfo*  dup_pkt_info = NULL;
+  if (seq_index_.Find(pkt_info->seq_num, dup_pkt_info))
   {
-    if ((cur_pkt_info->seq_num == pkt_info->seq_num) &&
-        (cur_pkt_info->data_len == pkt_info->data_len))
+    while ((dup_pkt_info != NULL) &&
+           (dup_pkt_info->seq_num == pkt_info->seq_num))
     {
-      LogD(kClassName, __func__, "%s, out-of-sequence buffer: Packet is "
-           "already in buffer: seq (%" PRIu32 ") data len (%" PRIu32 ").\n",
-           socket_->flow_id_str(), pkt_info->seq_num, pkt_info->data_len);
-      return false;
-    }
+      if (dup_pkt_info->data_len == pkt_info->data_len)
+      {
+        LogD(kClassName, __func__, "%s, out-of-sequence buffer: Packet is "
+             "already in buffer: seq (%" PRIu32 ") data len (%" PRIu32
+             ").\n", socket_->flow_id_str(), pkt_info->seq_num,
+             pkt_info->data_len);
+        return false;
+      }
 
-    if (SEQ_GT(cur_pkt_info->seq_num, pkt_info->seq_num))
-    {
-      // The packet to insert goes before the current packet.
+      dup_pkt_info = dup_pkt_info->next;
+    }
+  }
 
-      pkt_info->prev = cur_pkt_info->prev;
+  uint32_t  next_seq = 0;
+  if (!seq_index_.FindHigher(pkt_info->seq_num, next_seq, cur_pkt_info))
+  {
+    // Only packets with the same sequence number as the tail are in the
+    // way, so the packet goes at the end of the packet buffer.
+    return Enqueue(pkt_info);
+  }
 
-      if (cur_pkt_info->prev)
-      {
-        cur_pkt_info->prev->next = pkt_info;
-      }
+  // The packet to insert goes before the current packet.
+  pkt_info->prev = cur_pkt_info->prev;
 
-      pkt_info->next     = cur_pkt_info;
-      cur_pkt_info->prev = pkt_info;
+  if (cur_pkt_info->prev)
+  {
+    cur_pkt_info->prev->next = pkt_info;
+  }
 
-      if (head_ == cur_pkt_info)
-      {
-        head_ = pkt_info;
-      }
+  pkt_info->next     = cur_pkt_info;
+  cur_pkt_info->prev = pkt_info;
 
-      size_bytes_ += pkt_info->data_len;
-      break;
-    }
-    else
-    {
-      cur_pkt_info = cur_pkt_info->next;
-    }
+  if (head_ == cur_pkt_info)
+  {
+    head_ = pkt_info;
   }
 
+  IndexPkt(pkt_info);
+
+  size_bytes_ += pkt_info->data_len;
+
   last_inserted_seq_ = pkt_info->seq_num;
 
   return true;
@@ -288,6 +303,8 @@ PktInfo* OutSeqBuffer::UnlinkHead()
 
   PktInfo*  pkt_info = head_;
 
+  UnindexPkt(pkt_info);
+
   pkt_info->prev = NULL;
   head_          = head_->next;
   pkt_info->next = NULL;
@@ -303,6 +320,8 @@ PktInfo* OutSeqBuffer::UnlinkHead()
 
   size_bytes_ -= pkt_info->data_len;
 
+  TrimFirstPlug();
+
   return pkt_info;
 }
 
@@ -318,19 +337,9 @@ size_t OutSeqBuffer::GatherPlugs(PlugInfo* plugs, uint32_t max_to_find)
     return num_found;
   }
 
-  PktInfo*  pkt_info = head_;
-  while (pkt_info != NULL)
+  bool  found = plugs_.GetFirst(lower, upper);
+  while (found)
   {
-    lower = pkt_info->seq_num;
-    upper = pkt_info->seq_num + pkt_info->data_len;
-
-    pkt_info = pkt_info->next;
-    while (pkt_info && pkt_info->seq_num == upper)
-    {
-      upper    += pkt_info->data_len;
-      pkt_info  = pkt_info->next;
-    }
-
     plugs[num_found].lower_seq = lower;
     plugs[num_found].upper_seq = upper;
 
@@ -339,6 +348,8 @@ size_t OutSeqBuffer::GatherPlugs(PlugInfo* plugs, uint32_t max_to_find)
     {
       break;
     }
+
+    found = plugs_.FindHigher(lower, lower, upper);
   }
 
   if (num_found > 0)
@@ -353,42 +364,128 @@ size_t OutSeqBuffer::GatherPlugs(PlugInfo* plugs, uint32_t max_to_find)
 //============================================================================
 bool OutSeqBuffer::GetPlugCoveringLastPkt(PlugInfo& plug)
 {
-  if (SEQ_LT(last_inserted_seq_, head_->seq_num))
+  uint32_t  lower = 0;
+  uint32_t  upper = 0;
+
+  if (plugs_.FindFloor(last_inserted_seq_, lower, upper) &&
+      SEQ_LT(last_inserted_seq_, upper))
   {
-    return false;
+    plug.lower_seq = lower;
+    plug.upper_seq = upper;
+
+    LogD(kClassName, __func__, "%s, Found covering plug for seq %"
+         PRIu32 "\n", socket_->flow_id_str(), last_inserted_seq_);
+
+    return true;
   }
 
+  LogD(kClassName, __func__, "%s, No covering plug found for seq %"
+       PRIu32 "\n", socket_->flow_id_str(), last_inserted_seq_);
+
+  return false;
+}
+
+//============================================================================
+void OutSeqBuffer::IndexPkt(PktInfo* pkt_info)
+{
+  // Packets with the same sequence number are adjacent in the buffer, so
+  // the index only needs to be updated if the packet is the first one with
+  // its sequence number.
+  if ((pkt_info->prev == NULL) ||
+      (pkt_info->prev->seq_num != pkt_info->seq_num))
+  {
+    if (!seq_index_.Insert(pkt_info->seq_num, pkt_info))
+    {
+      LogF(kClassName, __func__, "%s, Error adding seq (%" PRIu32 ") to the "
+           "sequence number index.\n", socket_->flow_id_str(),
+           pkt_info->seq_num);
+    }
+  }
+
+  if (pkt_info->data_len > 0)
+  {
+    AddPlug(pkt_info->seq_num, pkt_info->seq_num + pkt_info->data_len);
+  }
+}
+
+//============================================================================
+void OutSeqBuffer::UnindexPkt(PktInfo* pkt_info)
+{
+  PktInfo*  indexed_pkt_info = NULL;
+  if (!seq_index_.Find(pkt_info->seq_num, indexed_pkt_info) ||
+      (indexed_pkt_info != pkt_info))
+  {
+    return;
+  }
+
+  if ((pkt_info->next != NULL) &&
+      (pkt_info->next->seq_num == pkt_info->seq_num))
+  {
+    seq_index_.Insert(pkt_info->seq_num, pkt_info->next);
+  }
+  else
+  {
+    seq_index_.Erase(pkt_info->seq_num);
+  }
+}
+
+//============================================================================
+void OutSeqBuffer::AddPlug(uint32_t lower_seq, uint32_t upper_seq)
+{
   uint32_t  lower = 0;
   uint32_t  upper = 0;
 
-  PktInfo*  pkt_info = head_;
-  while (pkt_info != NULL)
+  // Merge with the preceding plug if the two touch or overlap.
+  if (plugs_.FindFloor(lower_seq, lower, upper) &&
+      SEQ_GEQ(upper, lower_seq))
   {
-    lower = pkt_info->seq_num;
-    upper = pkt_info->seq_num + pkt_info->data_len;
-
-    pkt_info = pkt_info->next;
-    while (pkt_info && pkt_info->seq_num == upper)
+    lower_seq = lower;
+    if (SEQ_GT(upper, upper_seq))
     {
-      upper    += pkt_info->data_len;
-      pkt_info  = pkt_info->next;
+      upper_seq = upper;
     }
+  }
 
-    if (SEQ_GEQ(last_inserted_seq_,lower) && SEQ_LT(last_inserted_seq_,upper))
+  // Absorb any following plugs that the merged plug now touches.
+  while (plugs_.FindHigher(lower_seq, lower, upper) &&
+         SEQ_LEQ(lower, upper_seq))
+  {
+    if (SEQ_GT(upper, upper_seq))
     {
-      plug.lower_seq = lower;
-      plug.upper_seq = upper;
+      upper_seq = upper;
+    }
+    plugs_.Erase(lower);
+  }
 
-      LogD(kClassName, __func__, "%s, Found covering plug for seq %"
-           PRIu32 "\n", socket_->flow_id_str(), last_inserted_seq_);
+  if (!plugs_.Insert(lower_seq, upper_seq))
+  {
+    LogF(kClassName, __func__, "%s, Error adding plug [%" PRIu32 ", %"
+         PRIu32 ").\n", socket_->flow_id_str(), lower_seq, upper_seq);
+  }
+}
 
-      return true;
-    }
+//============================================================================
+void OutSeqBuffer::TrimFirstPlug()
+{
+  if (head_ == NULL)
+  {
+    plugs_.Clear();
+    return;
   }
 
-  LogD(kClassName, __func__, "%s, No covering plug found for seq %"
-       PRIu32 "\n", socket_->flow_id_str(), last_inserted_seq_);
+  uint32_t  lower = 0;
+  uint32_t  upper = 0;
 
-  return false;
-}
+  if (!plugs_.GetFirst(lower, upper) || !SEQ_GT(head_->seq_num, lower))
+  {
+    return;
+  }
 
+  // The first plug now starts at the new head, unless the removed packet
+  // was the last one in the plug.
+  plugs_.Erase(lower);
+  if (SEQ_LT(head_->seq_num, upper))
+  {
+    plugs_.Insert(head_->seq_num, upper);
+  }
+}
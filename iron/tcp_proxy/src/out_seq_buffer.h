@@ -42,6 +42,7 @@
 
 #include "packet.h"
 #include "pkt_info_pool.h"
+#include "seq_map.h"
 
 class Socket;
 
@@ -175,6 +176,33 @@ class OutSeqBuffer
   ///         there are no packets in the buffer.
   PktInfo* UnlinkHead();
 
+  /// \brief Add a packet to the sequence number index.
+  ///
+  /// The index maps each sequence number to the first packet in the buffer
+  /// that starts at that sequence number. The packet must already be linked
+  /// into the buffer.
+  ///
+  /// \param  pkt_info  The packet to add to the index.
+  void IndexPkt(PktInfo* pkt_info);
+
+  /// \brief Remove a packet from the sequence number index.
+  ///
+  /// Must be called before the packet is unlinked from the buffer.
+  ///
+  /// \param  pkt_info  The packet to remove from the index.
+  void UnindexPkt(PktInfo* pkt_info);
+
+  /// \brief Add a block of received data to the set of plugs.
+  ///
+  /// Plugs that touch or overlap the new block are merged with it.
+  ///
+  /// \param  lower_seq  The first sequence number in the block.
+  /// \param  upper_seq  The sequence number following the block.
+  void AddPlug(uint32_t lower_seq, uint32_t upper_seq);
+
+  /// \brief Update the first plug after the head of the buffer is removed.
+  void TrimFirstPlug();
+
   // The following depicts the out-of-sequence buffer.
   //
   //     +-----+-----+-----+-----+-----+-----+-----+-----+-----+
@@ -207,6 +235,15 @@ class OutSeqBuffer
   /// Pointer to the Socket that owns the buffer.
   Socket*       socket_;
 
+  /// Index from sequence number to the first packet in the buffer with that
+  /// sequence number. Used to find insertion points in O(log n).
+  SeqMap<PktInfo*>  seq_index_;
+
+  /// The contiguous blocks of data held in the buffer, i.e., the plugs,
+  /// mapped from their lower sequence number to their upper sequence
+  /// number.
+  SeqMap<uint32_t>  plugs_;
+
 }; // end class OutSeqBuffer
 
 #endif // IRON_TCP_PROXY_OUT_SEQ_BUFFER_H
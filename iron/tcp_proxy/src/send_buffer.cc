@@ -56,6 +56,11 @@ namespace
 
   /// The maximum size for dynamic buffers.
   const uint32_t  kDefaultMaxDynamicBufferSize = 3000000;
+
+  /// The number of bytes at the end of a Packet's buffer that coalescing
+  /// leaves unused, so that a coalesced packet plus the headers added by the
+  /// BPF still fits in a single Packet at the remote proxy.
+  const size_t    kCoalesceReserveBytes = 128;
 }
 
 //============================================================================
@@ -79,7 +84,10 @@ SendBuffer::SendBuffer(PktInfoPool& pkt_info_pool, uint32_t max_size_bytes,
       adaptive_buffer_size_limit_(max_size_bytes),
       adaptive_buffer_min_size_(kDefaultMinDynamicBufferSize),
       adaptive_buffer_max_size_(kDefaultMaxDynamicBufferSize),
-      cum_acked_bytes_(0)
+      cum_acked_bytes_(0),
+      max_coalesce_bytes_(0),
+      seq_index_(),
+      hole_mark_seq_(0)
 {
   LogI(kClassName, __func__, "Creating send buffer with a maximum size of "
        "%zd bytes...\n", max_size_bytes);
@@ -101,6 +109,8 @@ SendBuffer::~SendBuffer()
     pkt_info_pool_.Recycle(cur_pkt_info);
   }
 
+  seq_index_.Clear();
+
   snd_una_     = NULL;
   snd_nxt_     = NULL;
   tail_        = NULL;
@@ -145,54 +155,27 @@ bool SendBuffer::Enqueue(PktInfo* pkt_info)
     }
   }
 
-  if ((snd_una_ != NULL) && (tail_ == NULL))
+  // Coalesce contiguous data into an untransmitted tail packet, if
+  // configured to do so.
+  if ((max_coalesce_bytes_ > 0) && CoalesceIntoTail(pkt_info))
   {
-    // There is a head but no tail. Something isn't right.
-    LogW(kClassName, __func__, "%s, Something is wrong. Send packet buffer "
-         "has a head but no tail.\n", socket_->flow_id_str());
-    return false;
-  }
-  else if ((snd_una_ == NULL) && (tail_ != NULL))
-  {
-    // There is a tail but no head. Something isn't right.
-    LogW(kClassName, __func__, "%s, Something is wrong. Send packet buffer "
-         "has a tail but no head.\n", socket_->flow_id_str());
-    return false;
-  }
-  else if (tail_ == NULL)
-  {
-    // There isn't anything in the send buffer. This is the first packet in
-    // the send buffer.
-    pkt_info->prev = NULL;
-    pkt_info->next = NULL;
-    snd_una_       = pkt_info;
-    snd_nxt_       = pkt_info;
-    tail_          = pkt_info;
-    una_seq_       = snd_una_->seq_num;
-    nxt_seq_       = tail_->seq_num + tail_->data_len;
-    if (!una_seq_initialized_)
-    {
-      win_hwm_             = una_seq_ + max_size_bytes_;
-      una_seq_initialized_ = true;
-    }
+    socket_->Send(NULL, false);
+
+    return true;
   }
-  else
-  {
-    // Append the packet to the tail of the send buffer.
-    tail_->next    = pkt_info;
-    pkt_info->prev = tail_;
-    pkt_info->next = NULL;
-    tail_          = pkt_info;
 
-    if (SEQ_LT(nxt_seq_,tail_->seq_num + tail_->data_len))
-    {
-      nxt_seq_ = tail_->seq_num + tail_->data_len;
-    }
+  // The remote proxy may have coalesced the data into a segment that is
+  // larger than this socket may transmit. If so, split it up.
+  int16_t  max_data = socket_->max_data();
+  if ((socket_->cfg_if_id() == LAN) && (max_data > 0) &&
+      (pkt_info->data_len > max_data))
+  {
+    return EnqueueResegmented(pkt_info, max_data);
   }
 
-  if (!snd_nxt_)
+  if (!AppendPkts(pkt_info, pkt_info))
   {
-    snd_nxt_ = tail_;
+    return false;
   }
 
   socket_->Send(NULL, false);
@@ -325,29 +308,45 @@ void SendBuffer::ProcessPlugs(OutSeqBuffer::PlugInfo* plugs,
     return;
   }
 
-  bool      done         = false;
-  Time      now          = Time::Now();
-  PktInfo*  cur_pkt_info = snd_una_;
-  uint32_t  i            = 0;
-  while ((i < num_plugs) && !done)
+  // Packets before hole_mark_seq_ that have not been plugged were marked as
+  // holes while processing earlier plugs, so they are not revisited.
+  if (SEQ_LT(hole_mark_seq_, snd_una_->seq_num))
+  {
+    hole_mark_seq_ = snd_una_->seq_num;
+  }
+
+  Time      now = Time::Now();
+  uint32_t  i   = 0;
+  while ((i < num_plugs) && (snd_una_ != NULL))
   {
     // Mark all packets in the buffer whose sequence numbers are less than
     // the sequence number of the current plug as holes, if necessary.
-    while (cur_pkt_info && SEQ_LT(cur_pkt_info->seq_num, plugs[i].lower_seq))
+    if (SEQ_LT(hole_mark_seq_, plugs[i].lower_seq))
     {
-      if (cur_pkt_info->rexmit_time.IsInfinite())
+      PktInfo*  cur_pkt_info = FindPkt(hole_mark_seq_);
+      while (cur_pkt_info &&
+             SEQ_LT(cur_pkt_info->seq_num, plugs[i].lower_seq))
       {
-        // The current packet does not have a retransmission time set yet, so
-        // we mark it as a hole.
-        MarkHole(cur_pkt_info, now);
+        if (cur_pkt_info->rexmit_time.IsInfinite())
+        {
+          // The current packet does not have a retransmission time set yet,
+          // so we mark it as a hole.
+          MarkHole(cur_pkt_info, now);
 
-        buf_changed = true;
+          buf_changed = true;
+        }
+
+        cur_pkt_info = cur_pkt_info->next;
       }
 
-      cur_pkt_info = cur_pkt_info->next;
+      // Never move the hole marking point past data that has yet to be
+      // enqueued.
+      hole_mark_seq_ = SEQ_LT(plugs[i].lower_seq, nxt_seq_) ?
+        plugs[i].lower_seq : nxt_seq_;
     }
 
-    PktInfo*  pkt_info_at_plug_start = cur_pkt_info;
+    PktInfo*  pkt_info_at_plug_start = FindPkt(plugs[i].lower_seq);
+    PktInfo*  cur_pkt_info           = pkt_info_at_plug_start;
 
     // A data length of 0 in the following loop is meant to cover SYN and
     // FIN packets.
@@ -401,11 +400,8 @@ void SendBuffer::ProcessPlugs(OutSeqBuffer::PlugInfo* plugs,
       }
       else
       {
-        // The plug is at the end of the send buffer. If and when this becomes
-        // the case, we can return as we know there are no additional packets
-        // that can be plugged.
+        // The plug is at the end of the send buffer.
         tail_ = pkt_info_at_plug_start->prev;
-        done  = true;
       }
       pkt_info_at_plug_start->prev = NULL;
 
@@ -593,6 +589,11 @@ void SendBuffer::Trim(uint32_t seq_num)
   {
     una_seq_ = nxt_seq_;
   }
+
+  if (SEQ_LT(hole_mark_seq_, una_seq_))
+  {
+    hole_mark_seq_ = una_seq_;
+  }
 }
 
 //============================================================================
@@ -816,6 +817,23 @@ void SendBuffer::ReleasePkts(PktInfo* pkt_info)
   {
     PktInfo*  next_pkt_info = pkt_info->next;
 
+    // Remove the packet from the sequence number index. If the next packet
+    // has the same sequence number, it becomes the indexed packet.
+    PktInfo*  indexed_pkt_info = NULL;
+    if (seq_index_.Find(pkt_info->seq_num, indexed_pkt_info) &&
+        (indexed_pkt_info == pkt_info))
+    {
+      if ((next_pkt_info != NULL) &&
+          (next_pkt_info->seq_num == pkt_info->seq_num))
+      {
+        seq_index_.Insert(pkt_info->seq_num, next_pkt_info);
+      }
+      else
+      {
+        seq_index_.Erase(pkt_info->seq_num);
+      }
+    }
+
     // Remove the packet from the retransmission list.
     if (pkt_info->rexmit_prev)
     {
@@ -849,3 +867,265 @@ void SendBuffer::ReleasePkts(PktInfo* pkt_info)
     pkt_info = next_pkt_info;
   }
 }
+
+//============================================================================
+PktInfo* SendBuffer::FindPkt(uint32_t seq_num) const
+{
+  uint32_t  found_seq_num = 0;
+  PktInfo*  pkt_info      = NULL;
+
+  if (!seq_index_.FindCeiling(seq_num, found_seq_num, pkt_info))
+  {
+    return NULL;
+  }
+
+  return pkt_info;
+}
+
+//============================================================================
+bool SendBuffer::AppendPkts(PktInfo* first_pkt_info, PktInfo* last_pkt_info)
+{
+  // Validate the send buffer before it is modified, so that either all of
+  // the packets are appended or none of them are.
+  if ((snd_una_ != NULL) && (tail_ == NULL))
+  {
+    // There is a head but no tail. Something isn't right.
+    LogW(kClassName, __func__, "%s, Something is wrong. Send packet buffer "
+         "has a head but no tail.\n", socket_->flow_id_str());
+    return false;
+  }
+  else if ((snd_una_ == NULL) && (tail_ != NULL))
+  {
+    // There is a tail but no head. Something isn't right.
+    LogW(kClassName, __func__, "%s, Something is wrong. Send packet buffer "
+         "has a tail but no head.\n", socket_->flow_id_str());
+    return false;
+  }
+
+  uint32_t  end_seq = last_pkt_info->seq_num + last_pkt_info->data_len;
+
+  if (tail_ == NULL)
+  {
+    // There isn't anything in the send buffer. These are the first packets
+    // in the send buffer.
+    first_pkt_info->prev = NULL;
+    snd_una_             = first_pkt_info;
+    snd_nxt_             = first_pkt_info;
+    una_seq_             = snd_una_->seq_num;
+    nxt_seq_             = end_seq;
+    if (!una_seq_initialized_)
+    {
+      win_hwm_             = una_seq_ + max_size_bytes_;
+      una_seq_initialized_ = true;
+    }
+    hole_mark_seq_ = una_seq_;
+  }
+  else
+  {
+    // Append the packets to the tail of the send buffer.
+    tail_->next          = first_pkt_info;
+    first_pkt_info->prev = tail_;
+
+    if (SEQ_LT(nxt_seq_, end_seq))
+    {
+      nxt_seq_ = end_seq;
+    }
+  }
+
+  last_pkt_info->next = NULL;
+  tail_               = last_pkt_info;
+
+  // Packets with the same sequence number, e.g., a SYN or a FIN, are
+  // adjacent in the send buffer. Only the first one is indexed.
+  for (PktInfo* pkt_info = first_pkt_info; pkt_info != NULL;
+       pkt_info = pkt_info->next)
+  {
+    if ((pkt_info->prev == NULL) ||
+        (pkt_info->prev->seq_num != pkt_info->seq_num))
+    {
+      if (!seq_index_.Insert(pkt_info->seq_num, pkt_info))
+      {
+        LogF(kClassName, __func__, "%s, Error adding seq (%" PRIu32 ") to "
+             "the sequence number index.\n", socket_->flow_id_str(),
+             pkt_info->seq_num);
+      }
+    }
+  }
+
+  if (!snd_nxt_)
+  {
+    snd_nxt_ = first_pkt_info;
+  }
+
+  return true;
+}
+
+//============================================================================
+bool SendBuffer::CoalesceIntoTail(PktInfo* pkt_info)
+{
+  // Only the data in an untransmitted tail packet may be extended. Once a
+  // packet has been transmitted, the BPF may still hold a reference to it
+  // and it may need to be retransmitted as is.
+  if ((tail_ == NULL) || (snd_nxt_ == NULL) || (tail_->data_len == 0) ||
+      (pkt_info->data_len == 0) || (!tail_->rexmit_time.IsInfinite()) ||
+      tail_->has_been_encapsulated || (tail_->pkt->ref_cnt() > 1))
+  {
+    return false;
+  }
+
+  if ((tail_->seq_num + tail_->data_len) != pkt_info->seq_num)
+  {
+    return false;
+  }
+
+  struct tcphdr*  tail_tcp_hdr = tail_->pkt->GetTcpHdr();
+  struct tcphdr*  tcp_hdr      = pkt_info->pkt->GetTcpHdr();
+  const uint8_t   no_coalesce  = (TH_SYN | TH_FIN | TH_RST | TH_URG);
+
+  if ((tail_tcp_hdr->th_flags & no_coalesce) ||
+      (tcp_hdr->th_flags & no_coalesce))
+  {
+    return false;
+  }
+
+  size_t  coalesced_data_len = tail_->data_len + pkt_info->data_len;
+  if ((coalesced_data_len > max_coalesce_bytes_) ||
+      ((tail_->pkt->GetLengthInBytes() + pkt_info->data_len +
+        kCoalesceReserveBytes) > tail_->pkt->GetMaxLengthInBytes()))
+  {
+    return false;
+  }
+
+  // Append the data, which also updates the length in the tail packet's IP
+  // header. The IP payload offset is past the TCP header and its options.
+  size_t  data_offset = pkt_info->pkt->GetIpPayloadOffset();
+  if (!tail_->pkt->AppendBlockToEnd(pkt_info->pkt->GetBuffer(data_offset),
+                                    pkt_info->data_len))
+  {
+    return false;
+  }
+
+  LogD(kClassName, __func__, "%s, coalesced seq (%" PRIu32 ") data len (%"
+       PRIu32 ") into tail packet with seq (%" PRIu32 ").\n",
+       socket_->flow_id_str(), pkt_info->seq_num, pkt_info->data_len,
+       tail_->seq_num);
+
+  tail_tcp_hdr->th_flags |= (tcp_hdr->th_flags & TH_PUSH);
+  tail_->flags           |= (pkt_info->flags & TH_PUSH);
+  tail_->data_len         = coalesced_data_len;
+  ResetTcpChecksums(tail_);
+
+  if (SEQ_LT(nxt_seq_, tail_->seq_num + tail_->data_len))
+  {
+    nxt_seq_ = tail_->seq_num + tail_->data_len;
+  }
+
+  pkt_info_pool_.Recycle(pkt_info);
+
+  return true;
+}
+
+//============================================================================
+bool SendBuffer::EnqueueResegmented(PktInfo* pkt_info, uint16_t max_data)
+{
+  Packet*         pkt      = pkt_info->pkt;
+  struct tcphdr*  tcp_hdr  = pkt->GetTcpHdr();
+  size_t          hdr_len  = pkt->GetIpPayloadOffset();
+  uint8_t         flags    = tcp_hdr->th_flags;
+  PktInfo*        seg_tail = pkt_info;
+
+  LogD(kClassName, __func__, "%s, resegmenting seq (%" PRIu32 ") data len (%"
+       PRIu32 ") into segments of at most %" PRIu16 " bytes.\n",
+       socket_->flow_id_str(), pkt_info->seq_num, pkt_info->data_len,
+       max_data);
+
+  // Build the trailing segments first, as the original packet is truncated
+  // to carry the first segment. Each segment gets a copy of the original
+  // headers. Only the last segment keeps the PSH and FIN flags.
+  for (uint32_t offset = max_data; offset < pkt_info->data_len;
+       offset += max_data)
+  {
+    uint16_t  seg_len  = ((pkt_info->data_len - offset) > max_data) ?
+      max_data : (pkt_info->data_len - offset);
+    PktInfo*  seg_info = pkt_info_pool_.Get();
+    Packet*   seg_pkt  = seg_info->pkt;
+
+    memcpy(seg_pkt->GetBuffer(), pkt->GetBuffer(), hdr_len);
+    memcpy(seg_pkt->GetBuffer(hdr_len), pkt->GetBuffer(hdr_len + offset),
+           seg_len);
+    seg_pkt->UpdateIpLen(hdr_len + seg_len);
+
+    struct tcphdr*  seg_tcp_hdr = seg_pkt->GetTcpHdr();
+    seg_tcp_hdr->th_seq         = htonl(pkt_info->seq_num + offset);
+    if ((offset + seg_len) < pkt_info->data_len)
+    {
+      seg_tcp_hdr->th_flags = (flags & ~(TH_PUSH | TH_FIN));
+    }
+
+    seg_info->seq_num   = pkt_info->seq_num + offset;
+    seg_info->data_len  = seg_len;
+    seg_info->flags     = seg_tcp_hdr->th_flags;
+    seg_info->timestamp = pkt_info->timestamp;
+    ResetTcpChecksums(seg_info);
+
+    seg_tail->next = seg_info;
+    seg_info->prev = seg_tail;
+    seg_tail       = seg_info;
+  }
+
+  pkt->UpdateIpLen(hdr_len + max_data);
+  tcp_hdr->th_flags  = (flags & ~(TH_PUSH | TH_FIN));
+  pkt_info->flags    = tcp_hdr->th_flags;
+  pkt_info->data_len = max_data;
+  ResetTcpChecksums(pkt_info);
+
+  // The segments are appended as a single list, so that the send buffer
+  // never holds some of them when the caller is told that the enqueue
+  // failed. The caller keeps ownership of the original packet on failure.
+  if (!AppendPkts(pkt_info, seg_tail))
+  {
+    LogW(kClassName, __func__, "%s, error enqueuing resegmented packet.\n",
+         socket_->flow_id_str());
+
+    PktInfo*  seg_info = pkt_info->next;
+    pkt_info->next     = NULL;
+    while (seg_info != NULL)
+    {
+      PktInfo*  next_seg_info = seg_info->next;
+      pkt_info_pool_.Recycle(seg_info);
+      seg_info = next_seg_info;
+    }
+
+    return false;
+  }
+
+  socket_->Send(NULL, false);
+
+  return true;
+}
+
+//============================================================================
+void SendBuffer::ResetTcpChecksums(PktInfo* pkt_info)
+{
+  Packet*         pkt     = pkt_info->pkt;
+  struct tcphdr*  tcp_hdr = pkt->GetTcpHdr();
+  uint16_t        cksum   = 0;
+
+  if (!pkt->ComputeTransportChecksum(pkt->GetIpPayloadLengthInBytes(),
+                                     cksum))
+  {
+    // This should never fail. If it does, something is terribly wrong.
+    LogF(kClassName, __func__, "%s, error computing TCP checksum.\n",
+         socket_->flow_id_str());
+  }
+  tcp_hdr->th_sum          = cksum;
+  pkt_info->orig_tcp_cksum = cksum;
+
+  if (!pkt->ComputeTransportChecksum(tcp_hdr->th_off * 4, cksum))
+  {
+    LogF(kClassName, __func__, "%s, error computing TCP header checksum.\n",
+         socket_->flow_id_str());
+  }
+  tcp_hdr->th_sum              = pkt_info->orig_tcp_cksum;
+  pkt_info->orig_tcp_hdr_cksum = cksum;
+}
@@ -42,6 +42,7 @@
 
 #include "pkt_info_pool.h"
 #include "out_seq_buffer.h"
+#include "seq_map.h"
 #include "tcp_proxy_config.h"
 
 class Socket;
@@ -274,6 +275,20 @@ class SendBuffer
     adaptive_buffer_size_limit_ = size_limit;
   }
 
+  /// \brief Set the maximum payload size of a coalesced segment, in bytes.
+  ///
+  /// When non-zero, the data in a packet that is enqueued directly behind an
+  /// untransmitted, contiguous tail packet is appended to the tail packet
+  /// instead of being queued as a separate packet.
+  ///
+  /// \param  max_coalesce_bytes  The maximum TCP payload size of a
+  ///                             coalesced segment, in bytes. Zero disables
+  ///                             coalescing.
+  inline void set_max_coalesce_bytes(uint32_t max_coalesce_bytes)
+  {
+    max_coalesce_bytes_ = max_coalesce_bytes;
+  }
+
   /// \brief Get the number of bytes acked by the remote proxy.
   ///
   /// \return The number of bytes acked by the remote proxy.
@@ -309,6 +324,63 @@ class SendBuffer
   ///                   that are being released.
   void ReleasePkts(PktInfo* pkt_info);
 
+  /// \brief Find the first packet whose sequence number is greater than or
+  /// equal to the specified sequence number.
+  ///
+  /// \param  seq_num  The sequence number.
+  ///
+  /// \return The first packet at or after the sequence number, or NULL if
+  ///         there is no such packet in the send buffer.
+  PktInfo* FindPkt(uint32_t seq_num) const;
+
+  /// \brief Link a list of contiguous packets to the tail of the send buffer.
+  ///
+  /// Either all of the packets are added to the send buffer or, if the send
+  /// buffer is found to be inconsistent, none of them are.
+  ///
+  /// \param  first_pkt_info  The first packet in the list.
+  /// \param  last_pkt_info   The last packet in the list.
+  ///
+  /// \return True if the packets are added, false otherwise.
+  bool AppendPkts(PktInfo* first_pkt_info, PktInfo* last_pkt_info);
+
+  /// \brief Append the data in a packet to the tail of the send buffer.
+  ///
+  /// The packet's data is appended to the tail packet if the tail packet has
+  /// not yet been transmitted, the data is contiguous with the tail packet's
+  /// data, neither packet carries a SYN, FIN, RST or URG flag, and the
+  /// coalesced segment is within the configured maximum size and fits in the
+  /// tail packet's buffer. On success, the packet is recycled.
+  ///
+  /// \param  pkt_info  The packet whose data is to be coalesced.
+  ///
+  /// \return True if the data is appended to the tail packet, false
+  ///         otherwise.
+  bool CoalesceIntoTail(PktInfo* pkt_info);
+
+  /// \brief Split a packet into segments no larger than the socket's maximum
+  /// data size and enqueue them.
+  ///
+  /// This undoes coalescing performed by the remote proxy before the data is
+  /// transmitted to the LAN.
+  ///
+  /// \param  pkt_info  The packet to be split. It carries the first segment
+  ///                   when enqueued.
+  /// \param  max_data  The maximum payload size of a segment, in bytes.
+  ///
+  /// \return True if all of the segments are enqueued, false if none of
+  ///         them are. On failure, the caller keeps ownership of pkt_info.
+  bool EnqueueResegmented(PktInfo* pkt_info, uint16_t max_data);
+
+  /// \brief Recompute the TCP checksum after the packet's data changes.
+  ///
+  /// The TCP checksum and the TCP header checksum that are used for the
+  /// incremental checksum update at transmission time are both reset, as if
+  /// the packet had been received in its current form.
+  ///
+  /// \param  pkt_info  The packet whose checksums are to be recomputed.
+  void ResetTcpChecksums(PktInfo* pkt_info);
+
   // The send buffer and retransmission list are depicted below:
   //
   //  snd_una_                     snd_nxt_      tail_              uwe
@@ -403,6 +475,18 @@ class SendBuffer
   /// The total number of bytes acked by the remote proxy.
   uint64_t      cum_acked_bytes_;
 
+  /// The maximum TCP payload size of a coalesced segment, in bytes. Zero
+  /// disables coalescing.
+  uint32_t      max_coalesce_bytes_;
+
+  /// Index from sequence number to the first packet in the send buffer with
+  /// that sequence number. Used to locate plugs and holes in O(log n).
+  SeqMap<PktInfo*>  seq_index_;
+
+  /// All of the packets in the send buffer before this sequence number that
+  /// have not been plugged have already been marked as holes.
+  uint32_t      hole_mark_seq_;
+
 }; // end class SendBuffer
 
 #endif // IRON_TCP_PROXY_SEND_BUFFER_H
@@ -0,0 +1,554 @@
+//============================================================================
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+//============================================================================
+
+#ifndef IRON_TCP_PROXY_SEQ_MAP_H
+#define IRON_TCP_PROXY_SEQ_MAP_H
+
+#include <new>
+
+#include <stdint.h>
+#include <unistd.h>
+
+/// An ordered map keyed by TCP sequence number.
+///
+/// Keys are compared using sequence number arithmetic, so all of the keys in
+/// a map must lie within 2^31 of each other. This always holds for the
+/// sequence numbers held in a send buffer or an out-of-sequence buffer.
+///
+/// The map is a height-balanced (AVL) binary search tree, so lookups,
+/// insertions and removals are O(log n). Removed tree nodes are kept in an
+/// internal pool for reuse.
+///
+/// This class is NOT thread-safe.
+template <typename V>
+class SeqMap
+{
+  public:
+
+  /// \brief Constructor.
+  SeqMap()
+      : root_(NULL), pool_(NULL), size_(0)
+  { }
+
+  /// \brief Destructor.
+  virtual ~SeqMap()
+  {
+    Clear();
+
+    while (pool_ != NULL)
+    {
+      Node*  node = pool_;
+      pool_       = node->left;
+      delete node;
+    }
+  }
+
+  /// \brief Add an entry to the map, or replace the value of an existing
+  /// entry.
+  ///
+  /// \param  key    The sequence number.
+  /// \param  value  The value to associate with the sequence number.
+  ///
+  /// \return True on success, false if memory could not be allocated.
+  bool Insert(uint32_t key, const V& value)
+  {
+    bool  ok = true;
+    root_    = InsertNode(root_, key, value, ok);
+    return ok;
+  }
+
+  /// \brief Remove an entry from the map.
+  ///
+  /// \param  key  The sequence number of the entry to remove.
+  ///
+  /// \return True if the entry was found and removed, false otherwise.
+  bool Erase(uint32_t key)
+  {
+    bool  erased = false;
+    root_        = EraseNode(root_, key, erased);
+    return erased;
+  }
+
+  /// \brief Find the entry with the specified sequence number.
+  ///
+  /// \param  key    The sequence number.
+  /// \param  value  The value of the entry, if found.
+  ///
+  /// \return True if the entry was found, false otherwise.
+  bool Find(uint32_t key, V& value) const
+  {
+    Node*  node = root_;
+    while (node != NULL)
+    {
+      if (SeqLt(key, node->key))
+      {
+        node = node->left;
+      }
+      else if (SeqLt(node->key, key))
+      {
+        node = node->right;
+      }
+      else
+      {
+        value = node->value;
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /// \brief Find the entry with the largest sequence number that is less
+  /// than or equal to the specified sequence number.
+  ///
+  /// \param  key        The sequence number.
+  /// \param  found_key  The sequence number of the entry, if found.
+  /// \param  value      The value of the entry, if found.
+  ///
+  /// \return True if such an entry was found, false otherwise.
+  bool FindFloor(uint32_t key, uint32_t& found_key, V& value) const
+  {
+    Node*  found = NULL;
+    Node*  node  = root_;
+    while (node != NULL)
+    {
+      if (SeqLt(key, node->key))
+      {
+        node = node->left;
+      }
+      else
+      {
+        found = node;
+        node  = node->right;
+      }
+    }
+
+    return GetEntry(found, found_key, value);
+  }
+
+  /// \brief Find the entry with the smallest sequence number that is greater
+  /// than or equal to the specified sequence number.
+  ///
+  /// \param  key        The sequence number.
+  /// \param  found_key  The sequence number of the entry, if found.
+  /// \param  value      The value of the entry, if found.
+  ///
+  /// \return True if such an entry was found, false otherwise.
+  bool FindCeiling(uint32_t key, uint32_t& found_key, V& value) const
+  {
+    Node*  found = NULL;
+    Node*  node  = root_;
+    while (node != NULL)
+    {
+      if (SeqLt(node->key, key))
+      {
+        node = node->right;
+      }
+      else
+      {
+        found = node;
+        node  = node->left;
+      }
+    }
+
+    return GetEntry(found, found_key, value);
+  }
+
+  /// \brief Find the entry with the smallest sequence number that is
+  /// strictly greater than the specified sequence number.
+  ///
+  /// This is used to walk the map in order.
+  ///
+  /// \param  key        The sequence number.
+  /// \param  found_key  The sequence number of the entry, if found.
+  /// \param  value      The value of the entry, if found.
+  ///
+  /// \return True if such an entry was found, false otherwise.
+  bool FindHigher(uint32_t key, uint32_t& found_key, V& value) const
+  {
+    Node*  found = NULL;
+    Node*  node  = root_;
+    while (node != NULL)
+    {
+      if (SeqLt(key, node->key))
+      {
+        found = node;
+        node  = node->left;
+      }
+      else
+      {
+        node = node->right;
+      }
+    }
+
+    return GetEntry(found, found_key, value);
+  }
+
+  /// \brief Get the entry with the smallest sequence number.
+  ///
+  /// \param  found_key  The sequence number of the entry, if found.
+  /// \param  value      The value of the entry, if found.
+  ///
+  /// \return True if the map is not empty, false otherwise.
+  bool GetFirst(uint32_t& found_key, V& value) const
+  {
+    Node*  node = root_;
+    while ((node != NULL) && (node->left != NULL))
+    {
+      node = node->left;
+    }
+
+    return GetEntry(node, found_key, value);
+  }
+
+  /// \brief Remove all of the entries from the map.
+  void Clear()
+  {
+    ClearNode(root_);
+    root_ = NULL;
+    size_ = 0;
+  }
+
+  /// \brief Get the number of entries in the map.
+  ///
+  /// \return The number of entries in the map.
+  inline size_t size() const
+  {
+    return size_;
+  }
+
+  private:
+
+  /// \brief Copy constructor.
+  SeqMap(const SeqMap& other);
+
+  /// \brief Assignment operator.
+  SeqMap& operator=(const SeqMap& other);
+
+  /// A tree node.
+  struct Node
+  {
+    /// The sequence number.
+    uint32_t  key;
+
+    /// The value associated with the sequence number.
+    V         value;
+
+    /// The left subtree, or the next node when in the pool.
+    Node*     left;
+
+    /// The right subtree.
+    Node*     right;
+
+    /// The height of the subtree rooted at this node.
+    int       height;
+  };
+
+  /// \brief Compare two sequence numbers.
+  ///
+  /// \param  a  The first sequence number.
+  /// \param  b  The second sequence number.
+  ///
+  /// \return True if a comes before b, false otherwise.
+  static inline bool SeqLt(uint32_t a, uint32_t b)
+  {
+    return (static_cast<int32_t>(a - b) < 0);
+  }
+
+  /// \brief Get the height of a subtree.
+  ///
+  /// \param  node  The root of the subtree. May be NULL.
+  ///
+  /// \return The height of the subtree.
+  static inline int Height(const Node* node)
+  {
+    return ((node != NULL) ? node->height : 0);
+  }
+
+  /// \brief Recompute the height of a node from its children.
+  ///
+  /// \param  node  The node.
+  static inline void UpdateHeight(Node* node)
+  {
+    int  hl      = Height(node->left);
+    int  hr      = Height(node->right);
+    node->height = 1 + ((hl > hr) ? hl : hr);
+  }
+
+  /// \brief Rotate a subtree to the right.
+  ///
+  /// \param  node  The root of the subtree.
+  ///
+  /// \return The new root of the subtree.
+  static Node* RotateRight(Node* node)
+  {
+    Node*  left = node->left;
+    node->left  = left->right;
+    left->right = node;
+    UpdateHeight(node);
+    UpdateHeight(left);
+    return left;
+  }
+
+  /// \brief Rotate a subtree to the left.
+  ///
+  /// \param  node  The root of the subtree.
+  ///
+  /// \return The new root of the subtree.
+  static Node* RotateLeft(Node* node)
+  {
+    Node*  right = node->right;
+    node->right  = right->left;
+    right->left  = node;
+    UpdateHeight(node);
+    UpdateHeight(right);
+    return right;
+  }
+
+  /// \brief Restore the AVL balance of a subtree.
+  ///
+  /// \param  node  The root of the subtree.
+  ///
+  /// \return The new root of the subtree.
+  static Node* Balance(Node* node)
+  {
+    UpdateHeight(node);
+
+    int  balance = Height(node->left) - Height(node->right);
+    if (balance > 1)
+    {
+      if (Height(node->left->left) < Height(node->left->right))
+      {
+        node->left = RotateLeft(node->left);
+      }
+      return RotateRight(node);
+    }
+    if (balance < -1)
+    {
+      if (Height(node->right->right) < Height(node->right->left))
+      {
+        node->right = RotateRight(node->right);
+      }
+      return RotateLeft(node);
+    }
+
+    return node;
+  }
+
+  /// \brief Copy out the key and value of a node.
+  ///
+  /// \param  node       The node. May be NULL.
+  /// \param  found_key  The sequence number of the node.
+  /// \param  value      The value of the node.
+  ///
+  /// \return True if the node is not NULL, false otherwise.
+  static inline bool GetEntry(const Node* node, uint32_t& found_key,
+                              V& value)
+  {
+    if (node == NULL)
+    {
+      return false;
+    }
+
+    found_key = node->key;
+    value     = node->value;
+    return true;
+  }
+
+  /// \brief Insert into a subtree.
+  ///
+  /// \param  node   The root of the subtree. May be NULL.
+  /// \param  key    The sequence number.
+  /// \param  value  The value.
+  /// \param  ok     Set to false if a node could not be allocated.
+  ///
+  /// \return The new root of the subtree.
+  Node* InsertNode(Node* node, uint32_t key, const V& value, bool& ok)
+  {
+    if (node == NULL)
+    {
+      Node*  new_node = GetNode();
+      if (new_node == NULL)
+      {
+        ok = false;
+        return NULL;
+      }
+      new_node->key    = key;
+      new_node->value  = value;
+      new_node->left   = NULL;
+      new_node->right  = NULL;
+      new_node->height = 1;
+      ++size_;
+      return new_node;
+    }
+
+    if (SeqLt(key, node->key))
+    {
+      node->left = InsertNode(node->left, key, value, ok);
+    }
+    else if (SeqLt(node->key, key))
+    {
+      node->right = InsertNode(node->right, key, value, ok);
+    }
+    else
+    {
+      node->value = value;
+      return node;
+    }
+
+    return Balance(node);
+  }
+
+  /// \brief Unlink the node with the smallest sequence number from a
+  /// subtree.
+  ///
+  /// \param  node      The root of the subtree. Must not be NULL.
+  /// \param  min_node  Set to the unlinked node.
+  ///
+  /// \return The new root of the subtree.
+  static Node* UnlinkMin(Node* node, Node*& min_node)
+  {
+    if (node->left == NULL)
+    {
+      min_node = node;
+      return node->right;
+    }
+
+    node->left = UnlinkMin(node->left, min_node);
+    return Balance(node);
+  }
+
+  /// \brief Remove from a subtree.
+  ///
+  /// \param  node    The root of the subtree. May be NULL.
+  /// \param  key     The sequence number to remove.
+  /// \param  erased  Set to true if the entry was found and removed.
+  ///
+  /// \return The new root of the subtree.
+  Node* EraseNode(Node* node, uint32_t key, bool& erased)
+  {
+    if (node == NULL)
+    {
+      return NULL;
+    }
+
+    if (SeqLt(key, node->key))
+    {
+      node->left = EraseNode(node->left, key, erased);
+    }
+    else if (SeqLt(node->key, key))
+    {
+      node->right = EraseNode(node->right, key, erased);
+    }
+    else
+    {
+      Node*  left  = node->left;
+      Node*  right = node->right;
+      RecycleNode(node);
+      --size_;
+      erased = true;
+
+      if (right == NULL)
+      {
+        return left;
+      }
+
+      Node*  min_node = NULL;
+      right           = UnlinkMin(right, min_node);
+      min_node->left  = left;
+      min_node->right = right;
+      return Balance(min_node);
+    }
+
+    return Balance(node);
+  }
+
+  /// \brief Recycle all of the nodes in a subtree.
+  ///
+  /// \param  node  The root of the subtree. May be NULL.
+  void ClearNode(Node* node)
+  {
+    if (node == NULL)
+    {
+      return;
+    }
+
+    ClearNode(node->left);
+    ClearNode(node->right);
+    RecycleNode(node);
+  }
+
+  /// \brief Get a node, either from the pool or a new allocation.
+  ///
+  /// \return A pointer to an unused node, or NULL if a new node could not
+  ///         be allocated.
+  Node* GetNode()
+  {
+    if (pool_ != NULL)
+    {
+      Node*  node = pool_;
+      pool_       = node->left;
+      return node;
+    }
+
+    return new (std::nothrow) Node();
+  }
+
+  /// \brief Return a node to the pool.
+  ///
+  /// \param  node  The node to recycle.
+  inline void RecycleNode(Node* node)
+  {
+    node->left  = pool_;
+    node->right = NULL;
+    pool_       = node;
+  }
+
+  /// The root of the tree.
+  Node*   root_;
+
+  /// The pool of unused nodes, linked through their left pointers.
+  Node*   pool_;
+
+  /// The number of entries in the map.
+  size_t  size_;
+
+}; // end class SeqMap
+
+#endif // IRON_TCP_PROXY_SEQ_MAP_H
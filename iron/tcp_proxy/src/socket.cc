@@ -39,6 +39,8 @@
 
 #include "socket.h"
 #include "clock.h"
+#include "cong_ctrl_bbr.h"
+#include "cong_ctrl_cubic.h"
 #include "cong_ctrl_none.h"
 #include "cong_ctrl_vj.h"
 #include "iron_constants.h"
@@ -213,6 +215,8 @@ Socket::Socket(TcpProxy& tcp_proxy, iron::PacketPool& packet_pool,
       mtu_(kDefaultMTU),
       t_dupacks_(0),
       unacked_segs_(0),
+      cc_alg_(VJ_CONGESTION_CONTROL),
+      next_pacing_time_(),
       last_adv_wnd_(kDefaultBufferSize),
       total_sent_(0),
       is_carrying_data_(false),
@@ -346,8 +350,10 @@ Socket::Socket(TcpProxy& tcp_proxy, iron::PacketPool& packet_pool,
     cc_algs_[i] = NULL;
   }
 
-  cc_algs_[NO_CONGESTION_CONTROL] = new NoCongCtrlAlg(this);
-  cc_algs_[VJ_CONGESTION_CONTROL] = new VJCongCtrlAlg(this);
+  cc_algs_[NO_CONGESTION_CONTROL]    = new NoCongCtrlAlg(this);
+  cc_algs_[VJ_CONGESTION_CONTROL]    = new VJCongCtrlAlg(this);
+  cc_algs_[CUBIC_CONGESTION_CONTROL] = new CubicCongCtrlAlg(this);
+  cc_algs_[BBR_CONGESTION_CONTROL]   = new BbrCongCtrlAlg(this);
 
   // The default Congestion Control Alogirthm is VJ.
   cc_algs_[VJ_CONGESTION_CONTROL]->Select();
@@ -836,6 +842,16 @@ uint32_t Socket::Send(PktInfo* arg_pkt_info, bool force)
     next_admission_time_ = low_adm_time;
   }
 
+  // The selected Congestion Control Algorithm may limit the transmissions
+  // with its congestion window and pacing rate. The pacing schedule gets the
+  // same catch up limit and burst window as admission control, as the
+  // socket is only serviced by the TCP Proxy's service sockets timer.
+  CongCtrlAlg*  cc_alg = GetEnforcingCcAlg();
+  if ((cc_alg != NULL) && (next_pacing_time_ < low_adm_time))
+  {
+    next_pacing_time_ = low_adm_time;
+  }
+
   while (true)
   {
     // We exit the loop if the force flag is true.
@@ -917,6 +933,29 @@ uint32_t Socket::Send(PktInfo* arg_pkt_info, bool force)
       break;
     }
 
+    // Test if we are blocked by the selected Congestion Control
+    // Algorithm. The congestion window only limits new data, while both new
+    // data and retransmissions are paced.
+    if (cc_alg != NULL)
+    {
+      if (pkt_info->rexmit_time.IsInfinite() && (pkt_info->data_len > 0) &&
+          ((seq_sent_ - snd_una_) + pkt_info->data_len > cc_alg->GetCwnd()))
+      {
+        LogD(kClassName, __func__, "%s, exiting loop, congestion window "
+             "blocked: in flight=%" PRIu32 " cwnd=%" PRIu32 ".\n",
+             flow_id_str_, (seq_sent_ - snd_una_), cc_alg->GetCwnd());
+        break;
+      }
+
+      if (next_pacing_time_ >
+          (now + min_burst_usec_.Multiply(kBurstIntervalMultiplier)))
+      {
+        LogD(kClassName, __func__, "%s, exiting loop, pacing blocked until "
+             "%s.\n", flow_id_str_, next_pacing_time_.ToString().c_str());
+        break;
+      }
+    }
+
     test_val = pkt_info->pkt->GetLengthInBytes();
 
     // Test if we are congestion control blocked on the LAN side interface.
@@ -947,6 +986,8 @@ uint32_t Socket::Send(PktInfo* arg_pkt_info, bool force)
 
     took_while = 1;
 
+    FlushIfQueuedForLan(pkt_info);
+
     if (is_tunneled_ && pkt_info->has_been_encapsulated)
     {
       // Remove the tunnel headers for packets that have been
@@ -1016,6 +1057,14 @@ uint32_t Socket::Send(PktInfo* arg_pkt_info, bool force)
 
       max_to_send -= bytes_sent;
 
+      // Advance the pacing schedule by the transmission's serialization time
+      // at the selected Congestion Control Algorithm's pacing rate.
+      if ((cc_alg != NULL) && (cc_alg->GetPacingRate() > 0.0))
+      {
+        next_pacing_time_ = next_pacing_time_.Add(
+          static_cast<double>(bytes_sent) * 8.0 / cc_alg->GetPacingRate());
+      }
+
       if (!pkt_info->rexmit_time.IsInfinite() && (bytes_sent > 0))
       {
         LogD(kClassName, __func__, "%s, retransmitted seq num %" PRIu32
@@ -1215,6 +1264,8 @@ uint32_t Socket::Send(PktInfo* arg_pkt_info, bool force)
 
   if ((arg_pkt_info) && !(took_while))
   {
+    FlushIfQueuedForLan(arg_pkt_info);
+
     if (is_tunneled_ && arg_pkt_info->has_been_encapsulated)
     {
       // Remove the tunnel headers for packets that have been
@@ -1625,7 +1676,8 @@ void Socket::ConfigureUtilityFn(string utility_def, QueueDepths& queue_depths)
 
   flow_utility_fn_ =
     new (std::nothrow) iron::LogUtility(queue_depths, bin_idx_,
-                                        tcp_proxy_.k_val(), flow_tag_);
+                                        tcp_proxy_.k_val(), flow_tag_,
+                                        &tcp_proxy_.log_utility_batch());
 
   if (flow_utility_fn_ == NULL)
   {
@@ -1982,6 +2034,12 @@ void Socket::Flush()
     {
       flags_ |= TH_PUSH;
 
+      // The packets may still be queued for the LAN.
+      if (cfg_if_id_ == LAN)
+      {
+        tcp_proxy_.FlushLanSends();
+      }
+
       send_buf_->SetPacketsPushFlag();
     }
 
@@ -2086,6 +2144,14 @@ void Socket::SetProxyOptions()
   }
   peer_send_buf_max_bytes_ = peer_buffer_size;
 
+  // Set the maximum size of the segments coalesced by the socket's send
+  // buffer. Only WAN-facing sockets coalesce segments. LAN-facing sockets
+  // split coalesced segments back into MSS-sized segments.
+  if (cfg_if_id_ == WAN)
+  {
+    send_buf_->set_max_coalesce_bytes(proxy_config_.wan_coalesce_bytes());
+  }
+
   // If we're doing window scaling and haven't sent a SYN yet, can go ahead
   // and recompute the window scale factor. Since this is set only on the SYN,
   // if the SYN's gone out, must not change the value, regardless of the
@@ -2116,8 +2182,9 @@ void Socket::SetProxyOptions()
       break;
 
     case VJ_CONGESTION_CONTROL:
-      ClearCcAlgSelection();
-      cc_algs_[VJ_CONGESTION_CONTROL]->Select();
+    case CUBIC_CONGESTION_CONTROL:
+    case BBR_CONGESTION_CONTROL:
+      set_cc_alg(proxy_config_.GetIfCongCtrlAlg(cfg_if_id_));
       break;
   }
 
@@ -2738,6 +2805,8 @@ uint32_t Socket::SendPkt(PktInfo* pkt_info)
 
   int write_len_bytes = 0;
 
+  FlushIfQueuedForLan(pkt_info);
+
   // Adjust the packet timing, if necessary.
   TimePkt(pkt_info);
 
@@ -2936,6 +3005,17 @@ uint32_t Socket::SendPkt(PktInfo* pkt_info)
   return write_len_bytes;
 }
 
+//============================================================================
+void Socket::FlushIfQueuedForLan(PktInfo* pkt_info)
+{
+  // Only the LAN send batch shares the packets that a LAN-facing socket
+  // keeps, so a shared packet may still be waiting to be sent.
+  if ((cfg_if_id_ == LAN) && (pkt_info->pkt->ref_cnt() > 1))
+  {
+    tcp_proxy_.FlushLanSends();
+  }
+}
+
 //============================================================================
 void Socket::ProcessPktListenState(const struct iphdr* ip_hdr,
                                    const struct tcphdr* tcp_hdr)
@@ -3052,8 +3132,9 @@ int Socket::ProcessPktSynSentState(const struct tcphdr* tcp_hdr)
         }
       }
 
-      // select the desired congestion control algorithm (VJ in this case).
-      cc_algs_[VJ_CONGESTION_CONTROL]->Select();
+      // select the desired congestion control algorithm (VJ unless the
+      // Service definition requests otherwise).
+      cc_algs_[cc_alg_]->Select();
 
       if ((sock_flags_ & (TF_RCVD_SCALE | TF_REQ_SCALE)) ==
           (TF_RCVD_SCALE | TF_REQ_SCALE))
@@ -3641,7 +3722,8 @@ void Socket::HandleNewConnection(const struct iphdr* ip_hdr,
   capabilities_ |= CAP_CONGEST;
 
   // Deselect the current congestion control algorithm and
-  // select the desired congestion control algorithm (VJ in this case).
+  // select the desired congestion control algorithm (VJ unless the Service
+  // definition requests otherwise).
 
   for (int i = 0; i < MAX_CC_ALG_CNT; i++)
   {
@@ -3653,7 +3735,7 @@ void Socket::HandleNewConnection(const struct iphdr* ip_hdr,
     }
   }
 
-  cc_algs_[VJ_CONGESTION_CONTROL]->Select();
+  cc_algs_[cc_alg_]->Select();
 }
 
 //============================================================================
@@ -3769,8 +3851,8 @@ void Socket::ProcessAck(PktInfo* pkt_info, const struct tcphdr* tcp_hdr)
     }
 
     // Process the positive ACK in the Congestion Control Algorithm
-    // implementations (LAN side only)
-    if (cfg_if_id_ == LAN)
+    // implementations.
+    if (ReportsCcEvents())
     {
       for (int i = 0; i < MAX_CC_ALG_CNT; i++)
       {
@@ -3873,8 +3955,8 @@ void Socket::ProcessAck(PktInfo* pkt_info, const struct tcphdr* tcp_hdr)
     }
 
     // Process the duplicate Ack in the Congestion Control Algorithm
-    // implementations (LAN side only)
-    if (cfg_if_id_ == LAN)
+    // implementations.
+    if (ReportsCcEvents())
     {
       for (int i = 0; i < MAX_CC_ALG_CNT; i++)
       {
@@ -4134,6 +4216,13 @@ void Socket::ProcessRcvdData(PktInfo* pkt_info, const struct tcphdr* tcp_hdr)
     // Place the new segment into the peer's send queue.
     UpdateHeaderForMoveToPeer(pkt_info);
     out_seq_buf_->set_last_inserted_seq(pkt_info->seq_num);
+
+    // The peer's send buffer may coalesce the packet into its tail packet
+    // and recycle it, or split it into several segments, so the received
+    // sequence number range is captured before it is enqueued.
+    uint32_t  rcvd_seq_num  = pkt_info->seq_num;
+    uint32_t  rcvd_data_len = pkt_info->data_len;
+
     if (!peer_->send_buf_->Enqueue(pkt_info))
     {
       // The enqueue failed. Recycle the packet and delete the PktInfo.
@@ -4143,11 +4232,10 @@ void Socket::ProcessRcvdData(PktInfo* pkt_info, const struct tcphdr* tcp_hdr)
       return;
     }
 
-    ack_num_ = pkt_info->seq_num + pkt_info->data_len;
+    ack_num_ = rcvd_seq_num + rcvd_data_len;
 
     LogD(kClassName, __func__, "%s, Rcvd. Packet: seq (%" PRIu32 "), data "
-         "len (%" PRIu32 ").\n", flow_id_str_, pkt_info->seq_num,
-         pkt_info->data_len);
+         "len (%" PRIu32 ").\n", flow_id_str_, rcvd_seq_num, rcvd_data_len);
 
     while (out_seq_buf_->head() &&
            SEQ_LEQ(out_seq_buf_->head()->seq_num, ack_num_))
@@ -4195,7 +4283,7 @@ void Socket::ProcessRcvdData(PktInfo* pkt_info, const struct tcphdr* tcp_hdr)
           {
             LogW(kClassName, __func__, "%s, really odd ack number check "
                  "failed\n", flow_id_str_);
-            ack_num_ = pkt_info->seq_num + pkt_info->data_len;
+            ack_num_ = rcvd_seq_num + rcvd_data_len;
           }
         }
 
@@ -4425,6 +4513,15 @@ void Socket::UpdateRttEstimate(uint32_t rtt_sample)
 
   t_rxtcur_ = MAX(t_rxtcur_, min_rto_us_);
   t_rxtcur_ = MIN(t_rxtcur_, max_rto_us_);
+
+  // Provide the sample to the Congestion Control Algorithm implementations.
+  for (int i = 0; i < MAX_CC_ALG_CNT; i++)
+  {
+    if (cc_algs_[i] != NULL)
+    {
+      cc_algs_[i]->RttSample(rtt_sample);
+    }
+  }
 }
 
 //============================================================================
@@ -5109,7 +5206,7 @@ void Socket::RtoTimeout()
 
     // Process the timeout in the Congestion Control Algorithm
     // implementations.
-    if (cfg_if_id_ == LAN)
+    if (ReportsCcEvents())
     {
       for (int i = 0; i < MAX_CC_ALG_CNT; i++)
       {
@@ -5217,6 +5314,24 @@ void Socket::TimeWaitTimeout()
   }
 }
 
+//============================================================================
+void Socket::set_cc_alg(int cc_alg)
+{
+  if ((cc_alg < 0) || (cc_alg >= MAX_CC_ALG_CNT) ||
+      (cc_algs_[cc_alg] == NULL))
+  {
+    LogW(kClassName, __func__, "%s, invalid congestion control algorithm "
+         "%d, keeping %d.\n", flow_id_str_, cc_alg, cc_alg_);
+    return;
+  }
+
+  cc_alg_ = cc_alg;
+
+  // The algorithm is selected again when the connection is established.
+  ClearCcAlgSelection();
+  cc_algs_[cc_alg_]->Select();
+}
+
 //============================================================================
 void Socket::ClearCcAlgSelection()
 {
@@ -5231,6 +5346,40 @@ void Socket::ClearCcAlgSelection()
   }
 }
 
+//============================================================================
+CongCtrlAlg* Socket::GetSelectedCcAlg() const
+{
+  for (int i = 0; i < MAX_CC_ALG_CNT; i++)
+  {
+    if ((cc_algs_[i] != NULL) && cc_algs_[i]->selected())
+    {
+      return cc_algs_[i];
+    }
+  }
+
+  return NULL;
+}
+
+//============================================================================
+CongCtrlAlg* Socket::GetEnforcingCcAlg() const
+{
+  CongCtrlAlg*  cc_alg = GetSelectedCcAlg();
+
+  if ((cc_alg != NULL) && (capabilities_ & CAP_CONGEST) &&
+      cc_alg->EnforcesWindow())
+  {
+    return cc_alg;
+  }
+
+  return NULL;
+}
+
+//============================================================================
+bool Socket::ReportsCcEvents() const
+{
+  return ((cfg_if_id_ == LAN) || (GetEnforcingCcAlg() != NULL));
+}
+
 //============================================================================
 void Socket::ScheduleDelayedAckEvent(Time& time_delta)
 {
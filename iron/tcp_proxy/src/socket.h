@@ -125,9 +125,11 @@ class SocketMgr;
 #define DUPACK_THRESH        3
 
 // Congestion control algorithms.
-#define NO_CONGESTION_CONTROL  0
-#define VJ_CONGESTION_CONTROL  1
-#define MAX_CC_ALG_CNT         2
+#define NO_CONGESTION_CONTROL     0
+#define VJ_CONGESTION_CONTROL     1
+#define CUBIC_CONGESTION_CONTROL  2
+#define BBR_CONGESTION_CONTROL    3
+#define MAX_CC_ALG_CNT            4
 
 #define PROXY_SEND_SYN         1
 #define PROXY_SEND_FIN         2
@@ -618,6 +620,22 @@ class Socket
     return desired_dscp_;
   }
 
+  /// \brief Set the Congestion Control Algorithm selected when the socket's
+  /// connection is established.
+  ///
+  /// \param  cc_alg  The Congestion Control Algorithm, one of the
+  ///                 *_CONGESTION_CONTROL values.
+  void set_cc_alg(int cc_alg);
+
+  /// \brief Get the Congestion Control Algorithm selected when the socket's
+  /// connection is established.
+  ///
+  /// \return The Congestion Control Algorithm.
+  inline int cc_alg() const
+  {
+    return cc_alg_;
+  }
+
   /// \brief Set the socket's state.
   ///
   /// \param  state  The socket's state.
@@ -666,6 +684,23 @@ class Socket
     seq_num_ = seq_num;
   }
 
+  /// \brief Set the socket's ACK number.
+  ///
+  /// \param  ack_num  The next sequence number expected from the remote
+  ///                  endpoint.
+  inline void set_ack_num(uint32_t ack_num)
+  {
+    ack_num_ = ack_num;
+  }
+
+  /// \brief Get the socket's ACK number.
+  ///
+  /// \return The next sequence number expected from the remote endpoint.
+  inline uint32_t ack_num() const
+  {
+    return ack_num_;
+  }
+
   /// \brief Set the socket's send una sequence number.
   ///
   /// \param  snd_una  The socket's send una sequence number.
@@ -818,6 +853,14 @@ class Socket
     timeout_ = timeout;
   }
 
+  /// \brief Set the socket's send scale.
+  ///
+  /// \param  snd_scale  The socket's send scale.
+  inline void set_snd_scale(int16_t snd_scale)
+  {
+    snd_scale_ = snd_scale;
+  }
+
   /// \brief Get the socket's send scale.
   ///
   /// \return The socket's send scale.
@@ -1090,6 +1133,16 @@ class Socket
   /// \return The number of bytes that were sent.
   uint32_t SendPkt(PktInfo* pkt_info);
 
+  /// \brief Send the TCP Proxy's queued LAN packets if a packet that is
+  /// about to be modified may be one of them.
+  ///
+  /// The LAN send batch holds a reference to each packet that it queues, so
+  /// a kept packet that is shared is flushed before it is modified.
+  ///
+  /// \param  pkt_info  Pointer to the PktInfo containing the packet that is
+  ///                   about to be modified.
+  void FlushIfQueuedForLan(PktInfo* pkt_info);
+
   /// \brief Process a packet received on a socket that is in the TCP_LISTEN
   /// state.
   ///
@@ -1270,6 +1323,29 @@ class Socket
   /// This is normally called when we are making changes to the selection.
   void ClearCcAlgSelection();
 
+  /// \brief Get the currently selected Congestion Control Algorithm.
+  ///
+  /// \return The selected Congestion Control Algorithm, or NULL if none is
+  ///         selected.
+  CongCtrlAlg* GetSelectedCcAlg() const;
+
+  /// \brief Get the selected Congestion Control Algorithm if it limits the
+  /// socket's transmissions.
+  ///
+  /// \return The selected Congestion Control Algorithm if it enforces its
+  ///         congestion window and pacing rate, NULL otherwise.
+  CongCtrlAlg* GetEnforcingCcAlg() const;
+
+  /// \brief Inquire whether ACKs, duplicate ACKs and timeouts are reported
+  /// to the Congestion Control Algorithms.
+  ///
+  /// LAN-facing sockets always report them. WAN-facing sockets are governed
+  /// by Admission Control, so they only report them when the selected
+  /// algorithm enforces its congestion window.
+  ///
+  /// \return True if the events are reported, false otherwise.
+  bool ReportsCcEvents() const;
+
   /// \brief Schedule a delayed ack event.
   ///
   /// \param  time_delta  The time delta from now when the event is to occur.
@@ -1554,6 +1630,14 @@ class Socket
   /// Array of pointers to the Congestion Control objects.
   CongCtrlAlg*              cc_algs_[MAX_CC_ALG_CNT];
 
+  /// The Congestion Control Algorithm selected when the connection is
+  /// established.
+  int                       cc_alg_;
+
+  /// The earliest time that the next packet may be sent at the selected
+  /// Congestion Control Algorithm's pacing rate.
+  iron::Time                next_pacing_time_;
+
   /// The last advertised window.
   uint32_t                  last_adv_wnd_;
 
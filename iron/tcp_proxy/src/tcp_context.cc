@@ -42,7 +42,8 @@ TcpContext::TcpContext()
     : lo_port_(1),
       hi_port_(65535),
       util_fn_defn_(""),
-      dscp_(-1)
+      dscp_(-1),
+      cc_alg_(-1)
 {
 }
 
@@ -52,7 +53,8 @@ TcpContext::TcpContext(int lo_port, int hi_port, std::string util_fn_defn,
     : lo_port_(lo_port),
       hi_port_(hi_port),
       util_fn_defn_(util_fn_defn),
-      dscp_(dscp)
+      dscp_(dscp),
+      cc_alg_(-1)
 {
 }
 
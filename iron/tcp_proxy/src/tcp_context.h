@@ -116,6 +116,27 @@ class TcpContext
     return dscp_;
   }
 
+  /// \brief  Set the Congestion Control Algorithm for the WAN-facing sockets
+  /// of this context's flows.
+  ///
+  /// \param  cc_alg  The Congestion Control Algorithm, one of the
+  ///                 *_CONGESTION_CONTROL values, or -1 to use the TCP
+  ///                 Proxy's default.
+  inline void set_cc_alg(int cc_alg)
+  {
+    cc_alg_ = cc_alg;
+  }
+
+  /// \brief  Get the Congestion Control Algorithm for the WAN-facing sockets
+  /// of this context's flows.
+  ///
+  /// \return The Congestion Control Algorithm, or -1 if the TCP Proxy's
+  ///         default is used.
+  inline int cc_alg() const
+  {
+    return cc_alg_;
+  }
+
   private:
 
   /// \brief Copy constructor.
@@ -133,6 +154,10 @@ class TcpContext
   /// DSCP value to add (or not, if -1) to packets.
   int8_t       dscp_;
 
+  /// Congestion Control Algorithm for the WAN-facing sockets (or the
+  /// default, if -1).
+  int          cc_alg_;
+
 }; // end class TcpContext
 
 #endif // IRON_TCP_PROXY_TCP_CONTEXT_H
@@ -150,9 +150,11 @@ TcpProxy::TcpProxy(TcpProxyConfig& proxy_config,
       proxy_config_(proxy_config),
       socket_mgr_(),
       pkt_info_pool_(packet_pool_),
+      lan_send_batch_(edge_if_, packet_pool_),
       timer_(),
       k_val_(),
       local_queue_depths_(bin_map_shm_),
+      log_utility_batch_(local_queue_depths_, k_val_),
       svc_configs_(),
       flow_utility_def_cache_(),
       context_dscp_cache_(),
@@ -514,6 +516,9 @@ void TcpProxy::MainLoop()
 
     num_recon_reqs_ = 0;
   }
+
+  // Send the packets sent to the LAN during this pass.
+  lan_send_batch_.Flush();
 }
 
 //============================================================================
@@ -523,9 +528,20 @@ void TcpProxy::Stop()
 }
 
 //============================================================================
-ssize_t TcpProxy::SendToLan(const Packet* pkt)
+ssize_t TcpProxy::SendToLan(Packet* pkt)
 {
-  return edge_if_.Send(pkt);
+  if (pkt == NULL)
+  {
+    LogE(kClassName, __func__, "Error: pkt was NULL.\n");
+    return -1;
+  }
+
+  // The socket keeps the packet for retransmission, so the batch is given a
+  // reference to it instead of a copy. The socket flushes the batch before
+  // it modifies a packet that is still queued.
+  packet_pool_.PacketShallowCopy(pkt);
+
+  return lan_send_batch_.Send(pkt);
 }
 
 //============================================================================
@@ -582,9 +598,11 @@ uint32_t TcpProxy::SimpleSendPkt(ProxyIfType out_if, PktInfo* pkt_info)
   {
     pkt_info->pkt->UpdateChecksums();
 
-    uint32_t bytes_written = edge_if_.Send(pkt_info->pkt);
+    // The batch takes ownership of the packet.
+    uint32_t bytes_written = lan_send_batch_.Send(pkt_info->pkt);
+    pkt_info->pkt          = NULL;
 
-    // Recycle the packet and delete its container.
+    // Delete the packet's container.
     pkt_info_pool_.Recycle(pkt_info);
 
     return bytes_written;
@@ -644,6 +662,10 @@ void TcpProxy::SvcSocketsTimeout()
   LogD(kClassName, __func__, "Servicing sockets, Queue depths are: %s.\n",
        local_queue_depths_.ToString().c_str());
 
+  // Compute the send rates of the sockets' Log utility functions in one
+  // pass.
+  log_utility_batch_.Evaluate();
+
   // Service all of the sockets.
   Socket*  iter = socket_mgr_.GetSocketList();
   while (iter != NULL)
@@ -747,6 +769,30 @@ int8_t TcpProxy::GetContextDscp(uint16_t port_hbo)
   return -1;
 }
 
+//============================================================================
+int TcpProxy::GetContextCcAlg(uint16_t port_hbo)
+{
+  map<int, TcpContext*>::reverse_iterator  iter;
+  for (iter = svc_configs_.rbegin(); iter != svc_configs_.rend(); ++iter)
+  {
+    if (iter->first <= port_hbo)
+    {
+      TcpContext*  context = iter->second;
+
+      if (context->hi_port() >= port_hbo)
+      {
+        return context->cc_alg();
+      }
+      else
+      {
+        return -1;
+      }
+    }
+  }
+
+  return -1;
+}
+
 //============================================================================
 void TcpProxy::PushStats()
 {
@@ -1552,6 +1598,14 @@ Socket* TcpProxy::CreateSocketPair(Packet* packet, ProxyIfType in_if,
     // the active_socket. We must do this after the socket's bin index has
     // been set.
     active_socket->ConfigureUtilityFn(utility_fn_def, local_queue_depths_);
+
+    // Select the Service's congestion control algorithm, if any, for the
+    // WAN side socket.
+    int  cc_alg = GetContextCcAlg(ntohs(four_tuple.dst_port_nbo()));
+    if (cc_alg != -1)
+    {
+      active_socket->set_cc_alg(cc_alg);
+    }
     LogI(kClassName, __func__, "Flow tag: %" PRIu32 " <==> %s\n", tag,
          four_tuple.ToString().c_str());
   }
@@ -1571,6 +1625,14 @@ Socket* TcpProxy::CreateSocketPair(Packet* packet, ProxyIfType in_if,
     // the passive_socket. We must do this after the socket's bin index has
     // been set.
     passive_socket->ConfigureUtilityFn(utility_fn_def, local_queue_depths_);
+
+    // Select the Service's congestion control algorithm, if any, for the
+    // WAN side socket.
+    int  cc_alg = GetContextCcAlg(ntohs(four_tuple.dst_port_nbo()));
+    if (cc_alg != -1)
+    {
+      passive_socket->set_cc_alg(cc_alg);
+    }
     LogI(kClassName, __func__, "Flow tag: %" PRIu32 " <==> %s\n", tag,
          four_tuple.ToString().c_str());
   }
@@ -2407,7 +2469,8 @@ TcpContext* TcpProxy::ParseService(char* command, TcpActionType action)
   int lo_port = atoi(p);
 
   // Get the next token
-  int8_t  dscp  = -1;
+  int8_t  dscp   = -1;
+  int     cc_alg = -1;
 
   if (action == TcpModAction)
   {
@@ -2464,8 +2527,9 @@ TcpContext* TcpProxy::ParseService(char* command, TcpActionType action)
       util_fn = string(p);
     }
 
-    // Get next token (if available) -- dscp value
-    if ((p = strtok(NULL, ";")) != NULL)
+    // Get the remaining tokens (if available) -- dscp value and congestion
+    // control algorithm
+    while ((p = strtok(NULL, ";")) != NULL)
     {
       // There is a string, look at it.
       string opt_tok = string(p);
@@ -2506,6 +2570,34 @@ TcpContext* TcpProxy::ParseService(char* command, TcpActionType action)
           }
         }
       }
+      else if (opt_tok.compare(0, 3, "cc=") == 0)
+      {
+        // The string starts with cc=. Means specifying the congestion
+        // control algorithm for the WAN-facing sockets.
+        string cc_str = opt_tok.substr(3, string::npos);
+
+        if (cc_str == "none")
+        {
+          cc_alg = NO_CONGESTION_CONTROL;
+        }
+        else if (cc_str == "vj")
+        {
+          cc_alg = VJ_CONGESTION_CONTROL;
+        }
+        else if (cc_str == "cubic")
+        {
+          cc_alg = CUBIC_CONGESTION_CONTROL;
+        }
+        else if (cc_str == "bbr")
+        {
+          cc_alg = BBR_CONGESTION_CONTROL;
+        }
+        else
+        {
+          LogW(kClassName, __func__, "Unsupported congestion control "
+               "algorithm %s, using default.\n", cc_str.c_str());
+        }
+      }
       else
       {
         // The string starts with something unsupported.  Drop it.
@@ -2517,6 +2609,7 @@ TcpContext* TcpProxy::ParseService(char* command, TcpActionType action)
 
   // If we are here, we successfully found all info needed for a context
   context = new TcpContext(lo_port, hi_port, util_fn, dscp);
+  context->set_cc_alg(cc_alg);
 
   return context;
 }
@@ -2564,6 +2657,7 @@ bool TcpProxy::ModService(TcpContext* ref_context)
       return false;
     }
 
+    context->set_cc_alg(ref_context->cc_alg());
     svc_configs_[context->lo_port()] = context;
     return true;
   }
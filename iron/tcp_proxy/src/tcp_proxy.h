@@ -41,10 +41,12 @@
 #define IRON_TCP_PROXY_TCP_PROXY_H
 
 #include "fifo_if.h"
+#include "edge_if_send_batch.h"
 #include "four_tuple.h"
 #include "hash_table.h"
 #include "ipv4_address.h"
 #include "k_val.h"
+#include "log_utility_batch.h"
 #include "packet.h"
 #include "packet_fifo.h"
 #include "packet_pool.h"
@@ -138,11 +140,27 @@ class TcpProxy
 
   /// \brief Send a Packet to the LAN side interface.
   ///
+  /// A reference to the packet is queued and the packet is sent, in order,
+  /// with the other packets sent to the LAN during the current pass of the
+  /// main loop. The caller retains ownership of the packet and must not
+  /// modify it while it is queued (see FlushLanSends()).
+  ///
   /// \param  pkt  Pointer to the Packet to be written to the LAN side
   ///              interface.
   ///
-  /// \return The number of bytes written to the LAN side interface.
-  ssize_t SendToLan(const iron::Packet* pkt);
+  /// \return The number of bytes queued for the LAN side interface, or -1
+  ///         on failure.
+  ssize_t SendToLan(iron::Packet* pkt);
+
+  /// \brief Send the packets queued for the LAN side interface.
+  ///
+  /// The queued packets are normally sent at the end of the current pass of
+  /// the main loop. A socket calls this before it modifies a packet that it
+  /// sent with SendToLan() and that may still be queued.
+  inline void FlushLanSends()
+  {
+    lan_send_batch_.Flush();
+  }
 
   /// \brief Send a Packet to the LAN side interface.
   ///
@@ -240,6 +258,20 @@ class TcpProxy
   ///         the provided port.
   int8_t GetContextDscp(uint16_t port_hbo);
 
+  /// \brief  Get the Congestion Control Algorithm for the provided
+  /// destination port.
+  ///
+  /// This lookup will search the Service definitions for a match. If there is
+  /// no Service defined for the provided port, or the Service does not
+  /// specify an algorithm, -1 is returned.
+  ///
+  /// \param  port_hbo  The target port for the lookup.
+  ///
+  /// \return The Congestion Control Algorithm for the WAN-facing socket, one
+  ///         of the *_CONGESTION_CONTROL values, or -1 if the TCP Proxy's
+  ///         default is to be used.
+  int GetContextCcAlg(uint16_t port_hbo);
+
   /// \brief Inquire if there is a Flow Utility function definition that
   /// matches the provided 4-tuple.
   ///
@@ -316,6 +348,15 @@ class TcpProxy
     return k_val_;
   }
 
+  /// \brief Get the batch that computes the send rates of the sockets' Log
+  /// utility functions.
+  ///
+  /// \return A reference to the Log utility function batch.
+  inline iron::LogUtilityBatch& log_utility_batch()
+  {
+    return log_utility_batch_;
+  }
+
   /// \brief Get the next scheduled time for servicing the sockets.
   ///
   /// \return The next scheduled time for servicing the sockets.
@@ -558,6 +599,10 @@ class TcpProxy
   /// The PktInfo pool.
   PktInfoPool                                    pkt_info_pool_;
 
+  /// The packets sent to the LAN during the current pass of the main loop,
+  /// which are sent together when the pass ends.
+  iron::EdgeIfSendBatch                          lan_send_batch_;
+
   /// The IRON timer.
   iron::Timer                                    timer_;
 
@@ -567,6 +612,10 @@ class TcpProxy
   /// QueueDepths object to store deserialized local QLAM.
   iron::QueueDepths                              local_queue_depths_;
 
+  /// The send rates of the sockets' Log utility functions, which are
+  /// computed together each time the sockets are serviced.
+  iron::LogUtilityBatch                          log_utility_batch_;
+
   /// Collection of Service context information.
   std::map<int, TcpContext*>                     svc_configs_;
 
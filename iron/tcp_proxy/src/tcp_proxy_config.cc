@@ -38,6 +38,7 @@
 //============================================================================
 
 #include "tcp_proxy_config.h"
+#include "iron_constants.h"
 #include "log.h"
 #include "string_utils.h"
 #include "unused.h"
@@ -133,6 +134,10 @@ namespace
   /// Default WAN interface sack.
   const int       kDefaultWanIfSack = 1;
 
+  /// Default maximum coalesced WAN segment payload size, in bytes. Zero
+  /// disables coalescing.
+  const uint32_t  kDefaultWanCoalesceBytes = 0;
+
   /// Default RTT max shift.
   const int       kDefaultRttMaxShift = 12;
 }
@@ -142,7 +147,8 @@ TcpProxyConfig::TcpProxyConfig()
     : lan_if_cfg_(),
       wan_if_cfg_(),
       rtt_max_shift_(kDefaultRttMaxShift),
-      adaptive_buffers_(kDefaultAdaptiveBuffers)
+      adaptive_buffers_(kDefaultAdaptiveBuffers),
+      wan_coalesce_bytes_(kDefaultWanCoalesceBytes)
 {
 }
 
@@ -233,6 +239,18 @@ void TcpProxyConfig::LoadWanIfInfo(const ConfigInfo& config_info,
   // Extract the MTU size, in bytes.
   wan_if_config.mtu = config_info.GetUint("MtuBytes", kDefaultMtuBytes);
 
+  // Extract the maximum coalesced WAN segment payload size, in bytes. A
+  // coalesced segment must still fit in a single Packet.
+  wan_coalesce_bytes_ = config_info.GetUint("WanCoalesceBytes",
+                                            kDefaultWanCoalesceBytes);
+  if (wan_coalesce_bytes_ > iron::kMaxPacketSizeBytes)
+  {
+    LogW(kClassName, __func__, "WanCoalesceBytes %" PRIu32 " exceeds the "
+         "maximum packet size, using %zu bytes.\n", wan_coalesce_bytes_,
+         iron::kMaxPacketSizeBytes);
+    wan_coalesce_bytes_ = iron::kMaxPacketSizeBytes;
+  }
+
   // Set the remaining values in the TcpProxyIfConfig structure for the WAN
   // interface to the default values. We don't provide the ability to change
   // the configuration of the remaining values.
@@ -251,5 +269,7 @@ void TcpProxyConfig::LoadWanIfInfo(const ConfigInfo& config_info,
   LogC(kClassName, __func__, "BufferBytes    : %" PRId32 " bytes\n",
        wan_if_cfg_.bufSize);
   LogC(kClassName, __func__, "MtuBytes       : %d bytes\n", wan_if_cfg_.mtu);
+  LogC(kClassName, __func__, "WanCoalesceBytes: %" PRIu32 " bytes\n",
+       wan_coalesce_bytes_);
   LogC(kClassName, __func__, "TCP Proxy WAN configuration complete.\n");
 }
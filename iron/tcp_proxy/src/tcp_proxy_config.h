@@ -209,6 +209,15 @@ class TcpProxyConfig
     return adaptive_buffers_;
   }
 
+  /// \brief Get the maximum payload size of a coalesced WAN segment.
+  ///
+  /// \return The maximum TCP payload size, in bytes, of a segment coalesced
+  ///         on the WAN side. Zero indicates that coalescing is disabled.
+  uint32_t wan_coalesce_bytes() const
+  {
+    return wan_coalesce_bytes_;
+  }
+
   private:
 
   /// \brief Copy constructor.
@@ -274,6 +283,10 @@ class TcpProxyConfig
   /// Remembers if the proxy is using adaptive buffers or not.
   bool            adaptive_buffers_;
 
+  /// The maximum TCP payload size, in bytes, of a segment coalesced from
+  /// contiguous in-order data on the WAN side. Zero disables coalescing.
+  uint32_t        wan_coalesce_bytes_;
+
 }; // end class TcpProxyConfig
 
 #endif // IRON_TCP_PROXY_CONFIG_H
@@ -0,0 +1,358 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+// Test cases for the TCP Proxy out-of-sequence buffer.
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "out_seq_buffer.h"
+#include "pkt_info.h"
+#include "pkt_info_pool.h"
+#include "socket.h"
+#include "socket_mgr.h"
+#include "tcp_proxy.h"
+#include "tcp_proxy_config.h"
+
+#include "bin_map.h"
+#include "config_info.h"
+#include "failing_edge_if.h"
+#include "log.h"
+#include "packet_pool_heap.h"
+#include "pseudo_fifo.h"
+#include "pseudo_shared_memory.h"
+
+#include <netinet/tcp.h>
+#include <string.h>
+
+using ::iron::BinMap;
+using ::iron::ConfigInfo;
+using ::iron::FailingEdgeIf;
+using ::iron::Log;
+using ::iron::PacketPoolHeap;
+using ::iron::PseudoFifo;
+using ::iron::PseudoSharedMemory;
+using ::iron::RemoteControlServer;
+
+namespace
+{
+  /// The maximum size of the out-of-sequence buffer used in the tests.
+  const uint32_t  kBufferSize = 65536;
+
+  const int       kPoolSize = 100;
+}
+
+//============================================================================
+class OutSeqBufferTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(OutSeqBufferTest);
+
+  CPPUNIT_TEST(TestOutOfOrderInsert);
+  CPPUNIT_TEST(TestOverlappingSegments);
+  CPPUNIT_TEST(TestInsertAfterDequeue);
+
+  CPPUNIT_TEST_SUITE_END();
+
+  private:
+
+  TcpProxyConfig*       tcp_proxy_config_;
+  PacketPoolHeap*       packet_pool_;
+  PktInfoPool*          pkt_info_pool_;
+  FailingEdgeIf*        edge_if_;
+  char*                 bin_map_mem_;
+  BinMap*               bin_map_;
+  PseudoSharedMemory*   weight_qd_shared_memory_;
+  PseudoFifo*           bpf_to_tcp_pkt_fifo_;
+  PseudoFifo*           tcp_to_bpf_pkt_fifo_;
+  RemoteControlServer*  remote_control_server_;
+  TcpProxy*             tcp_proxy_;
+  SocketMgr*            socket_mgr_;
+  Socket*               socket_;
+  OutSeqBuffer*         out_seq_buf_;
+
+  public:
+
+  //==========================================================================
+  void setUp()
+  {
+    Log::SetDefaultLevel("F");
+
+    tcp_proxy_config_ = new TcpProxyConfig();
+
+    packet_pool_ = new PacketPoolHeap();
+    packet_pool_->Create(kPoolSize);
+
+    pkt_info_pool_ = new PktInfoPool(*packet_pool_);
+    edge_if_       = new FailingEdgeIf(true);
+
+    bin_map_mem_ = new char[sizeof(BinMap)];
+    bin_map_     = reinterpret_cast<BinMap*>(bin_map_mem_);
+    memset(bin_map_mem_, 0, sizeof(BinMap));
+
+    ConfigInfo  ci;
+    ci.Add("BinMap.BinIds", "1,2");
+    ci.Add("BinMap.BinId.1.IronNodeAddr", "172.24.1.2");
+    ci.Add("BinMap.BinId.1.HostMasks", "172.24.1.0/24");
+    ci.Add("BinMap.BinId.2.IronNodeAddr", "172.24.2.2");
+    ci.Add("BinMap.BinId.2.HostMasks", "172.24.2.0/24");
+    CPPUNIT_ASSERT(bin_map_->Initialize(ci));
+
+    weight_qd_shared_memory_ = new PseudoSharedMemory();
+    bpf_to_tcp_pkt_fifo_     = new PseudoFifo();
+    tcp_to_bpf_pkt_fifo_     = new PseudoFifo();
+    remote_control_server_   = new RemoteControlServer();
+
+    tcp_proxy_ = new TcpProxy(*tcp_proxy_config_, *packet_pool_, *edge_if_,
+                              *bin_map_, *weight_qd_shared_memory_,
+                              bpf_to_tcp_pkt_fifo_, tcp_to_bpf_pkt_fifo_,
+                              *remote_control_server_);
+    socket_mgr_ = new SocketMgr();
+    socket_     = new Socket(*tcp_proxy_, *packet_pool_, *bin_map_,
+                             *pkt_info_pool_, *tcp_proxy_config_,
+                             *socket_mgr_);
+
+    out_seq_buf_ = new OutSeqBuffer(*pkt_info_pool_, kBufferSize, socket_);
+  }
+
+  //==========================================================================
+  void tearDown()
+  {
+    delete out_seq_buf_;
+    out_seq_buf_ = NULL;
+
+    delete socket_;
+    socket_ = NULL;
+
+    delete socket_mgr_;
+    socket_mgr_ = NULL;
+
+    delete tcp_proxy_;
+    tcp_proxy_ = NULL;
+
+    delete remote_control_server_;
+    remote_control_server_ = NULL;
+
+    delete tcp_to_bpf_pkt_fifo_;
+    tcp_to_bpf_pkt_fifo_ = NULL;
+
+    delete bpf_to_tcp_pkt_fifo_;
+    bpf_to_tcp_pkt_fifo_ = NULL;
+
+    delete weight_qd_shared_memory_;
+    weight_qd_shared_memory_ = NULL;
+
+    delete [] bin_map_mem_;
+    bin_map_mem_ = NULL;
+    bin_map_     = NULL;
+
+    delete edge_if_;
+    edge_if_ = NULL;
+
+    delete pkt_info_pool_;
+    pkt_info_pool_ = NULL;
+
+    delete packet_pool_;
+    packet_pool_ = NULL;
+
+    delete tcp_proxy_config_;
+    tcp_proxy_config_ = NULL;
+
+    Log::SetDefaultLevel("FEW");
+  }
+
+  //==========================================================================
+  PktInfo* CreatePkt(uint32_t seq_num, uint32_t data_len)
+  {
+    PktInfo*  pkt_info = pkt_info_pool_->Get();
+
+    pkt_info->seq_num  = seq_num;
+    pkt_info->data_len = data_len;
+    pkt_info->flags    = TH_ACK;
+
+    return pkt_info;
+  }
+
+  //==========================================================================
+  void CheckOrder(const uint32_t* seq_nums, const uint32_t* data_lens,
+                  size_t num_pkts)
+  {
+    PktInfo*  pkt_info = out_seq_buf_->head();
+    size_t    bytes    = 0;
+
+    for (size_t i = 0; i < num_pkts; ++i)
+    {
+      CPPUNIT_ASSERT(pkt_info != NULL);
+      CPPUNIT_ASSERT_EQUAL(seq_nums[i], pkt_info->seq_num);
+      CPPUNIT_ASSERT_EQUAL(data_lens[i], pkt_info->data_len);
+      CPPUNIT_ASSERT((i == 0) || (pkt_info->prev->next == pkt_info));
+
+      bytes    += pkt_info->data_len;
+      pkt_info  = pkt_info->next;
+    }
+
+    CPPUNIT_ASSERT(pkt_info == NULL);
+    CPPUNIT_ASSERT_EQUAL(bytes, out_seq_buf_->size_bytes());
+  }
+
+  //==========================================================================
+  void CheckPlugs(const uint32_t* lower_seqs, const uint32_t* upper_seqs,
+                  size_t num_plugs)
+  {
+    OutSeqBuffer::PlugInfo  plugs[8];
+
+    CPPUNIT_ASSERT_EQUAL(num_plugs, out_seq_buf_->GatherPlugs(plugs, 8));
+
+    for (size_t i = 0; i < num_plugs; ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(lower_seqs[i], plugs[i].lower_seq);
+      CPPUNIT_ASSERT_EQUAL(upper_seqs[i], plugs[i].upper_seq);
+    }
+  }
+
+  //==========================================================================
+  void TestOutOfOrderInsert()
+  {
+    // Insert four segments, none of them in order. The sequence numbers
+    // wrap around.
+    uint32_t  base = 0xffffff00;
+
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(base + 600, 100)));
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(base + 200, 100)));
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(base + 400, 100)));
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(base + 300, 100)));
+
+    uint32_t  seq_nums[]  = {base + 200, base + 300, base + 400, base + 600};
+    uint32_t  data_lens[] = {100, 100, 100, 100};
+    CheckOrder(seq_nums, data_lens, 4);
+
+    // The segments that touch form a single plug.
+    uint32_t  lower_seqs[] = {base + 200, base + 600};
+    uint32_t  upper_seqs[] = {base + 500, base + 700};
+    CheckPlugs(lower_seqs, upper_seqs, 2);
+
+    OutSeqBuffer::PlugInfo  plug;
+    CPPUNIT_ASSERT(out_seq_buf_->GetPlugCoveringLastPkt(plug));
+    CPPUNIT_ASSERT_EQUAL(base + 200, plug.lower_seq);
+    CPPUNIT_ASSERT_EQUAL(base + 500, plug.upper_seq);
+
+    // An exact duplicate is rejected, and the caller keeps it.
+    PktInfo*  dup_pkt_info = CreatePkt(base + 300, 100);
+    CPPUNIT_ASSERT(!out_seq_buf_->Insert(dup_pkt_info));
+    pkt_info_pool_->Recycle(dup_pkt_info);
+    CheckOrder(seq_nums, data_lens, 4);
+  }
+
+  //==========================================================================
+  void TestOverlappingSegments()
+  {
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(2000, 500)));
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(3000, 500)));
+
+    // A segment that overlaps both of them bridges the gap, so the plugs
+    // are merged.
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(2400, 700)));
+
+    uint32_t  seq_nums[]  = {2000, 2400, 3000};
+    uint32_t  data_lens[] = {500, 700, 500};
+    CheckOrder(seq_nums, data_lens, 3);
+
+    uint32_t  lower_seqs[] = {2000};
+    uint32_t  upper_seqs[] = {3500};
+    CheckPlugs(lower_seqs, upper_seqs, 1);
+
+    // A retransmission with the same sequence number as an existing segment
+    // but more data is kept next to it, and extends the plug.
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(3000, 800)));
+
+    uint32_t  seq_nums2[]  = {2000, 2400, 3000, 3000};
+    uint32_t  data_lens2[] = {500, 700, 500, 800};
+    CheckOrder(seq_nums2, data_lens2, 4);
+
+    uint32_t  upper_seqs2[] = {3800};
+    CheckPlugs(lower_seqs, upper_seqs2, 1);
+
+    // A zero-length segment does not create a plug.
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(5000, 0)));
+    CheckPlugs(lower_seqs, upper_seqs2, 1);
+  }
+
+  //==========================================================================
+  void TestInsertAfterDequeue()
+  {
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(1000, 100)));
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(1100, 100)));
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(1400, 100)));
+
+    // Move the head to the send buffer, as is done once the data before it
+    // has been received. The first plug now starts at the new head.
+    PktInfo*  pkt_info = out_seq_buf_->Dequeue();
+    CPPUNIT_ASSERT(pkt_info != NULL);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(1000), pkt_info->seq_num);
+    pkt_info_pool_->Recycle(pkt_info);
+
+    uint32_t  lower_seqs[] = {1100, 1400};
+    uint32_t  upper_seqs[] = {1200, 1500};
+    CheckPlugs(lower_seqs, upper_seqs, 2);
+
+    // The released sequence number is no longer indexed, so a late copy of
+    // the dequeued segment is inserted in front of the new head instead of
+    // being treated as a duplicate.
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(1000, 100)));
+    CPPUNIT_ASSERT(out_seq_buf_->Insert(CreatePkt(1300, 100)));
+
+    uint32_t  seq_nums[]  = {1000, 1100, 1300, 1400};
+    uint32_t  data_lens[] = {100, 100, 100, 100};
+    CheckOrder(seq_nums, data_lens, 4);
+
+    uint32_t  lower_seqs2[] = {1000, 1300};
+    uint32_t  upper_seqs2[] = {1200, 1500};
+    CheckPlugs(lower_seqs2, upper_seqs2, 2);
+
+    // Empty the buffer. Nothing is left behind in the plugs.
+    for (int i = 0; i < 4; ++i)
+    {
+      pkt_info = out_seq_buf_->Dequeue();
+      CPPUNIT_ASSERT(pkt_info != NULL);
+      pkt_info_pool_->Recycle(pkt_info);
+    }
+
+    CPPUNIT_ASSERT(out_seq_buf_->head() == NULL);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), out_seq_buf_->size_bytes());
+    CheckPlugs(lower_seqs2, upper_seqs2, 0);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OutSeqBufferTest);
@@ -0,0 +1,486 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+// Test cases for the TCP Proxy send buffer.
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "send_buffer.h"
+#include "out_seq_buffer.h"
+#include "pkt_info.h"
+#include "pkt_info_pool.h"
+#include "socket.h"
+#include "socket_mgr.h"
+#include "tcp_proxy.h"
+#include "tcp_proxy_config.h"
+
+#include "bin_map.h"
+#include "config_info.h"
+#include "failing_edge_if.h"
+#include "itime.h"
+#include "log.h"
+#include "packet.h"
+#include "packet_pool_heap.h"
+#include "pseudo_fifo.h"
+#include "pseudo_shared_memory.h"
+
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/tcp.h>
+#include <string.h>
+
+using ::iron::BinMap;
+using ::iron::ConfigInfo;
+using ::iron::FailingEdgeIf;
+using ::iron::Log;
+using ::iron::Packet;
+using ::iron::PacketPoolHeap;
+using ::iron::PseudoFifo;
+using ::iron::PseudoSharedMemory;
+using ::iron::RemoteControlServer;
+using ::iron::Time;
+
+namespace
+{
+  /// The sequence number of the first byte of data in the tests.
+  const uint32_t  kIsn = 1000;
+
+  /// The maximum coalesced segment size used in the tests.
+  const uint32_t  kCoalesceBytes = 1000;
+
+  /// The MSS offered by the LAN application in the tests. It is small
+  /// enough that a coalesced segment spans several LAN segments.
+  const uint32_t  kLanMss = 536;
+
+  const int       kPoolSize = 100;
+}
+
+//============================================================================
+class SendBufferTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(SendBufferTest);
+
+  CPPUNIT_TEST(TestCoalesceContiguous);
+  CPPUNIT_TEST(TestCoalesceStopsAtGap);
+  CPPUNIT_TEST(TestResegment);
+  CPPUNIT_TEST(TestResegmentFailure);
+  CPPUNIT_TEST(TestPlugsAfterTrim);
+
+  CPPUNIT_TEST_SUITE_END();
+
+  private:
+
+  TcpProxyConfig*       tcp_proxy_config_;
+  PacketPoolHeap*       packet_pool_;
+  PktInfoPool*          pkt_info_pool_;
+  FailingEdgeIf*        edge_if_;
+  char*                 bin_map_mem_;
+  BinMap*               bin_map_;
+  PseudoSharedMemory*   weight_qd_shared_memory_;
+  PseudoFifo*           bpf_to_tcp_pkt_fifo_;
+  PseudoFifo*           tcp_to_bpf_pkt_fifo_;
+  RemoteControlServer*  remote_control_server_;
+  TcpProxy*             tcp_proxy_;
+  SocketMgr*            socket_mgr_;
+  Socket*               socket_;
+
+  public:
+
+  //==========================================================================
+  void setUp()
+  {
+    Log::SetDefaultLevel("F");
+
+    tcp_proxy_config_ = new TcpProxyConfig();
+
+    packet_pool_ = new PacketPoolHeap();
+    packet_pool_->Create(kPoolSize);
+
+    pkt_info_pool_ = new PktInfoPool(*packet_pool_);
+    edge_if_       = new FailingEdgeIf(true);
+
+    bin_map_mem_ = new char[sizeof(BinMap)];
+    bin_map_     = reinterpret_cast<BinMap*>(bin_map_mem_);
+    memset(bin_map_mem_, 0, sizeof(BinMap));
+
+    ConfigInfo  ci;
+    ci.Add("BinMap.BinIds", "1,2");
+    ci.Add("BinMap.BinId.1.IronNodeAddr", "172.24.1.2");
+    ci.Add("BinMap.BinId.1.HostMasks", "172.24.1.0/24");
+    ci.Add("BinMap.BinId.2.IronNodeAddr", "172.24.2.2");
+    ci.Add("BinMap.BinId.2.HostMasks", "172.24.2.0/24");
+    CPPUNIT_ASSERT(bin_map_->Initialize(ci));
+
+    weight_qd_shared_memory_ = new PseudoSharedMemory();
+    bpf_to_tcp_pkt_fifo_     = new PseudoFifo();
+    tcp_to_bpf_pkt_fifo_     = new PseudoFifo();
+    remote_control_server_   = new RemoteControlServer();
+
+    tcp_proxy_ = new TcpProxy(*tcp_proxy_config_, *packet_pool_, *edge_if_,
+                              *bin_map_, *weight_qd_shared_memory_,
+                              bpf_to_tcp_pkt_fifo_, tcp_to_bpf_pkt_fifo_,
+                              *remote_control_server_);
+    socket_mgr_ = new SocketMgr();
+
+    // The send buffer under test belongs to a LAN-facing socket. It is flow
+    // control blocked, as its peer has not advertised a window, so nothing
+    // that is enqueued is transmitted.
+    socket_ = new Socket(*tcp_proxy_, *packet_pool_, *bin_map_,
+                         *pkt_info_pool_, *tcp_proxy_config_, *socket_mgr_);
+    socket_->set_cfg_if_id(LAN);
+    socket_->SetMss(kLanMss);
+    socket_->send_buf()->init_una_seq(kIsn);
+  }
+
+  //==========================================================================
+  void tearDown()
+  {
+    delete socket_;
+    socket_ = NULL;
+
+    delete socket_mgr_;
+    socket_mgr_ = NULL;
+
+    delete tcp_proxy_;
+    tcp_proxy_ = NULL;
+
+    delete remote_control_server_;
+    remote_control_server_ = NULL;
+
+    delete tcp_to_bpf_pkt_fifo_;
+    tcp_to_bpf_pkt_fifo_ = NULL;
+
+    delete bpf_to_tcp_pkt_fifo_;
+    bpf_to_tcp_pkt_fifo_ = NULL;
+
+    delete weight_qd_shared_memory_;
+    weight_qd_shared_memory_ = NULL;
+
+    delete [] bin_map_mem_;
+    bin_map_mem_ = NULL;
+    bin_map_     = NULL;
+
+    delete edge_if_;
+    edge_if_ = NULL;
+
+    delete pkt_info_pool_;
+    pkt_info_pool_ = NULL;
+
+    delete packet_pool_;
+    packet_pool_ = NULL;
+
+    delete tcp_proxy_config_;
+    tcp_proxy_config_ = NULL;
+
+    Log::SetDefaultLevel("FEW");
+  }
+
+  //==========================================================================
+  PktInfo* CreatePkt(uint32_t seq_num, uint32_t data_len, uint8_t flags)
+  {
+    // Each data byte holds the low order byte of its sequence number, so
+    // that the data can be verified after it has been coalesced or split.
+    PktInfo*  pkt_info = pkt_info_pool_->Get();
+    Packet*   pkt      = pkt_info->pkt;
+    size_t    hdr_len  = sizeof(struct iphdr) + sizeof(struct tcphdr);
+
+    CPPUNIT_ASSERT(pkt->SetLengthInBytes(hdr_len + data_len));
+    memset(pkt->GetBuffer(), 0, hdr_len);
+
+    struct iphdr*  ip_hdr = reinterpret_cast<struct iphdr*>(pkt->GetBuffer());
+    ip_hdr->version  = 4;
+    ip_hdr->ihl      = 5;
+    ip_hdr->ttl      = 64;
+    ip_hdr->protocol = IPPROTO_TCP;
+    ip_hdr->tot_len  = htons(hdr_len + data_len);
+    ip_hdr->saddr    = htonl(0xac180101);
+    ip_hdr->daddr    = htonl(0xac180201);
+
+    struct tcphdr*  tcp_hdr = pkt->GetTcpHdr();
+    tcp_hdr->th_sport = htons(30000);
+    tcp_hdr->th_dport = htons(29778);
+    tcp_hdr->th_seq   = htonl(seq_num);
+    tcp_hdr->th_off   = 5;
+    tcp_hdr->th_flags = flags;
+    tcp_hdr->th_win   = htons(0xffff);
+
+    uint8_t*  data = pkt->GetBuffer(hdr_len);
+    for (uint32_t i = 0; i < data_len; ++i)
+    {
+      data[i] = static_cast<uint8_t>(seq_num + i);
+    }
+
+    pkt_info->seq_num  = seq_num;
+    pkt_info->data_len = data_len;
+    pkt_info->flags    = flags;
+
+    return pkt_info;
+  }
+
+  //==========================================================================
+  void CheckPkt(const PktInfo* pkt_info, uint32_t seq_num, uint32_t data_len)
+  {
+    Packet*         pkt     = pkt_info->pkt;
+    struct tcphdr*  tcp_hdr = pkt->GetTcpHdr();
+    size_t          hdr_len = pkt->GetIpPayloadOffset();
+
+    CPPUNIT_ASSERT_EQUAL(seq_num, pkt_info->seq_num);
+    CPPUNIT_ASSERT_EQUAL(data_len, pkt_info->data_len);
+    CPPUNIT_ASSERT_EQUAL(seq_num, static_cast<uint32_t>(
+                           ntohl(tcp_hdr->th_seq)));
+    CPPUNIT_ASSERT_EQUAL(hdr_len + data_len, pkt->GetLengthInBytes());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(hdr_len + data_len),
+                         static_cast<size_t>(
+                           ntohs(reinterpret_cast<struct iphdr*>(
+                                   pkt->GetBuffer())->tot_len)));
+
+    const uint8_t*  data = pkt->GetBuffer(hdr_len);
+    for (uint32_t i = 0; i < data_len; ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(seq_num + i), data[i]);
+    }
+  }
+
+  //==========================================================================
+  size_t CountPkts()
+  {
+    size_t  cnt = 0;
+    for (PktInfo* pkt_info = socket_->send_buf()->snd_una();
+         pkt_info != NULL; pkt_info = pkt_info->next)
+    {
+      ++cnt;
+    }
+
+    return cnt;
+  }
+
+  //==========================================================================
+  void TestCoalesceContiguous()
+  {
+    SendBuffer*  send_buf = socket_->send_buf();
+    send_buf->set_max_coalesce_bytes(kCoalesceBytes);
+
+    CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn, 100, TH_ACK)));
+    CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn + 100, 200, TH_ACK)));
+    CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn + 300, 300,
+                                               TH_ACK | TH_PUSH)));
+
+    // The three segments are merged into the first one, which picks up the
+    // PSH flag.
+    PktInfo*  head = send_buf->snd_una();
+    CPPUNIT_ASSERT(head != NULL);
+    CPPUNIT_ASSERT(head == send_buf->snd_nxt());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), CountPkts());
+    CheckPkt(head, kIsn, 600);
+    CPPUNIT_ASSERT(head->flags & TH_PUSH);
+    CPPUNIT_ASSERT(head->pkt->GetTcpHdr()->th_flags & TH_PUSH);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(600),
+                         send_buf->BytesInBuffer());
+
+    // A segment that would exceed the maximum coalesced size starts a new
+    // packet.
+    CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn + 600, 450, TH_ACK)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), CountPkts());
+    CheckPkt(head, kIsn, 600);
+    CheckPkt(head->next, kIsn + 600, 450);
+  }
+
+  //==========================================================================
+  void TestCoalesceStopsAtGap()
+  {
+    SendBuffer*  send_buf = socket_->send_buf();
+    send_buf->set_max_coalesce_bytes(kCoalesceBytes);
+
+    // Data that does not start where the tail's data ends is never merged.
+    CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn, 100, TH_ACK)));
+    CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn + 150, 100, TH_ACK)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), CountPkts());
+
+    // Contiguous data after the gap is merged into the new tail.
+    CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn + 250, 50, TH_ACK)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), CountPkts());
+
+    PktInfo*  head = send_buf->snd_una();
+    CheckPkt(head, kIsn, 100);
+    CheckPkt(head->next, kIsn + 150, 150);
+
+    // A FIN is never merged.
+    CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn + 300, 10,
+                                               TH_ACK | TH_FIN)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), CountPkts());
+    CheckPkt(head->next->next, kIsn + 300, 10);
+  }
+
+  //==========================================================================
+  void TestResegment()
+  {
+    SendBuffer*  send_buf = socket_->send_buf();
+    uint32_t     max_data = socket_->max_data();
+    uint32_t     data_len = (2 * max_data) + (max_data / 2);
+
+    CPPUNIT_ASSERT(max_data > 0);
+
+    // A segment that is larger than the socket's maximum data size is split
+    // up. Only the last segment keeps the PSH and FIN flags.
+    CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn, data_len,
+                                               TH_ACK | TH_PUSH | TH_FIN)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), CountPkts());
+    CPPUNIT_ASSERT_EQUAL(data_len, send_buf->BytesInBuffer());
+
+    PktInfo*  pkt_info = send_buf->snd_una();
+    CPPUNIT_ASSERT(pkt_info == send_buf->snd_nxt());
+    CheckPkt(pkt_info, kIsn, max_data);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(TH_ACK), pkt_info->flags);
+
+    pkt_info = pkt_info->next;
+    CheckPkt(pkt_info, kIsn + max_data, max_data);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(TH_ACK), pkt_info->flags);
+
+    pkt_info = pkt_info->next;
+    CheckPkt(pkt_info, kIsn + (2 * max_data), max_data / 2);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(TH_ACK | TH_PUSH | TH_FIN),
+                         pkt_info->flags);
+    CPPUNIT_ASSERT(pkt_info->next == NULL);
+  }
+
+  //==========================================================================
+  void TestResegmentFailure()
+  {
+    SendBuffer*  send_buf = socket_->send_buf();
+    uint32_t     max_data = socket_->max_data();
+
+    CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn, 10, TH_ACK | TH_FIN)));
+
+    size_t  free_pkts = packet_pool_->GetSize();
+
+    // A segment that would have been split up cannot follow the FIN. None of
+    // its segments may be left in the send buffer, as the caller keeps the
+    // packet and recycles it.
+    PktInfo*  pkt_info = CreatePkt(kIsn + 10, 3 * max_data,
+                                   TH_ACK | TH_FIN);
+    CPPUNIT_ASSERT(!send_buf->Enqueue(pkt_info));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), CountPkts());
+    CPPUNIT_ASSERT(send_buf->snd_una()->next == NULL);
+    pkt_info_pool_->Recycle(pkt_info);
+
+    // The same holds if the segment does not fit in the send buffer.
+    pkt_info = CreatePkt(send_buf->uwe() - max_data, 3 * max_data, TH_ACK);
+    CPPUNIT_ASSERT(!send_buf->Enqueue(pkt_info));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), CountPkts());
+    pkt_info_pool_->Recycle(pkt_info);
+
+    // No packets are leaked.
+    CPPUNIT_ASSERT_EQUAL(free_pkts, packet_pool_->GetSize());
+  }
+
+  //==========================================================================
+  void TestPlugsAfterTrim()
+  {
+    SendBuffer*  send_buf  = socket_->send_buf();
+    size_t       free_pkts = packet_pool_->GetSize();
+
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+      CPPUNIT_ASSERT(send_buf->Enqueue(CreatePkt(kIsn + (i * 100), 100,
+                                                 TH_ACK)));
+    }
+
+    // An ACK releases the first two packets.
+    send_buf->Trim(kIsn + 200);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), CountPkts());
+    CPPUNIT_ASSERT_EQUAL(kIsn + 200, send_buf->snd_una()->seq_num);
+
+    // SACK blocks release the packets that they cover, one of them spanning
+    // two packets, and mark the packets before them as holes.
+    OutSeqBuffer::PlugInfo  plugs[2];
+    plugs[0].lower_seq = kIsn + 300;
+    plugs[0].upper_seq = kIsn + 500;
+    plugs[1].lower_seq = kIsn + 600;
+    plugs[1].upper_seq = kIsn + 700;
+
+    bool  buf_changed = false;
+    send_buf->ProcessPlugs(plugs, 2, buf_changed);
+    CPPUNIT_ASSERT(buf_changed);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), CountPkts());
+
+    PktInfo*  pkt_info = send_buf->snd_una();
+    CheckPkt(pkt_info, kIsn + 200, 100);
+    CPPUNIT_ASSERT(!pkt_info->rexmit_time.IsInfinite());
+    CheckPkt(pkt_info->next, kIsn + 500, 100);
+    CPPUNIT_ASSERT(!pkt_info->next->rexmit_time.IsInfinite());
+    CheckPkt(pkt_info->next->next, kIsn + 700, 100);
+    CPPUNIT_ASSERT(pkt_info->next->next->rexmit_time.IsInfinite());
+
+    // A stale SACK block for data that has already been ACKed finds
+    // nothing, as the released packets are no longer indexed.
+    plugs[0].lower_seq = kIsn;
+    plugs[0].upper_seq = kIsn + 100;
+
+    buf_changed = false;
+    send_buf->ProcessPlugs(plugs, 1, buf_changed);
+    CPPUNIT_ASSERT(!buf_changed);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), CountPkts());
+
+    // An ACK releases the first hole, which leaves the retransmission list.
+    // The remaining hole is the next packet to be retransmitted once its
+    // retransmission time has passed.
+    send_buf->Trim(kIsn + 500);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), CountPkts());
+
+    Time      later    = Time::Now().Add(3600.0);
+    PktInfo*  next_pkt = send_buf->GetNextTransmission(later, kIsn + 10000,
+                                                       LAN);
+    CPPUNIT_ASSERT(next_pkt == send_buf->snd_una());
+    CheckPkt(next_pkt, kIsn + 500, 100);
+
+    // A SACK block for the last packet is found after the earlier packets
+    // have been released.
+    plugs[0].lower_seq = kIsn + 700;
+    plugs[0].upper_seq = kIsn + 800;
+
+    buf_changed = false;
+    send_buf->ProcessPlugs(plugs, 1, buf_changed);
+    CPPUNIT_ASSERT(buf_changed);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), CountPkts());
+
+    send_buf->Trim(kIsn + 800);
+    CPPUNIT_ASSERT(send_buf->snd_una() == NULL);
+    CPPUNIT_ASSERT_EQUAL(free_pkts, packet_pool_->GetSize());
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SendBufferTest);
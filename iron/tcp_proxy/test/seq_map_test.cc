@@ -0,0 +1,192 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+// Test cases for the sequence number keyed map.
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "seq_map.h"
+
+#include <map>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace
+{
+  /// A starting sequence number that forces the keys to wrap.
+  const uint32_t  kWrapSeq = 0xfffff000;
+}
+
+//============================================================================
+class SeqMapTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE(SeqMapTest);
+
+  CPPUNIT_TEST(TestInsertFind);
+  CPPUNIT_TEST(TestNeighbors);
+  CPPUNIT_TEST(TestRandomOps);
+
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  //==========================================================================
+  void TestInsertFind()
+  {
+    SeqMap<int>  seq_map;
+    int          value = 0;
+    uint32_t     key   = 0;
+
+    CPPUNIT_ASSERT(!seq_map.GetFirst(key, value));
+
+    // Insert across the sequence number wrap.
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+      CPPUNIT_ASSERT(seq_map.Insert(kWrapSeq + (i * 100), i));
+    }
+    CPPUNIT_ASSERT(seq_map.size() == 100);
+
+    CPPUNIT_ASSERT(seq_map.GetFirst(key, value));
+    CPPUNIT_ASSERT(key == kWrapSeq);
+    CPPUNIT_ASSERT(value == 0);
+
+    CPPUNIT_ASSERT(seq_map.Find(kWrapSeq + 9900, value));
+    CPPUNIT_ASSERT(value == 99);
+    CPPUNIT_ASSERT(!seq_map.Find(kWrapSeq + 9901, value));
+
+    // Replace an existing value.
+    CPPUNIT_ASSERT(seq_map.Insert(kWrapSeq + 500, 1000));
+    CPPUNIT_ASSERT(seq_map.size() == 100);
+    CPPUNIT_ASSERT(seq_map.Find(kWrapSeq + 500, value));
+    CPPUNIT_ASSERT(value == 1000);
+
+    CPPUNIT_ASSERT(seq_map.Erase(kWrapSeq));
+    CPPUNIT_ASSERT(!seq_map.Erase(kWrapSeq));
+    CPPUNIT_ASSERT(seq_map.size() == 99);
+    CPPUNIT_ASSERT(seq_map.GetFirst(key, value));
+    CPPUNIT_ASSERT(key == kWrapSeq + 100);
+
+    seq_map.Clear();
+    CPPUNIT_ASSERT(seq_map.size() == 0);
+    CPPUNIT_ASSERT(!seq_map.GetFirst(key, value));
+  }
+
+  //==========================================================================
+  void TestNeighbors()
+  {
+    SeqMap<int>  seq_map;
+    int          value = 0;
+    uint32_t     key   = 0;
+
+    CPPUNIT_ASSERT(seq_map.Insert(kWrapSeq + 1000, 1));
+    CPPUNIT_ASSERT(seq_map.Insert(kWrapSeq + 5000, 2));
+    CPPUNIT_ASSERT(seq_map.Insert(kWrapSeq + 9000, 3));
+
+    CPPUNIT_ASSERT(seq_map.FindFloor(kWrapSeq + 4999, key, value));
+    CPPUNIT_ASSERT(key == kWrapSeq + 1000);
+    CPPUNIT_ASSERT(seq_map.FindFloor(kWrapSeq + 5000, key, value));
+    CPPUNIT_ASSERT(key == kWrapSeq + 5000);
+    CPPUNIT_ASSERT(!seq_map.FindFloor(kWrapSeq + 999, key, value));
+
+    CPPUNIT_ASSERT(seq_map.FindCeiling(kWrapSeq + 5001, key, value));
+    CPPUNIT_ASSERT(key == kWrapSeq + 9000);
+    CPPUNIT_ASSERT(seq_map.FindCeiling(kWrapSeq + 5000, key, value));
+    CPPUNIT_ASSERT(key == kWrapSeq + 5000);
+    CPPUNIT_ASSERT(!seq_map.FindCeiling(kWrapSeq + 9001, key, value));
+
+    CPPUNIT_ASSERT(seq_map.FindHigher(kWrapSeq + 5000, key, value));
+    CPPUNIT_ASSERT(key == kWrapSeq + 9000);
+    CPPUNIT_ASSERT(value == 3);
+    CPPUNIT_ASSERT(!seq_map.FindHigher(kWrapSeq + 9000, key, value));
+  }
+
+  //==========================================================================
+  void TestRandomOps()
+  {
+    SeqMap<uint32_t>              seq_map;
+    std::map<uint32_t, uint32_t>  ref_map;
+    uint32_t                      key   = 0;
+    uint32_t                      value = 0;
+
+    // Keep all of the keys within a window that straddles the wrap, and
+    // compare against std::map using offsets from the start of the window.
+    srandom(1234);
+    for (int i = 0; i < 20000; ++i)
+    {
+      uint32_t  offset = static_cast<uint32_t>(random() % 5000);
+      uint32_t  seq    = kWrapSeq + offset;
+
+      if ((random() % 3) == 0)
+      {
+        CPPUNIT_ASSERT(seq_map.Erase(seq) == (ref_map.erase(offset) == 1));
+      }
+      else
+      {
+        CPPUNIT_ASSERT(seq_map.Insert(seq, offset));
+        ref_map[offset] = offset;
+      }
+
+      CPPUNIT_ASSERT(seq_map.size() == ref_map.size());
+
+      std::map<uint32_t, uint32_t>::iterator  it =
+        ref_map.lower_bound(offset);
+      bool  found = seq_map.FindCeiling(seq, key, value);
+      CPPUNIT_ASSERT(found == (it != ref_map.end()));
+      if (found)
+      {
+        CPPUNIT_ASSERT(key == kWrapSeq + it->first);
+        CPPUNIT_ASSERT(value == it->second);
+      }
+    }
+
+    // Walk the map in order.
+    std::map<uint32_t, uint32_t>::iterator  it    = ref_map.begin();
+    bool                                    found = seq_map.GetFirst(key,
+                                                                     value);
+    while (it != ref_map.end())
+    {
+      CPPUNIT_ASSERT(found);
+      CPPUNIT_ASSERT(key == kWrapSeq + it->first);
+      ++it;
+      found = seq_map.FindHigher(key, key, value);
+    }
+    CPPUNIT_ASSERT(!found);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SeqMapTest);
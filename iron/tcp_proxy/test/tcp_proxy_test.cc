@@ -39,10 +39,14 @@
 
 #include "tcp_proxy.h"
 
+#include "cong_ctrl_bbr.h"
+#include "cong_ctrl_cubic.h"
+#include "cong_ctrl_vj.h"
+#include "socket.h"
+
 #include "bin_map.h"
 #include "config_info.h"
 #include "log.h"
-#include "failing_edge_if.h"
 #include "fifo_if.h"
 #include "itime.h"
 #include "iron_constants.h"
@@ -56,7 +60,14 @@
 #include "unused.h"
 #include "virtual_edge_if.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/tcp.h>
+#include <string.h>
 
 using ::iron::BinMap;
 using ::iron::ConfigInfo;
@@ -67,7 +78,6 @@ using ::iron::Packet;
 using ::iron::PacketPool;
 using ::iron::PacketPoolHeap;
 using ::iron::StringUtils;
-using ::iron::FailingEdgeIf;
 using ::iron::PseudoFifo;
 using ::iron::PseudoSharedMemory;
 using ::iron::RemoteControlServer;
@@ -75,6 +85,7 @@ using ::iron::SharedMemoryIF;
 using ::iron::Time;
 using ::iron::VirtualEdgeIf;
 using ::std::string;
+using ::std::vector;
 
 namespace
 {
@@ -99,7 +110,67 @@ namespace
   const string  kTestService3 = "29780-29780;type=LOGa=10:b=11500:"
     "m=25000000:p=5:label=mgen_flow_3;";
 
+  const string  kTestService4UtilityDef = "type=LOG:a=10:b=11500:"
+    "m=25000000:p=1:label=bulk_flow";
+
+  const string  kTestService4 = "29790-29790;" + kTestService4UtilityDef +
+    ";dscp=10;cc=bbr;";
+
+  /// The bottleneck capacity of the simulated WAN path, in bits per second.
+  const double  kSimCapacityBps = 20000000.0;
+
+  /// The propagation round trip time of the simulated WAN path, in seconds.
+  const double  kSimBaseRttSec = 0.1;
+
+  /// The bottleneck buffer of the simulated WAN path, as a fraction of the
+  /// bandwidth-delay product.
+  const double  kSimBufferBdpFraction = 0.2;
+
+  /// The number of round trips that are simulated.
+  const int     kSimRounds = 600;
+
+  /// A random loss hits the simulated WAN path once per this many rounds.
+  const int     kSimLossPeriodRounds = 20;
+
+  /// The MSS offered by the LAN application in the coalescing test. It is
+  /// small enough that a coalesced segment spans several LAN segments.
+  const uint32_t  kTestLanMss = 536;
+
   const int kPoolSize = 100;
+
+  /// An edge interface that records the bytes of the packets it sends.
+  class RecordingEdgeIf : public VirtualEdgeIf
+  {
+  public:
+
+    RecordingEdgeIf()
+        : sent_pkts_()
+    { }
+
+    virtual ~RecordingEdgeIf() { }
+
+    bool Open() { return true; }
+
+    bool IsOpen() const { return true; }
+
+    void Close() { }
+
+    ssize_t Recv(Packet* pkt, const size_t offset = 0) { return -1; }
+
+    ssize_t Send(const Packet* pkt)
+    {
+      sent_pkts_.push_back(
+        string(reinterpret_cast<const char*>(pkt->GetBuffer()),
+               pkt->GetLengthInBytes()));
+      return pkt->GetLengthInBytes();
+    }
+
+    void AddFileDescriptors(int& max_fd, fd_set& read_fds) const { }
+
+    bool InSet(fd_set* fds) const { return false; }
+
+    vector<string>  sent_pkts_;
+  };
 }
 
 //============================================================================
@@ -122,6 +193,10 @@ class TcpProxyTester : public TcpProxy
   void CheckInitialize();
   void TestServiceDefUpdate();
   void TestFlowDefUpdate();
+  void TestServiceCcAlg();
+  double SimulateThroughput(int cc_alg);
+  void TestCoalescedSegmentAck();
+  void TestLanRexmitBeforeFlush(const RecordingEdgeIf& edge_if);
 
   // Method overriding.
   virtual bool AttachSharedMemory(const ConfigInfo& config_info);
@@ -167,6 +242,7 @@ void TcpProxyTester::InitForTest()
   ci.Add("Service1", kTestService1);
   ci.Add("Service2", kTestService2);
   ci.Add("Service3", kTestService3);
+  ci.Add("Service4", kTestService4);
   ci.Add("DefaultUtilityDef", kTestDefaultUtilityDef);
 
   proxy_config_.Initialize(ci);
@@ -258,6 +334,356 @@ void TcpProxyTester::TestFlowDefUpdate()
   CPPUNIT_ASSERT(utility_func == flow_utility_func_def);
 }
 
+//============================================================================
+void TcpProxyTester::TestServiceCcAlg()
+{
+  // The congestion control algorithm is an option following the utility
+  // function definition, which is not part of the utility function.
+  CPPUNIT_ASSERT(GetContextCcAlg(29790) == BBR_CONGESTION_CONTROL);
+  CPPUNIT_ASSERT(GetContextDscp(29790) == 10);
+  CPPUNIT_ASSERT(GetUtilityFnDef(29790) == kTestService4UtilityDef);
+
+  // Services without the option, and ports without a Service, use the
+  // default algorithm.
+  CPPUNIT_ASSERT(GetContextCcAlg(22) == -1);
+  CPPUNIT_ASSERT(GetContextCcAlg(29781) == -1);
+
+  // The algorithm is kept when a Service is added or modified.
+  TcpContext*  new_context = new (std::nothrow)
+    TcpContext(30000, 30100, kTestService4UtilityDef, -1);
+  CPPUNIT_ASSERT(new_context);
+  new_context->set_cc_alg(CUBIC_CONGESTION_CONTROL);
+  CPPUNIT_ASSERT(ModService(new_context));
+  CPPUNIT_ASSERT(GetContextCcAlg(30050) == CUBIC_CONGESTION_CONTROL);
+
+  new_context->set_cc_alg(VJ_CONGESTION_CONTROL);
+  CPPUNIT_ASSERT(ModService(new_context));
+  CPPUNIT_ASSERT(GetContextCcAlg(30050) == VJ_CONGESTION_CONTROL);
+  delete new_context;
+}
+
+//============================================================================
+double TcpProxyTester::SimulateThroughput(int cc_alg)
+{
+  // The algorithm is driven through a round-based model of a long delay,
+  // high capacity WAN path. Each round, the window is sent, and its ACKs
+  // return evenly spread over the round, which lasts at least one
+  // propagation round trip time and at least the window's serialization
+  // time at the bottleneck. A round loses one segment when the window
+  // overflows the bottleneck buffer or when a random loss hits the path.
+  Socket*  sock = new (std::nothrow) Socket(*this, packet_pool_,
+                                            bin_map_shm_, pkt_info_pool_,
+                                            proxy_config_, socket_mgr_);
+  CPPUNIT_ASSERT(sock);
+
+  sock->set_cfg_if_id(WAN);
+  sock->SetMss(0);
+  sock->set_snd_scale(TCP_MAX_WINSHIFT);
+  sock->set_snd_ssthresh(1 << 30);
+
+  uint32_t  mss = sock->max_data();
+  sock->set_snd_prev_cwnd(4 * mss);
+
+  CongCtrlAlg*  alg = NULL;
+  switch (cc_alg)
+  {
+    case VJ_CONGESTION_CONTROL:
+      alg = new (std::nothrow) VJCongCtrlAlg(sock);
+      break;
+
+    case CUBIC_CONGESTION_CONTROL:
+      alg = new (std::nothrow) CubicCongCtrlAlg(sock);
+      break;
+
+    case BBR_CONGESTION_CONTROL:
+      alg = new (std::nothrow) BbrCongCtrlAlg(sock);
+      break;
+  }
+  CPPUNIT_ASSERT(alg);
+
+  alg->Init();
+  alg->Select();
+
+  double    bdp_bytes       = kSimCapacityBps * kSimBaseRttSec / 8.0;
+  double    max_bytes       = bdp_bytes * (1.0 + kSimBufferBdpFraction);
+  double    delivered_bytes = 0.0;
+  double    elapsed_sec     = 0.0;
+  uint32_t  snd_una         = 1000;
+  Time      start(1000.0);
+
+  for (int round = 0; round < kSimRounds; ++round)
+  {
+    // The VJ algorithm keeps its window in the socket.
+    double  window = ((cc_alg == VJ_CONGESTION_CONTROL) ?
+                      sock->snd_prev_cwnd() : alg->GetCwnd());
+
+    if (alg->GetPacingRate() > 0.0)
+    {
+      window = std::min(window,
+                        alg->GetPacingRate() * kSimBaseRttSec / 8.0);
+    }
+
+    uint32_t  segs      = std::max(static_cast<uint32_t>(window / mss),
+                                   static_cast<uint32_t>(1));
+    double    round_sec = std::max(kSimBaseRttSec,
+                                   segs * mss * 8.0 / kSimCapacityBps);
+    bool      loss      = (((round + 1) % kSimLossPeriodRounds) == 0) ||
+      ((segs * mss) > max_bytes);
+
+    sock->set_snd_una(snd_una);
+    sock->set_seq_sent(snd_una + (segs * mss));
+    sock->set_snd_max(snd_una + (segs * mss));
+
+    if (loss)
+    {
+      // Report the loss, which is repaired within the round.
+      struct tcphdr  tcp_hdr;
+      memset(&tcp_hdr, 0, sizeof(tcp_hdr));
+      tcp_hdr.th_ack = htonl(snd_una);
+      tcp_hdr.th_win = htons(TCP_MAXWIN);
+
+      alg->SnackRcvd(&tcp_hdr, 0, 0);
+    }
+
+    for (uint32_t i = 0; i < segs; ++i)
+    {
+      Time::SetSimulatedNow(
+        start.Add(elapsed_sec + (round_sec * (i + 1) / segs)));
+
+      // Each ACK releases a new segment.
+      snd_una += mss;
+      sock->set_snd_una(snd_una);
+      sock->set_seq_sent(snd_una + (segs * mss));
+      sock->set_snd_max(snd_una + (segs * mss));
+
+      alg->RttSample(static_cast<uint32_t>(round_sec * 1000000.0));
+      alg->AckRcvd(snd_una, mss);
+    }
+
+    delivered_bytes += (loss ? (segs - 1) : segs) * mss;
+    elapsed_sec     += round_sec;
+  }
+
+  Time::ClearSimulatedNow();
+
+  delete alg;
+  delete sock;
+
+  return (delivered_bytes * 8.0 / elapsed_sec);
+}
+
+//============================================================================
+void TcpProxyTester::TestCoalescedSegmentAck()
+{
+  // A WAN-facing socket that receives a segment coalesced by the remote
+  // proxy must acknowledge all of its data, even though the send buffer of
+  // its LAN-facing peer splits the segment up.
+  Socket*  wan_sock = new (std::nothrow) Socket(*this, packet_pool_,
+                                                bin_map_shm_, pkt_info_pool_,
+                                                proxy_config_, socket_mgr_);
+  Socket*  lan_sock = new (std::nothrow) Socket(*this, packet_pool_,
+                                                bin_map_shm_, pkt_info_pool_,
+                                                proxy_config_, socket_mgr_);
+  CPPUNIT_ASSERT(wan_sock);
+  CPPUNIT_ASSERT(lan_sock);
+
+  uint32_t  isn = 1000;
+
+  wan_sock->set_cfg_if_id(WAN);
+  wan_sock->set_peer(lan_sock);
+  wan_sock->SetMss(0);
+  wan_sock->ConfigureUtilityFn(kTestDefaultUtilityDef, local_queue_depths_);
+  wan_sock->set_state(TCP_ESTABLISHED);
+  wan_sock->set_ack_num(isn);
+
+  lan_sock->set_cfg_if_id(LAN);
+  lan_sock->set_peer(wan_sock);
+  lan_sock->SetMss(kTestLanMss);
+  lan_sock->set_state(TCP_ESTABLISHED);
+  lan_sock->send_buf()->init_una_seq(isn);
+
+  uint32_t  data_len = (2 * lan_sock->max_data()) + 100;
+  uint32_t  seq_num  = isn;
+
+  for (int i = 0; i < 3; ++i)
+  {
+    // The last time around, the first segment is retransmitted. It has
+    // already been acknowledged, so it is dropped.
+    uint32_t  pkt_seq_num = ((i < 2) ? seq_num : isn);
+
+    PktInfo*  pkt_info = pkt_info_pool_.Get();
+    Packet*   pkt      = pkt_info->pkt;
+    size_t    hdr_len  = sizeof(struct iphdr) + sizeof(struct tcphdr);
+
+    CPPUNIT_ASSERT(pkt->SetLengthInBytes(hdr_len + data_len));
+    memset(pkt->GetBuffer(), 0, pkt->GetLengthInBytes());
+
+    struct iphdr*  ip_hdr = reinterpret_cast<struct iphdr*>(pkt->GetBuffer());
+    ip_hdr->version  = 4;
+    ip_hdr->ihl      = 5;
+    ip_hdr->ttl      = 64;
+    ip_hdr->protocol = IPPROTO_TCP;
+    ip_hdr->tot_len  = htons(hdr_len + data_len);
+    ip_hdr->saddr    = htonl(iron::StringUtils::GetIpAddr(
+                               "172.24.2.1").address());
+    ip_hdr->daddr    = htonl(iron::StringUtils::GetIpAddr(
+                               "172.24.1.1").address());
+
+    struct tcphdr*  tcp_hdr = pkt->GetTcpHdr();
+    tcp_hdr->th_sport = htons(29778);
+    tcp_hdr->th_dport = htons(30000);
+    tcp_hdr->th_seq   = htonl(pkt_seq_num);
+    tcp_hdr->th_ack   = htonl(wan_sock->snd_una());
+    tcp_hdr->th_off   = 5;
+    tcp_hdr->th_flags = TH_ACK;
+    tcp_hdr->th_win   = htons(0xffff);
+
+    pkt_info->seq_num  = pkt_seq_num;
+    pkt_info->data_len = data_len;
+    pkt_info->flags    = TH_ACK;
+
+    wan_sock->ProcessPkt(pkt_info, tcp_hdr, ip_hdr);
+
+    if (i < 2)
+    {
+      seq_num += data_len;
+    }
+    CPPUNIT_ASSERT_EQUAL(seq_num, wan_sock->ack_num());
+  }
+
+  // The peer holds all of the data, in segments that fit its MSS.
+  SendBuffer*  send_buf = lan_sock->send_buf();
+  CPPUNIT_ASSERT_EQUAL(2 * data_len, send_buf->BytesInBuffer());
+
+  uint32_t  next_seq_num = isn;
+  for (PktInfo* pkt_info = send_buf->snd_una(); pkt_info != NULL;
+       pkt_info = pkt_info->next)
+  {
+    CPPUNIT_ASSERT_EQUAL(next_seq_num, pkt_info->seq_num);
+    CPPUNIT_ASSERT(pkt_info->data_len <=
+                   static_cast<uint32_t>(lan_sock->max_data()));
+    next_seq_num += pkt_info->data_len;
+  }
+  CPPUNIT_ASSERT_EQUAL(seq_num, next_seq_num);
+
+  delete wan_sock;
+  delete lan_sock;
+}
+
+//============================================================================
+void TcpProxyTester::TestLanRexmitBeforeFlush(const RecordingEdgeIf& edge_if)
+{
+  // A LAN-facing socket that retransmits a segment before the LAN send
+  // batch is flushed must not change the bytes of the queued transmission.
+  Socket*  wan_sock = new (std::nothrow) Socket(*this, packet_pool_,
+                                                bin_map_shm_, pkt_info_pool_,
+                                                proxy_config_, socket_mgr_);
+  Socket*  lan_sock = new (std::nothrow) Socket(*this, packet_pool_,
+                                                bin_map_shm_, pkt_info_pool_,
+                                                proxy_config_, socket_mgr_);
+  CPPUNIT_ASSERT(wan_sock);
+  CPPUNIT_ASSERT(lan_sock);
+
+  Time::SetSimulatedNow(Time(1000.0));
+
+  uint32_t  isn      = 1000;
+  uint32_t  data_len = 100;
+
+  wan_sock->set_cfg_if_id(WAN);
+  wan_sock->set_peer(lan_sock);
+  wan_sock->SetMss(0);
+  wan_sock->ConfigureUtilityFn(kTestDefaultUtilityDef, local_queue_depths_);
+  wan_sock->set_state(TCP_ESTABLISHED);
+  wan_sock->set_ack_num(isn);
+
+  lan_sock->set_cfg_if_id(LAN);
+  lan_sock->set_peer(wan_sock);
+  lan_sock->SetMss(kTestLanMss);
+  lan_sock->set_state(TCP_ESTABLISHED);
+  lan_sock->set_last_uwe_in(isn + TCP_MAXWIN);
+  lan_sock->send_buf()->init_una_seq(isn);
+
+  PktInfo*  pkt_info = pkt_info_pool_.Get();
+  Packet*   pkt      = pkt_info->pkt;
+  size_t    hdr_len  = sizeof(struct iphdr) + sizeof(struct tcphdr);
+
+  CPPUNIT_ASSERT(pkt->SetLengthInBytes(hdr_len + data_len));
+  memset(pkt->GetBuffer(), 0, pkt->GetLengthInBytes());
+
+  for (uint32_t i = 0; i < data_len; ++i)
+  {
+    *(pkt->GetBuffer(hdr_len + i)) = static_cast<uint8_t>(i);
+  }
+
+  struct iphdr*  ip_hdr = reinterpret_cast<struct iphdr*>(pkt->GetBuffer());
+  ip_hdr->version  = 4;
+  ip_hdr->ihl      = 5;
+  ip_hdr->ttl      = 64;
+  ip_hdr->protocol = IPPROTO_TCP;
+  ip_hdr->tot_len  = htons(hdr_len + data_len);
+  ip_hdr->saddr    = htonl(iron::StringUtils::GetIpAddr(
+                             "172.24.2.1").address());
+  ip_hdr->daddr    = htonl(iron::StringUtils::GetIpAddr(
+                             "172.24.1.1").address());
+
+  struct tcphdr*  tcp_hdr = pkt->GetTcpHdr();
+  tcp_hdr->th_sport = htons(29778);
+  tcp_hdr->th_dport = htons(30000);
+  tcp_hdr->th_seq   = htonl(isn);
+  tcp_hdr->th_ack   = htonl(wan_sock->snd_una());
+  tcp_hdr->th_off   = 5;
+  tcp_hdr->th_flags = TH_ACK;
+  tcp_hdr->th_win   = htons(0xffff);
+
+  pkt_info->seq_num  = isn;
+  pkt_info->data_len = data_len;
+  pkt_info->flags    = TH_ACK;
+
+  // The data is moved to the LAN-facing socket, which sends it. The LAN
+  // send batch holds a reference to the socket's packet.
+  wan_sock->ProcessPkt(pkt_info, tcp_hdr, ip_hdr);
+  lan_sock->Send(NULL, false);
+
+  PktInfo*  sent_pkt_info = lan_sock->send_buf()->snd_una();
+  CPPUNIT_ASSERT(sent_pkt_info);
+  Packet*   sent_pkt      = sent_pkt_info->pkt;
+
+  CPPUNIT_ASSERT(lan_send_batch_.num_queued() == 1);
+  CPPUNIT_ASSERT(sent_pkt->ref_cnt() == 2);
+  CPPUNIT_ASSERT(edge_if.sent_pkts_.empty());
+
+  string  first_xmit(reinterpret_cast<const char*>(sent_pkt->GetBuffer()),
+                     sent_pkt->GetLengthInBytes());
+
+  // Mark the segment as a hole, as a duplicate ACK does, and retransmit it
+  // with a new ACK number before the batch is flushed. The first
+  // transmission is sent unchanged before the packet is modified.
+  sent_pkt_info->rexmit_time = Time::Now();
+  lan_sock->send_buf()->MoveToHeadOfRexmitList(sent_pkt_info);
+  lan_sock->set_ack_num(lan_sock->ack_num() + 5000);
+  lan_sock->Send(NULL, false);
+
+  CPPUNIT_ASSERT(edge_if.sent_pkts_.size() == 1);
+  CPPUNIT_ASSERT(edge_if.sent_pkts_[0] == first_xmit);
+  CPPUNIT_ASSERT(lan_send_batch_.num_queued() == 1);
+
+  string  second_xmit(reinterpret_cast<const char*>(sent_pkt->GetBuffer()),
+                      sent_pkt->GetLengthInBytes());
+  CPPUNIT_ASSERT(second_xmit != first_xmit);
+  CPPUNIT_ASSERT(second_xmit.substr(hdr_len) == first_xmit.substr(hdr_len));
+
+  FlushLanSends();
+
+  CPPUNIT_ASSERT(edge_if.sent_pkts_.size() == 2);
+  CPPUNIT_ASSERT(edge_if.sent_pkts_[1] == second_xmit);
+  CPPUNIT_ASSERT(sent_pkt->ref_cnt() == 1);
+
+  Time::ClearSimulatedNow();
+
+  delete wan_sock;
+  delete lan_sock;
+}
+
 //============================================================================
 bool TcpProxyTester::AttachSharedMemory(const ConfigInfo& config_info)
 {
@@ -274,6 +700,10 @@ class TcpProxyTest : public CppUnit::TestFixture
   CPPUNIT_TEST(TestGetUtilityFnDef);
   CPPUNIT_TEST(TestServiceDefUpdate);
   CPPUNIT_TEST(TestFlowDefUpdate);
+  CPPUNIT_TEST(TestServiceCcAlg);
+  CPPUNIT_TEST(TestCongCtrlThroughput);
+  CPPUNIT_TEST(TestCoalescedSegmentAck);
+  CPPUNIT_TEST(TestLanRexmitBeforeFlush);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -282,7 +712,7 @@ class TcpProxyTest : public CppUnit::TestFixture
   TcpProxyTester*       tcp_proxy_;
   TcpProxyConfig*       tcp_proxy_config_;
   PacketPoolHeap*       packet_pool_;
-  VirtualEdgeIf*        edge_if_;
+  RecordingEdgeIf*      edge_if_;
   SharedMemoryIF*       weight_qd_shared_memory_;
   BinMap*          bin_map_;
   char*            bin_map_mem_;
@@ -297,7 +727,7 @@ class TcpProxyTest : public CppUnit::TestFixture
   {
     Log::SetDefaultLevel("F");
 
-    edge_if_          = new FailingEdgeIf(true);
+    edge_if_          = new RecordingEdgeIf();
     tcp_proxy_config_ = new TcpProxyConfig();
 
     packet_pool_ = new PacketPoolHeap();
@@ -426,6 +856,41 @@ class TcpProxyTest : public CppUnit::TestFixture
     tcp_proxy_->TestFlowDefUpdate();
   }
 
+  //==========================================================================
+  void TestServiceCcAlg()
+  {
+    tcp_proxy_->TestServiceCcAlg();
+  }
+
+  //==========================================================================
+  void TestCoalescedSegmentAck()
+  {
+    tcp_proxy_->TestCoalescedSegmentAck();
+  }
+
+  //==========================================================================
+  void TestLanRexmitBeforeFlush()
+  {
+    tcp_proxy_->TestLanRexmitBeforeFlush(*edge_if_);
+  }
+
+  //==========================================================================
+  void TestCongCtrlThroughput()
+  {
+    // With periodic random losses on a long delay path, VJ's linear growth
+    // leaves most of the capacity unused. Cubic regrows its window
+    // independently of the round trip time, and BBR does not back off on
+    // loss at all.
+    double  vj_bps    = tcp_proxy_->SimulateThroughput(VJ_CONGESTION_CONTROL);
+    double  cubic_bps =
+      tcp_proxy_->SimulateThroughput(CUBIC_CONGESTION_CONTROL);
+    double  bbr_bps   = tcp_proxy_->SimulateThroughput(BBR_CONGESTION_CONTROL);
+
+    CPPUNIT_ASSERT(cubic_bps > (1.2 * vj_bps));
+    CPPUNIT_ASSERT(bbr_bps > (2.0 * vj_bps));
+    CPPUNIT_ASSERT(bbr_bps > (0.8 * kSimCapacityBps));
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TcpProxyTest);
@@ -146,6 +146,17 @@ bool AdmissionController::ConfigureUtilityFn(UtilityFn* utility_fn,
   return true;
 }
 
+//============================================================================
+Time AdmissionController::NextEventTime()
+{
+  if (encoding_state_.GetCountFromEncodedPktsQueue() > 0)
+  {
+    return Time();
+  }
+
+  return Time::Infinite();
+}
+
 //============================================================================
 void AdmissionController::SvcAdmissionEvent(Time& now, UtilityFn* utility_fn)
 {
@@ -94,6 +94,16 @@ class AdmissionController
   /// \param  now  The current time.
   virtual void SvcEvents(iron::Time& now) = 0;
 
+  /// \brief Get the time of the next admission control event.
+  ///
+  /// A flow with packets waiting for admission is paced against a send rate
+  /// that is recomputed on every service pass, so it is always due.
+  ///
+  /// \return The time of the next admission control event. A zero time
+  ///         indicates that the flow must be serviced on the next pass, and
+  ///         an infinite time that there are no scheduled events.
+  virtual iron::Time NextEventTime();
+
   /// \brief Get the flow's instantaneous utility.
   ///
   /// \param  rate  The flow's send rate.
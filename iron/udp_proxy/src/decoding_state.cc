@@ -37,6 +37,7 @@
 
 #include "admission_controller.h"
 #include "decoding_state.h"
+#include "fec_codec.h"
 #include "fec_state.h"
 #include "ipv4_endpoint.h"
 #include "log.h"
@@ -75,7 +76,6 @@ using ::iron::StringUtils;
 using ::iron::Time;
 using ::rapidjson::StringBuffer;
 using ::rapidjson::Writer;
-using ::std::map;
 using ::std::numeric_limits;
 using ::std::string;
 
@@ -87,6 +87,14 @@ namespace
   /// The minimum interval between event-driven RRMs generated by a flow,
   /// in milliseconds.
   const uint32_t  kMinEventRrmIntervalMsec = 1000;
+
+  /// The initial number of slots in the ring of FEC groups being decoded.
+  /// Must be a power of two.
+  const uint32_t  kInitialFecGrpRingSize = 64;
+
+  /// The maximum number of slots in the ring of FEC groups being decoded.
+  /// Must be a power of two.
+  const uint32_t  kMaxFecGrpRingSize = 4096;
 }
 
 //============================================================================
@@ -101,10 +109,15 @@ DecodingState::DecodingState(UdpProxy& udp_proxy,
       packet_pool_(packet_pool),
       bin_map_(bin_map),
       fecstate_pool_(fecstate_pool),
-      fec_state_map_(),
+      fec_grp_ring_(kInitialFecGrpRingSize, static_cast<FecState*>(NULL)),
+      fec_grp_ring_mask_(kInitialFecGrpRingSize - 1),
+      fec_grp_count_(0),
+      last_grp_id_(-1),
       fec_grp_ready_time_(Time::Infinite()),
       next_grp_id_(-1),
       last_time_(Time::GetNowInSec()),
+      svc_deadline_(),
+      gc_deadline_(),
       max_reorder_time_(Time(0)),
       bin_idx_(iron::kInvalidBinIndex),
       four_tuple_(four_tuple),
@@ -132,20 +145,16 @@ DecodingState::~DecodingState()
     release_controller_ = NULL;
   }
 
-  // Destroy the FEC State map. Recycle the FEC State objects in this map.
-  if (fec_state_map_.size() != 0)
+  // Recycle the FEC State objects in the ring of FEC groups.
+  for (size_t i = 0; i < fec_grp_ring_.size(); ++i)
   {
-    map<int, FecState*>::iterator  it;
-    for (it = fec_state_map_.begin(); it != fec_state_map_.end(); ++it)
+    if (fec_grp_ring_[i] != NULL)
     {
-      if (it->second)
-      {
-        fecstate_pool_.Recycle(it->second);
-        it->second = NULL;
-      }
+      fecstate_pool_.Recycle(fec_grp_ring_[i]);
+      fec_grp_ring_[i] = NULL;
     }
-    fec_state_map_.clear();
   }
+  fec_grp_count_ = 0;
 }
 
 //============================================================================
@@ -468,9 +477,9 @@ void DecodingState::HandlePkt(Packet* pkt)
   else
   {
     fec_state = fecstate_pool_.Get();
-    fec_state_map_[fecTrlr.group_id] = fec_state;
     fec_state->set_group_id(fecTrlr.group_id);
     fec_state->set_decoding_state(this);
+    AddFecState(fecTrlr.group_id, fec_state);
   }
 
   // Add the packet we just received to the cache of the appropriate FecState.
@@ -562,6 +571,36 @@ void DecodingState::SvcEvents(Time& now)
   }
 }
 
+//============================================================================
+void DecodingState::CompleteFecCodecJob(FecCodecJob* job)
+{
+  if (!HasFecState(job->group_id))
+  {
+    return;
+  }
+
+  FecState*  fec_state = NULL;
+  GetFecState(job->group_id, fec_state);
+
+  // The group no longer waits for the FEC codec threads, so the FEC groups
+  // are checked for release on the next service.
+  if ((fec_state != NULL) && fec_state->CompleteDecode(job))
+  {
+    fec_grp_ready_time_ = Time();
+  }
+}
+
+//============================================================================
+Time DecodingState::NextEventTime()
+{
+  if (release_controller_ == NULL)
+  {
+    return fec_grp_ready_time_;
+  }
+
+  return Time::Min(fec_grp_ready_time_, release_controller_->NextEventTime());
+}
+
 //============================================================================
 ssize_t DecodingState::ReleasePkt(Packet* pkt) const
 {
@@ -704,7 +743,7 @@ void DecodingState::ReleaseInOrderPackets()
     if (SendToReleaseController(fec_state, next_exp))
     {
       DeleteFecState(next_grp_id_);
-      ++next_grp_id_;
+      next_grp_id_ = (next_grp_id_ + 1) & FEC_GROUPID_MASK;
       LogD(kClassName, __func__, "continue rel\n");
     }
     else  // The next FEC group is not complete, so we wait.
@@ -718,60 +757,42 @@ void DecodingState::ReleaseInOrderPackets()
 //============================================================================
 int DecodingState::GetNextFecGrp(int cur_group)
 {
-  if (fec_state_map_.size() == 0)
+  if (fec_grp_count_ == 0)
   {
     return -1;
   }
 
-  // The smallest FEC group ID that is larger than current group ID.
-  int next_grp_id = cur_group + FEC_GROUPID_ROLLOVER;
+  // Group IDs are dense, so the next group is normally in the next slot.
+  // The search never goes past the furthest group in the ring.
+  uint32_t  first = IsLate(cur_group) ? 0 : (GrpOffset(cur_group) + 1);
+  uint32_t  last  = GrpOffset(last_grp_id_);
 
-  std::map<int,FecState*>::iterator it;
-  for(it = fec_state_map_.begin(); it != fec_state_map_.end(); ++it)
+  for (uint32_t offset = first; offset <= last; ++offset)
   {
-    if (IsLate(it->first, cur_group))
-    {
-      continue;
-    }
-
-    int grp_id = 0;
-    if (it->first <= cur_group)
-    {
-      grp_id = it->first + FEC_GROUPID_ROLLOVER;
-    }
-    else
-    {
-      grp_id = it->first;
-    }
-
+    int  grp_id = (next_grp_id_ + offset) & FEC_GROUPID_MASK;
 
-    //LogD(kClassName, __func__, "has grp %d vs %d\n", it->first,next_grp_id);
-    if (grp_id < next_grp_id)
+    if (FindFecState(grp_id) != NULL)
     {
-      next_grp_id = grp_id;
+      return grp_id;
     }
   }
 
-  next_grp_id = next_grp_id & FEC_GROUPID_MASK;
-
-  if (next_grp_id == cur_group)
-  {
-    return -1;
-  }
-  return next_grp_id;
+  return -1;
 }
 
 //============================================================================
 Time DecodingState::GetNextExpTime(int index, int groupId)
 {
-  if (fec_state_map_.find(groupId) == fec_state_map_.end())
+  FecState*  fec_state = FindFecState(groupId);
+
+  if (fec_state == NULL)
   {
     return Time::Infinite();
   }
 
   LogD(kClassName, __func__, "Finding Next exp time for group:%d, pkt %d\n",
        groupId, index);
-  Time next_pkt_exp = fec_state_map_[groupId]->next_pkt_exp(index);
+  Time next_pkt_exp = fec_state->next_pkt_exp(index);
   if (next_pkt_exp == Time::Infinite())
   {
     int next_grp = GetNextFecGrp(groupId);
@@ -791,26 +812,99 @@ Time DecodingState::GetNextExpTime(int index, int groupId)
 //============================================================================
 bool DecodingState::HasFecState(int group_id)
 {
-  std::map<int,FecState*>::iterator  it;
-  it = fec_state_map_.find(group_id);
-  return (it != fec_state_map_.end());
+  return (FindFecState(group_id) != NULL);
 }
 
 //============================================================================
 void DecodingState::DeleteFecState(int group_id)
 {
-  std::map<int,FecState*>::iterator  it;
-  it = fec_state_map_.find(group_id);
-  if (it != fec_state_map_.end())
+  FecState*  fec_state = FindFecState(group_id);
+  if (fec_state != NULL)
   {
     LogD(kClassName, __func__, "Deleting %d\n", group_id);
-    FecState* fec_state = it->second;
     fec_state->FlushCache();
-    fec_state_map_.erase(group_id);
+    fec_grp_ring_[group_id & fec_grp_ring_mask_] = NULL;
+    --fec_grp_count_;
     fecstate_pool_.Recycle(fec_state);
   }
 }
 
+//============================================================================
+void DecodingState::AddFecState(int group_id, FecState* fec_state)
+{
+  uint32_t  offset = GrpOffset(group_id);
+
+  if (offset >= kMaxFecGrpRingSize)
+  {
+    LogW(kClassName, __func__, "fid: %" PRIu32 ", group %d is %" PRIu32
+         " groups ahead of group %d, restarting decoding.\n", flow_tag_,
+         group_id, offset, next_grp_id_);
+    FlushFecGrps();
+    next_grp_id_ = group_id;
+    offset       = 0;
+  }
+
+  if (offset > fec_grp_ring_mask_)
+  {
+    GrowFecGrpRing(offset + 1);
+  }
+
+  fec_grp_ring_[group_id & fec_grp_ring_mask_] = fec_state;
+  ++fec_grp_count_;
+
+  if ((fec_grp_count_ == 1) || (offset > GrpOffset(last_grp_id_)))
+  {
+    last_grp_id_ = group_id;
+  }
+}
+
+//============================================================================
+void DecodingState::GrowFecGrpRing(uint32_t min_size)
+{
+  uint32_t  size = fec_grp_ring_.size();
+
+  while (size < min_size)
+  {
+    size <<= 1;
+  }
+
+  LogD(kClassName, __func__, "fid: %" PRIu32 ", growing FEC group ring to %"
+       PRIu32 " slots.\n", flow_tag_, size);
+
+  std::vector<FecState*>  ring(size, static_cast<FecState*>(NULL));
+
+  for (size_t i = 0; i < fec_grp_ring_.size(); ++i)
+  {
+    if (fec_grp_ring_[i] != NULL)
+    {
+      ring[fec_grp_ring_[i]->group_id() & (size - 1)] = fec_grp_ring_[i];
+    }
+  }
+
+  fec_grp_ring_.swap(ring);
+  fec_grp_ring_mask_ = size - 1;
+}
+
+//============================================================================
+void DecodingState::FlushFecGrps()
+{
+  while (fec_grp_count_ > 0)
+  {
+    FecState*  fec_state = FindFecState(next_grp_id_);
+
+    if (fec_state != NULL)
+    {
+      // Missing packets are skipped, as a zero next expiration time has
+      // already passed.
+      Time  no_wait;
+      SendToReleaseController(fec_state, no_wait);
+      DeleteFecState(next_grp_id_);
+    }
+
+    next_grp_id_ = (next_grp_id_ + 1) & FEC_GROUPID_MASK;
+  }
+}
+
 //============================================================================
 void DecodingState::AccumulatePacketInfo(uint64_t length_bytes,
   const Time& delay)
@@ -845,12 +939,24 @@ void DecodingState::FecGrpReadyTimeout(Time& now)
   {
     if (!HasFecState(next_grp_id_))
     {
-      if (max_reorder_time_.GetTimeInUsec() > 0)
+      // Skip straight to the next group that has packets.
+      int  next_fec_grp = GetNextFecGrp(next_grp_id_);
+
+      if (next_fec_grp == -1)
+      {
+        fec_grp_ready_time_ = Time::Infinite();
+        break;
+      }
+
+      while (next_grp_id_ != next_fec_grp)
       {
-        LogA(kClassName, __func__, "pktcount: Flow: %zu, Missing FECState "
-             "group: %" PRIu32 ".\n", four_tuple_.Hash(), next_grp_id_);
+        if (max_reorder_time_.GetTimeInUsec() > 0)
+        {
+          LogA(kClassName, __func__, "pktcount: Flow: %zu, Missing FECState "
+               "group: %" PRIu32 ".\n", four_tuple_.Hash(), next_grp_id_);
+        }
+        next_grp_id_ = (next_grp_id_ + 1) & FEC_GROUPID_MASK;
       }
-      ++next_grp_id_;
       continue;
     }
 
@@ -875,7 +981,7 @@ void DecodingState::FecGrpReadyTimeout(Time& now)
     if (SendToReleaseController(fec_state, next_exp))
     {
       DeleteFecState(next_grp_id_);
-      ++next_grp_id_;
+      next_grp_id_ = (next_grp_id_ + 1) & FEC_GROUPID_MASK;
       fec_grp_ready_time_ = next_exp;
       LogD(kClassName, __func__, "Next exp group is: %d\n", next_grp_id_);
     }
@@ -909,6 +1015,10 @@ bool DecodingState::SendToReleaseController(FecState* fec_state,
   int   upper_limit = fec_state->max_pkt_id();
   Time  now         = Time::Now();
 
+  // Missing packets are not skipped while the FEC codec threads may still
+  // reconstruct them.
+  bool  decode_pending = fec_state->DecodePending(now);
+
   LogD(kClassName, __func__, "limits: %d, %d\n", lower_limit, upper_limit);
   if (upper_limit >= 0)
   {
@@ -940,7 +1050,7 @@ bool DecodingState::SendToReleaseController(FecState* fec_state,
       {
         // Could not reassemble packet, check if we should skip.
         next_pkt_exp = Time::Min(next_exp, fec_state->next_pkt_exp(i));
-        if (next_pkt_exp < now)
+        if ((next_pkt_exp < now) && (!decode_pending))
         {
           LogA(kClassName, __func__, "pktcount: Missing FECState group: %"
                PRIu32 " slot: %" PRIu32 " \n.", fec_state->group_id(), i);
@@ -955,6 +1065,15 @@ bool DecodingState::SendToReleaseController(FecState* fec_state,
     }
   }
 
+  // Hold the group until the FEC codec threads return its repairs, or its
+  // FEC offload deadline passes.
+  if (decode_pending &&
+      (fec_state->getFirstUnsentPktID() < fec_state->base_rate()))
+  {
+    fec_state->set_expiration_time(fec_state->decode_deadline());
+    return false;
+  }
+
   // Check if there is still packets to send in this state.
   if (fec_state->fec_used() && next_pkt_exp > now)
   {
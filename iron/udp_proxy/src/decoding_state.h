@@ -56,12 +56,15 @@
 #include "rapidjson/writer.h"
 
 #include <ctime>
+#include <vector>
+
 #include <string.h>
 #include <sys/types.h>
 
 class UdpProxy;
 class ReleaseController;
 class FecState;
+struct FecCodecJob;
 
 /// A decoding state is used to store per-flow state at the destination
 /// UDP Proxy. The decoding state contains a map which holds the FEC
@@ -108,6 +111,58 @@ class DecodingState
   /// \param  now  The current time.
   void SvcEvents(iron::Time& now);
 
+  /// \brief Install the packets of a FEC group that was decoded by the FEC
+  /// codec threads.
+  ///
+  /// The group is released on the next service of the decoding state.
+  ///
+  /// \param  job  The returned job. The installed packets are removed from
+  ///              the job.
+  void CompleteFecCodecJob(FecCodecJob* job);
+
+  /// \brief Get the time of the next decoding event.
+  ///
+  /// \return The time of the next decoding event. A zero time indicates
+  ///         that the flow must be serviced on the next pass.
+  iron::Time NextEventTime();
+
+  /// \brief Get the time at which the UDP Proxy will next service the
+  /// decoding state.
+  ///
+  /// \return The time at which the state is scheduled for service.
+  inline const iron::Time& svc_deadline() const
+  {
+    return svc_deadline_;
+  }
+
+  /// \brief Set the time at which the UDP Proxy will next service the
+  /// decoding state.
+  ///
+  /// \param  deadline  The time at which the state is scheduled for service.
+  inline void set_svc_deadline(const iron::Time& deadline)
+  {
+    svc_deadline_ = deadline;
+  }
+
+  /// \brief Get the time at which the UDP Proxy will next check the decoding
+  /// state for garbage collection.
+  ///
+  /// \return The time at which the state is scheduled for expiration.
+  inline const iron::Time& gc_deadline() const
+  {
+    return gc_deadline_;
+  }
+
+  /// \brief Set the time at which the UDP Proxy will next check the decoding
+  /// state for garbage collection.
+  ///
+  /// \param  deadline  The time at which the state is scheduled for
+  ///                   expiration.
+  inline void set_gc_deadline(const iron::Time& deadline)
+  {
+    gc_deadline_ = deadline;
+  }
+
   /// \brief Release a decoded packet.
   ///
   /// \param  pkt  Pointer to the packet to be released.
@@ -164,6 +219,14 @@ class DecodingState
     return flow_tag_;
   }
 
+  /// \brief Get a pointer to the udp proxy that owns this decoding state.
+  ///
+  /// \return A pointer to the udp proxy that owns this decoding state.
+  inline UdpProxy* udp_proxy() const
+  {
+    return &udp_proxy_;
+  }
+
   private:
 
   /// \brief No-arg constructor.
@@ -197,9 +260,58 @@ class DecodingState
     {
       cur_id = next_grp_id_;
     }
-    return ((grp_id - cur_id) > (FEC_GROUPID_ROLLOVER >> 1));
+    return (((grp_id - cur_id) & FEC_GROUPID_MASK) >
+            (FEC_GROUPID_ROLLOVER >> 1));
   }
 
+  /// \brief Get the distance of a FEC group ahead of the next group to be
+  /// sent.
+  ///
+  /// \param  group_id  The FEC group ID.
+  ///
+  /// \return The number of groups from next_grp_id_ to the group.
+  inline uint32_t GrpOffset(int group_id) const
+  {
+    return ((group_id - next_grp_id_) & FEC_GROUPID_MASK);
+  }
+
+  /// \brief Find the FecState of a FEC group.
+  ///
+  /// \param  group_id  The FEC group ID.
+  ///
+  /// \return The FecState, or NULL if there is none for the group.
+  inline FecState* FindFecState(int group_id) const
+  {
+    FecState*  fec_state = fec_grp_ring_[group_id & fec_grp_ring_mask_];
+
+    if ((fec_state != NULL) && (fec_state->group_id() == group_id))
+    {
+      return fec_state;
+    }
+
+    return NULL;
+  }
+
+  /// \brief Add the FecState of a new FEC group.
+  ///
+  /// The ring of FEC groups is grown to cover the group, up to a maximum
+  /// size. A group beyond that is taken as a restart of the source's group
+  /// IDs: the outstanding groups are released as they are and decoding
+  /// restarts at the new group.
+  ///
+  /// \param  group_id   The FEC group ID, which must not be late.
+  /// \param  fec_state  The FecState for the group.
+  void AddFecState(int group_id, FecState* fec_state);
+
+  /// \brief Grow the ring of FEC groups.
+  ///
+  /// \param  min_size  The minimum number of slots in the grown ring.
+  void GrowFecGrpRing(uint32_t min_size);
+
+  /// \brief Release whatever can be released from all of the outstanding
+  /// FEC groups, without waiting for missing packets, and delete them.
+  void FlushFecGrps();
+
   /// \brief  Get the sequentially next FEC group for which we have
   /// received packets.
   ///
@@ -232,7 +344,7 @@ class DecodingState
   /// will be set by this method.
   inline void GetFecState(int groupId, FecState*& fec_state)
   {
-    fec_state = fec_state_map_[groupId];
+    fec_state = FindFecState(groupId);
   }
 
   /// \brief Delete a FecState.
@@ -247,9 +359,11 @@ class DecodingState
   /// \return The expiration time of the specified group.
   inline iron::Time grp_exp_time(int group_id)
   {
-    if (fec_state_map_.find(group_id) != fec_state_map_.end())
+    FecState*  fec_state = FindFecState(group_id);
+
+    if (fec_state != NULL)
     {
-      return fec_state_map_[group_id]->expiration_time();
+      return fec_state->expiration_time();
     }
     else
     {
@@ -296,8 +410,20 @@ class DecodingState
   /// Pool of fec states to use.
   FecStatePool&             fecstate_pool_;
 
-  /// A collection of groups of packets being decoded.
-  std::map<int, FecState*>  fec_state_map_;
+  /// The groups of packets being decoded, indexed by group ID modulo the
+  /// ring size, which is a power of two. All of the groups are less than
+  /// one ring size ahead of next_grp_id_, so no two groups share a slot.
+  std::vector<FecState*>    fec_grp_ring_;
+
+  /// The ring size minus one, used to mask group IDs into ring slots.
+  uint32_t                  fec_grp_ring_mask_;
+
+  /// The number of groups in the ring.
+  size_t                    fec_grp_count_;
+
+  /// The group in the ring that is furthest ahead of next_grp_id_, valid
+  /// when the ring is not empty.
+  int                       last_grp_id_;
 
   /// The time that the next FEC group should be provided to the release
   /// controller.
@@ -309,6 +435,13 @@ class DecodingState
   /// Last time this was accessed.
   time_t                    last_time_;
 
+  /// The time at which the UDP Proxy next services this state.
+  iron::Time                svc_deadline_;
+
+  /// The time at which the UDP Proxy next checks this state for garbage
+  /// collection.
+  iron::Time                gc_deadline_;
+
   /// The maximum hold time for reordering.
   iron::Time                max_reorder_time_;
 
@@ -37,6 +37,7 @@
 
 #include "admission_controller.h"
 #include "encoding_state.h"
+#include "fec_codec.h"
 #include "flog_admission_controller.h"
 #include "ipv4_endpoint.h"
 #include "iron_types.h"
@@ -96,6 +97,8 @@ EncodingState::EncodingState(UdpProxy& udp_proxy,
                              iron::BinIndex bin_idx, uint32_t flow_tag,
                              NormFlowController* flow_controller)
     : last_time_(Time::GetNowInSec()),
+      svc_deadline_(),
+      gc_deadline_(),
       group_id_(rand() & FEC_GROUPID_MASK),
       pkt_id_(0),
       orig_count_(0),
@@ -136,6 +139,8 @@ EncodingState::EncodingState(UdpProxy& udp_proxy,
       loss_rate_pct_(0),
       dump_byte_number_(0),
       dump_pkt_number_(0),
+      dump_fec_grp_number_(0),
+      dump_fec_copy_bytes_(0),
       total_byte_number_(0),
       total_pkt_number_(0),
       last_report_time_(Time::Now()),
@@ -451,6 +456,17 @@ void EncodingState::SvcEvents(Time& now)
   }
 }
 
+//============================================================================
+Time EncodingState::NextEventTime()
+{
+  if (admission_controller_ == NULL)
+  {
+    return Time::Infinite();
+  }
+
+  return admission_controller_->NextEventTime();
+}
+
 //============================================================================
 size_t EncodingState::AdmitPacket()
 {
@@ -829,7 +845,9 @@ bool EncodingState::UpdateFEC(struct timeval *currentTime)
     fec_count_ = 0;
     for (j=0; j<nFecPkts; j++)
     {
+      // Each repair packet is a full copy of the original.
       rpkt = packet_pool_.Clone(qpkt, false, iron::PACKET_NOW_TIMESTAMP);
+      dump_fec_copy_bytes_ += qpkt->GetLengthInBytes();
 
       // Note: cached packets have the FEC trailer appended to them
       // We trim them back to make the bookkeeping work
@@ -867,12 +885,31 @@ bool EncodingState::UpdateFEC(struct timeval *currentTime)
 
     fecTrlr.type = FEC_REPAIR;
 
+    // The repair payload starts as a copy of the first original, which the
+    // remaining originals are XORed into. Only the part of the buffer that
+    // the longest original covers needs to be zeroed.
     rpkt  = packet_pool_.Clone(qpkt, false, iron::PACKET_NO_TIMESTAMP);
     rptr  = rpkt->GetBuffer();
     rdata = rptr + rpkt->GetIpPayloadOffset();
     rlen  = rpkt->GetLengthInBytes();
 
-    memset (&rptr[rlen],0,rpkt->GetMaxLengthInBytes()-rlen);
+    dump_fec_copy_bytes_ += rlen;
+
+    int  zero_len = rlen;
+
+    for (i=1; i< orig_count_; i++)
+    {
+      qpkt = orig_cache_[i];
+      qlen = (rdata - rptr) + qpkt->GetLengthInBytes() -
+        qpkt->GetIpPayloadOffset() - sizeof(fecTrlr);
+
+      if (zero_len < qlen)
+      {
+        zero_len = qlen;
+      }
+    }
+
+    memset (&rptr[rlen],0,zero_len-rlen);
     rlen -= (rdata - rptr);
 
     fecLen = (unsigned short)rlen;
@@ -982,24 +1019,19 @@ bool EncodingState::UpdateFEC(struct timeval *currentTime)
       rlen++;
     }
 
+    // The repair packets carry the headers of the first original. Their
+    // payloads are written entirely by the encoder, so nothing else is
+    // copied into them.
     qpkt = orig_cache_[0];
 
     fec_count_ = 0;
     for (i=0; i<fecRate; i++)
     {
-      // On the first pass we clone an original packet and set its length
-      if (i == 0)
-      {
-        qpkt = orig_cache_[0];
-        rpkt = packet_pool_.Clone(qpkt, false, iron::PACKET_NOW_TIMESTAMP);
-        rpkt->UpdateIpLen(rlen + rpkt->GetIpPayloadOffset());
-      }
+      rpkt = CreateRepairPkt(qpkt, rlen);
 
-      // On subsequent passes can simply duplicate an existing repair packet
-      else
+      if (rpkt == NULL)
       {
-        qpkt = fec_cache_[i-1];
-        rpkt = packet_pool_.Clone(qpkt, false, iron::PACKET_NOW_TIMESTAMP);
+        break;
       }
 
       fec_cache_[i] = rpkt;
@@ -1010,26 +1042,73 @@ bool EncodingState::UpdateFEC(struct timeval *currentTime)
       pfec[i] = rdata;
     }
 
-    encode_vdmfec (pdata, szArray, orig_count_, pfec, fecSz, fec_count_);
-
-    // Finish setting up the FEC control and repair trailers
+    if (fec_count_ == 0)
+    {
+      // Treat this as a benign encoding, so the group is still sent.
+      LogW(kClassName, __func__, "fid: %" PRIu32 ", unable to create repair "
+           "packets.\n", flow_tag_);
+      return true;
+    }
 
     repTrlr.base_rate = baseRate;
     repTrlr.fec_rate  = fecRate;
 
-    for (i=0; i<fec_count_; i++)
+    // Hand the group to the FEC codec threads, if they are running. The job
+    // holds references to the originals, as the cache is flushed once the
+    // group is sent. The repair packets are enqueued when the job returns.
+    FecCodecJob*  job = udp_proxy_.GetFecCodecJob(FEC_CODEC_ENCODE,
+                                                  four_tuple_, group_id_);
+
+    if (job != NULL)
     {
-      fecTrlr.slot_id          = i;
+      for (i=0; i<orig_count_; i++)
+      {
+        packet_pool_.PacketShallowCopy(orig_cache_[i]);
+        job->src_pkts[i] = orig_cache_[i];
+        job->psrc[i]     = pdata[i];
+        job->src_sz[i]   = szArray[i];
+      }
+
+      for (i=0; i<fec_count_; i++)
+      {
+        job->dst_pkts[i] = fec_cache_[i];
+        job->pdst[i]     = pfec[i];
+        fec_cache_[i]    = NULL;
+      }
+
       fecTrlr.total_bytes_sent = src_info_.total_bytes_sent();
       fecTrlr.seq_number       = original_pkt_seq_num_;
-      repTrlr.fec_len          = fecSz[i];
 
-      rpkt = fec_cache_[i];
-      rpkt->AppendBlockToEnd((uint8_t*)&repTrlr,sizeof(repTrlr));
-      rpkt->AppendBlockToEnd((uint8_t*)&fecTrlr,sizeof(fecTrlr));
+      job->num_src  = orig_count_;
+      job->num_dst  = fec_count_;
+      job->fec_trlr = fecTrlr;
+      job->rep_trlr = repTrlr;
+
+      fec_count_ = 0;
+      udp_proxy_.SubmitFecCodecJob(job);
+    }
+    else
+    {
+      encode_vdmfec (pdata, szArray, orig_count_, pfec, fecSz, fec_count_);
+
+      // Finish setting up the FEC control and repair trailers
+
+      for (i=0; i<fec_count_; i++)
+      {
+        fecTrlr.slot_id          = i;
+        fecTrlr.total_bytes_sent = src_info_.total_bytes_sent();
+        fecTrlr.seq_number       = original_pkt_seq_num_;
+        repTrlr.fec_len          = fecSz[i];
+
+        rpkt = fec_cache_[i];
+        rpkt->AppendBlockToEnd((uint8_t*)&repTrlr,sizeof(repTrlr));
+        rpkt->AppendBlockToEnd((uint8_t*)&fecTrlr,sizeof(fecTrlr));
+      }
     }
   }
 
+  ++dump_fec_grp_number_;
+
   // If we had a straggler, we need to restore the FEC control trailer
   // and recompute the checksums (the straggler hasn't yet been
   // transmitted)
@@ -1037,6 +1116,68 @@ bool EncodingState::UpdateFEC(struct timeval *currentTime)
   return (true);
 }
 
+//============================================================================
+void EncodingState::CompleteFecCodecJob(FecCodecJob* job)
+{
+  if (job->expired)
+  {
+    LogW(kClassName, __func__, "fid: %" PRIu32 ", FEC group %d missed its "
+         "offload deadline, dropping %d repair packets.\n", flow_tag_,
+         job->group_id, job->num_dst);
+    return;
+  }
+
+  FECControlTrailer  fec_trlr = job->fec_trlr;
+  FECRepairTrailer   rep_trlr = job->rep_trlr;
+
+  for (int i = 0; i < job->num_dst; ++i)
+  {
+    Packet*  rpkt = job->dst_pkts[i];
+
+    fec_trlr.slot_id = i;
+    rep_trlr.fec_len = job->fec_sz[i];
+
+    rpkt->AppendBlockToEnd((uint8_t*)&rep_trlr, sizeof(rep_trlr));
+    rpkt->AppendBlockToEnd((uint8_t*)&fec_trlr, sizeof(fec_trlr));
+
+    // Enqueue the packets, they will be sent by admission control. The
+    // packets that cannot be enqueued are left for the job to recycle.
+    if (!encoded_pkts_queue_.Enqueue(rpkt))
+    {
+      LogW(kClassName, __func__, "fid: %" PRIu32 ", error enqueuing FEC "
+           "packet to encoded packets queue.\n", flow_tag_);
+      break;
+    }
+
+    job->dst_pkts[i] = NULL;
+
+    std::string metadata = rpkt->GetPacketMetadataString();
+    LogD(kClassName, __func__, "fid: %" PRIu32 ", FEC packet %s enqueued.\n",
+         flow_tag_, metadata.c_str());
+  }
+}
+
+//============================================================================
+Packet* EncodingState::CreateRepairPkt(Packet* hdr_pkt, int payload_len)
+{
+  Packet*  rpkt = packet_pool_.CloneHeaderOnly(hdr_pkt,
+                                               iron::PACKET_NOW_TIMESTAMP);
+
+  if (rpkt == NULL)
+  {
+    LogW(kClassName, __func__, "fid: %" PRIu32 ", failed to create repair "
+         "packet.\n", flow_tag_);
+    return NULL;
+  }
+
+  size_t  hdr_len = rpkt->GetLengthInBytes();
+
+  rpkt->UpdateIpLen(hdr_len + payload_len);
+  dump_fec_copy_bytes_ += hdr_len;
+
+  return rpkt;
+}
+
 //============================================================================
 bool EncodingState::UpdateEncodingParams(int baseRate, int totalRate,
                                          bool in_order, int maxChunkSz,
@@ -1185,6 +1326,7 @@ void EncodingState::WriteStats(Time& now, string& log_str,
   //   "bin_id"          : x,
   //   "src_rate"        : xxx.xxx
   //   "toggle_count"    : xxx
+  //   "fec_copy_bytes_per_grp" : xxxx.xxx
 
   double  rate_bps = 0.0;
   double  pps      = 0.0;
@@ -1200,6 +1342,14 @@ void EncodingState::WriteStats(Time& now, string& log_str,
       (dump_pkt_number_ * 1000000.0) / delta_usec);
   }
 
+  double  fec_copy_bytes_per_grp = 0.0;
+
+  if (dump_fec_grp_number_ > 0)
+  {
+    fec_copy_bytes_per_grp = static_cast<double>(dump_fec_copy_bytes_) /
+      static_cast<double>(dump_fec_grp_number_);
+  }
+
   int    flow_state = iron::UNDEFINED;
   double priority       = 0.0;
   uint32_t toggle_count = 0;
@@ -1270,8 +1420,11 @@ void EncodingState::WriteStats(Time& now, string& log_str,
       StringUtils::FormatString(256, "'src_rate':'%f'",
                                 src_rate_estimator_.avg_src_rate()));
     log_str.append(
-      StringUtils::FormatString(256, "'toggle_count':'%" PRIu32 "'}",
+      StringUtils::FormatString(256, "'toggle_count':'%" PRIu32 "', ",
       toggle_count));
+    log_str.append(
+      StringUtils::FormatString(256, "'fec_copy_bytes_per_grp':'%f'}",
+                                fec_copy_bytes_per_grp));
 
   }
 
@@ -1326,12 +1479,17 @@ void EncodingState::WriteStats(Time& now, string& log_str,
     writer->Key("toggle_count");
     writer->Uint(toggle_count);
 
+    writer->Key("fec_copy_bytes_per_grp");
+    writer->Double(fec_copy_bytes_per_grp);
+
     writer->EndObject();
   }
 
   // Reset the per interval statistics.
-  dump_byte_number_ = 0;
-  dump_pkt_number_  = 0;
+  dump_byte_number_    = 0;
+  dump_pkt_number_     = 0;
+  dump_fec_grp_number_ = 0;
+  dump_fec_copy_bytes_ = 0;
   last_report_time_ = now;
 }
 
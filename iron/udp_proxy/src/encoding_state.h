@@ -66,6 +66,7 @@
 
 class AdmissionController;
 class UdpProxy;
+struct FecCodecJob;
 
 /// UDP proxy encoding state object.
 class EncodingState
@@ -124,6 +125,58 @@ class EncodingState
   /// \param  now  The current time.
   void SvcEvents(iron::Time& now);
 
+  /// \brief Enqueue the repair packets of a FEC group that was encoded by
+  /// the FEC codec threads.
+  ///
+  /// The repair packets are dropped if the job missed its deadline.
+  ///
+  /// \param  job  The returned job. The repair packets that are enqueued
+  ///              are removed from the job.
+  void CompleteFecCodecJob(FecCodecJob* job);
+
+  /// \brief Get the time of the next encoding event.
+  ///
+  /// \return The time of the next encoding event. A zero time indicates
+  ///         that the flow must be serviced on the next pass.
+  iron::Time NextEventTime();
+
+  /// \brief Get the time at which the UDP Proxy will next service the
+  /// encoding state.
+  ///
+  /// \return The time at which the state is scheduled for service.
+  inline const iron::Time& svc_deadline() const
+  {
+    return svc_deadline_;
+  }
+
+  /// \brief Set the time at which the UDP Proxy will next service the
+  /// encoding state.
+  ///
+  /// \param  deadline  The time at which the state is scheduled for service.
+  inline void set_svc_deadline(const iron::Time& deadline)
+  {
+    svc_deadline_ = deadline;
+  }
+
+  /// \brief Get the time at which the UDP Proxy will next check the encoding
+  /// state for garbage collection.
+  ///
+  /// \return The time at which the state is scheduled for expiration.
+  inline const iron::Time& gc_deadline() const
+  {
+    return gc_deadline_;
+  }
+
+  /// \brief Set the time at which the UDP Proxy will next check the encoding
+  /// state for garbage collection.
+  ///
+  /// \param  deadline  The time at which the state is scheduled for
+  ///                   expiration.
+  inline void set_gc_deadline(const iron::Time& deadline)
+  {
+    gc_deadline_ = deadline;
+  }
+
   /// \brief  Sends a packet to the BPF, if one is available.
   ///
   /// The proxy's admission controller has determined that a packet can be
@@ -326,8 +379,10 @@ class EncodingState
   /// Note: this method is public to support unit testing.
   inline void ClearDumpStats()
   {
-    dump_byte_number_ = 0;
-    dump_pkt_number_  = 0;
+    dump_byte_number_    = 0;
+    dump_pkt_number_     = 0;
+    dump_fec_grp_number_ = 0;
+    dump_fec_copy_bytes_ = 0;
   }
 
   /// \brief Update a parameter of the utility function for this state.
@@ -441,6 +496,13 @@ class EncodingState
   /// Last time this was accessed (used for garbage collection).
   time_t                last_time_;
 
+  /// The time at which the UDP Proxy next services this state.
+  iron::Time            svc_deadline_;
+
+  /// The time at which the UDP Proxy next checks this state for garbage
+  /// collection.
+  iron::Time            gc_deadline_;
+
   /// Current group we are encoding.
   int                   group_id_;
 
@@ -573,6 +635,14 @@ class EncodingState
   /// The number of packets sent or received since the last dump.
   uint64_t              dump_pkt_number_;
 
+  /// The number of FEC groups for which repair packets were generated since
+  /// the last dump.
+  uint64_t              dump_fec_grp_number_;
+
+  /// The number of bytes copied from original packets into repair packets
+  /// since the last dump.
+  uint64_t              dump_fec_copy_bytes_;
+
   /// The number of packets sent or received since proxy start.
   uint64_t              total_byte_number_;
 
@@ -646,6 +716,18 @@ class EncodingState
   /// \return  FECSTATE_OKAY on success, error code otherwise
   bool DisassembleIntoCache(iron::Packet* qpkt, int* start, int* num);
 
+  /// \brief Create a repair packet from the headers of an original chunk
+  /// packet.
+  ///
+  /// Only the IP and UDP headers are copied into the new packet. The payload
+  /// is left for the FEC encoder to write.
+  ///
+  /// \param  hdr_pkt      The chunk packet whose headers are used.
+  /// \param  payload_len  The length of the repair payload, in bytes.
+  ///
+  /// \return The repair packet, or NULL if it cannot be created.
+  iron::Packet* CreateRepairPkt(iron::Packet* hdr_pkt, int payload_len);
+
   /// \brief Retrieve a chunk packet from the cache: no trailers are removed.
   ///
   /// \param  cacheType  Specifies whether an original or repair chunk is
@@ -0,0 +1,323 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "fec_codec.h"
+
+#include "log.h"
+#include "vdmfec.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <string.h>
+
+using ::iron::Time;
+using ::std::vector;
+
+namespace
+{
+  /// Class name for logging.
+  const char  kClassName[] = "FecCodec";
+}
+
+//============================================================================
+FecCodecJob::FecCodecJob()
+    : op(FEC_CODEC_ENCODE),
+      four_tuple(),
+      group_id(0),
+      job_id(0),
+      deadline(),
+      expired(false),
+      rc(0),
+      num_src(0),
+      num_dst(0),
+      fec_trlr(),
+      rep_trlr(),
+      done_queue(NULL)
+{
+  ::memset(src_pkts, 0, sizeof(src_pkts));
+  ::memset(psrc,     0, sizeof(psrc));
+  ::memset(src_sz,   0, sizeof(src_sz));
+  ::memset(index,    0, sizeof(index));
+  ::memset(fec_sz,   0, sizeof(fec_sz));
+  ::memset(dst_pkts, 0, sizeof(dst_pkts));
+  ::memset(pdst,     0, sizeof(pdst));
+  ::memset(rec_sz,   0, sizeof(rec_sz));
+}
+
+//============================================================================
+FecCodecQueue::FecCodecQueue()
+    : jobs_(),
+      mutex_()
+{
+  pthread_mutex_init(&mutex_, NULL);
+}
+
+//============================================================================
+FecCodecQueue::~FecCodecQueue()
+{
+  pthread_mutex_destroy(&mutex_);
+}
+
+//============================================================================
+void FecCodecQueue::Push(FecCodecJob* job)
+{
+  pthread_mutex_lock(&mutex_);
+  jobs_.push_back(job);
+  pthread_mutex_unlock(&mutex_);
+}
+
+//============================================================================
+void FecCodecQueue::Swap(vector<FecCodecJob*>& jobs)
+{
+  pthread_mutex_lock(&mutex_);
+  jobs.swap(jobs_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+//============================================================================
+FecCodec::FecCodec(uint32_t num_threads)
+    : num_threads_(num_threads),
+      workers_(NULL),
+      running_(false)
+{
+  workers_ = new (std::nothrow) Worker[num_threads_];
+
+  if (workers_ == NULL)
+  {
+    LogF(kClassName, __func__, "Error allocating %" PRIu32 " FEC codec "
+         "threads.\n", num_threads_);
+    return;
+  }
+
+  for (uint32_t i = 0; i < num_threads_; ++i)
+  {
+    pthread_mutex_init(&workers_[i].mutex, NULL);
+    pthread_cond_init(&workers_[i].cond, NULL);
+  }
+}
+
+//============================================================================
+FecCodec::~FecCodec()
+{
+  Stop();
+
+  if (workers_ == NULL)
+  {
+    return;
+  }
+
+  for (uint32_t i = 0; i < num_threads_; ++i)
+  {
+    pthread_cond_destroy(&workers_[i].cond);
+    pthread_mutex_destroy(&workers_[i].mutex);
+  }
+
+  delete [] workers_;
+  workers_ = NULL;
+}
+
+//============================================================================
+bool FecCodec::Start()
+{
+  if ((workers_ == NULL) || running_)
+  {
+    return false;
+  }
+
+  // Block all signals while creating the codec threads, so that the threads
+  // inherit a full signal mask and signals are handled by the main thread.
+  sigset_t  all_sigs;
+  sigset_t  old_sigs;
+  sigfillset(&all_sigs);
+  pthread_sigmask(SIG_SETMASK, &all_sigs, &old_sigs);
+
+  running_ = true;
+
+  for (uint32_t i = 0; i < num_threads_; ++i)
+  {
+    Worker&  worker = workers_[i];
+
+    worker.running = true;
+
+    if (pthread_create(&worker.thread, NULL, &FecCodec::WorkerThreadMain,
+                       &worker) != 0)
+    {
+      LogE(kClassName, __func__, "Error creating FEC codec thread %" PRIu32
+           ": %s.\n", i, strerror(errno));
+      worker.running = false;
+      running_       = false;
+      break;
+    }
+
+    worker.thread_started = true;
+  }
+
+  pthread_sigmask(SIG_SETMASK, &old_sigs, NULL);
+
+  if (!running_)
+  {
+    Stop();
+    return false;
+  }
+
+  LogI(kClassName, __func__, "Started %" PRIu32 " FEC codec threads.\n",
+       num_threads_);
+
+  return true;
+}
+
+//============================================================================
+void FecCodec::Stop()
+{
+  if (workers_ == NULL)
+  {
+    return;
+  }
+
+  running_ = false;
+
+  for (uint32_t i = 0; i < num_threads_; ++i)
+  {
+    Worker&  worker = workers_[i];
+
+    if (worker.thread_started)
+    {
+      pthread_mutex_lock(&worker.mutex);
+      worker.running = false;
+      pthread_cond_signal(&worker.cond);
+      pthread_mutex_unlock(&worker.mutex);
+
+      pthread_join(worker.thread, NULL);
+      worker.thread_started = false;
+    }
+
+    // Return the jobs that were not run, so that their submitters release
+    // the packets that they hold.
+    for (size_t j = 0; j < worker.jobs.size(); ++j)
+    {
+      FecCodecJob*  job = worker.jobs[j];
+      job->expired = true;
+      job->done_queue->Push(job);
+    }
+    worker.jobs.clear();
+  }
+}
+
+//============================================================================
+void FecCodec::Submit(FecCodecJob* job)
+{
+  Worker&  worker = workers_[job->four_tuple.Hash() % num_threads_];
+
+  pthread_mutex_lock(&worker.mutex);
+  worker.jobs.push_back(job);
+  if (worker.jobs.size() == 1)
+  {
+    pthread_cond_signal(&worker.cond);
+  }
+  pthread_mutex_unlock(&worker.mutex);
+}
+
+//============================================================================
+void FecCodec::RunJob(FecCodecJob* job)
+{
+  if (job->op == FEC_CODEC_ENCODE)
+  {
+    encode_vdmfec(job->psrc, job->src_sz, job->num_src, job->pdst,
+                  job->fec_sz, job->num_dst);
+    job->rc = 0;
+  }
+  else
+  {
+    job->rc = decode_vdmfec(job->psrc, job->pdst, job->index, job->num_src,
+                            job->src_sz, job->fec_sz, job->rec_sz);
+  }
+}
+
+//============================================================================
+void* FecCodec::WorkerThreadMain(void* arg)
+{
+  Worker*  worker = static_cast<Worker*>(arg);
+
+  RunWorker(*worker);
+
+  return NULL;
+}
+
+//============================================================================
+void FecCodec::RunWorker(Worker& worker)
+{
+  vector<FecCodecJob*>  jobs;
+
+  pthread_mutex_lock(&worker.mutex);
+
+  while (worker.running)
+  {
+    if (worker.jobs.empty())
+    {
+      pthread_cond_wait(&worker.cond, &worker.mutex);
+      continue;
+    }
+
+    jobs.swap(worker.jobs);
+    pthread_mutex_unlock(&worker.mutex);
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+      FecCodecJob*  job = jobs[i];
+
+      // A job that has waited past its deadline is returned without running
+      // the codec, so a backlog does not delay the groups behind it.
+      if (Time::Now() > job->deadline)
+      {
+        job->expired = true;
+      }
+      else
+      {
+        RunJob(job);
+      }
+
+      job->done_queue->Push(job);
+    }
+
+    jobs.clear();
+
+    pthread_mutex_lock(&worker.mutex);
+  }
+
+  pthread_mutex_unlock(&worker.mutex);
+}
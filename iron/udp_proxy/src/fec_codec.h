@@ -0,0 +1,289 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+/// Provides the UDP Proxy with threads that run the VDM FEC codec off of the
+/// service loop.
+
+#ifndef IRON_UDP_PROXY_FEC_CODEC_H
+#define IRON_UDP_PROXY_FEC_CODEC_H
+
+#include "fec_defs.h"
+#include "four_tuple.h"
+#include "itime.h"
+#include "packet.h"
+#include "udp_fec_trailer.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <vector>
+
+class FecCodecQueue;
+
+/// The operation performed by a FEC codec job.
+enum FecCodecOp
+{
+  FEC_CODEC_ENCODE,
+  FEC_CODEC_DECODE
+};
+
+/// A FEC group handed to the FEC codec threads.
+///
+/// The job holds a reference to each packet whose buffer it points into, so
+/// that the buffers stay valid if the owning state flushes the group while
+/// the job is in flight. All packet references are acquired and released by
+/// the thread that submitted the job. The codec threads only run the codec
+/// on the buffers.
+struct FecCodecJob
+{
+  FecCodecJob();
+
+  /// The codec operation.
+  FecCodecOp         op;
+
+  /// The 4-tuple of the flow that the group belongs to.
+  iron::FourTuple    four_tuple;
+
+  /// The FEC group id.
+  int                group_id;
+
+  /// The job id, unique within the submitting UDP Proxy.
+  uint64_t           job_id;
+
+  /// The time by which the codec must start on the job. A job that is not
+  /// started by then is returned unprocessed.
+  iron::Time         deadline;
+
+  /// True if the job was returned unprocessed because it missed its
+  /// deadline.
+  bool               expired;
+
+  /// The codec return code. Zero on success.
+  int                rc;
+
+  /// The number of source buffers.
+  int                num_src;
+
+  /// The number of destination buffers.
+  int                num_dst;
+
+  /// The packets holding the source buffers, or NULL.
+  iron::Packet*      src_pkts[MAX_FEC_RATE];
+
+  /// The source buffers.
+  unsigned char*     psrc[MAX_FEC_RATE];
+
+  /// The source buffer lengths, in bytes.
+  unsigned short     src_sz[MAX_FEC_RATE];
+
+  /// The decoder slot index of each source buffer.
+  int                index[MAX_FEC_RATE];
+
+  /// The FEC lengths, written by the encoder and read by the decoder.
+  unsigned short     fec_sz[MAX_FEC_RATE];
+
+  /// The packets holding the destination buffers, or NULL. These are the
+  /// repair packets when encoding and the reconstructed originals when
+  /// decoding.
+  iron::Packet*      dst_pkts[MAX_FEC_RATE];
+
+  /// The destination buffers.
+  unsigned char*     pdst[MAX_FEC_RATE];
+
+  /// The reconstructed buffer lengths, in bytes, written by the decoder.
+  unsigned short     rec_sz[MAX_FEC_RATE];
+
+  /// The FEC control trailer to append to the repair packets.
+  FECControlTrailer  fec_trlr;
+
+  /// The FEC repair trailer to append to the repair packets.
+  FECRepairTrailer   rep_trlr;
+
+  /// The queue that the finished job is returned on.
+  FecCodecQueue*     done_queue;
+
+}; // end struct FecCodecJob
+
+/// A queue of FEC codec jobs shared between threads.
+///
+/// The consumer takes all of the queued jobs at once, so the queue lock is
+/// held for one swap per batch rather than once per job.
+class FecCodecQueue
+{
+  public:
+
+  /// \brief Constructor.
+  FecCodecQueue();
+
+  /// \brief Destructor.
+  virtual ~FecCodecQueue();
+
+  /// \brief Add a job to the end of the queue.
+  ///
+  /// \param  job  The job.
+  void Push(FecCodecJob* job);
+
+  /// \brief Take all of the queued jobs.
+  ///
+  /// \param  jobs  An empty vector, which is filled with the queued jobs in
+  ///               the order that they were pushed.
+  void Swap(std::vector<FecCodecJob*>& jobs);
+
+  private:
+
+  /// \brief Copy constructor.
+  FecCodecQueue(const FecCodecQueue& q);
+
+  /// \brief Assignment operator.
+  FecCodecQueue& operator=(const FecCodecQueue& q);
+
+  /// The queued jobs.
+  std::vector<FecCodecJob*>  jobs_;
+
+  /// The mutex to protect the queued jobs.
+  pthread_mutex_t            mutex_;
+
+}; // end class FecCodecQueue
+
+/// The FEC codec threads.
+///
+/// Jobs are assigned to a thread by flow, and each thread runs its jobs in
+/// the order that they were submitted, so the jobs of a flow are returned in
+/// order. init_vdmfec() must be called before the threads are started.
+class FecCodec
+{
+  public:
+
+  /// \brief Constructor.
+  ///
+  /// \param  num_threads  The number of codec threads.
+  FecCodec(uint32_t num_threads);
+
+  /// \brief Destructor.
+  ///
+  /// Stops the codec threads, if they are running.
+  virtual ~FecCodec();
+
+  /// \brief Start the codec threads.
+  ///
+  /// \return True if successful, false otherwise.
+  bool Start();
+
+  /// \brief Stop and join the codec threads.
+  ///
+  /// Jobs that have not been run are returned unprocessed, marked as
+  /// expired, on their done queues.
+  void Stop();
+
+  /// \brief Hand a job to the codec thread that serves its flow.
+  ///
+  /// \param  job  The job. It is returned on its done queue.
+  void Submit(FecCodecJob* job);
+
+  /// \brief Run the codec for a job on the calling thread.
+  ///
+  /// \param  job  The job.
+  static void RunJob(FecCodecJob* job);
+
+  /// \brief Check if the codec threads are running.
+  ///
+  /// \return True if the codec threads are running, false otherwise.
+  inline bool running() const
+  {
+    return running_;
+  }
+
+  /// \brief Get the number of codec threads.
+  ///
+  /// \return The number of codec threads.
+  inline uint32_t num_threads() const
+  {
+    return num_threads_;
+  }
+
+  private:
+
+  /// Information for one codec thread.
+  struct Worker
+  {
+    Worker()
+        : thread(),
+          thread_started(false),
+          running(false),
+          mutex(),
+          cond(),
+          jobs()
+    { }
+
+    pthread_t                  thread;
+    bool                       thread_started;
+    bool                       running;
+    pthread_mutex_t            mutex;
+    pthread_cond_t             cond;
+    std::vector<FecCodecJob*>  jobs;
+
+  }; // end struct Worker
+
+  /// \brief Copy constructor.
+  FecCodec(const FecCodec& fc);
+
+  /// \brief Assignment operator.
+  FecCodec& operator=(const FecCodec& fc);
+
+  /// \brief The codec thread entry point.
+  ///
+  /// \param  arg  A pointer to the Worker.
+  ///
+  /// \return Always NULL.
+  static void* WorkerThreadMain(void* arg);
+
+  /// \brief The codec thread loop.
+  ///
+  /// \param  worker  The Worker information for this thread.
+  static void RunWorker(Worker& worker);
+
+  /// The number of codec threads.
+  uint32_t  num_threads_;
+
+  /// The array of codec threads.
+  Worker*   workers_;
+
+  /// True if the codec threads are running.
+  bool      running_;
+
+}; // end class FecCodec
+
+#endif // IRON_UDP_PROXY_FEC_CODEC_H
@@ -37,7 +37,9 @@
 
 #include "fec_state.h"
 #include "decoding_state.h"
+#include "fec_codec.h"
 #include "log.h"
+#include "udp_proxy.h"
 #include "packet_pool.h"
 #include "unused.h"
 #include "vdmfec.h"
@@ -83,6 +85,9 @@ FecState::FecState(iron::PacketPool& packet_pool)
   expiration_time_ = Time(0);
   fec_used_        =  true;
   decoding_state_  = NULL;
+  decode_job_id_     = 0;
+  decode_deadline_   = Time(0);
+  decode_offloaded_  = false;
 
   for (i = 0; i < MAX_FEC_RATE; i++)
   {
@@ -133,6 +138,9 @@ void FecState::Initialize()
   expiration_time_ = Time(0);
   fec_used_        =  true;
   decoding_state_  = NULL;
+  decode_job_id_     = 0;
+  decode_deadline_   = Time(0);
+  decode_offloaded_  = false;
 
   bytes_sourced_  = 0;
   bytes_released_ = 0;
@@ -543,6 +551,14 @@ bool FecState::UpdateFEC()
 
   else // Must be we used the VDM FEC code
   {
+    // The repair trailers are removed when the group is handed to the FEC
+    // codec threads, so it is only ever handed over once.
+    if (decode_offloaded_)
+    {
+      return false;
+    }
+
+    Packet        *srcPkt [MAX_FEC_RATE];
     unsigned char *psrc   [MAX_FEC_RATE];
     unsigned char *pdst   [MAX_FEC_RATE];
     int            index  [MAX_FEC_RATE];
@@ -550,6 +566,7 @@ bool FecState::UpdateFEC()
     unsigned short fecSz  [MAX_FEC_RATE];
     unsigned short recSz  [MAX_FEC_RATE];
 
+    memset(srcPkt,  0, sizeof(srcPkt));
     memset(psrc,    0, sizeof(psrc));
     memset(pdst,    0, sizeof(pdst));
     memset(index,   0, sizeof(index));
@@ -566,6 +583,7 @@ bool FecState::UpdateFEC()
         qdata = qptr + qpkt->GetIpPayloadOffset();
         qlen  = qpkt->GetLengthInBytes() - (qdata - qptr);
 
+        srcPkt[j]  = qpkt;
         psrc[j]    = qdata;
         szArray[j] = qlen;
         fecSz[j]   = qlen;
@@ -591,6 +609,7 @@ bool FecState::UpdateFEC()
         rdata = rptr + rpkt->GetIpPayloadOffset();
         rlen  = rpkt->GetLengthInBytes() - (rdata - rptr);
 
+        srcPkt[j]  = rpkt;
         psrc[j]    = rdata;
         szArray[j] = rlen;
         fecSz[j]   = repTrlr.fec_len;
@@ -623,6 +642,48 @@ bool FecState::UpdateFEC()
       }
     }
 
+    // Hand the group to the FEC codec threads, if they are running. The job
+    // holds references to the packets that it decodes from, and owns the
+    // reconstruction targets until CompleteDecode() installs them.
+    FecCodecJob*  job = NULL;
+
+    if (decoding_state_ != NULL)
+    {
+      job = decoding_state_->udp_proxy()->GetFecCodecJob(
+        FEC_CODEC_DECODE, decoding_state_->four_tuple(), group_id_);
+    }
+
+    if (job != NULL)
+    {
+      for (i=0; i<base_rate_; i++)
+      {
+        packet_pool_.PacketShallowCopy(srcPkt[i]);
+        job->src_pkts[i] = srcPkt[i];
+        job->psrc[i]     = psrc[i];
+        job->src_sz[i]   = szArray[i];
+        job->fec_sz[i]   = fecSz[i];
+        job->index[i]    = index[i];
+        job->pdst[i]     = pdst[i];
+
+        if (!orig_valid_[i])
+        {
+          job->dst_pkts[i] = orig_cache_[i];
+          orig_cache_[i]   = NULL;
+        }
+      }
+
+      job->num_src = base_rate_;
+      job->num_dst = base_rate_;
+
+      decode_job_id_    = job->job_id;
+      decode_deadline_  = job->deadline;
+      decode_offloaded_ = true;
+
+      decoding_state_->udp_proxy()->SubmitFecCodecJob(job);
+
+      return false;
+    }
+
     if ((rc = decode_vdmfec (psrc, pdst, index, base_rate_, szArray, fecSz, recSz)) != 0)
     {
       LogW(kClassName, __func__, "FEC decoding error: decoder returned %d)\n", rc);
@@ -669,6 +730,80 @@ bool FecState::UpdateFEC()
   return true;
 }
 
+//============================================================================
+bool FecState::DecodePending(const Time& now)
+{
+  if (decode_job_id_ == 0)
+  {
+    return false;
+  }
+
+  if (now >= decode_deadline_)
+  {
+    LogW(kClassName, __func__, "FEC group %d missed its offload deadline, "
+         "releasing it without repairs.\n", group_id_);
+    decode_job_id_ = 0;
+    return false;
+  }
+
+  return true;
+}
+
+//============================================================================
+bool FecState::CompleteDecode(FecCodecJob* job)
+{
+  Packet        *rpkt;
+  unsigned char *rptr;
+  unsigned char *rdata;
+
+  if ((decode_job_id_ == 0) || (job->job_id != decode_job_id_))
+  {
+    return false;
+  }
+
+  decode_job_id_ = 0;
+
+  if (job->expired)
+  {
+    LogW(kClassName, __func__, "FEC group %d missed its offload deadline, "
+         "releasing it without repairs.\n", group_id_);
+    return true;
+  }
+
+  if (job->rc != 0)
+  {
+    LogW(kClassName, __func__, "FEC decoding error: decoder returned %d\n",
+         job->rc);
+    return true;
+  }
+
+  LogD(kClassName, __func__, "Decode vdm success\n");
+
+  // Assign the packet lengths and mark the repaired packets as valid. A
+  // slot whose original arrived while the job was in flight keeps the
+  // original.
+  for (int i=0; i<base_rate_; i++)
+  {
+    if ((job->dst_pkts[i] != NULL) && (!orig_valid_[i]))
+    {
+      rpkt  = job->dst_pkts[i];
+      rptr  = rpkt->GetBuffer();
+      rdata = rptr + rpkt->GetIpPayloadOffset();
+
+      rpkt->UpdateIpLen(job->rec_sz[i] + (rdata-rptr));
+
+      orig_cache_[i]   = rpkt;
+      orig_valid_[i]   = true;
+      job->dst_pkts[i] = NULL;
+      orig_count_++;
+
+      UpdateLookupInfo(i);
+    }
+  }
+
+  return true;
+}
+
 //============================================================================
 int FecState::FlushCache()
 {
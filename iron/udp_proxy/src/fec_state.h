@@ -63,6 +63,7 @@
 
 class DecodingState;
 class ReleaseController;
+struct FecCodecJob;
 
 
 /// A FEC state object is used to aggregate packets from a FEC group and
@@ -116,6 +117,35 @@ class FecState
   ///         otherwise.
   bool UpdateFEC();
 
+  /// \brief Check if the group is waiting for the FEC codec threads to
+  /// reconstruct its missing packets.
+  ///
+  /// The group stops waiting once the FEC offload deadline has passed, and
+  /// the packets that are returned for it after that are discarded.
+  ///
+  /// \param  now  The current time.
+  ///
+  /// \return True if the group is waiting for the FEC codec threads, false
+  ///         otherwise.
+  bool DecodePending(const iron::Time& now);
+
+  /// \brief Install the packets reconstructed by the FEC codec threads.
+  ///
+  /// \param  job  The returned job. The installed packets are removed from
+  ///              the job.
+  ///
+  /// \return True if the group was waiting for the job, false otherwise.
+  bool CompleteDecode(FecCodecJob* job);
+
+  /// \brief Get the time after which the group stops waiting for the FEC
+  /// codec threads.
+  ///
+  /// \return The FEC offload deadline of the group.
+  inline const iron::Time& decode_deadline() const
+  {
+    return decode_deadline_;
+  }
+
   /// \brief Function to flush the decoding cache and reset associated control
   /// values in preparation for encoding the next group.
   ///
@@ -345,6 +375,16 @@ class FecState
   /// A pointer to the DecodingState to which this belongs.
   DecodingState*     decoding_state_;
 
+  /// The id of the FEC codec job reconstructing the missing packets, or zero
+  /// if there is none in flight.
+  uint64_t           decode_job_id_;
+
+  /// The time after which the group stops waiting for its FEC codec job.
+  iron::Time         decode_deadline_;
+
+  /// True once the group has been handed to the FEC codec threads.
+  bool               decode_offloaded_;
+
   /// Total number of bytes sent by the source up to and including
   /// this FEC State.
   uint64_t           bytes_sourced_;
@@ -121,6 +121,15 @@ void FlogAdmissionController::SvcEvents(Time& now)
   }
 }
 
+//============================================================================
+Time FlogAdmissionController::NextEventTime()
+{
+  Time  next_time = AdmissionController::NextEventTime();
+  next_time       = Time::Min(next_time, check_utility_time_);
+
+  return next_time;
+}
+
 //============================================================================
 double FlogAdmissionController::ComputeUtility(double rate)
 {
@@ -88,7 +88,9 @@ bool LogAdmissionController::CreateUtilityFn(string& utility_def,
   log_utility_ = new (std::nothrow) LogUtility(queue_depths,
                                                encoding_state_.bin_idx(),
                                                encoding_state_.k_val(),
-                                               flow_id);
+                                               flow_id,
+                                               &(encoding_state_.udp_proxy()->
+                                                 log_utility_batch()));
   if (log_utility_ == NULL)
   {
     LogF(kClassName, __func__, "fid: %" PRIu32 "Unable to allocate memory "
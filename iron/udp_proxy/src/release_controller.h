@@ -67,6 +67,13 @@ class ReleaseController
   /// \param  now  The current time.
   virtual void SvcEvents(iron::Time& now) = 0;
 
+  /// \brief Get the time of the next release control event.
+  ///
+  /// \return The time of the next release control event. A zero time
+  ///         indicates that the flow must be serviced on the next pass, and
+  ///         an infinite time that there are no scheduled events.
+  virtual iron::Time NextEventTime() = 0;
+
   /// \brief Handle an IRON packet.
   ///
   /// \param  pkt  The packet to handle.
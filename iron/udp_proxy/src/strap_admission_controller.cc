@@ -131,6 +131,16 @@ void StrapAdmissionController::SvcEvents(Time& now)
   }
 }
 
+//============================================================================
+Time StrapAdmissionController::NextEventTime()
+{
+  Time  next_time = AdmissionController::NextEventTime();
+  next_time       = Time::Min(next_time, restart_time_);
+  next_time       = Time::Min(next_time, step_time_);
+
+  return next_time;
+}
+
 //============================================================================
 double StrapAdmissionController::ComputeUtility(double rate)
 {
@@ -88,6 +88,11 @@ class StrapAdmissionController : public AdmissionController
   /// \param  now  The current time.
   virtual void SvcEvents(iron::Time& now);
 
+  /// \brief Get the time of the next admission control event.
+  ///
+  /// \return The time of the next admission control event.
+  virtual iron::Time NextEventTime();
+
   /// \brief Get the flow's instantaneous utility.
   ///
   /// \param  rate  The flow's send rate.
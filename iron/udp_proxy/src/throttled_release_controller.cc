@@ -127,6 +127,19 @@ void ThrottledReleaseController::SvcEvents(Time& now)
   }
 }
 
+//============================================================================
+Time ThrottledReleaseController::NextEventTime()
+{
+  // Queued packets are checked against their release time on every service
+  // pass.
+  if (release_pkts_queue_.GetCount() > 0)
+  {
+    return Time();
+  }
+
+  return Time::Infinite();
+}
+
 //============================================================================
 bool ThrottledReleaseController::HandlePkt(Packet* pkt)
 {
@@ -80,6 +80,11 @@ class ThrottledReleaseController : public ReleaseController
   /// \param  now  The current time.
   virtual void SvcEvents(iron::Time& now);
 
+  /// \brief Get the time of the next release control event.
+  ///
+  /// \return The time of the next release control event.
+  virtual iron::Time NextEventTime();
+
   /// \brief Handle an IRON packet.
   ///
   /// \param  pkt  The packet to handle.
@@ -130,6 +130,17 @@ void TrapAdmissionController::SvcEvents(Time& now)
   }
 }
 
+//============================================================================
+Time TrapAdmissionController::NextEventTime()
+{
+  Time  next_time = AdmissionController::NextEventTime();
+  next_time       = Time::Min(next_time, restart_time_);
+  next_time       = Time::Min(next_time, step_time_);
+  next_time       = Time::Min(next_time, check_utility_time_);
+
+  return next_time;
+}
+
 //============================================================================
 double TrapAdmissionController::ComputeUtility(double rate)
 {
@@ -62,6 +62,8 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <fcntl.h>
+#include <signal.h>
+#include <time.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -105,6 +107,7 @@ using ::rapidjson::SizeType;
 using ::rapidjson::StringBuffer;
 using ::rapidjson::Value;
 using ::rapidjson::Writer;
+using ::std::make_pair;
 using ::std::map;
 using ::std::set;
 using ::std::string;
@@ -189,6 +192,33 @@ namespace
   const uint32_t  kDefaultSvcFlowsIntervalUs =
     iron::kDefaultBpfMinBurstUsec / 2;
 
+  /// The interval, in milliseconds, at which encoding states without a
+  /// backlog or pending admission control events are serviced, keeping
+  /// their source rate estimates and send rates current.
+  const uint32_t  kQuietFlowSvcIntervalMs = 100;
+
+  /// The default number of flow shards. A single shard processes all flows
+  /// in the main service loop.
+  const uint32_t  kDefaultNumShards = 1;
+
+  /// The maximum number of flow shards.
+  const uint32_t  kMaxNumShards = 16;
+
+  /// The maximum number of packets waiting in a flow shard's inbound ring.
+  /// Packets dispatched to a full ring are dropped.
+  const size_t    kMaxShardRingPkts = 4096;
+
+  /// The default number of FEC codec threads. Without codec threads, the
+  /// VDM FEC codec runs inline in the service loop.
+  const uint32_t  kDefaultNumFecThreads = 0;
+
+  /// The maximum number of FEC codec threads.
+  const uint32_t  kMaxNumFecThreads = 8;
+
+  /// The default time, in milliseconds, that a FEC group may wait for the
+  /// FEC codec threads.
+  const uint32_t  kDefaultFecOffloadBudgetMs = 20;
+
   /// The default service definition.
   const std::string kDefaultService = "1-65535;1/1;1500;0;0;120;0;type=LOG:"
               "a=20:m=10000000:p=1:label=def_service";
@@ -297,7 +327,14 @@ UdpProxy::UdpProxy(iron::PacketPool& packet_pool,
       fecstate_pool_(fecstate_pool),
       default_utility_def_(),
       bin_states_map_(),
+      enc_svc_sched_(),
+      dec_svc_sched_(),
+      enc_gc_sched_(),
+      dec_gc_sched_(),
+      enc_svc_due_(),
+      dec_svc_due_(),
       k_val_(),
+      log_utility_batch_(local_queue_depths_, k_val_),
       max_queue_depth_pkts_(kDefaultMaxQueueDepthPerFlowPkts),
       drop_policy_(::iron::HEAD),
       bpf_min_burst_usec_(iron::kDefaultBpfMinBurstUsec),
@@ -328,9 +365,24 @@ UdpProxy::UdpProxy(iron::PacketPool& packet_pool,
       do_latency_checks_(kDefaultDoLatencyChecks),
       debug_stats_(NULL),
       max_queue_(),
-      enable_loss_triage_(kDefaultEnableLossTriage)
+      enable_loss_triage_(kDefaultEnableLossTriage),
+      dispatcher_(NULL),
+      num_shards_(kDefaultNumShards),
+      shards_(NULL),
+      flow_tag_stride_(1),
+      bpf_out_pkts_(),
+      lan_send_batch_(edge_if_, packet_pool_),
+      bpf_send_mutex_(),
+      num_fec_threads_(kDefaultNumFecThreads),
+      fec_codec_(NULL),
+      fec_offload_budget_(Time::FromMsec(kDefaultFecOffloadBudgetMs)),
+      fec_done_queue_(),
+      fec_done_jobs_(),
+      next_fec_job_id_(1)
 {
   LogI(cn, __func__," Creating UdpProxy...\n");
+
+  pthread_mutex_init(&bpf_send_mutex_, NULL);
 }
 
 //============================================================================
@@ -362,7 +414,14 @@ UdpProxy::UdpProxy(iron::PacketPool& packet_pool,
       fecstate_pool_(fecstate_pool),
       default_utility_def_(),
       bin_states_map_(),
+      enc_svc_sched_(),
+      dec_svc_sched_(),
+      enc_gc_sched_(),
+      dec_gc_sched_(),
+      enc_svc_due_(),
+      dec_svc_due_(),
       k_val_(),
+      log_utility_batch_(local_queue_depths_, k_val_),
       max_queue_depth_pkts_(kDefaultMaxQueueDepthPerFlowPkts),
       drop_policy_(::iron::HEAD),
       bpf_min_burst_usec_(iron::kDefaultBpfMinBurstUsec),
@@ -395,9 +454,109 @@ UdpProxy::UdpProxy(iron::PacketPool& packet_pool,
       max_queue_(),
       enable_loss_triage_(kDefaultEnableLossTriage),
       norm_low_addr_(),
-      norm_high_addr_()
+      norm_high_addr_(),
+      dispatcher_(NULL),
+      num_shards_(kDefaultNumShards),
+      shards_(NULL),
+      flow_tag_stride_(1),
+      bpf_out_pkts_(),
+      lan_send_batch_(edge_if_, packet_pool_),
+      bpf_send_mutex_(),
+      num_fec_threads_(kDefaultNumFecThreads),
+      fec_codec_(NULL),
+      fec_offload_budget_(Time::FromMsec(kDefaultFecOffloadBudgetMs)),
+      fec_done_queue_(),
+      fec_done_jobs_(),
+      next_fec_job_id_(1)
 {
   LogI(cn, __func__, "Creating UdpProxy...\n");
+
+  pthread_mutex_init(&bpf_send_mutex_, NULL);
+}
+
+//============================================================================
+UdpProxy::UdpProxy(UdpProxy& dispatcher, FecStatePool& fecstate_pool,
+                   uint32_t shard_idx)
+    : edge_if_(dispatcher.edge_if_),
+      running_(false),
+      weight_qd_shared_memory_(dispatcher.weight_qd_shared_memory_),
+      local_queue_depths_(dispatcher.bin_map_shm_),
+      bin_map_shm_(dispatcher.bin_map_shm_),
+      timer_(dispatcher.timer_),
+      gc_interval_sec_(kDefaultGCIntervalSec),
+      decoder_timeout_sec_(kDefaultDecoderTimeoutSec),
+      config(),
+      default_service_(NULL),
+      encoding(),
+      decoding(),
+      flow_defn_cache_(),
+      bpf_to_udp_pkt_fifo_(dispatcher.packet_pool_, NULL, PACKET_OWNER_BPF,
+                           kMaxPktsPerFifoRecv),
+      udp_to_bpf_pkt_fifo_(dispatcher.packet_pool_, NULL, PACKET_OWNER_BPF,
+                           0),
+      packet_pool_(dispatcher.packet_pool_),
+      fecstate_pool_(fecstate_pool),
+      default_utility_def_(),
+      bin_states_map_(),
+      enc_svc_sched_(),
+      dec_svc_sched_(),
+      enc_gc_sched_(),
+      dec_gc_sched_(),
+      enc_svc_due_(),
+      dec_svc_due_(),
+      k_val_(),
+      log_utility_batch_(local_queue_depths_, k_val_),
+      max_queue_depth_pkts_(kDefaultMaxQueueDepthPerFlowPkts),
+      drop_policy_(::iron::HEAD),
+      bpf_min_burst_usec_(iron::kDefaultBpfMinBurstUsec),
+      flow_tag_(kStartTag + shard_idx),
+      mgen_diag_mode_(kDefaultMGENDiagnosticsMode),
+      remote_control_port_(kDefaultRemoteControlPort),
+      remote_control_(),
+      qd_direct_access_(dispatcher.qd_direct_access_),
+      qd_update_interval_us_(kDefaultQueueDepthUpdateIntervalUs),
+      stats_push_(),
+      stats_interval_ms_(kDefaultStatsCollectionIntervalMs),
+      log_stats_(true),
+      total_utility_(0),
+      svc_flows_timer_handle_(),
+      next_sched_svc_flows_time_(Time::Now()),
+      rrm_transmission_time_(Time::Now()),
+      straggler_cleanup_time_(Time::Now()),
+      garbage_collection_time_(Time::Now()),
+      reorder_max_hold_time_(Time(kDefaultMaxHoldTimeSec)),
+      release_records_(),
+      next_decode_exp_time_(Time::Infinite()),
+      do_ttg_tracking_(::iron::kDefaultTtgTracking),
+      garbage_collected_flows_(),
+      ls_latency_collection_(iron::kDefaultLinkStateLatency),
+      total_pkts_sent_(0),
+      total_src_drop_(0),
+      shm_latency_cache_(dispatcher.bin_map_shm_, ::iron::SHM_TYPE_ATTACH),
+      do_latency_checks_(kDefaultDoLatencyChecks),
+      debug_stats_(NULL),
+      max_queue_(),
+      enable_loss_triage_(kDefaultEnableLossTriage),
+      norm_low_addr_(),
+      norm_high_addr_(),
+      dispatcher_(&dispatcher),
+      num_shards_(1),
+      shards_(NULL),
+      flow_tag_stride_(dispatcher.num_shards_),
+      bpf_out_pkts_(),
+      lan_send_batch_(edge_if_, packet_pool_),
+      bpf_send_mutex_(),
+      num_fec_threads_(kDefaultNumFecThreads),
+      fec_codec_(NULL),
+      fec_offload_budget_(Time::FromMsec(kDefaultFecOffloadBudgetMs)),
+      fec_done_queue_(),
+      fec_done_jobs_(),
+      next_fec_job_id_(1)
+{
+  LogI(cn, __func__, "Creating UdpProxy flow shard %" PRIu32 "...\n",
+       shard_idx);
+
+  pthread_mutex_init(&bpf_send_mutex_, NULL);
 }
 
 //============================================================================
@@ -405,8 +564,38 @@ UdpProxy::~UdpProxy()
 {
   LogI(cn, __func__, "Destroying UdpProxy...\n");
 
-  // Cancel all timers.
-  timer_.CancelAllTimers();
+  // Stop and destroy the flow shards, if any, before anything they share.
+  // The FEC codec threads are stopped in between, returning their remaining
+  // jobs to the flow shards for cleanup.
+  StopShards();
+
+  if ((dispatcher_ == NULL) && (fec_codec_ != NULL))
+  {
+    fec_codec_->Stop();
+  }
+
+  DestroyShards();
+
+  // Release the packets held by the returned FEC codec jobs.
+  fec_done_queue_.Swap(fec_done_jobs_);
+  for (size_t i = 0; i < fec_done_jobs_.size(); ++i)
+  {
+    DiscardFecCodecJob(fec_done_jobs_[i]);
+  }
+  fec_done_jobs_.clear();
+
+  if ((dispatcher_ == NULL) && (fec_codec_ != NULL))
+  {
+    delete fec_codec_;
+  }
+  fec_codec_ = NULL;
+
+  // Cancel all timers. Flow shards share the dispatcher's timer and never
+  // start timers.
+  if (dispatcher_ == NULL)
+  {
+    timer_.CancelAllTimers();
+  }
 
 #ifdef DEBUG_STATS
   if (debug_stats_)
@@ -416,7 +605,10 @@ UdpProxy::~UdpProxy()
 #endif // DEBUG_STATS
 
   // Clean up the timer callback object pools.
-  CallbackNoArg<UdpProxy>::EmptyPool();
+  if (dispatcher_ == NULL)
+  {
+    CallbackNoArg<UdpProxy>::EmptyPool();
+  }
 
   // Delete the collection of Service context information.
   map<int, FECContext*>::iterator  c_iter;
@@ -497,6 +689,20 @@ UdpProxy::~UdpProxy()
     }
   }
 
+  // Clean up the garbage collected flow list.
+  garbage_collected_flows_.Clear();
+
+  pthread_mutex_destroy(&bpf_send_mutex_);
+
+  // The remaining resources are shared with, and released by, the
+  // dispatching UDP Proxy, which also reports the packet counts for the
+  // flow shards.
+  if (dispatcher_ != NULL)
+  {
+    LogI(cn, __func__,"UdpProxy flow shard successfully terminated.\n");
+    return;
+  }
+
   // Detached the shared memory.
   weight_qd_shared_memory_.Detach();
   LogD(cn, __func__, "Detached shared memory segments.\n");
@@ -509,9 +715,6 @@ UdpProxy::~UdpProxy()
   // Close the various sockets.
   edge_if_.Close();
 
-  // Clean up the garbage collected flow list.
-  garbage_collected_flows_.Clear();
-
   LogI(cn, __func__,"UdpProxy successfully terminated.\n");
 }
 
@@ -660,40 +863,76 @@ bool UdpProxy::Configure(ConfigInfo& ci, const char* prefix)
                                        kDefaultNormAddressRange);
   ParseNormAddrRangeString(norm_addr_range_str);
 
-  // Log the configuration information.
-  LogC(cn, __func__, "UDP Proxy configuration:\n");
-  LogC(cn, __func__, "RemoteControlPort         : %d\n",
-       remote_control_port_);
-  LogC(cn, __func__, "PPInterval                : %d\n", kPPIntervalMsec);
-  LogC(cn, __func__, "GCIntervalSec             : %d\n", gc_interval_sec_);
-  LogC(cn, __func__, "DecoderTimeoutSec         : %d\n",
-       decoder_timeout_sec_);
-  LogC(cn, __func__, "K                         : %.2e\n",
-       static_cast<double>(k_val_.GetValue()));
-  LogC(cn, __func__, "MaxQueueDepthPerFlowPkts  : %d\n",
-       max_queue_depth_pkts_);
-  LogC(cn, __func__, "DropPolicy                : %s\n",
-       drop_policy_str.c_str());
-  LogC(cn, __func__, "DefaultUtilityFn          : %s\n",
-       default_utility_def_.c_str());
-  LogC(cn, __func__, "DirectAccess              : %s\n",
-       qd_direct_access_ ? "On" : "Off");
-  LogC(cn, __func__, "QueueDepthUpdateIntervalUs: %" PRIu32 "\n",
-       qd_update_interval_us_);
-  LogC(cn, __func__, "StatsCollectionIntervalMs : %" PRIu32 "\n",
-       stats_interval_ms_);
-  LogC(cn, __func__, "LogStatistics             : %s\n",
-       log_stats ? "true" : "false");
-  LogC(cn, __func__, "Time-to-go tracking       : %s\n",
-       (do_ttg_tracking_ ? "On" : "Off"));
-  LogC(cn, __func__, "LS Latency collection     : %s\n",
-       ls_latency_collection_ ? "On" : "Off");
-  LogC(cn, __func__, "Latency checking          : %s\n",
-       (do_latency_checks_ ? "On" : "Off"));
-  LogC(cn, __func__, "Loss Triage               : %s\n",
-       (enable_loss_triage_ ? "On" : "Off"));
-  LogC(cn, __func__, "NORM address range        : %s\n",
-       norm_addr_range_str.c_str());
+  // Extract the number of flow shards. Flow shards do not shard further.
+  if (dispatcher_ == NULL)
+  {
+    num_shards_ = ci.GetUint("NumShards", kDefaultNumShards);
+
+    if ((num_shards_ < 1) || (num_shards_ > kMaxNumShards))
+    {
+      LogF(cn, __func__, "NumShards must be between 1 and %" PRIu32 ".\n",
+           kMaxNumShards);
+      return false;
+    }
+
+    num_fec_threads_ = ci.GetUint("NumFecThreads", kDefaultNumFecThreads);
+
+    if (num_fec_threads_ > kMaxNumFecThreads)
+    {
+      LogF(cn, __func__, "NumFecThreads must be at most %" PRIu32 ".\n",
+           kMaxNumFecThreads);
+      return false;
+    }
+  }
+
+  uint32_t  fec_offload_budget_ms = ci.GetUint("FecOffloadBudgetMs",
+                                               kDefaultFecOffloadBudgetMs);
+  fec_offload_budget_ = Time::FromMsec(fec_offload_budget_ms);
+
+  // Log the configuration information. Flow shards are configured from
+  // the same information, so only the dispatching UDP Proxy logs it.
+  if (dispatcher_ == NULL)
+  {
+    LogC(cn, __func__, "UDP Proxy configuration:\n");
+    LogC(cn, __func__, "RemoteControlPort         : %d\n",
+         remote_control_port_);
+    LogC(cn, __func__, "PPInterval                : %d\n", kPPIntervalMsec);
+    LogC(cn, __func__, "GCIntervalSec             : %d\n", gc_interval_sec_);
+    LogC(cn, __func__, "DecoderTimeoutSec         : %d\n",
+         decoder_timeout_sec_);
+    LogC(cn, __func__, "K                         : %.2e\n",
+         static_cast<double>(k_val_.GetValue()));
+    LogC(cn, __func__, "MaxQueueDepthPerFlowPkts  : %d\n",
+         max_queue_depth_pkts_);
+    LogC(cn, __func__, "DropPolicy                : %s\n",
+         drop_policy_str.c_str());
+    LogC(cn, __func__, "DefaultUtilityFn          : %s\n",
+         default_utility_def_.c_str());
+    LogC(cn, __func__, "DirectAccess              : %s\n",
+         qd_direct_access_ ? "On" : "Off");
+    LogC(cn, __func__, "QueueDepthUpdateIntervalUs: %" PRIu32 "\n",
+         qd_update_interval_us_);
+    LogC(cn, __func__, "StatsCollectionIntervalMs : %" PRIu32 "\n",
+         stats_interval_ms_);
+    LogC(cn, __func__, "LogStatistics             : %s\n",
+         log_stats ? "true" : "false");
+    LogC(cn, __func__, "Time-to-go tracking       : %s\n",
+         (do_ttg_tracking_ ? "On" : "Off"));
+    LogC(cn, __func__, "LS Latency collection     : %s\n",
+         ls_latency_collection_ ? "On" : "Off");
+    LogC(cn, __func__, "Latency checking          : %s\n",
+         (do_latency_checks_ ? "On" : "Off"));
+    LogC(cn, __func__, "Loss Triage               : %s\n",
+         (enable_loss_triage_ ? "On" : "Off"));
+    LogC(cn, __func__, "NORM address range        : %s\n",
+         norm_addr_range_str.c_str());
+    LogC(cn, __func__, "NumShards                 : %" PRIu32 "\n",
+         num_shards_);
+    LogC(cn, __func__, "NumFecThreads             : %" PRIu32 "\n",
+         num_fec_threads_);
+    LogC(cn, __func__, "FecOffloadBudgetMs        : %" PRIu32 "\n",
+         fec_offload_budget_ms);
+  }
 
   // Retrieve zero or more service configurations
   string  pvar;
@@ -743,6 +982,28 @@ bool UdpProxy::Configure(ConfigInfo& ci, const char* prefix)
     LogW(cn, __func__, "Default service definition not configured.\n");
   }
 
+  // Create the FEC codec threads before the flow shards, which share them.
+  if (dispatcher_ != NULL)
+  {
+    fec_codec_ = dispatcher_->fec_codec_;
+  }
+  else if ((num_fec_threads_ > 0) && (fec_codec_ == NULL))
+  {
+    fec_codec_ = new (std::nothrow) FecCodec(num_fec_threads_);
+
+    if (fec_codec_ == NULL)
+    {
+      LogF(cn, __func__, "Error allocating FEC codec threads.\n");
+      return false;
+    }
+  }
+
+  if ((num_shards_ > 1) && (!CreateShards(ci, prefix)))
+  {
+    LogF(cn, __func__, "Unable to create flow shards.\n");
+    return false;
+  }
+
   LogC(cn, __func__, "UDP Proxy configuration complete.\n");
 
   return true;
@@ -842,6 +1103,29 @@ bool UdpProxy::AttachSharedMemory(const ConfigInfo& ci)
     return false;
   }
 
+  // The flow shards read the queue depths and latencies from the same
+  // shared memory segments.
+  for (uint32_t i = 0; (shards_ != NULL) && (i < num_shards_); ++i)
+  {
+    UdpProxy*  shard = shards_[i].proxy;
+
+    if (qd_direct_access_ &&
+        (!shard->local_queue_depths_.InitializeShmDirectAccess(
+          &weight_qd_shared_memory_)))
+    {
+      LogE(cn, __func__, "Unable to attach flow shard %" PRIu32 " to shared "
+           "memory for weight queue depth information.\n", i);
+      return false;
+    }
+
+    if (!shard->shm_latency_cache_.Initialize())
+    {
+      LogW(cn, __func__, "Unable to initialize LatencyCacheShm for flow "
+           "shard %" PRIu32 ".\n", i);
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -854,6 +1138,12 @@ void UdpProxy::Start()
 
   running_ = true;
 
+  if ((fec_codec_ != NULL) && (!fec_codec_->Start()))
+  {
+    LogF(cn, __func__, "Unable to start FEC codec threads.\n");
+    running_ = false;
+  }
+
   Time  now = Time::Now();
 
   // Schedule the initial statistics collection event.
@@ -883,6 +1173,12 @@ void UdpProxy::Start()
        "%" PRId64 ".\n", duration.ToString().c_str(),
        svc_flows_timer_handle_.id());
 
+  if ((shards_ != NULL) && (!StartShards()))
+  {
+    LogF(cn, __func__, "Unable to start flow shard threads.\n");
+    running_ = false;
+  }
+
   while (running_)
   {
     fd_set  read_fds;
@@ -944,7 +1240,14 @@ void UdpProxy::Start()
             LogD(cn, __func__, "RECV: UDP proxy from LAN IF, size: %d bytes.\n",
                  pkt->GetLengthInBytes());
 
-            RunEncoder(pkt);
+            if (shards_ != NULL)
+            {
+              DispatchPkt(pkt, true);
+            }
+            else
+            {
+              RunEncoder(pkt);
+            }
           }
         }
         while (!done);
@@ -955,6 +1258,12 @@ void UdpProxy::Start()
         ReceivePktsFromBpf();
       }
 
+      // Hand the packets received in this pass to the flow shards.
+      if (shards_ != NULL)
+      {
+        FlushDispatchedPkts();
+      }
+
       if (remote_control_.ServiceFileDescriptors(read_fds))
       {
         // Process a received remote control message.
@@ -965,9 +1274,21 @@ void UdpProxy::Start()
     // Process the timer callbacks.
     LogD(cn, __func__, "Processing timer callbacks...\n");
     timer_.DoCallbacks();
+
+    // Send the packets released to the LAN during this pass.
+    lan_send_batch_.Flush();
   }
 
+  lan_send_batch_.Flush();
+
   LogI(cn, __func__, "Stopping UDP Proxy main service loop...\n");
+
+  StopShards();
+
+  if (fec_codec_ != NULL)
+  {
+    fec_codec_->Stop();
+  }
 }
 
 //============================================================================
@@ -984,6 +1305,14 @@ bool UdpProxy::SendToBpf(Packet* pkt)
     return false;
   }
 
+  // A flow shard queues the packet for the dispatching UDP Proxy, which owns
+  // the connection to the BPF.
+  if (dispatcher_ != NULL)
+  {
+    bpf_out_pkts_.push_back(pkt);
+    return true;
+  }
+
   if (!udp_to_bpf_pkt_fifo_.IsOpen())
   {
     if (!udp_to_bpf_pkt_fifo_.OpenSender())
@@ -998,9 +1327,11 @@ bool UdpProxy::SendToBpf(Packet* pkt)
 }
 
 //============================================================================
-ssize_t UdpProxy::SendToLan(Packet* pkt) const
+ssize_t UdpProxy::SendToLan(Packet* pkt)
 {
-  ssize_t bytes_sent = edge_if_.Send(pkt);
+  // The batch takes ownership of the packet and recycles it once it has
+  // been sent.
+  ssize_t bytes_sent = lan_send_batch_.Send(pkt);
 
   LogD(cn, __func__, "SEND: Proxy to LAN IF, size %" PRId32 "bytes.\n",
        bytes_sent);
@@ -1010,9 +1341,6 @@ ssize_t UdpProxy::SendToLan(Packet* pkt) const
     return 0;
   }
 
-  // The transmission was successful, so we can recycle the packet.
-  packet_pool_.Recycle(pkt);
-
   return bytes_sent;
 }
 
@@ -1034,15 +1362,9 @@ void UdpProxy::SvcFlowsTimeout()
   LogD(cn, __func__, "Servicing flows, Queue depths are: %s.\n",
        local_queue_depths_.ToString().c_str());
 
-  // Service all of the encoding states.
-  iron::MashTable<FourTuple, EncodingState*>::WalkState es_walk_state;
-  EncodingState*                                        es  = NULL;
-  bool push_stats_now                                 = false;
-  while (encoding.GetNextItem(es_walk_state, es))
-  {
-    es->SvcEvents(now);
-    push_stats_now = push_stats_now || es->PushStats();
-  }
+  // Service all of the encoding and decoding states. The flow shards service
+  // their own states, and only report toggle events here.
+  bool  push_stats_now = ServiceStates(now);
 
   if (push_stats_now)
   {
@@ -1050,34 +1372,13 @@ void UdpProxy::SvcFlowsTimeout()
     PushStats(false);
   }
 
-  // Service all of the decoding states.
-  iron::MashTable<FourTuple, DecodingState*>::WalkState ds_walk_state;
-  DecodingState*                                        ds  = NULL;
-  while (decoding.GetNextItem(ds_walk_state, ds))
-  {
-    ds->SvcEvents(now);
-  }
-
   // Service the UDP Proxy events.
   if (stats_push_.next_push_time <= now)
   {
     PushStats(true);
   }
 
-  if (straggler_cleanup_time_ <= now)
-  {
-    StragglerCleanupTimeout(now);
-  }
-
-  if (garbage_collection_time_ <= now)
-  {
-    GarbageCollectionTimeout(now);
-  }
-
-  if (rrm_transmission_time_ <= now)
-  {
-    SendRRMs(now);
-  }
+  ServiceEvents(now);
 
   // Schedule the next service flows timer.
   Time  end_time = Time::Now();
@@ -1104,79 +1405,304 @@ void UdpProxy::SvcFlowsTimeout()
 }
 
 //============================================================================
-bool UdpProxy::CreateReleaseRecord(BinIndex bin_idx, FourTuple& four_tuple,
-                                   uint64_t total_bytes_sent,
-                                   uint32_t seq_num, uint8_t priority)
+bool UdpProxy::ServiceStates(Time& now)
 {
-  ReleaseRecord*  release_record  =
-    new (std::nothrow) ReleaseRecord(four_tuple, total_bytes_sent, seq_num,
-                                     priority);
+  bool  push_stats_now = false;
 
-  if (!release_record)
+  // The flow shards service their own states. Collect the toggle events that
+  // they have detected since the last call.
+  if (shards_ != NULL)
   {
-    LogF(cn, __func__, "Failed to allocate release record.\n");
-    return false;
+    for (uint32_t i = 0; i < num_shards_; ++i)
+    {
+      pthread_mutex_lock(&shards_[i].ring_mutex);
+      push_stats_now         = push_stats_now || shards_[i].push_stats;
+      shards_[i].push_stats  = false;
+      pthread_mutex_unlock(&shards_[i].ring_mutex);
+    }
+
+    return push_stats_now;
   }
 
-  if (release_records_[bin_idx].Insert(four_tuple, release_record))
+  // Hand the work finished by the FEC codec threads to the flows, which are
+  // then serviced in this pass.
+  ProcessFecCodecJobs();
+
+  // Compute the send rates of the Log utility functions in one pass before
+  // the encoding states that are due are serviced.
+  if ((!enc_svc_sched_.empty()) && (enc_svc_sched_.begin()->first <= now))
   {
-    LogD(cn, __func__, "fid: %" PRIu32 ", successfully inserted record "
-         "for flow %s.\n", flow_tag_, four_tuple.ToString().c_str());
+    log_utility_batch_.Evaluate();
   }
-  else
+
+  // Service the encoding states that are due. They are rescheduled once
+  // all of them have been serviced, as a state that is still backlogged is
+  // due again on the next pass.
+  while ((!enc_svc_sched_.empty()) && (enc_svc_sched_.begin()->first <= now))
   {
-    LogW(cn, __func__, "fid: %" PRIu32 ", Failed to insert record for "
-         "flow %s.\n", flow_tag_, four_tuple.ToString().c_str());
-    delete release_record;
-    return false;
+    EncodingState*  es = enc_svc_sched_.begin()->second;
+    enc_svc_sched_.erase(enc_svc_sched_.begin());
+
+    es->SvcEvents(now);
+    push_stats_now = push_stats_now || es->PushStats();
+    enc_svc_due_.push_back(es);
   }
 
-  return true;
+  Time  quiet_deadline = now + Time::FromMsec(kQuietFlowSvcIntervalMs);
+
+  for (size_t i = 0; i < enc_svc_due_.size(); ++i)
+  {
+    EncodingState*  es       = enc_svc_due_[i];
+    Time            deadline = Time::Min(es->NextEventTime(), quiet_deadline);
+
+    es->set_svc_deadline(deadline);
+    enc_svc_sched_.insert(make_pair(deadline, es));
+  }
+  enc_svc_due_.clear();
+
+  // Service the decoding states that are due. A decoding state has no work
+  // to do between its FEC group ready time and its packet releases.
+  while ((!dec_svc_sched_.empty()) && (dec_svc_sched_.begin()->first <= now))
+  {
+    DecodingState*  ds = dec_svc_sched_.begin()->second;
+    dec_svc_sched_.erase(dec_svc_sched_.begin());
+
+    ds->SvcEvents(now);
+    dec_svc_due_.push_back(ds);
+  }
+
+  for (size_t i = 0; i < dec_svc_due_.size(); ++i)
+  {
+    DecodingState*  ds       = dec_svc_due_[i];
+    Time            deadline = ds->NextEventTime();
+
+    ds->set_svc_deadline(deadline);
+    dec_svc_sched_.insert(make_pair(deadline, ds));
+  }
+  dec_svc_due_.clear();
+
+  return push_stats_now;
 }
 
 //============================================================================
-bool UdpProxy::GetReleaseRecord(BinIndex bin_idx, const FourTuple& four_tuple,
-                                ReleaseRecord*& release_record)
+void UdpProxy::ServiceEvents(Time& now)
 {
-  return release_records_[bin_idx].Find(four_tuple, release_record);
+  if (straggler_cleanup_time_ <= now)
+  {
+    StragglerCleanupTimeout(now);
+  }
+
+  if (garbage_collection_time_ <= now)
+  {
+    GarbageCollectionTimeout(now);
+  }
+
+  if (rrm_transmission_time_ <= now)
+  {
+    SendRRMs(now);
+  }
 }
 
 //============================================================================
-void UdpProxy::SendRRMs(Time& now)
+FecCodecJob* UdpProxy::GetFecCodecJob(FecCodecOp op,
+                                      const FourTuple& four_tuple,
+                                      int group_id)
 {
-  LogD(cn, __func__, "sending RRMs\n");
-  // Send one RRM per flow originator. These must be destination bins.
-  BinIndex dst_bin_idx = 0;
-  for (bool valid = bin_map_shm_.GetFirstUcastBinIndex(dst_bin_idx);
-       valid;
-       valid = bin_map_shm_.GetNextUcastBinIndex(dst_bin_idx))
+  if ((fec_codec_ == NULL) || (!fec_codec_->running()))
   {
-    iron::MashTable<FourTuple, ReleaseRecord*>::WalkState ws;
-    ws.PrepareForWalk();
+    return NULL;
+  }
 
-    ReleaseRecord*  release_record  = NULL;
+  FecCodecJob*  job = new (std::nothrow) FecCodecJob();
 
-    while (release_records_[dst_bin_idx].GetNextItem(ws, release_record))
-    {
-      Packet* rrm = iron::Rrm::CreateNewRrm(packet_pool_,
-        release_record->four_tuple_);
+  if (job == NULL)
+  {
+    LogW(cn, __func__, "Error allocating FEC codec job, running the FEC "
+         "codec inline.\n");
+    return NULL;
+  }
 
-      if (!rrm)
-      {
-        LogF(cn, __func__, "Failed to allocate RRM packet.\n");
-        return;
-      }
+  job->op         = op;
+  job->four_tuple = four_tuple;
+  job->group_id   = group_id;
+  job->job_id     = next_fec_job_id_++;
+  job->deadline   = Time::Now() + fec_offload_budget_;
+  job->done_queue = &fec_done_queue_;
 
-      uint64_t  highest_num_bytes  = 0;
-      uint64_t  num_released_bytes = 0;
-      release_record->GetBytes(highest_num_bytes, num_released_bytes);
+  return job;
+}
 
-      uint32_t  highest_num_pkts   = 0;
-      uint32_t  num_released_pkts  = 0;
-      release_record->GetPackets(highest_num_pkts, num_released_pkts);
+//============================================================================
+void UdpProxy::SubmitFecCodecJob(FecCodecJob* job)
+{
+  fec_codec_->Submit(job);
+}
 
-      // Reset the loss rate if we haven't seen a packet in a while.
-      // It's either the first packet of the flow, or the first packet
+//============================================================================
+void UdpProxy::ProcessFecCodecJobs()
+{
+  fec_done_queue_.Swap(fec_done_jobs_);
+
+  for (size_t i = 0; i < fec_done_jobs_.size(); ++i)
+  {
+    FecCodecJob*  job = fec_done_jobs_[i];
+
+    // The flow may have been garbage collected while the job was in flight,
+    // in which case the job is simply discarded.
+    if (job->op == FEC_CODEC_ENCODE)
+    {
+      EncodingState*  es = NULL;
+
+      if (GetExistingEncodingState(job->four_tuple, es))
+      {
+        es->CompleteFecCodecJob(job);
+        ScheduleSvc(es, Time());
+      }
+    }
+    else
+    {
+      DecodingState*  ds = NULL;
+
+      if (GetExistingDecodingState(job->four_tuple, ds))
+      {
+        ds->CompleteFecCodecJob(job);
+        ScheduleSvc(ds, Time());
+      }
+    }
+
+    DiscardFecCodecJob(job);
+  }
+
+  fec_done_jobs_.clear();
+}
+
+//============================================================================
+void UdpProxy::DiscardFecCodecJob(FecCodecJob* job)
+{
+  // The flows take ownership of the packets that they use, leaving NULL in
+  // the job.
+  for (int i = 0; i < MAX_FEC_RATE; ++i)
+  {
+    if (job->src_pkts[i] != NULL)
+    {
+      packet_pool_.Recycle(job->src_pkts[i]);
+    }
+
+    if (job->dst_pkts[i] != NULL)
+    {
+      packet_pool_.Recycle(job->dst_pkts[i]);
+    }
+  }
+
+  delete job;
+}
+
+//============================================================================
+void UdpProxy::ScheduleSvc(EncodingState* es, const Time& deadline)
+{
+  enc_svc_sched_.erase(make_pair(es->svc_deadline(), es));
+  es->set_svc_deadline(deadline);
+  enc_svc_sched_.insert(make_pair(deadline, es));
+}
+
+//============================================================================
+void UdpProxy::ScheduleSvc(DecodingState* ds, const Time& deadline)
+{
+  dec_svc_sched_.erase(make_pair(ds->svc_deadline(), ds));
+  ds->set_svc_deadline(deadline);
+  dec_svc_sched_.insert(make_pair(deadline, ds));
+}
+
+//============================================================================
+void UdpProxy::ScheduleGc(EncodingState* es, const Time& deadline)
+{
+  enc_gc_sched_.erase(make_pair(es->gc_deadline(), es));
+  es->set_gc_deadline(deadline);
+  enc_gc_sched_.insert(make_pair(deadline, es));
+}
+
+//============================================================================
+void UdpProxy::ScheduleGc(DecodingState* ds, const Time& deadline)
+{
+  dec_gc_sched_.erase(make_pair(ds->gc_deadline(), ds));
+  ds->set_gc_deadline(deadline);
+  dec_gc_sched_.insert(make_pair(deadline, ds));
+}
+
+//============================================================================
+bool UdpProxy::CreateReleaseRecord(BinIndex bin_idx, FourTuple& four_tuple,
+                                   uint64_t total_bytes_sent,
+                                   uint32_t seq_num, uint8_t priority)
+{
+  ReleaseRecord*  release_record  =
+    new (std::nothrow) ReleaseRecord(four_tuple, total_bytes_sent, seq_num,
+                                     priority);
+
+  if (!release_record)
+  {
+    LogF(cn, __func__, "Failed to allocate release record.\n");
+    return false;
+  }
+
+  if (release_records_[bin_idx].Insert(four_tuple, release_record))
+  {
+    LogD(cn, __func__, "fid: %" PRIu32 ", successfully inserted record "
+         "for flow %s.\n", flow_tag_, four_tuple.ToString().c_str());
+  }
+  else
+  {
+    LogW(cn, __func__, "fid: %" PRIu32 ", Failed to insert record for "
+         "flow %s.\n", flow_tag_, four_tuple.ToString().c_str());
+    delete release_record;
+    return false;
+  }
+
+  return true;
+}
+
+//============================================================================
+bool UdpProxy::GetReleaseRecord(BinIndex bin_idx, const FourTuple& four_tuple,
+                                ReleaseRecord*& release_record)
+{
+  return release_records_[bin_idx].Find(four_tuple, release_record);
+}
+
+//============================================================================
+void UdpProxy::SendRRMs(Time& now)
+{
+  LogD(cn, __func__, "sending RRMs\n");
+  // Send one RRM per flow originator. These must be destination bins.
+  BinIndex dst_bin_idx = 0;
+  for (bool valid = bin_map_shm_.GetFirstUcastBinIndex(dst_bin_idx);
+       valid;
+       valid = bin_map_shm_.GetNextUcastBinIndex(dst_bin_idx))
+  {
+    iron::MashTable<FourTuple, ReleaseRecord*>::WalkState ws;
+    ws.PrepareForWalk();
+
+    ReleaseRecord*  release_record  = NULL;
+
+    while (release_records_[dst_bin_idx].GetNextItem(ws, release_record))
+    {
+      Packet* rrm = iron::Rrm::CreateNewRrm(packet_pool_,
+        release_record->four_tuple_);
+
+      if (!rrm)
+      {
+        LogF(cn, __func__, "Failed to allocate RRM packet.\n");
+        return;
+      }
+
+      uint64_t  highest_num_bytes  = 0;
+      uint64_t  num_released_bytes = 0;
+      release_record->GetBytes(highest_num_bytes, num_released_bytes);
+
+      uint32_t  highest_num_pkts   = 0;
+      uint32_t  num_released_pkts  = 0;
+      release_record->GetPackets(highest_num_pkts, num_released_pkts);
+
+      // Reset the loss rate if we haven't seen a packet in a while.
+      // It's either the first packet of the flow, or the first packet
       // after triage ended.
       if (now > (release_record->last_release_time_ + iron::Time(kMaxInterarrivalTime)))
       {
@@ -1192,24 +1718,8 @@ void UdpProxy::SendRRMs(Time& now)
       iron::Rrm::FillReport(rrm, highest_num_bytes, highest_num_pkts,
         num_released_bytes, num_released_pkts, cur_loss_rate);
 
-      bool  sent_pkt     = false;
-      bool  fifo_is_open = udp_to_bpf_pkt_fifo_.IsOpen();
-
-      if (!fifo_is_open)
-      {
-        fifo_is_open = udp_to_bpf_pkt_fifo_.OpenSender();
-
-        if (!fifo_is_open)
-        {
-          LogW(cn, __func__, "Backpressure forwarder packet FIFO not ready "
-               "yet, dropping RRM packet.\n");
-        }
-      }
-
-      if (fifo_is_open)
-      {
-        sent_pkt = udp_to_bpf_pkt_fifo_.Send(rrm);
-      }
+      // Flow shards queue the RRM for the dispatching UDP Proxy.
+      bool  sent_pkt = SendToBpf(rrm);
 
       if (!sent_pkt)
       {
@@ -1828,7 +2338,16 @@ void UdpProxy::ReceivePktsFromBpf()
     Packet* packet;
     while (bpf_to_udp_pkt_fifo_.GetNextRcvdPacket(&packet))
     {
-      if (packet != NULL)
+      if (packet == NULL)
+      {
+        continue;
+      }
+
+      if (shards_ != NULL)
+      {
+        DispatchPkt(packet, false);
+      }
+      else
       {
         ProcessPktFromBpf(packet);
       }
@@ -1883,53 +2402,11 @@ void UdpProxy::RunEncoder(Packet* pkt)
   // packet. If so, the flow's IP and UDP headers are encapsulated and we need
   // to strip off the encapsulating headers before processing the received
   // packet.
-  uint8_t  protocol;
-  if (!pkt->GetIpProtocol(protocol))
+  if (!StripPimRegisterHdrs(pkt))
   {
-    LogE(cn, __func__, "Unable to get packet protocol from received "
-         "packet.\n");
-    TRACK_UNEXPECTED_DROP(cn, packet_pool_);
-    packet_pool_.Recycle(pkt);
-    pkt = NULL;
     return;
   }
 
-  if (protocol == IPPROTO_PIM)
-  {
-    // We expect that the received PIM packet is a PIM Register packet. Make
-    // sure that this is the case.
-    struct iphdr*  ip_hdr   = pkt->GetIpHdr();
-    uint8_t        hdr_len  = ip_hdr->ihl * 4;
-    uint8_t        pim_type = *(pkt->GetBuffer(hdr_len)) & 0xf;
-
-    if (pim_type != kPimRegisterPktType)
-    {
-      LogE(cn, __func__, "Received unexpected PIM packet type (%" PRIu8
-           ").\n", pim_type);
-      TRACK_UNEXPECTED_DROP(cn, packet_pool_);
-      packet_pool_.Recycle(pkt);
-      pkt = NULL;
-      return;
-    }
-
-    // We have received a PIM Register packet. Strip off the outer IP header
-    // and PIM header from the received packet before we continue processing
-    // it.
-    LogD(cn, __func__, "Received PIM Register packet.\n");
-    LogD(cn, __func__, "Removing %d bytes from PIM Register packet.\n",
-         (hdr_len + kPimHdrLen));
-
-    if (!pkt->RemoveBytesFromBeginning(hdr_len + kPimHdrLen))
-    {
-      LogE(cn, __func__, "Error removing encapsulating IP Header and PIM "
-           "header from received PIM Register packet.\n");
-      TRACK_UNEXPECTED_DROP(cn, packet_pool_);
-      packet_pool_.Recycle(pkt);
-      pkt = NULL;
-      return;
-    }
-  }
-
   uint16_t  sport_nbo;
   uint16_t  dport_nbo;
   uint32_t  saddr_nbo;
@@ -1979,12 +2456,69 @@ void UdpProxy::RunEncoder(Packet* pkt)
   std::string UNUSED(metadata) = pkt->GetPacketMetadataString();
   encoding_state->HandlePkt(pkt);
 
+  // The packet is admitted by the admission controller, so make sure that
+  // the flow is serviced on the next pass.
+  if (!encoding_state->svc_deadline().IsZero())
+  {
+    ScheduleSvc(encoding_state, Time());
+  }
+
   LogD(cn, __func__, "fid: %" PRIu32 ", packet (%s) enqueued, bin %s"
        ", Q size: %" PRIu32 "\n", flow_tag_, metadata.c_str(),
        bin_map_shm_.GetIdToLog(encoding_state->bin_idx()).c_str(),
        encoding_state->GetCountFromEncodedPktsQueue());
 }
 
+//============================================================================
+bool UdpProxy::StripPimRegisterHdrs(Packet* pkt)
+{
+  uint8_t  protocol;
+  if (!pkt->GetIpProtocol(protocol))
+  {
+    LogE(cn, __func__, "Unable to get packet protocol from received "
+         "packet.\n");
+    TRACK_UNEXPECTED_DROP(cn, packet_pool_);
+    packet_pool_.Recycle(pkt);
+    return false;
+  }
+
+  if (protocol == IPPROTO_PIM)
+  {
+    // We expect that the received PIM packet is a PIM Register packet. Make
+    // sure that this is the case.
+    struct iphdr*  ip_hdr   = pkt->GetIpHdr();
+    uint8_t        hdr_len  = ip_hdr->ihl * 4;
+    uint8_t        pim_type = *(pkt->GetBuffer(hdr_len)) & 0xf;
+
+    if (pim_type != kPimRegisterPktType)
+    {
+      LogE(cn, __func__, "Received unexpected PIM packet type (%" PRIu8
+           ").\n", pim_type);
+      TRACK_UNEXPECTED_DROP(cn, packet_pool_);
+      packet_pool_.Recycle(pkt);
+      return false;
+    }
+
+    // We have received a PIM Register packet. Strip off the outer IP header
+    // and PIM header from the received packet before we continue processing
+    // it.
+    LogD(cn, __func__, "Received PIM Register packet.\n");
+    LogD(cn, __func__, "Removing %d bytes from PIM Register packet.\n",
+         (hdr_len + kPimHdrLen));
+
+    if (!pkt->RemoveBytesFromBeginning(hdr_len + kPimHdrLen))
+    {
+      LogE(cn, __func__, "Error removing encapsulating IP Header and PIM "
+           "header from received PIM Register packet.\n");
+      TRACK_UNEXPECTED_DROP(cn, packet_pool_);
+      packet_pool_.Recycle(pkt);
+      return false;
+    }
+  }
+
+  return true;
+}
+
 //============================================================================
 bool UdpProxy::GetEncodingState(const BinIndex bin_idx,
                                 const FourTuple& four_tuple,
@@ -2036,6 +2570,9 @@ bool UdpProxy::GetEncodingState(const BinIndex bin_idx,
       return false;
     }
 
+    ScheduleSvc(encoding_state, Time());
+    ScheduleGc(encoding_state, Time());
+
     map<BinIndex, set<EncodingState*> >::iterator  it =
       bin_states_map_.find(bin_idx);
     if (it == bin_states_map_.end())
@@ -2133,6 +2670,12 @@ bool UdpProxy::ResetEncodingState(EncodingState* es)
   bool success = es->CreateAdmissionController(utility_def);
 
   es->FlushBacklog();
+
+  // Service the flow with its new parameters on the next pass. Its timeout
+  // may have changed, so also check its expiration at the next garbage
+  // collection.
+  ScheduleSvc(es, Time());
+  ScheduleGc(es, Time());
   return success;
 }
 
@@ -2170,6 +2713,14 @@ void UdpProxy::RunDecoder(Packet* pkt)
   // Pass the received packet the the decoding state for processing. Note that
   // ownership of the received packet is passed to the decoding state.
   decoding_state->HandlePkt(pkt);
+
+  // The packet may have started a new FEC group or been queued for release.
+  Time  deadline = decoding_state->NextEventTime();
+
+  if (deadline != decoding_state->svc_deadline())
+  {
+    ScheduleSvc(decoding_state, deadline);
+  }
 }
 
 //============================================================================
@@ -2234,6 +2785,9 @@ bool UdpProxy::GetDecodingState(const FourTuple& four_tuple,
       decoding_state = NULL;
       return false;
     }
+
+    ScheduleSvc(decoding_state, Time());
+    ScheduleGc(decoding_state, Time());
   }
 
   // decoding_state is valid, and a reference is stored in "decoding".
@@ -2285,6 +2839,7 @@ bool UdpProxy::ResetDecodingState(DecodingState* ds)
   }
 
   ds->CreateReleaseController(utility_def);
+  ScheduleSvc(ds, Time());
 
   return true;
 }
@@ -2298,6 +2853,7 @@ void UdpProxy::TurnFlowOff(const FourTuple& four_tuple)
     LogW(cn, __func__, "Turning flow off in encoding state: %s.\n",
          four_tuple.ToString().c_str());
     encoding_state->set_flow_state(iron::FLOW_OFF);
+    ScheduleSvc(encoding_state, Time());
   }
 }
 
@@ -2429,8 +2985,17 @@ void UdpProxy::ProcessSetMessage()
       {
         string  key = it->name.GetString();
 
+        // ---------- Flow Shards ----------
+        // When sharded, the flow state lives in the flow shards.
+        if ((shards_ != NULL) &&
+            ((key == "add_service") || (key == "add_flow") ||
+             (key == "del_flow") || (key == "off_flow") ||
+             (key == "update_util") || (key == "add_mcast_dst_list")))
+        {
+          success = ProcessShardSetMsg(key, it->value, err_msg);
+        }
         // ---------- Service Definition ----------
-        if (key == "add_service")
+        else if (key == "add_service")
         {
           success = ProcessServiceDefnUpdateMsg(key, it->value, err_msg);
         }
@@ -2689,6 +3254,7 @@ bool UdpProxy::ProcessFlowDefnUpdateMsg(const string& key,
                           value.c_str(),
                           four_tuple.ToString().c_str());
       enc_state->UpdateUtilityFn(value);
+      ScheduleSvc(enc_state, Time());
     }
     else
     {
@@ -3164,19 +3730,31 @@ void UdpProxy::WriteStats(bool is_periodic, Writer<StringBuffer>* writer)
   Time    now     = Time::Now();
   string  log_str = "";
 
+  // The statistics cover the flows in all of the flow shards. Hold all of
+  // their flow state locks so that the report is a consistent snapshot.
+  LockShards();
+
+  size_t  num_outbound_flows = 0;
+  size_t  num_inbound_flows  = 0;
+  for (uint32_t t = 0; t < NumFlowTables(); ++t)
+  {
+    num_outbound_flows += FlowTable(t).encoding.size();
+    num_inbound_flows  += FlowTable(t).decoding.size();
+  }
+
   if (log_stats_)
   {
     LogI(cn, __func__, "---Udp Stats-------------\n");
 
     log_str.append(
       StringUtils::FormatString(256, "NumActiveOutboundFlows=%zd",
-                                encoding.size()));
+                                num_outbound_flows));
     LogI(cn, __func__, "%s\n", log_str.c_str());
 
     log_str.clear();
     log_str.append(
       StringUtils::FormatString(256, "NumActiveInboundFlows=%zd",
-                                decoding.size()));
+                                num_inbound_flows));
     LogI(cn, __func__, "%s\n", log_str.c_str());
 
     log_str.clear();
@@ -3197,10 +3775,10 @@ void UdpProxy::WriteStats(bool is_periodic, Writer<StringBuffer>* writer)
     writer->StartObject();
 
     writer->Key("NumActiveOutboundFlows");
-    writer->Uint(encoding.size());
+    writer->Uint(num_outbound_flows);
 
     writer->Key("NumActiveInboundFlows");
-    writer->Uint(decoding.size());
+    writer->Uint(num_inbound_flows);
 
     writer->Key("MaxQueueDepthsBytes");
     writer->StartArray();
@@ -3225,37 +3803,42 @@ void UdpProxy::WriteStats(bool is_periodic, Writer<StringBuffer>* writer)
     writer->StartArray();
   }
 
-  while (garbage_collected_flows_.size() > 0)
+  for (uint32_t t = 0; t < NumFlowTables(); ++t)
   {
-    FourTuple ft;
-    garbage_collected_flows_.Peek(ft);
-    string     flow_id_str = (Ipv4Endpoint(ft.src_addr_nbo(),
-                                           ft.src_port_nbo()).ToString() +
-                              " -> " +
-                              Ipv4Endpoint(ft.dst_addr_nbo(),
-                                           ft.dst_port_nbo()).ToString());
+    iron::List<FourTuple>&  gc_flows = FlowTable(t).garbage_collected_flows_;
 
-    if (log_stats_)
+    while (gc_flows.size() > 0)
     {
-      if (first)
+      FourTuple ft;
+      gc_flows.Peek(ft);
+      string     flow_id_str = (Ipv4Endpoint(ft.src_addr_nbo(),
+                                             ft.src_port_nbo()).ToString() +
+                                " -> " +
+                                Ipv4Endpoint(ft.dst_addr_nbo(),
+                                             ft.dst_port_nbo()).ToString());
+
+      if (log_stats_)
       {
-        first = false;
+        if (first)
+        {
+          first = false;
+        }
+        else
+        {
+          log_str.append(",");
+        }
+
+        log_str.append(
+          StringUtils::FormatString(256, "'%s'", flow_id_str.c_str()));
       }
-      else
+
+      if (writer)
       {
-        log_str.append(",");
+        writer->String(flow_id_str.c_str());
       }
 
-      log_str.append(
-        StringUtils::FormatString(256, "'%s'", flow_id_str.c_str()));
-    }
-
-    if (writer)
-    {
-      writer->String(flow_id_str.c_str());
+      gc_flows.Pop(ft);
     }
-
-    garbage_collected_flows_.Pop(ft);
   }
 
   if (writer)
@@ -3279,22 +3862,25 @@ void UdpProxy::WriteStats(bool is_periodic, Writer<StringBuffer>* writer)
 
   first = true;
 
-  iron::MashTable<FourTuple, EncodingState*>::WalkState es_walk_state;
-  EncodingState*  encoding_state  = NULL;
-  while (encoding.GetNextItem(es_walk_state, encoding_state))
+  for (uint32_t t = 0; t < NumFlowTables(); ++t)
   {
-    if (first)
+    iron::MashTable<FourTuple, EncodingState*>::WalkState es_walk_state;
+    EncodingState*  encoding_state  = NULL;
+    while (FlowTable(t).encoding.GetNextItem(es_walk_state, encoding_state))
     {
-      first = false;
-    }
-    else
-    {
-      log_str.append(",");
-    }
+      if (first)
+      {
+        first = false;
+      }
+      else
+      {
+        log_str.append(",");
+      }
 
-    encoding_state->WriteStats(now, log_str, writer);
+      encoding_state->WriteStats(now, log_str, writer);
 
-    cumulative_utility += encoding_state->utility();
+      cumulative_utility += encoding_state->utility();
+    }
   }
 
   if (log_stats_)
@@ -3315,22 +3901,27 @@ void UdpProxy::WriteStats(bool is_periodic, Writer<StringBuffer>* writer)
 
   first = true;
 
-  iron::MashTable<FourTuple, DecodingState*>::WalkState ds_walk_state;
-  DecodingState*    decoding_state  = NULL;
-  while (decoding.GetNextItem(ds_walk_state, decoding_state))
+  for (uint32_t t = 0; t < NumFlowTables(); ++t)
   {
-    if (first)
-    {
-      first = false;
-    }
-    else
+    iron::MashTable<FourTuple, DecodingState*>::WalkState ds_walk_state;
+    DecodingState*    decoding_state  = NULL;
+    while (FlowTable(t).decoding.GetNextItem(ds_walk_state, decoding_state))
     {
-      log_str.append(",");
-    }
+      if (first)
+      {
+        first = false;
+      }
+      else
+      {
+        log_str.append(",");
+      }
 
-    decoding_state->WriteStats(now, log_str, writer);
+      decoding_state->WriteStats(now, log_str, writer);
+    }
   }
 
+  UnlockShards();
+
   total_utility_ += cumulative_utility;
 
   if (log_stats_)
@@ -3419,135 +4010,622 @@ void UdpProxy::GarbageCollectionTimeout(Time& now)
   // Run the garbage collector.
   LogD(cn, __func__, "Running garbage collector...\n");
 
-  // Garbage collect EncodingStates.
-  iron::MashTable<FourTuple, EncodingState*>::WalkState es_walk_state;
-  EncodingState*                                        es            = NULL;
-  EncodingState*                                        es_to_delete  = NULL;
-  FourTuple                                             four_tuple;
-  FourTuple                                             to_delete;
-  bool                                                  to_delete_set = false;
+  // Garbage collect EncodingStates. Only the states whose expiration
+  // deadline has passed are examined.
+  while ((!enc_gc_sched_.empty()) && (enc_gc_sched_.begin()->first < now))
+  {
+    EncodingState*  es = enc_gc_sched_.begin()->second;
+    enc_gc_sched_.erase(enc_gc_sched_.begin());
+
+    Time  exp_time = Time::FromSec(es->last_time()) +
+      Time::FromSec(es->timeout());
+
+    if (!(exp_time < now))
+    {
+      // The flow has been active since its deadline was computed.
+      es->set_gc_deadline(exp_time);
+      enc_gc_sched_.insert(make_pair(exp_time, es));
+      continue;
+    }
+
+    FourTuple  four_tuple = es->four_tuple();
 
-  while (encoding.GetNextItem(es_walk_state, es))
+    LogD(cn, __func__, "Deleting encoding state: %s\n",
+         four_tuple.ToString().c_str());
+    // The EncodingState is to be removed. Perform the following steps:
+    //
+    // 1. Remove the entry(ies) in the bin_states_map_ map for all bins
+    // 2. Add it's four-tuple to the garbage collected flows list.
+    // 3. Remove the entry from the encoding map and service schedule
+    // 4. Delete the Encoding State
+    map<BinIndex, set<EncodingState*> >::iterator  bin_iter;
+
+    bin_iter = bin_states_map_.find(es->bin_idx());
+    if (bin_iter != bin_states_map_.end())
+    {
+      bin_iter->second.erase(es);
+    }
+    garbage_collected_flows_.Push(four_tuple);
+
+    EncodingState*  es_to_delete = NULL;
+    encoding.FindAndRemove(four_tuple, es_to_delete);
+    enc_svc_sched_.erase(make_pair(es->svc_deadline(), es));
+    delete es;
+  }
+
+  // Garbage collect DecodingStates.
+  while ((!dec_gc_sched_.empty()) && (dec_gc_sched_.begin()->first < now))
   {
-    // We can't delete the item we're currently looking at, since that will
-    // mess up the iterator. Instead, we wait until the iterator has moved on
-    // and then delete it.
-    if (to_delete_set && encoding.FindAndRemove(to_delete, es_to_delete))
+    DecodingState*  ds = dec_gc_sched_.begin()->second;
+    dec_gc_sched_.erase(dec_gc_sched_.begin());
+
+    Time  exp_time = Time::FromSec(ds->lastTime()) +
+      Time::FromSec(decoder_timeout_sec_);
+
+    if (!(exp_time < now))
     {
-      delete es_to_delete;
-      es_to_delete = NULL;
-      to_delete_set = false;
+      ds->set_gc_deadline(exp_time);
+      dec_gc_sched_.insert(make_pair(exp_time, ds));
+      continue;
     }
-    four_tuple  = es->four_tuple();
-    if (Time::FromSec(es->last_time()) < (now - Time::FromSec(es->timeout())))
+
+    // The DecodingState is to be removed, along with its release record.
+    FourTuple    four_tuple = ds->four_tuple();
+    Ipv4Address  src_addr(four_tuple.src_addr_nbo());
+    BinIndex     src_bin_idx =
+      bin_map_shm_.GetDstBinIndexFromAddress(src_addr);
+
+    if (src_bin_idx == iron::kInvalidBinIndex)
     {
-      LogD(cn, __func__, "Deleting encoding state: %s\n",
+      LogE(cn, __func__, "Failed to compute bin index for address %s "
+           "(four tuple %s).\n", src_addr.ToString().c_str(),
            four_tuple.ToString().c_str());
-      // The EncodingState is to be removed. Perform the following steps:
-      //
-      // 1. Cancel any timers associated with the EncodingState tag
-      // 2. Remove the entry(ies) in the bin_states_map_ map for all bins
-      // 3. Add it's four-tuple to the garbage collected flows list.
-      // 4. Remove the entry from the encoding map
-      // 5. Delete the Encoding State
-      map<BinIndex, set<EncodingState*> >::iterator  bin_iter;
-
-      bin_iter = bin_states_map_.find(es->bin_idx());
-      if (bin_iter != bin_states_map_.end())
+    }
+    else
+    {
+      ReleaseRecord*  release_record = NULL;
+      if (release_records_[src_bin_idx].FindAndRemove(
+            four_tuple, release_record))
       {
-        bin_iter->second.erase(es);
+        if (release_record)
+        {
+          LogD(cn, __func__, "Removed release record from source bin %s.\n",
+               bin_map_shm_.GetIdToLog(src_bin_idx).c_str());
+          delete release_record;
+          release_record  = NULL;
+        }
+        else
+        {
+          LogE(cn, __func__, "Did not find ReleaseRecord for flow %s.\n",
+               four_tuple.ToString().c_str());
+        }
       }
-      garbage_collected_flows_.Push(four_tuple);
-      // Save this encoding state so we can delete it once the iterator moves
-      // on.
-      to_delete = four_tuple;
-      to_delete_set = true;
     }
+
+    DecodingState*  ds_to_delete = NULL;
+    decoding.FindAndRemove(four_tuple, ds_to_delete);
+    dec_svc_sched_.erase(make_pair(ds->svc_deadline(), ds));
+    delete ds;
   }
-  // Delete the last item in the list, now that we're done iterating.
-  if (to_delete_set && encoding.FindAndRemove(to_delete, es_to_delete))
+
+  // Schedule the next garbage collection event time.
+  garbage_collection_time_ = now + Time::FromSec(gc_interval_sec_);
+}
+
+//============================================================================
+bool UdpProxy::CreateShards(ConfigInfo& ci, const char* prefix)
+{
+  shards_ = new (std::nothrow) Shard[num_shards_];
+
+  if (shards_ == NULL)
   {
-    delete es_to_delete;
-    es_to_delete = NULL;
-    to_delete_set = false;
+    LogF(cn, __func__, "Error allocating flow shards.\n");
+    return false;
   }
 
-  // Garbage collect DecodingStates.
-  iron::MashTable<FourTuple, DecodingState*>::WalkState ds_walk_state;
-  DecodingState*                                        ds           = NULL;
-  DecodingState*                                        ds_to_delete = NULL;
-  to_delete_set                                                      = false;
+  for (uint32_t i = 0; i < num_shards_; ++i)
+  {
+    Shard&  shard = shards_[i];
+
+    pthread_mutex_init(&shard.ring_mutex, NULL);
+    pthread_mutex_init(&shard.state_mutex, NULL);
+
+    // The shard threads wait on the same monotonic clock that Time uses.
+    pthread_condattr_t  cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&shard.ring_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+
+    // Each shard has its own FEC state pool, as the decoding states hold
+    // onto FEC states for the lifetime of their FEC groups.
+    shard.fecstate_pool = new (std::nothrow) FecStatePool(packet_pool_);
+
+    if (shard.fecstate_pool == NULL)
+    {
+      LogF(cn, __func__, "Error allocating FecStatePool for flow shard %"
+           PRIu32 ".\n", i);
+      return false;
+    }
 
-  while (decoding.GetNextItem(ds_walk_state, ds))
+    shard.proxy = new (std::nothrow) UdpProxy(*this, *shard.fecstate_pool,
+                                              i);
+
+    if (shard.proxy == NULL)
+    {
+      LogF(cn, __func__, "Error allocating flow shard %" PRIu32 ".\n", i);
+      return false;
+    }
+
+    if (!shard.proxy->Configure(ci, prefix))
+    {
+      LogF(cn, __func__, "Error configuring flow shard %" PRIu32 ".\n", i);
+      return false;
+    }
+  }
+
+  LogI(cn, __func__, "Created %" PRIu32 " flow shards.\n", num_shards_);
+
+  return true;
+}
+
+//============================================================================
+bool UdpProxy::StartShards()
+{
+  // Block all signals while creating the shard threads, so that the threads
+  // inherit a full signal mask and signals are handled by the main thread.
+  sigset_t  all_sigs;
+  sigset_t  old_sigs;
+  sigfillset(&all_sigs);
+  pthread_sigmask(SIG_SETMASK, &all_sigs, &old_sigs);
+
+  bool  success = true;
+
+  for (uint32_t i = 0; i < num_shards_; ++i)
   {
-    // As with encoding states, we delete each item after the iterator has
-    // moved on.
-    if (to_delete_set && decoding.FindAndRemove(to_delete, ds_to_delete))
+    Shard&  shard = shards_[i];
+
+    shard.running = true;
+
+    if (pthread_create(&shard.thread, NULL, &UdpProxy::ShardThreadMain,
+                       &shard) != 0)
     {
-      delete ds_to_delete;
-      ds_to_delete = NULL;
-      to_delete_set = false;
+      LogE(cn, __func__, "Error creating thread for flow shard %" PRIu32
+           ": %s.\n", i, strerror(errno));
+      shard.running = false;
+      success       = false;
+      break;
     }
-    four_tuple  = ds->four_tuple();
-    if (Time::FromSec(ds->lastTime()) <
-        (now - Time::FromSec(decoder_timeout_sec_)))
+
+    shard.thread_started = true;
+  }
+
+  pthread_sigmask(SIG_SETMASK, &old_sigs, NULL);
+
+  LogI(cn, __func__, "Started %" PRIu32 " flow shard threads.\n",
+       num_shards_);
+
+  return success;
+}
+
+//============================================================================
+void UdpProxy::StopShards()
+{
+  if (shards_ == NULL)
+  {
+    return;
+  }
+
+  for (uint32_t i = 0; i < num_shards_; ++i)
+  {
+    Shard&  shard = shards_[i];
+
+    if (shard.thread_started)
+    {
+      pthread_mutex_lock(&shard.ring_mutex);
+      shard.running = false;
+      pthread_cond_signal(&shard.ring_cond);
+      pthread_mutex_unlock(&shard.ring_mutex);
+
+      pthread_join(shard.thread, NULL);
+      shard.thread_started = false;
+    }
+
+    // Recycle any packets that were dispatched to the shard but not yet
+    // processed.
+    for (size_t j = 0; j < shard.lan_pkts.size(); ++j)
+    {
+      packet_pool_.Recycle(shard.lan_pkts[j]);
+    }
+    shard.lan_pkts.clear();
+
+    for (size_t j = 0; j < shard.bpf_pkts.size(); ++j)
+    {
+      packet_pool_.Recycle(shard.bpf_pkts[j]);
+    }
+    shard.bpf_pkts.clear();
+  }
+}
+
+//============================================================================
+void UdpProxy::DestroyShards()
+{
+  if (shards_ == NULL)
+  {
+    return;
+  }
+
+  for (uint32_t i = 0; i < num_shards_; ++i)
+  {
+    Shard&  shard = shards_[i];
+
+    if (shard.ring_drops > 0)
+    {
+      LogW(cn, __func__, "Flow shard %" PRIu32 " dropped %" PRIu64
+           " packets due to a full inbound ring.\n", i, shard.ring_drops);
+    }
+
+    if (shard.proxy != NULL)
+    {
+      // Fold the shard's packet counts into the totals reported by this
+      // instance.
+      total_pkts_sent_ += shard.proxy->total_pkts_sent_;
+      total_src_drop_  += shard.proxy->total_src_drop_;
+
+      delete shard.proxy;
+      shard.proxy = NULL;
+    }
+
+    if (shard.fecstate_pool != NULL)
+    {
+      delete shard.fecstate_pool;
+      shard.fecstate_pool = NULL;
+    }
+
+    pthread_cond_destroy(&shard.ring_cond);
+    pthread_mutex_destroy(&shard.ring_mutex);
+    pthread_mutex_destroy(&shard.state_mutex);
+  }
+
+  delete [] shards_;
+  shards_ = NULL;
+}
+
+//============================================================================
+void* UdpProxy::ShardThreadMain(void* arg)
+{
+  Shard*  shard = static_cast<Shard*>(arg);
+
+  shard->proxy->RunShard(*shard);
+
+  return NULL;
+}
+
+//============================================================================
+void UdpProxy::RunShard(Shard& shard)
+{
+  Time  now = Time::Now();
+
+  // Schedule the shard's events, as Start() does for the main service loop.
+  garbage_collection_time_   = now + Time::FromSec(gc_interval_sec_);
+  straggler_cleanup_time_    = now + Time::FromMsec(kPPIntervalMsec);
+  rrm_transmission_time_     = now + Time::FromMsec(kPeriodicRrmIntervalMsec);
+  next_sched_svc_flows_time_ = now +
+    Time::FromUsec(kDefaultSvcFlowsIntervalUs);
+
+  std::vector<Packet*>  lan_pkts;
+  std::vector<Packet*>  bpf_pkts;
+
+  pthread_mutex_lock(&shard.ring_mutex);
+
+  while (shard.running)
+  {
+    // Wait for dispatched packets, or until the flows must be serviced.
+    if (shard.lan_pkts.empty() && shard.bpf_pkts.empty())
+    {
+      struct timeval   svc_tv = next_sched_svc_flows_time_.ToTval();
+      struct timespec  svc_ts;
+      svc_ts.tv_sec  = svc_tv.tv_sec;
+      svc_ts.tv_nsec = svc_tv.tv_usec * 1000;
+
+      pthread_cond_timedwait(&shard.ring_cond, &shard.ring_mutex, &svc_ts);
+    }
+
+    lan_pkts.swap(shard.lan_pkts);
+    bpf_pkts.swap(shard.bpf_pkts);
+    pthread_mutex_unlock(&shard.ring_mutex);
+
+    pthread_mutex_lock(&shard.state_mutex);
+
+    for (size_t i = 0; i < lan_pkts.size(); ++i)
+    {
+      RunEncoder(lan_pkts[i]);
+    }
+
+    for (size_t i = 0; i < bpf_pkts.size(); ++i)
     {
-      // The DecodingState is to be removed.
-      // Store the four tuple so that next iteration (once the iterator
-      // moves on) we can remove the entry from the decoding map and delete
-      // the Decoding State.
-      to_delete = four_tuple;
-      to_delete_set = true;
+      ProcessPktFromBpf(bpf_pkts[i]);
+    }
 
-      Ipv4Address  src_addr(four_tuple.src_addr_nbo());
-      BinIndex     src_bin_idx =
-        bin_map_shm_.GetDstBinIndexFromAddress(src_addr);
+    bool  push_stats_now = false;
 
-      if (src_bin_idx == iron::kInvalidBinIndex)
+    now = Time::Now();
+    if (next_sched_svc_flows_time_ <= now)
+    {
+      if (!qd_direct_access_)
       {
-        LogE(cn, __func__, "Failed to compute bin index for address %s "
-             "(four tuple %s).\n", src_addr.ToString().c_str(),
-             four_tuple.ToString().c_str());
-        continue;
+        local_queue_depths_.CopyFromShm(weight_qd_shared_memory_);
+      }
+
+      push_stats_now = ServiceStates(now);
+      ServiceEvents(now);
+
+      next_sched_svc_flows_time_ = now +
+        Time::FromUsec(kDefaultSvcFlowsIntervalUs);
+    }
+
+    // Hand the packets admitted during this pass to the BPF.
+    if (!bpf_out_pkts_.empty())
+    {
+      dispatcher_->SendShardPktsToBpf(bpf_out_pkts_);
+    }
+
+    // Send the packets released to the LAN during this pass.
+    lan_send_batch_.Flush();
+
+    pthread_mutex_unlock(&shard.state_mutex);
+
+    lan_pkts.clear();
+    bpf_pkts.clear();
+
+    pthread_mutex_lock(&shard.ring_mutex);
+    shard.push_stats = shard.push_stats || push_stats_now;
+  }
+
+  pthread_mutex_unlock(&shard.ring_mutex);
+}
+
+//============================================================================
+void UdpProxy::DispatchPkt(Packet* pkt, bool from_lan)
+{
+  // The encapsulated headers of a PIM Register packet identify its flow.
+  if (from_lan && (!StripPimRegisterHdrs(pkt)))
+  {
+    return;
+  }
+
+  uint32_t   shard_idx = 0;
+  FourTuple  four_tuple;
+  uint16_t   sport_nbo = 0;
+  uint16_t   dport_nbo = 0;
+  uint32_t   saddr_nbo = 0;
+  uint32_t   daddr_nbo = 0;
+  uint32_t   proto     = 0;
+
+  // RRMs are routed to the shard that owns the flow they report on. Packets
+  // whose flow cannot be identified are handed to the first shard, which
+  // drops them.
+  if ((!from_lan) && (pkt->GetType() == IPV4_PACKET) &&
+      pkt->GetDstPort(dport_nbo) &&
+      (ntohs(dport_nbo) == iron::Rrm::kDefaultRrmPort))
+  {
+    iron::Rrm::GetFlowFourTuple(pkt, four_tuple);
+    shard_idx = GetShardIndex(four_tuple);
+  }
+  else if (pkt->GetFiveTuple(saddr_nbo, daddr_nbo, sport_nbo, dport_nbo,
+                             proto))
+  {
+    four_tuple.Set(saddr_nbo, sport_nbo, daddr_nbo, dport_nbo);
+    shard_idx = GetShardIndex(four_tuple);
+  }
+
+  if (from_lan)
+  {
+    shards_[shard_idx].staged_lan_pkts.push_back(pkt);
+  }
+  else
+  {
+    shards_[shard_idx].staged_bpf_pkts.push_back(pkt);
+  }
+}
+
+//============================================================================
+void UdpProxy::FlushDispatchedPkts()
+{
+  for (uint32_t i = 0; i < num_shards_; ++i)
+  {
+    Shard&  shard = shards_[i];
+
+    if (shard.staged_lan_pkts.empty() && shard.staged_bpf_pkts.empty())
+    {
+      continue;
+    }
+
+    pthread_mutex_lock(&shard.ring_mutex);
+
+    for (size_t j = 0; j < shard.staged_lan_pkts.size(); ++j)
+    {
+      if ((shard.lan_pkts.size() + shard.bpf_pkts.size()) <
+          kMaxShardRingPkts)
+      {
+        shard.lan_pkts.push_back(shard.staged_lan_pkts[j]);
       }
       else
       {
-        ReleaseRecord*  release_record = NULL;
-        if (release_records_[src_bin_idx].FindAndRemove(
-              four_tuple, release_record))
-        {
-          if (release_record)
-          {
-            LogD(cn, __func__, "Removed release record from source bin %s.\n",
-                 bin_map_shm_.GetIdToLog(src_bin_idx).c_str());
-            delete release_record;
-            release_record  = NULL;
-          }
-          else
-          {
-            LogE(cn, __func__, "Did not find ReleaseRecord for flow %s.\n",
-                 four_tuple.ToString().c_str());
-          }
-        }
+        ++shard.ring_drops;
+        TRACK_EXPECTED_DROP(cn, packet_pool_);
+        packet_pool_.Recycle(shard.staged_lan_pkts[j]);
+      }
+    }
+
+    for (size_t j = 0; j < shard.staged_bpf_pkts.size(); ++j)
+    {
+      if ((shard.lan_pkts.size() + shard.bpf_pkts.size()) <
+          kMaxShardRingPkts)
+      {
+        shard.bpf_pkts.push_back(shard.staged_bpf_pkts[j]);
+      }
+      else
+      {
+        ++shard.ring_drops;
+        TRACK_EXPECTED_DROP(cn, packet_pool_);
+        packet_pool_.Recycle(shard.staged_bpf_pkts[j]);
       }
     }
+
+    pthread_cond_signal(&shard.ring_cond);
+    pthread_mutex_unlock(&shard.ring_mutex);
+
+    shard.staged_lan_pkts.clear();
+    shard.staged_bpf_pkts.clear();
   }
-  // Delete the last item in the list, now that we're done iterating.
-  if (to_delete_set && decoding.FindAndRemove(to_delete, ds_to_delete))
+}
+
+//============================================================================
+void UdpProxy::SendShardPktsToBpf(std::vector<Packet*>& pkts)
+{
+  pthread_mutex_lock(&bpf_send_mutex_);
+
+  for (size_t i = 0; i < pkts.size(); ++i)
   {
-    delete ds_to_delete;
-    ds_to_delete = NULL;
-    to_delete_set = false;
+    if (!SendToBpf(pkts[i]))
+    {
+      LogD(cn, __func__, "Error sending flow shard packet to BPF, dropping "
+           "packet.\n");
+      packet_pool_.Recycle(pkts[i]);
+    }
   }
 
-  // Schedule the next garbage collection event time.
-  garbage_collection_time_ = now + Time::FromSec(gc_interval_sec_);
+  pthread_mutex_unlock(&bpf_send_mutex_);
+
+  pkts.clear();
+}
+
+//============================================================================
+void UdpProxy::LockShards()
+{
+  for (uint32_t i = 0; (shards_ != NULL) && (i < num_shards_); ++i)
+  {
+    pthread_mutex_lock(&shards_[i].state_mutex);
+  }
+}
+
+//============================================================================
+void UdpProxy::UnlockShards()
+{
+  for (uint32_t i = 0; (shards_ != NULL) && (i < num_shards_); ++i)
+  {
+    pthread_mutex_unlock(&shards_[i].state_mutex);
+  }
+}
+
+//============================================================================
+bool UdpProxy::ProcessShardSetMsg(const string& key, const Value& val_obj,
+                                  string& err_msg)
+{
+  // Service definitions apply to the flows of every shard.
+  if (key == "add_service")
+  {
+    bool  success = true;
+
+    for (uint32_t i = 0; i < num_shards_; ++i)
+    {
+      pthread_mutex_lock(&shards_[i].state_mutex);
+      success = (shards_[i].proxy->ProcessServiceDefnUpdateMsg(
+                   key, val_obj, err_msg) && success);
+      pthread_mutex_unlock(&shards_[i].state_mutex);
+    }
+
+    return success;
+  }
+
+  // Flow definitions and multicast destination lists apply to the shard
+  // that owns the flow.
+  FourTuple  four_tuple;
+  if (!GetSetMsgFourTuple(key, val_obj, four_tuple))
+  {
+    LogW(cn, __func__, "Improperly formatted flow tuple.\n");
+    err_msg = "Improperly formatted flow tuple.";
+    return false;
+  }
+
+  Shard&  shard   = shards_[GetShardIndex(four_tuple)];
+  bool    success = false;
+
+  pthread_mutex_lock(&shard.state_mutex);
+  if (key == "add_mcast_dst_list")
+  {
+    success = shard.proxy->ProcessMcastDstListMsg(key, val_obj, err_msg);
+  }
+  else
+  {
+    success = shard.proxy->ProcessFlowDefnUpdateMsg(key, val_obj, err_msg);
+  }
+  pthread_mutex_unlock(&shard.state_mutex);
+
+  return success;
+}
+
+//============================================================================
+bool UdpProxy::GetSetMsgFourTuple(const string& key, const Value& val_obj,
+                                  FourTuple& four_tuple)
+{
+  if (!(val_obj.IsString()))
+  {
+    return false;
+  }
+
+  string        val = val_obj.GetString();
+  List<string>  tokens;
+  StringUtils::Tokenize(val, ";", tokens);
+
+  if (key == "add_mcast_dst_list")
+  {
+    // The first token is the flow tuple and has the following format:
+    //
+    //   saddr:sport->daddr:dport
+    string  flow_tuple_str;
+    tokens.Pop(flow_tuple_str);
+
+    List<string>  four_tuple_tokens;
+    StringUtils::Tokenize(flow_tuple_str, "->", four_tuple_tokens);
+    if (four_tuple_tokens.size() != 2)
+    {
+      return false;
+    }
+    string  src_token;
+    four_tuple_tokens.Pop(src_token);
+    string  dst_token;
+    four_tuple_tokens.Pop(dst_token);
+
+    Ipv4Endpoint  src_endpt(src_token);
+    Ipv4Endpoint  dst_endpt(dst_token);
+
+    four_tuple.Set(src_endpt.address(), src_endpt.port(),
+                   dst_endpt.address(), dst_endpt.port());
+    return true;
+  }
+
+  // The flow definition starts with sport;dport;saddr;daddr.
+  string  token;
+  tokens.Pop(token);
+  uint16_t  sport_nbo = htons(StringUtils::GetUint(token));
+  tokens.Pop(token);
+  uint16_t  dport_nbo = htons(StringUtils::GetUint(token));
+  tokens.Pop(token);
+  uint32_t  saddr_nbo = StringUtils::GetIpAddr(token).address();
+  tokens.Pop(token);
+  uint32_t  daddr_nbo = StringUtils::GetIpAddr(token).address();
+
+  four_tuple.Set(saddr_nbo, sport_nbo, daddr_nbo, dport_nbo);
+  return true;
 }
 
 //============================================================================
 uint32_t UdpProxy::flow_tag()
 {
-  if (++flow_tag_ == 0)
+  flow_tag_ += flow_tag_stride_;
+  if (flow_tag_ < flow_tag_stride_)
   {
     LogW(cn, __func__, "Flow tag has looped.\n");
   }
@@ -43,7 +43,9 @@
 #include "config_info.h"
 #include "debugging_stats.h"
 #include "decoding_state.h"
+#include "edge_if_send_batch.h"
 #include "encoding_state.h"
+#include "fec_codec.h"
 #include "fec_state.h"
 #include "fec_context.h"
 #include "fec_state_pool.h"
@@ -56,6 +58,7 @@
 #include "k_val.h"
 #include "latency_cache_shm.h"
 #include "list.h"
+#include "log_utility_batch.h"
 #include "mash_table.h"
 #include "packet.h"
 #include "packet_fifo.h"
@@ -72,6 +75,8 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <pthread.h>
 
@@ -187,15 +192,26 @@ class UdpProxy
   /// \param  pkt  Pointer to the Packet to be written to the LAN side
   ///              interface.
   ///
-  /// \return The number of bytes written to the LAN side interface. If 0
-  ///         bytes are written to the LAN side interface, the caller retains
-  ///         ownership of the packet. Otherwise, this class assumes ownership
-  ///         of the packet.
-  ssize_t SendToLan(iron::Packet* pkt) const;
+  /// The packet is queued and is sent, in order, with the other packets
+  /// sent to the LAN during the current processing pass when the pass ends.
+  ///
+  /// \return The number of bytes queued for the LAN side interface. If 0
+  ///         bytes are queued, the caller retains ownership of the packet.
+  ///         Otherwise, this class assumes ownership of the packet.
+  ssize_t SendToLan(iron::Packet* pkt);
 
   /// \brief The service flows timeout callback.
   void SvcFlowsTimeout();
 
+  /// \brief Get the number of flow shards.
+  ///
+  /// \return The number of flow shards. A value of 1 indicates that all of
+  ///         the flows are processed by the main service loop.
+  inline uint32_t num_shards() const
+  {
+    return num_shards_;
+  }
+
   /// \brief Get the scheduled service flows timeout time.
   ///
   /// \return The scheduled service flows timeout time.
@@ -388,6 +404,15 @@ class UdpProxy
     return k_val_;
   }
 
+  /// \brief Return access to the batch that computes the send rates of the
+  /// Log utility functions of the flows serviced by this UDP Proxy.
+  ///
+  /// \return Reference to the Log utility function batch.
+  inline iron::LogUtilityBatch& log_utility_batch()
+  {
+    return log_utility_batch_;
+  }
+
   /// \brief Query if the UDP Proxy is logging statistics.
   ///
   /// \return True if the UDP Proxy is logging statistics, false otherwise.
@@ -426,6 +451,26 @@ class UdpProxy
     return enable_loss_triage_;
   }
 
+  /// \brief Get a job for handing a FEC group to the FEC codec threads.
+  ///
+  /// The job's deadline is set from the FEC offload budget, and its finished
+  /// work is returned to this instance's service loop.
+  ///
+  /// \param  op          The codec operation.
+  /// \param  four_tuple  The 4-tuple of the flow.
+  /// \param  group_id    The FEC group id.
+  ///
+  /// \return The job, or NULL if the FEC codec is to be run inline.
+  FecCodecJob* GetFecCodecJob(FecCodecOp op,
+                              const iron::FourTuple& four_tuple,
+                              int group_id);
+
+  /// \brief Hand a job to the FEC codec threads.
+  ///
+  /// \param  job  The job, from GetFecCodecJob(). It is returned to the
+  ///              flow's state by ProcessFecCodecJobs().
+  void SubmitFecCodecJob(FecCodecJob* job);
+
   protected:
 
   // Everything from this point to the end of the file is protected. This will
@@ -460,6 +505,21 @@ class UdpProxy
            iron::FifoIF* udp_to_bpf_pkt_fifo,
            bool qd_direct_access);
 
+  /// \brief Constructor for a flow shard.
+  ///
+  /// A flow shard owns the encoding and decoding states, admission
+  /// controllers and release records for the subset of the flows whose
+  /// 4-tuples hash to it. It shares the packet pool, edge interface, BinMap
+  /// and queue depth shared memory with the dispatching UDP Proxy, and hands
+  /// the packets that it sends to the BPF to the dispatching UDP Proxy.
+  ///
+  /// \param  dispatcher     The UDP Proxy that dispatches packets to the
+  ///                        shard.
+  /// \param  fecstate_pool  Pool containing fec states for the shard.
+  /// \param  shard_idx      The index of the shard.
+  UdpProxy(UdpProxy& dispatcher, FecStatePool& fecstate_pool,
+           uint32_t shard_idx);
+
   /// \brief Wrapper for system select()
   ///
   /// Allows test cases to operate when not using system resources to back
@@ -681,6 +741,234 @@ class UdpProxy
 
   }; // end struct StatsPushInfo
 
+  /// Information for a flow shard and the thread that services it.
+  ///
+  /// The lan_pkts and bpf_pkts vectors form the inbound ring from the
+  /// dispatcher to the shard, and are protected by ring_mutex. The shard's
+  /// flow state is protected by state_mutex, which the shard thread holds
+  /// while processing packets and servicing flows and which the dispatcher
+  /// takes when it needs to read or modify the shard's flow state.
+  struct Shard
+  {
+    Shard()
+        : proxy(NULL),
+          fecstate_pool(NULL),
+          thread(),
+          thread_started(false),
+          running(false),
+          push_stats(false),
+          ring_mutex(),
+          ring_cond(),
+          state_mutex(),
+          lan_pkts(),
+          bpf_pkts(),
+          staged_lan_pkts(),
+          staged_bpf_pkts(),
+          ring_drops(0)
+    { }
+
+    UdpProxy*                   proxy;
+    FecStatePool*               fecstate_pool;
+    pthread_t                   thread;
+    bool                        thread_started;
+    bool                        running;
+    bool                        push_stats;
+    pthread_mutex_t             ring_mutex;
+    pthread_cond_t              ring_cond;
+    pthread_mutex_t             state_mutex;
+    std::vector<iron::Packet*>  lan_pkts;
+    std::vector<iron::Packet*>  bpf_pkts;
+    std::vector<iron::Packet*>  staged_lan_pkts;
+    std::vector<iron::Packet*>  staged_bpf_pkts;
+    uint64_t                    ring_drops;
+
+  }; // end struct Shard
+
+  /// Encoding states ordered by a deadline. Each state is present at most
+  /// once, keyed by the matching deadline stored in the state.
+  typedef std::set<std::pair<iron::Time, EncodingState*> >  EncodingSchedule;
+
+  /// Decoding states ordered by a deadline. Each state is present at most
+  /// once, keyed by the matching deadline stored in the state.
+  typedef std::set<std::pair<iron::Time, DecodingState*> >  DecodingSchedule;
+
+  /// \brief Create and configure the flow shards.
+  ///
+  /// \param  ci      A reference to the configuration information.
+  /// \param  prefix  The property prefix.
+  ///
+  /// \return True if successful, false otherwise.
+  bool CreateShards(iron::ConfigInfo& ci, const char* prefix);
+
+  /// \brief Start the flow shard threads.
+  ///
+  /// \return True if successful, false otherwise.
+  bool StartShards();
+
+  /// \brief Stop and join the flow shard threads.
+  void StopShards();
+
+  /// \brief Destroy the flow shards.
+  void DestroyShards();
+
+  /// \brief The flow shard thread entry point.
+  ///
+  /// \param  arg  A pointer to the Shard.
+  ///
+  /// \return Always NULL.
+  static void* ShardThreadMain(void* arg);
+
+  /// \brief The flow shard service loop.
+  ///
+  /// Processes the packets dispatched to the shard and services the shard's
+  /// flows every service flows interval, until the shard is stopped.
+  ///
+  /// \param  shard  The Shard information for this instance.
+  void RunShard(Shard& shard);
+
+  /// \brief Get the index of the flow shard that owns a flow.
+  ///
+  /// \param  four_tuple  The 4-tuple of the flow.
+  ///
+  /// \return The index of the owning flow shard.
+  inline uint32_t GetShardIndex(const iron::FourTuple& four_tuple) const
+  {
+    return (four_tuple.Hash() % num_shards_);
+  }
+
+  /// \brief Stage a received packet for the flow shard that owns its flow.
+  ///
+  /// The staged packets are handed to the shards by FlushDispatchedPkts().
+  ///
+  /// \param  pkt       The received packet. Ownership is transferred.
+  /// \param  from_lan  True if the packet was received from the LAN side,
+  ///                   false if it was received from the BPF.
+  void DispatchPkt(iron::Packet* pkt, bool from_lan);
+
+  /// \brief Hand all staged packets to the flow shards and wake them up.
+  void FlushDispatchedPkts();
+
+  /// \brief Send the packets that a flow shard has queued for the BPF.
+  ///
+  /// The packets are recycled if they cannot be sent.
+  ///
+  /// \param  pkts  The packets to send. The vector is cleared.
+  void SendShardPktsToBpf(std::vector<iron::Packet*>& pkts);
+
+  /// \brief Lock the flow state of all of the flow shards.
+  void LockShards();
+
+  /// \brief Unlock the flow state of all of the flow shards.
+  void UnlockShards();
+
+  /// \brief Get the number of instances holding flow state.
+  ///
+  /// \return The number of flow shards, or 1 if there are no shards.
+  inline uint32_t NumFlowTables() const
+  {
+    return (shards_ ? num_shards_ : 1);
+  }
+
+  /// \brief Get an instance holding flow state.
+  ///
+  /// \param  idx  The index, less than NumFlowTables().
+  ///
+  /// \return A reference to the flow shard, or to this instance if there
+  ///         are no shards.
+  inline UdpProxy& FlowTable(uint32_t idx)
+  {
+    return (shards_ ? *(shards_[idx].proxy) : *this);
+  }
+
+  /// \brief Service all of the encoding and decoding states.
+  ///
+  /// \param  now  The current time.
+  ///
+  /// \return True if an event-driven statistics push is needed.
+  bool ServiceStates(iron::Time& now);
+
+  /// \brief Service the straggler cleanup, garbage collection and RRM
+  /// transmission events that are due.
+  ///
+  /// \param  now  The current time.
+  void ServiceEvents(iron::Time& now);
+
+  /// \brief Hand the jobs returned by the FEC codec threads to their flows.
+  ///
+  /// Flows that were serviced by a returned job are scheduled for the
+  /// current service pass.
+  void ProcessFecCodecJobs();
+
+  /// \brief Release the packets held by a FEC codec job and delete it.
+  ///
+  /// \param  job  The job.
+  void DiscardFecCodecJob(FecCodecJob* job);
+
+  /// \brief Schedule the next service of an encoding state.
+  ///
+  /// \param  es        The encoding state.
+  /// \param  deadline  The time at which the state is to be serviced. A zero
+  ///                   time schedules the state for the next service pass.
+  void ScheduleSvc(EncodingState* es, const iron::Time& deadline);
+
+  /// \brief Schedule the next service of a decoding state.
+  ///
+  /// \param  ds        The decoding state.
+  /// \param  deadline  The time at which the state is to be serviced. A zero
+  ///                   time schedules the state for the next service pass.
+  void ScheduleSvc(DecodingState* ds, const iron::Time& deadline);
+
+  /// \brief Schedule the next garbage collection check of an encoding state.
+  ///
+  /// \param  es        The encoding state.
+  /// \param  deadline  The time after which the state may have expired.
+  void ScheduleGc(EncodingState* es, const iron::Time& deadline);
+
+  /// \brief Schedule the next garbage collection check of a decoding state.
+  ///
+  /// \param  ds        The decoding state.
+  /// \param  deadline  The time after which the state may have expired.
+  void ScheduleGc(DecodingState* ds, const iron::Time& deadline);
+
+  /// \brief Remove the encapsulating headers from a PIM Register packet.
+  ///
+  /// Packets that are not PIM packets are left unchanged.
+  ///
+  /// \param  pkt  The packet received from the LAN side. It is recycled if
+  ///              false is returned.
+  ///
+  /// \return True if the packet is ready for encoding, false if it has been
+  ///         dropped.
+  bool StripPimRegisterHdrs(iron::Packet* pkt);
+
+  /// \brief Route a remote control set message key to the flow shards.
+  ///
+  /// Service definitions are applied to all of the shards. Flow definitions
+  /// and multicast destination lists are applied to the shard that owns the
+  /// flow.
+  ///
+  /// \param  key       The json message key.
+  /// \param  val_obj   The json message value object.
+  /// \param  err_msg   The reference where the error string is to be
+  ///                   written.
+  ///
+  /// \return True if the message is successfully processed, false otherwise.
+  bool ProcessShardSetMsg(const std::string& key,
+                          const rapidjson::Value& val_obj,
+                          std::string& err_msg);
+
+  /// \brief Extract the flow 4-tuple from a flow definition or multicast
+  /// destination list set message value.
+  ///
+  /// \param  key         The json message key.
+  /// \param  val_obj     The json message value object.
+  /// \param  four_tuple  The extracted 4-tuple.
+  ///
+  /// \return True if the 4-tuple is extracted, false otherwise.
+  bool GetSetMsgFourTuple(const std::string& key,
+                          const rapidjson::Value& val_obj,
+                          iron::FourTuple& four_tuple);
+
   /// \brief Process a RRM from a peer proxy.
   ///
   /// \param pkt A pointer to the RRM packet.
@@ -817,6 +1105,10 @@ class UdpProxy
   /// \brief Garbage collect encoding and decoding states that are no longer
   /// active.
   ///
+  /// Only the states whose expiration deadline has passed are examined. A
+  /// state that has seen activity since its deadline was computed is
+  /// rescheduled for its new expiration time.
+  ///
   /// \param  now  The current time.
   void GarbageCollectionTimeout(iron::Time& now);
 
@@ -895,9 +1187,33 @@ class UdpProxy
   /// unique timer tag that has to be updated.
   std::map<iron::BinIndex, std::set<EncodingState*> > bin_states_map_;
 
+  /// The encoding states ordered by the time of their next service.
+  EncodingSchedule            enc_svc_sched_;
+
+  /// The decoding states ordered by the time of their next service.
+  DecodingSchedule            dec_svc_sched_;
+
+  /// The encoding states ordered by the time after which they may have
+  /// expired.
+  EncodingSchedule            enc_gc_sched_;
+
+  /// The decoding states ordered by the time after which they may have
+  /// expired.
+  DecodingSchedule            dec_gc_sched_;
+
+  /// The encoding states serviced in the current service pass.
+  std::vector<EncodingState*> enc_svc_due_;
+
+  /// The decoding states serviced in the current service pass.
+  std::vector<DecodingState*> dec_svc_due_;
+
   /// Backpressure queue normalization parameter (bits^2/sec).
   iron::KVal                  k_val_;
 
+  /// The send rates of the encoding states' Log utility functions, which
+  /// are computed together at the start of each service pass.
+  iron::LogUtilityBatch       log_utility_batch_;
+
   /// The size of the encoded_packets_queue, in packets.
   uint32_t                    max_queue_depth_pkts_;
 
@@ -1012,6 +1328,51 @@ class UdpProxy
   /// The high address in the NORM flow range.
   iron::Ipv4Address           norm_high_addr_;
 
+  /// The dispatching UDP Proxy if this instance is a flow shard, NULL
+  /// otherwise.
+  UdpProxy*                   dispatcher_;
+
+  /// The number of flow shards.
+  uint32_t                    num_shards_;
+
+  /// The array of flow shards, NULL if the flows are processed by the main
+  /// service loop.
+  Shard*                      shards_;
+
+  /// The increment between the flow tags of successive new flows, which
+  /// keeps flow tags unique across the flow shards.
+  uint32_t                    flow_tag_stride_;
+
+  /// The packets that a flow shard has admitted to the BPF during the
+  /// current processing pass.
+  std::vector<iron::Packet*>  bpf_out_pkts_;
+
+  /// The packets sent to the LAN during the current processing pass, which
+  /// are sent together when the pass ends.
+  iron::EdgeIfSendBatch       lan_send_batch_;
+
+  /// Serializes the flow shard sends on the UDP Proxy to BPF packet FIFO.
+  pthread_mutex_t             bpf_send_mutex_;
+
+  /// The number of FEC codec threads. Zero runs the FEC codec inline.
+  uint32_t                    num_fec_threads_;
+
+  /// The FEC codec threads, or NULL if the FEC codec runs inline. Flow
+  /// shards share the codec threads of the dispatching UDP Proxy.
+  FecCodec*                   fec_codec_;
+
+  /// The time that a FEC group may wait for the FEC codec threads.
+  iron::Time                  fec_offload_budget_;
+
+  /// The jobs returned by the FEC codec threads.
+  FecCodecQueue               fec_done_queue_;
+
+  /// The returned jobs being handed to their flows.
+  std::vector<FecCodecJob*>   fec_done_jobs_;
+
+  /// The id of the next FEC codec job.
+  uint64_t                    next_fec_job_id_;
+
 }; // end class UdpProxy
 
 #endif // IRON_UDP_PROXY_H
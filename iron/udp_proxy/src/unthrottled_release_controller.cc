@@ -61,6 +61,12 @@ void UnthrottledReleaseController::SvcEvents(Time& now)
   // HandlePkt() method, so there are no events to service.
 }
 
+//============================================================================
+Time UnthrottledReleaseController::NextEventTime()
+{
+  return Time::Infinite();
+}
+
 //============================================================================
 bool UnthrottledReleaseController::HandlePkt(Packet* pkt)
 {
@@ -55,9 +55,15 @@
 #include "string_utils.h"
 #include "timer.h"
 #include "unused.h"
+#include "vdmfec.h"
 #include "virtual_edge_if.h"
 
 #include <string>
+#include <vector>
+
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <unistd.h>
 
 using ::iron::BinMap;
 using ::iron::ConfigInfo;
@@ -73,6 +79,7 @@ using ::iron::PseudoFifo;
 using ::iron::PseudoSharedMemory;
 using ::iron::SharedMemoryIF;
 using ::iron::StringUtils;
+using ::iron::Time;
 using ::iron::Timer;
 using ::iron::VirtualEdgeIf;
 using ::std::string;
@@ -106,7 +113,7 @@ public:
 
   /// \brief Function initializes the gateway for testing, including setting
   /// up and using configuration info.
-  void InitForTest();
+  void InitForTest(uint32_t num_shards = 1);
   bool CheckKVal(uint64_t value);
   void HasMatchingContext(FECContext& context);
   bool TestModService(FECContext* context);
@@ -114,6 +121,9 @@ public:
   void CheckFlowDefn(FourTuple four_tuple, std::string flow_defn);
   void AddEncodingState(FourTuple four_tuple);
   void CheckStats(FourTuple four_tuple);
+  void CheckShards(FourTuple four_tuple, std::string flow_defn);
+  void CheckShardDispatch(PacketPool& pkt_pool);
+  void CheckFlowSchedule(FourTuple four_tuple);
 
   // Method overriding.
   virtual size_t EdgeIfSend(const Packet* pkt) const;
@@ -148,11 +158,12 @@ UdpProxyAppTester::~UdpProxyAppTester()
 }
 
 //============================================================================
-void UdpProxyAppTester::InitForTest()
+void UdpProxyAppTester::InitForTest(uint32_t num_shards)
 {
   ConfigInfo  ci;
 
   ci.Add("KVal", "6.5e8");
+  ci.Add("NumShards", StringUtils::ToString(num_shards));
 
   // We can use defaults for most configuration values. There is no default
   // Service, though, so this defines a couple that may be useful for testing.
@@ -286,6 +297,184 @@ void UdpProxyAppTester::CheckStats(FourTuple four_tuple)
   CPPUNIT_ASSERT(encoding_state->dump_pkt_number() == 0);
 }
 
+//============================================================================
+void UdpProxyAppTester::CheckShards(FourTuple four_tuple,
+                                    std::string flow_defn)
+{
+  CPPUNIT_ASSERT(num_shards() == 4);
+  CPPUNIT_ASSERT(GetShardIndex(four_tuple) < num_shards());
+
+  // Flow definitions are routed to the owning shard, not kept here.
+  string             err_msg;
+  rapidjson::Value   flow_val(flow_defn.c_str(), flow_defn.size());
+  CPPUNIT_ASSERT(ProcessShardSetMsg("add_flow", flow_val, err_msg));
+  CPPUNIT_ASSERT(!HasFlowDefn(four_tuple));
+  CPPUNIT_ASSERT(ProcessShardSetMsg("del_flow", flow_val, err_msg));
+
+  // A multicast destination list needs a well formed flow tuple to be
+  // routed.
+  string             mcast_defn = "10.1.1.1:5000;10.1.1.2";
+  rapidjson::Value   mcast_val(mcast_defn.c_str(), mcast_defn.size());
+  CPPUNIT_ASSERT(!ProcessShardSetMsg("add_mcast_dst_list", mcast_val,
+                                     err_msg));
+
+  // The shard threads start and stop cleanly.
+  CPPUNIT_ASSERT(StartShards());
+  StopShards();
+}
+
+//============================================================================
+void UdpProxyAppTester::CheckFlowSchedule(FourTuple four_tuple)
+{
+  EncodingState*  encoding_state = NULL;
+  CPPUNIT_ASSERT(GetEncodingState(1, four_tuple, encoding_state));
+
+  // A new flow is due on the next service pass.
+  CPPUNIT_ASSERT(encoding_state->svc_deadline().IsZero());
+
+  // Once serviced, a flow without a backlog is left alone until the quiet
+  // flow service interval has elapsed.
+  Time  now = Time::Now();
+  ServiceStates(now);
+  CPPUNIT_ASSERT(encoding_state->svc_deadline() > now);
+
+  Time  deadline = encoding_state->svc_deadline();
+  ServiceStates(now);
+  CPPUNIT_ASSERT(encoding_state->svc_deadline() == deadline);
+
+  // The garbage collector leaves the active flow in place, and expires it
+  // once its timeout has passed.
+  GarbageCollectionTimeout(now);
+  CPPUNIT_ASSERT(GetExistingEncodingState(four_tuple, encoding_state));
+  CPPUNIT_ASSERT(encoding_state->gc_deadline() > now);
+
+  Time  later = now + Time::FromSec(encoding_state->timeout() + 1);
+  GarbageCollectionTimeout(later);
+  CPPUNIT_ASSERT(!GetExistingEncodingState(four_tuple, encoding_state));
+}
+
+//============================================================================
+void UdpProxyAppTester::CheckShardDispatch(PacketPool& pkt_pool)
+{
+  const size_t  kNumFlows  = 6;
+  const size_t  kNumRounds = 2;
+  FourTuple     four_tuples[kNumFlows];
+  uint32_t      flow_shard[kNumFlows];
+  bool          shard_used[4] = { false, false, false, false };
+
+  CPPUNIT_ASSERT(num_shards() == 4);
+
+  // The shard proxies are plain UdpProxy objects, so their protected
+  // methods are reached through member pointers named via this class.
+  void (UdpProxy::*run_encoder)(Packet*) = &UdpProxyAppTester::RunEncoder;
+  bool (UdpProxy::*get_state)(const FourTuple&, EncodingState*&) =
+    &UdpProxyAppTester::GetExistingEncodingState;
+
+  uint32_t  saddr_nbo = StringUtils::GetIpAddr("10.1.20.1").address();
+  uint32_t  daddr_nbo = StringUtils::GetIpAddr("192.168.3.2").address();
+
+  for (size_t i = 0; i < kNumFlows; ++i)
+  {
+    four_tuples[i].Set(saddr_nbo, htons(20000 + i), daddr_nbo, htons(30001));
+    flow_shard[i]             = GetShardIndex(four_tuples[i]);
+    shard_used[flow_shard[i]] = true;
+  }
+
+  // The flows must be spread over more than one shard for the test to be
+  // meaningful.
+  CPPUNIT_ASSERT((shard_used[0] + shard_used[1] + shard_used[2] +
+                  shard_used[3]) > 1);
+
+  // Dispatch interleaved packets from every flow, several times over.
+  for (size_t round = 0; round < kNumRounds; ++round)
+  {
+    for (size_t i = 0; i < kNumFlows; ++i)
+    {
+      Packet*  pkt = pkt_pool.Get();
+      CPPUNIT_ASSERT(pkt);
+
+      struct iphdr  ip_hdr;
+      memset(&ip_hdr, 0, sizeof(ip_hdr));
+      ip_hdr.version  = 4;
+      ip_hdr.ihl      = 5;
+      ip_hdr.ttl      = 64;
+      ip_hdr.protocol = IPPROTO_UDP;
+      ip_hdr.saddr    = four_tuples[i].src_addr_nbo();
+      ip_hdr.daddr    = four_tuples[i].dst_addr_nbo();
+      ip_hdr.tot_len  = htons(sizeof(ip_hdr) + sizeof(struct udphdr) + 100);
+
+      struct udphdr  udp_hdr;
+      memset(&udp_hdr, 0, sizeof(udp_hdr));
+      udp_hdr.source = four_tuples[i].src_port_nbo();
+      udp_hdr.dest   = four_tuples[i].dst_port_nbo();
+      udp_hdr.len    = htons(sizeof(udp_hdr) + 100);
+
+      memset(pkt->GetBuffer(), 0, pkt->GetMaxLengthInBytes());
+      memcpy(pkt->GetBuffer(), &ip_hdr, sizeof(ip_hdr));
+      memcpy(pkt->GetBuffer(sizeof(ip_hdr)), &udp_hdr, sizeof(udp_hdr));
+      pkt->SetLengthInBytes(sizeof(ip_hdr) + sizeof(udp_hdr) + 100);
+
+      DispatchPkt(pkt, true);
+      CPPUNIT_ASSERT(shards_[flow_shard[i]].staged_lan_pkts.back() == pkt);
+    }
+  }
+
+  FlushDispatchedPkts();
+
+  // Every packet is in the inbound ring of the shard that owns its flow.
+  size_t  num_pkts = 0;
+
+  for (uint32_t shard_i = 0; shard_i < num_shards(); ++shard_i)
+  {
+    std::vector<Packet*>&  lan_pkts = shards_[shard_i].lan_pkts;
+
+    for (size_t j = 0; j < lan_pkts.size(); ++j)
+    {
+      uint32_t  saddr = 0;
+      uint32_t  daddr = 0;
+      uint16_t  sport = 0;
+      uint16_t  dport = 0;
+      uint32_t  proto = 0;
+
+      CPPUNIT_ASSERT(lan_pkts[j]->GetFiveTuple(saddr, daddr, sport, dport,
+                                               proto));
+      FourTuple  four_tuple(saddr, sport, daddr, dport);
+      CPPUNIT_ASSERT(GetShardIndex(four_tuple) == shard_i);
+    }
+
+    num_pkts += lan_pkts.size();
+  }
+
+  CPPUNIT_ASSERT(num_pkts == (kNumFlows * kNumRounds));
+
+  // Encode each shard's packets, as its thread would.
+  for (uint32_t shard_i = 0; shard_i < num_shards(); ++shard_i)
+  {
+    std::vector<Packet*>  lan_pkts;
+    lan_pkts.swap(shards_[shard_i].lan_pkts);
+
+    for (size_t j = 0; j < lan_pkts.size(); ++j)
+    {
+      (shards_[shard_i].proxy->*run_encoder)(lan_pkts[j]);
+    }
+  }
+
+  // Only the owning shard holds the encoding state of a flow.
+  for (size_t i = 0; i < kNumFlows; ++i)
+  {
+    EncodingState*  state = NULL;
+
+    CPPUNIT_ASSERT(!GetExistingEncodingState(four_tuples[i], state));
+
+    for (uint32_t shard_i = 0; shard_i < num_shards(); ++shard_i)
+    {
+      CPPUNIT_ASSERT((shards_[shard_i].proxy->*get_state)(four_tuples[i],
+                                                          state) ==
+                     (shard_i == flow_shard[i]));
+    }
+  }
+}
+
 //============================================================================
 size_t UdpProxyAppTester::EdgeIfSend(const Packet* pkt) const
 {
@@ -333,6 +522,10 @@ class FECGatewayTest : public CppUnit::TestFixture
   CPPUNIT_TEST(TestModService);
   CPPUNIT_TEST(TestFlowDefn);
   CPPUNIT_TEST(TestStats);
+  CPPUNIT_TEST(TestShards);
+  CPPUNIT_TEST(TestShardDispatch);
+  CPPUNIT_TEST(TestFlowSchedule);
+  CPPUNIT_TEST(TestFecCodec);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -370,7 +563,7 @@ class FECGatewayTest : public CppUnit::TestFixture
     udp_to_bpf_pkt_fifo_ = new PseudoFifo();
 
     pkt_pool_ = new PacketPoolHeap();
-    CPPUNIT_ASSERT(pkt_pool_->Create(8) == true);
+    CPPUNIT_ASSERT(pkt_pool_->Create(32) == true);
 
     fecstate_pool_ = new FecStatePool(*pkt_pool_);
 
@@ -513,6 +706,154 @@ class FECGatewayTest : public CppUnit::TestFixture
     udp_proxy_->CheckStats(four_tuple);
   }
 
+  //==========================================================================
+  void TestShards()
+  {
+    UdpProxyAppTester*  sharded_proxy =
+      new (std::nothrow) UdpProxyAppTester(*pkt_pool_, *bin_map_,
+                                           *fecstate_pool_,
+                                           *timer_, *edge_if_,
+                                           *weight_qd_shared_memory_,
+                                           bpf_to_udp_pkt_fifo_,
+                                           udp_to_bpf_pkt_fifo_);
+    CPPUNIT_ASSERT(sharded_proxy != NULL);
+    sharded_proxy->InitForTest(4);
+
+    uint32_t sport_nbo = htons(30000);
+    uint32_t dport_nbo = htons(39999);
+    uint64_t saddr_nbo = htonl(
+      (uint64_t)(iron::StringUtils::GetIpAddr("192.168.1.1").address()));
+    uint64_t daddr_nbo = htonl(
+      (uint64_t)(iron::StringUtils::GetIpAddr("192.168.1.2").address()));
+
+    FourTuple four_tuple(saddr_nbo, sport_nbo, daddr_nbo, dport_nbo);
+
+    std::string flow_defn = "30000;39999;192.168.1.1;192.168.1.2;1/1;1500;"
+      "0;0;120;40000;type=STRAP:p=10:b=1:label=f1;dscp=46";
+    sharded_proxy->CheckShards(four_tuple, flow_defn);
+
+    delete sharded_proxy;
+  }
+
+  //==========================================================================
+  void TestShardDispatch()
+  {
+    UdpProxyAppTester*  sharded_proxy =
+      new (std::nothrow) UdpProxyAppTester(*pkt_pool_, *bin_map_,
+                                           *fecstate_pool_,
+                                           *timer_, *edge_if_,
+                                           *weight_qd_shared_memory_,
+                                           bpf_to_udp_pkt_fifo_,
+                                           udp_to_bpf_pkt_fifo_);
+    CPPUNIT_ASSERT(sharded_proxy != NULL);
+    sharded_proxy->InitForTest(4);
+
+    sharded_proxy->CheckShardDispatch(*pkt_pool_);
+
+    delete sharded_proxy;
+  }
+
+  //==========================================================================
+  void TestFlowSchedule()
+  {
+    uint32_t sport_nbo = htons(30000);
+    uint32_t dport_nbo = htons(39999);
+    uint64_t saddr_nbo = htonl(
+      (uint64_t)(iron::StringUtils::GetIpAddr("192.168.1.1").address()));
+    uint64_t daddr_nbo = htonl(
+      (uint64_t)(iron::StringUtils::GetIpAddr("192.168.1.2").address()));
+
+    FourTuple four_tuple(saddr_nbo, sport_nbo, daddr_nbo, dport_nbo);
+    udp_proxy_->CheckFlowSchedule(four_tuple);
+  }
+
+  //==========================================================================
+  void TestFecCodec()
+  {
+    const int  kNumSrc = 4;
+    const int  kNumRpr = 2;
+    const int  kLen    = 64;
+
+    unsigned char  src[kNumSrc][kLen];
+    unsigned char  inline_fec[kNumRpr][kLen];
+    unsigned char  offload_fec[kNumRpr][kLen];
+
+    for (int i = 0; i < kNumSrc; ++i)
+    {
+      for (int j = 0; j < kLen; ++j)
+      {
+        src[i][j] = static_cast<unsigned char>((i * 37) + (j * 11));
+      }
+    }
+
+    init_vdmfec();
+
+    FecCodecJob  inline_job;
+    FecCodecJob* job      = new FecCodecJob();
+    FecCodecJob* late_job = new FecCodecJob();
+    FecCodecJob* jobs[3]  = { &inline_job, job, late_job };
+
+    for (int i = 0; i < 3; ++i)
+    {
+      jobs[i]->num_src = kNumSrc;
+      jobs[i]->num_dst = kNumRpr;
+
+      for (int j = 0; j < kNumSrc; ++j)
+      {
+        jobs[i]->psrc[j]   = src[j];
+        jobs[i]->src_sz[j] = kLen;
+      }
+
+      for (int j = 0; j < kNumRpr; ++j)
+      {
+        jobs[i]->pdst[j] = (i == 0) ? inline_fec[j] : offload_fec[j];
+      }
+    }
+
+    FecCodec::RunJob(&inline_job);
+
+    // Both jobs are for the same flow, so they are run in order by the same
+    // codec thread. The second job has already missed its deadline.
+    FecCodecQueue  done_queue;
+    FecCodec       codec(2);
+    CPPUNIT_ASSERT(codec.Start());
+
+    job->deadline        = Time::Now() + Time::FromSec(5);
+    job->done_queue      = &done_queue;
+    late_job->deadline   = Time();
+    late_job->done_queue = &done_queue;
+
+    codec.Submit(job);
+    codec.Submit(late_job);
+
+    std::vector<FecCodecJob*>  done_jobs;
+
+    for (int i = 0; (i < 500) && (done_jobs.size() < 2); ++i)
+    {
+      std::vector<FecCodecJob*>  batch;
+      done_queue.Swap(batch);
+      done_jobs.insert(done_jobs.end(), batch.begin(), batch.end());
+      usleep(10000);
+    }
+
+    codec.Stop();
+
+    CPPUNIT_ASSERT(done_jobs.size() == 2);
+    CPPUNIT_ASSERT(done_jobs[0] == job);
+    CPPUNIT_ASSERT(!job->expired);
+    CPPUNIT_ASSERT(done_jobs[1] == late_job);
+    CPPUNIT_ASSERT(late_job->expired);
+
+    for (int i = 0; i < kNumRpr; ++i)
+    {
+      CPPUNIT_ASSERT(job->fec_sz[i] == inline_job.fec_sz[i]);
+      CPPUNIT_ASSERT(memcmp(offload_fec[i], inline_fec[i], kLen) == 0);
+    }
+
+    delete job;
+    delete late_job;
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(FECGatewayTest);
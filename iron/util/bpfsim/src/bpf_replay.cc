@@ -0,0 +1,496 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "bpf_replay.h"
+
+#include "replay_path_ctrl.h"
+#include "sim_bpfwder.h"
+
+#include "bin_map.h"
+#include "log.h"
+#include "packet.h"
+#include "string_utils.h"
+#include "unused.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <inttypes.h>
+#include <time.h>
+
+
+using ::iron::BinId;
+using ::iron::BinMap;
+using ::iron::BpfTraceCapacity;
+using ::iron::BpfTracePdd;
+using ::iron::BpfTracePktInfo;
+using ::iron::BpfTraceXmitQueueSize;
+using ::iron::Packet;
+using ::iron::PktMemIndex;
+using ::iron::StringUtils;
+using ::iron::Time;
+using ::std::string;
+using ::std::vector;
+
+
+namespace
+{
+  /// Class name for logging.
+  const char*     UNUSED(kClassName)     = "BpfReplay";
+
+  /// The default number of packets in the packet pool.
+  const uint32_t  kDefaultPacketPoolSize = 65536;
+
+  /// The longest simulated time step, matching the BPF's select() backstop
+  /// time, in seconds.
+  const double    kMaxStepSec            = 0.1;
+
+  /// The maximum number of PktMemIndex values read from a FIFO at once.
+  const size_t    kMaxDeliveryBatch      = 256;
+
+  /// \brief Get the monotonic wall clock time, which is not affected by the
+  /// simulated clock.
+  ///
+  /// \return  The wall clock time in seconds.
+  double GetWallTime()
+  {
+    struct timespec  ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (static_cast<double>(ts.tv_sec) +
+            (static_cast<double>(ts.tv_nsec) * 1.0e-9));
+  }
+}
+
+
+//============================================================================
+BpfReplay::BpfReplay()
+    : reader_(),
+      rec_hdr_(),
+      config_info_(),
+      packet_pool_(),
+      timer_(),
+      bin_map_mem_(NULL),
+      bin_map_(NULL),
+      weight_qd_shm_(),
+      bpf_to_udp_fifo_(),
+      bpf_to_tcp_fifo_(),
+      udp_to_bpf_fifo_(),
+      tcp_to_bpf_fifo_(),
+      bpf_(NULL),
+      path_ctrls_(),
+      start_time_(),
+      end_time_(),
+      num_records_(0),
+      num_pkts_(0),
+      num_skipped_(0),
+      num_deliveries_(0),
+      num_dequeues_(0),
+      wall_time_(0.0)
+{
+  memset(&rec_hdr_, 0, sizeof(rec_hdr_));
+}
+
+//============================================================================
+BpfReplay::~BpfReplay()
+{
+  path_ctrls_.clear();
+
+  if (bpf_ != NULL)
+  {
+    delete bpf_;
+    bpf_ = NULL;
+  }
+
+  bin_map_ = NULL;
+
+  if (bin_map_mem_ != NULL)
+  {
+    delete [] bin_map_mem_;
+    bin_map_mem_ = NULL;
+  }
+
+  Time::ClearSimulatedNow();
+}
+
+//============================================================================
+bool BpfReplay::Initialize(const string& config_file,
+                           const string& trace_file,
+                           const vector<string>& overrides)
+{
+  if (!reader_.Open(trace_file))
+  {
+    return false;
+  }
+
+  if (!config_info_.LoadFromFile(config_file))
+  {
+    LogE(kClassName, __func__, "Error loading configuration file %s.\n",
+         config_file.c_str());
+    return false;
+  }
+
+  for (size_t i = 0; i < overrides.size(); ++i)
+  {
+    size_t  pos = overrides[i].find('=');
+
+    if ((pos == string::npos) || (pos == 0))
+    {
+      LogE(kClassName, __func__, "Invalid override \"%s\", expecting "
+           "key=value.\n", overrides[i].c_str());
+      return false;
+    }
+
+    config_info_.Add(overrides[i].substr(0, pos),
+                     overrides[i].substr(pos + 1));
+  }
+
+  // Replay as the recorded node, without recording again, and with every
+  // Path Controller replaced by one that is driven from the trace.
+  uint32_t  num_pcs = config_info_.GetUint("Bpf.NumPathControllers", 0);
+
+  config_info_.Add("Bpf.BinId", StringUtils::ToString(
+                     static_cast<uint32_t>(reader_.file_hdr().bin_id)));
+  config_info_.Add("Bpf.TraceFile", "");
+
+  for (uint32_t i = 0; i < num_pcs; ++i)
+  {
+    config_info_.Add("PathController." + StringUtils::ToString(i) +
+                     ".Type", "Replay");
+  }
+
+  // Everything from here on, including the BPF's initialization, runs on
+  // the simulated clock, starting when the recording started.
+  start_time_ = Time::FromUsec(reader_.file_hdr().start_time_usec);
+  end_time_   = start_time_;
+  Time::SetSimulatedNow(start_time_);
+
+  uint32_t  pool_size = config_info_.GetUint("Sim.PacketPoolSize",
+                                             kDefaultPacketPoolSize);
+
+  if (!packet_pool_.Create(pool_size))
+  {
+    LogE(kClassName, __func__, "Unable to create packet pool of %" PRIu32
+         " packets.\n", pool_size);
+    return false;
+  }
+
+  bin_map_mem_ = new (std::nothrow) char[sizeof(BinMap)];
+
+  if (bin_map_mem_ == NULL)
+  {
+    LogE(kClassName, __func__, "Unable to allocate BinMap.\n");
+    return false;
+  }
+
+  memset(bin_map_mem_, 0, sizeof(BinMap));
+  bin_map_ = reinterpret_cast<BinMap*>(bin_map_mem_);
+
+  if (!bin_map_->Initialize(config_info_))
+  {
+    LogE(kClassName, __func__, "Unable to initialize BinMap.\n");
+    return false;
+  }
+
+  bpf_ = new (std::nothrow) SimBPFwder(
+    packet_pool_, timer_, *bin_map_, weight_qd_shm_, &bpf_to_udp_fifo_,
+    &bpf_to_tcp_fifo_, &udp_to_bpf_fifo_, &tcp_to_bpf_fifo_, config_info_);
+
+  if (bpf_ == NULL)
+  {
+    LogE(kClassName, __func__, "Unable to allocate BPF.\n");
+    return false;
+  }
+
+  if (!bpf_->Initialize())
+  {
+    LogE(kClassName, __func__, "Unable to initialize BPF.\n");
+    return false;
+  }
+
+  for (size_t i = 0; i < bpf_->GetNumReplayPathCtrls(); ++i)
+  {
+    ReplayPathCtrl*  pc     = bpf_->GetReplayPathCtrl(i);
+    size_t           pc_num = pc->path_controller_number();
+
+    if (pc_num >= path_ctrls_.size())
+    {
+      path_ctrls_.resize(pc_num + 1, NULL);
+    }
+
+    path_ctrls_[pc_num] = pc;
+  }
+
+  return true;
+}
+
+//============================================================================
+void BpfReplay::Run()
+{
+  double  wall_start = GetWallTime();
+  Time    now        = start_time_;
+  bool    have_rec   = ReadNextRecord();
+
+  bpf_->StartSimulation();
+
+  while (have_rec)
+  {
+    timer_.DoCallbacks();
+
+    // Apply every record that is due, in recorded order.
+    while ((have_rec) && (Time::FromUsec(rec_hdr_.time_usec) <= now))
+    {
+      ApplyRecord();
+      have_rec = ReadNextRecord();
+    }
+
+    num_dequeues_ += bpf_->RunOnce();
+
+    for (size_t i = 0; i < path_ctrls_.size(); ++i)
+    {
+      if (path_ctrls_[i] != NULL)
+      {
+        path_ctrls_[i]->DiscardUnusedXmitQueueSizes();
+      }
+    }
+
+    DrainDeliveries(bpf_to_udp_fifo_);
+    DrainDeliveries(bpf_to_tcp_fifo_);
+
+    // Jump to the next BPF timer or the next record, whichever is first.
+    Time  next = (now + timer_.GetNextExpirationTime(Time(kMaxStepSec)));
+
+    if (have_rec)
+    {
+      Time  rec_time = Time::FromUsec(rec_hdr_.time_usec);
+
+      if (rec_time < next)
+      {
+        next = ((rec_time > now) ? rec_time : now);
+      }
+    }
+
+    now = next;
+    Time::SetSimulatedNow(now);
+  }
+
+  wall_time_ = (GetWallTime() - wall_start);
+}
+
+//============================================================================
+void BpfReplay::PrintSummary() const
+{
+  fprintf(stdout, "Replayed %.3f s of trace in %.3f s of wall clock time.\n",
+          (end_time_ - start_time_).ToDouble(), wall_time_);
+  fprintf(stdout, "Records: %" PRIu64 " (%" PRIu64 " packets, %" PRIu64
+          " skipped)\n", num_records_, num_pkts_, num_skipped_);
+  fprintf(stdout, "Dequeue solutions: %" PRIu64 "\n", num_dequeues_);
+  fprintf(stdout, "Proxy deliveries: %" PRIu64 " pkts\n", num_deliveries_);
+
+  for (size_t i = 0; i < path_ctrls_.size(); ++i)
+  {
+    if (path_ctrls_[i] != NULL)
+    {
+      fprintf(stdout, "Path Controller %zu %s: %" PRIu64 " bytes sent\n", i,
+              path_ctrls_[i]->endpoints_str().c_str(),
+              path_ctrls_[i]->total_bytes_sent());
+    }
+  }
+}
+
+//============================================================================
+bool BpfReplay::ReadNextRecord()
+{
+  return reader_.ReadRecord(rec_hdr_, rec_body_, sizeof(rec_body_));
+}
+
+//============================================================================
+void BpfReplay::ApplyRecord()
+{
+  ++num_records_;
+  end_time_ = Time::FromUsec(rec_hdr_.time_usec);
+
+  if (rec_hdr_.type == iron::TRACE_RCVD_PKT)
+  {
+    ApplyPacketRecord();
+    return;
+  }
+
+  ReplayPathCtrl*  pc = GetRecordPathCtrl();
+
+  if (pc == NULL)
+  {
+    ++num_skipped_;
+    return;
+  }
+
+  switch (rec_hdr_.type)
+  {
+    case iron::TRACE_CAPACITY:
+      if (rec_hdr_.body_len == sizeof(BpfTraceCapacity))
+      {
+        BpfTraceCapacity  cap;
+        memcpy(&cap, rec_body_, sizeof(cap));
+        bpf_->ProcessCapacityUpdate(pc, cap.chan_cap_est_bps,
+                                    cap.trans_cap_est_bps);
+        return;
+      }
+      break;
+
+    case iron::TRACE_PDD:
+      if (rec_hdr_.body_len == sizeof(BpfTracePdd))
+      {
+        BpfTracePdd  pdd;
+        memcpy(&pdd, rec_body_, sizeof(pdd));
+        bpf_->ProcessPktDelDelay(pc, pdd.pdd_mean, pdd.pdd_variance);
+        return;
+      }
+      break;
+
+    case iron::TRACE_XMIT_QUEUE_SIZE:
+      if (rec_hdr_.body_len == sizeof(BpfTraceXmitQueueSize))
+      {
+        BpfTraceXmitQueueSize  xqs;
+        memcpy(&xqs, rec_body_, sizeof(xqs));
+        pc->AddRecordedXmitQueueSize((xqs.valid != 0),
+                                     static_cast<size_t>(xqs.size));
+        return;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  LogW(kClassName, __func__, "Skipping invalid record of type %" PRIu8
+       " and length %" PRIu32 ".\n", rec_hdr_.type, rec_hdr_.body_len);
+  ++num_skipped_;
+}
+
+//============================================================================
+void BpfReplay::ApplyPacketRecord()
+{
+  BpfTracePktInfo  info;
+
+  if (rec_hdr_.body_len < sizeof(info))
+  {
+    ++num_skipped_;
+    return;
+  }
+
+  memcpy(&info, rec_body_, sizeof(info));
+
+  size_t  capture_len = (rec_hdr_.body_len - sizeof(info));
+
+  if ((info.pkt_len < capture_len) ||
+      (info.pkt_len > iron::kMaxPacketSizeBytes))
+  {
+    LogW(kClassName, __func__, "Skipping packet record of length %" PRIu32
+         ".\n", info.pkt_len);
+    ++num_skipped_;
+    return;
+  }
+
+  ReplayPathCtrl*  pc = NULL;
+
+  if (rec_hdr_.pc_num != iron::kTraceProxyPathCtrlNum)
+  {
+    pc = GetRecordPathCtrl();
+
+    if (pc == NULL)
+    {
+      ++num_skipped_;
+      return;
+    }
+  }
+
+  Packet*  pkt = packet_pool_.Get();
+
+  // Only the headers of IPv4 packets are recorded, so the payload is
+  // replayed as zeros.
+  memcpy(pkt->GetBuffer(), &(rec_body_[sizeof(info)]), capture_len);
+  memset(pkt->GetBuffer(capture_len), 0, (info.pkt_len - capture_len));
+  pkt->SetLengthInBytes(info.pkt_len);
+
+  pkt->set_packet_id(info.packet_id);
+  pkt->set_time_to_go_usec(info.ttg_usec);
+  pkt->set_time_to_go_valid((info.flags & iron::kTraceTtgValid) != 0);
+  pkt->set_track_ttg((info.flags & iron::kTraceTrackTtg) != 0);
+  pkt->set_recv_time(Time::FromUsec(info.recv_time_usec));
+  pkt->set_origin_ts_ms(info.origin_ts_ms);
+  pkt->set_bin_id(static_cast<BinId>(info.bin_id));
+
+  if (info.dst_vec != 0)
+  {
+    pkt->set_dst_vec(static_cast<iron::DstVec>(info.dst_vec));
+  }
+
+  ++num_pkts_;
+  bpf_->ProcessRcvdPacket(pkt, pc);
+}
+
+//============================================================================
+ReplayPathCtrl* BpfReplay::GetRecordPathCtrl() const
+{
+  if ((rec_hdr_.pc_num >= path_ctrls_.size()) ||
+      (path_ctrls_[rec_hdr_.pc_num] == NULL))
+  {
+    LogW(kClassName, __func__, "Record references unknown Path Controller %"
+         PRIu8 ".\n", rec_hdr_.pc_num);
+    return NULL;
+  }
+
+  return path_ctrls_[rec_hdr_.pc_num];
+}
+
+//============================================================================
+void BpfReplay::DrainDeliveries(SimFifo& fifo)
+{
+  PktMemIndex  indices[kMaxDeliveryBatch];
+  size_t       bytes = 0;
+
+  while ((bytes = fifo.Recv(reinterpret_cast<uint8_t*>(indices),
+                            sizeof(indices))) > 0)
+  {
+    for (size_t i = 0; i < (bytes / sizeof(PktMemIndex)); ++i)
+    {
+      packet_pool_.Recycle(packet_pool_.GetPacketFromIndex(indices[i]));
+      ++num_deliveries_;
+    }
+  }
+}
@@ -0,0 +1,213 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+/// \brief Offline replay of a recorded Backpressure Forwarder trace.
+///
+/// A BPF started with "Bpf.TraceFile" records every input that drives its
+/// forwarding decisions: the packets it receives (from the proxies and from
+/// each Path Controller), the capacity and packet delivery delay updates,
+/// and the answers to its transmit queue size queries.  The replay runs a
+/// single real BPFwder, built from the same configuration file, on the
+/// simulated clock and feeds it those inputs at their recorded times.  The
+/// BPF's own timers fire in between, exactly as in the simulator.  This
+/// allows a field problem to be reproduced under a debugger or profiler,
+/// and forwarding algorithm changes to be compared on identical inputs.
+///
+/// Every PathController.X.Type is replaced by "Replay", so that no sockets
+/// are opened and the packets the BPF sends are simply counted.  The replay
+/// is open loop: the recorded inputs, including the answers to the transmit
+/// queue size queries, are applied regardless of what the replayed BPF
+/// sends.
+
+#ifndef IRON_UTIL_BPFSIM_BPF_REPLAY_H
+#define IRON_UTIL_BPFSIM_BPF_REPLAY_H
+
+#include "sim_fifo.h"
+#include "sim_shared_memory.h"
+
+#include "bpf_trace.h"
+#include "config_info.h"
+#include "iron_constants.h"
+#include "itime.h"
+#include "packet_pool_heap.h"
+#include "timer.h"
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+
+namespace iron
+{
+  class BinMap;
+}
+
+class ReplayPathCtrl;
+class SimBPFwder;
+
+class BpfReplay
+{
+ public:
+
+  /// \brief Constructor.
+  BpfReplay();
+
+  /// \brief Destructor.
+  virtual ~BpfReplay();
+
+  /// \brief Open the trace and build the BPF that it is replayed into.
+  ///
+  /// \param  config_file  The BPF configuration file of the recorded node.
+  /// \param  trace_file   The trace file name.
+  /// \param  overrides    "key=value" strings applied after loading the
+  ///                      configuration file, e.g. to try other settings.
+  ///
+  /// \return  True on success, false otherwise.
+  bool Initialize(const std::string& config_file,
+                  const std::string& trace_file,
+                  const std::vector<std::string>& overrides);
+
+  /// \brief Replay the whole trace.
+  void Run();
+
+  /// \brief Print the replay summary to stdout.
+  void PrintSummary() const;
+
+ private:
+
+  /// Copy constructor.
+  BpfReplay(const BpfReplay& other);
+
+  /// Copy operator.
+  BpfReplay& operator=(const BpfReplay& other);
+
+  /// \brief Read the next trace record into rec_hdr_ and rec_body_.
+  ///
+  /// \return  True if a record was read, false at the end of the trace.
+  bool ReadNextRecord();
+
+  /// \brief Hand the current trace record to the BPF.
+  void ApplyRecord();
+
+  /// \brief Rebuild a recorded packet and hand it to the BPF.
+  void ApplyPacketRecord();
+
+  /// \brief Find the Path Controller a record refers to.
+  ///
+  /// \return  The Path Controller, or NULL if the trace references an
+  ///          unknown one.
+  ReplayPathCtrl* GetRecordPathCtrl() const;
+
+  /// \brief Consume the packets that the BPF delivered to its proxies.
+  ///
+  /// \param  fifo  The delivery FIFO.
+  void DrainDeliveries(SimFifo& fifo);
+
+  /// The trace reader.
+  iron::BpfTraceReader          reader_;
+
+  /// The header of the current trace record.
+  iron::BpfTraceRecordHeader    rec_hdr_;
+
+  /// The body of the current trace record.
+  uint8_t                       rec_body_[sizeof(iron::BpfTracePktInfo) +
+                                          iron::kMaxPacketSizeBytes];
+
+  /// The BPF configuration.
+  iron::ConfigInfo              config_info_;
+
+  /// The packet pool.
+  iron::PacketPoolHeap          packet_pool_;
+
+  /// The timer, and the replay's event queue.
+  iron::Timer                   timer_;
+
+  /// The memory backing the BinMap.
+  char*                         bin_map_mem_;
+
+  /// The BinMap, placed in bin_map_mem_.
+  iron::BinMap*                 bin_map_;
+
+  /// The weight queue depths published by the BPF.
+  SimSharedMemory               weight_qd_shm_;
+
+  /// Delivery from the BPF to the UDP Proxy.
+  SimFifo                       bpf_to_udp_fifo_;
+
+  /// Delivery from the BPF to the TCP Proxy.
+  SimFifo                       bpf_to_tcp_fifo_;
+
+  /// Unused, packets are injected directly.
+  SimFifo                       udp_to_bpf_fifo_;
+
+  /// Unused, packets are injected directly.
+  SimFifo                       tcp_to_bpf_fifo_;
+
+  /// The replayed Backpressure Forwarder.
+  SimBPFwder*                   bpf_;
+
+  /// The Path Controllers, indexed by path controller number.
+  std::vector<ReplayPathCtrl*>  path_ctrls_;
+
+  /// The recorded start time of the trace.
+  iron::Time                    start_time_;
+
+  /// The time of the last record replayed.
+  iron::Time                    end_time_;
+
+  /// The number of records replayed.
+  uint64_t                      num_records_;
+
+  /// The number of packets replayed.
+  uint64_t                      num_pkts_;
+
+  /// The number of records skipped as invalid.
+  uint64_t                      num_skipped_;
+
+  /// The number of packets the BPF delivered to its proxies.
+  uint64_t                      num_deliveries_;
+
+  /// The number of dequeue solutions found by the BPF.
+  uint64_t                      num_dequeues_;
+
+  /// The wall clock time taken by Run(), in seconds.
+  double                        wall_time_;
+
+}; // end class BpfReplay
+
+#endif // IRON_UTIL_BPFSIM_BPF_REPLAY_H
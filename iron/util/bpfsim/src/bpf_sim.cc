@@ -0,0 +1,677 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "bpf_sim.h"
+
+#include "sim_bpfwder.h"
+#include "sim_flow.h"
+#include "sim_path_ctrl.h"
+
+#include "bin_map.h"
+#include "list.h"
+#include "log.h"
+#include "packet.h"
+#include "queue_depths.h"
+#include "string_utils.h"
+#include "unused.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <inttypes.h>
+
+
+using ::iron::BinId;
+using ::iron::BinIndex;
+using ::iron::BinMap;
+using ::iron::ConfigInfo;
+using ::iron::Ipv4Address;
+using ::iron::List;
+using ::iron::Packet;
+using ::iron::PktMemIndex;
+using ::iron::QueueDepths;
+using ::iron::StringUtils;
+using ::iron::Time;
+using ::std::string;
+using ::std::vector;
+
+
+namespace
+{
+  /// Class name for logging.
+  const char*     UNUSED(kClassName)          = "BpfSim";
+
+  /// The default simulated run time, in seconds.
+  const double    kDefaultDurationSec         = 10.0;
+
+  /// The default number of packets in the shared packet pool.
+  const uint32_t  kDefaultPacketPoolSize      = 65536;
+
+  /// The default remote control port of the first node.
+  const uint32_t  kDefaultRemoteControlPort   = 35000;
+
+  /// The simulated time at which every run starts, in seconds.  Not zero,
+  /// as a zero Time often means "unset".
+  const double    kStartTimeSec               = 1000.0;
+
+  /// The longest simulated time step, matching the BPF's select() backstop
+  /// time, in seconds.
+  const double    kMaxStepSec                 = 0.1;
+
+  /// The UDP port used for link endpoints.
+  const uint16_t  kLinkPort                   = 30300;
+
+  /// The maximum number of PktMemIndex values read from a FIFO at once.
+  const size_t    kMaxDeliveryBatch           = 256;
+}
+
+
+//============================================================================
+BpfSim::SimNode::SimNode()
+    : bin_id(0),
+      is_int_node(false),
+      config_info(),
+      bin_map_mem(NULL),
+      bin_map(NULL),
+      weight_qd_shm(),
+      proxy_qd(NULL),
+      bpf_to_udp_fifo(),
+      bpf_to_tcp_fifo(),
+      udp_to_bpf_fifo(),
+      tcp_to_bpf_fifo(),
+      num_path_ctrls(0),
+      bpf(NULL)
+{
+}
+
+//============================================================================
+BpfSim::SimNode::~SimNode()
+{
+  if (proxy_qd != NULL)
+  {
+    delete proxy_qd;
+    proxy_qd = NULL;
+  }
+
+  if (bpf != NULL)
+  {
+    delete bpf;
+    bpf = NULL;
+  }
+
+  bin_map = NULL;
+
+  if (bin_map_mem != NULL)
+  {
+    delete [] bin_map_mem;
+    bin_map_mem = NULL;
+  }
+}
+
+//============================================================================
+BpfSim::BpfSim()
+    : config_file_(),
+      overrides_(),
+      config_info_(),
+      packet_pool_(),
+      timer_(),
+      start_time_(),
+      duration_(),
+      nodes_(),
+      flows_(),
+      unknown_deliveries_(0)
+{
+}
+
+//============================================================================
+BpfSim::~BpfSim()
+{
+  for (size_t i = 0; i < flows_.size(); ++i)
+  {
+    if (flows_[i] != NULL)
+    {
+      delete flows_[i];
+      flows_[i] = NULL;
+    }
+  }
+
+  for (size_t i = 0; i < nodes_.size(); ++i)
+  {
+    delete nodes_[i];
+    nodes_[i] = NULL;
+  }
+
+  Time::ClearSimulatedNow();
+}
+
+//============================================================================
+bool BpfSim::Initialize(const string& config_file,
+                        const vector<string>& overrides)
+{
+  config_file_ = config_file;
+  overrides_   = overrides;
+
+  if (!LoadConfig(config_info_))
+  {
+    return false;
+  }
+
+  // Everything from here on, including the BPFs' initialization, runs on
+  // the simulated clock.  It always starts at the same time so that runs are
+  // reproducible.
+  start_time_ = Time(kStartTimeSec);
+  duration_   = Time(config_info_.GetDouble("Sim.DurationSec",
+                                            kDefaultDurationSec));
+  Time::SetSimulatedNow(start_time_);
+
+  uint32_t  pool_size = config_info_.GetUint("Sim.PacketPoolSize",
+                                             kDefaultPacketPoolSize);
+
+  if (!packet_pool_.Create(pool_size))
+  {
+    LogE(kClassName, __func__, "Unable to create packet pool of %" PRIu32
+         " packets.\n", pool_size);
+    return false;
+  }
+
+  if ((!CreateNodes(config_info_.Get("Sim.Nodes", ""), false)) ||
+      (!CreateNodes(config_info_.Get("Sim.IntNodes", ""), true)))
+  {
+    return false;
+  }
+
+  if (nodes_.empty())
+  {
+    LogE(kClassName, __func__, "No nodes configured in Sim.Nodes.\n");
+    return false;
+  }
+
+  return (ConfigureLinks() && InitializeNodes() && CreateFlows());
+}
+
+//============================================================================
+void BpfSim::Run()
+{
+  Time  end_time = (start_time_ + duration_);
+  Time  now      = start_time_;
+
+  for (size_t i = 0; i < nodes_.size(); ++i)
+  {
+    nodes_[i]->bpf->StartSimulation();
+  }
+
+  while (now < end_time)
+  {
+    timer_.DoCallbacks();
+
+    for (size_t i = 0; i < nodes_.size(); ++i)
+    {
+      SimNode*  node = nodes_[i];
+
+      node->bpf->RunOnce();
+
+      DrainDeliveries(*node, node->bpf_to_udp_fifo);
+      DrainDeliveries(*node, node->bpf_to_tcp_fifo);
+    }
+
+    // Jump straight to the next event, exactly as the BPF's select() would
+    // have slept until it.
+    now = (now + timer_.GetNextExpirationTime(Time(kMaxStepSec)));
+    Time::SetSimulatedNow(now);
+  }
+}
+
+//============================================================================
+void BpfSim::PrintSummary() const
+{
+  fprintf(stdout, "Simulated %.3f s, %zu nodes, %zu flows.\n",
+          duration_.ToDouble(), nodes_.size(), flows_.size());
+
+  for (size_t i = 0; i < flows_.size(); ++i)
+  {
+    if (flows_[i] != NULL)
+    {
+      flows_[i]->PrintSummary(duration_);
+    }
+  }
+
+  for (size_t i = 0; i < nodes_.size(); ++i)
+  {
+    SimBPFwder*  bpf = nodes_[i]->bpf;
+
+    for (size_t j = 0; j < bpf->GetNumSimPathCtrls(); ++j)
+    {
+      SimPathCtrl*  pc = bpf->GetSimPathCtrl(j);
+
+      fprintf(stdout, "Link %s %s: %.3f Mbps\n", pc->label().c_str(),
+              pc->endpoints_str().c_str(),
+              ((pc->total_bytes_sent() * 8.0) / duration_.ToDouble() /
+               1.0e6));
+    }
+  }
+
+  if (unknown_deliveries_ > 0)
+  {
+    fprintf(stdout, "Unknown deliveries: %" PRIu64 " pkts\n",
+            unknown_deliveries_);
+  }
+}
+
+//============================================================================
+bool BpfSim::LoadConfig(ConfigInfo& config_info) const
+{
+  if (!config_info.LoadFromFile(config_file_))
+  {
+    LogE(kClassName, __func__, "Error loading configuration file %s.\n",
+         config_file_.c_str());
+    return false;
+  }
+
+  for (size_t i = 0; i < overrides_.size(); ++i)
+  {
+    size_t  pos = overrides_[i].find('=');
+
+    if ((pos == string::npos) || (pos == 0))
+    {
+      LogE(kClassName, __func__, "Invalid override \"%s\", expecting "
+           "key=value.\n", overrides_[i].c_str());
+      return false;
+    }
+
+    config_info.Add(overrides_[i].substr(0, pos),
+                    overrides_[i].substr(pos + 1));
+  }
+
+  AddBinMapConfig(config_info);
+
+  return true;
+}
+
+//============================================================================
+void BpfSim::AddBinMapConfig(ConfigInfo& config_info) const
+{
+  string  nodes_str     = config_info.Get("Sim.Nodes", "");
+  string  int_nodes_str = config_info.Get("Sim.IntNodes", "");
+
+  if (config_info.Get("BinMap.BinIds", "").empty())
+  {
+    config_info.Add("BinMap.BinIds", nodes_str);
+  }
+
+  if (config_info.Get("BinMap.IntBinIds", "").empty())
+  {
+    config_info.Add("BinMap.IntBinIds", int_nodes_str);
+  }
+
+  List<string>  tokens;
+  StringUtils::Tokenize(nodes_str, ",", tokens);
+
+  string  bin_id_str;
+  while (tokens.Pop(bin_id_str))
+  {
+    string  key = "BinMap.BinId." + bin_id_str + ".HostMasks";
+
+    if (config_info.Get(key, "").empty())
+    {
+      config_info.Add(key, "10." + bin_id_str + ".0.0/16");
+    }
+  }
+}
+
+//============================================================================
+bool BpfSim::CreateNodes(const string& bin_ids_str, bool is_int_node)
+{
+  uint32_t  base_port = config_info_.GetUint("Sim.RemoteControlBasePort",
+                                             kDefaultRemoteControlPort);
+
+  List<string>  tokens;
+  StringUtils::Tokenize(bin_ids_str, ",", tokens);
+
+  string  bin_id_str;
+  while (tokens.Pop(bin_id_str))
+  {
+    SimNode*  node = new (std::nothrow) SimNode();
+
+    if (node == NULL)
+    {
+      LogE(kClassName, __func__, "Unable to allocate node.\n");
+      return false;
+    }
+
+    nodes_.push_back(node);
+
+    node->bin_id      = static_cast<BinId>(
+      StringUtils::GetUint(bin_id_str, iron::kInvalidBinId));
+    node->is_int_node = is_int_node;
+
+    if (!LoadConfig(node->config_info))
+    {
+      return false;
+    }
+
+    node->config_info.Add("Bpf.BinId", bin_id_str);
+    node->config_info.Add("Bpf.RemoteControl.Port",
+                          StringUtils::ToString(
+                            static_cast<uint32_t>(base_port + nodes_.size() -
+                                                  1)));
+
+    // All nodes share the configuration, so each records its own trace.
+    string  trace_file = node->config_info.Get("Bpf.TraceFile", "");
+
+    if (!trace_file.empty())
+    {
+      node->config_info.Add("Bpf.TraceFile", (trace_file + "." +
+                                              bin_id_str));
+    }
+
+    // Each node gets its own BinMap, as the BPF may modify the multicast
+    // groups at run time.
+    node->bin_map_mem = new (std::nothrow) char[sizeof(BinMap)];
+
+    if (node->bin_map_mem == NULL)
+    {
+      LogE(kClassName, __func__, "Unable to allocate BinMap.\n");
+      return false;
+    }
+
+    memset(node->bin_map_mem, 0, sizeof(BinMap));
+    node->bin_map = reinterpret_cast<BinMap*>(node->bin_map_mem);
+
+    if (!node->bin_map->Initialize(node->config_info))
+    {
+      LogE(kClassName, __func__, "Unable to initialize BinMap for node %"
+           PRIBinId ".\n", node->bin_id);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//============================================================================
+bool BpfSim::ConfigureLinks()
+{
+  uint32_t  num_links = config_info_.GetUint("Sim.NumLinks", 0);
+
+  for (uint32_t i = 0; i < num_links; ++i)
+  {
+    string  prefix = "Sim.Link." + StringUtils::ToString(i);
+
+    List<string>  tokens;
+    StringUtils::Tokenize(config_info_.Get(prefix + ".Nodes", ""), ",",
+                          tokens);
+
+    if (tokens.size() != 2)
+    {
+      LogE(kClassName, __func__, "%s.Nodes must list two bin ids.\n",
+           prefix.c_str());
+      return false;
+    }
+
+    string  end_str[2];
+    tokens.Pop(end_str[0]);
+    tokens.Pop(end_str[1]);
+
+    SimNode*  end[2];
+
+    for (size_t e = 0; e < 2; ++e)
+    {
+      end[e] = FindNode(static_cast<BinId>(
+                          StringUtils::GetUint(end_str[e],
+                                               iron::kInvalidBinId)));
+
+      if (end[e] == NULL)
+      {
+        LogE(kClassName, __func__, "%s.Nodes references unknown node %s.\n",
+             prefix.c_str(), end_str[e].c_str());
+        return false;
+      }
+    }
+
+    // The endpoints only need to be unique, as nothing is sent on them.
+    string  addr_prefix = ("10.254." + StringUtils::ToString(i) + ".");
+    string  port_str    = (":" + StringUtils::ToString(
+                             static_cast<uint32_t>(kLinkPort)));
+    string  ep_str[2];
+
+    ep_str[0] = (addr_prefix + "1" + port_str);
+    ep_str[1] = (addr_prefix + "2" + port_str);
+
+    for (size_t e = 0; e < 2; ++e)
+    {
+      SimNode*  node      = end[e];
+      string    pc_prefix = ("PathController." +
+                             StringUtils::ToString(node->num_path_ctrls));
+
+      if (node->num_path_ctrls >= iron::kMaxPathCtrls)
+      {
+        LogE(kClassName, __func__, "Too many links at node %" PRIBinId
+             ".\n", node->bin_id);
+        return false;
+      }
+
+      node->config_info.Add(pc_prefix + ".Type", "Sim");
+      node->config_info.Add(pc_prefix + ".Label", ("link" +
+                                                   StringUtils::ToString(i)));
+      node->config_info.Add(pc_prefix + ".Endpoints",
+                            (ep_str[e] + "->" + ep_str[1 - e]));
+      node->config_info.Add(pc_prefix + ".MaxLineRateKbps",
+                            config_info_.Get(prefix + ".RateKbps", "10000"));
+      node->config_info.Add(pc_prefix + ".DelayMs",
+                            config_info_.Get(prefix + ".DelayMs", "10"));
+
+      ++(node->num_path_ctrls);
+    }
+  }
+
+  for (size_t i = 0; i < nodes_.size(); ++i)
+  {
+    nodes_[i]->config_info.Add("Bpf.NumPathControllers",
+                               StringUtils::ToString(
+                                 nodes_[i]->num_path_ctrls));
+  }
+
+  return true;
+}
+
+//============================================================================
+bool BpfSim::InitializeNodes()
+{
+  for (size_t i = 0; i < nodes_.size(); ++i)
+  {
+    SimNode*  node = nodes_[i];
+
+    node->bpf = new (std::nothrow) SimBPFwder(
+      packet_pool_, timer_, *(node->bin_map), node->weight_qd_shm,
+      &(node->bpf_to_udp_fifo), &(node->bpf_to_tcp_fifo),
+      &(node->udp_to_bpf_fifo), &(node->tcp_to_bpf_fifo), node->config_info);
+
+    if (node->bpf == NULL)
+    {
+      LogE(kClassName, __func__, "Unable to allocate BPF.\n");
+      return false;
+    }
+
+    if (!node->bpf->Initialize())
+    {
+      LogE(kClassName, __func__, "Unable to initialize BPF for node %"
+           PRIBinId ".\n", node->bin_id);
+      return false;
+    }
+
+    node->proxy_qd = new (std::nothrow) QueueDepths(*(node->bin_map));
+
+    if ((node->proxy_qd == NULL) ||
+        (!node->proxy_qd->InitializeShmDirectAccess(&(node->weight_qd_shm))))
+    {
+      LogE(kClassName, __func__, "Unable to attach proxy queue depths for "
+           "node %" PRIBinId ".\n", node->bin_id);
+      return false;
+    }
+  }
+
+  // Connect the two ends of each link.  Link i is the i-th "Sim" Path
+  // Controller created at each of its two nodes, in configuration order.
+  uint32_t  num_links = config_info_.GetUint("Sim.NumLinks", 0);
+
+  vector<size_t>  next_pc(nodes_.size(), 0);
+
+  for (uint32_t i = 0; i < num_links; ++i)
+  {
+    string  prefix = "Sim.Link." + StringUtils::ToString(i);
+
+    List<string>  tokens;
+    StringUtils::Tokenize(config_info_.Get(prefix + ".Nodes", ""), ",",
+                          tokens);
+
+    SimPathCtrl*  pc[2];
+
+    for (size_t e = 0; e < 2; ++e)
+    {
+      string  end_str;
+      tokens.Pop(end_str);
+
+      BinId  bin_id = static_cast<BinId>(StringUtils::GetUint(end_str, 0));
+      size_t n      = 0;
+
+      while (nodes_[n]->bin_id != bin_id)
+      {
+        ++n;
+      }
+
+      pc[e] = nodes_[n]->bpf->GetSimPathCtrl(next_pc[n]);
+      ++next_pc[n];
+    }
+
+    pc[0]->set_peer(pc[1]);
+    pc[1]->set_peer(pc[0]);
+  }
+
+  return true;
+}
+
+//============================================================================
+bool BpfSim::CreateFlows()
+{
+  uint32_t  num_flows = config_info_.GetUint("Sim.NumFlows", 0);
+
+  flows_.resize(num_flows, NULL);
+
+  for (uint32_t i = 0; i < num_flows; ++i)
+  {
+    string    prefix = "Sim.Flow." + StringUtils::ToString(i);
+    BinId     src_id = static_cast<BinId>(
+      config_info_.GetUint(prefix + ".Src", iron::kInvalidBinId));
+    BinId     dst_id = static_cast<BinId>(
+      config_info_.GetUint(prefix + ".Dst", iron::kInvalidBinId));
+    SimNode*  src    = FindNode(src_id);
+    SimNode*  dst    = FindNode(dst_id);
+
+    if ((src == NULL) || (dst == NULL) || (src->is_int_node) ||
+        (dst->is_int_node) || (src == dst))
+    {
+      LogE(kClassName, __func__, "Flow %" PRIu32 " must be between two "
+           "different edge nodes.\n", i);
+      return false;
+    }
+
+    flows_[i] = new (std::nothrow) SimFlow(i, *(src->bpf), *(src->proxy_qd),
+                                           packet_pool_, timer_);
+
+    if ((flows_[i] == NULL) ||
+        (!flows_[i]->Initialize(config_info_, GetHostAddress(src_id),
+                                GetHostAddress(dst_id),
+                                src->bin_map->GetPhyBinIndex(dst_id))))
+    {
+      LogE(kClassName, __func__, "Unable to create flow %" PRIu32 ".\n", i);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//============================================================================
+BpfSim::SimNode* BpfSim::FindNode(BinId bin_id) const
+{
+  for (size_t i = 0; i < nodes_.size(); ++i)
+  {
+    if (nodes_[i]->bin_id == bin_id)
+    {
+      return nodes_[i];
+    }
+  }
+
+  return NULL;
+}
+
+//============================================================================
+Ipv4Address BpfSim::GetHostAddress(BinId bin_id)
+{
+  return Ipv4Address("10." + StringUtils::ToString(
+                       static_cast<uint32_t>(bin_id)) + ".0.1");
+}
+
+//============================================================================
+void BpfSim::DrainDeliveries(SimNode& node, SimFifo& fifo)
+{
+  PktMemIndex  indices[kMaxDeliveryBatch];
+  size_t       bytes = 0;
+  Time         now   = Time::Now();
+
+  while ((bytes = fifo.Recv(reinterpret_cast<uint8_t*>(indices),
+                            sizeof(indices))) > 0)
+  {
+    for (size_t i = 0; i < (bytes / sizeof(PktMemIndex)); ++i)
+    {
+      Packet*   pkt     = packet_pool_.GetPacketFromIndex(indices[i]);
+      uint32_t  flow_id = 0;
+
+      if ((SimFlow::GetFlowId(pkt, flow_id)) && (flow_id < flows_.size()) &&
+          (flows_[flow_id] != NULL))
+      {
+        flows_[flow_id]->RecordDelivery(pkt, now);
+      }
+      else
+      {
+        ++unknown_deliveries_;
+      }
+
+      packet_pool_.Recycle(pkt);
+    }
+  }
+}
@@ -0,0 +1,282 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+/// \brief A discrete-event simulator for networks of Backpressure
+/// Forwarders.
+///
+/// The simulator runs the real BPFwder code for every node of a configured
+/// topology inside a single process.  The nodes share one Timer, which
+/// serves as the simulator's event queue, and the iron::Time clock is
+/// driven by the simulator, so a run executes as fast as the CPU allows and
+/// is exactly reproducible.  Links are modeled by SimPathCtrl objects with a
+/// configurable line rate and propagation delay, and traffic is generated
+/// by SimFlow objects using the real admission control utility functions.
+///
+/// The simulation is described by "Sim." keys, in the same file as the BPF
+/// configuration shared by all nodes:
+///
+/// - Sim.DurationSec          : The simulated run time, in seconds.
+/// - Sim.Nodes                : Comma-separated edge node bin ids.
+/// - Sim.IntNodes             : Comma-separated interior node bin ids.
+/// - Sim.NumLinks             : The number of links.
+/// - Sim.Link.N.Nodes         : The two bin ids connected by link N.
+/// - Sim.Link.N.RateKbps      : The line rate of link N, each direction.
+/// - Sim.Link.N.DelayMs       : The propagation delay of link N.
+/// - Sim.NumFlows             : The number of flows.
+/// - Sim.Flow.N.Src / .Dst    : The flow's edge node bin ids.
+/// - Sim.Flow.N.StartSec      : When the flow starts.
+/// - Sim.Flow.N.StopSec       : When the flow stops.
+/// - Sim.Flow.N.PktSizeBytes  : The UDP payload size.
+/// - Sim.Flow.N.Utility       : "type=LOG:m=..:a=..:p=.." or
+///                              "type=INELASTIC:m=<bps>".
+/// - Sim.Flow.N.DeadlineMs    : Makes the flow EF with this time-to-go.
+/// - Sim.PacketPoolSize       : The number of packets in the shared pool.
+/// - Sim.RemoteControlBasePort: The first node's remote control port.
+///
+/// If the BinMap keys are not present, they are generated from Sim.Nodes
+/// and Sim.IntNodes, with node X owning the 10.X.0.0/16 host mask.
+///
+/// If Bpf.TraceFile is set, node X records its BPF trace to the file name
+/// with ".X" appended.  Such a trace may be replayed with the -r option.
+
+#ifndef IRON_UTIL_BPFSIM_BPF_SIM_H
+#define IRON_UTIL_BPFSIM_BPF_SIM_H
+
+#include "sim_fifo.h"
+#include "sim_shared_memory.h"
+
+#include "config_info.h"
+#include "iron_types.h"
+#include "ipv4_address.h"
+#include "itime.h"
+#include "packet_pool_heap.h"
+#include "timer.h"
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+
+namespace iron
+{
+  class BinMap;
+  class QueueDepths;
+}
+
+class SimBPFwder;
+class SimFlow;
+
+class BpfSim
+{
+ public:
+
+  /// \brief Constructor.
+  BpfSim();
+
+  /// \brief Destructor.
+  virtual ~BpfSim();
+
+  /// \brief Build the simulated network.
+  ///
+  /// The configuration file is loaded once for the simulator and once for
+  /// each node, since ConfigInfo objects cannot be copied.
+  ///
+  /// \param  config_file  The simulation configuration file name.
+  /// \param  overrides    "key=value" strings applied after loading the
+  ///                      file, e.g. for parameter sweeps.
+  ///
+  /// \return  True on success, false otherwise.
+  bool Initialize(const std::string& config_file,
+                  const std::vector<std::string>& overrides);
+
+  /// \brief Run the simulation to completion.
+  void Run();
+
+  /// \brief Print the per-flow and per-link summary to stdout.
+  void PrintSummary() const;
+
+ private:
+
+  /// Copy constructor.
+  BpfSim(const BpfSim& other);
+
+  /// Copy operator.
+  BpfSim& operator=(const BpfSim& other);
+
+  /// The state of one simulated IRON node.
+  struct SimNode
+  {
+    SimNode();
+    virtual ~SimNode();
+
+    /// The node's bin identifier.
+    iron::BinId        bin_id;
+
+    /// True if the node is an interior node.
+    bool               is_int_node;
+
+    /// The node's configuration.
+    iron::ConfigInfo   config_info;
+
+    /// The memory backing the node's BinMap.
+    char*              bin_map_mem;
+
+    /// The node's BinMap, placed in bin_map_mem.
+    iron::BinMap*      bin_map;
+
+    /// The weight queue depths published by the BPF.
+    SimSharedMemory    weight_qd_shm;
+
+    /// The queue depths as seen by the node's proxies.
+    iron::QueueDepths* proxy_qd;
+
+    /// Delivery from the BPF to the UDP Proxy.
+    SimFifo            bpf_to_udp_fifo;
+
+    /// Delivery from the BPF to the TCP Proxy.
+    SimFifo            bpf_to_tcp_fifo;
+
+    /// Unused, packets are injected directly.
+    SimFifo            udp_to_bpf_fifo;
+
+    /// Unused, packets are injected directly.
+    SimFifo            tcp_to_bpf_fifo;
+
+    /// The number of Path Controllers configured so far.
+    uint32_t           num_path_ctrls;
+
+    /// The node's Backpressure Forwarder.
+    SimBPFwder*        bpf;
+
+   private:
+
+    /// Copy constructor.
+    SimNode(const SimNode& other);
+
+    /// Copy operator.
+    SimNode& operator=(const SimNode& other);
+  };
+
+  /// \brief Load the configuration file and overrides into a ConfigInfo.
+  ///
+  /// \param  config_info  The ConfigInfo to load.
+  ///
+  /// \return  True on success, false otherwise.
+  bool LoadConfig(iron::ConfigInfo& config_info) const;
+
+  /// \brief Add the generated BinMap keys, if they are missing.
+  ///
+  /// \param  config_info  The ConfigInfo to update.
+  void AddBinMapConfig(iron::ConfigInfo& config_info) const;
+
+  /// \brief Create the nodes listed in a Sim.Nodes or Sim.IntNodes value.
+  ///
+  /// \param  bin_ids_str  The comma-separated bin ids.
+  /// \param  is_int_node  True if the nodes are interior nodes.
+  ///
+  /// \return  True on success, false otherwise.
+  bool CreateNodes(const std::string& bin_ids_str, bool is_int_node);
+
+  /// \brief Add the Path Controller configuration for each link end.
+  ///
+  /// \return  True on success, false otherwise.
+  bool ConfigureLinks();
+
+  /// \brief Initialize the BPF of each node and connect the links.
+  ///
+  /// \return  True on success, false otherwise.
+  bool InitializeNodes();
+
+  /// \brief Create and initialize the flows.
+  ///
+  /// \return  True on success, false otherwise.
+  bool CreateFlows();
+
+  /// \brief Find a node by bin identifier.
+  ///
+  /// \param  bin_id  The bin identifier.
+  ///
+  /// \return  The node, or NULL if not found.
+  SimNode* FindNode(iron::BinId bin_id) const;
+
+  /// \brief Get the address of the host in a node's generated subnet.
+  ///
+  /// \param  bin_id  The node's bin identifier.
+  ///
+  /// \return  The host address.
+  static iron::Ipv4Address GetHostAddress(iron::BinId bin_id);
+
+  /// \brief Consume the packets that a node delivered to its proxies.
+  ///
+  /// \param  node  The node.
+  /// \param  fifo  The delivery FIFO.
+  void DrainDeliveries(SimNode& node, SimFifo& fifo);
+
+  /// The configuration file name.
+  std::string                 config_file_;
+
+  /// The configuration overrides.
+  std::vector<std::string>    overrides_;
+
+  /// The simulator's configuration.
+  iron::ConfigInfo            config_info_;
+
+  /// The packet pool shared by all nodes.
+  iron::PacketPoolHeap        packet_pool_;
+
+  /// The timer shared by all nodes, and the simulator's event queue.
+  iron::Timer                 timer_;
+
+  /// The simulated time at which the run starts.
+  iron::Time                  start_time_;
+
+  /// The simulated duration of the run.
+  iron::Time                  duration_;
+
+  /// The simulated nodes.
+  std::vector<SimNode*>       nodes_;
+
+  /// The simulated flows, indexed by flow identifier.
+  std::vector<SimFlow*>       flows_;
+
+  /// The number of packets delivered that did not belong to any flow.
+  uint64_t                    unknown_deliveries_;
+
+}; // end class BpfSim
+
+#endif // IRON_UTIL_BPFSIM_BPF_SIM_H
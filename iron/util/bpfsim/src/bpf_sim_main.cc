@@ -0,0 +1,184 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "bpf_replay.h"
+#include "bpf_sim.h"
+
+#include "log.h"
+#include "unused.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+
+using ::iron::Log;
+using ::std::string;
+using ::std::vector;
+
+namespace
+{
+  const char*  UNUSED(cn) = "bpf_sim_main";
+}
+
+void Usage(const std::string& prog_name)
+{
+  fprintf(stderr,"\n");
+  fprintf(stderr,"Usage:\n");
+  fprintf(stderr,"  %s [options] -c <config>\n", prog_name.c_str());
+  fprintf(stderr,"  %s [options] -c <bpf config> -r <trace>\n",
+          prog_name.c_str());
+  fprintf(stderr,"\n");
+  fprintf(stderr,"Options:\n");
+  fprintf(stderr," -c <name>       The simulation configuration file.\n");
+  fprintf(stderr," -r <name>       Replay a BPF trace recorded with\n");
+  fprintf(stderr,"                 Bpf.TraceFile, using the recorded\n");
+  fprintf(stderr,"                 node's BPF configuration file.\n");
+  fprintf(stderr," -s <key=value>  Override a configuration value. May be\n");
+  fprintf(stderr,"                 repeated, e.g. for parameter sweeps.\n");
+  fprintf(stderr," -l <name>       The log file. Default behavior sends\n");
+  fprintf(stderr,"                 log statements to stdout.\n");
+  fprintf(stderr," -d              Turn on debug logging.\n");
+  fprintf(stderr," -h              Print out usage information.\n");
+  fprintf(stderr,"\n");
+
+  exit(2);
+}
+
+int main(int argc, char** argv)
+{
+  extern int      optind;
+  extern char*    optarg;
+  int             c;
+  bool            debug = false;
+  string          config_file;
+  string          trace_file;
+  vector<string>  overrides;
+
+  while ((c = getopt(argc, argv, "c:r:s:l:dh")) != -1)
+  {
+    switch (c)
+    {
+      case 'c':
+        config_file = optarg;
+        break;
+
+      case 'r':
+        trace_file = optarg;
+        break;
+
+      case 's':
+        overrides.push_back(optarg);
+        break;
+
+      case 'l':
+        Log::SetOutputFile(optarg, false);
+        break;
+
+      case 'd':
+        debug = true;
+        break;
+
+      case 'h':
+      default:
+        Usage(argv[0]);
+    }
+  }
+
+  if ((optind < argc) || (config_file.empty()))
+  {
+    Usage(argv[0]);
+  }
+
+  // The simulator runs every node in this process, so only warnings and
+  // errors are logged by default.
+  Log::SetDefaultLevel(debug ? "FEWIAD" : "FEW");
+
+  if (!trace_file.empty())
+  {
+    BpfReplay*  replay = new (std::nothrow) BpfReplay();
+
+    if (replay == NULL)
+    {
+      LogF(cn, __func__, "Unable to allocate replay.\n");
+      exit(1);
+    }
+
+    if (!replay->Initialize(config_file, trace_file, overrides))
+    {
+      LogF(cn, __func__, "Error initializing replay. Aborting...\n");
+      exit(1);
+    }
+
+    replay->Run();
+    replay->PrintSummary();
+
+    delete replay;
+
+    Log::Flush();
+    Log::Destroy();
+
+    exit(0);
+  }
+
+  BpfSim*  sim = new (std::nothrow) BpfSim();
+
+  if (sim == NULL)
+  {
+    LogF(cn, __func__, "Unable to allocate simulator.\n");
+    exit(1);
+  }
+
+  if (!sim->Initialize(config_file, overrides))
+  {
+    LogF(cn, __func__, "Error initializing simulator. Aborting...\n");
+    exit(1);
+  }
+
+  sim->Run();
+  sim->PrintSummary();
+
+  delete sim;
+
+  Log::Flush();
+  Log::Destroy();
+
+  exit(0);
+}
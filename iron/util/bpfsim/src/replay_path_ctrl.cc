@@ -0,0 +1,193 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "replay_path_ctrl.h"
+
+#include "backpressure_fwder.h"
+#include "config_info.h"
+#include "list.h"
+#include "log.h"
+#include "packet.h"
+#include "packet_pool.h"
+#include "string_utils.h"
+#include "unused.h"
+
+#include <inttypes.h>
+
+
+using ::iron::BPFwder;
+using ::iron::ConfigInfo;
+using ::iron::FdEvent;
+using ::iron::FdEventInfo;
+using ::iron::List;
+using ::iron::Packet;
+using ::iron::PacketPool;
+using ::iron::StringUtils;
+using ::std::string;
+
+
+namespace
+{
+  /// Class name for logging.
+  const char*  UNUSED(kClassName) = "ReplayPathCtrl";
+}
+
+
+//============================================================================
+ReplayPathCtrl::ReplayPathCtrl(BPFwder* bpf, PacketPool& packet_pool)
+    : PathController(bpf),
+      packet_pool_(packet_pool),
+      pending_xqs_(),
+      current_xqs_(false, 0),
+      total_bytes_sent_(0)
+{
+}
+
+//============================================================================
+ReplayPathCtrl::~ReplayPathCtrl()
+{
+}
+
+//============================================================================
+bool ReplayPathCtrl::Initialize(const ConfigInfo& config_info,
+                                uint32_t config_id)
+{
+  path_controller_number_ = config_id;
+
+  string  config_prefix("PathController.");
+  config_prefix.append(StringUtils::ToString(static_cast<int>(config_id)));
+
+  label_         = config_info.Get(config_prefix + ".Label");
+  endpoints_str_ = config_info.Get(config_prefix + ".Endpoints");
+
+  if (!ParseEndpointsString(endpoints_str_))
+  {
+    LogE(kClassName, __func__, "ReplayPathCtrl %" PRIu32 ": Error, invalid "
+         "endpoints: %s\n", path_controller_number_, endpoints_str_.c_str());
+    return false;
+  }
+
+  LogC(kClassName, __func__, "ReplayPathCtrl %" PRIu32 " configuration:\n",
+       path_controller_number_);
+  LogC(kClassName, __func__, "Endpoints      : %s->%s\n",
+       local_endpt_.ToString().c_str(), remote_endpt_.ToString().c_str());
+
+  return true;
+}
+
+//============================================================================
+bool ReplayPathCtrl::ConfigurePddReporting(double thresh, double min_period,
+                                           double max_period)
+{
+  return true;
+}
+
+//============================================================================
+bool ReplayPathCtrl::SendPacket(Packet* pkt)
+{
+  if (pkt == NULL)
+  {
+    return false;
+  }
+
+  total_bytes_sent_ += pkt->GetLengthInBytes();
+  packet_pool_.Recycle(pkt);
+
+  return true;
+}
+
+//============================================================================
+void ReplayPathCtrl::ServiceFileDescriptor(int fd, FdEvent event)
+{
+}
+
+//============================================================================
+size_t ReplayPathCtrl::GetFileDescriptors(FdEventInfo* fd_event_array,
+                                          size_t array_size) const
+{
+  return 0;
+}
+
+//============================================================================
+bool ReplayPathCtrl::GetXmitQueueSize(size_t& size) const
+{
+  if (!pending_xqs_.empty())
+  {
+    current_xqs_ = pending_xqs_.front();
+    pending_xqs_.pop_front();
+  }
+
+  size = current_xqs_.size;
+
+  return current_xqs_.valid;
+}
+
+//============================================================================
+void ReplayPathCtrl::AddRecordedXmitQueueSize(bool valid, size_t size)
+{
+  pending_xqs_.push_back(XmitQueueSize(valid, size));
+}
+
+//============================================================================
+void ReplayPathCtrl::DiscardUnusedXmitQueueSizes()
+{
+  if (!pending_xqs_.empty())
+  {
+    current_xqs_ = pending_xqs_.back();
+    pending_xqs_.clear();
+  }
+}
+
+//============================================================================
+bool ReplayPathCtrl::ParseEndpointsString(const string& ep_str)
+{
+  List<string>  tokens;
+  StringUtils::Tokenize(ep_str, "->", tokens);
+
+  if (tokens.size() != 2)
+  {
+    return false;
+  }
+
+  string  lep_str;
+  string  rep_str;
+  tokens.Pop(lep_str);
+  tokens.Peek(rep_str);
+
+  return (local_endpt_.SetEndpoint(lep_str) &&
+          remote_endpt_.SetEndpoint(rep_str));
+}
@@ -0,0 +1,208 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+/// \brief A Path Controller that stands in for a recorded one during BPF
+/// trace replay.
+
+#ifndef IRON_UTIL_BPFSIM_REPLAY_PATH_CTRL_H
+#define IRON_UTIL_BPFSIM_REPLAY_PATH_CTRL_H
+
+#include "path_controller.h"
+
+#include <deque>
+#include <string>
+
+#include <stdint.h>
+
+
+namespace iron
+{
+  class BPFwder;
+  class ConfigInfo;
+  class Packet;
+  class PacketPool;
+}
+
+/// \brief A Path Controller with no link behind it.
+///
+/// During trace replay, every event that a real Path Controller would have
+/// produced (received packets, capacity and PDD updates) comes from the
+/// trace instead.  This Path Controller therefore only absorbs the packets
+/// that the BPF sends, and answers transmit queue size queries with the
+/// recorded answers.
+///
+/// The following configuration items are read, where X is the path
+/// controller number:
+///
+/// - PathController.X.Endpoints : "LOCAL_IP:PORT->REMOTE_IP:PORT".
+/// - PathController.X.Label     : Optional label.
+class ReplayPathCtrl : public iron::PathController
+{
+ public:
+
+  /// \brief Constructor.
+  ///
+  /// \param  bpf          The owning backpressure forwarder.
+  /// \param  packet_pool  The packet pool.
+  ReplayPathCtrl(iron::BPFwder* bpf, iron::PacketPool& packet_pool);
+
+  /// \brief Destructor.
+  virtual ~ReplayPathCtrl();
+
+  /// \brief Initialize the Path Controller.
+  ///
+  /// \param  config_info  The configuration information.
+  /// \param  config_id    The path controller number.
+  ///
+  /// \return  True on success, or false otherwise.
+  virtual bool Initialize(const iron::ConfigInfo& config_info,
+                          uint32_t config_id);
+
+  /// \brief Accept the PDD reporting configuration.  The PDD reports come
+  /// from the trace.
+  ///
+  /// \param  thresh      Ignored.
+  /// \param  min_period  Ignored.
+  /// \param  max_period  Ignored.
+  ///
+  /// \return  True.
+  virtual bool ConfigurePddReporting(double thresh, double min_period,
+                                     double max_period);
+
+  /// \brief Count and recycle a packet sent by the BPF.
+  ///
+  /// \param  pkt  The packet.  Ownership is always taken.
+  ///
+  /// \return  True on success, or false otherwise.
+  virtual bool SendPacket(iron::Packet* pkt);
+
+  /// \brief Does nothing, as there are no file descriptors.
+  ///
+  /// \param  fd     Ignored.
+  /// \param  event  Ignored.
+  virtual void ServiceFileDescriptor(int fd, iron::FdEvent event);
+
+  /// \brief Get the file descriptors.  There are none.
+  ///
+  /// \param  fd_event_array  Unchanged.
+  /// \param  array_size      Ignored.
+  ///
+  /// \return  Zero.
+  virtual size_t GetFileDescriptors(iron::FdEventInfo* fd_event_array,
+                                    size_t array_size) const;
+
+  /// \brief Get the next recorded transmit queue size, or the last one if
+  /// none are pending.
+  ///
+  /// \param  size  Where the size, in bytes, is placed.
+  ///
+  /// \return  The recorded validity of the size.
+  virtual bool GetXmitQueueSize(size_t& size) const;
+
+  /// \brief Get the per-QLAM overhead in bytes.  Matches the SOND.
+  ///
+  /// \return  The per-QLAM overhead in bytes.
+  virtual uint32_t GetPerQlamOverhead() const
+  {
+    return 54;
+  }
+
+  /// \brief Queue a recorded transmit queue size.
+  ///
+  /// The recorded sizes are the answers that the BPF received, in order, so
+  /// each later GetXmitQueueSize() call consumes one of them.
+  ///
+  /// \param  valid  The recorded validity of the size.
+  /// \param  size   The recorded size, in bytes.
+  void AddRecordedXmitQueueSize(bool valid, size_t size);
+
+  /// \brief Drop any recorded transmit queue sizes that the replayed BPF
+  /// did not ask for, keeping the latest one as the current answer.
+  void DiscardUnusedXmitQueueSizes();
+
+  /// \brief Get the total number of bytes sent by the BPF.
+  ///
+  /// \return  The total number of bytes sent.
+  inline uint64_t total_bytes_sent() const
+  {
+    return total_bytes_sent_;
+  }
+
+ private:
+
+  /// \brief Copy constructor.
+  ReplayPathCtrl(const ReplayPathCtrl& other);
+
+  /// \brief Copy operator.
+  ReplayPathCtrl& operator=(const ReplayPathCtrl& other);
+
+  /// \brief Parse the endpoints string.
+  ///
+  /// \param  ep_str  The endpoints string.
+  ///
+  /// \return  True on success, or false otherwise.
+  bool ParseEndpointsString(const std::string& ep_str);
+
+  /// The packet pool.
+  iron::PacketPool&                  packet_pool_;
+
+  /// \brief A recorded transmit queue size query answer.
+  struct XmitQueueSize
+  {
+    XmitQueueSize(bool v, size_t s)
+        : valid(v), size(s)
+    { }
+
+    /// The validity of the size.
+    bool    valid;
+
+    /// The size, in bytes.
+    size_t  size;
+  };
+
+  /// The recorded answers not yet consumed, oldest first.
+  mutable std::deque<XmitQueueSize>  pending_xqs_;
+
+  /// The current answer.
+  mutable XmitQueueSize              current_xqs_;
+
+  /// The total number of bytes sent by the BPF.
+  uint64_t                           total_bytes_sent_;
+
+}; // end class ReplayPathCtrl
+
+#endif // IRON_UTIL_BPFSIM_REPLAY_PATH_CTRL_H
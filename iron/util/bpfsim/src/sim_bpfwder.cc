@@ -0,0 +1,146 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "sim_bpfwder.h"
+
+#include "replay_path_ctrl.h"
+#include "sim_path_ctrl.h"
+
+#include "config_info.h"
+#include "log.h"
+#include "packet.h"
+#include "string_utils.h"
+#include "unused.h"
+
+
+using ::iron::BinId;
+using ::iron::BinMap;
+using ::iron::BPFwder;
+using ::iron::ConfigInfo;
+using ::iron::FifoIF;
+using ::iron::Packet;
+using ::iron::PacketPool;
+using ::iron::PathController;
+using ::iron::SharedMemoryIF;
+using ::iron::StringUtils;
+using ::iron::Timer;
+using ::std::string;
+
+
+namespace
+{
+  /// Class name for logging.
+  const char*  UNUSED(kClassName) = "SimBPFwder";
+}
+
+
+//============================================================================
+SimBPFwder::SimBPFwder(PacketPool& packet_pool,
+                       Timer& timer,
+                       BinMap& bin_map,
+                       SharedMemoryIF& weight_qd_shared_memory,
+                       FifoIF* bpf_to_udp_pkt_fifo,
+                       FifoIF* bpf_to_tcp_pkt_fifo,
+                       FifoIF* udp_to_bpf_pkt_fifo,
+                       FifoIF* tcp_to_bpf_pkt_fifo,
+                       ConfigInfo& config_info)
+    : BPFwder(packet_pool, timer, bin_map, weight_qd_shared_memory,
+              bpf_to_udp_pkt_fifo, bpf_to_tcp_pkt_fifo, udp_to_bpf_pkt_fifo,
+              tcp_to_bpf_pkt_fifo, config_info),
+      sim_packet_pool_(packet_pool),
+      sim_timer_(timer),
+      sim_bin_id_(static_cast<BinId>(
+                    config_info.GetUint("Bpf.BinId", 0, false))),
+      sim_path_ctrls_(),
+      replay_path_ctrls_()
+{
+}
+
+//============================================================================
+SimBPFwder::~SimBPFwder()
+{
+  // The Path Controllers are deleted by the BPFwder destructor.
+  sim_path_ctrls_.clear();
+  replay_path_ctrls_.clear();
+}
+
+//============================================================================
+void SimBPFwder::InjectFromProxy(Packet* pkt)
+{
+  pkt->set_bin_id(sim_bin_id_);
+
+  ProcessRcvdPacket(pkt);
+}
+
+//============================================================================
+PathController* SimBPFwder::CreatePathController(const string& type)
+{
+  if (type == "Replay")
+  {
+    ReplayPathCtrl*  replay_ctrl = new (std::nothrow) ReplayPathCtrl(
+      this, sim_packet_pool_);
+
+    if (replay_ctrl == NULL)
+    {
+      LogW(kClassName, __func__, "Unable to allocate Replay Path "
+           "Controller.\n");
+      return NULL;
+    }
+
+    replay_path_ctrls_.push_back(replay_ctrl);
+
+    return replay_ctrl;
+  }
+
+  if (type != "Sim")
+  {
+    return BPFwder::CreatePathController(type);
+  }
+
+  SimPathCtrl*  path_ctrl = new (std::nothrow) SimPathCtrl(
+    this, sim_packet_pool_, sim_timer_);
+
+  if (path_ctrl == NULL)
+  {
+    LogW(kClassName, __func__, "Unable to allocate Sim Path Controller.\n");
+    return NULL;
+  }
+
+  sim_path_ctrls_.push_back(path_ctrl);
+
+  return path_ctrl;
+}
@@ -0,0 +1,186 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+/// \brief A Backpressure Forwarder that runs inside the discrete-event
+/// simulator.
+///
+/// This is the real BPFwder, with "Sim" Path Controllers connecting it to
+/// the other simulated nodes (or "Replay" Path Controllers when replaying a
+/// trace) and with the main event loop turned inside out, so that the
+/// simulator can advance the simulated clock between iterations.
+
+#ifndef IRON_UTIL_BPFSIM_SIM_BPFWDER_H
+#define IRON_UTIL_BPFSIM_SIM_BPFWDER_H
+
+#include "backpressure_fwder.h"
+
+#include <string>
+#include <vector>
+
+
+class ReplayPathCtrl;
+class SimPathCtrl;
+
+class SimBPFwder : public iron::BPFwder
+{
+ public:
+
+  /// \brief Constructor.
+  ///
+  /// The arguments are passed unchanged to the BPFwder constructor.
+  ///
+  /// \param  packet_pool              Pool of packets to use.
+  /// \param  timer                    The simulator's shared timer.
+  /// \param  bin_map                  This node's mapping of IP addresses to
+  ///                                  bins.
+  /// \param  weight_qd_shared_memory  Memory to share weight queue depths
+  ///                                  with the simulated proxies.
+  /// \param  bpf_to_udp_pkt_fifo      Delivery to the UDP proxy.
+  /// \param  bpf_to_tcp_pkt_fifo      Delivery to the TCP proxy.
+  /// \param  udp_to_bpf_pkt_fifo      Unused, packets are injected directly.
+  /// \param  tcp_to_bpf_pkt_fifo      Unused, packets are injected directly.
+  /// \param  config_info              This node's configuration.
+  SimBPFwder(iron::PacketPool& packet_pool,
+             iron::Timer& timer,
+             iron::BinMap& bin_map,
+             iron::SharedMemoryIF& weight_qd_shared_memory,
+             iron::FifoIF* bpf_to_udp_pkt_fifo,
+             iron::FifoIF* bpf_to_tcp_pkt_fifo,
+             iron::FifoIF* udp_to_bpf_pkt_fifo,
+             iron::FifoIF* tcp_to_bpf_pkt_fifo,
+             iron::ConfigInfo& config_info);
+
+  /// \brief Destructor.
+  virtual ~SimBPFwder();
+
+  /// \brief Start the BPF's periodic timers.
+  ///
+  /// Replaces Start(), which would block in select().
+  inline void StartSimulation()
+  {
+    StartPeriodicTimers();
+  }
+
+  /// \brief Run one iteration of the BPF's main event loop.
+  ///
+  /// The simulator must have already fired the expired timers for the
+  /// current simulated time.
+  ///
+  /// \return  The number of dequeue solutions found.
+  inline uint32_t RunOnce()
+  {
+    return ServiceTimersAndQueues();
+  }
+
+  /// \brief Inject a packet as though received from a local proxy.
+  ///
+  /// \param  pkt  The packet.  Ownership is transferred to the BPF.
+  void InjectFromProxy(iron::Packet* pkt);
+
+  /// \brief Get the number of "Sim" Path Controllers created.
+  ///
+  /// \return  The number of simulated links attached to this node.
+  inline size_t GetNumSimPathCtrls() const
+  {
+    return sim_path_ctrls_.size();
+  }
+
+  /// \brief Get a "Sim" Path Controller.
+  ///
+  /// \param  i  The index, in creation order.
+  ///
+  /// \return  The Path Controller, or NULL if the index is out of range.
+  inline SimPathCtrl* GetSimPathCtrl(size_t i) const
+  {
+    return ((i < sim_path_ctrls_.size()) ? sim_path_ctrls_[i] : NULL);
+  }
+
+  /// \brief Get the number of "Replay" Path Controllers created.
+  ///
+  /// \return  The number of replayed Path Controllers.
+  inline size_t GetNumReplayPathCtrls() const
+  {
+    return replay_path_ctrls_.size();
+  }
+
+  /// \brief Get a "Replay" Path Controller.
+  ///
+  /// \param  i  The index, in creation order.
+  ///
+  /// \return  The Path Controller, or NULL if the index is out of range.
+  inline ReplayPathCtrl* GetReplayPathCtrl(size_t i) const
+  {
+    return ((i < replay_path_ctrls_.size()) ? replay_path_ctrls_[i] : NULL);
+  }
+
+ protected:
+
+  /// \brief Create a Path Controller, adding support for the "Sim" and
+  /// "Replay" types.
+  ///
+  /// \param  type  The Path Controller type from the configuration.
+  ///
+  /// \return  A pointer to the new Path Controller, or NULL on error.
+  virtual iron::PathController* CreatePathController(const std::string& type);
+
+ private:
+
+  /// Copy constructor.
+  SimBPFwder(const SimBPFwder& other);
+
+  /// Copy operator.
+  SimBPFwder& operator=(const SimBPFwder& other);
+
+  /// The packet pool, kept for creating Path Controllers.
+  iron::PacketPool&             sim_packet_pool_;
+
+  /// The shared simulator timer, kept for creating Path Controllers.
+  iron::Timer&                  sim_timer_;
+
+  /// This node's bin identifier.
+  iron::BinId                   sim_bin_id_;
+
+  /// The "Sim" Path Controllers, in creation order.  Owned by the BPFwder.
+  std::vector<SimPathCtrl*>     sim_path_ctrls_;
+
+  /// The "Replay" Path Controllers, in creation order.  Owned by the
+  /// BPFwder.
+  std::vector<ReplayPathCtrl*>  replay_path_ctrls_;
+
+}; // end class SimBPFwder
+
+#endif // IRON_UTIL_BPFSIM_SIM_BPFWDER_H
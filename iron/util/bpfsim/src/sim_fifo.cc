@@ -0,0 +1,128 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "sim_fifo.h"
+
+#include <cstring>
+
+
+//============================================================================
+SimFifo::SimFifo()
+    : iron::FifoIF(),
+      buf_(),
+      msg_sizes_(),
+      head_offset_(0),
+      head_msg_(0)
+{
+}
+
+//============================================================================
+SimFifo::~SimFifo()
+{
+}
+
+//============================================================================
+bool SimFifo::OpenReceiver()
+{
+  return true;
+}
+
+//============================================================================
+bool SimFifo::OpenSender()
+{
+  return true;
+}
+
+//============================================================================
+bool SimFifo::IsOpen() const
+{
+  return true;
+}
+
+//============================================================================
+bool SimFifo::Send(uint8_t* msg_buf, size_t size_bytes)
+{
+  if ((msg_buf == NULL) || (size_bytes == 0))
+  {
+    return false;
+  }
+
+  buf_.insert(buf_.end(), msg_buf, (msg_buf + size_bytes));
+  msg_sizes_.push_back(size_bytes);
+
+  return true;
+}
+
+//============================================================================
+size_t SimFifo::Recv(uint8_t* msg_buf, size_t size_bytes)
+{
+  size_t  bytes = 0;
+
+  while ((head_msg_ < msg_sizes_.size()) &&
+         ((bytes + msg_sizes_[head_msg_]) <= size_bytes))
+  {
+    size_t  msg_size = msg_sizes_[head_msg_];
+
+    memcpy((msg_buf + bytes), &(buf_[head_offset_]), msg_size);
+
+    bytes        += msg_size;
+    head_offset_ += msg_size;
+    ++head_msg_;
+  }
+
+  // Reclaim the space once everything has been read.
+  if (head_msg_ == msg_sizes_.size())
+  {
+    buf_.clear();
+    msg_sizes_.clear();
+    head_offset_ = 0;
+    head_msg_    = 0;
+  }
+
+  return bytes;
+}
+
+//============================================================================
+void SimFifo::AddFileDescriptors(int& max_fd, fd_set& read_fds) const
+{
+}
+
+//============================================================================
+bool SimFifo::InSet(fd_set* fds)
+{
+  return false;
+}
@@ -0,0 +1,135 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+/// \brief An in-memory FIFO for the BPF simulator.
+
+#ifndef IRON_UTIL_BPFSIM_SIM_FIFO_H
+#define IRON_UTIL_BPFSIM_SIM_FIFO_H
+
+#include "fifo_if.h"
+
+#include <vector>
+
+#include <stdint.h>
+#include <sys/select.h>
+
+
+/// \brief A FIFO that queues messages in memory instead of using a named
+/// pipe.
+///
+/// The simulator gives each node one of these for every BPF/proxy FIFO.  It
+/// has no file descriptor, so it never appears ready to the select() based
+/// main loop; instead, the simulator drains the BPF-to-proxy FIFOs directly
+/// with Recv() after each simulation step.  Messages are kept whole: a Recv()
+/// never returns part of a message.
+class SimFifo : public iron::FifoIF
+{
+ public:
+
+  /// \brief Constructor.
+  SimFifo();
+
+  /// \brief Destructor.
+  virtual ~SimFifo();
+
+  /// \brief Open the receive side.  Always succeeds.
+  ///
+  /// \return  True.
+  virtual bool OpenReceiver();
+
+  /// \brief Open the send side.  Always succeeds.
+  ///
+  /// \return  True.
+  virtual bool OpenSender();
+
+  /// \brief Check if the FIFO is open.
+  ///
+  /// \return  True.
+  virtual bool IsOpen() const;
+
+  /// \brief Queue a message.
+  ///
+  /// \param  msg_buf     The message.
+  /// \param  size_bytes  The message size in bytes.
+  ///
+  /// \return  True on success, or false on error.
+  virtual bool Send(uint8_t* msg_buf, size_t size_bytes);
+
+  /// \brief Dequeue as many whole messages as fit in the buffer.
+  ///
+  /// \param  msg_buf     The buffer for the messages.
+  /// \param  size_bytes  The buffer size in bytes.
+  ///
+  /// \return  The number of bytes placed in the buffer.
+  virtual size_t Recv(uint8_t* msg_buf, size_t size_bytes);
+
+  /// \brief Does nothing, as there is no file descriptor.
+  ///
+  /// \param  max_fd    Unchanged.
+  /// \param  read_fds  Unchanged.
+  virtual void AddFileDescriptors(int& max_fd, fd_set& read_fds) const;
+
+  /// \brief Check if the FIFO's file descriptor is in a set.
+  ///
+  /// \param  fds  Ignored.
+  ///
+  /// \return  False, as there is no file descriptor.
+  virtual bool InSet(fd_set* fds);
+
+ private:
+
+  /// \brief Copy constructor.
+  SimFifo(const SimFifo& other);
+
+  /// \brief Copy operator.
+  SimFifo& operator=(const SimFifo& other);
+
+  /// The queued message bytes.
+  std::vector<uint8_t>  buf_;
+
+  /// The size of each queued message, in bytes, in FIFO order.
+  std::vector<size_t>   msg_sizes_;
+
+  /// The offset of the oldest message in buf_.
+  size_t                head_offset_;
+
+  /// The index of the oldest message in msg_sizes_.
+  size_t                head_msg_;
+
+}; // end class SimFifo
+
+#endif // IRON_UTIL_BPFSIM_SIM_FIFO_H
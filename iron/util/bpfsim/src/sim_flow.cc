@@ -0,0 +1,466 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "sim_flow.h"
+
+#include "sim_bpfwder.h"
+
+#include "callback.h"
+#include "config_info.h"
+#include "list.h"
+#include "log.h"
+#include "log_utility.h"
+#include "packet.h"
+#include "packet_pool.h"
+#include "queue_depths.h"
+#include "string_utils.h"
+#include "unused.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <inttypes.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+
+
+using ::iron::BinIndex;
+using ::iron::CallbackNoArg;
+using ::iron::ConfigInfo;
+using ::iron::Ipv4Address;
+using ::iron::List;
+using ::iron::LogUtility;
+using ::iron::Packet;
+using ::iron::PacketPool;
+using ::iron::QueueDepths;
+using ::iron::StringUtils;
+using ::iron::Time;
+using ::iron::Timer;
+using ::std::string;
+
+
+namespace
+{
+  /// Class name for logging.
+  const char*     UNUSED(kClassName) = "SimFlow";
+
+  /// Marker at the start of each SimFlow packet payload.
+  const uint32_t  kPayloadMagic      = 0x5349u;
+
+  /// The base UDP port number.  The flow identifier is added to it.
+  const uint16_t  kBasePort          = 30000;
+
+  /// The default UDP payload size, in bytes.
+  const size_t    kDefaultPktSize    = 1000;
+
+  /// How long to wait before asking the utility function again when it
+  /// returns a send rate of zero, in seconds.  Matches the UDP Proxy's
+  /// admission control tick.
+  const double    kRatePollInterval  = 0.005;
+
+  /// The payload header written into each packet.
+  struct SimFlowPayload
+  {
+    uint32_t  magic;
+    uint32_t  flow_id;
+    uint32_t  seq_num;
+    int64_t   send_time_usec;
+  };
+}
+
+
+//============================================================================
+SimFlow::SimFlow(uint32_t flow_id, SimBPFwder& src_node, QueueDepths& src_qd,
+                 PacketPool& packet_pool, Timer& timer)
+    : flow_id_(flow_id),
+      src_node_(src_node),
+      src_qd_(src_qd),
+      packet_pool_(packet_pool),
+      timer_(timer),
+      src_addr_(),
+      dst_addr_(),
+      payload_len_(kDefaultPktSize),
+      ttg_(),
+      start_time_(),
+      stop_time_(),
+      const_rate_(0.0),
+      k_val_(),
+      utility_fn_(NULL),
+      send_timer_handle_(),
+      next_seq_num_(0),
+      pkts_sent_(0),
+      bytes_sent_(0),
+      pkts_pool_drops_(0),
+      pkts_rcvd_(0),
+      bytes_rcvd_(0),
+      pkts_late_(0),
+      latency_sum_(0.0),
+      latency_max_(0.0)
+{
+}
+
+//============================================================================
+SimFlow::~SimFlow()
+{
+  timer_.CancelTimer(send_timer_handle_);
+
+  if (utility_fn_ != NULL)
+  {
+    delete utility_fn_;
+    utility_fn_ = NULL;
+  }
+
+  CallbackNoArg<SimFlow>::EmptyPool();
+}
+
+//============================================================================
+bool SimFlow::Initialize(const ConfigInfo& config_info,
+                         const Ipv4Address& src_addr,
+                         const Ipv4Address& dst_addr, BinIndex dst_bin_idx)
+{
+  string  prefix = "Sim.Flow." + StringUtils::ToString(flow_id_);
+
+  src_addr_    = src_addr;
+  dst_addr_    = dst_addr;
+  payload_len_ = config_info.GetUint(prefix + ".PktSizeBytes",
+                                     kDefaultPktSize);
+
+  if ((payload_len_ < sizeof(SimFlowPayload)) ||
+      (payload_len_ > (iron::kMaxPacketSizeBytes - sizeof(struct iphdr) -
+                       sizeof(struct udphdr) - 256)))
+  {
+    LogE(kClassName, __func__, "Flow %" PRIu32 ": Invalid packet size %zu "
+         "bytes.\n", flow_id_, payload_len_);
+    return false;
+  }
+
+  Time  now   = Time::Now();
+  start_time_ = now + Time(config_info.GetDouble(prefix + ".StartSec", 0.0));
+  stop_time_  = now + Time(config_info.GetDouble(prefix + ".StopSec",
+                                                 1.0e6));
+
+  double  deadline_ms = config_info.GetDouble(prefix + ".DeadlineMs", 0.0);
+
+  if (deadline_ms > 0.0)
+  {
+    ttg_ = Time(deadline_ms / 1000.0);
+  }
+
+  // The utility definition uses the same "type=X:key=value:..." format as
+  // the UDP Proxy service definitions.
+  string  utility_def = config_info.Get(prefix + ".Utility", "type=LOG");
+  ConfigInfo    ci;
+  List<string>  tokens;
+
+  StringUtils::Tokenize(utility_def, ":", tokens);
+
+  List<string>::WalkState  tokens_ws;
+  tokens_ws.PrepareForWalk();
+
+  string  token;
+  while (tokens.GetNextItem(tokens_ws, token))
+  {
+    List<string>  token_values;
+    StringUtils::Tokenize(token, "=", token_values);
+
+    if (token_values.size() == 2)
+    {
+      string  name;
+      string  value;
+
+      token_values.Pop(name);
+      token_values.Peek(value);
+      ci.Add(name, value);
+    }
+  }
+
+  string  type = ci.Get("type", "");
+
+  if (type == "LOG")
+  {
+    k_val_.set_k_current(config_info.GetUint64("KVal",
+                                               k_val_.GetValue()));
+
+    utility_fn_ = new (std::nothrow) LogUtility(src_qd_, dst_bin_idx, k_val_,
+                                                flow_id_);
+
+    if ((utility_fn_ == NULL) || (!utility_fn_->Initialize(ci)))
+    {
+      LogE(kClassName, __func__, "Flow %" PRIu32 ": Error creating LOG "
+           "utility function.\n", flow_id_);
+      return false;
+    }
+  }
+  else if (type == "INELASTIC")
+  {
+    const_rate_ = ci.GetDouble("m", 0.0, false);
+
+    if (const_rate_ <= 0.0)
+    {
+      LogE(kClassName, __func__, "Flow %" PRIu32 ": Inelastic flow requires "
+           "m > 0.\n", flow_id_);
+      return false;
+    }
+  }
+  else
+  {
+    LogE(kClassName, __func__, "Flow %" PRIu32 ": Unsupported utility "
+         "type \"%s\".\n", flow_id_, type.c_str());
+    return false;
+  }
+
+  LogC(kClassName, __func__, "Flow %" PRIu32 ": %s -> %s, %zu bytes, %s, "
+       "ttg %s.\n", flow_id_, src_addr_.ToString().c_str(),
+       dst_addr_.ToString().c_str(), payload_len_, utility_def.c_str(),
+       ttg_.ToString().c_str());
+
+  CallbackNoArg<SimFlow>  cb(this, &SimFlow::StartCallback);
+
+  if (!timer_.StartTimer((start_time_ - now), &cb, send_timer_handle_))
+  {
+    LogE(kClassName, __func__, "Flow %" PRIu32 ": Error starting timer.\n",
+         flow_id_);
+    return false;
+  }
+
+  return true;
+}
+
+//============================================================================
+void SimFlow::RecordDelivery(Packet* pkt, const Time& now)
+{
+  SimFlowPayload  payload;
+  size_t          offset = pkt->GetIpPayloadOffset();
+
+  memcpy(&payload, pkt->GetBuffer(offset), sizeof(payload));
+
+  double  latency = ((now.GetTimeInUsec() - payload.send_time_usec) /
+                     1.0e6);
+
+  ++pkts_rcvd_;
+  bytes_rcvd_  += payload_len_;
+  latency_sum_ += latency;
+
+  if (latency > latency_max_)
+  {
+    latency_max_ = latency;
+  }
+
+  if ((!ttg_.IsZero()) && (latency > ttg_.ToDouble()))
+  {
+    ++pkts_late_;
+  }
+}
+
+//============================================================================
+void SimFlow::PrintSummary(const Time& duration) const
+{
+  double  secs = duration.ToDouble();
+
+  fprintf(stdout, "Flow %" PRIu32 " %s -> %s\n", flow_id_,
+          src_addr_.ToString().c_str(), dst_addr_.ToString().c_str());
+  fprintf(stdout, "  Sent         : %" PRIu64 " pkts, %.3f Mbps\n",
+          pkts_sent_, ((secs > 0.0) ? ((bytes_sent_ * 8.0) / secs / 1.0e6) :
+                       0.0));
+  fprintf(stdout, "  Delivered    : %" PRIu64 " pkts, %.3f Mbps\n",
+          pkts_rcvd_, ((secs > 0.0) ? ((bytes_rcvd_ * 8.0) / secs / 1.0e6) :
+                       0.0));
+  fprintf(stdout, "  Latency      : mean %.3f ms, max %.3f ms\n",
+          ((pkts_rcvd_ > 0) ? (latency_sum_ * 1000.0 / pkts_rcvd_) : 0.0),
+          (latency_max_ * 1000.0));
+
+  if (!ttg_.IsZero())
+  {
+    fprintf(stdout, "  Late         : %" PRIu64 " pkts\n", pkts_late_);
+  }
+
+  if (pkts_pool_drops_ > 0)
+  {
+    fprintf(stdout, "  Pool drops   : %" PRIu64 " pkts\n", pkts_pool_drops_);
+  }
+}
+
+//============================================================================
+bool SimFlow::GetFlowId(Packet* pkt, uint32_t& flow_id)
+{
+  uint8_t  protocol = 0;
+
+  if ((!pkt->GetIpProtocol(protocol)) || (protocol != IPPROTO_UDP))
+  {
+    return false;
+  }
+
+  SimFlowPayload  payload;
+  size_t          offset = pkt->GetIpPayloadOffset();
+
+  if (pkt->GetLengthInBytes() < (offset + sizeof(payload)))
+  {
+    return false;
+  }
+
+  memcpy(&payload, pkt->GetBuffer(offset), sizeof(payload));
+
+  if (payload.magic != kPayloadMagic)
+  {
+    return false;
+  }
+
+  flow_id = payload.flow_id;
+
+  return true;
+}
+
+//============================================================================
+void SimFlow::StartCallback()
+{
+  SendCallback();
+}
+
+//============================================================================
+void SimFlow::SendCallback()
+{
+  Time  now = Time::Now();
+
+  if (now >= stop_time_)
+  {
+    return;
+  }
+
+  double  rate = ((utility_fn_ != NULL) ? utility_fn_->GetSendRate() :
+                  const_rate_);
+  Time    next_send(kRatePollInterval);
+
+  if (rate > 0.0)
+  {
+    Packet*  pkt = CreatePacket();
+
+    if (pkt == NULL)
+    {
+      ++pkts_pool_drops_;
+    }
+    else
+    {
+      ++pkts_sent_;
+      bytes_sent_ += payload_len_;
+
+      src_node_.InjectFromProxy(pkt);
+    }
+
+    next_send = Time((payload_len_ * 8.0) / rate);
+  }
+
+  CallbackNoArg<SimFlow>  cb(this, &SimFlow::SendCallback);
+
+  if (!timer_.StartTimer(next_send, &cb, send_timer_handle_))
+  {
+    LogE(kClassName, __func__, "Flow %" PRIu32 ": Error starting timer.\n",
+         flow_id_);
+  }
+}
+
+//============================================================================
+Packet* SimFlow::CreatePacket()
+{
+  // PacketPool::Get() is fatal when the pool is empty, so check first.
+  if (packet_pool_.GetSize() == 0)
+  {
+    return NULL;
+  }
+
+  // The receive time is where the BPF starts counting down the time-to-go.
+  Packet*  pkt = packet_pool_.Get(iron::PACKET_NOW_TIMESTAMP);
+
+  struct iphdr   iphdr;
+  struct udphdr  udphdr;
+
+  memset(&iphdr, 0, sizeof(iphdr));
+  memset(&udphdr, 0, sizeof(udphdr));
+
+  iphdr.version  = 4;
+  iphdr.ihl      = 5;
+  iphdr.ttl      = 64;
+  iphdr.protocol = IPPROTO_UDP;
+  iphdr.saddr    = src_addr_.address();
+  iphdr.daddr    = dst_addr_.address();
+  iphdr.tot_len  = htons(sizeof(iphdr));
+
+  udphdr.source  = htons(kBasePort + static_cast<uint16_t>(flow_id_));
+  udphdr.dest    = htons(kBasePort + static_cast<uint16_t>(flow_id_));
+
+  memcpy(pkt->GetBuffer(), &iphdr, sizeof(iphdr));
+  pkt->SetLengthInBytes(sizeof(iphdr));
+
+  if (!pkt->AppendBlockToEnd(reinterpret_cast<uint8_t*>(&udphdr),
+                             sizeof(udphdr)))
+  {
+    packet_pool_.Recycle(pkt);
+    return NULL;
+  }
+
+  size_t          length = pkt->GetLengthInBytes();
+  SimFlowPayload  payload;
+
+  payload.magic          = kPayloadMagic;
+  payload.flow_id        = flow_id_;
+  payload.seq_num        = next_seq_num_++;
+  payload.send_time_usec = Time::Now().GetTimeInUsec();
+
+  memset(pkt->GetBuffer(length), 0, payload_len_);
+  memcpy(pkt->GetBuffer(length), &payload, sizeof(payload));
+  pkt->SetLengthInBytes(length + payload_len_);
+
+  if (!ttg_.IsZero())
+  {
+    pkt->SetIpDscp(iron::DSCP_EF);
+    pkt->SetTimeToGo(ttg_);
+    pkt->set_track_ttg(true);
+  }
+  else
+  {
+    pkt->SetIpDscp(iron::DSCP_DEFAULT);
+  }
+
+  if ((!pkt->UpdateIpLen()) || (!pkt->UpdateChecksums()))
+  {
+    LogE(kClassName, __func__, "Flow %" PRIu32 ": Error updating packet "
+         "headers.\n", flow_id_);
+    packet_pool_.Recycle(pkt);
+    return NULL;
+  }
+
+  return pkt;
+}
@@ -0,0 +1,215 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+/// \brief A simulated application flow entering the IRON network.
+///
+/// Each flow plays the role of the UDP Proxy admission controller for a
+/// single flow: it generates fixed-size UDP packets at its source node, at
+/// the rate returned by the real LOG utility function given the source
+/// node's published queue depths, or at a constant rate for inelastic
+/// flows.  Delivered packets are reported back to the flow so that
+/// goodput and latency can be summarized at the end of the run.
+
+#ifndef IRON_UTIL_BPFSIM_SIM_FLOW_H
+#define IRON_UTIL_BPFSIM_SIM_FLOW_H
+
+#include "iron_types.h"
+#include "ipv4_address.h"
+#include "itime.h"
+#include "k_val.h"
+#include "timer.h"
+
+#include <string>
+
+#include <stdint.h>
+
+
+namespace iron
+{
+  class ConfigInfo;
+  class Packet;
+  class PacketPool;
+  class QueueDepths;
+  class UtilityFn;
+}
+
+class SimBPFwder;
+
+class SimFlow
+{
+ public:
+
+  /// \brief Constructor.
+  ///
+  /// \param  flow_id       The flow identifier, carried in each packet.
+  /// \param  src_node      The node at which packets enter the network.
+  /// \param  src_qd        The queue depths published by the source node,
+  ///                       as seen by its proxies.
+  /// \param  packet_pool   The packet pool.
+  /// \param  timer         The simulator's shared timer.
+  SimFlow(uint32_t flow_id, SimBPFwder& src_node, iron::QueueDepths& src_qd,
+          iron::PacketPool& packet_pool, iron::Timer& timer);
+
+  /// \brief Destructor.
+  virtual ~SimFlow();
+
+  /// \brief Initialize the flow from the "Sim.Flow.<id>" configuration.
+  ///
+  /// \param  config_info  The simulation configuration.
+  /// \param  src_addr     The source address of the flow's packets.
+  /// \param  dst_addr     The destination address of the flow's packets.
+  /// \param  dst_bin_idx  The bin index of the destination node.
+  ///
+  /// \return  True on success, false otherwise.
+  bool Initialize(const iron::ConfigInfo& config_info,
+                  const iron::Ipv4Address& src_addr,
+                  const iron::Ipv4Address& dst_addr,
+                  iron::BinIndex dst_bin_idx);
+
+  /// \brief Record the delivery of one of this flow's packets.
+  ///
+  /// \param  pkt  The delivered packet.  The caller retains ownership.
+  /// \param  now  The current simulated time.
+  void RecordDelivery(iron::Packet* pkt, const iron::Time& now);
+
+  /// \brief Print the flow's summary statistics to stdout.
+  ///
+  /// \param  duration  The simulated duration of the run.
+  void PrintSummary(const iron::Time& duration) const;
+
+  /// \brief Extract the flow identifier from a delivered packet.
+  ///
+  /// \param  pkt      The packet.
+  /// \param  flow_id  A reference where the flow identifier is placed.
+  ///
+  /// \return  True if the packet was generated by a SimFlow.
+  static bool GetFlowId(iron::Packet* pkt, uint32_t& flow_id);
+
+ private:
+
+  /// Copy constructor.
+  SimFlow(const SimFlow& other);
+
+  /// Copy operator.
+  SimFlow& operator=(const SimFlow& other);
+
+  /// \brief The timer callback for starting the flow.
+  void StartCallback();
+
+  /// \brief The timer callback for sending the next packet.
+  void SendCallback();
+
+  /// \brief Build the next packet of the flow.
+  ///
+  /// \return  The packet, or NULL if the packet pool is exhausted.
+  iron::Packet* CreatePacket();
+
+  /// The flow identifier.
+  uint32_t            flow_id_;
+
+  /// The node at which packets enter the network.
+  SimBPFwder&         src_node_;
+
+  /// The queue depths published by the source node.
+  iron::QueueDepths&  src_qd_;
+
+  /// The packet pool.
+  iron::PacketPool&   packet_pool_;
+
+  /// The simulator's shared timer.
+  iron::Timer&        timer_;
+
+  /// The source address of the flow's packets.
+  iron::Ipv4Address   src_addr_;
+
+  /// The destination address of the flow's packets.
+  iron::Ipv4Address   dst_addr_;
+
+  /// The size of each packet's UDP payload, in bytes.
+  size_t              payload_len_;
+
+  /// The time-to-go of each packet, or zero if the flow is not EF.
+  iron::Time          ttg_;
+
+  /// The time at which the flow starts sending.
+  iron::Time          start_time_;
+
+  /// The time at which the flow stops sending.
+  iron::Time          stop_time_;
+
+  /// The constant send rate, in bps, of an inelastic flow.
+  double              const_rate_;
+
+  /// The k value used by the utility function.
+  iron::KVal          k_val_;
+
+  /// The utility function of an elastic flow, or NULL.
+  iron::UtilityFn*    utility_fn_;
+
+  /// The handle of the send timer.
+  iron::Timer::Handle send_timer_handle_;
+
+  /// The sequence number of the next packet.
+  uint32_t            next_seq_num_;
+
+  /// The number of packets sent.
+  uint64_t            pkts_sent_;
+
+  /// The number of bytes sent.
+  uint64_t            bytes_sent_;
+
+  /// The number of packets not sent because the pool was exhausted.
+  uint64_t            pkts_pool_drops_;
+
+  /// The number of packets delivered.
+  uint64_t            pkts_rcvd_;
+
+  /// The number of bytes delivered.
+  uint64_t            bytes_rcvd_;
+
+  /// The number of packets delivered after their time-to-go.
+  uint64_t            pkts_late_;
+
+  /// The sum of the packet delivery latencies, in seconds.
+  double              latency_sum_;
+
+  /// The maximum packet delivery latency, in seconds.
+  double              latency_max_;
+
+}; // end class SimFlow
+
+#endif // IRON_UTIL_BPFSIM_SIM_FLOW_H
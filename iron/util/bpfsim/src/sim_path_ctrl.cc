@@ -0,0 +1,568 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "sim_path_ctrl.h"
+
+#include "backpressure_fwder.h"
+#include "callback.h"
+#include "config_info.h"
+#include "list.h"
+#include "log.h"
+#include "packet.h"
+#include "packet_pool.h"
+#include "string_utils.h"
+#include "unused.h"
+
+#include <cmath>
+
+#include <inttypes.h>
+
+
+using ::iron::BPFwder;
+using ::iron::CallbackNoArg;
+using ::iron::ConfigInfo;
+using ::iron::FdEvent;
+using ::iron::FdEventInfo;
+using ::iron::List;
+using ::iron::Packet;
+using ::iron::PacketPool;
+using ::iron::StringUtils;
+using ::iron::Time;
+using ::iron::Timer;
+using ::std::string;
+
+
+namespace
+{
+  /// Class name for logging.
+  const char*   UNUSED(kClassName) = "SimPathCtrl";
+
+  /// The default line rate, in Kbps.
+  const double  kDefaultLineRateKbps = 10000.0;
+
+  /// The default propagation delay, in milliseconds.
+  const double  kDefaultDelayMs      = 10.0;
+
+  /// The maximum size of the control packet transmit queue, in packets.
+  const size_t  kControlQueueSize    = 100;
+
+  /// The maximum size of each data packet transmit queue, in packets.  The
+  /// BPF limits the bytes it hands over, so this is only a safety limit.
+  const size_t  kDataQueueSize       = 10000;
+
+  /// The EWMA gain used for the PDD variance.
+  const double  kPddVarGain          = 0.125;
+}
+
+
+//============================================================================
+SimPathCtrl::SimPathCtrl(BPFwder* bpf, PacketPool& packet_pool, Timer& timer)
+    : PathController(bpf),
+      packet_pool_(packet_pool),
+      timer_(timer),
+      peer_(NULL),
+      max_line_rate_(kDefaultLineRateKbps),
+      prop_delay_(),
+      ef_data_pkt_queue_(packet_pool),
+      control_pkt_queue_(packet_pool),
+      data_pkt_queue_(packet_pool),
+      qlam_pkt_(NULL),
+      xmit_pkt_(NULL),
+      xmit_timer_handle_(),
+      in_flight_(),
+      arrival_timer_handle_(),
+      total_bytes_queued_(0),
+      total_bytes_sent_(0),
+      pdd_thresh_(0.0),
+      pdd_min_period_(),
+      pdd_max_period_(),
+      pdd_last_mean_(0.0),
+      pdd_var_(0.0),
+      pdd_last_time_()
+{
+}
+
+//============================================================================
+SimPathCtrl::~SimPathCtrl()
+{
+  timer_.CancelTimer(xmit_timer_handle_);
+  timer_.CancelTimer(arrival_timer_handle_);
+
+  if (qlam_pkt_ != NULL)
+  {
+    packet_pool_.Recycle(qlam_pkt_);
+    qlam_pkt_ = NULL;
+  }
+
+  if (xmit_pkt_ != NULL)
+  {
+    packet_pool_.Recycle(xmit_pkt_);
+    xmit_pkt_ = NULL;
+  }
+
+  while (!in_flight_.empty())
+  {
+    packet_pool_.Recycle(in_flight_.front().pkt);
+    in_flight_.pop_front();
+  }
+
+  CallbackNoArg<SimPathCtrl>::EmptyPool();
+}
+
+//============================================================================
+bool SimPathCtrl::Initialize(const ConfigInfo& config_info, uint32_t config_id)
+{
+  path_controller_number_ = config_id;
+
+  string  config_prefix("PathController.");
+  config_prefix.append(StringUtils::ToString(static_cast<int>(config_id)));
+
+  label_         = config_info.Get(config_prefix + ".Label");
+  endpoints_str_ = config_info.Get(config_prefix + ".Endpoints");
+
+  if (!ParseEndpointsString(endpoints_str_))
+  {
+    LogE(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Error, invalid "
+         "endpoints: %s\n", path_controller_number_, endpoints_str_.c_str());
+    return false;
+  }
+
+  max_line_rate_ = config_info.GetDouble(config_prefix + ".MaxLineRateKbps",
+                                         kDefaultLineRateKbps);
+
+  if (max_line_rate_ < 0.0)
+  {
+    LogE(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Invalid line rate "
+         "%f Kbps.\n", path_controller_number_, max_line_rate_);
+    return false;
+  }
+
+  double  delay_ms = config_info.GetDouble(config_prefix + ".DelayMs",
+                                           kDefaultDelayMs);
+
+  if (delay_ms < 0.0)
+  {
+    LogE(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Invalid delay %f "
+         "ms.\n", path_controller_number_, delay_ms);
+    return false;
+  }
+
+  prop_delay_ = Time(delay_ms / 1000.0);
+
+  ef_data_pkt_queue_.SetQueueLimits(kDataQueueSize);
+  ef_data_pkt_queue_.set_drop_policy(iron::NO_DROP);
+  data_pkt_queue_.SetQueueLimits(kDataQueueSize);
+  data_pkt_queue_.set_drop_policy(iron::NO_DROP);
+  control_pkt_queue_.SetQueueLimits(kControlQueueSize);
+  control_pkt_queue_.set_drop_policy(iron::NO_DROP);
+
+  LogC(kClassName, __func__, "SimPathCtrl %" PRIu32 " configuration:\n",
+       path_controller_number_);
+  LogC(kClassName, __func__, "Endpoints      : %s->%s\n",
+       local_endpt_.ToString().c_str(), remote_endpt_.ToString().c_str());
+  LogC(kClassName, __func__, "Max Line Rate  : %f Kbps\n", max_line_rate_);
+  LogC(kClassName, __func__, "Delay          : %f ms\n", delay_ms);
+
+  bpf_->ProcessCapacityUpdate(this, (max_line_rate_ * 1000.0),
+                              (max_line_rate_ * 1000.0));
+
+  return true;
+}
+
+//============================================================================
+bool SimPathCtrl::ConfigurePddReporting(double thresh, double min_period,
+                                        double max_period)
+{
+  if ((thresh < 0.00001) || (min_period < 0.000001) ||
+      (max_period < 0.000001) || (min_period >= max_period))
+  {
+    LogE(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Error configuring "
+         "PDD with thresh=%f min_period=%f max_period=%f.\n",
+         path_controller_number_, thresh, min_period, max_period);
+    return false;
+  }
+
+  pdd_thresh_     = thresh;
+  pdd_min_period_ = Time(min_period);
+  pdd_max_period_ = Time(max_period);
+
+  return true;
+}
+
+//============================================================================
+bool SimPathCtrl::SendPacket(Packet* pkt)
+{
+  if (pkt == NULL)
+  {
+    return false;
+  }
+
+  // Metadata headers are not serialized, since the Packet object itself is
+  // handed to the peer, but they are counted so the line rate sees the same
+  // number of bytes as a real link.
+  if (NeedsMetadataHeaders(pkt))
+  {
+    if (!AddMetadataHeaders(pkt))
+    {
+      LogE(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Error adding "
+           "metadata headers.\n", path_controller_number_);
+    }
+  }
+  else
+  {
+    pkt->SetMetadataHeaderLengthInBytes(0);
+  }
+
+  size_t  pkt_len  = (pkt->GetMetadataHeaderLengthInBytes() +
+                      pkt->GetLengthInBytes());
+  size_t  drop_len = 0;
+
+  switch (pkt->GetRawType())
+  {
+    case iron::IPV4_PACKET:
+      if (pkt->GetLatencyClass() == iron::LOW_LATENCY)
+      {
+        if (!ef_data_pkt_queue_.Enqueue(pkt))
+        {
+          return false;
+        }
+      }
+      else if (!data_pkt_queue_.Enqueue(pkt))
+      {
+        return false;
+      }
+      break;
+
+    case iron::ZOMBIE_PACKET:
+      if (!data_pkt_queue_.Enqueue(pkt))
+      {
+        return false;
+      }
+      break;
+
+    case iron::QLAM_PACKET:
+      if (qlam_pkt_ != NULL)
+      {
+        drop_len = (qlam_pkt_->GetMetadataHeaderLengthInBytes() +
+                    qlam_pkt_->GetLengthInBytes());
+        packet_pool_.Recycle(qlam_pkt_);
+      }
+      qlam_pkt_ = pkt;
+      break;
+
+    case iron::LSA_PACKET:
+      if (!control_pkt_queue_.Enqueue(pkt))
+      {
+        return false;
+      }
+      break;
+
+    default:
+      LogE(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Unknown packet "
+           "type %d.\n", path_controller_number_, pkt->GetRawType());
+      return false;
+  }
+
+  total_bytes_queued_ -= drop_len;
+  total_bytes_queued_ += pkt_len;
+
+  Time  now = Time::Now();
+
+  ReportPdd(now);
+  StartNextXmit();
+
+  return true;
+}
+
+//============================================================================
+void SimPathCtrl::ServiceFileDescriptor(int fd, FdEvent event)
+{
+}
+
+//============================================================================
+size_t SimPathCtrl::GetFileDescriptors(FdEventInfo* fd_event_array,
+                                       size_t array_size) const
+{
+  return 0;
+}
+
+//============================================================================
+bool SimPathCtrl::GetXmitQueueSize(size_t& size) const
+{
+  size = total_bytes_queued_;
+
+  return true;
+}
+
+//============================================================================
+bool SimPathCtrl::SetParameter(const char* name, const char* value)
+{
+  string  name_str(name);
+  double  val = StringUtils::GetDouble(value, -1.0);
+
+  if (val < 0.0)
+  {
+    LogE(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Invalid value %s "
+         "for %s.\n", path_controller_number_, value, name);
+    return false;
+  }
+
+  if (name_str == "MaxLineRateKbps")
+  {
+    max_line_rate_ = val;
+    bpf_->ProcessCapacityUpdate(this, (max_line_rate_ * 1000.0),
+                                (max_line_rate_ * 1000.0));
+    StartNextXmit();
+    return true;
+  }
+
+  if (name_str == "DelayMs")
+  {
+    prop_delay_ = Time(val / 1000.0);
+    return true;
+  }
+
+  LogE(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Unknown parameter "
+       "\"%s\".\n", path_controller_number_, name);
+
+  return false;
+}
+
+//============================================================================
+bool SimPathCtrl::GetParameter(const char* name, string& value) const
+{
+  string  name_str(name);
+
+  if (name_str == "MaxLineRateKbps")
+  {
+    value = StringUtils::ToString(max_line_rate_);
+    return true;
+  }
+
+  if (name_str == "DelayMs")
+  {
+    value = StringUtils::ToString(prop_delay_.ToDouble() * 1000.0);
+    return true;
+  }
+
+  return false;
+}
+
+//============================================================================
+void SimPathCtrl::StartNextXmit()
+{
+  if ((xmit_pkt_ != NULL) || (max_line_rate_ <= 0.0) ||
+      (!IsPacketReadyToXmit()))
+  {
+    return;
+  }
+
+  // Same service order as the SOND: QLAM, EF data, control, then data.
+  if (qlam_pkt_ != NULL)
+  {
+    xmit_pkt_ = qlam_pkt_;
+    qlam_pkt_ = NULL;
+  }
+  else if (ef_data_pkt_queue_.GetCount() > 0)
+  {
+    xmit_pkt_ = ef_data_pkt_queue_.Dequeue();
+  }
+  else if (control_pkt_queue_.GetCount() > 0)
+  {
+    xmit_pkt_ = control_pkt_queue_.Dequeue();
+  }
+  else
+  {
+    xmit_pkt_ = data_pkt_queue_.Dequeue();
+  }
+
+  if (xmit_pkt_ == NULL)
+  {
+    LogE(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Dequeued NULL "
+         "packet.\n", path_controller_number_);
+    return;
+  }
+
+  size_t  pkt_len = (xmit_pkt_->GetMetadataHeaderLengthInBytes() +
+                     xmit_pkt_->GetLengthInBytes());
+
+  total_bytes_queued_ -= pkt_len;
+
+  Time                        xmit_time(
+    (static_cast<double>(pkt_len) * 8.0) / (max_line_rate_ * 1000.0));
+  CallbackNoArg<SimPathCtrl>  cb(this, &SimPathCtrl::XmitDoneCallback);
+
+  if (!timer_.StartTimer(xmit_time, &cb, xmit_timer_handle_))
+  {
+    LogF(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Error starting "
+         "transmit timer.\n", path_controller_number_);
+  }
+}
+
+//============================================================================
+void SimPathCtrl::XmitDoneCallback()
+{
+  Packet*  pkt = xmit_pkt_;
+  xmit_pkt_    = NULL;
+
+  if (pkt != NULL)
+  {
+    total_bytes_sent_ += (pkt->GetMetadataHeaderLengthInBytes() +
+                          pkt->GetLengthInBytes());
+
+    if (peer_ == NULL)
+    {
+      packet_pool_.Recycle(pkt);
+    }
+    else
+    {
+      // The propagation delay is constant between changes, so arrivals stay
+      // in order and a single timer for the oldest one is enough.
+      in_flight_.push_back(InFlightPkt(pkt, Time::Now() + prop_delay_));
+
+      if (!timer_.IsTimerSet(arrival_timer_handle_))
+      {
+        CallbackNoArg<SimPathCtrl>  cb(this, &SimPathCtrl::ArrivalCallback);
+
+        if (!timer_.StartTimer(prop_delay_, &cb, arrival_timer_handle_))
+        {
+          LogF(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Error "
+               "starting arrival timer.\n", path_controller_number_);
+        }
+      }
+    }
+  }
+
+  StartNextXmit();
+}
+
+//============================================================================
+void SimPathCtrl::ArrivalCallback()
+{
+  Time  now = Time::Now();
+
+  while ((!in_flight_.empty()) && (in_flight_.front().arrival_time <= now))
+  {
+    Packet*  pkt = in_flight_.front().pkt;
+    in_flight_.pop_front();
+
+    peer_->Receive(pkt);
+  }
+
+  if (!in_flight_.empty())
+  {
+    Time                        delta = (in_flight_.front().arrival_time -
+                                         now);
+    CallbackNoArg<SimPathCtrl>  cb(this, &SimPathCtrl::ArrivalCallback);
+
+    if (!timer_.StartTimer(delta, &cb, arrival_timer_handle_))
+    {
+      LogF(kClassName, __func__, "SimPathCtrl %" PRIu32 ": Error starting "
+           "arrival timer.\n", path_controller_number_);
+    }
+  }
+}
+
+//============================================================================
+void SimPathCtrl::Receive(Packet* pkt)
+{
+  // The time-to-go is reduced by the actual time spent since the packet was
+  // received by the previous node, which is exact in simulation.
+  if (pkt->track_ttg())
+  {
+    pkt->UpdateTimeToGo();
+  }
+
+  pkt->SetMetadataHeaderLengthInBytes(0);
+  pkt->set_recv_time(Time::Now());
+
+  bpf_->ProcessRcvdPacket(pkt, this);
+}
+
+//============================================================================
+void SimPathCtrl::ReportPdd(const Time& now)
+{
+  if ((pdd_max_period_.IsZero()) || (max_line_rate_ <= 0.0))
+  {
+    return;
+  }
+
+  // The delivery delay for a packet enqueued now: waiting behind the queued
+  // bytes, then propagating.
+  double  mean  = (prop_delay_.ToDouble() +
+                   ((static_cast<double>(total_bytes_queued_) * 8.0) /
+                    (max_line_rate_ * 1000.0)));
+  double  delta = (mean - pdd_last_mean_);
+
+  // The first estimate has nothing to vary from.
+  if (!pdd_last_time_.IsZero())
+  {
+    pdd_var_ += (kPddVarGain * ((delta * delta) - pdd_var_));
+  }
+
+  Time  elapsed = (now - pdd_last_time_);
+
+  if ((elapsed >= pdd_max_period_) ||
+      ((elapsed >= pdd_min_period_) &&
+       (fabs(delta) > (pdd_thresh_ * pdd_last_mean_))))
+  {
+    pdd_last_mean_ = mean;
+    pdd_last_time_ = now;
+
+    bpf_->ProcessPktDelDelay(this, mean, pdd_var_);
+  }
+}
+
+//============================================================================
+bool SimPathCtrl::ParseEndpointsString(const string& ep_str)
+{
+  List<string>  tokens;
+  StringUtils::Tokenize(ep_str, "->", tokens);
+
+  if (tokens.size() != 2)
+  {
+    return false;
+  }
+
+  string  lep_str;
+  string  rep_str;
+  tokens.Pop(lep_str);
+  tokens.Peek(rep_str);
+
+  return (local_endpt_.SetEndpoint(lep_str) &&
+          remote_endpt_.SetEndpoint(rep_str));
+}
@@ -0,0 +1,313 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+/// \brief An in-memory Path Controller for the BPF simulator.
+
+#ifndef IRON_UTIL_BPFSIM_SIM_PATH_CTRL_H
+#define IRON_UTIL_BPFSIM_SIM_PATH_CTRL_H
+
+#include "path_controller.h"
+
+#include "itime.h"
+#include "packet_queue.h"
+#include "timer.h"
+
+#include <deque>
+#include <string>
+
+#include <stdint.h>
+
+
+namespace iron
+{
+  class BPFwder;
+  class ConfigInfo;
+  class Packet;
+  class PacketPool;
+}
+
+/// \brief A Path Controller that models one direction of a point-to-point
+/// link in simulated time.
+///
+/// Packets handed to SendPacket() are queued exactly as in the SOND (one
+/// QLAM slot, then EF data, control, and normal data queues), serialized at
+/// the configured line rate, and handed to the peer SimPathCtrl after the
+/// configured propagation delay.  Packets are passed between the nodes by
+/// pointer, since all simulated nodes share a single packet pool.  All
+/// timing is done with the simulator's Timer, so the link runs on the
+/// simulated clock.
+///
+/// The following configuration items are read, where X is the path
+/// controller number:
+///
+/// - PathController.X.Endpoints       : "LOCAL_IP:PORT->REMOTE_IP:PORT".
+///                                      Only used for uniqueness checks.
+/// - PathController.X.Label           : Optional label.
+/// - PathController.X.MaxLineRateKbps : The line rate in Kbps.  0 means
+///                                      that the link is down.
+/// - PathController.X.DelayMs         : The propagation delay in ms.
+class SimPathCtrl : public iron::PathController
+{
+ public:
+
+  /// \brief Constructor.
+  ///
+  /// \param  bpf          The owning backpressure forwarder.
+  /// \param  packet_pool  The (shared) packet pool.
+  /// \param  timer        The (shared) simulation timer.
+  SimPathCtrl(iron::BPFwder* bpf, iron::PacketPool& packet_pool,
+              iron::Timer& timer);
+
+  /// \brief Destructor.
+  virtual ~SimPathCtrl();
+
+  /// \brief Initialize the Path Controller.
+  ///
+  /// \param  config_info  The configuration information.
+  /// \param  config_id    The path controller number.
+  ///
+  /// \return  True on success, or false otherwise.
+  virtual bool Initialize(const iron::ConfigInfo& config_info,
+                          uint32_t config_id);
+
+  /// \brief Configure the packet delivery delay (PDD) reporting.
+  ///
+  /// \param  thresh      The relative change that triggers a report.
+  /// \param  min_period  The minimum time between reports, in seconds.
+  /// \param  max_period  The maximum time between reports, in seconds.
+  ///
+  /// \return  True on success, or false otherwise.
+  virtual bool ConfigurePddReporting(double thresh, double min_period,
+                                     double max_period);
+
+  /// \brief Queue a packet for transmission on the link.
+  ///
+  /// \param  pkt  The packet.  Ownership is taken on success.
+  ///
+  /// \return  True on success, or false otherwise.
+  virtual bool SendPacket(iron::Packet* pkt);
+
+  /// \brief Does nothing, as there are no file descriptors.
+  ///
+  /// \param  fd     Ignored.
+  /// \param  event  Ignored.
+  virtual void ServiceFileDescriptor(int fd, iron::FdEvent event);
+
+  /// \brief Get the file descriptors.  There are none.
+  ///
+  /// \param  fd_event_array  Unchanged.
+  /// \param  array_size      Ignored.
+  ///
+  /// \return  Zero.
+  virtual size_t GetFileDescriptors(iron::FdEventInfo* fd_event_array,
+                                    size_t array_size) const;
+
+  /// \brief Get the number of bytes waiting to be transmitted.
+  ///
+  /// \param  size  Where the size, in bytes, is placed.
+  ///
+  /// \return  True.
+  virtual bool GetXmitQueueSize(size_t& size) const;
+
+  /// \brief Set a parameter.  "MaxLineRateKbps" and "DelayMs" are
+  /// supported, which allows the simulator to change links over time.
+  ///
+  /// \param  name   The parameter name.
+  /// \param  value  The parameter value.
+  ///
+  /// \return  True on success, or false otherwise.
+  virtual bool SetParameter(const char* name, const char* value);
+
+  /// \brief Get a parameter.  "MaxLineRateKbps" and "DelayMs" are
+  /// supported.
+  ///
+  /// \param  name   The parameter name.
+  /// \param  value  Where the parameter value is placed.
+  ///
+  /// \return  True on success, or false otherwise.
+  virtual bool GetParameter(const char* name, std::string& value) const;
+
+  /// \brief Get the per-QLAM overhead in bytes.  Matches the SOND.
+  ///
+  /// \return  The per-QLAM overhead in bytes.
+  virtual uint32_t GetPerQlamOverhead() const
+  {
+    return 54;
+  }
+
+  /// \brief Set the peer Path Controller at the far end of the link.
+  ///
+  /// \param  peer  The peer.
+  inline void set_peer(SimPathCtrl* peer)
+  {
+    peer_ = peer;
+  }
+
+  /// \brief Get the total number of bytes transmitted.
+  ///
+  /// \return  The total number of bytes transmitted.
+  inline uint64_t total_bytes_sent() const
+  {
+    return total_bytes_sent_;
+  }
+
+ private:
+
+  /// \brief Copy constructor.
+  SimPathCtrl(const SimPathCtrl& other);
+
+  /// \brief Copy operator.
+  SimPathCtrl& operator=(const SimPathCtrl& other);
+
+  /// \brief A packet propagating across the link.
+  struct InFlightPkt
+  {
+    InFlightPkt(iron::Packet* p, const iron::Time& t)
+        : pkt(p), arrival_time(t)
+    { }
+
+    /// The packet.
+    iron::Packet*  pkt;
+
+    /// When the packet reaches the peer.
+    iron::Time     arrival_time;
+  };
+
+  /// \brief Check if there is a packet ready to transmit.
+  ///
+  /// \return  True if there is at least one packet queued.
+  inline bool IsPacketReadyToXmit() const
+  {
+    return((qlam_pkt_ != NULL) ||
+           (ef_data_pkt_queue_.GetCount() > 0) ||
+           (control_pkt_queue_.GetCount() > 0) ||
+           (data_pkt_queue_.GetCount() > 0));
+  }
+
+  /// \brief Start serializing the next queued packet, if idle.
+  void StartNextXmit();
+
+  /// \brief The transmission complete timer callback.
+  void XmitDoneCallback();
+
+  /// \brief The arrival timer callback.  Hands all packets that have
+  /// finished propagating to the peer.
+  void ArrivalCallback();
+
+  /// \brief Accept a packet arriving from the peer and hand it to the BPF.
+  ///
+  /// \param  pkt  The arriving packet.
+  void Receive(iron::Packet* pkt);
+
+  /// \brief Report the packet delivery delay to the BPF if warranted.
+  ///
+  /// \param  now  The current time.
+  void ReportPdd(const iron::Time& now);
+
+  /// \brief Parse the endpoints string.
+  ///
+  /// \param  ep_str  The endpoints string.
+  ///
+  /// \return  True on success, or false otherwise.
+  bool ParseEndpointsString(const std::string& ep_str);
+
+  /// The (shared) packet pool.
+  iron::PacketPool&         packet_pool_;
+
+  /// The (shared) simulation timer.
+  iron::Timer&              timer_;
+
+  /// The path controller at the far end of the link.
+  SimPathCtrl*              peer_;
+
+  /// The line rate in Kbps.
+  double                    max_line_rate_;
+
+  /// The propagation delay.
+  iron::Time                prop_delay_;
+
+  /// The EF data transmit queue.
+  iron::PacketQueue         ef_data_pkt_queue_;
+
+  /// The control transmit queue.
+  iron::PacketQueue         control_pkt_queue_;
+
+  /// The data transmit queue.
+  iron::PacketQueue         data_pkt_queue_;
+
+  /// The latest QLAM, which replaces any older unsent QLAM.
+  iron::Packet*             qlam_pkt_;
+
+  /// The packet being serialized, or NULL if idle.
+  iron::Packet*             xmit_pkt_;
+
+  /// The transmission complete timer.
+  iron::Timer::Handle       xmit_timer_handle_;
+
+  /// The packets propagating to the peer, in arrival order.
+  std::deque<InFlightPkt>   in_flight_;
+
+  /// The arrival timer.
+  iron::Timer::Handle       arrival_timer_handle_;
+
+  /// The number of bytes queued, excluding the packet being serialized.
+  size_t                    total_bytes_queued_;
+
+  /// The total number of bytes transmitted.
+  uint64_t                  total_bytes_sent_;
+
+  /// The PDD reporting threshold.
+  double                    pdd_thresh_;
+
+  /// The PDD minimum reporting period.
+  iron::Time                pdd_min_period_;
+
+  /// The PDD maximum reporting period.
+  iron::Time                pdd_max_period_;
+
+  /// The last reported PDD mean, in seconds.
+  double                    pdd_last_mean_;
+
+  /// The smoothed PDD variance, in seconds squared.
+  double                    pdd_var_;
+
+  /// The time of the last PDD report.
+  iron::Time                pdd_last_time_;
+
+}; // end class SimPathCtrl
+
+#endif // IRON_UTIL_BPFSIM_SIM_PATH_CTRL_H
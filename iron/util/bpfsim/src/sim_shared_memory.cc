@@ -0,0 +1,179 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+#include "sim_shared_memory.h"
+
+#include "log.h"
+#include "unused.h"
+
+#include <cstring>
+#include <new>
+
+#include <inttypes.h>
+
+
+namespace
+{
+  /// Class name for logging.
+  const char*  UNUSED(kClassName) = "SimSharedMemory";
+}
+
+//============================================================================
+SimSharedMemory::SimSharedMemory()
+    : iron::SharedMemoryIF(),
+      shm_size_(0),
+      shm_ptr_(NULL)
+{
+}
+
+//============================================================================
+SimSharedMemory::~SimSharedMemory()
+{
+  Destroy();
+}
+
+//============================================================================
+bool SimSharedMemory::Create(key_t key, const char* name, size_t size_bytes)
+{
+  if (shm_ptr_ != NULL)
+  {
+    LogE(kClassName, __func__, "Memory segment already created.\n");
+    return false;
+  }
+
+  if (size_bytes < 1)
+  {
+    LogE(kClassName, __func__, "Invalid size %zu bytes.\n", size_bytes);
+    return false;
+  }
+
+  shm_ptr_ = new (std::nothrow) uint8_t[size_bytes];
+
+  if (shm_ptr_ == NULL)
+  {
+    LogF(kClassName, __func__, "Unable to allocate %zu bytes.\n",
+         size_bytes);
+    return false;
+  }
+
+  memset(shm_ptr_, 0, size_bytes);
+  shm_size_ = size_bytes;
+
+  return true;
+}
+
+//============================================================================
+bool SimSharedMemory::Attach(key_t key, const char* name, size_t size_bytes)
+{
+  return ((shm_ptr_ != NULL) && (shm_size_ == size_bytes));
+}
+
+//============================================================================
+bool SimSharedMemory::CopyToShm(const uint8_t* src_buf, size_t size_bytes,
+                                size_t shm_offset_bytes)
+#if not defined SHM_STATS
+  const
+#endif // not SHM_STATS
+{
+  if ((shm_ptr_ == NULL) || (src_buf == NULL) ||
+      ((shm_offset_bytes + size_bytes) > shm_size_))
+  {
+    return false;
+  }
+
+  memcpy((shm_ptr_ + shm_offset_bytes), src_buf, size_bytes);
+
+  return true;
+}
+
+//============================================================================
+bool SimSharedMemory::CopyFromShm(uint8_t* dst_buf, size_t size_bytes,
+                                  size_t shm_offset_bytes)
+#if not defined SHM_STATS
+  const
+#endif // not SHM_STATS
+{
+  if ((shm_ptr_ == NULL) || (dst_buf == NULL) ||
+      ((shm_offset_bytes + size_bytes) > shm_size_))
+  {
+    return false;
+  }
+
+  memcpy(dst_buf, (shm_ptr_ + shm_offset_bytes), size_bytes);
+
+  return true;
+}
+
+//============================================================================
+uint8_t* SimSharedMemory::GetShmPtr(size_t shm_offset_bytes)
+{
+  if ((shm_ptr_ == NULL) || (shm_offset_bytes > shm_size_))
+  {
+    return NULL;
+  }
+
+  return (shm_ptr_ + shm_offset_bytes);
+}
+
+//============================================================================
+bool SimSharedMemory::Lock()
+{
+  return (shm_ptr_ != NULL);
+}
+
+//============================================================================
+bool SimSharedMemory::Unlock()
+{
+  return (shm_ptr_ != NULL);
+}
+
+//============================================================================
+void SimSharedMemory::Destroy()
+{
+  if (shm_ptr_ != NULL)
+  {
+    delete [] shm_ptr_;
+    shm_ptr_ = NULL;
+  }
+
+  shm_size_ = 0;
+}
+
+//============================================================================
+void SimSharedMemory::Detach()
+{
+}
@@ -0,0 +1,159 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* IRON: end */
+
+/// \brief An in-memory shared memory segment for the BPF simulator.
+
+#ifndef IRON_UTIL_BPFSIM_SIM_SHARED_MEMORY_H
+#define IRON_UTIL_BPFSIM_SIM_SHARED_MEMORY_H
+
+#include "shared_memory_if.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <sys/types.h>
+
+
+/// \brief A heap-backed implementation of the shared memory interface.
+///
+/// Each simulated node owns one of these for the weight queue depths that
+/// the node's QueueStore publishes.  The simulated proxy admission
+/// controllers at that node attach to the same object, so no locking is
+/// needed beyond the (single-threaded) simulator itself.
+class SimSharedMemory : public iron::SharedMemoryIF
+{
+ public:
+
+  /// \brief Constructor.
+  SimSharedMemory();
+
+  /// \brief Destructor.
+  virtual ~SimSharedMemory();
+
+  /// \brief Create the memory segment.
+  ///
+  /// \param  key         Ignored.
+  /// \param  name        Ignored.
+  /// \param  size_bytes  The size of the segment in bytes.
+  ///
+  /// \return  True on success, or false if already created or on error.
+  virtual bool Create(key_t key, const char* name, size_t size_bytes);
+
+  /// \brief Attach to the memory segment.
+  ///
+  /// \param  key         Ignored.
+  /// \param  name        Ignored.
+  /// \param  size_bytes  The expected size of the segment in bytes.
+  ///
+  /// \return  True if the segment has been created with the same size.
+  virtual bool Attach(key_t key, const char* name, size_t size_bytes);
+
+  /// \brief Copy data into the memory segment.
+  ///
+  /// \param  src_buf           The source data.
+  /// \param  size_bytes        The size of the copy, in bytes.
+  /// \param  shm_offset_bytes  The offset into the segment, in bytes.
+  ///
+  /// \return  True on success, or false on error.
+  virtual bool CopyToShm(const uint8_t* src_buf, size_t size_bytes,
+                         size_t shm_offset_bytes = 0)
+#if not defined SHM_STATS
+    const
+#endif // not SHM_STATS
+    ;
+
+  /// \brief Copy data out of the memory segment.
+  ///
+  /// \param  dst_buf           The destination buffer.
+  /// \param  size_bytes        The size of the copy, in bytes.
+  /// \param  shm_offset_bytes  The offset into the segment, in bytes.
+  ///
+  /// \return  True on success, or false on error.
+  virtual bool CopyFromShm(uint8_t* dst_buf, size_t size_bytes,
+                           size_t shm_offset_bytes = 0)
+#if not defined SHM_STATS
+    const
+#endif // not SHM_STATS
+    ;
+
+  /// \brief Get a pointer into the memory segment.
+  ///
+  /// \param  shm_offset_bytes  The offset into the segment, in bytes.
+  ///
+  /// \return  The pointer on success, or NULL on error.
+  virtual uint8_t* GetShmPtr(size_t shm_offset_bytes = 0);
+
+  /// \brief Lock the memory segment.  A no-op in the simulator.
+  ///
+  /// \return  True if the segment has been created.
+  virtual bool Lock();
+
+  /// \brief Unlock the memory segment.  A no-op in the simulator.
+  ///
+  /// \return  True if the segment has been created.
+  virtual bool Unlock();
+
+  /// \brief Free the memory segment.
+  virtual void Destroy();
+
+  /// \brief Detach from the memory segment.  A no-op in the simulator.
+  virtual void Detach();
+
+  /// \brief Check if the memory segment has been created.
+  ///
+  /// \return  True if the memory segment has been created.
+  virtual bool IsInitialized() const
+  {
+    return (shm_ptr_ != NULL);
+  }
+
+ private:
+
+  /// \brief Copy constructor.
+  SimSharedMemory(const SimSharedMemory& other);
+
+  /// \brief Copy operator.
+  SimSharedMemory& operator=(const SimSharedMemory& other);
+
+  /// The size of the memory segment in bytes.
+  size_t    shm_size_;
+
+  /// The memory segment.
+  uint8_t*  shm_ptr_;
+
+}; // end class SimSharedMemory
+
+#endif // IRON_UTIL_BPFSIM_SIM_SHARED_MEMORY_H
@@ -61,6 +61,7 @@ enum HeaderType
   CC_SYNC_HEADER              = 34,
   RCVD_PKT_CNT_HEADER         = 35,
   CONN_MEAS_HEADER            = 36,
+  ACK_FREQ_HEADER             = 37,
 
   // SLIQ specialized stand-alone headers.  Cannot be concatenated.
   CC_PKT_TRAIN_HEADER         = 40,
@@ -79,6 +80,9 @@ enum HeaderType
 // The size of the base connection handshake header, in bytes.
 const size_t  kConnHandshakeHdrBaseSize = 16;
 
+// The size of the optional connection handshake resumption token, in bytes.
+const size_t  kConnHandshakeHdrTokenSize = 4;
+
 // The size of the connection handshake CC algorithm fields, in bytes.
 const size_t  kConnHandshakeHdrCcAlgSize = 8;
 
@@ -88,7 +92,7 @@ const size_t  kConnHandshakeHdrCcAlgSize = 8;
 ///  0                   1                   2                   3
 ///  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
 /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-/// |     Type      |  # of CC Alg  |          Message Tag          |
+/// |     Type      |C|R|# CC Alg   |          Message Tag          |
 /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 
 struct connHndshkFrontend
@@ -130,20 +134,36 @@ const size_t  kDataHdrMoveFwdSize = 4;
 // The size of the data header FEC fields, in bytes.
 const size_t  kDataHdrFecSize = 4;
 
+// The size of the data header FEC sliding window field, in bytes.
+const size_t  kDataHdrFecWinSize = 2;
+
 // The size of the data header encoded packet size field, in bytes.
 const size_t  kDataHdrEncPktLenSize = 2;
 
 // The size of the data header time-to-go field, in bytes.
 const size_t  kDataHdrTimeToGoSize = 2;
 
+// The size of the compact data header fields before the packet sequence
+// number, in bytes.
+const size_t  kDataHdrCompactPreSeqSize = 5;
+
+// The size of the compact data header timestamp field, in bytes.
+const size_t  kDataHdrCompactTsSize = 4;
+
 /// The SLIQ Data header (partial).
 ///
 /// \verbatim
 ///  0                   1                   2                   3
 ///  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
 /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-/// |     Type      |U|L|E|M| U |P|F|   Stream ID   | Number of TTG |
+/// |     Type      |C|L|E|M| U |P|F|   Stream ID   | Number of TTG |
 /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+///
+/// When the C flag is set, the two unused flag bits hold the packet sequence
+/// number length in bytes minus one, the "Number of TTG" byte holds the CC ID
+/// (3 bits) and the number of TTGs (5 bits), and the remaining fixed fields
+/// are a one byte retransmission count, the truncated packet sequence
+/// number, a four byte timestamp, and a varint timestamp delta.
 
 struct dataFrontend
 {
@@ -165,14 +185,25 @@ const size_t  kAckHdrObsTimeSize = 8;
 // The size of each ACK block offset entry in the ACK header, in bytes.
 const size_t  kAckHdrAckBlockOffsetSize = 2;
 
+// The size of the fixed length fields in the compact ACK header, in bytes.
+const size_t  kAckHdrCompactBaseSize = 12;
+
+// The size of the first observed timestamp in the compact ACK header, in
+// bytes.
+const size_t  kAckHdrCompactObsTsSize = 4;
+
 /// The SLIQ ACK header (partial).
 ///
 /// \verbatim
 ///  0                   1                   2                   3
 ///  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
 /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-/// |     Type      |Flags (Unused) |   Stream ID   | #OPT|   #ABO  |
+/// |     Type      |C|   Unused    |   Stream ID   | #OPT|   #ABO  |
 /// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+///
+/// When the C flag is set, the timestamp delta and the observed times use
+/// varints, and each ACK block offset is one byte (MSB 0) or two bytes (MSB
+/// 1).
 
 struct ackFrontend
 {
@@ -203,6 +234,12 @@ const size_t  kConnMeasHdrBaseSize = 4;
 // The size of the maximum remote-to-local one-way delay field, in bytes.
 const size_t  kConnMeasHdrMaxRtlOwdSize = 4;
 
+
+// ================ SLIQ ACK Frequency Headers ================
+
+// The size of the ACK frequency header, in bytes.
+const size_t  kAckFreqHdrSize = 8;
+
 /// The SLIQ connection measurement header (partial).
 ///
 /// \verbatim
@@ -52,6 +52,7 @@
 #include "sliq.h"
 
 static int32_t removeSliqHeader(char *dumpFileIn, char *dumpFileOut);
+static size_t varintSize(const uint8_t *ptr, const uint8_t *end);
 
 int main(int argc, char **argv)
 {
@@ -112,6 +113,9 @@ static int32_t removeSliqHeader(char *dumpFileIn, char *dumpFileOut)
   int32_t nPkts     = 0;
   int32_t shortPkts = 0;
 
+  uint64_t hdrBytes = 0;
+  uint64_t pldBytes = 0;
+
   // Open the capture file
 
   if ((p = pcap_open_offline(dumpFileIn,&errbuf[0])) == NULL)
@@ -209,6 +213,15 @@ static int32_t removeSliqHeader(char *dumpFileIn, char *dumpFileOut)
 
           uint8_t* send = sptr + plen;
 
+          // Count the SLIQ header bytes using the UDP length, since the
+          // capture may be truncated.  Any bytes after a data header are
+          // payload.
+          uint8_t* sstart  = sptr;
+          size_t   udpLen  = ntohs(udp->len);
+          size_t   sliqLen = ((udpLen > sizeof(struct udphdr)) ?
+                              (udpLen - sizeof(struct udphdr)) : 0);
+          size_t   pldLen  = 0;
+
           while (sptr < send)
           {
             uint8_t type = *sptr;
@@ -222,8 +235,15 @@ static int32_t removeSliqHeader(char *dumpFileIn, char *dumpFileOut)
                 struct connHndshkFrontend *chfe =
                   (struct connHndshkFrontend *)sptr;
                 size_t chSize = kConnHandshakeHdrBaseSize +
-                  (size_t)(chfe->num_cc_algs) * kConnHandshakeHdrCcAlgSize;
+                  (size_t)(chfe->num_cc_algs & 0x3f) *
+                  kConnHandshakeHdrCcAlgSize;
                 sptr += chSize;
+
+                // Skip the optional resumption token at the end.
+                if ((size_t)(send - sptr) == kConnHandshakeHdrTokenSize)
+                {
+                  sptr = send;
+                }
               }
               else
               {
@@ -253,12 +273,35 @@ static int32_t removeSliqHeader(char *dumpFileIn, char *dumpFileOut)
               if ((size_t)(send - sptr) > sizeof(struct ackFrontend))
               {
                 struct ackFrontend *afe = (struct ackFrontend *)sptr;
+                size_t numObs  = ((afe->num_opt_abo >> 5) & 0x07);
+                size_t numAbo  = (afe->num_opt_abo & 0x1f);
                 size_t ackSize =
-                  (kAckHdrBaseSize +
-                   ((size_t)((afe->num_opt_abo >> 5) & 0x07) *
-                    kAckHdrObsTimeSize) +
-                   ((size_t)(afe->num_opt_abo & 0x1f) *
-                    kAckHdrAckBlockOffsetSize));
+                  (kAckHdrBaseSize + (numObs * kAckHdrObsTimeSize) +
+                   (numAbo * kAckHdrAckBlockOffsetSize));
+
+                if (afe->flags & 0x80)
+                {
+                  // Walk the varint fields of the compact ACK header.
+                  const uint8_t *aptr = (sptr + kAckHdrCompactBaseSize);
+                  size_t         i    = 0;
+
+                  aptr += varintSize(aptr, send);
+
+                  for (i = 0; i < numObs; ++i)
+                  {
+                    aptr += varintSize(aptr, send);
+                    aptr += ((i == 0) ? kAckHdrCompactObsTsSize :
+                             varintSize(aptr, send));
+                  }
+
+                  for (i = 0; (i < numAbo) && (aptr < send); ++i)
+                  {
+                    aptr += (((*aptr) & 0x80) ? 2 : 1);
+                  }
+
+                  ackSize = (size_t)(aptr - sptr);
+                }
+
                 sptr += ackSize;
               }
               else
@@ -293,6 +336,10 @@ static int32_t removeSliqHeader(char *dumpFileIn, char *dumpFileOut)
                 sptr = send;
               }
             }
+            else if (type == ACK_FREQ_HEADER)
+            {
+              sptr += kAckFreqHdrSize;
+            }
             else if (type == CC_PKT_TRAIN_HEADER)
             {
               sptr = send;
@@ -304,16 +351,47 @@ static int32_t removeSliqHeader(char *dumpFileIn, char *dumpFileOut)
               if ((size_t)(send - sptr) > sizeof(struct dataFrontend))
               {
                 struct dataFrontend *dfe = (struct dataFrontend *)sptr;
+                size_t baseSize = kDataHdrBaseSize;
+                size_t numTtg   = dfe->num_ttg;
+
+                // The compact data header has a variable length base.
+                if (dfe->flags & 0x80)
+                {
+                  baseSize  = (kDataHdrCompactPreSeqSize +
+                               (size_t)(((dfe->flags >> 2) & 0x03) + 1) +
+                               kDataHdrCompactTsSize);
+                  baseSize += varintSize((sptr + baseSize), send);
+                  numTtg    = (dfe->num_ttg & 0x1f);
+                }
+
                 size_t dataHdrSize =
-                  (kDataHdrBaseSize +
+                  (baseSize +
                    ((dfe->flags & 0x10) ? kDataHdrMoveFwdSize : 0) +
                    ((dfe->flags & 0x20) ? kDataHdrFecSize : 0) +
                    ((dfe->flags & 0x40) ? kDataHdrEncPktLenSize : 0) +
-                   (dfe->num_ttg * kDataHdrTimeToGoSize));
+                   (numTtg * kDataHdrTimeToGoSize));
+
+                // The FEC sliding window flag is in the first FEC byte.
+                if (dfe->flags & 0x20)
+                {
+                  const uint8_t *fptr =
+                    (sptr + baseSize +
+                     ((dfe->flags & 0x10) ? kDataHdrMoveFwdSize : 0));
+
+                  if ((fptr < send) && ((*fptr) & 0x40))
+                  {
+                    dataHdrSize += kDataHdrFecWinSize;
+                  }
+                }
 
                 sptr += dataHdrSize;
                 plen  = send - sptr;
 
+                if ((size_t)(sptr - sstart) < sliqLen)
+                {
+                  pldLen = (sliqLen - (size_t)(sptr - sstart));
+                }
+
                 // Process CAT headers until an IP header is found
                 while (sptr < send)
                 {
@@ -381,6 +459,9 @@ static int32_t removeSliqHeader(char *dumpFileIn, char *dumpFileOut)
               sptr = send;
             }
           }
+
+          hdrBytes += (sliqLen - pldLen);
+          pldBytes += pldLen;
         }
       }
     }
@@ -407,5 +488,30 @@ static int32_t removeSliqHeader(char *dumpFileIn, char *dumpFileOut)
            shortPkts);
   }
 
+  if (pldBytes > 0)
+  {
+    printf("SLIQ header bytes %llu, payload bytes %llu, header bytes per "
+           "payload byte %f\n", (unsigned long long)hdrBytes,
+           (unsigned long long)pldBytes,
+           ((double)hdrBytes / (double)pldBytes));
+  }
+
   return (nPkts);
 }
+
+static size_t varintSize(const uint8_t *ptr, const uint8_t *end)
+{
+  size_t len = 0;
+
+  // A varint is at most 5 bytes long, and all but the last byte have the MSB
+  // set.
+  while (((ptr + len) < end) && (len < 5))
+  {
+    if ((ptr[len++] & 0x80) == 0)
+    {
+      break;
+    }
+  }
+
+  return (len);
+}
@@ -0,0 +1,2080 @@
+// IRON: iron_headers
+/*
+ * Distribution A
+ *
+ * Approved for Public Release, Distribution Unlimited
+ *
+ * EdgeCT (IRON) Software Contract No.: HR0011-15-C-0097
+ * DCOMP (GNAT)  Software Contract No.: HR0011-17-C-0050
+ * Copyright (c) 2015-20 Raytheon BBN Technologies Corp.
+ *
+ * This material is based upon work supported by the Defense Advanced
+ * Research Projects Agency under Contracts No. HR0011-15-C-0097 and
+ * HR0011-17-C-0050. Any opinions, findings and conclusions or
+ * recommendations expressed in this material are those of the author(s)
+ * and do not necessarily reflect the views of the Defense Advanced
+ * Research Project Agency.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/// \file sliq_perf.cc
+///
+/// A throughput and latency benchmark for SLIQ.
+///
+/// The client opens a SLIQ connection to the server, creates a number of
+/// streams using the specified reliability mode, and sends packets at the
+/// specified offered load for the specified duration.  The server receives
+/// the packets.  Both ends print periodic goodput reports, followed by a
+/// final report with goodput, one-way delay percentiles, retransmission and
+/// FEC overhead, CPU time per Gbit, and system calls per packet.
+///
+/// One-way delays are computed from sender timestamps, so the clocks of the
+/// two hosts must be synchronized when not running over loopback or a
+/// network namespace veth pair.  LinkEm may be placed between the two hosts
+/// in order to add loss and delay.
+
+#include "sliq_app.h"
+
+#include "fd_event.h"
+#include "ipv4_endpoint.h"
+#include "itime.h"
+#include "list.h"
+#include "log.h"
+#include "packet.h"
+#include "packet_pool_heap.h"
+#include "string_utils.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+
+using ::iron::FdEvent;
+using ::iron::FdEventInfo;
+using ::iron::Ipv4Endpoint;
+using ::iron::List;
+using ::iron::Log;
+using ::iron::Packet;
+using ::iron::PacketPool;
+using ::iron::PacketPoolHeap;
+using ::iron::StringUtils;
+using ::iron::Time;
+using ::iron::Timer;
+using ::sliq::AckBatchStats;
+using ::sliq::CongCtrl;
+using ::sliq::DeliveryMode;
+using ::sliq::EndptId;
+using ::sliq::Priority;
+using ::sliq::Reliability;
+using ::sliq::RexmitLimit;
+using ::sliq::RttPdd;
+using ::sliq::SendStats;
+using ::sliq::SliqApp;
+using ::sliq::SocketStats;
+using ::sliq::StreamId;
+using ::std::string;
+using ::std::vector;
+
+
+namespace
+{
+  const char*   kName            = "SliqPerf";
+  const size_t  kMaxFdCnt        = 33;
+  const size_t  kMaxStreams      = 16;
+  const size_t  kPktPoolSize     = 131072;
+  const size_t  kMaxCcAlg        = 8;
+  const size_t  kXmitQueueSize   = 64;
+  const size_t  kMaxSendBurst    = 64;
+  const size_t  kMaxOwdSamples   = 16777216;
+  const size_t  kPerfHdrLen      = 12;  // Sequence number and timestamp.
+  const size_t  kMaxPayload      = 1452;  // 1500 - 20 - 8 - 20 = 1452
+  const size_t  kDefaultPayload  = 1000;
+  const double  kDefaultDuration = 10.0;
+  const double  kDefaultInterval = 1.0;
+  const double  kDrainTime       = 1.0;
+  const double  kCloseWaitTime   = 16.0;
+}
+
+
+/// \brief Get the current wall clock time in microseconds.
+///
+/// \return  The current wall clock time in microseconds.
+static uint64_t GetWallClockUsec()
+{
+  timespec  t_spec;
+
+  if (clock_gettime(CLOCK_REALTIME, &t_spec) != 0)
+  {
+    return 0;
+  }
+
+  return ((static_cast<uint64_t>(t_spec.tv_sec) * 1000000) +
+          (static_cast<uint64_t>(t_spec.tv_nsec) / 1000));
+}
+
+
+/// \brief Get the CPU time used by the process so far.
+///
+/// \param  user_sec  A reference to where the user CPU time, in seconds, is
+///                   returned.
+/// \param  sys_sec   A reference to where the system CPU time, in seconds,
+///                   is returned.
+static void GetCpuTime(double& user_sec, double& sys_sec)
+{
+  struct rusage  usage;
+
+  user_sec = 0.0;
+  sys_sec  = 0.0;
+
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+  {
+    user_sec = (static_cast<double>(usage.ru_utime.tv_sec) +
+                (static_cast<double>(usage.ru_utime.tv_usec) * 1.0e-6));
+    sys_sec  = (static_cast<double>(usage.ru_stime.tv_sec) +
+                (static_cast<double>(usage.ru_stime.tv_usec) * 1.0e-6));
+  }
+}
+
+
+class SliqPerf;
+
+
+//============================================================================
+/// \brief A snapshot of the resources used by the process.
+class PerfUsage
+{
+
+public:
+
+  PerfUsage();
+  virtual ~PerfUsage();
+
+  void Take(SliqPerf* app, size_t select_calls);
+
+  bool         valid_;
+  Time         time_;
+  double       user_sec_;
+  double       sys_sec_;
+  size_t       select_calls_;
+  SocketStats  sock_stats_;
+}; // end class PerfUsage
+
+
+//============================================================================
+/// \brief The state of one benchmark stream.
+class PerfStream
+{
+
+public:
+
+  PerfStream(StreamId stream_id, PacketPool& packet_pool);
+  virtual ~PerfStream();
+
+  void StartSending(const Time& now, const Time& wait, const Time& end);
+  void GetNextWaitTime(const Time& now, Time& wait_time);
+  void SendPackets(SliqPerf* app, EndptId endpt_id, size_t pkt_len,
+                   const Time& now);
+  bool RecvPacket(Packet* data, size_t& pkt_len, uint64_t& owd_usec);
+
+  PacketPool&  pkt_pool_;
+  StreamId     stream_id_;
+  bool         is_established_;
+  bool         is_blocked_;
+  Packet*      pkt_;
+  Time         wait_;
+  Time         send_time_;
+  Time         end_time_;
+  uint32_t     next_seq_num_;
+  size_t       sent_pkts_;
+  size_t       sent_bytes_;
+  size_t       skipped_pkts_;
+  size_t       recv_pkts_;
+  size_t       recv_bytes_;
+  uint32_t     recv_max_seq_num_;
+}; // end class PerfStream
+
+
+//============================================================================
+/// \brief The SLIQ benchmark application.
+class SliqPerf : public SliqApp
+{
+
+public:
+
+  SliqPerf(PacketPool& packet_pool, Timer& timer);
+  virtual ~SliqPerf();
+
+  // ----- SliqPerf API Methods -----
+  bool Init(int argc, char** argv);
+  void Run();
+  void PrintReport();
+  void SentPkt(size_t pkt_len, const Time& now);
+
+  // ----- SliqApp API Methods -----
+  virtual bool ProcessConnectionRequest(EndptId server_endpt_id,
+                                        EndptId data_endpt_id,
+                                        const Ipv4Endpoint& client_address);
+  virtual void ProcessConnectionResult(EndptId endpt_id, bool success);
+  virtual void ProcessNewStream(EndptId endpt_id, StreamId stream_id,
+                                Priority prio, const Reliability& rel,
+                                DeliveryMode del_mode);
+  virtual void Recv(EndptId endpt_id, StreamId stream_id, Packet* data);
+  virtual void ProcessCapacityEstimate(EndptId endpt_id,
+                                       double chan_cap_est_bps,
+                                       double trans_cap_est_bps,
+                                       double ccl_time_sec);
+  virtual void ProcessRttPddSamples(EndptId endpt_id, uint32_t num_samples,
+                                    const RttPdd* samples);
+  virtual void ProcessCloseStream(EndptId endpt_id, StreamId stream_id,
+                                  bool fully_closed);
+  virtual void ProcessClose(EndptId endpt_id, bool fully_closed);
+  virtual void ProcessFileDescriptorChange();
+
+private:
+
+  void Usage(const char* prog_name);
+  bool ParseCongCtrlConfig(const char* cc_config);
+  bool ParseDirectConnConfig(const char* dir_conn_config);
+  bool ParseReliabilityMode(const char* rel_config);
+  bool ActAsServer(const Ipv4Endpoint& server_address);
+  bool ActAsClient(const Ipv4Endpoint& server_address);
+  void StartSending(const Time& now);
+  void StopSending();
+  void CloseClient();
+  void PrintInterval(const Time& now);
+  void PrintUsage(double bytes, size_t pkts);
+  void PrintOwdPercentiles();
+
+  PacketPool&         pkt_pool_;
+  Timer&              timer_;
+  bool                is_server_;
+  bool                direct_conn_;
+  bool                is_connected_;
+  bool                is_sending_;
+  bool                should_terminate_;
+  bool                ack_decimation_;
+  bool                ack_coalescing_;
+  bool                compact_hdrs_;
+  string              direct_local_addr_;
+  string              direct_remote_addr_;
+  string              server_addr_;
+  string              server_port_;
+  size_t              num_cc_alg_;
+  CongCtrl            cc_algorithm_[kMaxCcAlg];
+  size_t              num_streams_;
+  Reliability         rel_;
+  DeliveryMode        del_mode_;
+  size_t              pkt_len_;
+  double              rate_bps_;
+  double              duration_sec_;
+  double              interval_sec_;
+  EndptId             listen_endpt_id_;
+  EndptId             data_endpt_id_;
+  PerfStream*         stream_[kMaxStreams];
+  Time                end_time_;
+  Time                close_time_;
+  Time                term_time_;
+  Time                intv_start_time_;
+  Time                intv_end_time_;
+  size_t              intv_pkts_;
+  size_t              intv_bytes_;
+  uint64_t            intv_owd_sum_usec_;
+  Time                first_pkt_time_;
+  Time                last_pkt_time_;
+  size_t              total_pkts_;
+  size_t              total_bytes_;
+  vector<uint32_t>    owd_usec_;
+  size_t              select_calls_;
+  PerfUsage           start_usage_;
+  PerfUsage           end_usage_;
+  SendStats           send_stats_;
+  AckBatchStats       ack_batch_stats_;
+  double              chan_cap_est_bps_;
+}; // end class SliqPerf
+
+
+//============================================================================
+PerfUsage::PerfUsage()
+    : valid_(false),
+      time_(),
+      user_sec_(0.0),
+      sys_sec_(0.0),
+      select_calls_(0),
+      sock_stats_()
+{
+}
+
+//============================================================================
+PerfUsage::~PerfUsage()
+{
+}
+
+//============================================================================
+void PerfUsage::Take(SliqPerf* app, size_t select_calls)
+{
+  valid_        = true;
+  time_         = Time::Now();
+  select_calls_ = select_calls;
+
+  GetCpuTime(user_sec_, sys_sec_);
+
+  if (!app->GetSocketStats(sock_stats_))
+  {
+    LogW(kName, __func__, "Unable to get socket statistics.\n");
+  }
+}
+
+
+//============================================================================
+PerfStream::PerfStream(StreamId stream_id, PacketPool& packet_pool)
+    : pkt_pool_(packet_pool),
+      stream_id_(stream_id),
+      is_established_(false),
+      is_blocked_(false),
+      pkt_(NULL),
+      wait_(),
+      send_time_(),
+      end_time_(),
+      next_seq_num_(0),
+      sent_pkts_(0),
+      sent_bytes_(0),
+      skipped_pkts_(0),
+      recv_pkts_(0),
+      recv_bytes_(0),
+      recv_max_seq_num_(0)
+{
+  LogD(kName, __func__, "PerfStream %" PRIStreamId " object created.\n",
+       stream_id_);
+}
+
+//============================================================================
+PerfStream::~PerfStream()
+{
+  LogD(kName, __func__, "PerfStream %" PRIStreamId " object destroyed.\n",
+       stream_id_);
+
+  if (pkt_ != NULL)
+  {
+    pkt_pool_.Recycle(pkt_);
+    pkt_ = NULL;
+  }
+}
+
+//============================================================================
+void PerfStream::StartSending(const Time& now, const Time& wait,
+                              const Time& end)
+{
+  is_blocked_ = false;
+  wait_       = wait;
+  send_time_  = now;
+  end_time_   = end;
+}
+
+//============================================================================
+void PerfStream::GetNextWaitTime(const Time& now, Time& wait_time)
+{
+  if ((!is_established_) || (now >= end_time_))
+  {
+    return;
+  }
+
+  if (wait_.IsZero())
+  {
+    // Without an offered load limit, wait for SLIQ to accept more packets
+    // once it has refused one.
+    if (!is_blocked_)
+    {
+      wait_time.Zero();
+    }
+  }
+  else if (now >= send_time_)
+  {
+    wait_time.Zero();
+  }
+  else
+  {
+    wait_time = Time::Min(wait_time, (send_time_ - now));
+  }
+}
+
+//============================================================================
+void PerfStream::SendPackets(SliqPerf* app, EndptId endpt_id, size_t pkt_len,
+                             const Time& now)
+{
+  if ((!is_established_) || (now >= end_time_))
+  {
+    return;
+  }
+
+  is_blocked_ = false;
+
+  for (size_t i = 0; i < kMaxSendBurst; ++i)
+  {
+    // With an offered load limit, only send when the send time is reached.
+    if ((!wait_.IsZero()) && (now < send_time_))
+    {
+      return;
+    }
+
+    if (pkt_ == NULL)
+    {
+      pkt_ = pkt_pool_.Get();
+
+      if (pkt_ == NULL)
+      {
+        LogE(kName, __func__, "Error allocating packet.\n");
+        return;
+      }
+
+      pkt_->SetLengthInBytes(pkt_len);
+    }
+
+    // Stamp the packet with its sequence number and the current wall clock
+    // time.
+    uint8_t*  buf      = pkt_->GetBuffer();
+    uint64_t  ts_usec  = GetWallClockUsec();
+    uint32_t  seq_nbo  = htonl(next_seq_num_);
+    uint32_t  ts_hi    = htonl(static_cast<uint32_t>(ts_usec >> 32));
+    uint32_t  ts_lo    = htonl(static_cast<uint32_t>(ts_usec & 0xffffffff));
+
+    memcpy(buf, &seq_nbo, sizeof(seq_nbo));
+    memcpy(&(buf[4]), &ts_hi, sizeof(ts_hi));
+    memcpy(&(buf[8]), &ts_lo, sizeof(ts_lo));
+
+    // On success, SLIQ takes ownership of the packet.
+    if (app->Send(endpt_id, stream_id_, pkt_))
+    {
+      pkt_ = NULL;
+
+      ++next_seq_num_;
+      ++sent_pkts_;
+      sent_bytes_ += pkt_len;
+      app->SentPkt(pkt_len, now);
+
+      if (!wait_.IsZero())
+      {
+        send_time_ += wait_;
+      }
+    }
+    else
+    {
+      if (wait_.IsZero())
+      {
+        // Wait for SLIQ to accept more packets.
+        is_blocked_ = true;
+        return;
+      }
+
+      // Keep the offered load by skipping this send opportunity.  The
+      // sequence number is still consumed so that the receiver counts the
+      // packet as lost.
+      ++next_seq_num_;
+      ++skipped_pkts_;
+      send_time_ += wait_;
+    }
+  }
+}
+
+//============================================================================
+bool PerfStream::RecvPacket(Packet* data, size_t& pkt_len,
+                            uint64_t& owd_usec)
+{
+  pkt_len  = data->GetLengthInBytes();
+  owd_usec = 0;
+
+  if (pkt_len < kPerfHdrLen)
+  {
+    return false;
+  }
+
+  uint8_t*  buf     = data->GetBuffer();
+  uint32_t  seq_nbo = 0;
+  uint32_t  ts_hi   = 0;
+  uint32_t  ts_lo   = 0;
+
+  memcpy(&seq_nbo, buf, sizeof(seq_nbo));
+  memcpy(&ts_hi, &(buf[4]), sizeof(ts_hi));
+  memcpy(&ts_lo, &(buf[8]), sizeof(ts_lo));
+
+  uint32_t  seq_num = ntohl(seq_nbo);
+  uint64_t  ts_usec = ((static_cast<uint64_t>(ntohl(ts_hi)) << 32) |
+                       static_cast<uint64_t>(ntohl(ts_lo)));
+  uint64_t  now_usec = GetWallClockUsec();
+
+  if ((recv_pkts_ == 0) || (seq_num > recv_max_seq_num_))
+  {
+    recv_max_seq_num_ = seq_num;
+  }
+
+  ++recv_pkts_;
+  recv_bytes_ += pkt_len;
+
+  // A timestamp from the future is the result of unsynchronized clocks.
+  if (now_usec > ts_usec)
+  {
+    owd_usec = (now_usec - ts_usec);
+  }
+
+  return true;
+}
+
+
+//============================================================================
+SliqPerf::SliqPerf(PacketPool& packet_pool, Timer& timer)
+    : SliqApp(packet_pool, timer),
+      pkt_pool_(packet_pool),
+      timer_(timer),
+      is_server_(true),
+      direct_conn_(false),
+      is_connected_(false),
+      is_sending_(false),
+      should_terminate_(false),
+      ack_decimation_(false),
+      ack_coalescing_(false),
+      compact_hdrs_(false),
+      direct_local_addr_(),
+      direct_remote_addr_(),
+      server_addr_("0.0.0.0"),
+      server_port_("22123"),
+      num_cc_alg_(1),
+      cc_algorithm_(),
+      num_streams_(1),
+      rel_(),
+      del_mode_(sliq::ORDERED_DELIVERY),
+      pkt_len_(kDefaultPayload),
+      rate_bps_(0.0),
+      duration_sec_(kDefaultDuration),
+      interval_sec_(kDefaultInterval),
+      listen_endpt_id_(-1),
+      data_endpt_id_(-1),
+      stream_(),
+      end_time_(Time::Infinite()),
+      close_time_(Time::Infinite()),
+      term_time_(Time::Infinite()),
+      intv_start_time_(),
+      intv_end_time_(Time::Infinite()),
+      intv_pkts_(0),
+      intv_bytes_(0),
+      intv_owd_sum_usec_(0),
+      first_pkt_time_(),
+      last_pkt_time_(),
+      total_pkts_(0),
+      total_bytes_(0),
+      owd_usec_(),
+      select_calls_(0),
+      start_usage_(),
+      end_usage_(),
+      send_stats_(),
+      ack_batch_stats_(),
+      chan_cap_est_bps_(0.0)
+{
+  LogD(kName, __func__, "SliqPerf object created.\n");
+
+  cc_algorithm_[0].SetCopa();
+  rel_.SetRelArq();
+
+  for (size_t i = 0; i < kMaxStreams; ++i)
+  {
+    stream_[i] = NULL;
+  }
+}
+
+//============================================================================
+SliqPerf::~SliqPerf()
+{
+  LogD(kName, __func__, "SliqPerf object destroyed.\n");
+
+  for (size_t i = 0; i < kMaxStreams; ++i)
+  {
+    if (stream_[i] != NULL)
+    {
+      delete stream_[i];
+      stream_[i] = NULL;
+    }
+  }
+}
+
+//============================================================================
+bool SliqPerf::Init(int argc, char** argv)
+{
+  extern char*  optarg;
+  extern int    optind;
+
+  int  c   = 0;
+  int  val = 0;
+
+  // Log the command line.
+  string  cmd;
+
+  for (int i = 0; i < argc; ++i)
+  {
+    if (i > 0)
+    {
+      cmd.append(" ");
+    }
+
+    cmd.append(argv[i]);
+  }
+
+  LogC(kName, __func__, "Command: %s\n", cmd.c_str());
+
+  // Parse the command line arguments.
+  while ((c = getopt(argc, argv, "C:D:p:n:m:ul:b:t:i:ABcqvdh")) != -1)
+  {
+    switch (c)
+    {
+      case 'C':
+        if (!ParseCongCtrlConfig(optarg))
+        {
+          LogE(kName, __func__, "Invalid congestion control config: %s\n",
+               optarg);
+          return false;
+        }
+        break;
+
+      case 'D':
+        if (!ParseDirectConnConfig(optarg))
+        {
+          LogE(kName, __func__, "Invalid direct connection addresses: %s\n",
+               optarg);
+          return false;
+        }
+        direct_conn_ = true;
+        break;
+
+      case 'p':
+        server_port_ = optarg;
+        break;
+
+      case 'n':
+        val = StringUtils::GetInt(optarg, -1);
+        if ((val < 1) || (val > static_cast<int>(kMaxStreams)))
+        {
+          LogE(kName, __func__, "Invalid number of streams: %s\n", optarg);
+          return false;
+        }
+        num_streams_ = static_cast<size_t>(val);
+        break;
+
+      case 'm':
+        if (!ParseReliabilityMode(optarg))
+        {
+          LogE(kName, __func__, "Invalid reliability mode: %s\n", optarg);
+          return false;
+        }
+        break;
+
+      case 'u':
+        del_mode_ = sliq::UNORDERED_DELIVERY;
+        break;
+
+      case 'l':
+        val = StringUtils::GetInt(optarg, -1);
+        if ((val < static_cast<int>(kPerfHdrLen)) ||
+            (val > static_cast<int>(kMaxPayload)))
+        {
+          LogE(kName, __func__, "Invalid packet length: %s\n", optarg);
+          return false;
+        }
+        pkt_len_ = static_cast<size_t>(val);
+        break;
+
+      case 'b':
+        rate_bps_ = (StringUtils::GetDouble(optarg, -1.0) * 1.0e6);
+        if (rate_bps_ < 0.0)
+        {
+          LogE(kName, __func__, "Invalid offered load: %s\n", optarg);
+          return false;
+        }
+        break;
+
+      case 't':
+        duration_sec_ = StringUtils::GetDouble(optarg, -1.0);
+        if (duration_sec_ <= 0.0)
+        {
+          LogE(kName, __func__, "Invalid duration: %s\n", optarg);
+          return false;
+        }
+        break;
+
+      case 'i':
+        interval_sec_ = StringUtils::GetDouble(optarg, -1.0);
+        if (interval_sec_ < 0.0)
+        {
+          LogE(kName, __func__, "Invalid report interval: %s\n", optarg);
+          return false;
+        }
+        break;
+
+      case 'A':
+        ack_decimation_ = true;
+        break;
+
+      case 'B':
+        ack_coalescing_ = true;
+        break;
+
+      case 'c':
+        compact_hdrs_ = true;
+        break;
+
+      case 'q':
+        Log::SetDefaultLevel("FEW");
+        break;
+
+      case 'v':
+        Log::SetDefaultLevel("FEWIA");
+        break;
+
+      case 'd':
+        Log::SetDefaultLevel("FEWIAD");
+        break;
+
+      case 'h':
+      default:
+        Usage(argv[0]);
+    }
+  }
+
+  // Get any server address specified.
+  if ((argc - optind) > 1)
+  {
+    LogE(kName, __func__, "Too many server addresses specified.\n");
+    return false;
+  }
+
+  if ((argc - optind) == 1)
+  {
+    // Act as a client, connecting to the specified server.
+    is_server_   = false;
+    server_addr_ = argv[optind];
+  }
+
+  // SLIQ only supports ordered delivery for the reliable mode.
+  if (rel_.mode != sliq::RELIABLE_ARQ)
+  {
+    del_mode_ = sliq::UNORDERED_DELIVERY;
+  }
+
+  // Reserve space for the one-way delay samples up front to avoid
+  // reallocations while receiving.
+  if (is_server_)
+  {
+    owd_usec_.reserve(1048576);
+  }
+
+  // Initialize the parent SliqApp object.
+  if (!InitializeSliqApp())
+  {
+    LogE(kName, __func__, "Error initializing SliqApp.\n");
+    return false;
+  }
+
+  // Allow compact headers if requested.
+  if (compact_hdrs_ && (!ConfigureCompactHeaders(true)))
+  {
+    LogE(kName, __func__, "Error enabling compact headers.\n");
+    return false;
+  }
+
+  // Initialize the client or server side.
+  if (is_server_)
+  {
+    Ipv4Endpoint  endpoint("0.0.0.0:" + server_port_);
+
+    if (!ActAsServer(endpoint))
+    {
+      LogE(kName, __func__, "Error setting up server %s.\n",
+           endpoint.ToString().c_str());
+      return false;
+    }
+  }
+  else
+  {
+    Ipv4Endpoint  endpoint(server_addr_ + ":" + server_port_);
+
+    if (!ActAsClient(endpoint))
+    {
+      LogE(kName, __func__, "Error setting up client for server %s.\n",
+           endpoint.ToString().c_str());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//============================================================================
+void SliqPerf::Run()
+{
+  Time         now = Time::Now();
+  fd_set       read_fds;
+  fd_set       write_fds;
+  FdEventInfo  fd_event_info[kMaxFdCnt];
+
+  while (true)
+  {
+    // Prepare for the select() call.  Add the SLIQ file descriptors to the
+    // read and write sets.
+    size_t  num_fds = GetFileDescriptorList(fd_event_info, kMaxFdCnt);
+    int     max_fd  = -1;
+
+    FD_ZERO(&read_fds);
+    FD_ZERO(&write_fds);
+
+    for (size_t  i = 0; i < num_fds; ++i)
+    {
+      if ((fd_event_info[i].events == iron::kFdEventRead) ||
+          (fd_event_info[i].events == iron::kFdEventReadWrite))
+      {
+        FD_SET(fd_event_info[i].fd, &read_fds);
+      }
+
+      if ((fd_event_info[i].events == iron::kFdEventWrite) ||
+          (fd_event_info[i].events == iron::kFdEventReadWrite))
+      {
+        FD_SET(fd_event_info[i].fd, &write_fds);
+      }
+
+      if (max_fd < fd_event_info[i].fd)
+      {
+        max_fd = fd_event_info[i].fd;
+      }
+    }
+
+    // Figure out the backstop time for the select() call.
+    Time  wait_time = timer_.GetNextExpirationTime(Time(0.5));
+
+    if (is_sending_)
+    {
+      for (size_t  i = 0; i < num_streams_; ++i)
+      {
+        if (stream_[i] != NULL)
+        {
+          stream_[i]->GetNextWaitTime(now, wait_time);
+        }
+      }
+    }
+
+    if (intv_end_time_ > now)
+    {
+      wait_time = Time::Min(wait_time, (intv_end_time_ - now));
+    }
+    else
+    {
+      wait_time.Zero();
+    }
+
+    timeval  wait_tv = wait_time.ToTval();
+
+    // Do the select() call.
+    int  rv = ::select((max_fd + 1), &read_fds, &write_fds, NULL, &wait_tv);
+
+    ++select_calls_;
+
+    // Handle the select() call results.
+    if (rv < 0)
+    {
+      LogE(kName, __func__, "select() error %s.\n", strerror(errno));
+    }
+    else if (rv > 0)
+    {
+      FdEvent  event = iron::kFdEventRead;
+
+      // Process the file descriptors that are ready.
+      for (size_t  i = 0; i < num_fds; ++i)
+      {
+        bool  read_flag  = (FD_ISSET(fd_event_info[i].fd, &read_fds) != 0);
+        bool  write_flag = (FD_ISSET(fd_event_info[i].fd, &write_fds) != 0);
+
+        if (read_flag)
+        {
+          event = (write_flag ? iron::kFdEventReadWrite :
+                   iron::kFdEventRead);
+        }
+        else
+        {
+          if (!write_flag)
+          {
+            continue;
+          }
+
+          event = iron::kFdEventWrite;
+        }
+
+        SvcFileDescriptor(fd_event_info[i].fd, event);
+      }
+    }
+
+    // Process the timer callbacks.
+    timer_.DoCallbacks();
+
+    now.GetNow();
+
+    // Do any packet sends.
+    if (is_sending_)
+    {
+      if (now < end_time_)
+      {
+        for (size_t  i = 0; i < num_streams_; ++i)
+        {
+          if (stream_[i] != NULL)
+          {
+            stream_[i]->SendPackets(this, data_endpt_id_, pkt_len_, now);
+          }
+        }
+      }
+      else
+      {
+        StopSending();
+      }
+    }
+
+    // Print an interval report if it is time.
+    if (now >= intv_end_time_)
+    {
+      PrintInterval(now);
+    }
+
+    // Do a close if it is time.
+    if ((!is_server_) && (now > close_time_))
+    {
+      close_time_ = Time::Infinite();
+      CloseClient();
+      term_time_  = (now + kCloseWaitTime);
+    }
+
+    // End if it is time.
+    if ((should_terminate_) || (now > term_time_))
+    {
+      break;
+    }
+  }
+}
+
+//============================================================================
+void SliqPerf::PrintReport()
+{
+  printf("\n----------------------------------------------------------------"
+         "------------\n\n");
+
+  if (!start_usage_.valid_)
+  {
+    printf("No data %s.\n\n", (is_server_ ? "received" : "sent"));
+    return;
+  }
+
+  // Finish the usage measurement if it was not done at the end of the data.
+  if (!end_usage_.valid_)
+  {
+    end_usage_.Take(this, select_calls_);
+  }
+
+  double  dur_sec = (last_pkt_time_ - first_pkt_time_).ToDouble();
+  double  bytes   = static_cast<double>(total_bytes_);
+  double  mbps    = ((dur_sec > 0.0) ? ((bytes * 8.0) / (dur_sec * 1.0e6)) :
+                     0.0);
+
+  if (is_server_)
+  {
+    // Count the lost packets using the sequence numbers on each stream.
+    size_t  expected = 0;
+
+    printf("SLIQ Perf Receiver Report\n\n");
+
+    for (size_t i = 0; i < kMaxStreams; ++i)
+    {
+      PerfStream*  stream = stream_[i];
+
+      if ((stream == NULL) || (stream->recv_pkts_ == 0))
+      {
+        continue;
+      }
+
+      size_t  str_exp  = (static_cast<size_t>(stream->recv_max_seq_num_) +
+                          1);
+      size_t  str_lost = ((str_exp > stream->recv_pkts_) ?
+                          (str_exp - stream->recv_pkts_) : 0);
+
+      expected += str_exp;
+
+      printf("  Stream %-2" PRIStreamId "  %10zu packets  %12zu bytes  "
+             "%8zu lost\n", stream->stream_id_, stream->recv_pkts_,
+             stream->recv_bytes_, str_lost);
+    }
+
+    size_t  lost = ((expected > total_pkts_) ? (expected - total_pkts_) : 0);
+
+    printf("\n");
+    printf("  Packets:              %zu\n", total_pkts_);
+    printf("  Bytes:                %zu\n", total_bytes_);
+    printf("  Lost Packets:         %zu (%0.3f%%)\n", lost,
+           ((expected > 0) ? ((100.0 * static_cast<double>(lost)) /
+                              static_cast<double>(expected)) : 0.0));
+    printf("  Duration:             %0.3f seconds\n", dur_sec);
+    printf("  Goodput:              %0.3f Mbps\n", mbps);
+
+    PrintOwdPercentiles();
+  }
+  else
+  {
+    size_t  skipped = 0;
+
+    printf("SLIQ Perf Sender Report\n\n");
+
+    for (size_t i = 0; i < num_streams_; ++i)
+    {
+      PerfStream*  stream = stream_[i];
+
+      if (stream == NULL)
+      {
+        continue;
+      }
+
+      skipped += stream->skipped_pkts_;
+
+      printf("  Stream %-2" PRIStreamId "  %10zu packets  %12zu bytes  "
+             "%8zu skipped\n", stream->stream_id_, stream->sent_pkts_,
+             stream->sent_bytes_, stream->skipped_pkts_);
+    }
+
+    double  data_pkts = static_cast<double>(send_stats_.data_pkts);
+
+    printf("\n");
+    printf("  Packets:              %zu\n", total_pkts_);
+    printf("  Bytes:                %zu\n", total_bytes_);
+    printf("  Skipped Sends:        %zu\n", skipped);
+    printf("  Duration:             %0.3f seconds\n", dur_sec);
+    printf("  Goodput:              %0.3f Mbps\n", mbps);
+    printf("  Capacity Estimate:    %0.3f Mbps\n",
+           (chan_cap_est_bps_ / 1.0e6));
+    printf("  Retransmissions:      %zu packets (%0.3f%% overhead)\n",
+           send_stats_.rexmit_pkts,
+           ((data_pkts > 0.0) ?
+            ((100.0 * static_cast<double>(send_stats_.rexmit_pkts)) /
+             data_pkts) : 0.0));
+    printf("  FEC Encoded Packets:  %zu packets (%0.3f%% overhead)\n",
+           send_stats_.fec_enc_pkts,
+           ((data_pkts > 0.0) ?
+            ((100.0 * static_cast<double>(send_stats_.fec_enc_pkts)) /
+             data_pkts) : 0.0));
+
+    if (ack_coalescing_)
+    {
+      double  batches = static_cast<double>(ack_batch_stats_.batches);
+
+      printf("  Coalesced ACKs:       %zu packets in %zu batches (%0.3f per "
+             "batch)\n", ack_batch_stats_.ack_pkts, ack_batch_stats_.batches,
+             ((batches > 0.0) ?
+              (static_cast<double>(ack_batch_stats_.ack_pkts) / batches) :
+              0.0));
+      printf("  CC Cycles Saved:      %zu\n",
+             ack_batch_stats_.cc_cycles_saved);
+    }
+  }
+
+  PrintUsage(bytes, total_pkts_);
+
+  printf("\n");
+}
+
+//============================================================================
+void SliqPerf::SentPkt(size_t pkt_len, const Time& now)
+{
+  if (total_pkts_ == 0)
+  {
+    first_pkt_time_ = now;
+  }
+
+  ++total_pkts_;
+  total_bytes_   += pkt_len;
+  last_pkt_time_  = now;
+
+  ++intv_pkts_;
+  intv_bytes_ += pkt_len;
+}
+
+//============================================================================
+bool SliqPerf::ProcessConnectionRequest(EndptId server_endpt_id,
+                                        EndptId data_endpt_id,
+                                        const Ipv4Endpoint& client_address)
+{
+  LogD(kName, __func__, "Request for connection, server endpt %" PRIEndptId
+       ", data endpt %" PRIEndptId ", client %s.\n", server_endpt_id,
+       data_endpt_id, client_address.ToString().c_str());
+
+  if (data_endpt_id_ == -1)
+  {
+    // Accept the connection from the client.
+    data_endpt_id_ = data_endpt_id;
+
+    return true;
+  }
+
+  // Reject the connection from the client.  Only a single client connection
+  // is benchmarked at a time.
+  return false;
+}
+
+//============================================================================
+void SliqPerf::ProcessConnectionResult(EndptId endpt_id, bool success)
+{
+  is_connected_ = success;
+
+  if (!success)
+  {
+    LogE(kName, __func__, "Connection result for endpt %" PRIEndptId " is "
+         "failure.\n", endpt_id);
+    should_terminate_ = true;
+    return;
+  }
+
+  LogD(kName, __func__, "Connection result for endpt %" PRIEndptId " is "
+       "success.\n", endpt_id);
+
+  if (endpt_id != data_endpt_id_)
+  {
+    LogE(kName, __func__, "Bad endpoint, expected %" PRIEndptId " but got %"
+         PRIEndptId ".\n", data_endpt_id_, endpt_id);
+    should_terminate_ = true;
+    return;
+  }
+
+  // Set the adaptive ACK frequency option if needed.
+  if (ack_decimation_ && (!ConfigureAckFrequency(data_endpt_id_, true)))
+  {
+    LogW(kName, __func__, "Unable to configure adaptive ACK frequency.\n");
+  }
+
+  // Set the coalesced ACK processing option if needed.
+  if (ack_coalescing_ && (!ConfigureAckCoalescing(data_endpt_id_, true)))
+  {
+    LogW(kName, __func__, "Unable to configure coalesced ACK processing.\n");
+  }
+
+  if (is_server_)
+  {
+    return;
+  }
+
+  // Create the client streams, which use odd stream IDs.
+  for (size_t i = 0; i < num_streams_; ++i)
+  {
+    StreamId     stream_id = static_cast<StreamId>((2 * i) + 1);
+    PerfStream*  stream    = new (std::nothrow) PerfStream(stream_id,
+                                                           pkt_pool_);
+
+    if (stream == NULL)
+    {
+      LogE(kName, __func__, "Memory allocation error.\n");
+      should_terminate_ = true;
+      return;
+    }
+
+    stream_[i] = stream;
+
+    if (!AddStream(data_endpt_id_, stream_id, 3, rel_, del_mode_))
+    {
+      LogE(kName, __func__, "Error creating stream %" PRIStreamId ".\n",
+           stream_id);
+      should_terminate_ = true;
+      return;
+    }
+
+    if (!ConfigureTransmitQueue(data_endpt_id_, stream_id, kXmitQueueSize,
+                                sliq::FIFO_QUEUE, sliq::NO_DROP))
+    {
+      LogE(kName, __func__, "Error configuring transmit queue.\n");
+      should_terminate_ = true;
+      return;
+    }
+
+    stream->is_established_ = true;
+  }
+
+  StartSending(Time::Now());
+}
+
+//============================================================================
+void SliqPerf::ProcessNewStream(EndptId endpt_id, StreamId stream_id,
+                                Priority prio, const Reliability& rel,
+                                DeliveryMode del_mode)
+{
+  LogD(kName, __func__, "New stream %" PRIStreamId " created by peer, endpt %"
+       PRIEndptId " prio %" PRIPriority " rel %d del %d.\n", stream_id,
+       endpt_id, prio, rel.mode, del_mode);
+
+  if (endpt_id != data_endpt_id_)
+  {
+    LogE(kName, __func__, "Bad endpoint, expected %" PRIEndptId " but got %"
+         PRIEndptId ".\n", data_endpt_id_, endpt_id);
+    should_terminate_ = true;
+    return;
+  }
+
+  // The client streams use odd stream IDs.
+  size_t  idx = (static_cast<size_t>(stream_id) / 2);
+
+  if ((!is_server_) || ((static_cast<int>(stream_id) % 2) != 1) ||
+      (idx >= kMaxStreams) || (stream_[idx] != NULL))
+  {
+    LogE(kName, __func__, "Invalid stream %" PRIStreamId " created by "
+         "peer.\n", stream_id);
+    should_terminate_ = true;
+    return;
+  }
+
+  PerfStream*  stream = new (std::nothrow) PerfStream(stream_id, pkt_pool_);
+
+  if (stream == NULL)
+  {
+    LogE(kName, __func__, "Memory allocation error.\n");
+    should_terminate_ = true;
+    return;
+  }
+
+  stream->is_established_ = true;
+  stream_[idx]            = stream;
+
+  if (num_streams_ < (idx + 1))
+  {
+    num_streams_ = (idx + 1);
+  }
+}
+
+//============================================================================
+void SliqPerf::Recv(EndptId endpt_id, StreamId stream_id, Packet* data)
+{
+  size_t       idx    = (static_cast<size_t>(stream_id) / 2);
+  PerfStream*  stream = ((idx < kMaxStreams) ? stream_[idx] : NULL);
+
+  if ((endpt_id != data_endpt_id_) || (stream == NULL) ||
+      (stream->stream_id_ != stream_id))
+  {
+    LogE(kName, __func__, "Bad endpoint %" PRIEndptId " or stream %"
+         PRIStreamId ".\n", endpt_id, stream_id);
+    pkt_pool_.Recycle(data);
+    return;
+  }
+
+  size_t    pkt_len  = 0;
+  uint64_t  owd_usec = 0;
+
+  if (stream->RecvPacket(data, pkt_len, owd_usec))
+  {
+    Time  now = Time::Now();
+
+    // Start the measurements with the first packet.
+    if (total_pkts_ == 0)
+    {
+      first_pkt_time_ = now;
+      start_usage_.Take(this, select_calls_);
+
+      if (interval_sec_ > 0.0)
+      {
+        intv_start_time_ = now;
+        intv_end_time_   = (now + Time(interval_sec_));
+      }
+    }
+
+    ++total_pkts_;
+    total_bytes_   += pkt_len;
+    last_pkt_time_  = now;
+
+    ++intv_pkts_;
+    intv_bytes_        += pkt_len;
+    intv_owd_sum_usec_ += owd_usec;
+
+    if (owd_usec_.size() < kMaxOwdSamples)
+    {
+      owd_usec_.push_back(static_cast<uint32_t>(
+                            std::min(owd_usec,
+                                     static_cast<uint64_t>(UINT32_MAX))));
+    }
+  }
+
+  pkt_pool_.Recycle(data);
+}
+
+//============================================================================
+void SliqPerf::ProcessCapacityEstimate(EndptId endpt_id,
+                                       double chan_cap_est_bps,
+                                       double trans_cap_est_bps,
+                                       double ccl_time_sec)
+{
+  LogA(kName, __func__, "New endpt %" PRIEndptId " capacity estimate: "
+       "channel %f Mbps transport %f Mbps CCL %f sec.\n", endpt_id,
+       (chan_cap_est_bps / 1.0e6), (trans_cap_est_bps / 1.0e6), ccl_time_sec);
+
+  chan_cap_est_bps_ = chan_cap_est_bps;
+}
+
+//============================================================================
+void SliqPerf::ProcessRttPddSamples(EndptId endpt_id, uint32_t num_samples,
+                                    const RttPdd* samples)
+{
+}
+
+//============================================================================
+void SliqPerf::ProcessCloseStream(EndptId endpt_id, StreamId stream_id,
+                                  bool fully_closed)
+{
+  LogD(kName, __func__, "Close stream received from peer, endpt %" PRIEndptId
+       " stream %" PRIStreamId " fully_closed %s.\n", endpt_id, stream_id,
+       (fully_closed ? "true" : "false"));
+
+  size_t       idx    = (static_cast<size_t>(stream_id) / 2);
+  PerfStream*  stream = ((idx < kMaxStreams) ? stream_[idx] : NULL);
+
+  if ((endpt_id != data_endpt_id_) || (!is_connected_) || (stream == NULL))
+  {
+    LogE(kName, __func__, "Unexpected close for endpt %" PRIEndptId
+         " stream %" PRIStreamId ".\n", endpt_id, stream_id);
+    return;
+  }
+
+  if (is_server_)
+  {
+    // The data is complete once the client closes a stream.
+    if (start_usage_.valid_ && (!end_usage_.valid_))
+    {
+      end_usage_.Take(this, select_calls_);
+
+      if (intv_end_time_ != Time::Infinite())
+      {
+        PrintInterval(last_pkt_time_);
+        intv_end_time_ = Time::Infinite();
+      }
+    }
+
+    bool  is_fully_closed = false;
+
+    if (!CloseStream(data_endpt_id_, stream_id, is_fully_closed))
+    {
+      LogE(kName, __func__, "Error, cannot close stream %" PRIStreamId
+           ".\n", stream_id);
+    }
+
+    return;
+  }
+
+  stream->is_established_ = false;
+
+  // If all of the streams have been closed, then close the connection.
+  for (size_t i = 0; i < num_streams_; ++i)
+  {
+    if ((stream_[i] != NULL) && (stream_[i]->is_established_))
+    {
+      return;
+    }
+  }
+
+  bool  is_fully_closed = false;
+
+  if (!Close(data_endpt_id_, is_fully_closed))
+  {
+    LogE(kName, __func__, "Error, cannot close client connection.\n");
+  }
+}
+
+//============================================================================
+void SliqPerf::ProcessClose(EndptId endpt_id, bool fully_closed)
+{
+  LogD(kName, __func__, "Close received from peer, endpt %" PRIEndptId
+       " fully_closed %s.\n", endpt_id, (fully_closed ? "true" : "false"));
+
+  if ((endpt_id != data_endpt_id_) || (!is_connected_))
+  {
+    LogE(kName, __func__, "Unexpected close for endpt %" PRIEndptId ".\n",
+         endpt_id);
+    return;
+  }
+
+  if (is_server_)
+  {
+    bool  is_fully_closed = false;
+
+    if (!Close(data_endpt_id_, is_fully_closed))
+    {
+      LogE(kName, __func__, "Error, cannot close server side connection.\n");
+    }
+  }
+
+  data_endpt_id_    = -1;
+  is_connected_     = false;
+  should_terminate_ = true;
+}
+
+//============================================================================
+void SliqPerf::ProcessFileDescriptorChange()
+{
+  // The main processing loop grabs all of the file descriptors each time
+  // through the loop.
+  LogD(kName, __func__, "File descriptors have changed.\n");
+}
+
+//============================================================================
+void SliqPerf::Usage(const char* prog_name)
+{
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Usage:\n");
+  fprintf(stderr, "  %s [options] [server]\n", prog_name);
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Without a server address, acts as the receiving server. "
+          " With a server\naddress, acts as the sending client.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -C <cc>    The congestion control types to use (cubic, "
+          "copa1m, detcopa1m,\n             copa1_<delta>, detcopa1_<delta>, "
+          "copa2, copa, bbr,\n             gubic, gubicpacing, reno, "
+          "renopacing, fixedrate_<bps>, none)\n             (default "
+          "copa).\n");
+  fprintf(stderr, "  -D <addr>  Direct connect using local,remote "
+          "addresses.\n");
+  fprintf(stderr, "  -p <port>  The server port number (default 22123).\n");
+  fprintf(stderr, "  -n <strs>  The number of streams (1-%zu) (default "
+          "1).\n", kMaxStreams);
+  fprintf(stderr, "  -m <rel>   The reliability mode (beffort, rel_arq, "
+          "srel_arq[rx_lim],\n             srel_arqfec[rx_lim,del_lim,"
+          "tgt_rcv_prob[,sw]]) (default rel_arq).\n");
+  fprintf(stderr, "  -u         Use unordered delivery with rel_arq (other "
+          "modes are always\n             unordered).\n");
+  fprintf(stderr, "  -l <len>   The packet length in bytes (%zu-%zu) "
+          "(default %zu).\n", kPerfHdrLen, kMaxPayload, kDefaultPayload);
+  fprintf(stderr, "  -b <mbps>  The total offered load in Mbps, or 0 for "
+          "as fast as possible\n             (default 0).\n");
+  fprintf(stderr, "  -t <sec>   The test duration in seconds (default "
+          "%0.0f).\n", kDefaultDuration);
+  fprintf(stderr, "  -i <sec>   The report interval in seconds, or 0 for no "
+          "interval reports\n             (default %0.0f).\n",
+          kDefaultInterval);
+  fprintf(stderr, "  -A         Enable adaptive ACK frequency.\n");
+  fprintf(stderr, "  -B         Enable coalesced ACK processing.\n");
+  fprintf(stderr, "  -c         Enable compact headers.\n");
+  fprintf(stderr, "  -q         Turn off logging.\n");
+  fprintf(stderr, "  -v         Turn on verbose logging.\n");
+  fprintf(stderr, "  -d         Turn on debug logging.\n");
+  fprintf(stderr, "  -h         Print out usage information.\n");
+  fprintf(stderr, "\n");
+
+  exit(2);
+}
+
+//============================================================================
+bool SliqPerf::ParseCongCtrlConfig(const char* cc_config)
+{
+  // Parse the list of congestion control names, separated by ','.
+  string        conf(cc_config);
+  List<string>  tokens;
+  size_t        num_tokens = 0;
+
+  StringUtils::Tokenize(conf, ",", tokens);
+  num_tokens = tokens.size();
+
+  if ((num_tokens < 1) || (num_tokens > kMaxCcAlg))
+  {
+    return false;
+  }
+
+  // Loop over each token.
+  for (size_t i = 0; i < num_tokens; ++i)
+  {
+    string  tok;
+
+    if (!tokens.Pop(tok))
+    {
+      LogE(kName, __func__, "Missing congestion control token.\n");
+      return false;
+    }
+
+    const char*  cc_tok  = tok.c_str();
+    const char*  beg_ptr = NULL;
+    char*        end_ptr = NULL;
+
+    if (tok == "cubic")
+    {
+      cc_algorithm_[i].SetTcpCubic();
+    }
+    else if (tok == "copa1m")
+    {
+      cc_algorithm_[i].SetCopaBeta1M(false);
+    }
+    else if (tok == "detcopa1m")
+    {
+      cc_algorithm_[i].SetCopaBeta1M(true);
+    }
+    else if ((strncmp(cc_tok, "copa1_", 6) == 0) ||
+             (strncmp(cc_tok, "detcopa1_", 9) == 0))
+    {
+      bool  det = (cc_tok[0] == 'd');
+
+      beg_ptr = &(cc_tok[det ? 9 : 6]);
+
+      double  delta = strtod(beg_ptr, &end_ptr);
+
+      if (end_ptr == beg_ptr)
+      {
+        LogE(kName, __func__, "Invalid delta value: %s\n", cc_tok);
+        return false;
+      }
+
+      cc_algorithm_[i].SetCopaBeta1(delta, det);
+    }
+    else if (tok == "copa2")
+    {
+      cc_algorithm_[i].SetCopaBeta2();
+    }
+    else if (tok == "copa")
+    {
+      cc_algorithm_[i].SetCopa();
+    }
+    else if (tok == "bbr")
+    {
+      cc_algorithm_[i].SetBbr();
+    }
+    else if (tok == "gubicpacing")
+    {
+      cc_algorithm_[i].SetGoogleTcpCubic(true);
+    }
+    else if (tok == "gubic")
+    {
+      cc_algorithm_[i].SetGoogleTcpCubic(false);
+    }
+    else if (tok == "renopacing")
+    {
+      cc_algorithm_[i].SetGoogleTcpReno(true);
+    }
+    else if (tok == "reno")
+    {
+      cc_algorithm_[i].SetGoogleTcpReno(false);
+    }
+    else if (strncmp(cc_tok, "fixedrate_", 10) == 0)
+    {
+      beg_ptr = &(cc_tok[10]);
+
+      uint64_t  rate = static_cast<uint64_t>(strtoull(beg_ptr, &end_ptr,
+                                                      10));
+
+      if (end_ptr == beg_ptr)
+      {
+        LogE(kName, __func__, "Invalid rate value: %s\n", cc_tok);
+        return false;
+      }
+
+      cc_algorithm_[i].SetFixedRate(rate);
+    }
+    else if (tok == "none")
+    {
+      cc_algorithm_[i].SetNoCc();
+    }
+    else
+    {
+      LogE(kName, __func__, "Invalid congestion control: %s\n", cc_tok);
+      return false;
+    }
+  }
+
+  // All of the tokens were parsed successfully.
+  num_cc_alg_ = num_tokens;
+
+  return true;
+}
+
+//============================================================================
+bool SliqPerf::ParseDirectConnConfig(const char* dir_conn_config)
+{
+  // Tokenize the direct connection address string, which should contain two
+  // IP addresses separated by ','.
+  string        conf(dir_conn_config);
+  List<string>  tokens;
+
+  StringUtils::Tokenize(conf, ",", tokens);
+
+  if (tokens.size() != 2)
+  {
+    return false;
+  }
+
+  return (tokens.Pop(direct_local_addr_) && tokens.Pop(direct_remote_addr_));
+}
+
+//============================================================================
+bool SliqPerf::ParseReliabilityMode(const char* rel_config)
+{
+  string  tok(rel_config);
+  int     val = 0;
+
+  if (tok == "beffort")
+  {
+    rel_.SetBestEffort();
+    return true;
+  }
+
+  if (tok == "rel_arq")
+  {
+    rel_.SetRelArq();
+    return true;
+  }
+
+  if ((tok.size() > 10) && (tok.substr(0, 9) == "srel_arq[") &&
+      (tok[tok.size() - 1] == ']'))
+  {
+    val = StringUtils::GetInt(tok.substr(9, (tok.size() - 10)), -1);
+
+    if ((val < 1) || (val > 255))
+    {
+      LogE(kName, __func__, "Invalid semi-reliable ARQ retransmission "
+           "limit: %s\n", tok.c_str());
+      return false;
+    }
+
+    rel_.SetSemiRelArq(static_cast<RexmitLimit>(val));
+    return true;
+  }
+
+  if ((tok.size() <= 13) || (tok.substr(0, 12) != "srel_arqfec[") ||
+      (tok[tok.size() - 1] != ']'))
+  {
+    return false;
+  }
+
+  // Parse the semi-reliable ARQ+FEC parameters.
+  string        mix_str = tok.substr(12, (tok.size() - 13));
+  List<string>  mix_val;
+
+  StringUtils::Tokenize(mix_str, ",", mix_val);
+
+  if ((mix_val.size() != 3) && (mix_val.size() != 4))
+  {
+    LogE(kName, __func__, "Invalid semi-reliable ARQ/FEC format: %s\n",
+         mix_str.c_str());
+    return false;
+  }
+
+  // Retransmission limit.
+  mix_val.Pop(tok);
+  val = StringUtils::GetInt(tok, -1);
+
+  if ((val < 0) || (val > 255))
+  {
+    LogE(kName, __func__, "Invalid semi-reliable ARQ/FEC retransmission "
+         "limit: %s\n", tok.c_str());
+    return false;
+  }
+
+  RexmitLimit  limit = static_cast<RexmitLimit>(val);
+
+  // Target delivery limit, in rounds or in seconds with a trailing s.
+  bool         use_rounds = false;
+  double       tgt_time   = 0.0;
+  RexmitLimit  tgt_rounds = 0;
+
+  mix_val.Pop(tok);
+
+  if ((!tok.empty()) && (tok[tok.size() - 1] == 's'))
+  {
+    tgt_time = StringUtils::GetDouble(tok.substr(0, tok.size() - 1), -1.0);
+
+    if ((tgt_time < 0.001) || (tgt_time > 64.0))
+    {
+      LogE(kName, __func__, "Invalid semi-reliable ARQ/FEC target delivery "
+           "time limit in seconds: %s\n", tok.c_str());
+      return false;
+    }
+  }
+  else
+  {
+    tgt_rounds = static_cast<RexmitLimit>(StringUtils::GetInt(tok, 0));
+
+    if ((tgt_rounds < 1) || (tgt_rounds > 7) ||
+        (tgt_rounds > static_cast<RexmitLimit>(limit + 1)))
+    {
+      LogE(kName, __func__, "Invalid semi-reliable ARQ/FEC target delivery "
+           "round limit: %s\n", tok.c_str());
+      return false;
+    }
+
+    use_rounds = true;
+  }
+
+  // Target receive probability.
+  mix_val.Pop(tok);
+
+  double  rcv_p = StringUtils::GetDouble(tok, 0.0);
+
+  if ((rcv_p < 0.95) || (rcv_p > 0.999))
+  {
+    LogE(kName, __func__, "Invalid semi-reliable ARQ/FEC target receive "
+         "probability: %s\n", tok.c_str());
+    return false;
+  }
+
+  // Optional sliding window FEC mode.
+  bool  sliding_win = false;
+
+  if (mix_val.Pop(tok))
+  {
+    if (tok != "sw")
+    {
+      LogE(kName, __func__, "Invalid semi-reliable ARQ/FEC FEC mode: %s\n",
+           tok.c_str());
+      return false;
+    }
+
+    sliding_win = true;
+  }
+
+  if (use_rounds)
+  {
+    rel_.SetSemiRelArqFecUsingRounds(limit, rcv_p, tgt_rounds, sliding_win);
+  }
+  else
+  {
+    rel_.SetSemiRelArqFecUsingTime(limit, rcv_p, tgt_time, sliding_win);
+  }
+
+  return true;
+}
+
+//============================================================================
+bool SliqPerf::ActAsServer(const Ipv4Endpoint& server_address)
+{
+  if (direct_conn_)
+  {
+    // Set up a server data endpoint directly.
+    Ipv4Endpoint  server_addr(direct_local_addr_ + ":" + server_port_);
+    Ipv4Endpoint  client_addr(direct_remote_addr_ + ":" + server_port_);
+
+    if (!SetupServerDataEndpoint(server_addr, client_addr, data_endpt_id_))
+    {
+      LogE(kName, __func__, "Error in SetupServerDataEndpoint().\n");
+      return false;
+    }
+  }
+  else
+  {
+    // Listen on the specified server address and port number.  The
+    // ProcessConnectionRequest() method will be called for each client
+    // connection request.
+    if (!Listen(server_address, listen_endpt_id_))
+    {
+      LogE(kName, __func__, "Error in Listen().\n");
+      return false;
+    }
+  }
+
+  printf("SLIQ Perf server listening on port %s.\n", server_port_.c_str());
+  fflush(stdout);
+
+  return true;
+}
+
+//============================================================================
+bool SliqPerf::ActAsClient(const Ipv4Endpoint& server_address)
+{
+  if (direct_conn_)
+  {
+    // Set up a client data endpoint directly.
+    Ipv4Endpoint  client_addr(direct_local_addr_ + ":" + server_port_);
+    Ipv4Endpoint  server_addr(direct_remote_addr_ + ":" + server_port_);
+
+    if (!SetupClientDataEndpoint(client_addr, server_addr, cc_algorithm_,
+                                 num_cc_alg_, data_endpt_id_))
+    {
+      LogE(kName, __func__, "Error in SetupClientDataEndpoint().\n");
+      return false;
+    }
+  }
+  else
+  {
+    // Initiate a connection to the server.  The ProcessConnectionResult()
+    // method will be called with the result later.
+    if (!Connect(server_address, cc_algorithm_, num_cc_alg_, data_endpt_id_))
+    {
+      LogE(kName, __func__, "Error in Connect().\n");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//============================================================================
+void SliqPerf::StartSending(const Time& now)
+{
+  // Split the offered load evenly over the streams.
+  Time  wait;
+
+  if (rate_bps_ > 0.0)
+  {
+    wait = Time((static_cast<double>(pkt_len_ * num_streams_) * 8.0) /
+                rate_bps_);
+  }
+
+  end_time_ = (now + Time(duration_sec_));
+
+  for (size_t i = 0; i < num_streams_; ++i)
+  {
+    if (stream_[i] != NULL)
+    {
+      stream_[i]->StartSending(now, wait, end_time_);
+    }
+  }
+
+  is_sending_ = true;
+
+  start_usage_.Take(this, select_calls_);
+
+  if (interval_sec_ > 0.0)
+  {
+    intv_start_time_ = now;
+    intv_end_time_   = (now + Time(interval_sec_));
+  }
+
+  printf("Sending %zu stream(s) of %zu byte packets for %0.3f seconds.\n",
+         num_streams_, pkt_len_, duration_sec_);
+  fflush(stdout);
+}
+
+//============================================================================
+void SliqPerf::StopSending()
+{
+  is_sending_ = false;
+
+  // Report the final partial interval.
+  if (intv_end_time_ != Time::Infinite())
+  {
+    PrintInterval(Time::Now());
+    intv_end_time_ = Time::Infinite();
+  }
+
+  // Give the streams time to deliver the data before closing them.
+  close_time_ = (Time::Now() + Time(kDrainTime));
+}
+
+//============================================================================
+void SliqPerf::CloseClient()
+{
+  // Record the final transmission statistics before the streams go away.
+  end_usage_.Take(this, select_calls_);
+
+  if (ack_coalescing_ && (!GetAckBatchStats(data_endpt_id_, ack_batch_stats_)))
+  {
+    LogW(kName, __func__, "Unable to get coalesced ACK statistics.\n");
+  }
+
+  for (size_t i = 0; i < num_streams_; ++i)
+  {
+    if (stream_[i] == NULL)
+    {
+      continue;
+    }
+
+    SendStats  stats;
+
+    if (GetSendStats(data_endpt_id_, stream_[i]->stream_id_, stats))
+    {
+      send_stats_.data_pkts    += stats.data_pkts;
+      send_stats_.rexmit_pkts  += stats.rexmit_pkts;
+      send_stats_.fec_enc_pkts += stats.fec_enc_pkts;
+    }
+
+    bool  is_fully_closed = false;
+
+    if (!CloseStream(data_endpt_id_, stream_[i]->stream_id_,
+                     is_fully_closed))
+    {
+      LogE(kName, __func__, "Error, cannot close stream %" PRIStreamId
+           ".\n", stream_[i]->stream_id_);
+    }
+  }
+}
+
+//============================================================================
+void SliqPerf::PrintInterval(const Time& now)
+{
+  double  beg_sec = (intv_start_time_ - start_usage_.time_).ToDouble();
+  double  dur_sec = (now - intv_start_time_).ToDouble();
+
+  if (dur_sec > 0.0)
+  {
+    double  mbps = ((static_cast<double>(intv_bytes_) * 8.0) /
+                    (dur_sec * 1.0e6));
+
+    if (is_server_)
+    {
+      double  owd_msec = ((intv_pkts_ > 0) ?
+                          ((static_cast<double>(intv_owd_sum_usec_) /
+                            static_cast<double>(intv_pkts_)) * 0.001) :
+                          0.0);
+
+      printf("[%7.2f-%7.2f sec]  %10.3f Mbps  %8zu pkts  owd mean "
+             "%0.3f msec\n", beg_sec, (beg_sec + dur_sec), mbps, intv_pkts_,
+             owd_msec);
+    }
+    else
+    {
+      printf("[%7.2f-%7.2f sec]  %10.3f Mbps  %8zu pkts\n", beg_sec,
+             (beg_sec + dur_sec), mbps, intv_pkts_);
+    }
+
+    fflush(stdout);
+  }
+
+  intv_pkts_         = 0;
+  intv_bytes_        = 0;
+  intv_owd_sum_usec_ = 0;
+  intv_start_time_   = now;
+  intv_end_time_     = ((interval_sec_ > 0.0) ? (now + Time(interval_sec_)) :
+                        Time::Infinite());
+}
+
+//============================================================================
+void SliqPerf::PrintUsage(double bytes, size_t pkts)
+{
+  double  user_sec = (end_usage_.user_sec_ - start_usage_.user_sec_);
+  double  sys_sec  = (end_usage_.sys_sec_ - start_usage_.sys_sec_);
+  double  gbits    = ((bytes * 8.0) / 1.0e9);
+  size_t  reads    = (end_usage_.sock_stats_.read_calls -
+                      start_usage_.sock_stats_.read_calls);
+  size_t  writes   = (end_usage_.sock_stats_.write_calls -
+                      start_usage_.sock_stats_.write_calls);
+  size_t  selects  = (end_usage_.select_calls_ - start_usage_.select_calls_);
+  size_t  wr_pkts  = (end_usage_.sock_stats_.write_pkts -
+                      start_usage_.sock_stats_.write_pkts);
+  size_t  rd_pkts  = (end_usage_.sock_stats_.read_pkts -
+                      start_usage_.sock_stats_.read_pkts);
+
+  printf("  CPU Time:             %0.3f user %0.3f system seconds\n",
+         user_sec, sys_sec);
+
+  if (gbits > 0.0)
+  {
+    printf("  CPU per Gbit:         %0.3f seconds\n",
+           ((user_sec + sys_sec) / gbits));
+  }
+
+  printf("  Socket Packets:       %zu read %zu written\n", rd_pkts,
+         wr_pkts);
+  printf("  System Calls:         %zu recvmmsg %zu sendmsg %zu select\n",
+         reads, writes, selects);
+
+  if (pkts > 0)
+  {
+    printf("  System Calls per Pkt: %0.3f\n",
+           (static_cast<double>(reads + writes + selects) /
+            static_cast<double>(pkts)));
+  }
+}
+
+//============================================================================
+void SliqPerf::PrintOwdPercentiles()
+{
+  size_t  num = owd_usec_.size();
+
+  if (num == 0)
+  {
+    return;
+  }
+
+  std::sort(owd_usec_.begin(), owd_usec_.end());
+
+  const double  pct[] = { 0.5, 0.9, 0.99, 0.999 };
+
+  printf("  One-Way Delay:        min %0.3f", (owd_usec_[0] * 0.001));
+
+  for (size_t i = 0; i < (sizeof(pct) / sizeof(pct[0])); ++i)
+  {
+    size_t  idx = static_cast<size_t>(pct[i] * static_cast<double>(num - 1));
+
+    printf(" / p%g %0.3f", (pct[i] * 100.0), (owd_usec_[idx] * 0.001));
+  }
+
+  printf(" / max %0.3f msec\n", (owd_usec_[num - 1] * 0.001));
+}
+
+//============================================================================
+int main(int argc, char** argv)
+{
+  // Create the PacketPool, Timer, and SliqPerf objects.
+  PacketPoolHeap*  pkt_pool = new (std::nothrow) PacketPoolHeap();
+
+  if ((pkt_pool == NULL) || (!pkt_pool->Create(kPktPoolSize)))
+  {
+    LogE("main", __func__, "Error creating PacketPool.\n");
+    exit(1);
+  }
+
+  Timer*  timer = new (std::nothrow) Timer();
+
+  if (timer == NULL)
+  {
+    LogE("main", __func__, "Error creating Timer.\n");
+    delete pkt_pool;
+    exit(1);
+  }
+
+  SliqPerf*  sliq_perf = new (std::nothrow) SliqPerf(*pkt_pool, *timer);
+
+  if (sliq_perf == NULL)
+  {
+    LogE("main", __func__, "Error creating SliqPerf.\n");
+    delete pkt_pool;
+    delete timer;
+    exit(1);
+  }
+
+  // Initialize the SliqPerf object.
+  if (!sliq_perf->Init(argc, argv))
+  {
+    LogE("main", __func__, "Error initializing SliqPerf.\n");
+    exit(1);
+  }
+
+  // Run the benchmark and print out the results.
+  sliq_perf->Run();
+  sliq_perf->PrintReport();
+
+  // Destroy the objects.
+  delete sliq_perf;
+  sliq_perf = NULL;
+
+  delete timer;
+  timer = NULL;
+
+  delete pkt_pool;
+  pkt_pool = NULL;
+
+  // Clean up common components.
+  Log::Destroy();
+
+  return 0;
+}